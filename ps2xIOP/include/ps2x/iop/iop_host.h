@@ -77,6 +77,15 @@ namespace ps2x::iop
                                   void *destination,
                                   size_t size,
                                   size_t &bytesRead) = 0;
+        // Positional read straight into guest memory at guestAddress. Same
+        // short-read and failure rules as readHostFile. Other IOP calls may
+        // run while the read waits on the host, so the caller must not hold
+        // a lock those calls could need.
+        virtual bool readHostFileIntoGuest(uint64_t handle,
+                                           uint64_t offset,
+                                           uint32_t guestAddress,
+                                           size_t size,
+                                           size_t &bytesRead) = 0;
         virtual void closeHostFile(uint64_t handle) = 0;
 
         virtual int32_t memoryCard(const MemoryCardRequest &request) = 0;
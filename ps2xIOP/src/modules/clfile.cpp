@@ -262,39 +262,48 @@ namespace ps2x::iop::detail
                         return result;
                     }
 
-                    std::vector<uint8_t> bytes(std::min(requestedBytes,
-                                                        m_bindings.rpc.maximumReadBytes));
-                    size_t bytesRead = 0u;
-                    bool readFailed = false;
+                    size_t wanted = std::min(requestedBytes, m_bindings.rpc.maximumReadBytes);
+                    uint64_t hostFile = 0u;
+                    uint64_t position = 0u;
                     {
+                        // Claim [position, position + wanted) before reading so a
+                        // concurrent read on the same handle starts after it.
                         std::lock_guard<std::mutex> lock(m_mutex);
                         const auto fileIt = m_fileHandles.find(handle);
-                        if (fileIt == m_fileHandles.end() || fileIt->second.handle == 0u)
+                        if (fileIt != m_fileHandles.end())
                         {
-                            readFailed = true;
+                            ClFileHandle &entry = fileIt->second;
+                            hostFile = entry.handle;
+                            position = entry.position;
+                            const uint64_t remaining = position < entry.size ? entry.size - position : 0u;
+                            wanted = static_cast<size_t>(std::min<uint64_t>(wanted, remaining));
+                            entry.position = position + wanted;
                         }
-                        else if (!bytes.empty())
+                    }
+                    if (hostFile == 0u)
+                    {
+                        writeRpcResult(-1, 0u);
+                        return result;
+                    }
+
+                    // Read outside m_mutex so streams on other handles keep going.
+                    size_t bytesRead = 0u;
+                    const bool readOk =
+                        wanted == 0u ||
+                        m_host.readHostFileIntoGuest(hostFile, position, destinationAddress, wanted, bytesRead);
+                    if (bytesRead < wanted)
+                    {
+                        // Give back the unread tail unless a later read already
+                        // claimed the range after it.
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        const auto fileIt = m_fileHandles.find(handle);
+                        if (fileIt != m_fileHandles.end() && fileIt->second.handle == hostFile &&
+                            fileIt->second.position == position + wanted)
                         {
-                            size_t hostBytesRead = 0u;
-                            if (!m_host.readHostFile(fileIt->second.handle,
-                                                     fileIt->second.position,
-                                                     bytes.data(),
-                                                     bytes.size(),
-                                                     hostBytesRead))
-                            {
-                                readFailed = true;
-                            }
-                            else
-                            {
-                                bytesRead = hostBytesRead;
-                                fileIt->second.position += hostBytesRead;
-                            }
+                            fileIt->second.position = position + bytesRead;
                         }
                     }
-
-                    if (readFailed ||
-                        (bytesRead != 0u &&
-                         !m_host.writeGuest(destinationAddress, bytes.data(), bytesRead)))
+                    if (!readOk)
                     {
                         writeRpcResult(-1, 0u);
                         return result;
@@ -555,37 +564,15 @@ namespace ps2x::iop::detail
                                                uint32_t destinationAddress,
                                                uint64_t bytesToCopy)
             {
-                constexpr size_t kChunkBytes = 16u * 1024u;
                 if (bytesToCopy > 0xFFFFFFFFull - static_cast<uint64_t>(destinationAddress) + 1ull)
                 {
                     return false;
                 }
 
-                std::vector<uint8_t> chunk(kChunkBytes);
-                uint64_t copied = 0u;
-                while (copied < bytesToCopy)
-                {
-                    const size_t wanted = static_cast<size_t>(
-                        std::min<uint64_t>(chunk.size(), bytesToCopy - copied));
-                    size_t received = 0u;
-                    if (!m_host.readHostFile(file,
-                                             copied,
-                                             chunk.data(),
-                                             wanted,
-                                             received) ||
-                        received != wanted)
-                    {
-                        return false;
-                    }
-
-                    const uint32_t chunkAddress = destinationAddress + static_cast<uint32_t>(copied);
-                    if (!m_host.writeGuest(chunkAddress, chunk.data(), received))
-                    {
-                        return false;
-                    }
-                    copied += received;
-                }
-                return true;
+                size_t received = 0u;
+                const size_t wanted = static_cast<size_t>(bytesToCopy);
+                return m_host.readHostFileIntoGuest(file, 0u, destinationAddress, wanted, received) &&
+                       received == wanted;
             }
 
             IopHost &m_host;
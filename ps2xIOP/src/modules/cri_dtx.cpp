@@ -1032,14 +1032,25 @@ namespace ps2x::iop::detail
                            uint32_t sourceAddress,
                            uint32_t length)
             {
-                for (uint32_t index = 0u; index < length; ++index)
-                {
-                    uint8_t value = 0u;
-                    if (!m_host.readGuest(sourceAddress + index, &value, sizeof(value)) ||
-                        !m_host.writeGuest(destinationAddress + index, &value, sizeof(value)))
+                // Forward copy in blocks. When the destination starts less than
+                // a block ahead of the source, the block shrinks to that gap so
+                // the result still matches a byte-by-byte forward copy.
+                std::array<uint8_t, 512> block{};
+                const uint32_t gap = destinationAddress - sourceAddress;
+                uint32_t copied = 0u;
+                while (copied < length)
+                {
+                    uint32_t step = std::min<uint32_t>(length - copied, static_cast<uint32_t>(block.size()));
+                    if (gap != 0u && gap < step)
+                    {
+                        step = gap;
+                    }
+                    if (!m_host.readGuest(sourceAddress + copied, block.data(), step) ||
+                        !m_host.writeGuest(destinationAddress + copied, block.data(), step))
                     {
                         return false;
                     }
+                    copied += step;
                 }
                 return true;
             }
@@ -67,6 +67,7 @@ namespace ps2recomp
         void emitFallbackInstruction();
 
         bool emitDirectFunctionJumpIfAvailable(uint32_t target, StaticBranchKind kind, std::string_view indent);
+        bool emitDirectFunctionCallIfAvailable(uint32_t target, std::string_view indent);
         void emitExternalJumpDispatch(uint32_t target, StaticBranchKind kind, std::string_view indent);
         void emitExternalRegisterCallDispatch(std::string_view jumpTargetExpression, std::string_view indent);
         void emitExternalRegisterJumpDispatch(std::string_view jumpTargetExpression, RegisterBranchKind kind, uint8_t rsReg, std::string_view indent);
@@ -77,6 +78,12 @@ namespace ps2recomp
                                        std::string_view debugName,
                                        std::string_view indent,
                                        bool returnOnTransfer);
+        void emitCachedRuntimeBranchDispatch(std::string_view targetExpression,
+                                             uint32_t sourcePc,
+                                             uint32_t returnPc,
+                                             std::string_view runtimeKind,
+                                             std::string_view debugName,
+                                             std::string_view indent);
         bool emitRelocationCallIfAvailable(StaticBranchKind kind, std::string_view indent);
         std::string conditionalBranchExpression() const;
         uint32_t conditionalBranchTarget() const;
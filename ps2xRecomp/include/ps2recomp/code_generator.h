@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -53,7 +54,10 @@ namespace ps2recomp
         void setRelocationCallNames(const std::unordered_map<uint32_t, std::string> &callNames);
         void setConfiguredJumpTables(const std::vector<JumpTable> &jumpTables);
         void setResumeEntryTargets(const std::unordered_map<uint32_t, std::vector<uint32_t>> &resumeTargetsByOwner);
+        void setCleanCallTargets(const std::unordered_set<uint32_t> &cleanCallTargets);
         void setEmitInstructionComments(bool emitInstructionComments);
+        void setEmitPrecisePc(bool emitPrecisePc);
+        void setAssumeRdramStackAndGp(bool assumeRdramStackAndGp);
         void setReporter(RecompilerReporter *reporter);
 
         AnalysisResult collectInternalBranchTargets(const Function &function,
@@ -66,15 +70,19 @@ namespace ps2recomp
         std::unordered_map<uint32_t, std::string> m_relocationCallNames;
         std::unordered_map<uint32_t, std::vector<uint32_t>> m_configJumpTableTargetsByAddress;
         std::unordered_map<uint32_t, std::vector<uint32_t>> m_resumeEntryTargetsByOwner;
+        std::unordered_set<uint32_t> m_cleanCallTargets;
         const std::vector<Section>& m_sections;
         BootstrapInfo m_bootstrapInfo;
         bool m_emitInstructionComments = true;
+        bool m_emitPrecisePc = false;
+        bool m_assumeRdramStackAndGp = true;
         RecompilerReporter *m_reporter = nullptr;
         std::string m_currentFunctionName;
 
         std::string translateInstruction(const Instruction &inst);
         std::string translateInstruction(const Instruction &inst, const MemoryAccessHint &memoryHint);
         std::string emitUnhandledInstruction(const Instruction &inst, const std::string &message);
+        bool translationObservesPc(const Instruction &inst) const;
         std::string translateMMIInstruction(const Instruction &inst);
         std::string translateVUInstruction(const Instruction &inst);
         std::string translateFPUInstruction(const Instruction &inst);
@@ -195,8 +203,9 @@ namespace ps2recomp
         std::string translateVU_VSQD(const Instruction &inst);
 
         // Jump Table Generation
-        std::string generateJumpTableSwitch(const Instruction &inst, uint32_t tableAddress,
-                                            const std::vector<JumpTableEntry> &entries);
+        std::string generateJumpTableSwitch(const LocalJumpTable &table,
+                                            const std::unordered_set<uint32_t> &internalTargets,
+                                            std::string_view indent) const;
 
         const Symbol *findSymbolByAddress(uint32_t address) const;
         std::string getFunctionName(uint32_t address) const;
@@ -13,6 +13,15 @@ namespace ps2recomp
     struct Section;
     class RecompilerReporter;
 
+    // A rodata jump table whose slot can still be recovered at the JR:
+    // slotRegister holds slotBase + slot * 4 and targets is indexed by slot.
+    struct LocalJumpTable
+    {
+        uint32_t slotRegister = 0;
+        uint32_t slotBase = 0;
+        std::vector<uint32_t> targets;
+    };
+
     struct ControlFlowAnalysisResult
     {
         std::unordered_set<uint32_t> entryPoints;
@@ -20,6 +29,7 @@ namespace ps2recomp
         std::unordered_set<uint32_t> resumeEntryPoints;
         std::unordered_set<uint32_t> indirectFallbackEntryPoints;
         std::unordered_map<uint32_t, std::vector<uint32_t>> jumpTableTargets;
+        std::unordered_map<uint32_t, LocalJumpTable> localJumpTables;
     };
 
     class ControlFlowAnalyzer
@@ -38,6 +48,11 @@ namespace ps2recomp
         const std::unordered_map<uint32_t, std::vector<uint32_t>> &m_configJumpTableTargetsByAddress;
         RecompilerReporter *m_reporter = nullptr;
     };
+
+    // True when every path through the function ends in JR $ra without
+    // calling out, looping, trapping or rewriting $ra, so a caller can skip
+    // checking ctx->pc after calling it.
+    bool isCleanCallee(const Function &function, const std::vector<Instruction> &instructions);
 }
 
 #endif // PS2RECOMP_CONTROL_FLOW_ANALYZER_H
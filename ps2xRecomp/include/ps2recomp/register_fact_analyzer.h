@@ -0,0 +1,75 @@
+#ifndef PS2RECOMP_REGISTER_FACT_ANALYZER_H
+#define PS2RECOMP_REGISTER_FACT_ANALYZER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ps2recomp/control_flow_analyzer.h"
+#include "ps2recomp/gif_dma_kick_analyzer.h"
+#include "ps2recomp/types.h"
+
+namespace ps2recomp
+{
+    struct Function;
+    struct Instruction;
+
+    // What is known about the low 32 bits of one GPR: nothing, an exact
+    // value, or only the memory region it points into.
+    struct RegisterFact
+    {
+        enum class Kind : uint8_t
+        {
+            Unknown,
+            Constant,
+            Region
+        };
+
+        Kind kind = Kind::Unknown;
+        MemoryRegion region = MemoryRegion::Unknown;
+        uint32_t value = 0;
+
+        static RegisterFact unknown();
+        static RegisterFact constant(uint32_t value);
+        static RegisterFact inRegion(MemoryRegion region);
+
+        bool operator==(const RegisterFact &other) const = default;
+    };
+
+    struct RegisterFacts
+    {
+        bool reached = false;
+        std::array<RegisterFact, 32> regs{};
+
+        // Facts that hold on entry to any function: $zero is 0 and, when
+        // assumeRdramStackAndGp is set, $sp and $gp point into RDRAM.
+        static RegisterFacts entry(bool assumeRdramStackAndGp);
+
+        // What survives a call or syscall: the ABI preserves $sp and $gp,
+        // everything else may have been rewritten.
+        RegisterFacts clobbered() const;
+
+        bool join(const RegisterFacts &other);
+        void set(uint32_t reg, const RegisterFact &fact);
+        const RegisterFact &get(uint32_t reg) const;
+        ConstantRegisterState constants() const;
+    };
+
+    MemoryRegion classifyGuestAddress(uint32_t address);
+
+    // Forward dataflow over the function's branches and fallthroughs. Returns
+    // the facts that hold before each instruction, indexed like instructions.
+    // resumeEntryTargets are addresses other code resumes at (registered by
+    // their owners); they and the indirect fallback entries start from the
+    // entry facts even when a local branch also reaches them.
+    std::vector<RegisterFacts> analyzeRegisterFacts(const Function &function,
+                                                    const std::vector<Instruction> &instructions,
+                                                    const ControlFlowAnalysisResult &analysis,
+                                                    const std::vector<uint32_t> &resumeEntryTargets,
+                                                    bool assumeRdramStackAndGp);
+
+    void applyRegisterFacts(const Instruction &inst, RegisterFacts &facts);
+    MemoryAccessHint resolveMemoryAccessHint(const Instruction &inst, const RegisterFacts &facts);
+}
+
+#endif // PS2RECOMP_REGISTER_FACT_ANALYZER_H
@@ -80,10 +80,20 @@ namespace ps2recomp
         }
     };
 
+    // Where a guest address is known to point when its exact value is not.
+    enum class MemoryRegion : uint8_t
+    {
+        Unknown,
+        Rdram,
+        Scratchpad,
+        Mmio
+    };
+
     struct MemoryAccessHint
     {
         bool hasAddress = false;
         uint32_t address = 0;
+        MemoryRegion region = MemoryRegion::Unknown;
     };
 
     // Function information
@@ -184,6 +194,8 @@ namespace ps2recomp
         bool patchSyscalls = false;
         bool patchCop0 = true;
         bool patchCache = true;
+        bool precisePc = false;
+        bool assumeRdramStackAndGp = true;
         std::vector<std::string> skipFunctions;
         std::unordered_map<uint32_t, std::string> patches;
         std::vector<std::string> stubImplementations;
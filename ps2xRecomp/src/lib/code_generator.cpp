@@ -30,6 +30,12 @@
 #include <cmath>
 #include <vector>
 
+// Debug builds can force ctx->pc before every instruction regardless of
+// general.precise_pc.
+#ifndef PS2X_RECOMP_PRECISE_PC
+#define PS2X_RECOMP_PRECISE_PC 0
+#endif
+
 namespace ps2recomp
 {
     const std::unordered_set<std::string> kKeywords = {
@@ -151,11 +157,26 @@ namespace ps2recomp
         }
     }
 
+    void CodeGenerator::setCleanCallTargets(const std::unordered_set<uint32_t> &cleanCallTargets)
+    {
+        m_cleanCallTargets = cleanCallTargets;
+    }
+
     void CodeGenerator::setEmitInstructionComments(bool emitInstructionComments)
     {
         m_emitInstructionComments = emitInstructionComments;
     }
 
+    void CodeGenerator::setEmitPrecisePc(bool emitPrecisePc)
+    {
+        m_emitPrecisePc = emitPrecisePc;
+    }
+
+    void CodeGenerator::setAssumeRdramStackAndGp(bool assumeRdramStackAndGp)
+    {
+        m_assumeRdramStackAndGp = assumeRdramStackAndGp;
+    }
+
     void CodeGenerator::setReporter(RecompilerReporter *reporter)
     {
         m_reporter = reporter;
@@ -289,6 +310,325 @@ namespace ps2recomp
         return fmt::format("throw std::runtime_error(\"{} at 0x{:X} raw=0x{:08X}\");", message, inst.address, inst.raw);
     }
 
+    // The tables below mirror the translators: an entry is listed only when
+    // its translation is plain register arithmetic. Anything missing can
+    // reach the runtime (memory, exceptions, syscalls, traps, COP0/VU0 side
+    // effects) or falls through to emitUnhandledInstruction, so it gets the
+    // exact PC.
+    static bool specialObservesPc(uint32_t function)
+    {
+        switch (function)
+        {
+        case SPECIAL_SLL:
+        case SPECIAL_SRL:
+        case SPECIAL_SRA:
+        case SPECIAL_SLLV:
+        case SPECIAL_SRLV:
+        case SPECIAL_SRAV:
+        case SPECIAL_SYNC:
+        case SPECIAL_MFHI:
+        case SPECIAL_MTHI:
+        case SPECIAL_MFLO:
+        case SPECIAL_MTLO:
+        case SPECIAL_MULT:
+        case SPECIAL_MULTU:
+        case SPECIAL_DIV:
+        case SPECIAL_DIVU:
+        case SPECIAL_ADDU:
+        case SPECIAL_SUBU:
+        case SPECIAL_AND:
+        case SPECIAL_OR:
+        case SPECIAL_XOR:
+        case SPECIAL_NOR:
+        case SPECIAL_SLT:
+        case SPECIAL_SLTU:
+        case SPECIAL_MOVZ:
+        case SPECIAL_MOVN:
+        case SPECIAL_MFSA:
+        case SPECIAL_MTSA:
+        case SPECIAL_DADDU:
+        case SPECIAL_DSUBU:
+        case SPECIAL_DSLL:
+        case SPECIAL_DSRL:
+        case SPECIAL_DSRA:
+        case SPECIAL_DSLLV:
+        case SPECIAL_DSRLV:
+        case SPECIAL_DSRAV:
+        case SPECIAL_DSLL32:
+        case SPECIAL_DSRL32:
+        case SPECIAL_DSRA32:
+            return false;
+        default:
+            // JR/JALR, SYSCALL, BREAK, the trapping ADD/SUB/DADD/DSUB and
+            // the TGE..TNE traps.
+            return true;
+        }
+    }
+
+    static bool mmiSubfunctionObservesPc(uint32_t function, uint8_t subfunc)
+    {
+        switch (function)
+        {
+        case MMI_MMI0:
+            switch (subfunc)
+            {
+            case MMI0_PADDW:
+            case MMI0_PSUBW:
+            case MMI0_PCGTW:
+            case MMI0_PMAXW:
+            case MMI0_PADDH:
+            case MMI0_PSUBH:
+            case MMI0_PCGTH:
+            case MMI0_PMAXH:
+            case MMI0_PADDB:
+            case MMI0_PSUBB:
+            case MMI0_PCGTB:
+            case MMI0_PADDSW:
+            case MMI0_PSUBSW:
+            case MMI0_PEXTLW:
+            case MMI0_PPACW:
+            case MMI0_PADDSH:
+            case MMI0_PSUBSH:
+            case MMI0_PEXTLH:
+            case MMI0_PPACH:
+            case MMI0_PADDSB:
+            case MMI0_PSUBSB:
+            case MMI0_PEXTLB:
+            case MMI0_PPACB:
+            case MMI0_PEXT5:
+            case MMI0_PPAC5:
+                return false;
+            default:
+                return true;
+            }
+        case MMI_MMI1:
+            switch (subfunc)
+            {
+            case MMI1_PABSW:
+            case MMI1_PCEQW:
+            case MMI1_PMINW:
+            case MMI1_PADSBH:
+            case MMI1_PABSH:
+            case MMI1_PCEQH:
+            case MMI1_PMINH:
+            case MMI1_PCEQB:
+            case MMI1_PADDUW:
+            case MMI1_PSUBUW:
+            case MMI1_PEXTUW:
+            case MMI1_PADDUH:
+            case MMI1_PSUBUH:
+            case MMI1_PEXTUH:
+            case MMI1_PADDUB:
+            case MMI1_PSUBUB:
+            case MMI1_PEXTUB:
+            case MMI1_QFSRV:
+                return false;
+            default:
+                return true;
+            }
+        case MMI_MMI2:
+            switch (subfunc)
+            {
+            case MMI2_PMADDW:
+            case MMI2_PSLLVW:
+            case MMI2_PSRLVW:
+            case MMI2_PMSUBW:
+            case MMI2_PMFHI:
+            case MMI2_PMFLO:
+            case MMI2_PINTH:
+            case MMI2_PMULTW:
+            case MMI2_PDIVW:
+            case MMI2_PCPYLD:
+            case MMI2_PMADDH:
+            case MMI2_PHMADH:
+            case MMI2_PAND:
+            case MMI2_PXOR:
+            case MMI2_PMSUBH:
+            case MMI2_PHMSBH:
+            case MMI2_PEXEH:
+            case MMI2_PREVH:
+            case MMI2_PMULTH:
+            case MMI2_PDIVBW:
+            case MMI2_PEXEW:
+            case MMI2_PROT3W:
+                return false;
+            default:
+                return true;
+            }
+        case MMI_MMI3:
+            switch (subfunc)
+            {
+            case MMI3_PMADDUW:
+            case MMI3_PSRAVW:
+            case MMI3_PMTHI:
+            case MMI3_PMTLO:
+            case MMI3_PINTEH:
+            case MMI3_PMULTUW:
+            case MMI3_PDIVUW:
+            case MMI3_PCPYUD:
+            case MMI3_POR:
+            case MMI3_PNOR:
+            case MMI3_PEXCH:
+            case MMI3_PCPYH:
+            case MMI3_PEXCW:
+                return false;
+            default:
+                return true;
+            }
+        case MMI_PMFHL:
+            switch (subfunc)
+            {
+            case PMFHL_LW:
+            case PMFHL_UW:
+            case PMFHL_SLW:
+            case PMFHL_LH:
+            case PMFHL_SH:
+                return false;
+            default:
+                return true;
+            }
+        case MMI_PMTHL:
+            return subfunc != PMFHL_LW;
+        default:
+            return true;
+        }
+    }
+
+    static bool mmiObservesPc(const Instruction &inst)
+    {
+        switch (inst.function)
+        {
+        case MMI_MFHI1:
+        case MMI_MTHI1:
+        case MMI_MFLO1:
+        case MMI_MTLO1:
+        case MMI_MULT1:
+        case MMI_MULTU1:
+        case MMI_DIV1:
+        case MMI_DIVU1:
+        case MMI_MADD:
+        case MMI_MADDU:
+        case MMI_MSUB:
+        case MMI_MSUBU:
+        case MMI_MADD1:
+        case MMI_MADDU1:
+        case MMI_PLZCW:
+        case MMI_PSLLH:
+        case MMI_PSRLH:
+        case MMI_PSRAH:
+        case MMI_PSLLW:
+        case MMI_PSRLW:
+        case MMI_PSRAW:
+            return false;
+        case MMI_MMI0:
+        case MMI_MMI1:
+        case MMI_MMI2:
+        case MMI_MMI3:
+        case MMI_PMFHL:
+        case MMI_PMTHL:
+            return mmiSubfunctionObservesPc(inst.function, inst.sa);
+        default:
+            return true;
+        }
+    }
+
+    static bool fpuObservesPc(const Instruction &inst)
+    {
+        switch (inst.rs)
+        {
+        case COP1_MF:
+        case COP1_MT:
+        case COP1_CF:
+        case COP1_CT:
+        case COP1_BC:
+            return false;
+        case COP1_S:
+            switch (inst.function)
+            {
+            case COP1_S_ADD:
+            case COP1_S_SUB:
+            case COP1_S_MUL:
+            case COP1_S_DIV:
+            case COP1_S_SQRT:
+            case COP1_S_ABS:
+            case COP1_S_MOV:
+            case COP1_S_NEG:
+            case COP1_S_ROUND_W:
+            case COP1_S_TRUNC_W:
+            case COP1_S_CEIL_W:
+            case COP1_S_FLOOR_W:
+            case COP1_S_CVT_W:
+            case COP1_S_RSQRT:
+            case COP1_S_ADDA:
+            case COP1_S_SUBA:
+            case COP1_S_MULA:
+            case COP1_S_MADD:
+            case COP1_S_MSUB:
+            case COP1_S_MADDA:
+            case COP1_S_MSUBA:
+            case COP1_S_MAX:
+            case COP1_S_MIN:
+            case COP1_S_C_F:
+            case COP1_S_C_UN:
+            case COP1_S_C_EQ:
+            case COP1_S_C_UEQ:
+            case COP1_S_C_OLT:
+            case COP1_S_C_ULT:
+            case COP1_S_C_OLE:
+            case COP1_S_C_ULE:
+            case COP1_S_C_SF:
+            case COP1_S_C_NGLE:
+            case COP1_S_C_SEQ:
+            case COP1_S_C_NGL:
+            case COP1_S_C_LT:
+            case COP1_S_C_NGE:
+            case COP1_S_C_LE:
+            case COP1_S_C_NGT:
+                return false;
+            default:
+                return true;
+            }
+        case COP1_W:
+            return inst.function != COP1_W_CVT_S;
+        default:
+            return true;
+        }
+    }
+
+    bool CodeGenerator::translationObservesPc(const Instruction &inst) const
+    {
+        if (PS2X_RECOMP_PRECISE_PC || m_emitPrecisePc)
+        {
+            return true;
+        }
+
+        if (inst.isMMI)
+        {
+            return mmiObservesPc(inst);
+        }
+
+        switch (inst.opcode)
+        {
+        case OPCODE_SPECIAL:
+            return specialObservesPc(inst.function);
+        case OPCODE_COP1:
+            return fpuObservesPc(inst);
+        case OPCODE_ADDIU:
+        case OPCODE_SLTI:
+        case OPCODE_SLTIU:
+        case OPCODE_ANDI:
+        case OPCODE_ORI:
+        case OPCODE_XORI:
+        case OPCODE_LUI:
+        case OPCODE_DADDIU:
+            return false;
+        default:
+            // ADDI/DADDI trap on overflow; loads, stores, COP0/COP2, REGIMM
+            // and branches all need the exact PC.
+            return true;
+        }
+    }
+
     std::string CodeGenerator::generateFunctionRegistration(const std::vector<Function> &functions, const std::map<uint32_t, std::string> &stubs)
     {
         FunctionTableEmitter emitter(*this);
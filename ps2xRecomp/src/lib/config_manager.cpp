@@ -64,6 +64,8 @@ namespace ps2recomp
             config.patchSyscalls = toml::find_or<bool>(general, "patch_syscalls", config.patchSyscalls);
             config.patchCop0 = toml::find_or<bool>(general, "patch_cop0", config.patchCop0);
             config.patchCache = toml::find_or<bool>(general, "patch_cache", config.patchCache);
+            config.precisePc = toml::find_or<bool>(general, "precise_pc", config.precisePc);
+            config.assumeRdramStackAndGp = toml::find_or<bool>(general, "rdram_stack", config.assumeRdramStackAndGp);
 
             if (general.contains("stubs") && general.at("stubs").is_array())
             {
@@ -274,6 +276,8 @@ namespace ps2recomp
         general["patch_syscalls"] = config.patchSyscalls;
         general["patch_cop0"] = config.patchCop0;
         general["patch_cache"] = config.patchCache;
+        general["precise_pc"] = config.precisePc;
+        general["rdram_stack"] = config.assumeRdramStackAndGp;
         general["skip"] = config.skipFunctions;
         general["stubs"] = config.stubImplementations;
         data["general"] = general;
@@ -351,6 +351,7 @@ namespace ps2recomp
                                 if (rodata && rodata->data)
                                 {
                                     std::vector<uint32_t> jrTargets;
+                                    std::vector<uint32_t> slotTargets;
                                     bool validJumpTable = true;
                                     std::unordered_set<uint32_t> uniqueTargets;
                                     for (uint32_t i = 0; i < numCases; ++i)
@@ -360,6 +361,7 @@ namespace ps2recomp
                                         {
                                             uint32_t target = 0;
                                             std::memcpy(&target, rodata->data + (addr - rodata->address), 4);
+                                            slotTargets.push_back(target);
                                             if (target >= function.start && target < function.end && instructionAddresses.contains(target))
                                             {
                                                 if (!uniqueTargets.contains(target))
@@ -387,6 +389,28 @@ namespace ps2recomp
                                             result.entryPoints.insert(t);
                                         }
                                         foundTable = true;
+
+                                        // The slot is only recoverable while the LW's base register
+                                        // survives up to and including the delay slot.
+                                        const int lastIndex = std::min(jrIndex + 1, static_cast<int>(instructions.size()) - 1);
+                                        bool slotRegisterIntact = baseReg != 0u;
+                                        for (int i = lwIndex; slotRegisterIntact && i <= lastIndex; ++i)
+                                        {
+                                            if (i == jrIndex)
+                                            {
+                                                continue;
+                                            }
+                                            const auto &inst = instructions[i];
+                                            const bool writesSlot = !inst.isStore && (inst.rt == baseReg || inst.rd == baseReg);
+                                            slotRegisterIntact = !inst.hasDelaySlot && !writesSlot;
+                                        }
+                                        if (slotRegisterIntact)
+                                        {
+                                            LocalJumpTable &localTable = result.localJumpTables[jrInst->address];
+                                            localTable.slotRegister = baseReg;
+                                            localTable.slotBase = tableAddress - static_cast<uint32_t>(lwOffset);
+                                            localTable.targets = std::move(slotTargets);
+                                        }
                                     }
                                 }
                             }
@@ -428,4 +452,121 @@ namespace ps2recomp
         return result;
     }
 
+    namespace
+    {
+        bool isConditionalBranch(const Instruction &inst)
+        {
+            switch (inst.opcode)
+            {
+            case OPCODE_BEQ:
+            case OPCODE_BNE:
+            case OPCODE_BLEZ:
+            case OPCODE_BGTZ:
+            case OPCODE_BEQL:
+            case OPCODE_BNEL:
+            case OPCODE_BLEZL:
+            case OPCODE_BGTZL:
+                return true;
+            case OPCODE_REGIMM:
+                return inst.rt == REGIMM_BLTZ || inst.rt == REGIMM_BGEZ ||
+                       inst.rt == REGIMM_BLTZL || inst.rt == REGIMM_BGEZL;
+            case OPCODE_COP1:
+                return inst.rs == COP1_BC;
+            case OPCODE_COP2:
+                return inst.rs == COP2_BC;
+            default:
+                return false;
+            }
+        }
+
+        bool mayLeaveThroughRuntime(const Instruction &inst)
+        {
+            switch (inst.opcode)
+            {
+            case OPCODE_COP0:
+            case OPCODE_ADDI:
+            case OPCODE_DADDI:
+                return true;
+            case OPCODE_SPECIAL:
+                switch (inst.function)
+                {
+                case SPECIAL_SYSCALL:
+                case SPECIAL_BREAK:
+                case SPECIAL_ADD:
+                case SPECIAL_SUB:
+                case SPECIAL_DADD:
+                case SPECIAL_DSUB:
+                case SPECIAL_TGE:
+                case SPECIAL_TGEU:
+                case SPECIAL_TLT:
+                case SPECIAL_TLTU:
+                case SPECIAL_TEQ:
+                case SPECIAL_TNE:
+                    return true;
+                default:
+                    return false;
+                }
+            case OPCODE_REGIMM:
+                return inst.rt >= REGIMM_TGEI && inst.rt <= REGIMM_TNEI;
+            default:
+                return false;
+            }
+        }
+
+        bool mayWriteReturnAddress(const Instruction &inst)
+        {
+            switch (inst.opcode)
+            {
+            case OPCODE_SPECIAL:
+            case OPCODE_MMI:
+                return inst.rd == 31u;
+            case OPCODE_REGIMM:
+                return false;
+            default:
+                return !inst.isStore && !isConditionalBranch(inst) && inst.rt == 31u;
+            }
+        }
+    }
+
+    bool isCleanCallee(const Function &function, const std::vector<Instruction> &instructions)
+    {
+        if (instructions.size() < 2u)
+        {
+            return false;
+        }
+
+        const Instruction &tail = instructions[instructions.size() - 2u];
+        if (tail.opcode != OPCODE_SPECIAL || tail.function != SPECIAL_JR || tail.rs != 31u)
+        {
+            return false;
+        }
+
+        for (const Instruction &inst : instructions)
+        {
+            if (mayLeaveThroughRuntime(inst) || mayWriteReturnAddress(inst))
+            {
+                return false;
+            }
+
+            if (isConditionalBranch(inst))
+            {
+                // Backward branches reach the EE checkpoint, so only forward
+                // in-function branches keep the return on $ra guaranteed.
+                const int32_t offsetBytes = static_cast<int32_t>(static_cast<int16_t>(inst.simmediate)) << 2;
+                const uint32_t target = inst.address + 4u + static_cast<uint32_t>(offsetBytes);
+                if (target <= inst.address || target >= function.end)
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if (inst.hasDelaySlot && !(inst.opcode == OPCODE_SPECIAL && inst.function == SPECIAL_JR && inst.rs == 31u))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
 }
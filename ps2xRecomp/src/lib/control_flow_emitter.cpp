@@ -131,11 +131,17 @@ namespace ps2recomp
             return;
         }
 
-        m_ss << fmt::format("{}ctx->pc = 0x{:X}u;\n", indent, delayPc());
-        m_ss << fmt::format("{}ctx->in_delay_slot = true;\n", indent);
-        m_ss << fmt::format("{}ctx->branch_pc = 0x{:X}u;\n", indent, branchPc());
-
+        // The delay slot state is only visible to the runtime, so a pure
+        // register op in the slot skips publishing it.
         const std::string code = delaySlotCode();
+        const bool observesPc = !m_delaySlotOverride.empty() || m_gen.translationObservesPc(m_delaySlot);
+        if (observesPc)
+        {
+            m_ss << fmt::format("{}ctx->pc = 0x{:X}u;\n", indent, delayPc());
+            m_ss << fmt::format("{}ctx->in_delay_slot = true;\n", indent);
+            m_ss << fmt::format("{}ctx->branch_pc = 0x{:X}u;\n", indent, branchPc());
+        }
+
         std::istringstream lines(code);
         std::string line;
         while (std::getline(lines, line))
@@ -146,7 +152,10 @@ namespace ps2recomp
             }
         }
 
-        m_ss << fmt::format("{}ctx->in_delay_slot = false;\n", indent);
+        if (observesPc)
+        {
+            m_ss << fmt::format("{}ctx->in_delay_slot = false;\n", indent);
+        }
     }
 
     void ControlFlowEmitter::emitResumeFromDelaySlotEntry()
@@ -207,6 +216,30 @@ namespace ps2recomp
         m_ss << fmt::format("{}}}\n", indent);
     }
 
+    void ControlFlowEmitter::emitCachedRuntimeBranchDispatch(std::string_view targetExpression,
+                                                             uint32_t sourcePc,
+                                                             uint32_t returnPc,
+                                                             std::string_view runtimeKind,
+                                                             std::string_view debugName,
+                                                             std::string_view indent)
+    {
+        // One inline cache per register branch; the full dispatch only runs
+        // when the target is not among the callsite's recent targets.
+        const std::string cacheName = fmt::format("branchCache_0x{:x}", sourcePc);
+        m_ss << fmt::format("{}static PS2Runtime::GuestBranchCache {};\n", indent, cacheName);
+        m_ss << fmt::format(
+            "{}if (!runtime->dispatchCachedGuestBranch(rdram, ctx, {}, 0x{:X}u, 0x{:X}u, PS2Runtime::GuestBranchKind::{}, \"{}\", {})) {{\n",
+            indent,
+            targetExpression,
+            sourcePc,
+            returnPc,
+            runtimeKind,
+            debugName,
+            cacheName);
+        m_ss << fmt::format("{}    return;\n", indent);
+        m_ss << fmt::format("{}}}\n", indent);
+    }
+
     bool ControlFlowEmitter::emitDirectFunctionJumpIfAvailable(uint32_t target, StaticBranchKind kind, std::string_view indent)
     {
         if (kind != StaticBranchKind::Jump)
@@ -224,6 +257,43 @@ namespace ps2recomp
         return true;
     }
 
+    bool ControlFlowEmitter::emitDirectFunctionCallIfAvailable(uint32_t target, std::string_view indent)
+    {
+        const std::string functionName = m_gen.getFunctionName(target);
+        if (functionName.empty())
+        {
+            return false;
+        }
+
+        // The table compare keeps runtime overrides of the callee working; they
+        // take the dispatcher path like any other call. Unlike the dispatcher,
+        // a direct call does not charge eeCheckpointDue, so a thread making
+        // only straight-line calls is preempted later than before; backward
+        // branches and dispatched jumps still reach the checkpoint.
+        m_ss << fmt::format("{}if (ps2GuestFunctionAt(0x{:X}u) == &{}) {{\n", indent, target, functionName);
+        m_ss << fmt::format("{}    {}(rdram, ctx, runtime);\n", indent, functionName);
+        if (m_gen.m_cleanCallTargets.contains(target))
+        {
+            m_ss << indent << "#if defined(PS2X_STRICT_CALL_DIAGNOSTICS) && PS2X_STRICT_CALL_DIAGNOSTICS\n";
+            m_ss << fmt::format("{}    if (ctx->pc != 0x{:X}u) {{\n", indent, fallthroughPc());
+            m_ss << fmt::format("{}        runtime->reportUncleanCall(ctx, 0x{:X}u, 0x{:X}u, 0x{:X}u);\n",
+                                indent, target, branchPc(), fallthroughPc());
+            m_ss << fmt::format("{}        return;\n", indent);
+            m_ss << fmt::format("{}    }}\n", indent);
+            m_ss << indent << "#endif\n";
+        }
+        else
+        {
+            m_ss << fmt::format("{}    if (ctx->pc != 0x{:X}u && ctx->pc != 0x{:X}u) {{\n", indent, fallthroughPc(), target);
+            m_ss << fmt::format("{}        return;\n", indent);
+            m_ss << fmt::format("{}    }}\n", indent);
+        }
+        m_ss << fmt::format("{}}} else {{\n", indent);
+        emitExternalJumpDispatch(target, StaticBranchKind::Call, fmt::format("{}    ", indent));
+        m_ss << fmt::format("{}}}\n", indent);
+        return true;
+    }
+
     void ControlFlowEmitter::emitExternalJumpDispatch(uint32_t target, StaticBranchKind kind, std::string_view indent)
     {
         const bool isCall = kind == StaticBranchKind::Call;
@@ -238,13 +308,12 @@ namespace ps2recomp
 
     void ControlFlowEmitter::emitExternalRegisterCallDispatch(std::string_view jumpTargetExpression, std::string_view indent)
     {
-        emitRuntimeBranchDispatch(jumpTargetExpression,
-                                  branchPc(),
-                                  fallthroughPc(),
-                                  "IndirectCall",
-                                  "JALR",
-                                  indent,
-                                  true);
+        emitCachedRuntimeBranchDispatch(jumpTargetExpression,
+                                        branchPc(),
+                                        fallthroughPc(),
+                                        "IndirectCall",
+                                        "JALR",
+                                        indent);
     }
 
     void ControlFlowEmitter::emitExternalRegisterJumpDispatch(std::string_view jumpTargetExpression,
@@ -268,13 +337,12 @@ namespace ps2recomp
             return;
         }
 
-        emitRuntimeBranchDispatch(jumpTargetExpression,
-                                  branchPc(),
-                                  0u,
-                                  "IndirectJump",
-                                  "JR",
-                                  indent,
-                                  true);
+        emitCachedRuntimeBranchDispatch(jumpTargetExpression,
+                                        branchPc(),
+                                        0u,
+                                        "IndirectJump",
+                                        "JR",
+                                        indent);
     }
 
     bool ControlFlowEmitter::emitRelocationCallIfAvailable(StaticBranchKind kind, std::string_view indent)
@@ -343,6 +411,11 @@ namespace ps2recomp
             return;
         }
 
+        if (kind == StaticBranchKind::Call && emitDirectFunctionCallIfAvailable(target, "    "))
+        {
+            return;
+        }
+
         if (emitDirectFunctionJumpIfAvailable(target, kind, "    "))
         {
             return;
@@ -356,9 +429,19 @@ namespace ps2recomp
         const uint8_t rsReg = static_cast<uint8_t>(m_branchInst.rs);
         const uint8_t rdReg = static_cast<uint8_t>(m_branchInst.rd);
         const std::vector<uint32_t> sortedInternalTargets = resolvedLocalIndirectTargets();
+        const auto localTableIt = m_analysisResult.localJumpTables.find(m_branchInst.address);
+        const LocalJumpTable *localTable =
+            (!sortedInternalTargets.empty() && localTableIt != m_analysisResult.localJumpTables.end())
+                ? &localTableIt->second
+                : nullptr;
 
         m_ss << "    {\n";
         m_ss << "        const uint32_t jumpTarget = GPR_U32(ctx, " << static_cast<int>(rsReg) << ");\n";
+        if (localTable)
+        {
+            m_ss << fmt::format("        const uint32_t jumpSlot = (GPR_U32(ctx, {}) - 0x{:X}u) >> 2;\n",
+                                localTable->slotRegister, localTable->slotBase);
+        }
 
         if (kind == RegisterBranchKind::Call && rdReg != 0u)
         {
@@ -368,6 +451,11 @@ namespace ps2recomp
         emitDelaySlot("        ");
         m_ss << "        ctx->pc = jumpTarget;\n";
 
+        if (localTable)
+        {
+            m_ss << m_gen.generateJumpTableSwitch(*localTable, m_analysisResult.entryPoints, "        ");
+        }
+
         if (!sortedInternalTargets.empty())
         {
             m_ss << "        switch (jumpTarget) {\n";
@@ -4,6 +4,7 @@
 #include "ps2recomp/instructions.h"
 #include "ps2recomp/r5900_decoder.h"
 #include "ps2recomp/recompiler_reporter.h"
+#include "ps2recomp/register_fact_analyzer.h"
 #include "ps2recomp/types.h"
 
 #include <algorithm>
@@ -57,9 +58,11 @@ namespace ps2recomp
         CodeGenerator::AnalysisResult analysisResult = cg.collectInternalBranchTargets(function, instructions);
         std::vector<uint32_t> resumeTargets(analysisResult.resumeEntryPoints.begin(),
                                             analysisResult.resumeEntryPoints.end());
+        std::vector<uint32_t> ownerResumeTargets;
         auto resumeIt = cg.m_resumeEntryTargetsByOwner.find(function.start);
         if (resumeIt != cg.m_resumeEntryTargetsByOwner.end())
         {
+            ownerResumeTargets = resumeIt->second;
             resumeTargets.insert(resumeTargets.end(), resumeIt->second.begin(), resumeIt->second.end());
         }
         std::sort(resumeTargets.begin(), resumeTargets.end());
@@ -70,7 +73,9 @@ namespace ps2recomp
         }
 
         const std::unordered_set<uint32_t> &internalTargets = analysisResult.entryPoints;
-        ConstantRegisterState constantRegisters;
+        const std::vector<RegisterFacts> registerFacts =
+            analyzeRegisterFacts(function, instructions, analysisResult, ownerResumeTargets,
+                                 cg.m_assumeRdramStackAndGp);
         GifDmaKickPlan gifDmaKickPlan{};
         ss << "// Function: " << function.name << "\n";
         ss << "// Address: 0x" << std::hex << function.start << " - 0x" << function.end << std::dec << "\n";
@@ -112,7 +117,6 @@ namespace ps2recomp
 
             if (internalTargets.contains(inst.address))
             {
-                constantRegisters.clear();
                 ss << "label_" << std::hex << inst.address << std::dec << ":\n";
             }
 
@@ -174,13 +178,12 @@ namespace ps2recomp
                     {
                         ++i; // Skip delay slot instruction (handled inside branch logic)
                     }
-                    constantRegisters.clear();
                 }
                 else
                 {
                     if (!gifDmaKickPlan.valid)
                     {
-                        gifDmaKickPlan = tryBuildGifDmaKickPlan(instructions, i, constantRegisters, internalTargets);
+                        gifDmaKickPlan = tryBuildGifDmaKickPlan(instructions, i, registerFacts[i].constants(), internalTargets);
                     }
 
                     if (gifDmaKickPlan.suppresses(i))
@@ -196,21 +199,22 @@ namespace ps2recomp
                             gifDmaKickPlan = {};
                         }
 
-                        updateConstantRegisters(inst, constantRegisters);
                         continue;
                     }
 
-                    ss << "    ctx->pc = 0x" << std::hex << inst.address << "u;\n"
-                       << std::dec;
-                    const MemoryAccessHint memoryHint = resolveMemoryAccessHint(inst, constantRegisters);
-                    ss << "    " << cg.translateInstruction(inst, memoryHint);
+                    const MemoryAccessHint memoryHint = resolveMemoryAccessHint(inst, registerFacts[i]);
+                    const std::string code = cg.translateInstruction(inst, memoryHint);
+                    if (cg.translationObservesPc(inst))
+                    {
+                        ss << "    ctx->pc = 0x" << std::hex << inst.address << "u;\n"
+                           << std::dec;
+                    }
+                    ss << "    " << code;
                     if (inst.isMmio)
                     {
                         ss << " // MMIO: 0x" << std::hex << inst.mmioAddress << std::dec;
                     }
                     ss << "\n";
-
-                    updateConstantRegisters(inst, constantRegisters);
                 }
             }
             catch (const std::exception &e)
@@ -39,9 +39,8 @@ namespace ps2recomp
             }
         }
 
-        std::string genFastWrite(int width, uint32_t address, const std::string &val)
+        std::string genFastWrite(int width, const std::string &addr, const std::string &val)
         {
-            const std::string addr = addressLiteral(address);
             if (width == 128)
             {
                 return fmt::format(
@@ -60,6 +59,14 @@ namespace ps2recomp
                 "FAST_WRITE{}({}, _value); }} while (0)",
                 valueType, valueType, val, addr, memoryAccessSize(width), width, width, addr);
         }
+
+        // The address expression is evaluated once, ahead of the value, the same
+        // way the WRITEn macros do it.
+        std::string genFastWriteToExpr(int width, const std::string &addr, const std::string &val)
+        {
+            return fmt::format("do {{ uint32_t _addr = (uint32_t)({}); {}; }} while (0)",
+                               addr, genFastWrite(width, "_addr", val));
+        }
     }
 
     InstructionTranslator::InstructionTranslator(CodeGenerator &codeGenerator)
@@ -95,10 +102,14 @@ namespace ps2recomp
             return fmt::format("FAST_READ{}({})", width, resolvedAddressExpr);
         }
 
-        if (inst.isMmio)
+        if (inst.isMmio || memoryHint.region == MemoryRegion::Scratchpad || memoryHint.region == MemoryRegion::Mmio)
         {
             return fmt::format("runtime->Load{}(rdram, ctx, {})", width, addr);
         }
+        if (memoryHint.region == MemoryRegion::Rdram)
+        {
+            return fmt::format("FAST_READ{}({})", width, addr);
+        }
         return fmt::format("READ{}({})", width, addr);
     }
 
@@ -116,13 +127,17 @@ namespace ps2recomp
             {
                 return fmt::format("runtime->Store{}(rdram, ctx, {}, {})", width, resolvedAddressExpr, value);
             }
-            return genFastWrite(width, resolvedAddress, value);
+            return genFastWrite(width, resolvedAddressExpr, value);
         }
 
-        if (inst.isMmio)
+        if (inst.isMmio || memoryHint.region == MemoryRegion::Scratchpad || memoryHint.region == MemoryRegion::Mmio)
         {
             return fmt::format("runtime->Store{}(rdram, ctx, {}, {})", width, addr, value);
         }
+        if (memoryHint.region == MemoryRegion::Rdram)
+        {
+            return genFastWriteToExpr(width, addr, value);
+        }
         return fmt::format("WRITE{}({}, {})", width, addr, value);
     }
 
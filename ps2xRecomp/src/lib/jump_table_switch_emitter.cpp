@@ -1,44 +1,33 @@
 #include "ps2recomp/code_generator.h"
-#include "ps2recomp/codegen_helpers.h"
-#include "ps2recomp/instructions.h"
-#include "ps2recomp/types.h"
 #include <fmt/format.h>
 #include <sstream>
-#include <cmath>
 
 namespace ps2recomp
 {
-    std::string CodeGenerator::generateJumpTableSwitch(const Instruction &inst, uint32_t tableAddress,
-                                                       const std::vector<JumpTableEntry> &entries)
+    // Dispatches on the table slot rather than the loaded target, so the cases
+    // are dense and the host compiler lowers them to its own jump table. Each
+    // case still checks the loaded target, which keeps a table patched at run
+    // time on the slower paths that follow.
+    std::string CodeGenerator::generateJumpTableSwitch(const LocalJumpTable &table,
+                                                       const std::unordered_set<uint32_t> &internalTargets,
+                                                       std::string_view indent) const
     {
         std::stringstream ss;
 
-        uint32_t indexReg = inst.rs;
-
-        ss << "switch (GPR_U32(ctx, " << indexReg << ")) {\n";
-
-        for (const auto &[index, target] : entries)
+        ss << indent << "switch (jumpSlot) {\n";
+        for (size_t slot = 0; slot < table.targets.size(); ++slot)
         {
-            ss << "    case " << index << ": {\n";
-
-            std::string funcName = getFunctionName(target);
-            if (!funcName.empty())
+            const uint32_t target = table.targets[slot];
+            if (!internalTargets.contains(target))
             {
-                ss << "        " << funcName << "(rdram, ctx, runtime);\n";
-            }
-            else
-            {
-                ss << "        func_" << std::hex << target << std::dec << "(rdram, ctx,  runtime);\n";
+                continue;
             }
 
-            ss << "        return;\n";
-            ss << "    }\n";
+            ss << fmt::format("{}    case {}u: if (jumpTarget == 0x{:X}u) goto label_{:x}; break;\n",
+                              indent, slot, target, target);
         }
-
-        ss << "    default:\n";
-        ss << "        // Unknown jump table target\n";
-        ss << "        return;\n";
-        ss << "}\n";
+        ss << indent << "    default: break;\n";
+        ss << indent << "}\n";
 
         return ss.str();
     }
@@ -916,6 +916,8 @@ namespace ps2recomp
             m_codeGenerator->setBootstrapInfo(m_bootstrapInfo);
             m_codeGenerator->setConfiguredJumpTables(m_config.jumpTables);
             m_codeGenerator->setEmitInstructionComments(true);
+            m_codeGenerator->setEmitPrecisePc(m_config.precisePc);
+            m_codeGenerator->setAssumeRdramStackAndGp(m_config.assumeRdramStackAndGp);
 
             fs::create_directories(m_config.outputPath);
 
@@ -1901,6 +1903,25 @@ namespace ps2recomp
 
         m_codeGenerator->setResumeEntryTargets(m_resumeEntryTargetsByOwner);
 
+        // A callee with resume entries can be re-entered mid-body by the
+        // dispatcher, so only functions without any are candidates.
+        std::unordered_set<uint32_t> cleanCallTargets;
+        for (const auto &function : m_functions)
+        {
+            if (!function.isRecompiled || function.isStub || function.isSkipped ||
+                isEntryFunctionName(function.name) || m_resumeEntryTargetsByOwner.contains(function.start))
+            {
+                continue;
+            }
+
+            auto decodedIt = m_decodedFunctions.find(function.start);
+            if (decodedIt != m_decodedFunctions.end() && isCleanCallee(function, decodedIt->second))
+            {
+                cleanCallTargets.insert(function.start);
+            }
+        }
+        m_codeGenerator->setCleanCallTargets(cleanCallTargets);
+
         if (totalTargets > 0u)
         {
             m_reporter.recordAdditionalEntryPoints(totalTargets);
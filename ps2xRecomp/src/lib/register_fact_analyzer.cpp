@@ -0,0 +1,515 @@
+#include "ps2recomp/register_fact_analyzer.h"
+
+#include "ps2recomp/control_flow_utils.h"
+#include "ps2recomp/instructions.h"
+#include "runtime/ps2_address.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ps2recomp
+{
+    namespace
+    {
+        constexpr uint32_t kGpReg = 28u;
+        constexpr uint32_t kSpReg = 29u;
+        constexpr uint32_t kRaReg = 31u;
+
+        // Offsets up to a 16-bit displacement keep a stack or small-data
+        // pointer inside RDRAM; anything larger could walk into a mirror.
+        constexpr int32_t kMaxRegionOffset = 0xFFFF;
+
+        bool isSmallOffset(uint32_t value)
+        {
+            const int32_t offset = static_cast<int32_t>(value);
+            return offset >= -kMaxRegionOffset && offset <= kMaxRegionOffset;
+        }
+
+        MemoryRegion regionOf(const RegisterFact &fact)
+        {
+            switch (fact.kind)
+            {
+            case RegisterFact::Kind::Constant:
+                return classifyGuestAddress(fact.value);
+            case RegisterFact::Kind::Region:
+                return fact.region;
+            default:
+                return MemoryRegion::Unknown;
+            }
+        }
+
+        RegisterFact joinFacts(const RegisterFact &lhs, const RegisterFact &rhs)
+        {
+            if (lhs == rhs)
+                return lhs;
+
+            const MemoryRegion region = regionOf(lhs);
+            if (region != MemoryRegion::Unknown && region == regionOf(rhs))
+                return RegisterFact::inRegion(region);
+
+            return RegisterFact::unknown();
+        }
+
+        RegisterFact addFacts(const RegisterFact &lhs, const RegisterFact &rhs)
+        {
+            using Kind = RegisterFact::Kind;
+
+            if (lhs.kind == Kind::Constant && rhs.kind == Kind::Constant)
+                return RegisterFact::constant(lhs.value + rhs.value);
+            if (rhs.kind == Kind::Constant && rhs.value == 0u)
+                return lhs;
+            if (lhs.kind == Kind::Constant && lhs.value == 0u)
+                return rhs;
+
+            // Anything added to a special region still goes through the
+            // runtime, which handles every address; RDRAM only survives a
+            // small displacement. A constant that fits a displacement is the
+            // offset, not the base, whatever region its bits fall in.
+            for (const auto &[pointer, offset] : {std::pair{lhs, rhs}, std::pair{rhs, lhs}})
+            {
+                if (pointer.kind == Kind::Constant && isSmallOffset(pointer.value))
+                    continue;
+
+                const MemoryRegion region = regionOf(pointer);
+                if (region == MemoryRegion::Scratchpad || region == MemoryRegion::Mmio)
+                    return RegisterFact::inRegion(region);
+                if (pointer.kind == Kind::Region && region == MemoryRegion::Rdram &&
+                    offset.kind == Kind::Constant && isSmallOffset(offset.value))
+                    return RegisterFact::inRegion(region);
+            }
+
+            return RegisterFact::unknown();
+        }
+
+        RegisterFact constantOp(const RegisterFact &lhs, const RegisterFact &rhs, uint32_t (*op)(uint32_t, uint32_t))
+        {
+            if (lhs.kind == RegisterFact::Kind::Constant && rhs.kind == RegisterFact::Kind::Constant)
+                return RegisterFact::constant(op(lhs.value, rhs.value));
+            return RegisterFact::unknown();
+        }
+
+        uint32_t branchTarget(const Instruction &inst)
+        {
+            const int32_t offsetBytes = static_cast<int32_t>(static_cast<int16_t>(inst.simmediate)) << 2;
+            return static_cast<uint32_t>(static_cast<int64_t>(inst.address + 4u) + offsetBytes);
+        }
+
+        bool isRegimmLink(const Instruction &inst)
+        {
+            return inst.opcode == OPCODE_REGIMM &&
+                   (inst.rt == REGIMM_BLTZAL || inst.rt == REGIMM_BGEZAL ||
+                    inst.rt == REGIMM_BLTZALL || inst.rt == REGIMM_BGEZALL);
+        }
+
+        enum class FlowKind
+        {
+            Conditional,
+            Jump,
+            RegisterJump,
+            Call
+        };
+
+        FlowKind flowKindOf(const Instruction &inst)
+        {
+            if (inst.opcode == OPCODE_J)
+                return FlowKind::Jump;
+            if (inst.opcode == OPCODE_JAL || isRegimmLink(inst))
+                return FlowKind::Call;
+            if (inst.opcode == OPCODE_SPECIAL && inst.function == SPECIAL_JALR)
+                return FlowKind::Call;
+            if (inst.opcode == OPCODE_SPECIAL && inst.function == SPECIAL_JR)
+                return FlowKind::RegisterJump;
+            return FlowKind::Conditional;
+        }
+    }
+
+    RegisterFact RegisterFact::unknown()
+    {
+        return {};
+    }
+
+    RegisterFact RegisterFact::constant(uint32_t value)
+    {
+        RegisterFact fact{};
+        fact.kind = Kind::Constant;
+        fact.value = value;
+        return fact;
+    }
+
+    RegisterFact RegisterFact::inRegion(MemoryRegion region)
+    {
+        RegisterFact fact{};
+        fact.kind = region == MemoryRegion::Unknown ? Kind::Unknown : Kind::Region;
+        fact.region = region;
+        return fact;
+    }
+
+    RegisterFacts RegisterFacts::entry(bool assumeRdramStackAndGp)
+    {
+        RegisterFacts facts{};
+        facts.reached = true;
+        facts.regs[0] = RegisterFact::constant(0u);
+        if (assumeRdramStackAndGp)
+        {
+            facts.regs[kGpReg] = RegisterFact::inRegion(MemoryRegion::Rdram);
+            facts.regs[kSpReg] = RegisterFact::inRegion(MemoryRegion::Rdram);
+        }
+        return facts;
+    }
+
+    RegisterFacts RegisterFacts::clobbered() const
+    {
+        RegisterFacts facts{};
+        facts.reached = reached;
+        facts.regs[0] = RegisterFact::constant(0u);
+        facts.regs[kGpReg] = regs[kGpReg];
+        facts.regs[kSpReg] = regs[kSpReg];
+        return facts;
+    }
+
+    bool RegisterFacts::join(const RegisterFacts &other)
+    {
+        if (!other.reached)
+            return false;
+
+        if (!reached)
+        {
+            *this = other;
+            return true;
+        }
+
+        bool changed = false;
+        for (size_t reg = 1; reg < regs.size(); ++reg)
+        {
+            const RegisterFact joined = joinFacts(regs[reg], other.regs[reg]);
+            if (!(joined == regs[reg]))
+            {
+                regs[reg] = joined;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    void RegisterFacts::set(uint32_t reg, const RegisterFact &fact)
+    {
+        if (reg == 0 || reg >= regs.size())
+            return;
+
+        regs[reg] = fact;
+    }
+
+    const RegisterFact &RegisterFacts::get(uint32_t reg) const
+    {
+        static const RegisterFact kUnknown{};
+        return reg < regs.size() ? regs[reg] : kUnknown;
+    }
+
+    ConstantRegisterState RegisterFacts::constants() const
+    {
+        ConstantRegisterState state;
+        for (uint32_t reg = 1; reg < regs.size(); ++reg)
+        {
+            if (regs[reg].kind == RegisterFact::Kind::Constant)
+                state.write(reg, regs[reg].value);
+        }
+        return state;
+    }
+
+    MemoryRegion classifyGuestAddress(uint32_t address)
+    {
+        if (!Ps2IsSpecialAddress(address))
+            return MemoryRegion::Rdram;
+
+        if (!Ps2IsKseg23Address(address) &&
+            Ps2AddressInRange(Ps2PhysicalAddress(address), PS2_SCRATCHPAD_BASE, PS2_SCRATCHPAD_SIZE))
+            return MemoryRegion::Scratchpad;
+
+        return MemoryRegion::Mmio;
+    }
+
+    void applyRegisterFacts(const Instruction &inst, RegisterFacts &facts)
+    {
+        const RegisterFact &rs = facts.get(inst.rs);
+        const RegisterFact &rt = facts.get(inst.rt);
+        const RegisterFact imm = RegisterFact::constant(inst.simmediate);
+        const RegisterFact uimm = RegisterFact::constant(inst.immediate & 0xFFFFu);
+
+        switch (inst.opcode)
+        {
+        case OPCODE_LUI:
+            facts.set(inst.rt, RegisterFact::constant(inst.immediate << 16));
+            return;
+        case OPCODE_ADDI:
+        case OPCODE_ADDIU:
+        case OPCODE_DADDI:
+        case OPCODE_DADDIU:
+            facts.set(inst.rt, addFacts(rs, imm));
+            return;
+        case OPCODE_ORI:
+            facts.set(inst.rt, constantOp(rs, uimm, [](uint32_t a, uint32_t b) { return a | b; }));
+            return;
+        case OPCODE_ANDI:
+            facts.set(inst.rt, constantOp(rs, uimm, [](uint32_t a, uint32_t b) { return a & b; }));
+            return;
+        case OPCODE_XORI:
+            facts.set(inst.rt, constantOp(rs, uimm, [](uint32_t a, uint32_t b) { return a ^ b; }));
+            return;
+        case OPCODE_SB:
+        case OPCODE_SH:
+        case OPCODE_SWL:
+        case OPCODE_SW:
+        case OPCODE_SDL:
+        case OPCODE_SDR:
+        case OPCODE_SWR:
+        case OPCODE_SD:
+        case OPCODE_SQ:
+        case OPCODE_SWC1:
+        case OPCODE_SDC1:
+        case OPCODE_SDC2:
+        case OPCODE_CACHE:
+        case OPCODE_PREF:
+        case OPCODE_BEQ:
+        case OPCODE_BNE:
+        case OPCODE_BLEZ:
+        case OPCODE_BGTZ:
+        case OPCODE_BEQL:
+        case OPCODE_BNEL:
+        case OPCODE_BLEZL:
+        case OPCODE_BGTZL:
+        case OPCODE_J:
+            return;
+        case OPCODE_JAL:
+            facts.set(kRaReg, RegisterFact::constant(inst.address + 8u));
+            return;
+        case OPCODE_REGIMM:
+            if (isRegimmLink(inst))
+                facts.set(kRaReg, RegisterFact::constant(inst.address + 8u));
+            return;
+        case OPCODE_MMI:
+            facts.set(inst.rd, RegisterFact::unknown());
+            return;
+        case OPCODE_COP0:
+        case OPCODE_COP1:
+        case OPCODE_COP2:
+            // Only the move-from forms write a GPR, and they all use rt.
+            facts.set(inst.rt, RegisterFact::unknown());
+            return;
+        case OPCODE_SPECIAL:
+            switch (inst.function)
+            {
+            case SPECIAL_ADD:
+            case SPECIAL_ADDU:
+            case SPECIAL_DADD:
+            case SPECIAL_DADDU:
+                facts.set(inst.rd, addFacts(rs, rt));
+                return;
+            case SPECIAL_OR:
+                if (inst.rt == 0u)
+                    facts.set(inst.rd, rs);
+                else if (inst.rs == 0u)
+                    facts.set(inst.rd, rt);
+                else
+                    facts.set(inst.rd, constantOp(rs, rt, [](uint32_t a, uint32_t b) { return a | b; }));
+                return;
+            case SPECIAL_SUBU:
+            case SPECIAL_DSUBU:
+                facts.set(inst.rd, constantOp(rs, rt, [](uint32_t a, uint32_t b) { return a - b; }));
+                return;
+            case SPECIAL_MOVZ:
+            case SPECIAL_MOVN:
+            {
+                RegisterFact moved = facts.get(inst.rd);
+                moved = joinFacts(moved, rs);
+                facts.set(inst.rd, moved);
+                return;
+            }
+            case SPECIAL_JR:
+            case SPECIAL_SYNC:
+            case SPECIAL_BREAK:
+                return;
+            case SPECIAL_SYSCALL:
+                facts = facts.clobbered();
+                return;
+            default:
+                facts.set(inst.rd, RegisterFact::unknown());
+                return;
+            }
+        default:
+            // Loads and anything not modelled: the destination is rt or rd.
+            facts.set(inst.rt, RegisterFact::unknown());
+            facts.set(inst.rd, RegisterFact::unknown());
+            return;
+        }
+    }
+
+    std::vector<RegisterFacts> analyzeRegisterFacts(const Function &function,
+                                                    const std::vector<Instruction> &instructions,
+                                                    const ControlFlowAnalysisResult &analysis,
+                                                    const std::vector<uint32_t> &resumeEntryTargets,
+                                                    bool assumeRdramStackAndGp)
+    {
+        const size_t count = instructions.size();
+        std::vector<RegisterFacts> in(count);
+        if (count == 0)
+            return in;
+
+        std::unordered_map<uint32_t, size_t> indexByAddress;
+        indexByAddress.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            indexByAddress.emplace(instructions[i].address, i);
+
+        auto indexOf = [&](uint32_t address) -> size_t
+        {
+            const auto it = indexByAddress.find(address);
+            return it == indexByAddress.end() ? count : it->second;
+        };
+
+        // Labels reached only through edges modelled below keep their facts.
+        // Every other label (resume points, external entries) can be entered
+        // with arbitrary registers, and so can the owner-registered resume
+        // targets and indirect fallbacks even when a local branch also
+        // reaches them.
+        std::unordered_set<uint32_t> modelledTargets;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Instruction &inst = instructions[i];
+            if (!inst.hasDelaySlot)
+                continue;
+
+            const FlowKind kind = flowKindOf(inst);
+            if (kind == FlowKind::Conditional)
+                modelledTargets.insert(branchTarget(inst));
+            else if (kind == FlowKind::Jump)
+                modelledTargets.insert(buildAbsoluteJumpTarget(inst.address, inst.target));
+            else if (kind == FlowKind::RegisterJump)
+            {
+                const auto tableIt = analysis.jumpTableTargets.find(inst.address);
+                if (tableIt != analysis.jumpTableTargets.end())
+                    modelledTargets.insert(tableIt->second.begin(), tableIt->second.end());
+            }
+        }
+
+        const RegisterFacts entryFacts = RegisterFacts::entry(assumeRdramStackAndGp);
+        std::vector<bool> arbitraryEntry(count, false);
+        arbitraryEntry[0] = true;
+        for (uint32_t address : analysis.entryPoints)
+        {
+            const size_t index = indexOf(address);
+            if (index < count && (!modelledTargets.contains(address) || address == function.start))
+                arbitraryEntry[index] = true;
+        }
+        auto markArbitrary = [&](uint32_t address)
+        {
+            const size_t index = indexOf(address);
+            if (index < count)
+                arbitraryEntry[index] = true;
+        };
+        for (uint32_t address : resumeEntryTargets)
+            markArbitrary(address);
+        for (uint32_t address : analysis.indirectFallbackEntryPoints)
+            markArbitrary(address);
+
+        std::vector<bool> queued(count, false);
+        std::vector<size_t> worklist;
+        worklist.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (arbitraryEntry[i])
+            {
+                in[i].join(entryFacts);
+                worklist.push_back(i);
+                queued[i] = true;
+            }
+        }
+
+        auto flowTo = [&](size_t index, const RegisterFacts &facts)
+        {
+            if (index >= count)
+                return;
+            if (in[index].join(facts) && !queued[index])
+            {
+                queued[index] = true;
+                worklist.push_back(index);
+            }
+        };
+
+        while (!worklist.empty())
+        {
+            const size_t i = worklist.back();
+            worklist.pop_back();
+            queued[i] = false;
+
+            const Instruction &inst = instructions[i];
+            RegisterFacts out = in[i];
+            applyRegisterFacts(inst, out);
+
+            if (!inst.hasDelaySlot)
+            {
+                flowTo(i + 1, out);
+                continue;
+            }
+
+            // The delay slot only runs after its branch, so propagate
+            // through it here and branch from the facts after it.
+            const bool hasDelaySlot = i + 1 < count && instructions[i + 1].address == inst.address + 4u;
+            RegisterFacts afterSlot = out;
+            if (hasDelaySlot)
+            {
+                flowTo(i + 1, out);
+                applyRegisterFacts(instructions[i + 1], afterSlot);
+            }
+            const size_t fallthrough = hasDelaySlot ? i + 2 : i + 1;
+
+            switch (flowKindOf(inst))
+            {
+            case FlowKind::Conditional:
+                flowTo(indexOf(branchTarget(inst)), afterSlot);
+                // Likely branches skip the slot when not taken.
+                flowTo(fallthrough, out);
+                flowTo(fallthrough, afterSlot);
+                break;
+            case FlowKind::Jump:
+                flowTo(indexOf(buildAbsoluteJumpTarget(inst.address, inst.target)), afterSlot);
+                break;
+            case FlowKind::RegisterJump:
+            {
+                const auto tableIt = analysis.jumpTableTargets.find(inst.address);
+                if (tableIt != analysis.jumpTableTargets.end())
+                {
+                    for (uint32_t target : tableIt->second)
+                        flowTo(indexOf(target), afterSlot);
+                }
+                break;
+            }
+            case FlowKind::Call:
+                // A conditional link branch can also fall through untaken.
+                if (inst.opcode == OPCODE_REGIMM)
+                    flowTo(fallthrough, afterSlot);
+                flowTo(fallthrough, afterSlot.clobbered());
+                break;
+            }
+        }
+
+        return in;
+    }
+
+    MemoryAccessHint resolveMemoryAccessHint(const Instruction &inst, const RegisterFacts &facts)
+    {
+        MemoryAccessHint hint{};
+        if (!isDirectMemoryAccess(inst) || !facts.reached)
+            return hint;
+
+        const RegisterFact &base = facts.get(inst.rs);
+        if (base.kind == RegisterFact::Kind::Constant)
+        {
+            hint.hasAddress = true;
+            hint.address = base.value + inst.simmediate;
+            hint.region = classifyGuestAddress(hint.address);
+            return hint;
+        }
+
+        hint.region = addFacts(base, RegisterFact::constant(inst.simmediate)).region;
+        return hint;
+    }
+}
@@ -54,11 +54,36 @@ enum PS2Exception
     EXCEPTION_TRAP = 0x0D,             // Trap instruction condition met
 };
 
+// One 128-bit R5900 GPR. Most instructions only touch the low doubleword, so
+// scalar code goes through lo/hi and stays in integer registers; MMI and
+// LQ/SQ use the vector view, which loads and stores the same 16 bytes.
+struct alignas(16) R5900Gpr
+{
+    uint64_t lo;
+    uint64_t hi;
+
+    R5900Gpr() = default;
+    R5900Gpr(__m128i value) { setVec(value); }
+
+    R5900Gpr &operator=(__m128i value)
+    {
+        setVec(value);
+        return *this;
+    }
+
+    [[nodiscard]] __m128i vec() const { return _mm_load_si128(reinterpret_cast<const __m128i *>(this)); }
+    void setVec(__m128i value) { _mm_store_si128(reinterpret_cast<__m128i *>(this), value); }
+
+    operator __m128i() const { return vec(); }
+};
+
+static_assert(sizeof(R5900Gpr) == 16, "R5900Gpr must stay 128 bits");
+
 // PS2 CPU context (R5900)
 struct alignas(16) R5900Context
 {
     // General Purpose Registers (128-bit)
-    __m128i r[32]; // Main registers
+    R5900Gpr r[32]; // Main registers
 
     // Control registers
     uint32_t pc;         // Program counter
@@ -172,10 +197,8 @@ struct alignas(16) R5900Context
         for (int i = 0; i < 32; ++i)
         {
             std::cout << "R" << std::setw(2) << std::dec << i << ": 0x" << std::hex
-                      << std::setw(8) << static_cast<uint32_t>(_mm_extract_epi32(r[i], 3))
-                      << std::setw(8) << static_cast<uint32_t>(_mm_extract_epi32(r[i], 2)) << "_"
-                      << std::setw(8) << static_cast<uint32_t>(_mm_extract_epi32(r[i], 1))
-                      << std::setw(8) << static_cast<uint32_t>(_mm_extract_epi32(r[i], 0)) << "\n";
+                      << std::setw(16) << r[i].hi << "_"
+                      << std::setw(16) << r[i].lo << "\n";
         }
         std::cout << "Status: 0x" << std::setw(8) << cop0_status
                   << " Cause: 0x" << std::setw(8) << cop0_cause
@@ -194,26 +217,30 @@ inline uint32_t getRegU32(const R5900Context *ctx, int reg)
         return 0;
     if (reg == 0)
         return 0;
-    return static_cast<uint32_t>(_mm_extract_epi32(ctx->r[reg], 0));
+    return static_cast<uint32_t>(ctx->r[reg].lo);
 }
 
 inline void setReturnU32(R5900Context *ctx, uint32_t value)
 {
     // R5900 sign-extends 32-bit results into 64-bit GPR, even for unsigned values.
-    ctx->r[2] = _mm_set_epi64x(0, static_cast<int64_t>(static_cast<int32_t>(value))); // $v0
+    ctx->r[2].lo = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(value))); // $v0
+    ctx->r[2].hi = 0;
 }
 
 inline void setReturnS32(R5900Context *ctx, int32_t value)
 {
     // Signed 32-bit return should be sign-extended when observed as 64-bit.
-    ctx->r[2] = _mm_set_epi64x(0, static_cast<int64_t>(value)); // $v0
+    ctx->r[2].lo = static_cast<uint64_t>(static_cast<int64_t>(value)); // $v0
+    ctx->r[2].hi = 0;
 }
 
 inline void setReturnU64(R5900Context *ctx, uint64_t value)
 {
     // Keep both conventions: full 64-bit value in $v0 and high 32-bit in $v1.
-    ctx->r[2] = _mm_set_epi64x(0, static_cast<int64_t>(value));
-    ctx->r[3] = _mm_set_epi64x(0, static_cast<int64_t>(static_cast<uint32_t>(value >> 32)));
+    ctx->r[2].lo = value;
+    ctx->r[2].hi = 0;
+    ctx->r[3].lo = static_cast<uint32_t>(value >> 32);
+    ctx->r[3].hi = 0;
 }
 
 inline constexpr uint32_t PS2_PATH_WATCH_ADDR = 0x01EFFFA0u;
@@ -298,6 +325,9 @@ public:
 
     using RecompiledFunction = void (*)(uint8_t *, R5900Context *, PS2Runtime *);
 
+    // EE cycles charged for every inter-function guest transfer.
+    static constexpr uint32_t kGuestBranchDispatchCycles = 8u;
+
     enum class GuestBranchKind
     {
         DirectJump,
@@ -322,6 +352,28 @@ public:
         SkipCallDebug = 3,
     };
 
+    // Per-callsite inline cache for JALR/JR targets. Generated code keeps one
+    // as a function-local static so a repeated target skips the function table
+    // lookup and the dispatch bookkeeping. Entries are dropped whenever the
+    // function table generation changes.
+    struct GuestBranchCache
+    {
+        static constexpr uint32_t kEntries = 4u;
+
+        uint32_t generation = 0u;
+        uint32_t targets[kEntries] = {};
+        RecompiledFunction functions[kEntries] = {};
+    };
+
+    struct GuestBranchStats
+    {
+        uint64_t dispatches = 0;
+        uint64_t indirectCalls = 0;
+        uint64_t indirectJumps = 0;
+        uint64_t cacheHits = 0;
+        uint64_t cacheMisses = 0;
+    };
+
     bool replaceFunction(uint32_t address, RecompiledFunction func);
     // TODO remove this later need to update all tests
     bool registerFunction(uint32_t address, RecompiledFunction func);
@@ -334,12 +386,24 @@ public:
                              uint32_t fallthroughPc,
                              GuestBranchKind kind,
                              const char *debugName);
+    inline bool dispatchCachedGuestBranch(uint8_t *rdram,
+                                          R5900Context *ctx,
+                                          uint32_t targetPc,
+                                          uint32_t sourcePc,
+                                          uint32_t fallthroughPc,
+                                          GuestBranchKind kind,
+                                          const char *debugName,
+                                          GuestBranchCache &cache);
+    static void invalidateGuestBranchCaches() noexcept;
+    [[nodiscard]] GuestBranchStats guestBranchStats() const;
+    void resetGuestBranchStats();
     void reportMissingFunction(uint8_t *rdram,
                                R5900Context *ctx,
                                uint32_t targetPc,
                                uint32_t sourcePc,
                                GuestBranchKind kind,
                                const char *debugName);
+    void reportUncleanCall(const R5900Context *ctx, uint32_t targetPc, uint32_t sourcePc, uint32_t returnPc);
     void setMissingFunctionPolicy(MissingFunctionPolicy policy);
     MissingFunctionPolicy missingFunctionPolicy() const;
     void resetMissingFunctionReportOnce();
@@ -461,6 +525,20 @@ private:
     void freeGuestBlockLocked(uint32_t guestAddr);
     void coalesceGuestHeapLocked();
     void HandleIntegerOverflow(R5900Context *ctx);
+    bool dispatchGuestBranchMiss(uint8_t *rdram,
+                                 R5900Context *ctx,
+                                 uint32_t targetPc,
+                                 uint32_t sourcePc,
+                                 uint32_t fallthroughPc,
+                                 GuestBranchKind kind,
+                                 const char *debugName,
+                                 GuestBranchCache &cache);
+
+    // Relaxed: the counters are statistics and order nothing else.
+    static inline void bumpGuestBranchCounter(std::atomic<uint64_t> &counter) noexcept
+    {
+        counter.fetch_add(1u, std::memory_order_relaxed);
+    }
 
     [[nodiscard]] ps2x::iop::RpcAbi selectIopRpcAbi(const ps2x::iop::RpcAbiRequest &request) const;
     [[nodiscard]] ps2x::iop::RpcResult handleIopRpc(uint8_t *rdram, R5900Context *ctx, ps2x::iop::RpcRequest request);
@@ -497,6 +575,15 @@ private:
     uint32_t m_asyncCallbackStackFloor = 0x01F00000u;
     uint32_t m_asyncCallbackStackTop = PS2_RAM_SIZE;
 
+    static inline std::atomic<uint32_t> s_guestBranchCacheGeneration{1u};
+    static constexpr uint32_t kMaxCachedJumpDepth = 64u;
+    uint32_t m_cachedJumpDepth = 0u;
+    std::atomic<uint64_t> m_guestBranchDispatches{0};
+    std::atomic<uint64_t> m_guestBranchIndirectCalls{0};
+    std::atomic<uint64_t> m_guestBranchIndirectJumps{0};
+    std::atomic<uint64_t> m_guestBranchCacheHits{0};
+    std::atomic<uint64_t> m_guestBranchCacheMisses{0};
+
     std::atomic<uint32_t> m_missingFunctionPolicy{static_cast<uint32_t>(MissingFunctionPolicy::ContinueToTarget)};
     std::atomic<bool> m_missingFunctionReported{false};
     std::atomic<bool> m_stopRequested{false};
@@ -526,10 +613,109 @@ private:
     uint8_t *m_boundGSVram = nullptr;
 };
 
+inline bool PS2Runtime::dispatchCachedGuestBranch(uint8_t *rdram,
+                                                  R5900Context *ctx,
+                                                  uint32_t targetPc,
+                                                  uint32_t sourcePc,
+                                                  uint32_t fallthroughPc,
+                                                  GuestBranchKind kind,
+                                                  const char *debugName,
+                                                  GuestBranchCache &cache)
+{
+    RecompiledFunction targetFn = nullptr;
+    if (cache.generation == s_guestBranchCacheGeneration.load(std::memory_order_relaxed))
+    {
+        for (uint32_t i = 0; i < GuestBranchCache::kEntries; ++i)
+        {
+            if (cache.targets[i] == targetPc && cache.functions[i] != nullptr)
+            {
+                targetFn = cache.functions[i];
+                // Move to front so the hottest target stays in the first compare.
+                for (; i > 0u; --i)
+                {
+                    cache.targets[i] = cache.targets[i - 1u];
+                    cache.functions[i] = cache.functions[i - 1u];
+                }
+                cache.targets[0] = targetPc;
+                cache.functions[0] = targetFn;
+                break;
+            }
+        }
+    }
+
+    if (targetFn == nullptr)
+    {
+        return dispatchGuestBranchMiss(rdram, ctx, targetPc, sourcePc, fallthroughPc, kind, debugName, cache);
+    }
+
+    const bool isCall = (kind == GuestBranchKind::DirectCall || kind == GuestBranchKind::IndirectCall);
+    bumpGuestBranchCounter(m_guestBranchDispatches);
+    if (kind == GuestBranchKind::IndirectCall)
+    {
+        bumpGuestBranchCounter(m_guestBranchIndirectCalls);
+    }
+    else if (kind == GuestBranchKind::IndirectJump)
+    {
+        bumpGuestBranchCounter(m_guestBranchIndirectJumps);
+    }
+    bumpGuestBranchCounter(m_guestBranchCacheHits);
+
+    ctx->pc = targetPc;
+    if (eeCheckpointDue(kGuestBranchDispatchCycles))
+    {
+        return false;
+    }
+
+    if (!isCall)
+    {
+        // A cached jump runs the target on this host frame instead of
+        // unwinding to the scheduler. The depth bound keeps JR chains that
+        // never return (guest interpreters, state machines) from growing the
+        // host stack; past it the scheduler picks up ctx->pc as before.
+        if (m_cachedJumpDepth >= kMaxCachedJumpDepth)
+        {
+            return false;
+        }
+
+        struct DepthGuard
+        {
+            uint32_t &depth;
+            explicit DepthGuard(uint32_t &value) : depth(value) { ++depth; }
+            ~DepthGuard() { --depth; }
+        } guard(m_cachedJumpDepth);
+
+        targetFn(rdram, ctx, this);
+        return false;
+    }
+
+    targetFn(rdram, ctx, this);
+
+    if (isStopRequested() || ctx->pc == 0u)
+    {
+        return false;
+    }
+
+    if (ctx->pc == targetPc)
+    {
+        ctx->pc = fallthroughPc;
+    }
+
+    return ctx->pc == fallthroughPc;
+}
+
 // Generated by ps2xRecomp in ps2xRuntime/src/runner/register_functions.cpp.
 extern const uint32_t g_ps2RecompiledFunctionTableBase;
 extern const uint32_t g_ps2RecompiledFunctionTableEnd;
 extern const uint32_t g_ps2RecompiledFunctionTableSlotCount;
 extern PS2Runtime::RecompiledFunction g_ps2RecompiledFunctionTable[];
 
+// Table slot for a call target the recompiler resolved statically. Overrides
+// patch the same table, so generated code compares against this before it
+// calls the recompiled function by name.
+inline PS2Runtime::RecompiledFunction ps2GuestFunctionAt(uint32_t address) noexcept
+{
+    const uint32_t slot = (address - g_ps2RecompiledFunctionTableBase) >> 2;
+    return slot < g_ps2RecompiledFunctionTableSlotCount ? g_ps2RecompiledFunctionTable[slot] : nullptr;
+}
+
 #endif // PS2_RUNTIME_H
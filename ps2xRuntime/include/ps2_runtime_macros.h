@@ -733,58 +733,37 @@ inline __m128i ps2_qfsrv(__m128i rs, __m128i rt, uint32_t sa)
 #define PS2_VSQRT(x) sqrtf(x)
 #define PS2_VRSQRT(x) (1.0f / sqrtf(x))
 
-#define GPR_U32(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0U : static_cast<uint32_t>(PS2_EXTRACT_EPI32_0(ctx_ptr->r[reg_idx])))
-#define GPR_S32(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0 : PS2_EXTRACT_EPI32_0(ctx_ptr->r[reg_idx]))
-#define GPR_U64(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0ULL : static_cast<uint64_t>(PS2_EXTRACT_EPI64_0(ctx_ptr->r[reg_idx])))
-#define GPR_S64(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0LL : PS2_EXTRACT_EPI64_0(ctx_ptr->r[reg_idx]))
-#define GPR_VEC(ctx_ptr, reg_idx) ((reg_idx == 0) ? _mm_setzero_si128() : ctx_ptr->r[reg_idx])
-
-static inline void Ps2SetGprLow64(R5900Context *ctx, int reg, __m128i new_low)
-{
-    if (reg != 0)
-    {
-        ctx->r[reg] = _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(ctx->r[reg]), _mm_castsi128_pd(new_low)));
-    }
-}
-
-#define SET_GPR_U32(ctx_ptr, reg_idx, val)                                \
-    do                                                                    \
-    {                                                                     \
-        if ((reg_idx) != 0)                                               \
-        {                                                                 \
-            __m128i _newVal = _mm_cvtsi64_si128((int64_t)(int32_t)(val)); \
-                                                                          \
-            Ps2SetGprLow64(ctx_ptr, reg_idx, _newVal);                    \
-        }                                                                 \
+#define GPR_U32(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0U : static_cast<uint32_t>((ctx_ptr)->r[reg_idx].lo))
+#define GPR_S32(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0 : static_cast<int32_t>((ctx_ptr)->r[reg_idx].lo))
+#define GPR_U64(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0ULL : (ctx_ptr)->r[reg_idx].lo)
+#define GPR_S64(ctx_ptr, reg_idx) ((reg_idx == 0) ? 0LL : static_cast<int64_t>((ctx_ptr)->r[reg_idx].lo))
+#define GPR_VEC(ctx_ptr, reg_idx) ((reg_idx == 0) ? _mm_setzero_si128() : (ctx_ptr)->r[reg_idx].vec())
+
+// Scalar writes only replace the low doubleword; the upper 64 bits belong to
+// MMI and survive ordinary 32/64-bit instructions.
+#define SET_GPR_U32(ctx_ptr, reg_idx, val)                                             \
+    do                                                                                 \
+    {                                                                                  \
+        if ((reg_idx) != 0)                                                            \
+            (ctx_ptr)->r[reg_idx].lo = static_cast<uint64_t>((int64_t)(int32_t)(val)); \
     } while (0)
 
-#define SET_GPR_S32(ctx_ptr, reg_idx, val)                                \
-    do                                                                    \
-    {                                                                     \
-        if ((reg_idx) != 0)                                               \
-        {                                                                 \
-            __m128i _newVal = _mm_cvtsi64_si128((int64_t)(int32_t)(val)); \
-            Ps2SetGprLow64(ctx_ptr, reg_idx, _newVal);                    \
-        }                                                                 \
-    } while (0)
+#define SET_GPR_S32(ctx_ptr, reg_idx, val) SET_GPR_U32(ctx_ptr, reg_idx, val)
 
-#define SET_GPR_U64(ctx_ptr, reg_idx, val)                       \
-    do                                                           \
-    {                                                            \
-        if ((reg_idx) != 0)                                      \
-        {                                                        \
-            __m128i _newVal = _mm_cvtsi64_si128((int64_t)(val)); \
-            Ps2SetGprLow64(ctx_ptr, reg_idx, _newVal);           \
-        }                                                        \
+#define SET_GPR_U64(ctx_ptr, reg_idx, val)                                    \
+    do                                                                        \
+    {                                                                         \
+        if ((reg_idx) != 0)                                                   \
+            (ctx_ptr)->r[reg_idx].lo = static_cast<uint64_t>((int64_t)(val)); \
     } while (0)
 
 #define SET_GPR_S64(ctx_ptr, reg_idx, val) SET_GPR_U64(ctx_ptr, reg_idx, val)
 
-#define SET_GPR_VEC(ctx_ptr, reg_idx, val) \
-    do                                     \
-    {                                      \
-        if (reg_idx != 0)                  \
-            ctx_ptr->r[reg_idx] = (val);   \
+#define SET_GPR_VEC(ctx_ptr, reg_idx, val)     \
+    do                                         \
+    {                                          \
+        if (reg_idx != 0)                      \
+            (ctx_ptr)->r[reg_idx].setVec(val); \
     } while (0)
 
 #endif // PS2_RUNTIME_MACROS_H
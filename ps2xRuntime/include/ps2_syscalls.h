@@ -11,8 +11,6 @@
 
 std::string translatePs2Path(const char *ps2Path);
 
-inline std::mutex g_sys_fd_mutex;
-
 namespace ps2_syscalls
 {
 #define PS2_DECLARE_SYSCALL(name) void name(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime);
@@ -31,6 +29,14 @@ namespace ps2_syscalls
     void TODO(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime, uint32_t encodedSyscallId);
     uint64_t GetCurrentVSyncTick(PS2Runtime *runtime);
     void WaitVSyncTick(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime, int fixedResult = -1);
+
+    // When enabled, fioRead decodes files that start with a VAG header and
+    // hands the samples to the audio backend. Off by default.
+    void setFioVagStreaming(bool enabled);
+    // Applies PS2X_FIO_VAG_STREAMING ("1", "on" or "true" enables, any other
+    // value disables) and returns the resulting setting. Runs from
+    // PS2Runtime::initialize.
+    bool configureFioVagStreamingFromEnvironment();
 }
 
 #endif // PS2_SYSCALLS_H
@@ -2,16 +2,23 @@
 
 #include "ps2_runtime.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cassert>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <deque>
+#include <cstddef>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <new>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -92,15 +99,178 @@ enum class GuestInvocationKind : uint8_t
     HleCall,
 };
 
+// Move-only completion callback for guest invocations. Captures up to
+// kInlineBytes are stored in place, so the usual completions (a few pointers
+// or a small lambda) never touch the heap; larger ones fall back to it.
+class GuestInvocationCompletion
+{
+public:
+    static constexpr size_t kInlineBytes = 64u;
+
+    GuestInvocationCompletion() noexcept = default;
+    GuestInvocationCompletion(std::nullptr_t) noexcept {}
+
+    template <typename Fn,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, GuestInvocationCompletion> &&
+                                          std::is_invocable_v<std::decay_t<Fn> &, const R5900Context &, R5900Context &>>>
+    GuestInvocationCompletion(Fn &&fn)
+    {
+        emplace(std::forward<Fn>(fn));
+    }
+
+    GuestInvocationCompletion(GuestInvocationCompletion &&other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    GuestInvocationCompletion &operator=(GuestInvocationCompletion &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    GuestInvocationCompletion &operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template <typename Fn,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, GuestInvocationCompletion> &&
+                                          std::is_invocable_v<std::decay_t<Fn> &, const R5900Context &, R5900Context &>>>
+    GuestInvocationCompletion &operator=(Fn &&fn)
+    {
+        reset();
+        emplace(std::forward<Fn>(fn));
+        return *this;
+    }
+
+    GuestInvocationCompletion(const GuestInvocationCompletion &) = delete;
+    GuestInvocationCompletion &operator=(const GuestInvocationCompletion &) = delete;
+
+    ~GuestInvocationCompletion()
+    {
+        reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_ops != nullptr;
+    }
+
+    void operator()(const R5900Context &completed, R5900Context &parent)
+    {
+        assert(m_ops != nullptr);
+        m_ops->invoke(m_storage, completed, parent);
+    }
+
+    void reset() noexcept
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void *storage, const R5900Context &completed, R5900Context &parent);
+        void (*move)(void *destination, void *source) noexcept;
+        void (*destroy)(void *storage) noexcept;
+    };
+
+    template <typename T>
+    static constexpr bool kStoredInline = sizeof(T) <= kInlineBytes &&
+                                          alignof(T) <= alignof(std::max_align_t) &&
+                                          std::is_nothrow_move_constructible_v<T>;
+
+    template <typename T>
+    static const Ops *inlineOps() noexcept
+    {
+        static constexpr Ops ops{
+            [](void *storage, const R5900Context &completed, R5900Context &parent)
+            { (*std::launder(static_cast<T *>(storage)))(completed, parent); },
+            [](void *destination, void *source) noexcept
+            {
+                T *from = std::launder(static_cast<T *>(source));
+                ::new (destination) T(std::move(*from));
+                from->~T();
+            },
+            [](void *storage) noexcept
+            { std::launder(static_cast<T *>(storage))->~T(); }};
+        return &ops;
+    }
+
+    template <typename T>
+    static const Ops *heapOps() noexcept
+    {
+        static constexpr Ops ops{
+            [](void *storage, const R5900Context &completed, R5900Context &parent)
+            { (**static_cast<T **>(storage))(completed, parent); },
+            [](void *destination, void *source) noexcept
+            { *static_cast<T **>(destination) = *static_cast<T **>(source); },
+            [](void *storage) noexcept
+            { delete *static_cast<T **>(storage); }};
+        return &ops;
+    }
+
+    template <typename Fn>
+    void emplace(Fn &&fn)
+    {
+        using T = std::decay_t<Fn>;
+        // Empty function pointers and std::functions stay empty.
+        if constexpr (std::is_constructible_v<bool, const T &>)
+        {
+            if (!static_cast<bool>(fn))
+            {
+                return;
+            }
+        }
+        if constexpr (kStoredInline<T>)
+        {
+            ::new (static_cast<void *>(m_storage)) T(std::forward<Fn>(fn));
+            m_ops = inlineOps<T>();
+        }
+        else
+        {
+            *reinterpret_cast<T **>(m_storage) = new T(std::forward<Fn>(fn));
+            m_ops = heapOps<T>();
+        }
+    }
+
+    void moveFrom(GuestInvocationCompletion &other) noexcept
+    {
+        if (other.m_ops)
+        {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[kInlineBytes];
+    const Ops *m_ops = nullptr;
+};
+
 struct GuestInvocation
 {
     GuestInvocationKind kind = GuestInvocationKind::Interrupt;
     uint64_t sequence = 0;
     uint64_t tag = 0;
     R5900Context context{};
-    std::function<void(const R5900Context &, R5900Context &)> onComplete;
+    GuestInvocationCompletion onComplete;
 };
 
+// Invocation frames are pooled by the scheduler and only ever moved by
+// pointer, so a queued interrupt never copies its register file around.
+using GuestInvocationFrame = std::unique_ptr<GuestInvocation>;
+
 struct GuestThread
 {
     int id = 0;
@@ -121,19 +291,38 @@ struct GuestThread
     uint32_t tlsBase = 0;
     EeWaitState wait{};
     std::function<void(R5900Context &)> resumeCompletion;
-    std::vector<GuestInvocation> invocations;
+    std::vector<GuestInvocationFrame> invocations;
+    // Intrusive links in the per-priority ready list, as thread IDs (0 = none).
+    int readyPrev = 0;
+    int readyNext = 0;
+    bool readyQueued = false;
+    // Links in the wait queue of the semaphore or event flag being waited on.
+    int waitPrev = 0;
+    int waitNext = 0;
 
     [[nodiscard]] R5900Context &activeContext()
     {
-        return invocations.empty() ? context : invocations.back().context;
+        return invocations.empty() ? context : invocations.back()->context;
     }
 
     [[nodiscard]] const R5900Context &activeContext() const
     {
-        return invocations.empty() ? context : invocations.back().context;
+        return invocations.empty() ? context : invocations.back()->context;
     }
 };
 
+// FIFO of waiting threads threaded through GuestThread::waitPrev/waitNext,
+// so queueing and waking never allocate.
+struct EeWaitQueue
+{
+    int head = 0;
+    int tail = 0;
+    uint32_t count = 0;
+
+    [[nodiscard]] bool empty() const noexcept { return head == 0; }
+    [[nodiscard]] size_t size() const noexcept { return count; }
+};
+
 struct EeSemaphore
 {
     int id = 0;
@@ -142,7 +331,7 @@ struct EeSemaphore
     int initCount = 0;
     uint32_t attr = 0;
     uint32_t option = 0;
-    std::deque<int> waiters;
+    EeWaitQueue waiters;
 };
 
 struct EeEventFlag
@@ -152,7 +341,7 @@ struct EeEventFlag
     uint32_t option = 0;
     uint32_t initBits = 0;
     uint32_t bits = 0;
-    std::deque<int> waiters;
+    EeWaitQueue waiters;
 };
 
 struct EeAlarm
@@ -163,6 +352,8 @@ struct EeAlarm
     uint32_t argument = 0;
     uint32_t gp = 0;
     uint32_t sp = 0;
+    // EeDeadlineQueue handle of the pending expiry, used by CancelAlarm.
+    uint64_t deadline = 0;
 };
 
 struct EeIrqHandler
@@ -175,6 +366,193 @@ struct EeIrqHandler
     uint32_t sp = 0;
     bool enabled = true;
     int order = 0;
+    // Intrusive links in the per-cause list, kept sorted by order. 0 = none.
+    int prev = 0;
+    int next = 0;
+};
+
+// Dense ID-indexed storage for EE kernel objects. Slots live in a deque so
+// references stay valid while the table grows, and free IDs are kept on an
+// intrusive FIFO list so lookups and allocation are O(1) without hashing.
+template <typename T>
+class EeObjectTable
+{
+public:
+    EeObjectTable(int firstId, int lastId) noexcept
+        : m_firstId(firstId), m_lastId(lastId)
+    {
+    }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_freeHead = -1;
+        m_freeTail = -1;
+        m_size = 0;
+    }
+
+    // Returns the next free ID without occupying it, or 0 if the table is full.
+    [[nodiscard]] int nextFreeId()
+    {
+        if (m_freeHead < 0)
+        {
+            grow();
+        }
+        return m_freeHead < 0 ? 0 : m_firstId + m_freeHead;
+    }
+
+    T &emplace(int id, T value)
+    {
+        const int64_t index = static_cast<int64_t>(id) - m_firstId;
+        assert(index >= 0 && index <= static_cast<int64_t>(m_lastId) - m_firstId);
+        while (index >= static_cast<int64_t>(m_slots.size()))
+        {
+            grow();
+        }
+        Slot &slot = m_slots[static_cast<size_t>(index)];
+        assert(!slot.value.has_value());
+        unlinkFree(static_cast<int>(index));
+        slot.value.emplace(std::move(value));
+        ++m_size;
+        return *slot.value;
+    }
+
+    bool erase(int id)
+    {
+        Slot *slot = slotFor(id);
+        if (!slot || !slot->value.has_value())
+        {
+            return false;
+        }
+        slot->value.reset();
+        --m_size;
+        pushFree(id - m_firstId);
+        return true;
+    }
+
+    [[nodiscard]] T *find(int id) noexcept
+    {
+        Slot *slot = slotFor(id);
+        return slot && slot->value.has_value() ? &*slot->value : nullptr;
+    }
+
+    [[nodiscard]] const T *find(int id) const noexcept
+    {
+        return const_cast<EeObjectTable *>(this)->find(id);
+    }
+
+    [[nodiscard]] bool contains(int id) const noexcept
+    {
+        return find(id) != nullptr;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    // Visits live objects in ascending ID order.
+    template <typename Fn>
+    void forEach(Fn &&fn)
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.value.has_value())
+            {
+                fn(*slot.value);
+            }
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn &&fn) const
+    {
+        for (const Slot &slot : m_slots)
+        {
+            if (slot.value.has_value())
+            {
+                fn(*slot.value);
+            }
+        }
+    }
+
+private:
+    static constexpr int kGrowSlots = 64;
+
+    struct Slot
+    {
+        std::optional<T> value;
+        int prevFree = -1;
+        int nextFree = -1;
+    };
+
+    Slot *slotFor(int id) noexcept
+    {
+        const int64_t index = static_cast<int64_t>(id) - m_firstId;
+        if (index < 0 || index >= static_cast<int64_t>(m_slots.size()))
+        {
+            return nullptr;
+        }
+        return &m_slots[static_cast<size_t>(index)];
+    }
+
+    void grow()
+    {
+        const int64_t begin = static_cast<int64_t>(m_slots.size());
+        const int64_t available = static_cast<int64_t>(m_lastId) - m_firstId + 1 - begin;
+        const int64_t count = std::min<int64_t>(kGrowSlots, available);
+        for (int64_t i = 0; i < count; ++i)
+        {
+            m_slots.emplace_back();
+            pushFree(static_cast<int>(begin + i));
+        }
+    }
+
+    void pushFree(int index)
+    {
+        Slot &slot = m_slots[static_cast<size_t>(index)];
+        slot.prevFree = m_freeTail;
+        slot.nextFree = -1;
+        if (m_freeTail >= 0)
+        {
+            m_slots[static_cast<size_t>(m_freeTail)].nextFree = index;
+        }
+        else
+        {
+            m_freeHead = index;
+        }
+        m_freeTail = index;
+    }
+
+    void unlinkFree(int index)
+    {
+        Slot &slot = m_slots[static_cast<size_t>(index)];
+        if (slot.prevFree >= 0)
+        {
+            m_slots[static_cast<size_t>(slot.prevFree)].nextFree = slot.nextFree;
+        }
+        else
+        {
+            m_freeHead = slot.nextFree;
+        }
+        if (slot.nextFree >= 0)
+        {
+            m_slots[static_cast<size_t>(slot.nextFree)].prevFree = slot.prevFree;
+        }
+        else
+        {
+            m_freeTail = slot.prevFree;
+        }
+        slot.prevFree = -1;
+        slot.nextFree = -1;
+    }
+
+    std::deque<Slot> m_slots;
+    int m_firstId;
+    int m_lastId;
+    int m_freeHead = -1;
+    int m_freeTail = -1;
+    size_t m_size = 0;
 };
 
 struct EeThreadSnapshot
@@ -240,6 +618,132 @@ struct EeEvent
     uint64_t value = 0;
 };
 
+// Bounded multi-producer/single-consumer event ring. Producers (presentation,
+// IOP and stub threads) claim a cell with one CAS on the head; the EE executor
+// is the only consumer, so popping needs no read-modify-write at all.
+class EeEventRing
+{
+public:
+    static constexpr size_t kCapacity = 1024u;
+
+    EeEventRing() noexcept;
+
+    [[nodiscard]] bool tryPush(const EeEvent &event) noexcept;
+    [[nodiscard]] bool tryPop(EeEvent &event) noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    static_assert((kCapacity & (kCapacity - 1u)) == 0u, "EeEventRing capacity must be a power of two");
+
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence{0};
+        EeEvent event;
+    };
+
+    std::array<Cell, kCapacity> m_cells;
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    alignas(64) uint64_t m_tail = 0;
+};
+
+struct EeScheduledEvent
+{
+    uint64_t deadlineCycle = 0;
+    std::chrono::steady_clock::time_point hostDeadline{};
+    EeEvent event{};
+    uint64_t sequence = 0;
+};
+
+// Timed events in a 4-ary min-heap ordered by (deadlineCycle, type, id,
+// sequence), the order in which due events are processed. push() returns a
+// handle that stays valid until the event is popped, so a cancelled alarm is
+// removed in O(log n) instead of by a scan.
+class EeDeadlineQueue
+{
+public:
+    using Handle = uint64_t;
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_heap.empty();
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_heap.size();
+    }
+
+    [[nodiscard]] const EeScheduledEvent &top() const noexcept
+    {
+        assert(!m_heap.empty());
+        return m_heap.front().event;
+    }
+
+    void clear();
+    Handle push(const EeScheduledEvent &event);
+    bool erase(Handle handle);
+    EeScheduledEvent pop();
+
+    // Moves every event with deadlineCycle <= cycle and hostDeadline <=
+    // hostNow to out in queue order. Cycle-due events still waiting on the
+    // host clock stay queued and keep their handles.
+    void takeDue(uint64_t cycle,
+                 std::chrono::steady_clock::time_point hostNow,
+                 std::vector<EeScheduledEvent> &out);
+
+    // Visits, in no particular order, every event with deadlineCycle <= cycle.
+    template <typename Fn>
+    void forEachDue(uint64_t cycle, Fn &&fn) const
+    {
+        visitDue(0u, cycle, fn);
+    }
+
+private:
+    static constexpr size_t kArity = 4u;
+
+    struct Node
+    {
+        EeScheduledEvent event;
+        uint32_t slot = 0;
+    };
+
+    struct Slot
+    {
+        uint32_t position = 0;
+        uint32_t generation = 0;
+        bool live = false;
+    };
+
+    template <typename Fn>
+    void visitDue(size_t index, uint64_t cycle, Fn &fn) const
+    {
+        if (index >= m_heap.size() || m_heap[index].event.deadlineCycle > cycle)
+        {
+            return;
+        }
+        fn(m_heap[index].event);
+        for (size_t child = index * kArity + 1u; child <= index * kArity + kArity; ++child)
+        {
+            visitDue(child, cycle, fn);
+        }
+    }
+
+    [[nodiscard]] static bool before(const EeScheduledEvent &left, const EeScheduledEvent &right) noexcept;
+    [[nodiscard]] Slot *slotFor(Handle handle) noexcept;
+    uint32_t acquireSlot();
+    void releaseSlot(uint32_t slot);
+    void pushNode(Node node);
+    Node removeAt(size_t index);
+    void place(size_t index, Node node);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+
+    std::vector<Node> m_heap;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<Node> m_deferred;
+};
+
 struct EeThreadCreateParams
 {
     uint32_t attr = 0;
@@ -260,7 +764,7 @@ public:
     static constexpr int kPriorityCount = 128;
     static constexpr uint64_t kEeClockHz = 294912000ull;
     static constexpr uint32_t kGeneratedCheckpointCycles = 32u;
-    static constexpr uint32_t kGuestDispatchCycles = 8u;
+    static constexpr uint32_t kGuestDispatchCycles = PS2Runtime::kGuestBranchDispatchCycles;
     static constexpr uint64_t kDefaultTimeSliceCycles = 65536ull;
 
     explicit EeScheduler(PS2Runtime &runtime);
@@ -310,9 +814,14 @@ public:
 
     int setAlarm(uint16_t ticks, uint32_t handler, uint32_t argument, uint32_t gp, uint32_t sp);
     int cancelAlarm(int id);
-    void queueInvocation(GuestInvocation invocation);
-    [[noreturn]] void invokeCurrent(GuestInvocation invocation);
-    [[noreturn]] void invokeCurrentSequence(std::vector<GuestInvocation> invocations);
+    // Frames come from the scheduler's pool and are filled in place; the
+    // second overload starts the handler from a copy of the caller's
+    // registers, which is the only time a whole context is copied.
+    [[nodiscard]] GuestInvocationFrame acquireInvocationFrame(GuestInvocationKind kind);
+    [[nodiscard]] GuestInvocationFrame acquireInvocationFrame(GuestInvocationKind kind, const R5900Context &inherited);
+    void queueInvocation(GuestInvocationFrame frame);
+    [[noreturn]] void invokeCurrent(GuestInvocationFrame frame);
+    [[noreturn]] void invokeCurrentSequence(std::vector<GuestInvocationFrame> frames);
     [[nodiscard]] bool hasInvocation(GuestInvocationKind kind, uint64_t tag) const;
     [[nodiscard]] uint32_t invocationStackTop();
 
@@ -356,17 +865,15 @@ public:
     void publishSnapshot();
 
 private:
-    struct ScheduledEvent
-    {
-        uint64_t deadlineCycle = 0;
-        std::chrono::steady_clock::time_point hostDeadline{};
-        EeEvent event{};
-        uint64_t sequence = 0;
-    };
-
     void assertExecutor() const;
     [[nodiscard]] int allocateThreadId();
+    [[nodiscard]] GuestInvocationFrame takePooledInvocationFrame();
+    void releaseInvocationFrame(GuestInvocationFrame frame);
+    [[nodiscard]] bool hasPendingInvocations() const noexcept;
+    [[nodiscard]] GuestInvocationFrame popPendingInvocation();
     GuestThread &acquireInvocationThread();
+    void enqueueWaiter(EeWaitQueue &queue, GuestThread &thread);
+    void removeWaiter(EeWaitQueue &queue, GuestThread &thread);
     void enqueueReady(GuestThread &thread, bool front = false);
     void removeReady(GuestThread &thread);
     [[nodiscard]] GuestThread *selectReady();
@@ -385,28 +892,72 @@ private:
     static int waitObjectId(const EeWaitState &wait);
     void writeGuestU32(uint32_t address, uint32_t value);
     void waitForEvent();
-    void scheduleEvent(uint64_t deadlineCycle, std::chrono::steady_clock::time_point hostDeadline, EeEvent event);
+    bool drainPostedEvents();
+    bool hasPostedEvents() const noexcept;
+    void wakeExecutor();
+    EeDeadlineQueue::Handle scheduleEvent(uint64_t deadlineCycle, std::chrono::steady_clock::time_point hostDeadline, EeEvent event);
     void updateNextDeadline();
     [[nodiscard]] bool hasReadyAtOrAbovePriority(int priority) const;
+    [[nodiscard]] int highestReadyPriority() const noexcept;
     void renewTimeSlice();
     void copyMainContextToRuntime();
 
     PS2Runtime &m_runtime;
     uint8_t *m_rdram = nullptr;
-    std::array<std::deque<int>, kPriorityCount> m_readyQueues{};
-    std::unordered_map<int, GuestThread> m_threads;
-    std::unordered_map<int, EeSemaphore> m_semaphores;
-    std::unordered_map<int, EeEventFlag> m_eventFlags;
-    std::unordered_map<int, EeAlarm> m_alarms;
-    std::unordered_map<int, EeIrqHandler> m_intcHandlers;
-    std::unordered_map<int, EeIrqHandler> m_dmacHandlers;
-    int m_nextThreadId = kFirstThreadId;
-    int m_nextInvocationThreadId = -1;
-    int m_nextSemaphoreId = 1;
-    int m_nextEventFlagId = 1;
-    int m_nextAlarmId = 1;
-    int m_nextIntcHandlerId = 1;
-    int m_nextDmacHandlerId = 1;
+    struct ReadyQueue
+    {
+        int head = 0;
+        int tail = 0;
+    };
+
+    static constexpr size_t kReadyBitmapWords = kPriorityCount / 64;
+    static_assert(kPriorityCount % 64 == 0, "ready bitmap assumes whole 64-bit words");
+
+    // Bit p of m_readyBitmap is set while priority p has a ready thread, and
+    // bit w of m_readySummary while word w is non-zero, so the highest ready
+    // priority is two count-trailing-zeros away.
+    std::array<ReadyQueue, kPriorityCount> m_readyQueues{};
+    std::array<uint64_t, kReadyBitmapWords> m_readyBitmap{};
+    uint32_t m_readySummary = 0;
+    // Thread IDs woken by completeVSync/completeExternalWait; kept so its
+    // capacity is reused across VBlanks.
+    std::vector<int> m_wakeScratch;
+    // Causes 0..31 get their own handler list; anything larger shares the
+    // last list and is filtered by cause during dispatch.
+    static constexpr size_t kIrqCauseLists = 33u;
+
+    struct IrqCauseList
+    {
+        int head = 0;
+        int tail = 0;
+    };
+
+    template <typename Fn>
+    void forEachThread(Fn &&fn)
+    {
+        for (GuestThread &item : m_invocationThreads)
+        {
+            fn(item);
+        }
+        m_threads.forEach(fn);
+    }
+
+    [[nodiscard]] static size_t irqCauseList(uint32_t cause) noexcept
+    {
+        return std::min<size_t>(cause, kIrqCauseLists - 1u);
+    }
+
+    EeObjectTable<GuestThread> m_threads{kMainThreadId, kLastThreadId};
+    // Host-only dispatcher threads for queued invocations use IDs -1, -2, ...
+    // and are never deleted, only recycled once dormant.
+    std::deque<GuestThread> m_invocationThreads;
+    EeObjectTable<EeSemaphore> m_semaphores{1, std::numeric_limits<int>::max()};
+    EeObjectTable<EeEventFlag> m_eventFlags{1, std::numeric_limits<int>::max()};
+    EeObjectTable<EeAlarm> m_alarms{1, std::numeric_limits<int>::max()};
+    EeObjectTable<EeIrqHandler> m_intcHandlers{1, std::numeric_limits<int>::max()};
+    EeObjectTable<EeIrqHandler> m_dmacHandlers{1, std::numeric_limits<int>::max()};
+    std::array<IrqCauseList, kIrqCauseLists> m_intcCauseLists{};
+    std::array<IrqCauseList, kIrqCauseLists> m_dmacCauseLists{};
     int m_intcHeadOrder = 0;
     int m_intcTailOrder = 1000;
     int m_dmacHeadOrder = 0;
@@ -429,9 +980,20 @@ private:
 
     mutable std::mutex m_eventMutex;
     std::condition_variable m_eventCv;
-    std::deque<EeEvent> m_events;
-    std::vector<ScheduledEvent> m_deadlines;
-    std::deque<GuestInvocation> m_pendingInvocations;
+    // Posted events normally go through m_eventRing without locking. The mutex
+    // and condition variable are only for the executor sleeping in
+    // waitForEvent, and for the overflow list used when the ring is full.
+    EeEventRing m_eventRing;
+    std::deque<EeEvent> m_overflowEvents;
+    std::atomic<uint32_t> m_overflowEventCount{0};
+    std::atomic<bool> m_executorSleeping{false};
+    EeDeadlineQueue m_deadlines;
+    std::vector<EeScheduledEvent> m_dueDeadlines;
+    // FIFO of queued frames; consumed from m_pendingInvocationHead and reset
+    // once drained so the vector's capacity is reused.
+    std::vector<GuestInvocationFrame> m_pendingInvocations;
+    size_t m_pendingInvocationHead = 0;
+    std::vector<GuestInvocationFrame> m_invocationPool;
     uint64_t m_eventSequence = 0;
     uint64_t m_invocationSequence = 0;
     uint64_t m_vsyncTick = 0;
@@ -21,7 +21,8 @@ public:
     virtual void Flush() = 0;
     virtual void TextureFlush() = 0;
     virtual void Sync(GSSyncReason reason) = 0;
-    virtual PresentationFrame Present(const GSPresentationRequest &request) = 0;
+    // Fills frame in place so the caller can recycle its pixel storage.
+    virtual bool Present(const GSPresentationRequest &request, PresentationFrame &frame) = 0;
 
     virtual bool ClearFramebuffer(const GSContext &context, uint32_t rgba) = 0;
     virtual uint32_t ConsumeLocalToHostBytes(uint8_t *dst, uint32_t maxBytes) = 0;
@@ -22,7 +22,7 @@ public:
     void Flush() override;
     void TextureFlush() override;
     void Sync(GSSyncReason reason) override;
-    PresentationFrame Present(const GSPresentationRequest &request) override;
+    bool Present(const GSPresentationRequest &request, PresentationFrame &frame) override;
 
     bool ClearFramebuffer(const GSContext &context, uint32_t rgba) override;
     uint32_t ConsumeLocalToHostBytes(uint8_t *dst, uint32_t maxBytes) override;
@@ -47,7 +47,7 @@ private:
 
     void PerformLocalToLocalTransfer();
     void PerformLocalToHostTransfer();
-    PresentationFrame PresentFromLocalMemory(const GSPresentationRequest &request);
+    bool PresentFromLocalMemory(const GSPresentationRequest &request, PresentationFrame &frame);
     bool CopyFrameToHostRgba(const GSFrameReg &frame,
                              uint32_t width,
                              uint32_t height,
@@ -72,4 +72,7 @@ private:
     GSTransferSnapshot m_transferState{};
     std::vector<uint8_t> m_localToHostBuffer;
     size_t m_localToHostReadPos = 0;
+    std::vector<uint32_t> m_transferPixels;
+    std::vector<uint8_t> m_presentCircuitPixels[2];
+    std::vector<uint8_t> m_presentCandidatePixels;
 };
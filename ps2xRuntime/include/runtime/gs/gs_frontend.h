@@ -2,6 +2,7 @@
 #define PS2_GS_FRONTEND_H
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -130,15 +131,30 @@ public:
     void setDebugHistoryPaused(bool paused);
     bool getPreferredDisplaySource(GSFrameReg &outSource, uint32_t &outDestFbp) const;
     void latchHostPresentationFrame();
+    // Returns the newest latched frame without copying it (rows are 640
+    // pixels apart), or nullptr when there is none. Only one presenter thread
+    // may call this; the frame stays valid until its next call. The sequence
+    // advances once per latch.
+    const PresentationFrame *acquireHostPresentationFrame(uint64_t *outSequence = nullptr);
     bool copyLatchedHostPresentationFrame(std::vector<uint8_t> &outPixels,
                                           uint32_t &outWidth,
                                           uint32_t &outHeight,
                                           uint32_t *outDisplayFbp = nullptr,
                                           uint32_t *outSourceFbp = nullptr,
-                                          bool *outUsedPreferred = nullptr) const;
+                                          bool *outUsedPreferred = nullptr);
     bool clearFramebufferContext(uint32_t contextIndex, uint32_t rgba);
     bool clearActiveFramebuffer(uint32_t rgba);
     uint64_t nativeImageUploadCount() const { return m_nativeImageUploadCount; }
+
+    // Frame skipping for when the EE falls behind real time. A skipped frame
+    // drops only draws into display buffers; offscreen targets, transfers and
+    // register state are always processed. limit caps consecutive skipped
+    // frames, and 0 turns skipping off.
+    void setFrameSkipLimit(uint32_t limit);
+    // Called by the EE scheduler at every VBlank start.
+    void beginFrame(bool behindRealTime);
+    bool isSkippingFrame() const;
+    uint64_t skippedFrameCount() const;
     uint64_t nativePackedGIFPacketCount() const { return m_nativePackedGIFPacketCount; }
 
     uint32_t consumeLocalToHostBytes(uint8_t *dst, uint32_t maxBytes);
@@ -173,7 +189,10 @@ private:
     GSPrimitiveBatch buildDrawBatch(int vertexCount) const;
     void updatePreferredDisplaySourceForDraw(const GSPrimitiveBatch &batch);
     GSPresentationRequest buildPresentationRequestUnlocked() const;
-
+    void trackDisplayBufferUnlocked(uint64_t dispfb);
+    bool isDisplayBufferBlockUnlocked(uint32_t block) const;
+    bool dropDrawUnlocked(const GSDrawState &state);
+    void blockFrameSkipUnlocked();
 
     GSContext &activeContext();
 
@@ -183,6 +202,7 @@ private:
     mutable std::recursive_mutex m_stateMutex;
     mutable std::mutex m_backendLifetimeMutex;
     mutable std::mutex m_presentationMutex;
+    std::mutex m_presentationLatchMutex;
 
     GSContext m_ctx[2];
     GSPrimReg m_prim{};
@@ -222,7 +242,22 @@ private:
     GSFrameReg m_preferredDisplaySourceFrame{};
     uint32_t m_preferredDisplayDestFbp = 0;
     bool m_hasPreferredDisplaySource = false;
-    std::vector<uint8_t> m_hostPresentationFrame;
+    // Host presentation triple buffer. The latch renders into its back slot
+    // and swaps it into m_hostPresentationReady with the fresh bit set; the
+    // presenter swaps its front slot for the ready one when the bit is set.
+    struct HostPresentationSlot
+    {
+        PresentationFrame frame;
+        uint64_t sequence = 0;
+    };
+    static constexpr uint32_t kHostPresentationSlotMask = 0x3u;
+    static constexpr uint32_t kHostPresentationFresh = 0x4u;
+    std::array<HostPresentationSlot, 3> m_hostPresentationSlots{};
+    uint32_t m_hostPresentationBack = 0;
+    uint32_t m_hostPresentationFront = 1;
+    std::atomic<uint32_t> m_hostPresentationReady{2u};
+    std::atomic<uint64_t> m_hostPresentationSequence{0};
+    std::atomic<uint64_t> m_hostPresentationClearedSequence{0};
     uint32_t m_hostPresentationWidth = 0;
     uint32_t m_hostPresentationHeight = 0;
     uint32_t m_hostPresentationDisplayFbp = 0;
@@ -232,6 +267,22 @@ private:
     uint64_t m_nativeImageUploadCount = 0;
     uint64_t m_nativePackedGIFPacketCount = 0;
 
+    // Skipping stays off until this many frames have been drawn without a
+    // local-to-host transfer or a draw sampling a display buffer; either one
+    // turns it off until the next reset.
+    static constexpr uint32_t kFrameSkipWarmupFrames = 120u;
+    static constexpr size_t kMaxTrackedDisplayBuffers = 4u;
+    std::array<GSFrameReg, kMaxTrackedDisplayBuffers> m_displayBuffers{};
+    size_t m_displayBufferCount = 0;
+    size_t m_displayBufferNext = 0;
+    uint32_t m_frameSkipLimit = 0;
+    uint32_t m_frameSkipWarmup = kFrameSkipWarmupFrames;
+    uint32_t m_consecutiveSkippedFrames = 0;
+    uint64_t m_skippedFrames = 0;
+    bool m_skippingFrame = false;
+    bool m_frameSkipBlocked = false;
+    std::atomic<bool> m_presentSkippedFrame{false};
+
     static constexpr size_t kDebugHistoryCapacity = 512;
     std::array<GSDebugHistoryEntry, kDebugHistoryCapacity> m_debugHistory{};
     size_t m_debugHistoryWrite = 0;
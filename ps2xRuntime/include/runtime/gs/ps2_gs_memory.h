@@ -257,6 +257,12 @@ namespace GSMem
 		// returns a offset into a 32 bit word (P8H, P4HH, P4HL)
 		static constexpr usz BitOffset();
 
+		// writes the pixel at an already resolved pixel address
+		static constexpr void WriteAt(u8* data, u32 pixel_addr, PackedT value);
+
+		// reads the pixel at an already resolved pixel address
+		static constexpr auto ReadAt(const u8* data, u32 pixel_addr) -> PackedT;
+
 		// writes the pixel
 		static constexpr void Write(const PageLookupTableT& table, u8* data, u32 block, u32 bw, u32 x, u32 y, PackedT value);
 
@@ -458,9 +464,8 @@ namespace GSMem
 	}
 
 	template<PixelStorageMode psm>
-	constexpr void PixelStorageTraits<psm>::Write(const PageLookupTableT& table, u8* data, u32 block, u32 bw, u32 x, u32 y, PackedT value)
+	constexpr void PixelStorageTraits<psm>::WriteAt(u8* data, u32 pixel_addr, PackedT value)
 	{
-		const u32 pixel_addr = Address(table, block, bw, x, y);
 		const u32 bits = pixel_addr * UnpackedBitWidth(psm) + BitOffset();
 		const u32 byte_addr = (bits / 8) & (MEMORY_SIZE - sizeof(PackedT));
 		const u32 shift = bits % 8;
@@ -501,9 +506,8 @@ namespace GSMem
 	}
 
 	template<PixelStorageMode psm>
-	constexpr auto PixelStorageTraits<psm>::Read(const PageLookupTableT& table, u8* data, u32 block, u32 bw, u32 x, u32 y) -> PackedT
+	constexpr auto PixelStorageTraits<psm>::ReadAt(const u8* data, u32 pixel_addr) -> PackedT
 	{
-		const u32 pixel_addr = Address(table, block, bw, x, y);
 		const u32 bits = pixel_addr * UnpackedBitWidth(psm) + BitOffset();
 		const u32 byte_addr = (bits / 8) & (MEMORY_SIZE - sizeof(PackedT));
 		const u32 shift = bits % 8;
@@ -536,6 +540,18 @@ namespace GSMem
 		return 0xFFFF00FFu;
 	}
 
+	template<PixelStorageMode psm>
+	constexpr void PixelStorageTraits<psm>::Write(const PageLookupTableT& table, u8* data, u32 block, u32 bw, u32 x, u32 y, PackedT value)
+	{
+		WriteAt(data, Address(table, block, bw, x, y), value);
+	}
+
+	template<PixelStorageMode psm>
+	constexpr auto PixelStorageTraits<psm>::Read(const PageLookupTableT& table, u8* data, u32 block, u32 bw, u32 x, u32 y) -> PackedT
+	{
+		return ReadAt(data, Address(table, block, bw, x, y));
+	}
+
 	void InitLookupTables();
 
 	void WriteCT32(u8* data, u32 bp, u32 bw, u32 x, u32 y, u32 value);
@@ -580,4 +596,27 @@ namespace GSMem
 	u32 ReadP4HH(u8* data, u32 bp, u32 bw, u32 x, u32 y);
 
 	u32 ReadNull(u8* data, u32 bp, u32 bw, u32 x, u32 y);
+
+	// transfer helpers
+	// these address memory exactly like the Write*/Read* functions above, but
+	// resolve the page once per run of pixels instead of once per pixel
+
+	// writes count pixels of row y starting at x, one value per pixel
+	void WriteSpan(PixelStorageMode psm, u8* data, u32 bp, u32 bw, u32 x, u32 y, u32 count, const u32* values);
+
+	// reads count pixels of row y starting at x, one value per pixel
+	void ReadSpan(PixelStorageMode psm, u8* data, u32 bp, u32 bw, u32 x, u32 y, u32 count, u32* values);
+
+	// pixel extent of the blocks written by WriteBlock for a w x h rectangle at x, y
+	// { 0, 0 } if the psm has no block path, or if two pixels of the rectangle
+	// could share an address (then the pixels have to be written in order)
+	Extent2D TransferBlockExtent(PixelStorageMode psm, u32 bp, u32 bw, u32 x, u32 y, u32 w, u32 h);
+
+	// writes a whole block; x and y must be aligned to TransferBlockExtent and
+	// stride is the distance between rows of values, in pixels
+	void WriteBlock(PixelStorageMode psm, u8* data, u32 bp, u32 bw, u32 x, u32 y, const u32* values, usz stride);
+
+	// byte range [begin, end) that can be touched by a rectangle of pixels
+	// returns false if the range wraps around the end of memory
+	bool ByteRange(PixelStorageMode psm, u32 bp, u32 bw, u32 x, u32 y, u32 w, u32 h, u32& begin, u32& end);
 }
\ No newline at end of file
@@ -1,12 +1,123 @@
 #ifndef PS2_AUDIO_H
 #define PS2_AUDIO_H
 
+#include "runtime/ps2_spu2.h"
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
 
+namespace ps2_vag
+{
+    // Decodes one 16-byte SPU ADPCM block into 28 samples, carrying the
+    // predictor history in s1/s2 from block to block.
+    void decodeBlock(const uint8_t *block, int16_t &s1, int16_t &s2, int16_t *out);
+
+    // Hashes the sample rate and the whole ADPCM blocks of a VAG file
+    // without decoding them. Returns false when data is not a VAG file.
+    bool contentKey(const uint8_t *data, uint32_t sizeBytes, uint64_t &outKey, uint32_t &outSampleRate);
+}
+
+// Decoded PCM keyed by ps2_vag::contentKey. Games re-upload the same banks on
+// every scene change; a hit hands back the shared buffer instead of decoding
+// again. Least recently used entries go once the budget is exceeded.
+class PS2VagCache
+{
+public:
+    using Pcm = std::shared_ptr<const std::vector<int16_t>>;
+    static constexpr size_t kDefaultBudgetBytes = 64u * 1024u * 1024u;
+
+    explicit PS2VagCache(size_t budgetBytes = kDefaultBudgetBytes);
+
+    Pcm find(uint64_t key);
+    // Returns the cached buffer if another caller inserted key first.
+    Pcm insert(uint64_t key, std::vector<int16_t> &&pcm);
+    void clear();
+
+    [[nodiscard]] size_t sizeBytes() const;
+    [[nodiscard]] size_t entryCount() const;
+    [[nodiscard]] uint64_t hits() const;
+    [[nodiscard]] uint64_t misses() const;
+
+private:
+    struct Entry
+    {
+        Pcm pcm;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    void evictUnlocked();
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::list<uint64_t> m_lru;
+    size_t m_budgetBytes;
+    size_t m_bytes = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+// Incremental VAG decoder. Bytes may arrive in chunks of any size; the 48-byte
+// header and partial ADPCM blocks are carried across feed() calls, so a file
+// can be decoded while it is read. Samples go to the sink in chunks of at most
+// kChunkSamples as they are decoded; the decoder keeps no PCM of its own.
+class PS2VagStreamDecoder
+{
+public:
+    static constexpr size_t kChunkBlocks = 64;
+    static constexpr size_t kChunkSamples = kChunkBlocks * 28;
+    using PcmSink = std::function<void(const int16_t *samples, size_t count)>;
+
+    explicit PS2VagStreamDecoder(PcmSink sink = {});
+
+    // Returns false once the stream is known not to be a VAG file.
+    bool feed(const uint8_t *data, size_t size);
+    // Hands samples still waiting in the chunk buffer to the sink. Runs on
+    // its own once the last block is decoded.
+    void flush();
+
+    [[nodiscard]] bool headerValid() const { return m_state == State::Blocks || m_state == State::Done; }
+    [[nodiscard]] bool complete() const { return m_state == State::Done; }
+    [[nodiscard]] bool failed() const { return m_state == State::Invalid; }
+    [[nodiscard]] uint32_t sampleRate() const { return m_sampleRate; }
+    [[nodiscard]] uint32_t blocksDecoded() const { return m_blocksDecoded; }
+    // ps2_vag::contentKey of the blocks fed so far.
+    [[nodiscard]] uint64_t contentKey() const;
+
+private:
+    enum class State
+    {
+        Header,
+        Blocks,
+        Done,
+        Invalid
+    };
+
+    void parseHeader();
+    void decodeBlock(const uint8_t *block);
+
+    PcmSink m_sink;
+    State m_state = State::Header;
+    uint8_t m_header[48] = {};
+    uint8_t m_block[16] = {};
+    size_t m_headerFill = 0;
+    size_t m_blockFill = 0;
+    uint32_t m_blocksRemaining = 0;
+    uint32_t m_blocksDecoded = 0;
+    uint32_t m_sampleRate = 44100;
+    uint64_t m_hash = 0;
+    int16_t m_s1 = 0;
+    int16_t m_s2 = 0;
+    std::array<int16_t, kChunkSamples> m_chunk{};
+    size_t m_chunkFill = 0;
+};
+
 class PS2AudioBackend
 {
 public:
@@ -15,6 +126,14 @@ public:
 
     void onVagTransfer(const uint8_t *rdram, uint32_t srcAddr, uint32_t sizeBytes);
     void onVagTransferFromBuffer(const uint8_t *data, uint32_t sizeBytes, uint32_t keyAddr);
+    // Streamed uploads. appendVagStream takes the PCM chunks a
+    // PS2VagStreamDecoder produces while the file is read; finishVagStream
+    // banks the sample under keyAddr as onVagTransferFromBuffer would for
+    // the same bytes, abortVagStream drops it.
+    uint64_t beginVagStream(uint32_t keyAddr);
+    void appendVagStream(uint64_t streamId, const int16_t *samples, size_t count);
+    void finishVagStream(uint64_t streamId, uint32_t sampleRate, uint64_t contentKey);
+    void abortVagStream(uint64_t streamId);
     void onSoundCommand(uint32_t sid, uint32_t rpcNum,
                         const uint8_t *sendBuf, uint32_t sendSize,
                         uint8_t *recvBuf, uint32_t recvSize);
@@ -23,27 +142,53 @@ public:
               uint32_t voiceIndex = 0xFFFFFFFFu);
     void stop(uint32_t voiceId);
     void stopAll();
-    void setAudioReady(bool ready) { m_audioReady = ready; }
+    // Starts or stops the mixer thread and the host audio stream it feeds.
+    void setAudioReady(bool ready);
+    // True while the mixer thread is consuming SPU2 state in real time.
+    [[nodiscard]] bool streaming() const;
+
+    PS2Spu2 &spu2() { return m_spu2; }
+    const PS2Spu2 &spu2() const { return m_spu2; }
+    const PS2VagCache &vagCache() const { return m_vagCache; }
 
 private:
     struct DecodedSample
     {
-        std::vector<int16_t> pcm;
+        std::shared_ptr<const std::vector<int16_t>> pcm;
         uint32_t sampleRate = 44100;
     };
 
+    struct LoadedSample
+    {
+        uint32_t key = 0;
+        DecodedSample sample;
+    };
+
+    struct PendingVagStream
+    {
+        uint32_t keyAddr = 0;
+        std::vector<int16_t> pcm;
+    };
+
     struct Impl;
     std::unique_ptr<Impl> m_impl;
+    PS2Spu2 m_spu2;
+    PS2VagCache m_vagCache;
     bool m_audioReady = false;
     uint32_t m_mostRecentSampleKey = 0;
-    std::vector<DecodedSample> m_loadOrderSamples;
-    std::vector<uint32_t> m_loadOrderSampleKeys;
+    std::deque<LoadedSample> m_loadOrderSamples;
     std::unordered_map<uint32_t, DecodedSample> m_sampleBank;
+    std::unordered_map<uint64_t, PendingVagStream> m_vagStreams;
+    uint64_t m_nextVagStreamId = 1;
     std::mutex m_mutex;
 
-    void playDecodedSample(uint32_t sampleKey, DecodedSample &sample, float pitch, float volume,
+    bool decodeCached(const uint8_t *data, uint32_t sizeBytes, DecodedSample &outSample);
+    void storeLoadedSample(uint32_t keyAddr, DecodedSample &&sample);
+    void playDecodedSample(uint32_t sampleKey, const DecodedSample &sample, float pitch, float volume,
                           bool isBgm = false);
-    void pruneFinishedSounds();
+    void startMixer();
+    void stopMixer();
+    void mixerLoop();
 };
 
 #endif
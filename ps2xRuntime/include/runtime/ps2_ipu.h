@@ -0,0 +1,140 @@
+#ifndef PS2_IPU_H
+#define PS2_IPU_H
+
+#include "runtime/ps2_mpeg_decoder.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Software model of the EE's Image Processing Unit. Commands run to
+// completion as soon as they are issued when the input FIFO can supply
+// their bits; one that runs dry stays busy and picks up where it stopped
+// once more input arrives through IN_FIFO or the toIPU DMA channel.
+// Output is buffered without limit and drained by the fromIPU channel or
+// OUT_FIFO reads.
+class PS2Ipu
+{
+public:
+    enum Opcode : uint32_t
+    {
+        kBclr = 0u,
+        kIdec = 1u,
+        kBdec = 2u,
+        kVdec = 3u,
+        kFdec = 4u,
+        kSetiq = 5u,
+        kSetvq = 6u,
+        kCsc = 7u,
+        kPack = 8u,
+        kSetth = 9u
+    };
+
+    static constexpr size_t kQwordBytes = 16u;
+    static constexpr size_t kFifoQwords = 8u;
+
+    // Supplies the next input qword, normally from the toIPU DMA channel;
+    // returns false when nothing is available yet.
+    using InputPull = std::function<bool(uint8_t qword[kQwordBytes])>;
+
+    PS2Ipu();
+
+    // IPU_CTRL.RST: drops the running command, both FIFOs and all state
+    // except the matrices and CLUT.
+    void reset();
+    // Restores what sceIpuInit uploads: the MPEG default intra and
+    // non-intra matrices and a 16-level grey VQ CLUT.
+    void loadDefaultTables();
+    void setInputPull(InputPull pull) { m_pull = std::move(pull); }
+
+    void writeCommand(uint32_t value);
+    void writeControl(uint32_t value);
+    [[nodiscard]] uint64_t readCommand() const;
+    [[nodiscard]] uint32_t readControl() const;
+    [[nodiscard]] uint32_t readBitPointer() const;
+    // IPU_TOP: the next 32 bits of input, bit 63 set while they are not
+    // all there yet.
+    uint64_t readTop();
+
+    void writeInput(const uint8_t qword[kQwordBytes]);
+    bool readOutput(uint8_t qword[kQwordBytes]);
+    [[nodiscard]] size_t outputQwords() const { return (m_output.size() - m_outputRead) / kQwordBytes; }
+
+    // Pulls input and retries a command that ran dry. Call after new input
+    // becomes available; returns true while the command is still waiting.
+    bool resume();
+    [[nodiscard]] bool busy() const { return m_pending; }
+
+    [[nodiscard]] const std::array<uint8_t, 64> &intraMatrix() const { return m_intraMatrix; }
+    [[nodiscard]] const std::array<uint8_t, 64> &nonIntraMatrix() const { return m_nonIntraMatrix; }
+    [[nodiscard]] const std::array<uint16_t, 16> &vqClut() const { return m_clut; }
+
+private:
+    enum class Progress : uint8_t
+    {
+        Done,
+        Starved
+    };
+
+    Progress execute();
+    Progress executeIdec();
+    Progress executeBdec();
+    Progress executeVdec();
+    Progress executeFdec();
+    Progress executeTable(Opcode opcode);
+    Progress executeCsc();
+    Progress executePack();
+    // A command hit a code it cannot decode: report ECD unless the bad
+    // code is just the end of the input so far.
+    Progress failOrStarve(const ps2_mpeg::BitReader &reader);
+
+    void run();
+    bool pull(size_t qwords);
+    void topUp();
+    void discardConsumedInput();
+    [[nodiscard]] size_t queuedQwords() const { return m_input.size() / kQwordBytes; }
+
+    [[nodiscard]] ps2_mpeg::BlockCoding blockCoding(int quantiserCode) const;
+    bool decodeBlocks(ps2_mpeg::BitReader &reader, const ps2_mpeg::BlockCoding &coding, bool intra,
+                      uint32_t codedBlockPattern, int dcPredictors[3], int16_t blocks[6][64]) const;
+    // Converts one 16x16 4:2:0 macroblock to RGB32 or RGB16 per the
+    // command's OFM/DTE bits and appends it to the output FIFO.
+    void emitRgbMacroblock(const uint8_t *luma, const uint8_t *cb, const uint8_t *cr, bool rgb16, bool dither,
+                           bool signedOutput);
+    void applyAlphaThresholds(uint8_t *rgba, size_t pixelCount) const;
+    void appendOutput(const uint8_t *data, size_t size);
+
+    InputPull m_pull;
+
+    // Input bytes from the qword IPU_BP points into; m_bitPos < 128 once
+    // consumed qwords are discarded.
+    std::vector<uint8_t> m_input;
+    size_t m_bitPos = 0u;
+
+    std::vector<uint8_t> m_output;
+    size_t m_outputRead = 0u;
+
+    uint32_t m_control = 0u;
+    uint32_t m_command = 0u;
+    uint32_t m_data = 0u;
+    uint32_t m_codedBlockPattern = 0u;
+    bool m_pending = false;
+    bool m_errorCode = false;
+    bool m_startCode = false;
+
+    // Progress of a multi-macroblock command across starvation.
+    bool m_commandStarted = false;
+    uint32_t m_unitsDone = 0u;
+    int m_quantiserCode = 0;
+    int m_dcPredictors[3] = {128, 128, 128};
+
+    std::array<uint8_t, 64> m_intraMatrix{};
+    std::array<uint8_t, 64> m_nonIntraMatrix{};
+    std::array<uint16_t, 16> m_clut{};
+    uint32_t m_threshold0 = 0u;
+    uint32_t m_threshold1 = 0u;
+};
+
+#endif
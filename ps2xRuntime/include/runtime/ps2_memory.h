@@ -12,6 +12,7 @@
 #include <mutex>
 
 #include "gs/ps2_gif_arbiter.h"
+#include "runtime/ps2_ipu.h"
 #if defined(_MSC_VER)
 #include <intrin.h>
 #elif defined(USE_SSE2NEON)
@@ -360,6 +361,11 @@ public:
     uint8_t *getGSVRAM() { return m_gsVRAM; }
     const uint8_t *getGSVRAM() const { return m_gsVRAM; }
     bool hasSeenGifCopy() const { return m_seenGifCopy; }
+    PS2Ipu &ipu() { return m_ipu; }
+    const PS2Ipu &ipu() const { return m_ipu; }
+    // Feeds the IPU from toIPU and drains its output through fromIPU;
+    // returns true while a command is still waiting for input.
+    bool pumpIpu();
     // Main RAM (32MB)
     uint8_t *m_rdram;
 
@@ -450,6 +456,18 @@ public:
 
     std::array<EeTimer, 4> m_eeTimers{};
     void queueCompletedDmacCause(uint32_t cause);
+    void raiseDStatChannel(uint32_t channelBit);
+
+    // IPU and its two DMA channels. toIPU is pulled a qword at a time as
+    // commands consume input; fromIPU drains whatever output is ready.
+    PS2Ipu m_ipu;
+    bool m_ipuToChainEnded = false;
+    bool pullIpuInput(uint8_t qword[PS2Ipu::kQwordBytes]);
+    bool readIpuChainTag();
+    void drainIpuOutput();
+    void completeIpuChannel(uint32_t channelBase, uint32_t channelBit);
+    bool readDmaQword(uint32_t address, uint8_t qword[16]);
+    bool writeDmaQword(uint32_t address, const uint8_t qword[16]);
 };
 
 #endif // PS2_MEMORY_H
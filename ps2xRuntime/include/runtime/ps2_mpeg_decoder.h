@@ -0,0 +1,251 @@
+#ifndef PS2_MPEG_DECODER_H
+#define PS2_MPEG_DECODER_H
+
+#include "runtime/ps2_mpeg_video.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ps2_mpeg
+{
+    // MSB-first reader over a byte buffer. Reads past the end return zero
+    // bits and leave overrun() set, so a caller can decode optimistically and
+    // retry once more data has arrived.
+    class BitReader
+    {
+    public:
+        BitReader() = default;
+        BitReader(const uint8_t *data, size_t size, size_t bitPosition = 0u)
+            : m_data(data), m_size(size), m_bitPos(bitPosition) {}
+
+        // count is 1..32.
+        [[nodiscard]] uint32_t peek(uint32_t count) const
+        {
+            return static_cast<uint32_t>(window() >> (64u - count));
+        }
+        void skip(uint32_t count) { m_bitPos += count; }
+        uint32_t read(uint32_t count)
+        {
+            const uint32_t value = peek(count);
+            m_bitPos += count;
+            return value;
+        }
+        bool readFlag() { return read(1u) != 0u; }
+        void byteAlign() { m_bitPos = (m_bitPos + 7u) & ~static_cast<size_t>(7u); }
+
+        [[nodiscard]] size_t position() const { return m_bitPos; }
+        void setPosition(size_t bitPosition) { m_bitPos = bitPosition; }
+        [[nodiscard]] size_t bitSize() const { return m_size * 8u; }
+        [[nodiscard]] bool overrun() const { return m_bitPos > m_size * 8u; }
+
+        // Next 24 bits are a start code prefix (0x000001) at a byte boundary
+        // or, as the slice layer checks it, 23 zero bits.
+        [[nodiscard]] bool atStartCode() const { return peek(23u) == 0u; }
+
+    private:
+        [[nodiscard]] uint64_t window() const;
+
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0u;
+        size_t m_bitPos = 0u;
+    };
+
+    // macroblock_type flags, in the bit order the IPU reports them.
+    enum MacroblockFlags : uint32_t
+    {
+        kMbIntra = 1u << 0u,
+        kMbPattern = 1u << 1u,
+        kMbMotionBackward = 1u << 2u,
+        kMbMotionForward = 1u << 3u,
+        kMbQuant = 1u << 4u
+    };
+
+    enum class PictureCoding : uint8_t
+    {
+        Intra = 1,
+        Predicted = 2,
+        Bidirectional = 3,
+        DcIntra = 4
+    };
+
+    // Address increment escapes, as VDEC reports them.
+    constexpr int kMbaStuffing = 0x22;
+    constexpr int kMbaEscape = 0x23;
+    constexpr int kVlcInvalid = -0x8000;
+
+    // Everything block decoding needs that stays fixed across a macroblock.
+    // Matrices are in raster order; scan maps scan index to raster index.
+    struct BlockCoding
+    {
+        const uint8_t *scan = nullptr;
+        const uint8_t *intraMatrix = nullptr;
+        const uint8_t *nonIntraMatrix = nullptr;
+        int quantiserScale = 2;
+        int intraDcPrecision = 0;
+        bool intraVlcFormat = false;
+        bool mpeg1 = false;
+    };
+
+    extern const uint8_t kZigzagScan[64];
+    extern const uint8_t kAlternateScan[64];
+    extern const uint8_t kDefaultIntraMatrix[64];
+    extern const uint8_t kDefaultNonIntraMatrix[64];
+
+    // quantiser_scale_code to quantiser_scale (MPEG-2 units; MPEG-1 streams
+    // use the linear mapping).
+    int quantiserScale(int code, bool nonLinear);
+
+    // Single VLC symbols. Each returns kVlcInvalid on a code that is not in
+    // the table and leaves the reader just past the symbol otherwise.
+    // The address increment returns kMbaStuffing/kMbaEscape unexpanded.
+    int decodeAddressIncrementCode(BitReader &reader);
+    // Full macroblock_address_increment with escapes summed and stuffing
+    // skipped; 0 at a start code or on an invalid code.
+    int decodeMacroblockAddressIncrement(BitReader &reader);
+    int decodeMacroblockType(BitReader &reader, PictureCoding coding);
+    int decodeCodedBlockPattern(BitReader &reader);
+    int decodeMotionCode(BitReader &reader);
+    int decodeDualPrimeVector(BitReader &reader);
+
+    // Parses one 8x8 block into block (raster order, dequantised, mismatch
+    // controlled). dcPredictor is the running intra DC predictor of the
+    // block's colour component. Returns false on a corrupt block.
+    bool decodeIntraBlock(BitReader &reader, const BlockCoding &coding, bool chroma,
+                          int &dcPredictor, int16_t block[64]);
+    bool decodeNonIntraBlock(BitReader &reader, const BlockCoding &coding, int16_t block[64]);
+
+    // 8x8 inverse DCT in place; results saturate to -256..255.
+    void inverseDct(int16_t block[64]);
+    // Store or accumulate an IDCT result into 8-bit pixels.
+    void putBlock(const int16_t block[64], uint8_t *dst, size_t stride);
+    void addBlock(const int16_t block[64], uint8_t *dst, size_t stride);
+
+    // Half-pel prediction of a width x height block (width 8 or 16) from src.
+    // average blends into what dst already holds, for the second direction
+    // of a bidirectional macroblock.
+    void predictBlock(uint8_t *dst, size_t dstStride, const uint8_t *src, size_t srcStride,
+                      uint32_t width, uint32_t height, bool halfX, bool halfY, bool average);
+}
+
+// Self-contained MPEG-1/MPEG-2 video decoder for the 4:2:0 main profile
+// streams found on PS2 discs (up to 720x576). Frame pictures only; field
+// pictures and dual-prime prediction are dropped with a warning.
+class PS2MpegDecoder final : public PS2MpegVideoDecoder
+{
+public:
+    static constexpr uint32_t kMaxWidth = 720u;
+    static constexpr uint32_t kMaxHeight = 576u;
+
+    PS2MpegDecoder();
+
+    bool feed(const uint8_t *data, size_t size, int64_t pts90k, int64_t dts90k,
+              PS2MpegPictureQueue &pictures) override;
+    bool flush(PS2MpegPictureQueue &pictures) override;
+    void reset() override;
+
+    [[nodiscard]] uint64_t picturesDecoded() const { return m_picturesDecoded; }
+    [[nodiscard]] uint64_t picturesSkipped() const { return m_picturesSkipped; }
+
+private:
+    struct Frame
+    {
+        std::vector<uint8_t> luma;
+        std::vector<uint8_t> cb;
+        std::vector<uint8_t> cr;
+        int64_t pts90k = -1;
+        int repeatPict = 0;
+    };
+
+    struct SequenceState
+    {
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        uint32_t mbWidth = 0u;
+        uint32_t mbHeight = 0u;
+        bool mpeg2 = false;
+        bool progressiveSequence = true;
+        std::array<uint8_t, 64> intraMatrix{};
+        std::array<uint8_t, 64> nonIntraMatrix{};
+        bool valid = false;
+    };
+
+    struct PictureState
+    {
+        ps2_mpeg::PictureCoding coding = ps2_mpeg::PictureCoding::Intra;
+        int fCode[2][2] = {{1, 1}, {1, 1}};
+        bool fullPel[2] = {false, false};
+        int intraDcPrecision = 0;
+        int pictureStructure = 3;
+        bool topFieldFirst = false;
+        bool framePredFrameDct = true;
+        bool concealmentVectors = false;
+        bool qScaleType = false;
+        bool intraVlcFormat = false;
+        bool alternateScan = false;
+        bool repeatFirstField = false;
+        bool progressiveFrame = true;
+        int64_t pts90k = -1;
+    };
+
+    // Motion state carried between macroblocks of a slice.
+    struct MotionState
+    {
+        int pmv[2][2][2] = {};
+        uint32_t flags = 0u;
+        int motionType = 2;
+        int vectors[2][2][2] = {};
+        bool fieldSelect[2][2] = {};
+    };
+
+    bool processUnit(uint8_t code, const uint8_t *payload, size_t size, PS2MpegPictureQueue &pictures);
+    bool parseSequenceHeader(const uint8_t *payload, size_t size);
+    void parseExtension(const uint8_t *payload, size_t size);
+    void parsePictureHeader(const uint8_t *payload, size_t size);
+    bool startPicture(PS2MpegPictureQueue &pictures);
+    bool finishPicture(PS2MpegPictureQueue &pictures);
+    void decodeSlice(uint32_t row, const uint8_t *payload, size_t size);
+    bool decodeMacroblock(ps2_mpeg::BitReader &reader, uint32_t mbX, uint32_t mbY, int &quantiserScale,
+                          int dcPredictors[3], MotionState &motion);
+    void skipMacroblock(uint32_t mbX, uint32_t mbY, MotionState &motion);
+    bool decodeMotionVectors(ps2_mpeg::BitReader &reader, int direction, MotionState &motion);
+    void predictMacroblock(uint32_t mbX, uint32_t mbY, const MotionState &motion);
+    void predictFromReference(const Frame &reference, uint32_t mbX, uint32_t mbY, int direction,
+                              const MotionState &motion, bool average);
+    void predictRegion(const Frame &reference, uint32_t x, uint32_t y, uint32_t lumaRows, int mvX, int mvY,
+                       uint32_t sourceField, uint32_t targetField, bool fieldPrediction, bool average);
+    bool outputFrame(const Frame &frame, PS2MpegPictureQueue &pictures);
+    void allocateFrames();
+    [[nodiscard]] ps2_mpeg::BlockCoding blockCoding(int quantiserScale) const;
+
+    // Elementary stream bytes from the start of the unit being gathered; a
+    // unit is parsed once the next start code shows where it ends.
+    std::vector<uint8_t> m_stream;
+    bool m_haveUnit = false;
+    uint8_t m_unitCode = 0u;
+    int64_t m_unitPts = -1;
+    size_t m_scanPos = 0u;
+    int64_t m_pendingPts = -1;
+
+    SequenceState m_sequence;
+    PictureState m_picture;
+    bool m_pictureHeaderSeen = false;
+    bool m_pictureActive = false;
+    bool m_pictureDropped = false;
+
+    // m_frames[m_forwardIndex] / m_frames[m_backwardIndex] are the anchors;
+    // the third buffer receives B pictures.
+    std::array<Frame, 3> m_frames{};
+    uint32_t m_frameMbWidth = 0u;
+    uint32_t m_frameMbHeight = 0u;
+    int m_forwardIndex = -1;
+    int m_backwardIndex = -1;
+    int m_currentIndex = -1;
+    bool m_backwardPending = false;
+
+    uint64_t m_picturesDecoded = 0u;
+    uint64_t m_picturesSkipped = 0u;
+};
+
+#endif
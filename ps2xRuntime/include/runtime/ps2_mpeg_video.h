@@ -0,0 +1,110 @@
+#ifndef PS2_MPEG_VIDEO_H
+#define PS2_MPEG_VIDEO_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// One decoded 4:2:0 picture. Planes cover whole macroblocks so converters
+// never special-case the right or bottom edge; padding reads as black.
+struct PS2MpegPicture
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    int repeatPict = 0;
+    int64_t pts90k = -1;
+    std::vector<uint8_t> luma;
+    std::vector<uint8_t> cb;
+    std::vector<uint8_t> cr;
+
+    // Sizes the planes for a width x height picture. Storage is kept when a
+    // slot is reused at the same size.
+    void allocate(uint32_t pictureWidth, uint32_t pictureHeight);
+
+    [[nodiscard]] uint32_t alignedWidth() const { return (width + 15u) & ~15u; }
+    [[nodiscard]] uint32_t alignedHeight() const { return (height + 15u) & ~15u; }
+    [[nodiscard]] uint32_t lumaStride() const { return alignedWidth(); }
+    [[nodiscard]] uint32_t chromaStride() const { return alignedWidth() / 2u; }
+};
+
+// Fixed pool of picture slots shared by a decode worker and the EE. The
+// worker fills a free slot and publishes it; the EE takes the oldest ready
+// slot, converts it into guest memory and releases it back to the pool.
+class PS2MpegPictureQueue
+{
+public:
+    explicit PS2MpegPictureQueue(size_t slotCount);
+
+    // Producer side. acquire() blocks while every slot is in use and returns
+    // nullptr once the queue has been closed.
+    PS2MpegPicture *acquire();
+    PS2MpegPicture *tryAcquire();
+    void publish(PS2MpegPicture *picture);
+
+    // Consumer side.
+    [[nodiscard]] const PS2MpegPicture *peek() const;
+    PS2MpegPicture *take();
+    [[nodiscard]] size_t readyCount() const;
+
+    // Either side may hand back a slot it acquired or took.
+    void release(PS2MpegPicture *picture);
+
+    // Total pictures ever published; lets a producer tell whether a decode
+    // step produced anything without racing the consumer's readyCount().
+    [[nodiscard]] uint64_t publishedCount() const;
+
+    void clear();
+    // close() fails current and future acquire() calls until reopen(), so a
+    // producer blocked on a full queue can be shut down.
+    void close();
+    void reopen();
+    [[nodiscard]] size_t slotCount() const { return m_slots.size(); }
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_slotFreed;
+    std::vector<std::unique_ptr<PS2MpegPicture>> m_slots;
+    std::vector<PS2MpegPicture *> m_free;
+    std::deque<PS2MpegPicture *> m_ready;
+    uint64_t m_published = 0;
+    bool m_closed = false;
+};
+
+// Video decoder interface used by the MPEG stubs. feed() may be given any
+// split of the elementary stream and publishes every completed picture.
+class PS2MpegVideoDecoder
+{
+public:
+    virtual ~PS2MpegVideoDecoder() = default;
+
+    // Returns false when the stream cannot be decoded from here on.
+    virtual bool feed(const uint8_t *data, size_t size, int64_t pts90k, int64_t dts90k,
+                      PS2MpegPictureQueue &pictures) = 0;
+    virtual bool flush(PS2MpegPictureQueue &pictures) = 0;
+    virtual void reset() = 0;
+};
+
+namespace ps2_mpeg
+{
+    enum class PixelFormat : uint8_t
+    {
+        Rgba32,
+        Rgb16
+    };
+
+    // Converts pixelCount pixels of one picture row to the guest format
+    // (BT.601 studio range). cb/cr hold one sample per two pixels and the
+    // span must start on an even pixel. RGB16 is 5:5:5 with the top bit set
+    // when alpha is non-zero.
+    void convertRow(const uint8_t *luma, const uint8_t *cb, const uint8_t *cr,
+                    uint32_t pixelCount, uint8_t alpha, PixelFormat format, uint8_t *dst);
+
+    // Scalar form of convertRow for a single pixel, returned as R, G, B.
+    void convertPixel(uint8_t y, uint8_t cb, uint8_t cr, uint8_t rgb[3]);
+}
+
+#endif
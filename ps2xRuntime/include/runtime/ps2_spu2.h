@@ -0,0 +1,148 @@
+#ifndef PS2_SPU2_H
+#define PS2_SPU2_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Single-producer/single-consumer ring of interleaved stereo int16 frames.
+// The mixer thread writes and the host audio callback reads; neither side
+// ever blocks the other.
+class PS2AudioRing
+{
+public:
+    // Capacity is rounded up to a power of two frames.
+    explicit PS2AudioRing(size_t capacityFrames);
+
+    size_t write(const int16_t *frames, size_t frameCount);
+    size_t read(int16_t *frames, size_t frameCount);
+    [[nodiscard]] size_t available() const;
+    [[nodiscard]] size_t space() const;
+    [[nodiscard]] size_t capacity() const { return m_mask + 1u; }
+
+private:
+    std::vector<int16_t> m_samples;
+    size_t m_mask = 0;
+    std::atomic<size_t> m_readPos{0};
+    std::atomic<size_t> m_writePos{0};
+};
+
+// Software model of the two SPU2 cores: 48 voices decoding ADPCM straight out
+// of a 2 MiB sound RAM with per-voice pitch, ADSR envelope and volume, plus
+// the core PCM inputs fed by libsd block transfers. Host-decoded samples
+// (VAG files loaded from disc) can be keyed onto a voice as PCM.
+class PS2Spu2
+{
+public:
+    static constexpr uint32_t kRamBytes = 2u * 1024u * 1024u;
+    static constexpr uint32_t kCoreCount = 2u;
+    static constexpr uint32_t kVoicesPerCore = 24u;
+    static constexpr uint32_t kVoiceCount = kCoreCount * kVoicesPerCore;
+    static constexpr uint32_t kOutputRate = 48000u;
+
+    // libsd voice parameter indices (SD_VP_* >> 8).
+    enum class VoiceParam : uint8_t
+    {
+        VolumeLeft = 0,
+        VolumeRight = 1,
+        Pitch = 2,
+        Adsr1 = 3,
+        Adsr2 = 4,
+        Envelope = 5
+    };
+
+    PS2Spu2();
+
+    void reset();
+
+    void writeRam(uint32_t spuAddr, const uint8_t *data, uint32_t size);
+    [[nodiscard]] uint16_t readRam16(uint32_t spuAddr) const;
+
+    void setVoiceParam(uint32_t voice, VoiceParam param, uint16_t value);
+    [[nodiscard]] uint16_t voiceParam(uint32_t voice, VoiceParam param) const;
+    void setVoiceStartAddress(uint32_t voice, uint32_t spuAddr);
+    void setVoiceLoopAddress(uint32_t voice, uint32_t spuAddr);
+    void keyOn(uint32_t core, uint32_t voiceMask);
+    void keyOff(uint32_t core, uint32_t voiceMask);
+    [[nodiscard]] bool voiceActive(uint32_t voice) const;
+
+    // Plays already-decoded PCM on a free voice; pitch scales sampleRate.
+    bool keyOnSample(std::shared_ptr<const std::vector<int16_t>> pcm, uint32_t sampleRate,
+                     float pitch, float volume, uint32_t sampleKey);
+    [[nodiscard]] bool samplePlaying(uint32_t sampleKey) const;
+    void stopSamples();
+
+    // Streams 16-bit PCM in the ADMA layout (512 bytes left, then 512 bytes
+    // right) from host memory that outlives the stream.
+    void startCoreInput(uint32_t core, const uint8_t *data, uint32_t size, uint32_t offset, bool loop);
+    void stopCoreInput(uint32_t core);
+    [[nodiscard]] bool coreInputOffset(uint32_t core, uint32_t &offset) const;
+
+    // Renders interleaved stereo frames at kOutputRate.
+    void mix(int16_t *out, size_t frameCount);
+
+private:
+    enum class EnvelopePhase : uint8_t
+    {
+        Off,
+        Attack,
+        Decay,
+        Sustain,
+        Release
+    };
+
+    struct Voice
+    {
+        uint32_t startAddr = 0;
+        uint32_t loopAddr = 0;
+        uint32_t nextBlockAddr = 0;
+        bool loopAddrSet = false;
+        bool endAfterBlock = false;
+
+        std::array<int16_t, 28> block{};
+        uint32_t blockPos = 28;
+        int16_t s1 = 0;
+        int16_t s2 = 0;
+        int16_t prevSample = 0;
+        int16_t curSample = 0;
+        uint32_t counter = 0;
+
+        uint16_t pitch = 0;
+        uint16_t adsr1 = 0;
+        uint16_t adsr2 = 0;
+        uint16_t volLeft = 0;
+        uint16_t volRight = 0;
+
+        EnvelopePhase phase = EnvelopePhase::Off;
+        int32_t envelope = 0;
+        uint32_t envelopeCounter = 0;
+
+        std::shared_ptr<const std::vector<int16_t>> pcm;
+        size_t pcmPos = 0;
+        uint32_t sampleKey = 0;
+    };
+
+    struct CoreInput
+    {
+        const uint8_t *data = nullptr;
+        uint32_t size = 0;
+        uint32_t offset = 0;
+        bool loop = false;
+    };
+
+    int16_t nextVoiceSample(Voice &voice);
+    void decodeNextBlock(Voice &voice);
+    void tickEnvelope(Voice &voice);
+    void readCoreInput(CoreInput &input, int32_t &left, int32_t &right);
+
+    mutable std::mutex m_mutex;
+    std::vector<uint8_t> m_ram;
+    std::array<Voice, kVoiceCount> m_voices{};
+    std::array<CoreInput, kCoreCount> m_inputs{};
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <cstdint>
+#include <vector>
 
 class GS;
 class PS2Memory;
@@ -102,10 +103,43 @@ private:
         bool reserved = false;
     };
 
+    struct DecodedInstructionPair;
+    struct UpperHandlerTable;
+
+    // Upper instructions are resolved to a handler when the pair is decoded.
+    // Handlers are specialized by opcode class and dest mask and read their
+    // operand fields from the decoded pair instead of the raw word.
+    using UpperHandler = void (VU1Interpreter::*)(const DecodedInstructionPair &decoded);
+
+    enum class FmacOp : uint8_t
+    {
+        Add,
+        Sub,
+        Mul,
+        Madd,
+        Msub
+    };
+
+    enum class FmacSource : uint8_t
+    {
+        Broadcast,
+        Q,
+        I,
+        Vector,
+        Outer
+    };
+
     struct DecodedInstructionPair
     {
         uint32_t lower = 0;
         uint32_t upper = 0;
+        UpperHandler upperHandler = nullptr;
+        uint8_t dest = 0;
+        uint8_t fs = 0;
+        uint8_t ft = 0;
+        uint8_t fd = 0;
+        uint8_t bc = 0;
+        bool lowerNop = false;
         InstructionUsage lowerUsage{};
         InstructionUsage upperUsage{};
         bool iBit = false;
@@ -117,6 +151,32 @@ private:
         uint8_t suppressedLowerVf = 0;
     };
 
+    // Read of a register lane that a fast block does not write before the
+    // read. The block may only start once the pending value is ready by the
+    // read's issue offset.
+    struct FastBlockRead
+    {
+        uint16_t issueOffset = 0;
+        uint8_t kind = 0;
+        uint8_t reg = 0;
+        uint8_t lanes = 0;
+    };
+
+    // Straight-line run of cached pairs whose hazards were resolved ahead of
+    // time. Pairs whose writes land before the block ends run with immediate
+    // register writes; the trailing pairs queue theirs as usual.
+    struct FastBlock
+    {
+        uint32_t issueBegin = 0;
+        uint32_t readBegin = 0;
+        uint16_t readCount = 0;
+        uint16_t pairCount = 0;
+        uint16_t immediatePairs = 0;
+        uint16_t cycles = 0;
+        uint16_t settleCycles = 0;
+        bool analyzed = false;
+    };
+
     struct FlagPipelineEntry
     {
         uint64_t readyCycle = 0;
@@ -199,15 +259,22 @@ private:
     static constexpr uint32_t kMaxPendingViWrites = 8u;
     static constexpr uint32_t kMaxPendingAccWrites = 8u;
     static constexpr uint32_t kMaxDecodedPairs = 0x4000u / 8u;
+    static constexpr uint32_t kMinFastBlockPairs = 4u;
+    static constexpr uint32_t kMaxFastBlockPairs = 128u;
 
     Unit m_unit;
     VU1State m_state;
     std::array<DecodedInstructionPair, kMaxDecodedPairs> m_decodedCodeCache{};
+    DecodedInstructionPair m_uncachedPair{};
     const uint8_t *m_cachedVuCode = nullptr;
     const PS2Memory *m_cachedMemory = nullptr;
     uint32_t m_cachedCodeSize = 0;
     uint64_t m_cachedCodeGeneration = 0;
+    uint32_t m_cachedPairCount = 0;
     bool m_decodedCodeCacheValid = false;
+    std::array<FastBlock, kMaxDecodedPairs> m_fastBlocks{};
+    std::vector<uint16_t> m_fastBlockIssue;
+    std::vector<FastBlockRead> m_fastBlockReads;
 
     std::array<FlagPipelineEntry, kMaxFlagEntries> m_flagPipeline{};
     ScalarPipelineEntry m_fdiv{};
@@ -228,7 +295,6 @@ private:
     uint64_t m_nextWriteSequence = 0;
     uint64_t m_efuResourceReady = 0;
     uint32_t m_workingClip = 0;
-    uint32_t m_currentUpperInstruction = 0;
     int32_t m_viBranchBackupValue = 0;
     uint8_t m_viBranchBackupReg = 0;
     bool m_viBranchBackupValid = false;
@@ -250,21 +316,40 @@ private:
     static void addVfWrite(InstructionUsage &usage, uint8_t reg, uint8_t lanes);
     static uint8_t vfReadLanes(const InstructionUsage &usage, uint8_t reg);
     DecodedInstructionPair decodeInstructionPair(const uint8_t *vuCode, uint32_t pc) const;
-    DecodedInstructionPair getDecodedInstructionPairForPc(const uint8_t *vuCode, uint32_t codeSize, PS2Memory *memory, uint32_t pc);
+    const DecodedInstructionPair &getDecodedInstructionPairForPc(const uint8_t *vuCode, uint32_t codeSize, PS2Memory *memory, uint32_t pc);
     void rebuildDecodedCodeCache(const uint8_t *vuCode, uint32_t codeSize, const PS2Memory *memory, uint64_t generation);
 
-    void execUpper(uint32_t instr);
-    void execLower(uint32_t instr, uint8_t *vuData, uint32_t dataSize, GS &gs, PS2Memory *memory, uint32_t upperInstr);
+    static UpperHandler selectUpperHandler(uint32_t upper);
+    template <FmacOp Op, FmacSource Source, bool ToAcc, uint8_t Dest>
+    void upperFmac(const DecodedInstructionPair &decoded);
+    template <bool Max, FmacSource Source, uint8_t Dest>
+    void upperMinMax(const DecodedInstructionPair &decoded);
+    void upperItof(const DecodedInstructionPair &decoded);
+    void upperFtoi(const DecodedInstructionPair &decoded);
+    void upperAbs(const DecodedInstructionPair &decoded);
+    void upperClip(const DecodedInstructionPair &decoded);
+    void upperNop(const DecodedInstructionPair &decoded);
+    void upperReserved(const DecodedInstructionPair &decoded);
+    void execLower(uint32_t instr, uint8_t *vuData, uint32_t dataSize, GS &gs, PS2Memory *memory);
+    void executePair(const DecodedInstructionPair &decoded,
+                     uint8_t *vuData, uint32_t dataSize,
+                     GS &gs, PS2Memory *memory);
+    void issuePair(const DecodedInstructionPair &decoded,
+                   uint8_t *vuData, uint32_t dataSize,
+                   GS &gs, PS2Memory *memory);
+
+    void resetFastBlocks();
+    const FastBlock &fastBlockAt(uint32_t pairIndex);
+    void analyzeFastBlock(uint32_t pairIndex, FastBlock &block);
+    static bool fastBlockCandidate(const DecodedInstructionPair &decoded);
+    bool canEnterFastBlock(const FastBlock &block, uint64_t budgetEnd) const;
+    bool tryRunFastBlock(const DecodedInstructionPair &decoded, uint64_t budgetEnd,
+                         uint8_t *vuData, uint32_t dataSize,
+                         GS &gs, PS2Memory *memory);
 
     void applyDest(float *dst, const float *result, uint8_t dest);
-    void applyDestAcc(const float *result, uint8_t dest);
-    void applyFmacDest(float *dst, float *result, uint8_t dest);
-    void applyFmacDestAcc(float *result, uint8_t dest);
-    void normalizeFmacResult(float *result, uint8_t dest, uint8_t laneFlags[4]);
-    bool calculateFmacExactResult(uint32_t component, long double &result) const;
     uint8_t normalizeFmacExactResult(float &value, long double exactResult) const;
-    uint32_t calculateFmacProductSticky(uint8_t dest) const;
-    void updateFmacFlags(const uint8_t laneFlags[4], uint8_t dest, uint32_t extraSticky);
+    void queueFmacFlags(uint32_t mac, uint32_t status, uint32_t extraSticky);
     void queueFsset(uint16_t immediate);
     void queueClip(uint32_t clip);
     void queueFcset(uint32_t clip);
@@ -274,10 +359,14 @@ private:
     void queueVfWrite(uint8_t reg, uint8_t laneMask, const float value[4], uint32_t latency);
     void queueViWrite(uint8_t reg, int32_t value, uint32_t latency);
     void queueAccWrite(uint8_t laneMask, const float value[4], uint32_t latency);
+    void resetXgkick();
     void startXgkick(uint32_t qwordAddress);
 
     void resetScheduler();
     void commitReadyPipelines();
+    void commitReadyFlags();
+    void commitReadyStores();
+    void commitRegisterWrites(uint64_t throughCycle);
     void advanceOneCycle();
     void advanceTo(uint64_t targetCycle);
     void flushPipelines();
@@ -293,7 +382,6 @@ private:
     int32_t readBranchVi(uint8_t reg) const;
     void recordViWriteForBranch(uint8_t reg, int32_t oldValue);
     void reportReservedInstruction(bool upper, uint32_t instruction);
-    float broadcast(const float *vf, uint8_t bc);
 };
 
 #endif
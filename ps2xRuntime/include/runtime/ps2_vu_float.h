@@ -0,0 +1,118 @@
+#ifndef PS2_VU_FLOAT_H
+#define PS2_VU_FLOAT_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(USE_SSE2NEON)
+#include "sse2neon.h"
+#else
+#include <immintrin.h> // For SSE/AVX instructions
+#include <smmintrin.h> // For SSE4.1 instructions
+#endif
+
+// The VU FMAC has no Inf, NaN or denormals: an exponent of 0 reads as a
+// signed zero and an exponent of 255 reads as the signed largest finite
+// value. Results are folded the same way.
+
+static inline constexpr uint32_t PS2_VU_FLOAT_SIGN = 0x80000000u;
+static inline constexpr uint32_t PS2_VU_FLOAT_EXPONENT = 0x7F800000u;
+static inline constexpr uint32_t PS2_VU_FLOAT_MAX = 0x7F7FFFFFu;
+
+// Lane flags reported by Ps2VuNormalizeResult, in MAC flag order (Z, S, U, O).
+static inline constexpr uint32_t PS2_VU_LANE_ZERO = 0x1u;
+static inline constexpr uint32_t PS2_VU_LANE_SIGN = 0x2u;
+static inline constexpr uint32_t PS2_VU_LANE_UNDERFLOW = 0x4u;
+static inline constexpr uint32_t PS2_VU_LANE_OVERFLOW = 0x8u;
+
+static inline float Ps2VuNormalizeOperand(float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t exponent = bits & PS2_VU_FLOAT_EXPONENT;
+    if (exponent == 0u)
+    {
+        bits &= PS2_VU_FLOAT_SIGN;
+    }
+    else if (exponent == PS2_VU_FLOAT_EXPONENT)
+    {
+        bits = (bits & PS2_VU_FLOAT_SIGN) | PS2_VU_FLOAT_MAX;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline float Ps2VuNormalizeResult(float value, uint32_t &laneFlags)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = bits & PS2_VU_FLOAT_SIGN;
+    const uint32_t magnitude = bits & ~PS2_VU_FLOAT_SIGN;
+    const uint32_t exponent = bits & PS2_VU_FLOAT_EXPONENT;
+
+    laneFlags = sign != 0u ? PS2_VU_LANE_SIGN : 0u;
+    if (magnitude == 0u)
+    {
+        laneFlags |= PS2_VU_LANE_ZERO;
+    }
+    else if (exponent == 0u)
+    {
+        laneFlags |= PS2_VU_LANE_ZERO | PS2_VU_LANE_UNDERFLOW;
+        bits = sign;
+    }
+    else if (exponent == PS2_VU_FLOAT_EXPONENT)
+    {
+        laneFlags |= PS2_VU_LANE_OVERFLOW;
+        bits = sign | PS2_VU_FLOAT_MAX;
+    }
+
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Four-lane form of Ps2VuNormalizeOperand. Without flags, operand and result
+// folding are the same bit transform, so this serves both.
+static inline __m128 Ps2VuNormalize4(__m128 value)
+{
+    const __m128i bits = _mm_castps_si128(value);
+    const __m128i signMask = _mm_set1_epi32(static_cast<int32_t>(PS2_VU_FLOAT_SIGN));
+    const __m128i exponentMask = _mm_set1_epi32(static_cast<int32_t>(PS2_VU_FLOAT_EXPONENT));
+    const __m128i exponent = _mm_and_si128(bits, exponentMask);
+    const __m128i sign = _mm_and_si128(bits, signMask);
+    const __m128i isZero = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+    const __m128i isInfNan = _mm_cmpeq_epi32(exponent, exponentMask);
+    const __m128i saturated = _mm_or_si128(sign, _mm_set1_epi32(static_cast<int32_t>(PS2_VU_FLOAT_MAX)));
+
+    __m128i out = _mm_andnot_si128(_mm_or_si128(isZero, isInfNan), bits);
+    out = _mm_or_si128(out, _mm_and_si128(isZero, sign));
+    out = _mm_or_si128(out, _mm_and_si128(isInfNan, saturated));
+    return _mm_castsi128_ps(out);
+}
+
+static inline __m128 Ps2VuMul4(__m128 lhs, __m128 rhs)
+{
+    return Ps2VuNormalize4(_mm_mul_ps(lhs, rhs));
+}
+
+static inline __m128 Ps2VuAdd4(__m128 lhs, __m128 rhs)
+{
+    return Ps2VuNormalize4(_mm_add_ps(lhs, rhs));
+}
+
+static inline __m128 Ps2VuSub4(__m128 lhs, __m128 rhs)
+{
+    return Ps2VuNormalize4(_mm_sub_ps(lhs, rhs));
+}
+
+// FTOI truncates toward zero and saturates instead of producing the x86
+// "integer indefinite" value for large positive inputs.
+static inline __m128i Ps2VuFtoi4(__m128 value)
+{
+    const __m128i truncated = _mm_cvttps_epi32(value);
+    const __m128 positiveOverflow = _mm_cmpge_ps(value, _mm_set1_ps(2147483648.0f));
+    return _mm_xor_si128(truncated, _mm_castps_si128(positiveOverflow));
+}
+
+#endif // PS2_VU_FLOAT_H
@@ -4,6 +4,7 @@
 #include "ps2_runtime_macros.h"
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstring>
 #include <limits>
@@ -53,23 +54,249 @@ namespace
     constexpr uint64_t kVBlankPeriodCycles = microsecondsToEeCycles(16667u);
     constexpr uint64_t kVBlankDurationCycles = microsecondsToEeCycles(500u);
     constexpr uint64_t kAlarmTickCycles = microsecondsToEeCycles(kAlarmTickMicroseconds);
+}
 
-    template <typename Map>
-    int allocatePositiveId(int &nextId, const Map &objects)
+EeEventRing::EeEventRing() noexcept
+{
+    for (size_t i = 0; i < kCapacity; ++i)
     {
-        const int first = std::max(1, nextId);
-        int candidate = first;
-        do
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool EeEventRing::tryPush(const EeEvent &event) noexcept
+{
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell &cell = m_cells[head & (kCapacity - 1u)];
+        const uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence == head)
         {
-            if (!objects.contains(candidate))
+            if (m_head.compare_exchange_weak(head, head + 1u, std::memory_order_relaxed))
             {
-                nextId = (candidate == std::numeric_limits<int>::max()) ? 1 : candidate + 1;
-                return candidate;
+                cell.event = event;
+                cell.sequence.store(head + 1u, std::memory_order_release);
+                return true;
             }
-            candidate = (candidate == std::numeric_limits<int>::max()) ? 1 : candidate + 1;
-        } while (candidate != first);
-        return 0;
+        }
+        else if (sequence < head)
+        {
+            return false;
+        }
+        else
+        {
+            head = m_head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool EeEventRing::tryPop(EeEvent &event) noexcept
+{
+    Cell &cell = m_cells[m_tail & (kCapacity - 1u)];
+    if (cell.sequence.load(std::memory_order_acquire) != m_tail + 1u)
+    {
+        return false;
+    }
+    event = cell.event;
+    cell.sequence.store(m_tail + kCapacity, std::memory_order_release);
+    ++m_tail;
+    return true;
+}
+
+bool EeEventRing::empty() const noexcept
+{
+    return m_cells[m_tail & (kCapacity - 1u)].sequence.load(std::memory_order_acquire) != m_tail + 1u;
+}
+
+void EeDeadlineQueue::clear()
+{
+    m_heap.clear();
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_deferred.clear();
+}
+
+EeDeadlineQueue::Handle EeDeadlineQueue::push(const EeScheduledEvent &event)
+{
+    const uint32_t slot = acquireSlot();
+    pushNode(Node{event, slot});
+    return (static_cast<uint64_t>(m_slots[slot].generation) << 32) | (static_cast<uint64_t>(slot) + 1u);
+}
+
+bool EeDeadlineQueue::erase(Handle handle)
+{
+    Slot *slot = slotFor(handle);
+    if (!slot)
+    {
+        return false;
+    }
+    const Node node = removeAt(slot->position);
+    releaseSlot(node.slot);
+    return true;
+}
+
+EeScheduledEvent EeDeadlineQueue::pop()
+{
+    assert(!m_heap.empty());
+    Node node = removeAt(0u);
+    releaseSlot(node.slot);
+    return node.event;
+}
+
+void EeDeadlineQueue::takeDue(uint64_t cycle,
+                              std::chrono::steady_clock::time_point hostNow,
+                              std::vector<EeScheduledEvent> &out)
+{
+    m_deferred.clear();
+    while (!m_heap.empty() && m_heap.front().event.deadlineCycle <= cycle)
+    {
+        Node node = removeAt(0u);
+        if (node.event.hostDeadline <= hostNow)
+        {
+            releaseSlot(node.slot);
+            out.push_back(node.event);
+        }
+        else
+        {
+            m_deferred.push_back(node);
+        }
+    }
+    for (const Node &node : m_deferred)
+    {
+        pushNode(node);
+    }
+    m_deferred.clear();
+}
+
+bool EeDeadlineQueue::before(const EeScheduledEvent &left, const EeScheduledEvent &right) noexcept
+{
+    if (left.deadlineCycle != right.deadlineCycle)
+    {
+        return left.deadlineCycle < right.deadlineCycle;
+    }
+    if (left.event.type != right.event.type)
+    {
+        return left.event.type < right.event.type;
+    }
+    if (left.event.id != right.event.id)
+    {
+        return left.event.id < right.event.id;
+    }
+    return left.sequence < right.sequence;
+}
+
+EeDeadlineQueue::Slot *EeDeadlineQueue::slotFor(Handle handle) noexcept
+{
+    const uint64_t index = handle & 0xFFFFFFFFull;
+    if (index == 0u || index > m_slots.size())
+    {
+        return nullptr;
+    }
+    Slot &slot = m_slots[static_cast<size_t>(index - 1u)];
+    return slot.live && slot.generation == static_cast<uint32_t>(handle >> 32) ? &slot : nullptr;
+}
+
+uint32_t EeDeadlineQueue::acquireSlot()
+{
+    uint32_t slot = 0;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[slot].live = true;
+    return slot;
+}
+
+void EeDeadlineQueue::releaseSlot(uint32_t slot)
+{
+    m_slots[slot].live = false;
+    ++m_slots[slot].generation;
+    m_freeSlots.push_back(slot);
+}
+
+void EeDeadlineQueue::pushNode(Node node)
+{
+    m_heap.push_back(node);
+    m_slots[node.slot].position = static_cast<uint32_t>(m_heap.size() - 1u);
+    siftUp(m_heap.size() - 1u);
+}
+
+EeDeadlineQueue::Node EeDeadlineQueue::removeAt(size_t index)
+{
+    Node removed = m_heap[index];
+    Node last = m_heap.back();
+    m_heap.pop_back();
+    if (index < m_heap.size())
+    {
+        place(index, last);
+        if (index > 0u && before(last.event, m_heap[(index - 1u) / kArity].event))
+        {
+            siftUp(index);
+        }
+        else
+        {
+            siftDown(index);
+        }
+    }
+    return removed;
+}
+
+void EeDeadlineQueue::place(size_t index, Node node)
+{
+    m_slots[node.slot].position = static_cast<uint32_t>(index);
+    m_heap[index] = node;
+}
+
+void EeDeadlineQueue::siftUp(size_t index)
+{
+    const Node node = m_heap[index];
+    while (index > 0u)
+    {
+        const size_t parent = (index - 1u) / kArity;
+        if (!before(node.event, m_heap[parent].event))
+        {
+            break;
+        }
+        place(index, m_heap[parent]);
+        index = parent;
+    }
+    place(index, node);
+}
+
+void EeDeadlineQueue::siftDown(size_t index)
+{
+    const Node node = m_heap[index];
+    for (;;)
+    {
+        const size_t firstChild = index * kArity + 1u;
+        if (firstChild >= m_heap.size())
+        {
+            break;
+        }
+        const size_t lastChild = std::min(firstChild + kArity, m_heap.size());
+        size_t best = firstChild;
+        for (size_t child = firstChild + 1u; child < lastChild; ++child)
+        {
+            if (before(m_heap[child].event, m_heap[best].event))
+            {
+                best = child;
+            }
+        }
+        if (!before(m_heap[best].event, node.event))
+        {
+            break;
+        }
+        place(index, m_heap[best]);
+        index = best;
     }
+    place(index, node);
 }
 
 EeScheduler::EeScheduler(PS2Runtime &runtime)
@@ -87,19 +314,17 @@ void EeScheduler::reset(uint8_t *rdram, const R5900Context &mainContext)
     m_executorThread = std::this_thread::get_id();
     m_rdram = rdram;
     m_readyQueues = {};
+    m_readyBitmap = {};
+    m_readySummary = 0u;
     m_threads.clear();
     m_semaphores.clear();
     m_eventFlags.clear();
     m_alarms.clear();
     m_intcHandlers.clear();
     m_dmacHandlers.clear();
-    m_nextThreadId = kFirstThreadId;
-    m_nextInvocationThreadId = -1;
-    m_nextSemaphoreId = 1;
-    m_nextEventFlagId = 1;
-    m_nextAlarmId = 1;
-    m_nextIntcHandlerId = 1;
-    m_nextDmacHandlerId = 1;
+    m_invocationThreads.clear();
+    m_intcCauseLists = {};
+    m_dmacCauseLists = {};
     m_intcHeadOrder = 0;
     m_intcTailOrder = 1000;
     m_dmacHeadOrder = 0;
@@ -118,9 +343,15 @@ void EeScheduler::reset(uint8_t *rdram, const R5900Context &mainContext)
     m_debugPublishCountdown = 0u;
     {
         std::lock_guard lock(m_eventMutex);
-        m_events.clear();
+        EeEvent discarded{};
+        while (m_eventRing.tryPop(discarded))
+        {
+        }
+        m_overflowEvents.clear();
+        m_overflowEventCount.store(0u, std::memory_order_release);
         m_deadlines.clear();
         m_pendingInvocations.clear();
+        m_pendingInvocationHead = 0u;
     }
     m_eventSequence = 0;
     m_invocationSequence = 0;
@@ -143,9 +374,7 @@ void EeScheduler::reset(uint8_t *rdram, const R5900Context &mainContext)
     main.gp = getRegU32(&mainContext, 28);
     main.initialPriority = 0;
     main.currentPriority = 0;
-    main.status = EeThreadStatus::Ready;
-    m_threads.emplace(main.id, std::move(main));
-    m_readyQueues[0].push_back(kMainThreadId);
+    enqueueReady(m_threads.emplace(main.id, std::move(main)));
     scheduleEvent(m_eeCycle + kVBlankPeriodCycles,
                   std::chrono::steady_clock::now() + kVBlankPeriod,
                   EeEvent{EeEventType::VBlankStart, 0, 0});
@@ -168,7 +397,7 @@ void EeScheduler::run()
         if (m_currentThreadId == 0)
         {
             GuestThread *next = selectReady();
-            if (!next && m_pendingInvocations.empty())
+            if (!next && !hasPendingInvocations())
             {
                 publishSnapshot();
                 waitForEvent();
@@ -181,14 +410,13 @@ void EeScheduler::run()
             else
             {
                 GuestThread *owner = &acquireInvocationThread();
-                GuestInvocation invocation = std::move(m_pendingInvocations.front());
-                m_pendingInvocations.pop_front();
+                GuestInvocationFrame invocation = popPendingInvocation();
                 owner->status = EeThreadStatus::Running;
                 m_currentThreadId = owner->id;
                 renewTimeSlice();
-                if (getRegU32(&invocation.context, 29) == 0u)
+                if (getRegU32(&invocation->context, 29) == 0u)
                 {
-                    SET_GPR_U32(&invocation.context, 29, invocationStackTop());
+                    SET_GPR_U32(&invocation->context, 29, invocationStackTop());
                 }
                 owner->invocations.push_back(std::move(invocation));
             }
@@ -233,18 +461,19 @@ void EeScheduler::run()
         {
             if (!running->invocations.empty())
             {
-                GuestInvocation completed = std::move(running->invocations.back());
+                GuestInvocationFrame completed = std::move(running->invocations.back());
                 running->invocations.pop_back();
-                if (completed.onComplete)
+                if (completed->onComplete)
                 {
                     try
                     {
-                        completed.onComplete(completed.context, running->activeContext());
+                        completed->onComplete(completed->context, running->activeContext());
                     }
                     catch (const EeDispatcherTransfer &)
                     {
                     }
                 }
+                releaseInvocationFrame(std::move(completed));
                 continue;
             }
             makeDormant(*running);
@@ -252,13 +481,12 @@ void EeScheduler::run()
             continue;
         }
 
-        if (!m_pendingInvocations.empty())
+        if (hasPendingInvocations())
         {
-            GuestInvocation invocation = std::move(m_pendingInvocations.front());
-            m_pendingInvocations.pop_front();
-            if (getRegU32(&invocation.context, 29) == 0u)
+            GuestInvocationFrame invocation = popPendingInvocation();
+            if (getRegU32(&invocation->context, 29) == 0u)
             {
-                SET_GPR_U32(&invocation.context, 29, invocationStackTop());
+                SET_GPR_U32(&invocation->context, 29, invocationStackTop());
             }
             running->invocations.push_back(std::move(invocation));
             continue;
@@ -292,7 +520,7 @@ void EeScheduler::run()
 
         try
         {
-            m_insideInterrupt = !running->invocations.empty() && running->invocations.back().kind == GuestInvocationKind::Interrupt;
+            m_insideInterrupt = !running->invocations.empty() && running->invocations.back()->kind == GuestInvocationKind::Interrupt;
             m_guestExecuting.store(true, std::memory_order_release);
             function(m_rdram, &context, &m_runtime);
             m_guestExecuting.store(false, std::memory_order_release);
@@ -333,7 +561,7 @@ void EeScheduler::requestStop()
 {
     m_stopRequested.store(true, std::memory_order_release);
     m_checkpointPending.store(true, std::memory_order_release);
-    m_eventCv.notify_all();
+    wakeExecutor();
 }
 
 void EeScheduler::postEvent(EeEvent event)
@@ -344,12 +572,76 @@ void EeScheduler::postEvent(EeEvent event)
         return;
     }
 
+    // Once anything has spilled, keep spilling until the executor drains the
+    // overflow list so events from one producer stay in order.
+    if (m_overflowEventCount.load(std::memory_order_acquire) != 0u ||
+        !m_eventRing.tryPush(event))
     {
         std::lock_guard lock(m_eventMutex);
-        m_events.push_back(event);
-        m_checkpointPending.store(true, std::memory_order_release);
+        m_overflowEvents.push_back(event);
+        m_overflowEventCount.store(static_cast<uint32_t>(m_overflowEvents.size()), std::memory_order_release);
     }
-    m_eventCv.notify_one();
+
+    // Pairs with the fence in processPendingEvents: either the executor sees
+    // this event when it re-checks, or this store lands after its clear.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_checkpointPending.store(true, std::memory_order_release);
+    wakeExecutor();
+}
+
+void EeScheduler::wakeExecutor()
+{
+    // Pairs with the fence after m_executorSleeping is raised. Only take the
+    // mutex when the executor may actually be parked on the condition variable.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_executorSleeping.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    {
+        std::lock_guard lock(m_eventMutex);
+    }
+    m_eventCv.notify_all();
+}
+
+bool EeScheduler::hasPostedEvents() const noexcept
+{
+    return !m_eventRing.empty() || m_overflowEventCount.load(std::memory_order_acquire) != 0u;
+}
+
+bool EeScheduler::drainPostedEvents()
+{
+    // Bound one pass so a producer that keeps posting cannot starve the guest.
+    bool drained = false;
+    EeEvent event{};
+    for (size_t i = 0; i < EeEventRing::kCapacity && m_eventRing.tryPop(event); ++i)
+    {
+        processEvent(event);
+        drained = true;
+    }
+
+    if (m_overflowEventCount.load(std::memory_order_acquire) != 0u)
+    {
+        std::deque<EeEvent> spilled;
+        {
+            std::lock_guard lock(m_eventMutex);
+            // Anything still in the ring was posted before the spill started,
+            // so it goes ahead of the overflow list.
+            while (m_eventRing.tryPop(event))
+            {
+                spilled.push_back(event);
+            }
+            spilled.insert(spilled.end(), m_overflowEvents.begin(), m_overflowEvents.end());
+            m_overflowEvents.clear();
+            m_overflowEventCount.store(0u, std::memory_order_release);
+        }
+        for (const EeEvent &pending : spilled)
+        {
+            processEvent(pending);
+        }
+        drained = true;
+    }
+    return drained;
 }
 
 bool EeScheduler::checkpointDue(uint32_t cycles) noexcept
@@ -455,20 +747,20 @@ int EeScheduler::deleteThread(int id, uint32_t &ownedStack)
     {
         return KE_ILLEGAL_THID;
     }
-    auto it = m_threads.find(id);
-    if (it == m_threads.end())
+    GuestThread *target = m_threads.find(id);
+    if (!target)
     {
         return KE_UNKNOWN_THID;
     }
-    if (it->second.status != EeThreadStatus::Dormant)
+    if (target->status != EeThreadStatus::Dormant)
     {
         return KE_NOT_DORMANT;
     }
-    if (it->second.ownsStack)
+    if (target->ownsStack)
     {
-        ownedStack = it->second.stack;
+        ownedStack = target->stack;
     }
-    m_threads.erase(it);
+    m_threads.erase(id);
     publishSnapshot();
     return KE_OK;
 }
@@ -514,7 +806,7 @@ int EeScheduler::startThread(int id, uint32_t arg, const R5900Context &caller, b
     const uint32_t ownedStack = deleteThreadRecord && exiting->ownsStack ? exiting->stack : 0u;
     makeDormant(*exiting);
     m_currentThreadId = 0;
-    if (deleteThreadRecord && id != kMainThreadId)
+    if (deleteThreadRecord && id > kMainThreadId)
     {
         m_threads.erase(id);
     }
@@ -722,16 +1014,11 @@ int EeScheduler::changePriority(int id, int priority, bool interruptSafe, int &o
     else
     {
         target->currentPriority = priority;
-        if (target->status == EeThreadStatus::Running)
+        if (target->status == EeThreadStatus::Running &&
+            target->currentPriority > 0 &&
+            hasReadyAtOrAbovePriority(target->currentPriority - 1))
         {
-            for (int p = 0; p < target->currentPriority; ++p)
-            {
-                if (!m_readyQueues[p].empty())
-                {
-                    m_rescheduleRequested = true;
-                    break;
-                }
-            }
+            m_rescheduleRequested = true;
         }
     }
     publishSnapshot();
@@ -760,12 +1047,13 @@ int EeScheduler::rotateReadyQueue(int priority, bool interruptSafe)
     }
     else
     {
-        auto &queue = m_readyQueues[priority];
-        if (queue.size() > 1u)
+        const ReadyQueue &queue = m_readyQueues[priority];
+        if (queue.head != queue.tail)
         {
-            const int head = queue.front();
-            queue.pop_front();
-            queue.push_back(head);
+            GuestThread *head = thread(queue.head);
+            assert(head != nullptr);
+            removeReady(*head);
+            enqueueReady(*head);
         }
     }
     (void)interruptSafe;
@@ -822,7 +1110,7 @@ int EeScheduler::createSemaphore(int initCount, int maxCount, uint32_t attr, uin
     {
         return KE_ERROR;
     }
-    const int id = allocatePositiveId(m_nextSemaphoreId, m_semaphores);
+    const int id = m_semaphores.nextFreeId();
     if (id == 0)
     {
         return KE_ERROR;
@@ -842,19 +1130,19 @@ int EeScheduler::createSemaphore(int initCount, int maxCount, uint32_t attr, uin
 int EeScheduler::deleteSemaphore(int id, bool interruptSafe)
 {
     assertExecutor();
-    auto it = m_semaphores.find(id);
-    if (it == m_semaphores.end())
+    EeSemaphore *object = m_semaphores.find(id);
+    if (!object)
     {
         return KE_UNKNOWN_SEMID;
     }
-    std::deque<int> waiters = std::move(it->second.waiters);
-    m_semaphores.erase(it);
-    for (const int threadId : waiters)
+    int next = object->waiters.head;
+    m_semaphores.erase(id);
+    while (GuestThread *waiter = thread(next))
     {
-        if (GuestThread *waiter = thread(threadId))
-        {
-            makeReady(*waiter, KE_WAIT_DELETE, interruptSafe);
-        }
+        next = waiter->waitNext;
+        waiter->waitPrev = 0;
+        waiter->waitNext = 0;
+        makeReady(*waiter, KE_WAIT_DELETE, interruptSafe);
     }
     publishSnapshot();
     return id;
@@ -870,10 +1158,9 @@ int EeScheduler::signalSemaphore(int id, bool interruptSafe)
     }
     if (!object->waiters.empty())
     {
-        const int waiterId = object->waiters.front();
-        object->waiters.pop_front();
-        GuestThread *waiter = thread(waiterId);
+        GuestThread *waiter = thread(object->waiters.head);
         assert(waiter != nullptr);
+        removeWaiter(object->waiters, *waiter);
         makeReady(*waiter, id, interruptSafe);
         publishSnapshot();
         return id;
@@ -926,14 +1213,14 @@ void EeScheduler::waitSemaphore(int id)
     }
     GuestThread *self = currentThread();
     assert(self != nullptr);
-    object->waiters.push_back(self->id);
+    enqueueWaiter(object->waiters, *self);
     blockCurrent(EeWaitState{EeWaitReason::Semaphore, EeSemaphoreWait{id}});
 }
 
 int EeScheduler::createEventFlag(uint32_t initialBits, uint32_t attr, uint32_t option)
 {
     assertExecutor();
-    const int id = allocatePositiveId(m_nextEventFlagId, m_eventFlags);
+    const int id = m_eventFlags.nextFreeId();
     if (id == 0)
     {
         return KE_ERROR;
@@ -952,19 +1239,19 @@ int EeScheduler::createEventFlag(uint32_t initialBits, uint32_t attr, uint32_t o
 int EeScheduler::deleteEventFlag(int id, bool interruptSafe)
 {
     assertExecutor();
-    auto it = m_eventFlags.find(id);
-    if (it == m_eventFlags.end())
+    EeEventFlag *flag = m_eventFlags.find(id);
+    if (!flag)
     {
         return KE_UNKNOWN_EVFID;
     }
-    std::deque<int> waiters = std::move(it->second.waiters);
-    m_eventFlags.erase(it);
-    for (const int threadId : waiters)
+    int next = flag->waiters.head;
+    m_eventFlags.erase(id);
+    while (GuestThread *waiter = thread(next))
     {
-        if (GuestThread *waiter = thread(threadId))
-        {
-            makeReady(*waiter, KE_WAIT_DELETE, interruptSafe);
-        }
+        next = waiter->waitNext;
+        waiter->waitPrev = 0;
+        waiter->waitNext = 0;
+        makeReady(*waiter, KE_WAIT_DELETE, interruptSafe);
     }
     publishSnapshot();
     return KE_OK;
@@ -1049,7 +1336,7 @@ void EeScheduler::waitEventFlag(int id, uint32_t bits, uint32_t mode, uint32_t r
         publishSnapshot();
         return;
     }
-    flag->waiters.push_back(self->id);
+    enqueueWaiter(flag->waiters, *self);
     blockCurrent(EeWaitState{EeWaitReason::EventFlag,
                              EeEventFlagWait{id, bits, mode, resultAddress}});
 }
@@ -1065,73 +1352,144 @@ int EeScheduler::setAlarm(uint16_t ticks,
     {
         return KE_ERROR;
     }
-    const int id = allocatePositiveId(m_nextAlarmId, m_alarms);
+    const int id = m_alarms.nextFreeId();
     if (id == 0)
     {
         return KE_ERROR;
     }
-    m_alarms.emplace(id, EeAlarm{id, ticks, handler, argument, gp, sp});
+    EeAlarm &alarm = m_alarms.emplace(id, EeAlarm{id, ticks, handler, argument, gp, sp});
     const uint64_t tickCount = ticks == 0u ? 1u : static_cast<uint64_t>(ticks);
-    scheduleEvent(m_eeCycle + tickCount * kAlarmTickCycles,
-                  std::chrono::steady_clock::now() + std::chrono::microseconds(tickCount * kAlarmTickMicroseconds),
-                  EeEvent{EeEventType::Alarm, static_cast<uint32_t>(id), 0});
+    alarm.deadline = scheduleEvent(m_eeCycle + tickCount * kAlarmTickCycles,
+                                   std::chrono::steady_clock::now() + std::chrono::microseconds(tickCount * kAlarmTickMicroseconds),
+                                   EeEvent{EeEventType::Alarm, static_cast<uint32_t>(id), 0});
     return id;
 }
 
 int EeScheduler::cancelAlarm(int id)
 {
     assertExecutor();
-    if (m_alarms.erase(id) == 0u)
+    const EeAlarm *alarm = m_alarms.find(id);
+    if (!alarm)
     {
         return KE_ERROR;
     }
     {
         std::lock_guard lock(m_eventMutex);
-        std::erase_if(m_deadlines, [id](const ScheduledEvent &scheduled)
-                      { return scheduled.event.type == EeEventType::Alarm &&
-                               scheduled.event.id == static_cast<uint32_t>(id); });
+        m_deadlines.erase(alarm->deadline);
         updateNextDeadline();
     }
+    m_alarms.erase(id);
     return KE_OK;
 }
 
-void EeScheduler::queueInvocation(GuestInvocation invocation)
+void EeScheduler::queueInvocation(GuestInvocationFrame frame)
 {
     assertExecutor();
-    invocation.sequence = ++m_invocationSequence;
-    m_pendingInvocations.push_back(std::move(invocation));
+    frame->sequence = ++m_invocationSequence;
+    m_pendingInvocations.push_back(std::move(frame));
     m_checkpointPending.store(true, std::memory_order_release);
 }
 
-[[noreturn]] void EeScheduler::invokeCurrent(GuestInvocation invocation)
+bool EeScheduler::hasPendingInvocations() const noexcept
+{
+    return m_pendingInvocationHead < m_pendingInvocations.size();
+}
+
+GuestInvocationFrame EeScheduler::popPendingInvocation()
+{
+    assert(hasPendingInvocations());
+    GuestInvocationFrame frame = std::move(m_pendingInvocations[m_pendingInvocationHead++]);
+    if (m_pendingInvocationHead == m_pendingInvocations.size())
+    {
+        m_pendingInvocations.clear();
+        m_pendingInvocationHead = 0u;
+    }
+    return frame;
+}
+
+GuestInvocationFrame EeScheduler::takePooledInvocationFrame()
+{
+    if (m_invocationPool.empty())
+    {
+        return nullptr;
+    }
+    GuestInvocationFrame frame = std::move(m_invocationPool.back());
+    m_invocationPool.pop_back();
+    return frame;
+}
+
+GuestInvocationFrame EeScheduler::acquireInvocationFrame(GuestInvocationKind kind)
+{
+    GuestInvocationFrame frame = takePooledInvocationFrame();
+    if (!frame)
+    {
+        frame = std::make_unique<GuestInvocation>();
+    }
+    else
+    {
+        std::destroy_at(&frame->context);
+        std::construct_at(&frame->context);
+    }
+    frame->kind = kind;
+    return frame;
+}
+
+GuestInvocationFrame EeScheduler::acquireInvocationFrame(GuestInvocationKind kind, const R5900Context &inherited)
+{
+    GuestInvocationFrame frame = takePooledInvocationFrame();
+    if (!frame)
+    {
+        frame = std::make_unique<GuestInvocation>();
+    }
+    frame->kind = kind;
+    frame->context = inherited;
+    return frame;
+}
+
+void EeScheduler::releaseInvocationFrame(GuestInvocationFrame frame)
+{
+    // Keep enough frames around for a busy VBlank without holding on to a
+    // burst indefinitely.
+    constexpr size_t kMaxPooledInvocationFrames = 32u;
+    frame->onComplete = nullptr;
+    frame->sequence = 0u;
+    frame->tag = 0u;
+    if (m_invocationPool.size() < kMaxPooledInvocationFrames)
+    {
+        m_invocationPool.push_back(std::move(frame));
+    }
+}
+
+[[noreturn]] void EeScheduler::invokeCurrent(GuestInvocationFrame frame)
 {
     assertExecutor();
     GuestThread *owner = currentThread();
     assert(owner != nullptr);
-    if (getRegU32(&invocation.context, 29) == 0u)
+    if (getRegU32(&frame->context, 29) == 0u)
     {
-        SET_GPR_U32(&invocation.context, 29, invocationStackTop());
+        SET_GPR_U32(&frame->context, 29, invocationStackTop());
     }
-    invocation.sequence = ++m_invocationSequence;
-    owner->invocations.push_back(std::move(invocation));
+    frame->sequence = ++m_invocationSequence;
+    owner->invocations.push_back(std::move(frame));
     publishSnapshot();
     throw EeDispatcherTransfer{};
 }
 
-[[noreturn]] void EeScheduler::invokeCurrentSequence(std::vector<GuestInvocation> invocations)
+[[noreturn]] void EeScheduler::invokeCurrentSequence(std::vector<GuestInvocationFrame> frames)
 {
     assertExecutor();
     GuestThread *owner = currentThread();
     assert(owner != nullptr);
-    assert(!invocations.empty());
-    for (auto it = invocations.rbegin(); it != invocations.rend(); ++it)
+    assert(!frames.empty());
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it)
     {
-        if (getRegU32(&it->context, 29) == 0u)
+        GuestInvocationFrame &frame = *it;
+        if (getRegU32(&frame->context, 29) == 0u)
         {
-            SET_GPR_U32(&it->context, 29, invocationStackTop());
+            SET_GPR_U32(&frame->context, 29, invocationStackTop());
         }
-        it->sequence = ++m_invocationSequence;
-        owner->invocations.push_back(std::move(*it));
+        frame->sequence = ++m_invocationSequence;
+        owner->invocations.push_back(std::move(frame));
     }
     publishSnapshot();
     throw EeDispatcherTransfer{};
@@ -1145,9 +1503,9 @@ bool EeScheduler::hasInvocation(GuestInvocationKind kind, uint64_t tag) const
         return false;
     }
     return std::any_of(owner->invocations.begin(), owner->invocations.end(),
-                       [kind, tag](const GuestInvocation &invocation)
+                       [kind, tag](const GuestInvocationFrame &invocation)
                        {
-                           return invocation.kind == kind && invocation.tag == tag;
+                           return invocation->kind == kind && invocation->tag == tag;
                        });
 }
 
@@ -1187,23 +1545,52 @@ int EeScheduler::addIrqHandler(bool dmac,
 {
     assertExecutor();
     auto &handlers = dmac ? m_dmacHandlers : m_intcHandlers;
-    int &nextId = dmac ? m_nextDmacHandlerId : m_nextIntcHandlerId;
-    const int id = allocatePositiveId(nextId, handlers);
+    const int id = handlers.nextFreeId();
     if (id == 0)
     {
         return KE_ERROR;
     }
     int &head = dmac ? m_dmacHeadOrder : m_intcHeadOrder;
     int &tail = dmac ? m_dmacTailOrder : m_intcTailOrder;
-    handlers.emplace(id,
-                     EeIrqHandler{id,
-                                  cause,
-                                  handler,
-                                  argument,
-                                  gp,
-                                  sp,
-                                  true,
-                                  append ? ++tail : --head});
+    EeIrqHandler &entry = handlers.emplace(id,
+                                           EeIrqHandler{id,
+                                                        cause,
+                                                        handler,
+                                                        argument,
+                                                        gp,
+                                                        sp,
+                                                        true,
+                                                        append ? ++tail : --head});
+
+    // Appends always carry the largest order and prepends the smallest, so
+    // linking at the matching end keeps each cause list sorted.
+    IrqCauseList &list = (dmac ? m_dmacCauseLists : m_intcCauseLists)[irqCauseList(cause)];
+    if (append)
+    {
+        entry.prev = list.tail;
+        if (EeIrqHandler *last = handlers.find(list.tail))
+        {
+            last->next = id;
+        }
+        else
+        {
+            list.head = id;
+        }
+        list.tail = id;
+    }
+    else
+    {
+        entry.next = list.head;
+        if (EeIrqHandler *first = handlers.find(list.head))
+        {
+            first->prev = id;
+        }
+        else
+        {
+            list.tail = id;
+        }
+        list.head = id;
+    }
     return id;
 }
 
@@ -1211,11 +1598,29 @@ int EeScheduler::removeIrqHandler(bool dmac, uint32_t cause, int id)
 {
     assertExecutor();
     auto &handlers = dmac ? m_dmacHandlers : m_intcHandlers;
-    auto it = handlers.find(id);
-    if (it != handlers.end() && it->second.cause == cause)
+    EeIrqHandler *entry = handlers.find(id);
+    if (!entry || entry->cause != cause)
     {
-        handlers.erase(it);
+        return KE_OK;
     }
+    IrqCauseList &list = (dmac ? m_dmacCauseLists : m_intcCauseLists)[irqCauseList(cause)];
+    if (EeIrqHandler *previous = handlers.find(entry->prev))
+    {
+        previous->next = entry->next;
+    }
+    else
+    {
+        list.head = entry->next;
+    }
+    if (EeIrqHandler *following = handlers.find(entry->next))
+    {
+        following->prev = entry->prev;
+    }
+    else
+    {
+        list.tail = entry->prev;
+    }
+    handlers.erase(id);
     return KE_OK;
 }
 
@@ -1223,10 +1628,9 @@ int EeScheduler::setIrqHandlerEnabled(bool dmac, int id, bool enabled)
 {
     assertExecutor();
     auto &handlers = dmac ? m_dmacHandlers : m_intcHandlers;
-    auto it = handlers.find(id);
-    if (it != handlers.end())
+    if (EeIrqHandler *entry = handlers.find(id))
     {
-        it->second.enabled = enabled;
+        entry->enabled = enabled;
     }
     return KE_OK;
 }
@@ -1258,28 +1662,22 @@ void EeScheduler::dispatchIrq(bool dmac, uint32_t cause)
         return;
     }
     const auto &handlers = dmac ? m_dmacHandlers : m_intcHandlers;
-    std::vector<EeIrqHandler> matching;
-    for (const auto &[id, handler] : handlers)
+    const IrqCauseList &list = (dmac ? m_dmacCauseLists : m_intcCauseLists)[irqCauseList(cause)];
+    // queueInvocation only records the call, so the list cannot change under us.
+    for (const EeIrqHandler *handler = handlers.find(list.head); handler; handler = handlers.find(handler->next))
     {
-        (void)id;
-        if (handler.enabled && handler.cause == cause && handler.handler != 0u &&
-            m_runtime.hasFunction(handler.handler))
+        if (!handler->enabled || handler->cause != cause || handler->handler == 0u ||
+            !m_runtime.hasFunction(handler->handler))
         {
-            matching.push_back(handler);
+            continue;
         }
-    }
-    std::sort(matching.begin(), matching.end(), [](const EeIrqHandler &left, const EeIrqHandler &right)
-              { return left.order < right.order; });
-    for (const EeIrqHandler &handler : matching)
-    {
-        GuestInvocation invocation{};
-        invocation.kind = GuestInvocationKind::Interrupt;
-        invocation.context.pc = handler.handler;
-        SET_GPR_U32(&invocation.context, 4, cause);
-        SET_GPR_U32(&invocation.context, 5, handler.argument);
-        SET_GPR_U32(&invocation.context, 28, handler.gp);
-        SET_GPR_U32(&invocation.context, 29, handler.sp);
-        SET_GPR_U32(&invocation.context, 31, 0u);
+        GuestInvocationFrame invocation = acquireInvocationFrame(GuestInvocationKind::Interrupt);
+        invocation->context.pc = handler->handler;
+        SET_GPR_U32(&invocation->context, 4, cause);
+        SET_GPR_U32(&invocation->context, 5, handler->argument);
+        SET_GPR_U32(&invocation->context, 28, handler->gp);
+        SET_GPR_U32(&invocation->context, 29, handler->sp);
+        SET_GPR_U32(&invocation->context, 31, 0u);
         queueInvocation(std::move(invocation));
     }
 }
@@ -1328,16 +1726,16 @@ uint32_t EeScheduler::setGsVSyncCallback(uint32_t callback, uint32_t gp, uint32_
 void EeScheduler::completeVSync(uint64_t tick)
 {
     assertExecutor();
-    std::vector<int> completed;
-    for (const auto &[id, candidate] : m_threads)
-    {
-        if ((candidate.status == EeThreadStatus::Waiting || candidate.status == EeThreadStatus::WaitingSuspended) &&
-            candidate.wait.reason == EeWaitReason::VSync &&
-            std::get<EeVSyncWait>(candidate.wait.payload).afterTick < tick)
-        {
-            completed.push_back(id);
-        }
-    }
+    std::vector<int> &completed = m_wakeScratch;
+    completed.clear();
+    forEachThread([&completed, tick](const GuestThread &candidate)
+                  {
+                      if ((candidate.status == EeThreadStatus::Waiting || candidate.status == EeThreadStatus::WaitingSuspended) &&
+                          candidate.wait.reason == EeWaitReason::VSync &&
+                          std::get<EeVSyncWait>(candidate.wait.payload).afterTick < tick)
+                      {
+                          completed.push_back(candidate.id);
+                      } });
     std::sort(completed.begin(), completed.end());
     for (const int id : completed)
     {
@@ -1355,21 +1753,21 @@ void EeScheduler::completeVSync(uint64_t tick)
 void EeScheduler::completeExternalWait(uint32_t type, uint64_t token, int result)
 {
     assertExecutor();
-    std::vector<int> completed;
-    for (const auto &[id, candidate] : m_threads)
-    {
-        if ((candidate.status != EeThreadStatus::Waiting && candidate.status != EeThreadStatus::WaitingSuspended) ||
-            (candidate.wait.reason != EeWaitReason::External &&
-             candidate.wait.reason != EeWaitReason::Mpeg))
-        {
-            continue;
-        }
-        const auto &external = std::get<EeExternalWait>(candidate.wait.payload);
-        if (external.type == type && external.token == token)
-        {
-            completed.push_back(id);
-        }
-    }
+    std::vector<int> &completed = m_wakeScratch;
+    completed.clear();
+    forEachThread([&completed, type, token](const GuestThread &candidate)
+                  {
+                      if ((candidate.status != EeThreadStatus::Waiting && candidate.status != EeThreadStatus::WaitingSuspended) ||
+                          (candidate.wait.reason != EeWaitReason::External &&
+                           candidate.wait.reason != EeWaitReason::Mpeg))
+                      {
+                          return;
+                      }
+                      const auto &external = std::get<EeExternalWait>(candidate.wait.payload);
+                      if (external.type == type && external.token == token)
+                      {
+                          completed.push_back(candidate.id);
+                      } });
     std::sort(completed.begin(), completed.end());
     for (const int id : completed)
     {
@@ -1391,38 +1789,42 @@ void EeScheduler::completeExternalWait(uint32_t type, uint64_t token, int result
 
 GuestThread *EeScheduler::thread(int id)
 {
-    auto it = m_threads.find(id);
-    return it == m_threads.end() ? nullptr : &it->second;
+    if (id < 0)
+    {
+        const size_t index = static_cast<size_t>(-(id + 1));
+        return index < m_invocationThreads.size() ? &m_invocationThreads[index] : nullptr;
+    }
+    return m_threads.find(id);
 }
 
 const GuestThread *EeScheduler::thread(int id) const
 {
-    auto it = m_threads.find(id);
-    return it == m_threads.end() ? nullptr : &it->second;
+    if (id < 0)
+    {
+        const size_t index = static_cast<size_t>(-(id + 1));
+        return index < m_invocationThreads.size() ? &m_invocationThreads[index] : nullptr;
+    }
+    return m_threads.find(id);
 }
 
 EeSemaphore *EeScheduler::semaphore(int id)
 {
-    auto it = m_semaphores.find(id);
-    return it == m_semaphores.end() ? nullptr : &it->second;
+    return m_semaphores.find(id);
 }
 
 const EeSemaphore *EeScheduler::semaphore(int id) const
 {
-    auto it = m_semaphores.find(id);
-    return it == m_semaphores.end() ? nullptr : &it->second;
+    return m_semaphores.find(id);
 }
 
 EeEventFlag *EeScheduler::eventFlag(int id)
 {
-    auto it = m_eventFlags.find(id);
-    return it == m_eventFlags.end() ? nullptr : &it->second;
+    return m_eventFlags.find(id);
 }
 
 const EeEventFlag *EeScheduler::eventFlag(int id) const
 {
-    auto it = m_eventFlags.find(id);
-    return it == m_eventFlags.end() ? nullptr : &it->second;
+    return m_eventFlags.find(id);
 }
 
 GuestThread *EeScheduler::currentThread()
@@ -1488,51 +1890,36 @@ void EeScheduler::publishSnapshot()
     next.nextEventCycle = m_nextDeadlineCycle.load(std::memory_order_acquire);
     next.runningThreadId = m_currentThreadId;
     next.threads.reserve(m_threads.size());
-    for (const auto &[id, item] : m_threads)
-    {
-        if (id < 0)
-        {
-            continue;
-        }
-        EeThreadSnapshot snapshot{};
-        snapshot.id = id;
-        snapshot.pc = item.activeContext().pc;
-        snapshot.entry = item.entry;
-        snapshot.stack = item.stack;
-        snapshot.stackSize = item.stackSize;
-        snapshot.gp = item.gp;
-        snapshot.initialPriority = item.initialPriority;
-        snapshot.currentPriority = item.currentPriority;
-        snapshot.status = item.status;
-        snapshot.waitReason = item.wait.reason;
-        snapshot.waitId = waitObjectId(item.wait);
-        snapshot.suspendCount = item.suspendCount;
-        snapshot.wakeupCount = item.wakeupCount;
-        next.threads.push_back(snapshot);
-    }
-    std::sort(next.threads.begin(), next.threads.end(), [](const auto &left, const auto &right)
-              { return left.id < right.id; });
+    m_threads.forEach([&next](const GuestThread &item)
+                      {
+                          EeThreadSnapshot snapshot{};
+                          snapshot.id = item.id;
+                          snapshot.pc = item.activeContext().pc;
+                          snapshot.entry = item.entry;
+                          snapshot.stack = item.stack;
+                          snapshot.stackSize = item.stackSize;
+                          snapshot.gp = item.gp;
+                          snapshot.initialPriority = item.initialPriority;
+                          snapshot.currentPriority = item.currentPriority;
+                          snapshot.status = item.status;
+                          snapshot.waitReason = item.wait.reason;
+                          snapshot.waitId = waitObjectId(item.wait);
+                          snapshot.suspendCount = item.suspendCount;
+                          snapshot.wakeupCount = item.wakeupCount;
+                          next.threads.push_back(snapshot); });
     next.semaphores.reserve(m_semaphores.size());
-    for (const auto &[id, item] : m_semaphores)
-    {
-        next.semaphores.push_back(EeSemaphoreSnapshot{id,
-                                                      item.count,
-                                                      item.maxCount,
-                                                      static_cast<uint32_t>(item.waiters.size())});
-    }
-    std::sort(next.semaphores.begin(), next.semaphores.end(), [](const auto &left, const auto &right)
-              { return left.id < right.id; });
+    m_semaphores.forEach([&next](const EeSemaphore &item)
+                         { next.semaphores.push_back(EeSemaphoreSnapshot{item.id,
+                                                                         item.count,
+                                                                         item.maxCount,
+                                                                         static_cast<uint32_t>(item.waiters.size())}); });
     next.eventFlags.reserve(m_eventFlags.size());
-    for (const auto &[id, item] : m_eventFlags)
-    {
-        next.eventFlags.push_back(EeEventFlagSnapshot{id,
-                                                      item.bits,
-                                                      item.initBits,
-                                                      item.attr,
-                                                      static_cast<uint32_t>(item.waiters.size())});
-    }
-    std::sort(next.eventFlags.begin(), next.eventFlags.end(), [](const auto &left, const auto &right)
-              { return left.id < right.id; });
+    m_eventFlags.forEach([&next](const EeEventFlag &item)
+                         { next.eventFlags.push_back(EeEventFlagSnapshot{item.id,
+                                                                         item.bits,
+                                                                         item.initBits,
+                                                                         item.attr,
+                                                                         static_cast<uint32_t>(item.waiters.size())}); });
     {
         std::lock_guard lock(m_snapshotMutex);
         m_snapshot = std::move(next);
@@ -1546,79 +1933,156 @@ void EeScheduler::assertExecutor() const
 
 int EeScheduler::allocateThreadId()
 {
-    for (int attempts = 0; attempts <= kLastThreadId - kFirstThreadId; ++attempts)
-    {
-        const int candidate = m_nextThreadId;
-        m_nextThreadId = candidate == kLastThreadId ? kFirstThreadId : candidate + 1;
-        if (!m_threads.contains(candidate))
-        {
-            return candidate;
-        }
-    }
-    return 0;
+    // The main thread always holds ID 1, so the table hands out 2..255.
+    return m_threads.nextFreeId();
 }
 
 GuestThread &EeScheduler::acquireInvocationThread()
 {
-    for (auto &[id, candidate] : m_threads)
+    for (GuestThread &candidate : m_invocationThreads)
     {
-        if (id < 0 && candidate.status == EeThreadStatus::Dormant && candidate.invocations.empty())
+        if (candidate.status == EeThreadStatus::Dormant && candidate.invocations.empty())
         {
             return candidate;
         }
     }
 
-    GuestThread dispatcher{};
-    dispatcher.id = m_nextInvocationThreadId--;
+    GuestThread &dispatcher = m_invocationThreads.emplace_back();
+    dispatcher.id = -static_cast<int>(m_invocationThreads.size());
     dispatcher.initialPriority = 0;
     dispatcher.currentPriority = 0;
     dispatcher.status = EeThreadStatus::Dormant;
-    return m_threads.emplace(dispatcher.id, std::move(dispatcher)).first->second;
+    return dispatcher;
+}
+
+void EeScheduler::enqueueWaiter(EeWaitQueue &queue, GuestThread &item)
+{
+    item.waitPrev = queue.tail;
+    item.waitNext = 0;
+    if (queue.tail != 0)
+    {
+        thread(queue.tail)->waitNext = item.id;
+    }
+    else
+    {
+        queue.head = item.id;
+    }
+    queue.tail = item.id;
+    ++queue.count;
+}
+
+void EeScheduler::removeWaiter(EeWaitQueue &queue, GuestThread &item)
+{
+    if (queue.head != item.id && item.waitPrev == 0)
+    {
+        return;
+    }
+    if (item.waitPrev != 0)
+    {
+        thread(item.waitPrev)->waitNext = item.waitNext;
+    }
+    else
+    {
+        queue.head = item.waitNext;
+    }
+    if (item.waitNext != 0)
+    {
+        thread(item.waitNext)->waitPrev = item.waitPrev;
+    }
+    else
+    {
+        queue.tail = item.waitPrev;
+    }
+    item.waitPrev = 0;
+    item.waitNext = 0;
+    --queue.count;
 }
 
 void EeScheduler::enqueueReady(GuestThread &item, bool front)
 {
     assert(item.currentPriority >= 0 && item.currentPriority < kPriorityCount);
+    assert(!item.readyQueued);
     item.status = EeThreadStatus::Ready;
-    auto &queue = m_readyQueues[item.currentPriority];
-    if (front)
-    {
-        queue.push_front(item.id);
+    const int priority = item.currentPriority;
+    ReadyQueue &queue = m_readyQueues[static_cast<size_t>(priority)];
+    item.readyQueued = true;
+    if (queue.head == 0)
+    {
+        item.readyPrev = 0;
+        item.readyNext = 0;
+        queue.head = item.id;
+        queue.tail = item.id;
+        const size_t word = static_cast<size_t>(priority) / 64u;
+        m_readyBitmap[word] |= 1ull << (priority % 64);
+        m_readySummary |= 1u << word;
+    }
+    else if (front)
+    {
+        item.readyPrev = 0;
+        item.readyNext = queue.head;
+        thread(queue.head)->readyPrev = item.id;
+        queue.head = item.id;
     }
     else
     {
-        queue.push_back(item.id);
+        item.readyPrev = queue.tail;
+        item.readyNext = 0;
+        thread(queue.tail)->readyNext = item.id;
+        queue.tail = item.id;
     }
 }
 
 void EeScheduler::removeReady(GuestThread &item)
 {
-    if (item.status != EeThreadStatus::Ready)
+    if (!item.readyQueued)
     {
         return;
     }
-    auto &queue = m_readyQueues[item.currentPriority];
-    auto it = std::find(queue.begin(), queue.end(), item.id);
-    assert(it != queue.end());
-    queue.erase(it);
+    const int priority = item.currentPriority;
+    ReadyQueue &queue = m_readyQueues[static_cast<size_t>(priority)];
+    if (item.readyPrev != 0)
+    {
+        thread(item.readyPrev)->readyNext = item.readyNext;
+    }
+    else
+    {
+        queue.head = item.readyNext;
+    }
+    if (item.readyNext != 0)
+    {
+        thread(item.readyNext)->readyPrev = item.readyPrev;
+    }
+    else
+    {
+        queue.tail = item.readyPrev;
+    }
+    item.readyPrev = 0;
+    item.readyNext = 0;
+    item.readyQueued = false;
+
+    if (queue.head == 0)
+    {
+        const size_t word = static_cast<size_t>(priority) / 64u;
+        m_readyBitmap[word] &= ~(1ull << (priority % 64));
+        if (m_readyBitmap[word] == 0u)
+        {
+            m_readySummary &= ~(1u << word);
+        }
+    }
 }
 
 GuestThread *EeScheduler::selectReady()
 {
-    for (auto &queue : m_readyQueues)
+    const int priority = highestReadyPriority();
+    if (priority < 0)
     {
-        if (queue.empty())
-        {
-            continue;
-        }
-        const int id = queue.front();
-        queue.pop_front();
-        GuestThread *selected = thread(id);
-        assert(selected != nullptr);
-        assert(selected->status == EeThreadStatus::Ready);
-        return selected;
+        return nullptr;
     }
-    return nullptr;
+    GuestThread *selected = thread(m_readyQueues[static_cast<size_t>(priority)].head);
+    assert(selected != nullptr);
+    assert(selected->status == EeThreadStatus::Ready);
+    removeReady(*selected);
+    return selected;
 }
 
 void EeScheduler::makeRunning(GuestThread &item)
@@ -1639,22 +2103,21 @@ void EeScheduler::makeDormant(GuestThread &item)
     item.resumeCompletion = {};
     item.suspendCount = 0;
     item.wakeupCount = 0;
-    item.invocations.clear();
+    while (!item.invocations.empty())
+    {
+        releaseInvocationFrame(std::move(item.invocations.back()));
+        item.invocations.pop_back();
+    }
 }
 
 void EeScheduler::removeFromWaitObject(GuestThread &item)
 {
-    const int id = item.id;
     if (item.wait.reason == EeWaitReason::Semaphore)
     {
         const int objectId = std::get<EeSemaphoreWait>(item.wait.payload).id;
         if (EeSemaphore *object = semaphore(objectId))
         {
-            auto it = std::find(object->waiters.begin(), object->waiters.end(), id);
-            if (it != object->waiters.end())
-            {
-                object->waiters.erase(it);
-            }
+            removeWaiter(object->waiters, item);
         }
     }
     else if (item.wait.reason == EeWaitReason::EventFlag)
@@ -1662,11 +2125,7 @@ void EeScheduler::removeFromWaitObject(GuestThread &item)
         const int objectId = std::get<EeEventFlagWait>(item.wait.payload).id;
         if (EeEventFlag *object = eventFlag(objectId))
         {
-            auto it = std::find(object->waiters.begin(), object->waiters.end(), id);
-            if (it != object->waiters.end())
-            {
-                object->waiters.erase(it);
-            }
+            removeWaiter(object->waiters, item);
         }
     }
     item.wait = {};
@@ -1745,44 +2204,50 @@ void EeScheduler::processPendingEvents()
             dispatchIrq(false, 9u + timer);
         }
     }
-    std::deque<EeEvent> pending;
-    {
-        std::lock_guard lock(m_eventMutex);
-        pending.swap(m_events);
-    }
-    for (const EeEvent &event : pending)
+    drainPostedEvents();
+
+    const uint64_t nextEventCycle = m_nextDeadlineCycle.load(std::memory_order_acquire);
+    const bool cycleEventDue = nextEventCycle != 0u && m_eeCycle >= nextEventCycle;
+    if (cycleEventDue || m_stopRequested.load(std::memory_order_acquire))
     {
-        processEvent(event);
+        m_checkpointPending.store(true, std::memory_order_release);
     }
-
+    else
     {
-        std::lock_guard lock(m_eventMutex);
-        const uint64_t nextEventCycle = m_nextDeadlineCycle.load(std::memory_order_acquire);
-        const bool cycleEventDue = nextEventCycle != 0u && m_eeCycle >= nextEventCycle;
-        const bool pendingWork = !m_events.empty() || cycleEventDue || m_stopRequested.load(std::memory_order_acquire);
-        m_checkpointPending.store(pendingWork, std::memory_order_release);
+        // Clear first, then re-check: a producer that raced with the drain
+        // either shows up here or re-raises the flag after this store.
+        m_checkpointPending.store(false, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (hasPostedEvents() || m_stopRequested.load(std::memory_order_relaxed))
+        {
+            m_checkpointPending.store(true, std::memory_order_release);
+        }
     }
     applyPendingPreemption();
 }
 
 void EeScheduler::processDueDeadlines()
 {
+    const uint64_t nextDeadline = m_nextDeadlineCycle.load(std::memory_order_acquire);
+    if (nextDeadline == 0u || nextDeadline > m_eeCycle)
+    {
+        return;
+    }
+
     for (;;)
     {
-        std::vector<ScheduledEvent> due;
+        m_dueDeadlines.clear();
         std::chrono::steady_clock::time_point pacingDeadline{};
         {
             std::unique_lock lock(m_eventMutex);
             const auto now = std::chrono::steady_clock::now();
-            for (const ScheduledEvent &item : m_deadlines)
-            {
-                if (item.deadlineCycle <= m_eeCycle &&
-                    (pacingDeadline == std::chrono::steady_clock::time_point{} ||
-                     item.hostDeadline < pacingDeadline))
-                {
-                    pacingDeadline = item.hostDeadline;
-                }
-            }
+            m_deadlines.forEachDue(m_eeCycle, [&pacingDeadline](const EeScheduledEvent &item)
+                                   {
+                                       if (pacingDeadline == std::chrono::steady_clock::time_point{} ||
+                                           item.hostDeadline < pacingDeadline)
+                                       {
+                                           pacingDeadline = item.hostDeadline;
+                                       } });
 
             if (pacingDeadline == std::chrono::steady_clock::time_point{})
             {
@@ -1792,50 +2257,30 @@ void EeScheduler::processDueDeadlines()
 
             if (now < pacingDeadline)
             {
+                m_executorSleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
                 m_eventCv.wait_until(lock, pacingDeadline, [this]()
-                                     { return !m_events.empty() ||
+                                     { return hasPostedEvents() ||
                                               m_stopRequested.load(std::memory_order_acquire); });
-                if (!m_events.empty() || m_stopRequested.load(std::memory_order_acquire))
+                m_executorSleeping.store(false, std::memory_order_relaxed);
+                if (hasPostedEvents() || m_stopRequested.load(std::memory_order_acquire))
                 {
                     updateNextDeadline();
                     return;
                 }
             }
 
-            const auto pacedNow = std::chrono::steady_clock::now();
-            auto firstFuture = std::partition(m_deadlines.begin(), m_deadlines.end(),
-                                              [this, pacedNow](const ScheduledEvent &item)
-                                              { return item.deadlineCycle <= m_eeCycle &&
-                                                       item.hostDeadline <= pacedNow; });
-            due.insert(due.end(),
-                       std::make_move_iterator(m_deadlines.begin()),
-                       std::make_move_iterator(firstFuture));
-            m_deadlines.erase(m_deadlines.begin(), firstFuture);
+            // The queue hands due events back already in processing order.
+            m_deadlines.takeDue(m_eeCycle, std::chrono::steady_clock::now(), m_dueDeadlines);
             updateNextDeadline();
         }
 
-        std::sort(due.begin(), due.end(), [](const ScheduledEvent &left, const ScheduledEvent &right)
-                  {
-                      if (left.deadlineCycle != right.deadlineCycle)
-                      {
-                          return left.deadlineCycle < right.deadlineCycle;
-                      }
-                      if (left.event.type != right.event.type)
-                      {
-                          return left.event.type < right.event.type;
-                      }
-                      if (left.event.id != right.event.id)
-                      {
-                          return left.event.id < right.event.id;
-                      }
-                      return left.sequence < right.sequence; });
-
-        if (due.empty())
+        if (m_dueDeadlines.empty())
         {
             return;
         }
 
-        for (ScheduledEvent &scheduled : due)
+        for (const EeScheduledEvent &scheduled : m_dueDeadlines)
         {
             if (scheduled.event.type == EeEventType::VBlankStart)
             {
@@ -1845,6 +2290,10 @@ void EeScheduler::processDueDeadlines()
                 scheduleEvent(scheduled.deadlineCycle + kVBlankPeriodCycles,
                               scheduled.hostDeadline + kVBlankPeriod,
                               EeEvent{EeEventType::VBlankStart, 0, 0});
+                // A whole field late means the guest cannot keep up with
+                // drawing every frame.
+                const bool behind = std::chrono::steady_clock::now() - scheduled.hostDeadline >= kVBlankPeriod;
+                m_runtime.gs().beginFrame(behind);
             }
             processEvent(scheduled.event);
         }
@@ -1883,13 +2332,12 @@ void EeScheduler::processEvent(const EeEvent &event)
         completeVSync(m_vsyncTick);
         if (m_gsVSyncCallback != 0u && m_runtime.hasFunction(m_gsVSyncCallback))
         {
-            GuestInvocation invocation{};
-            invocation.kind = GuestInvocationKind::GsCallback;
-            invocation.context.pc = m_gsVSyncCallback;
-            SET_GPR_U32(&invocation.context, 4, static_cast<uint32_t>(m_vsyncTick));
-            SET_GPR_U32(&invocation.context, 28, m_gsVSyncCallbackGp);
-            SET_GPR_U32(&invocation.context, 29, m_gsVSyncCallbackSp);
-            SET_GPR_U32(&invocation.context, 31, 0u);
+            GuestInvocationFrame invocation = acquireInvocationFrame(GuestInvocationKind::GsCallback);
+            invocation->context.pc = m_gsVSyncCallback;
+            SET_GPR_U32(&invocation->context, 4, static_cast<uint32_t>(m_vsyncTick));
+            SET_GPR_U32(&invocation->context, 28, m_gsVSyncCallbackGp);
+            SET_GPR_U32(&invocation->context, 29, m_gsVSyncCallbackSp);
+            SET_GPR_U32(&invocation->context, 31, 0u);
             queueInvocation(std::move(invocation));
         }
         dispatchIrq(false, 2u);
@@ -1904,22 +2352,21 @@ void EeScheduler::processEvent(const EeEvent &event)
         break;
     case EeEventType::Alarm:
     {
-        auto it = m_alarms.find(static_cast<int>(event.id));
-        if (it == m_alarms.end())
+        const EeAlarm *pending = m_alarms.find(static_cast<int>(event.id));
+        if (!pending)
         {
             break;
         }
-        const EeAlarm alarm = it->second;
-        m_alarms.erase(it);
-        GuestInvocation invocation{};
-        invocation.kind = GuestInvocationKind::Alarm;
-        invocation.context.pc = alarm.handler;
-        SET_GPR_U32(&invocation.context, 4, static_cast<uint32_t>(alarm.id));
-        SET_GPR_U32(&invocation.context, 5, static_cast<uint32_t>(alarm.ticks));
-        SET_GPR_U32(&invocation.context, 6, alarm.argument);
-        SET_GPR_U32(&invocation.context, 28, alarm.gp);
-        SET_GPR_U32(&invocation.context, 29, alarm.sp);
-        SET_GPR_U32(&invocation.context, 31, 0u);
+        const EeAlarm alarm = *pending;
+        m_alarms.erase(alarm.id);
+        GuestInvocationFrame invocation = acquireInvocationFrame(GuestInvocationKind::Alarm);
+        invocation->context.pc = alarm.handler;
+        SET_GPR_U32(&invocation->context, 4, static_cast<uint32_t>(alarm.id));
+        SET_GPR_U32(&invocation->context, 5, static_cast<uint32_t>(alarm.ticks));
+        SET_GPR_U32(&invocation->context, 6, alarm.argument);
+        SET_GPR_U32(&invocation->context, 28, alarm.gp);
+        SET_GPR_U32(&invocation->context, 29, alarm.sp);
+        SET_GPR_U32(&invocation->context, 31, 0u);
         queueInvocation(std::move(invocation));
         break;
     }
@@ -1928,14 +2375,13 @@ void EeScheduler::processEvent(const EeEvent &event)
 
 void EeScheduler::finishEventWaiters(EeEventFlag &flag, bool interruptSafe)
 {
-    for (auto it = flag.waiters.begin(); it != flag.waiters.end();)
+    int next = flag.waiters.head;
+    while (GuestThread *waiter = thread(next))
     {
-        GuestThread *waiter = thread(*it);
-        assert(waiter != nullptr);
+        next = waiter->waitNext;
         const EeEventFlagWait wait = std::get<EeEventFlagWait>(waiter->wait.payload);
         if (!eventCondition(flag.bits, wait.bits, wait.mode))
         {
-            ++it;
             continue;
         }
         const uint32_t observed = flag.bits;
@@ -1948,7 +2394,7 @@ void EeScheduler::finishEventWaiters(EeEventFlag &flag, bool interruptSafe)
         {
             flag.bits &= ~wait.bits;
         }
-        it = flag.waiters.erase(it);
+        removeWaiter(flag.waiters, *waiter);
         makeReady(*waiter, KE_OK, interruptSafe);
     }
 }
@@ -1988,8 +2434,20 @@ void EeScheduler::writeGuestU32(uint32_t address, uint32_t value)
 
 void EeScheduler::waitForEvent()
 {
+    if (hasPostedEvents() || m_stopRequested.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
     std::unique_lock lock(m_eventMutex);
-    if (!m_events.empty() || m_stopRequested.load(std::memory_order_acquire))
+    m_executorSleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    struct SleepingGuard
+    {
+        std::atomic<bool> &flag;
+        ~SleepingGuard() { flag.store(false, std::memory_order_relaxed); }
+    } sleepingGuard{m_executorSleeping};
+    if (hasPostedEvents() || m_stopRequested.load(std::memory_order_acquire))
     {
         return;
     }
@@ -1998,7 +2456,7 @@ void EeScheduler::waitForEvent()
     if (m_deadlines.empty() && !hasTimerDeadline)
     {
         m_eventCv.wait(lock, [this]()
-                       { return !m_events.empty() || m_stopRequested.load(std::memory_order_acquire); });
+                       { return hasPostedEvents() || m_stopRequested.load(std::memory_order_acquire); });
         return;
     }
 
@@ -2006,17 +2464,9 @@ void EeScheduler::waitForEvent()
     auto hostDeadline = std::chrono::steady_clock::time_point::max();
     if (!m_deadlines.empty())
     {
-        const auto next = std::min_element(m_deadlines.begin(), m_deadlines.end(),
-                                           [](const ScheduledEvent &left, const ScheduledEvent &right)
-                                           {
-                                               if (left.deadlineCycle != right.deadlineCycle)
-                                               {
-                                                   return left.deadlineCycle < right.deadlineCycle;
-                                               }
-                                               return left.sequence < right.sequence;
-                                           });
-        deadlineCycle = next->deadlineCycle;
-        hostDeadline = next->hostDeadline;
+        const EeScheduledEvent &next = m_deadlines.top();
+        deadlineCycle = next.deadlineCycle;
+        hostDeadline = next.hostDeadline;
     }
     if (hasTimerDeadline)
     {
@@ -2029,7 +2479,7 @@ void EeScheduler::waitForEvent()
     }
 
     const bool signaled = m_eventCv.wait_until(lock, hostDeadline, [this]()
-                                               { return !m_events.empty() ||
+                                               { return hasPostedEvents() ||
                                                         m_stopRequested.load(std::memory_order_acquire); });
     if (!signaled)
     {
@@ -2046,16 +2496,18 @@ void EeScheduler::waitForEvent()
     }
 }
 
-void EeScheduler::scheduleEvent(uint64_t deadlineCycle,
-                                std::chrono::steady_clock::time_point hostDeadline,
-                                EeEvent event)
+EeDeadlineQueue::Handle EeScheduler::scheduleEvent(uint64_t deadlineCycle,
+                                                   std::chrono::steady_clock::time_point hostDeadline,
+                                                   EeEvent event)
 {
+    EeDeadlineQueue::Handle handle = 0;
     {
         std::lock_guard lock(m_eventMutex);
-        m_deadlines.push_back(ScheduledEvent{deadlineCycle, hostDeadline, event, ++m_eventSequence});
+        handle = m_deadlines.push(EeScheduledEvent{deadlineCycle, hostDeadline, event, ++m_eventSequence});
         updateNextDeadline();
     }
     m_eventCv.notify_one();
+    return handle;
 }
 
 void EeScheduler::updateNextDeadline()
@@ -2065,29 +2517,23 @@ void EeScheduler::updateNextDeadline()
         m_nextDeadlineCycle.store(0u, std::memory_order_release);
         return;
     }
-    const auto it = std::min_element(m_deadlines.begin(), m_deadlines.end(),
-                                     [](const ScheduledEvent &left, const ScheduledEvent &right)
-                                     {
-                                         if (left.deadlineCycle != right.deadlineCycle)
-                                         {
-                                             return left.deadlineCycle < right.deadlineCycle;
-                                         }
-                                         return left.sequence < right.sequence;
-                                     });
-    m_nextDeadlineCycle.store(it->deadlineCycle, std::memory_order_release);
+    m_nextDeadlineCycle.store(m_deadlines.top().deadlineCycle, std::memory_order_release);
 }
 
 bool EeScheduler::hasReadyAtOrAbovePriority(int priority) const
 {
-    const int last = std::clamp(priority, 0, kPriorityCount - 1);
-    for (int p = 0; p <= last; ++p)
+    const int highest = highestReadyPriority();
+    return highest >= 0 && highest <= std::clamp(priority, 0, kPriorityCount - 1);
+}
+
+int EeScheduler::highestReadyPriority() const noexcept
+{
+    if (m_readySummary == 0u)
     {
-        if (!m_readyQueues[static_cast<size_t>(p)].empty())
-        {
-            return true;
-        }
+        return -1;
     }
-    return false;
+    const int word = std::countr_zero(m_readySummary);
+    return word * 64 + std::countr_zero(m_readyBitmap[static_cast<size_t>(word)]);
 }
 
 void EeScheduler::renewTimeSlice()
@@ -6,6 +6,9 @@ namespace ps2_stubs
     namespace
     {
         constexpr uint32_t kLibSdCmdSetParam = 0x8010u;
+        constexpr uint32_t kLibSdCmdGetParam = 0x8020u;
+        constexpr uint32_t kLibSdCmdSetSwitch = 0x8030u;
+        constexpr uint32_t kLibSdCmdSetAddr = 0x8050u;
         constexpr uint32_t kLibSdCmdVoiceTrans = 0x80D0u;
         constexpr uint32_t kLibSdCmdBlockTrans = 0x80E0u;
         constexpr uint32_t kLibSdCmdVoiceTransStatus = 0x80F0u;
@@ -17,6 +20,13 @@ namespace ps2_stubs
         constexpr uint32_t kLibSdTransDirectionMask = 0x03u;
         constexpr uint32_t kLibSdTransStop = 0x02u;
         constexpr uint32_t kLibSdTransLoop = 0x10u;
+        constexpr uint32_t kLibSdTransWrite = 0x00u;
+        // Register selectors carried in the libsd entry word.
+        constexpr uint32_t kLibSdVoiceParamLast = 0x05u; // SD_VP_ENVX
+        constexpr uint32_t kLibSdSwitchKeyOn = 0x15u;    // SD_S_KON
+        constexpr uint32_t kLibSdSwitchKeyOff = 0x16u;   // SD_S_KOFF
+        constexpr uint32_t kLibSdAddrStart = 0x20u;      // SD_VA_SSA
+        constexpr uint32_t kLibSdAddrLoop = 0x21u;       // SD_VA_LSAX
 
         struct VoiceTransferState
         {
@@ -54,6 +64,24 @@ namespace ps2_stubs
             g_audio_stub_state = {};
         }
 
+        // Entry words pack the register in bits 8-15, the voice in bits 1-5
+        // and the core in bit 0.
+        uint32_t libSdEntryVoice(uint32_t entry)
+        {
+            const uint32_t voice = (entry >> 1) & 0x1Fu;
+            if (voice >= PS2Spu2::kVoicesPerCore)
+                return PS2Spu2::kVoiceCount;
+            return (entry & 1u) * PS2Spu2::kVoicesPerCore + voice;
+        }
+
+        const uint8_t *guestRange(uint8_t *rdram, uint32_t address, uint32_t size)
+        {
+            const uint32_t physical = address & PS2_RAM_MASK;
+            if (!rdram || size > PS2_RAM_SIZE || physical > PS2_RAM_SIZE - size)
+                return nullptr;
+            return rdram + physical;
+        }
+
         uint32_t currentBlockStatus(const BlockTransferState &transfer)
         {
             const uint32_t position = (transfer.base + transfer.offset) & kAudioPositionMask;
@@ -76,8 +104,6 @@ namespace ps2_stubs
 
     void sceSdRemote(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
     {
-        (void)runtime;
-
         const uint32_t cmd = getRegU32(ctx, 5);
         const uint32_t cmdArg0 = getRegU32(ctx, 6);
         const uint32_t cmdArg1 = getRegU32(ctx, 7);
@@ -97,6 +123,7 @@ namespace ps2_stubs
         const uint32_t core = cmdArg0 & (kLibSdCoreCount - 1u);
         VoiceTransferState &voiceTransfer = g_audio_stub_state.voiceTransfers[core];
         BlockTransferState &blockTransfer = g_audio_stub_state.blockTransfers[core];
+        PS2Spu2 *spu2 = runtime ? &runtime->audioBackend().spu2() : nullptr;
         uint32_t returnValue = 0u;
 
         if (cmd == kLibSdCmdVoiceTrans)
@@ -107,6 +134,12 @@ namespace ps2_stubs
             voiceTransfer.mode = static_cast<uint16_t>(cmdArg1);
             voiceTransfer.completed = true;
 
+            if (spu2 && (voiceTransfer.mode & kLibSdTransDirectionMask) == kLibSdTransWrite)
+            {
+                if (const uint8_t *src = guestRange(rdram, voiceTransfer.sourceAddress, voiceTransfer.size))
+                    spu2->writeRam(voiceTransfer.destinationAddress, src, voiceTransfer.size);
+            }
+
             // sceSdVoiceTrans returns the transferred byte count for DMA
             // mode and zero for its synchronous programmed-I/O mode.
             returnValue = ((voiceTransfer.mode & kLibSdTransModeIo) != 0u)
@@ -129,6 +162,8 @@ namespace ps2_stubs
             {
                 returnValue = currentBlockStatus(blockTransfer);
                 blockTransfer = {};
+                if (spu2)
+                    spu2->stopCoreInput(core);
             }
             else if (arg4 != 0u && arg5 != 0u)
             {
@@ -145,6 +180,12 @@ namespace ps2_stubs
                 blockTransfer.statusTraceCount = 0u;
                 blockTransfer.active = true;
                 returnValue = 0u;
+
+                if (spu2)
+                {
+                    if (const uint8_t *src = guestRange(rdram, arg4, blockTransfer.size))
+                        spu2->startCoreInput(core, src, blockTransfer.size, blockTransfer.offset, blockTransfer.loop);
+                }
             }
             else
             {
@@ -167,7 +208,15 @@ namespace ps2_stubs
         }
         else if (cmd == kLibSdCmdBlockTransStatus)
         {
-            if (blockTransfer.active && blockTransfer.size != 0u)
+            uint32_t mixerOffset = 0u;
+            if (blockTransfer.active && spu2 && runtime->audioBackend().streaming() &&
+                spu2->coreInputOffset(core, mixerOffset))
+            {
+                // The mixer is playing the stream in real time; report where
+                // it actually is instead of stepping per poll.
+                blockTransfer.offset = mixerOffset;
+            }
+            else if (blockTransfer.active && blockTransfer.size != 0u)
             {
                 blockTransfer.offset = (blockTransfer.offset + kAudioTransferUnit) % blockTransfer.size;
                 if (blockTransfer.statusTraceCount < 32u)
@@ -186,8 +235,40 @@ namespace ps2_stubs
         }
         else if (cmd == kLibSdCmdSetParam)
         {
-            (void)cmdArg0;
-            (void)cmdArg1;
+            const uint32_t reg = (cmdArg0 >> 8) & 0xFFu;
+            if (spu2 && reg <= kLibSdVoiceParamLast)
+            {
+                spu2->setVoiceParam(libSdEntryVoice(cmdArg0),
+                                    static_cast<PS2Spu2::VoiceParam>(reg),
+                                    static_cast<uint16_t>(cmdArg1));
+            }
+            returnValue = 0u;
+        }
+        else if (cmd == kLibSdCmdGetParam)
+        {
+            const uint32_t reg = (cmdArg0 >> 8) & 0xFFu;
+            if (spu2 && reg <= kLibSdVoiceParamLast)
+            {
+                returnValue = spu2->voiceParam(libSdEntryVoice(cmdArg0),
+                                               static_cast<PS2Spu2::VoiceParam>(reg));
+            }
+        }
+        else if (cmd == kLibSdCmdSetSwitch)
+        {
+            const uint32_t reg = (cmdArg0 >> 8) & 0xFFu;
+            if (spu2 && reg == kLibSdSwitchKeyOn)
+                spu2->keyOn(core, cmdArg1);
+            else if (spu2 && reg == kLibSdSwitchKeyOff)
+                spu2->keyOff(core, cmdArg1);
+            returnValue = 0u;
+        }
+        else if (cmd == kLibSdCmdSetAddr)
+        {
+            const uint32_t reg = (cmdArg0 >> 8) & 0xFFu;
+            if (spu2 && reg == kLibSdAddrStart)
+                spu2->setVoiceStartAddress(libSdEntryVoice(cmdArg0), cmdArg1);
+            else if (spu2 && reg == kLibSdAddrLoop)
+                spu2->setVoiceLoopAddress(libSdEntryVoice(cmdArg0), cmdArg1);
             returnValue = 0u;
         }
 
@@ -197,11 +278,12 @@ namespace ps2_stubs
     void sceSdRemoteInit(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
     {
         (void)rdram;
-        (void)runtime;
 
         std::lock_guard<std::mutex> lock(g_audio_stub_mutex);
         resetAudioStubStateUnlocked();
         g_audio_stub_state.initialized = true;
+        if (runtime)
+            runtime->audioBackend().spu2().reset();
         setReturnS32(ctx, 0);
     }
 
@@ -1,50 +1,53 @@
 #include "Common.h"
 #include "IPU.h"
-#include "runtime/ee_scheduler.h"
 
 namespace
 {
-    constexpr uint32_t REG_IPU_CTRL = 0x10002010u;
     constexpr uint32_t REG_IPU_CMD = 0x10002000u;
-    constexpr uint32_t REG_IPU_IN_FIFO = 0x10007010u;
-    constexpr uint32_t IQVAL_BASE = 0x1721e0u;
-    constexpr uint32_t VQVAL_BASE = 0x172230u;
-    constexpr uint32_t SETD4_CHCR_ENTRY = 0x126428u;
+    constexpr uint32_t REG_IPU_CTRL = 0x10002010u;
+    constexpr uint32_t REG_IPU_BP = 0x10002020u;
+    constexpr uint32_t IPU_CTRL_BUSY = 0x80000000u;
+    constexpr uint32_t IPU_CTRL_RST = 0x40000000u;
+
+    constexpr uint32_t REG_D3_CHCR = 0x1000B000u; // fromIPU
+    constexpr uint32_t REG_D4_CHCR = 0x1000B400u; // toIPU
+    constexpr uint32_t DMA_MADR = 0x10u;
+    constexpr uint32_t DMA_QWC = 0x20u;
+    constexpr uint32_t DMA_TADR = 0x30u;
+    constexpr uint32_t DMA_CHCR_STR = 0x100u;
 
-    void completeIpuInit(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
+    struct SceIpuDmaEnv
     {
-        PS2Memory &mem = runtime->memory();
-        mem.write32(REG_IPU_CTRL, 0x40000000u);
-        mem.write32(REG_IPU_CMD, 0u);
+        uint32_t d4madr = 0;
+        uint32_t d4tadr = 0;
+        uint32_t d4qwc = 0;
+        uint32_t d4chcr = 0;
+        uint32_t d3madr = 0;
+        uint32_t d3qwc = 0;
+        uint32_t d3chcr = 0;
+        uint32_t ipubp = 0;
+        uint32_t ipuctrl = 0;
+    };
 
-        __m128i v;
-        v = runtime->Load128(rdram, ctx, IQVAL_BASE + 0x00u);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        v = runtime->Load128(rdram, ctx, IQVAL_BASE + 0x10u);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        v = runtime->Load128(rdram, ctx, IQVAL_BASE + 0x20u);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        v = runtime->Load128(rdram, ctx, IQVAL_BASE + 0x30u);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        v = runtime->Load128(rdram, ctx, IQVAL_BASE + 0x40u);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        mem.write128(REG_IPU_IN_FIFO, v);
-
-        mem.write32(REG_IPU_CMD, 0x50000000u);
-        mem.write32(REG_IPU_CMD, 0x58000000u);
-
-        v = runtime->Load128(rdram, ctx, VQVAL_BASE + 0x00u);
-        mem.write128(REG_IPU_IN_FIFO, v);
-        v = runtime->Load128(rdram, ctx, VQVAL_BASE + 0x10u);
-        mem.write128(REG_IPU_IN_FIFO, v);
-
-        mem.write32(REG_IPU_CMD, 0x60000000u);
-        mem.write32(REG_IPU_CMD, 0x90000000u);
-        mem.write32(REG_IPU_CTRL, 0x40000000u);
-        mem.write32(REG_IPU_CMD, 0u);
-        setReturnS32(ctx, 0);
+    static_assert(sizeof(SceIpuDmaEnv) == 0x24, "sceIpuDmaEnv must match the guest ABI");
+
+    // The IPU stays busy while a command waits for input or while more
+    // output is queued than its FIFO holds and fromIPU is not draining it.
+    bool ipuBusy(PS2Memory &mem)
+    {
+        mem.pumpIpu();
+        return (mem.read32(REG_IPU_CTRL) & IPU_CTRL_BUSY) != 0u ||
+               mem.ipu().outputQwords() > PS2Ipu::kFifoQwords;
+    }
+
+    // A chain that stopped on refe/end has no further tag to fetch.
+    bool toIpuHasWork(const SceIpuDmaEnv &env)
+    {
+        if (env.d4qwc != 0u)
+            return true;
+        const bool chain = ((env.d4chcr >> 2) & 0x3u) == 1u;
+        const uint32_t tagId = (env.d4chcr >> 28) & 0x7u;
+        return chain && tagId != 0u && tagId != 7u;
     }
 }
 
@@ -70,39 +73,90 @@ namespace ps2_stubs
             return;
         }
 
-        if (runtime->hasFunction(SETD4_CHCR_ENTRY))
-        {
-            EeScheduler &scheduler = runtime->eeScheduler();
-            scheduler.bindMainContextForSyscall(*ctx, rdram);
-            GuestInvocation invocation{};
-            invocation.kind = GuestInvocationKind::HleCall;
-            invocation.context = *ctx;
-            invocation.context.pc = SETD4_CHCR_ENTRY;
-            SET_GPR_U32(&invocation.context, 4, 1u);
-            SET_GPR_U32(&invocation.context, 29, 0u);
-            SET_GPR_U32(&invocation.context, 31, 0u);
-            invocation.onComplete = [rdram, runtime](const R5900Context &, R5900Context &parent)
-            {
-                completeIpuInit(rdram, &parent, runtime);
-            };
-            scheduler.invokeCurrent(std::move(invocation));
-        }
-
-        completeIpuInit(rdram, ctx, runtime);
+        // RST drops any running command and both FIFOs; BCLR then starts
+        // the bit pointer at the first qword fed in. RST keeps the tables,
+        // so the defaults the library would SETIQ/SETVQ are loaded directly.
+        PS2Memory &mem = runtime->memory();
+        mem.write32(REG_IPU_CTRL, IPU_CTRL_RST);
+        mem.write32(REG_IPU_CMD, 0u);
+        mem.ipu().loadDefaultTables();
+        setReturnS32(ctx, 0);
     }
 
     void sceIpuRestartDMA(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
     {
+        const uint32_t envAddr = getRegU32(ctx, 4);
+        const uint8_t *src = getConstMemPtr(rdram, envAddr);
+        if (!runtime || !src)
+        {
+            setReturnS32(ctx, -1);
+            return;
+        }
+
+        SceIpuDmaEnv env;
+        std::memcpy(&env, src, sizeof(env));
+
+        PS2Memory &mem = runtime->memory();
+        mem.write32(REG_D3_CHCR + DMA_MADR, env.d3madr);
+        mem.write32(REG_D3_CHCR + DMA_QWC, env.d3qwc);
+        mem.write32(REG_D4_CHCR + DMA_MADR, env.d4madr);
+        mem.write32(REG_D4_CHCR + DMA_TADR, env.d4tadr);
+        mem.write32(REG_D4_CHCR + DMA_QWC, env.d4qwc);
+
+        // fromIPU goes first so output produced by the resumed input has
+        // somewhere to go.
+        const bool restartFrom = (env.d3chcr & DMA_CHCR_STR) != 0u && env.d3qwc != 0u;
+        mem.write32(REG_D3_CHCR, restartFrom ? env.d3chcr : (env.d3chcr & ~DMA_CHCR_STR));
+        const bool restartTo = (env.d4chcr & DMA_CHCR_STR) != 0u && toIpuHasWork(env);
+        mem.write32(REG_D4_CHCR, restartTo ? env.d4chcr : (env.d4chcr & ~DMA_CHCR_STR));
         setReturnS32(ctx, 0);
     }
 
     void sceIpuStopDMA(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
     {
+        if (!runtime)
+        {
+            setReturnS32(ctx, -1);
+            return;
+        }
+
+        PS2Memory &mem = runtime->memory();
+        SceIpuDmaEnv env;
+        env.d4chcr = mem.read32(REG_D4_CHCR);
+        env.d3chcr = mem.read32(REG_D3_CHCR);
+        mem.write32(REG_D4_CHCR, env.d4chcr & ~DMA_CHCR_STR);
+        mem.write32(REG_D3_CHCR, env.d3chcr & ~DMA_CHCR_STR);
+
+        env.d4madr = mem.read32(REG_D4_CHCR + DMA_MADR);
+        env.d4tadr = mem.read32(REG_D4_CHCR + DMA_TADR);
+        env.d4qwc = mem.read32(REG_D4_CHCR + DMA_QWC);
+        env.d3madr = mem.read32(REG_D3_CHCR + DMA_MADR);
+        env.d3qwc = mem.read32(REG_D3_CHCR + DMA_QWC);
+        env.ipubp = mem.read32(REG_IPU_BP);
+        env.ipuctrl = mem.read32(REG_IPU_CTRL);
+
+        if (uint8_t *dst = getMemPtr(rdram, getRegU32(ctx, 4)))
+            std::memcpy(dst, &env, sizeof(env));
         setReturnS32(ctx, 0);
     }
 
     void sceIpuSync(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
     {
-        setReturnS32(ctx, 0);
+        if (!runtime)
+        {
+            setReturnS32(ctx, 0);
+            return;
+        }
+
+        // The model runs commands as soon as input reaches it, so once
+        // both channels have been serviced nothing can change until the
+        // guest feeds more data: a blocking sync that is still busy has
+        // timed out.
+        const bool busy = ipuBusy(runtime->memory());
+        const int32_t mode = static_cast<int32_t>(getRegU32(ctx, 4));
+        if (mode != 0)
+            setReturnS32(ctx, busy ? 1 : 0);
+        else
+            setReturnS32(ctx, busy ? -1 : 0);
     }
 }
@@ -16,8 +16,14 @@ extern "C"
 }
 #endif
 
+#include <condition_variable>
 #include <deque>
+#include <functional>
 #include <memory>
+#include <thread>
+
+#include "runtime/ps2_mpeg_decoder.h"
+#include "runtime/ps2_mpeg_video.h"
 
 #include "Syscalls/Helpers/State.h"
 
@@ -25,15 +31,6 @@ namespace ps2_stubs
 {
     namespace
     {
-        struct MpegDecodedFrame
-        {
-            int width = 0;
-            int height = 0;
-            int repeatPict = 0;
-            int64_t pts90k = -1;
-            std::vector<uint8_t> rgba;
-        };
-
 #if PS2X_HAS_FFMPEG
         std::string ffmpegErrorString(int err)
         {
@@ -58,12 +55,12 @@ namespace ps2_stubs
                            });
         }
 
-        class MpegFfmpegDecoder
+        class MpegFfmpegDecoder final : public PS2MpegVideoDecoder
         {
         public:
             MpegFfmpegDecoder() = default;
 
-            ~MpegFfmpegDecoder()
+            ~MpegFfmpegDecoder() override
             {
                 reset();
             }
@@ -71,7 +68,7 @@ namespace ps2_stubs
             MpegFfmpegDecoder(const MpegFfmpegDecoder &) = delete;
             MpegFfmpegDecoder &operator=(const MpegFfmpegDecoder &) = delete;
 
-            bool feed(const uint8_t *data, size_t size, std::deque<MpegDecodedFrame> &frames, int64_t pts90k = -1, int64_t dts90k = -1)
+            bool feed(const uint8_t *data, size_t size, int64_t pts90k, int64_t dts90k, PS2MpegPictureQueue &pictures) override
             {
                 if (!data || size == 0)
                 {
@@ -83,15 +80,6 @@ namespace ps2_stubs
                     return false;
                 }
 
-                static uint32_t s_feedLogCount = 0u;
-                const bool shouldLog = (s_feedLogCount < 32u);
-                if (shouldLog)
-                    ++s_feedLogCount;
-
-                size_t totalParsed = 0u;
-                size_t totalPacketsSent = 0u;
-                size_t framesBefore = frames.size();
-
                 const uint8_t *cursor = data;
                 size_t remaining = size;
                 int64_t parserPts = pts90k >= 0 ? pts90k : AV_NOPTS_VALUE;
@@ -122,7 +110,6 @@ namespace ps2_stubs
                         break;
                     }
 
-                    totalParsed += static_cast<size_t>(used);
                     cursor += used;
                     remaining -= static_cast<size_t>(used);
 
@@ -134,30 +121,28 @@ namespace ps2_stubs
 
                     if (packetSize > 0)
                     {
-                        ++totalPacketsSent;
-                        if (!sendPacket(packetData, static_cast<size_t>(packetSize), frames, m_parser->pts, m_parser->dts))
+                        if (!sendPacket(packetData, static_cast<size_t>(packetSize), pictures, m_parser->pts, m_parser->dts))
                         {
                             return false;
                         }
                     }
                 }
 
-                if (shouldLog)
-                {
-                    PS2_IF_AGRESSIVE_LOGS({
+                PS2_IF_AGRESSIVE_LOGS({
+                    static uint32_t s_feedLogCount = 0u;
+                    if (s_feedLogCount < 32u)
+                    {
+                        ++s_feedLogCount;
                         std::cerr << "[MPEG:feed] inSize=" << size
-                                  << " parsed=" << totalParsed
-                                  << " packets=" << totalPacketsSent
-                                  << " newFrames=" << (frames.size() - framesBefore)
-                                  << " totalFrames=" << frames.size()
+                                  << " totalFrames=" << m_picturesDecoded
                                   << std::endl;
-                    });
-                }
+                    }
+                });
 
                 return true;
             }
 
-            bool flush(std::deque<MpegDecodedFrame> &frames)
+            bool flush(PS2MpegPictureQueue &pictures) override
             {
                 if (!m_initialized || m_drained)
                 {
@@ -179,7 +164,7 @@ namespace ps2_stubs
                         AV_NOPTS_VALUE,
                         0);
                     (void)used;
-                    if (packetSize > 0 && !sendPacket(packetData, static_cast<size_t>(packetSize), frames, m_parser->pts, m_parser->dts))
+                    if (packetSize > 0 && !sendPacket(packetData, static_cast<size_t>(packetSize), pictures, m_parser->pts, m_parser->dts))
                     {
                         return false;
                     }
@@ -192,12 +177,12 @@ namespace ps2_stubs
                     return false;
                 }
 
-                const bool ok = receiveFrames(frames);
+                const bool ok = receiveFrames(pictures);
                 m_drained = true;
                 return ok;
             }
 
-            void reset()
+            void reset() override
             {
                 if (m_swsCtx)
                 {
@@ -286,7 +271,7 @@ namespace ps2_stubs
 
             bool sendPacket(const uint8_t *data,
                             size_t size,
-                            std::deque<MpegDecodedFrame> &frames,
+                            PS2MpegPictureQueue &pictures,
                             int64_t pts = AV_NOPTS_VALUE,
                             int64_t dts = AV_NOPTS_VALUE)
             {
@@ -309,7 +294,7 @@ namespace ps2_stubs
                 int ret = avcodec_send_packet(m_codecCtx, m_packet);
                 if (ret == AVERROR(EAGAIN))
                 {
-                    if (!receiveFrames(frames))
+                    if (!receiveFrames(pictures))
                     {
                         av_packet_unref(m_packet);
                         return false;
@@ -329,10 +314,10 @@ namespace ps2_stubs
                     return true;
                 }
 
-                return receiveFrames(frames);
+                return receiveFrames(pictures);
             }
 
-            bool receiveFrames(std::deque<MpegDecodedFrame> &frames)
+            bool receiveFrames(PS2MpegPictureQueue &pictures)
             {
                 while (true)
                 {
@@ -353,7 +338,7 @@ namespace ps2_stubs
                         return true;
                     }
 
-                    if (!convertFrame(frames))
+                    if (!storeFrame(pictures))
                     {
                         av_frame_unref(m_frame);
                         return false;
@@ -362,7 +347,21 @@ namespace ps2_stubs
                 }
             }
 
-            bool convertFrame(std::deque<MpegDecodedFrame> &frames)
+            static void copyPlane(const uint8_t *src, int srcStride, uint8_t *dst, uint32_t dstStride,
+                                  uint32_t width, uint32_t height)
+            {
+                for (uint32_t y = 0u; y < height; ++y)
+                {
+                    std::memcpy(dst + static_cast<size_t>(y) * dstStride,
+                                src + static_cast<std::ptrdiff_t>(y) * srcStride,
+                                width);
+                }
+            }
+
+            // Keeps the picture as planar 4:2:0 in a queue slot. MPEG-2 video on
+            // PS2 discs is always 4:2:0, so the scaler only runs for the odd
+            // stream that decodes to another layout.
+            bool storeFrame(PS2MpegPictureQueue &pictures)
             {
                 const int width = m_frame->width;
                 const int height = m_frame->height;
@@ -372,10 +371,11 @@ namespace ps2_stubs
                     return false;
                 }
 
-                if (!m_swsCtx ||
-                    m_swsWidth != width ||
-                    m_swsHeight != height ||
-                    m_swsFormat != srcFormat)
+                if (srcFormat != AV_PIX_FMT_YUV420P &&
+                    (!m_swsCtx ||
+                     m_swsWidth != width ||
+                     m_swsHeight != height ||
+                     m_swsFormat != srcFormat))
                 {
                     if (m_swsCtx)
                     {
@@ -388,7 +388,7 @@ namespace ps2_stubs
                         srcFormat,
                         width,
                         height,
-                        AV_PIX_FMT_RGBA,
+                        AV_PIX_FMT_YUV420P,
                         SWS_BILINEAR,
                         nullptr,
                         nullptr,
@@ -403,32 +403,55 @@ namespace ps2_stubs
                     m_swsFormat = srcFormat;
                 }
 
-                MpegDecodedFrame decoded;
-                decoded.width = width;
-                decoded.height = height;
-                decoded.repeatPict = std::max(0, m_frame->repeat_pict);
-                decoded.pts90k = m_frame->best_effort_timestamp != AV_NOPTS_VALUE
-                                     ? m_frame->best_effort_timestamp
-                                     : -1;
-                decoded.rgba.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4u);
-
-                uint8_t *dstData[4] = {decoded.rgba.data(), nullptr, nullptr, nullptr};
-                int dstLinesize[4] = {width * 4, 0, 0, 0};
-                const int scaledRows = sws_scale(
-                    m_swsCtx,
-                    m_frame->data,
-                    m_frame->linesize,
-                    0,
-                    height,
-                    dstData,
-                    dstLinesize);
-                if (scaledRows <= 0)
-                {
-                    std::cerr << "[MPEG] FFmpeg scaler produced no rows." << std::endl;
+                PS2MpegPicture *picture = pictures.acquire();
+                if (!picture)
+                {
                     return false;
                 }
 
-                frames.push_back(std::move(decoded));
+                picture->allocate(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+                picture->repeatPict = std::max(0, m_frame->repeat_pict);
+                picture->pts90k = m_frame->best_effort_timestamp != AV_NOPTS_VALUE
+                                      ? m_frame->best_effort_timestamp
+                                      : -1;
+
+                if (srcFormat == AV_PIX_FMT_YUV420P)
+                {
+                    const uint32_t chromaWidth = (picture->width + 1u) / 2u;
+                    const uint32_t chromaHeight = (picture->height + 1u) / 2u;
+                    copyPlane(m_frame->data[0], m_frame->linesize[0], picture->luma.data(),
+                              picture->lumaStride(), picture->width, picture->height);
+                    copyPlane(m_frame->data[1], m_frame->linesize[1], picture->cb.data(),
+                              picture->chromaStride(), chromaWidth, chromaHeight);
+                    copyPlane(m_frame->data[2], m_frame->linesize[2], picture->cr.data(),
+                              picture->chromaStride(), chromaWidth, chromaHeight);
+                }
+                else
+                {
+                    uint8_t *dstData[4] = {picture->luma.data(), picture->cb.data(), picture->cr.data(), nullptr};
+                    int dstLinesize[4] = {
+                        static_cast<int>(picture->lumaStride()),
+                        static_cast<int>(picture->chromaStride()),
+                        static_cast<int>(picture->chromaStride()),
+                        0};
+                    const int scaledRows = sws_scale(
+                        m_swsCtx,
+                        m_frame->data,
+                        m_frame->linesize,
+                        0,
+                        height,
+                        dstData,
+                        dstLinesize);
+                    if (scaledRows <= 0)
+                    {
+                        std::cerr << "[MPEG] FFmpeg scaler produced no rows." << std::endl;
+                        pictures.release(picture);
+                        return false;
+                    }
+                }
+
+                pictures.publish(picture);
+                ++m_picturesDecoded;
                 return true;
             }
 
@@ -440,33 +463,184 @@ namespace ps2_stubs
             int m_swsWidth = 0;
             int m_swsHeight = 0;
             AVPixelFormat m_swsFormat = AV_PIX_FMT_NONE;
+            uint64_t m_picturesDecoded = 0u;
             bool m_initialized = false;
             bool m_drained = false;
         };
+
+        using MpegWorkerDecoder = MpegFfmpegDecoder;
 #else
-        // TODO
-        class MpegFfmpegDecoder
+        // Without FFmpeg the built-in decoder covers the MPEG-1/2 main
+        // profile streams PS2 titles ship.
+        using MpegWorkerDecoder = PS2MpegDecoder;
+#endif
+
+        // Runs one video decoder on its own host thread so decoding never
+        // stalls the EE. Demuxed elementary stream chunks are copied in and the
+        // call returns at once; pictures land in the shared slot queue and the
+        // wake callback nudges any sceMpegGetPicture waiter through the EE
+        // event ring. A decoder failure stops decoding until the owner
+        // replaces the worker after resyncing on a sequence header.
+        class MpegDecodeWorker
         {
         public:
-            bool feed(const uint8_t *, size_t, std::deque<MpegDecodedFrame> &, int64_t = -1, int64_t = -1)
+            MpegDecodeWorker(std::shared_ptr<PS2MpegPictureQueue> pictures, std::function<void()> wake)
+                : m_pictures(std::move(pictures)),
+                  m_wake(std::move(wake)),
+                  m_decoder(std::make_unique<MpegWorkerDecoder>())
+            {
+                m_pictures->reopen();
+                m_thread = std::thread([this]
+                                       { run(); });
+            }
+
+            ~MpegDecodeWorker()
             {
-                static bool s_warnedNoFfmpeg = false;
-                if (!s_warnedNoFfmpeg)
                 {
-                    std::cerr << "[MPEG] runtime built without FFmpeg; MPEG video decode is disabled." << std::endl;
-                    s_warnedNoFfmpeg = true;
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_commandReady.notify_all();
+                m_pictures->close();
+                if (m_thread.joinable())
+                {
+                    m_thread.join();
                 }
-                return false;
             }
 
-            bool flush(std::deque<MpegDecodedFrame> &)
+            MpegDecodeWorker(const MpegDecodeWorker &) = delete;
+            MpegDecodeWorker &operator=(const MpegDecodeWorker &) = delete;
+
+            void submit(const uint8_t *data, size_t size, int64_t pts90k, int64_t dts90k)
             {
-                return true;
+                if (!data || size == 0u)
+                {
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    Command command;
+                    if (!m_spareBuffers.empty())
+                    {
+                        command.data = std::move(m_spareBuffers.back());
+                        m_spareBuffers.pop_back();
+                    }
+                    command.data.assign(data, data + size);
+                    command.pts90k = pts90k;
+                    command.dts90k = dts90k;
+                    m_queuedBytes += size;
+                    m_commands.push_back(std::move(command));
+                }
+                m_commandReady.notify_one();
+            }
+
+            void flush()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    Command command;
+                    command.flush = true;
+                    m_commands.push_back(std::move(command));
+                }
+                m_commandReady.notify_one();
+            }
+
+            bool failed() const
+            {
+                return m_failed.load(std::memory_order_acquire);
             }
 
-            void reset() {}
+            // True while submitted input has not been fully decoded yet.
+            bool pending() const
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_busy || !m_commands.empty();
+            }
+
+            size_t queuedBytes() const
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_queuedBytes;
+            }
+
+        private:
+            static constexpr size_t kMaxSpareBuffers = 8u;
+
+            struct Command
+            {
+                std::vector<uint8_t> data;
+                int64_t pts90k = -1;
+                int64_t dts90k = -1;
+                bool flush = false;
+            };
+
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (true)
+                {
+                    m_commandReady.wait(lock, [this]
+                                        { return m_stopping || !m_commands.empty(); });
+                    if (m_stopping)
+                    {
+                        return;
+                    }
+
+                    Command command = std::move(m_commands.front());
+                    m_commands.pop_front();
+                    m_busy = true;
+                    lock.unlock();
+
+                    const uint64_t publishedBefore = m_pictures->publishedCount();
+                    bool ok = true;
+                    if (!m_failed.load(std::memory_order_relaxed))
+                    {
+                        ok = command.flush
+                                 ? m_decoder->flush(*m_pictures)
+                                 : m_decoder->feed(command.data.data(), command.data.size(),
+                                                   command.pts90k, command.dts90k, *m_pictures);
+                    }
+                    const bool published = m_pictures->publishedCount() != publishedBefore;
+
+                    lock.lock();
+                    m_queuedBytes -= command.data.size();
+                    if (!command.flush && m_spareBuffers.size() < kMaxSpareBuffers)
+                    {
+                        m_spareBuffers.push_back(std::move(command.data));
+                    }
+                    if (!ok && !m_stopping)
+                    {
+                        m_failed.store(true, std::memory_order_release);
+                    }
+                    m_busy = false;
+                    const bool idle = m_commands.empty();
+                    const bool stopping = m_stopping;
+                    lock.unlock();
+
+                    // Waiters re-check on every new picture and once the
+                    // backlog drains, so EOF or failure is never missed.
+                    if (!stopping && m_wake && (published || idle || !ok))
+                    {
+                        m_wake();
+                    }
+                    lock.lock();
+                }
+            }
+
+            std::shared_ptr<PS2MpegPictureQueue> m_pictures;
+            std::function<void()> m_wake;
+            std::unique_ptr<PS2MpegVideoDecoder> m_decoder;
+            mutable std::mutex m_mutex;
+            std::condition_variable m_commandReady;
+            std::deque<Command> m_commands;
+            std::vector<std::vector<uint8_t>> m_spareBuffers;
+            size_t m_queuedBytes = 0u;
+            bool m_busy = false;
+            bool m_stopping = false;
+            std::atomic<bool> m_failed{false};
+            std::thread m_thread;
         };
-#endif
 
         struct MpegRegisteredCallback
         {
@@ -483,6 +657,10 @@ namespace ps2_stubs
         constexpr uint64_t kDefaultPictureIntervalQ32 = 2ull * kPictureClockOne;
         constexpr size_t kMpegTimingScanLimit = 4096u;
         constexpr size_t kMaxDecodedPicturesAhead = 8u;
+        // Two spare slots let the worker keep decoding while the EE holds the
+        // picture it is presenting and demux backpressure catches up.
+        constexpr size_t kMpegPictureSlots = kMaxDecodedPicturesAhead + 2u;
+        constexpr size_t kMaxQueuedElementaryBytes = 512u * 1024u;
 
         struct MpegPlaybackState
         {
@@ -500,8 +678,9 @@ namespace ps2_stubs
             std::vector<uint8_t> videoSequenceSyncBuffer;
             std::vector<uint8_t> pssBuffer;
             std::vector<uint32_t> pssGuestAddrs;
-            std::deque<MpegDecodedFrame> decodedFrames;
-            std::unique_ptr<MpegFfmpegDecoder> decoder;
+            std::shared_ptr<PS2MpegPictureQueue> pictures = std::make_shared<PS2MpegPictureQueue>(kMpegPictureSlots);
+            std::function<void()> wakePictureWaiter;
+            std::unique_ptr<MpegDecodeWorker> decoder;
             uint8_t frameRateCode = 0u;
             uint8_t frameRateExtensionN = 0u;
             uint8_t frameRateExtensionD = 0u;
@@ -701,7 +880,7 @@ namespace ps2_stubs
         }
 
         uint64_t decodedFrameIntervalQ32(const MpegPlaybackState &playback,
-                                         const MpegDecodedFrame &frame)
+                                         const PS2MpegPicture &frame)
         {
             const uint64_t base = playback.pictureIntervalQ32 != 0u
                                       ? playback.pictureIntervalQ32
@@ -742,7 +921,7 @@ namespace ps2_stubs
             return wholeQ32 + remainderQ32;
         }
 
-        uint64_t presentationTickForFrame(MpegPlaybackState &playback, const MpegDecodedFrame &frame, uint64_t currentTickQ32)
+        uint64_t presentationTickForFrame(MpegPlaybackState &playback, const PS2MpegPicture &frame, uint64_t currentTickQ32)
         {
             if (frame.pts90k < 0)
             {
@@ -815,9 +994,31 @@ namespace ps2_stubs
             playback.imageBufferAddr = oldPlayback.imageBufferAddr;
             playback.width = oldPlayback.width;
             playback.height = oldPlayback.height;
+            playback.wakePictureWaiter = oldPlayback.wakePictureWaiter;
             return playback;
         }
 
+        bool decodePending(const MpegPlaybackState &playback)
+        {
+            return playback.decoder && playback.decoder->pending();
+        }
+
+        // Decode workers outlive the stub call that fed them, so they wake
+        // picture waiters by posting to the EE event ring instead of calling
+        // into the scheduler directly.
+        void bindPictureWaiterWake(uint32_t mpegAddr, MpegPlaybackState &playback, PS2Runtime *runtime)
+        {
+            if (playback.wakePictureWaiter || !runtime)
+            {
+                return;
+            }
+
+            playback.wakePictureWaiter = [runtime, mpegAddr]
+            {
+                runtime->postEeEvent(EeEvent{EeEventType::ExternalWake, kMpegPictureWaitType, mpegAddr});
+            };
+        }
+
         uint16_t readBe16(const uint8_t *p)
         {
             return static_cast<uint16_t>((static_cast<uint16_t>(p[0]) << 8u) | static_cast<uint16_t>(p[1]));
@@ -1008,7 +1209,7 @@ namespace ps2_stubs
         {
             if (playback.streamEnded && playback.decoder)
             {
-                playback.decoder->flush(playback.decodedFrames);
+                playback.decoder->flush();
             }
         }
 
@@ -1039,6 +1240,14 @@ namespace ps2_stubs
 
             playback.sawInput = true;
             updateMpegPictureTiming(playback, data, size);
+            if (playback.decoder && playback.decoder->failed())
+            {
+                playback.decoder.reset();
+                playback.waitingForVideoSequenceHeader = true;
+                playback.videoSequenceSyncBuffer.clear();
+                playback.decoderFailed = false;
+            }
+
             if (playback.waitingForVideoSequenceHeader)
             {
                 playback.videoSequenceSyncBuffer.insert(
@@ -1083,7 +1292,7 @@ namespace ps2_stubs
                 playback.waitingForVideoSequenceHeader = false;
                 playback.decoderFailed = false;
                 playback.decoder.reset();
-                playback.decodedFrames.clear();
+                playback.pictures->clear();
             }
 
             if (containsMpegSequenceEnd(data, size))
@@ -1094,18 +1303,10 @@ namespace ps2_stubs
 
             if (!playback.decoder)
             {
-                playback.decoder = std::make_unique<MpegFfmpegDecoder>();
-            }
-
-            if (!playback.decoder->feed(data, size, playback.decodedFrames, pts90k, dts90k))
-            {
-                playback.decoder.reset();
-                playback.waitingForVideoSequenceHeader = true;
-                playback.videoSequenceSyncBuffer.clear();
-                playback.decoderFailed = false;
-                return;
+                playback.decoder = std::make_unique<MpegDecodeWorker>(playback.pictures, playback.wakePictureWaiter);
             }
 
+            playback.decoder->submit(data, size, pts90k, dts90k);
             playback.videoSequenceSyncBuffer.clear();
             flushDecoderIfEnded(playback);
         }
@@ -1397,7 +1598,8 @@ namespace ps2_stubs
         bool mpegDemuxBackpressured(const MpegPlaybackState &playback)
         {
             // Let EOF finalization drain any tail that is already in the guest
-            // ring, otherwise bound decode lead to a handful of pictures.
+            // ring, otherwise bound decode lead to a handful of pictures and
+            // the worker's undecoded input to a few hundred KiB.
             //
             // Important: do not park sceMpegDemuxPss/Ring here. Code Veronica
             // explicitly wakes its video thread before every demux call and that
@@ -1410,7 +1612,8 @@ namespace ps2_stubs
             // still propagates naturally to sceCdStRead because the ring does not
             // advance while this is true.
             return !g_mpeg_stub_state.currentCdStreamEofSeen &&
-                   playback.decodedFrames.size() >= kMaxDecodedPicturesAhead;
+                   (playback.pictures->readyCount() >= kMaxDecodedPicturesAhead ||
+                    (playback.decoder && playback.decoder->queuedBytes() >= kMaxQueuedElementaryBytes));
         }
 
         void recordCdStreamBytesDemuxedUnlocked(
@@ -1601,7 +1804,9 @@ namespace ps2_stubs
                 return;
             }
 
-            R5900Context callbackCtx = *callerCtx;
+            EeScheduler &scheduler = runtime->eeScheduler();
+            GuestInvocationFrame invocation = scheduler.acquireInvocationFrame(GuestInvocationKind::RpcCallback, *callerCtx);
+            R5900Context &callbackCtx = invocation->context;
             SET_GPR_U32(&callbackCtx, 4, event.mpegAddr);
             SET_GPR_U32(&callbackCtx, 5, cbDataAddr);
             SET_GPR_U32(&callbackCtx, 6, callback.data);
@@ -1609,15 +1814,11 @@ namespace ps2_stubs
             SET_GPR_U32(&callbackCtx, 29, 0u);
             SET_GPR_U32(&callbackCtx, 31, 0u);
             callbackCtx.pc = callback.func;
-
-            GuestInvocation invocation{};
-            invocation.kind = GuestInvocationKind::RpcCallback;
-            invocation.context = callbackCtx;
-            invocation.onComplete = [runtime, cbDataAddr](const R5900Context &, R5900Context &)
+            invocation->onComplete = [runtime, cbDataAddr](const R5900Context &, R5900Context &)
             {
                 runtime->guestFree(cbDataAddr);
             };
-            runtime->eeScheduler().queueInvocation(std::move(invocation));
+            scheduler.queueInvocation(std::move(invocation));
         }
 
         void dispatchStreamCallbacks(uint8_t *rdram,
@@ -1686,18 +1887,20 @@ namespace ps2_stubs
             }
         }
 
-        void writeDecodedFrameToGuest(uint8_t *rdram, uint32_t destAddr, const MpegDecodedFrame &frame)
+        // Converts straight from the picture planes into the guest image in the
+        // layout sceMpegGetPicture produces: 16-pixel-wide macroblock column
+        // strips of RGBA32, each covering the full picture height.
+        void writeDecodedFrameToGuest(uint8_t *rdram, uint32_t destAddr, const PS2MpegPicture &picture)
         {
-            if (!rdram || destAddr == 0u || frame.rgba.empty() || frame.width <= 0 || frame.height <= 0)
+            if (!rdram || destAddr == 0u || picture.luma.empty() || picture.width == 0u || picture.height == 0u)
             {
                 return;
             }
 
-            const uint32_t width = static_cast<uint32_t>(frame.width);
-            const uint32_t height = static_cast<uint32_t>(frame.height);
-            const uint32_t outWidth = align16(width);
-            const uint32_t outHeight = align16(height);
-            const uint32_t macroblockColumns = outWidth / 16u;
+            const uint32_t outHeight = picture.alignedHeight();
+            const uint32_t macroblockColumns = picture.alignedWidth() / 16u;
+            const size_t lumaStride = picture.lumaStride();
+            const size_t chromaStride = picture.chromaStride();
 
             for (uint32_t mbx = 0u; mbx < macroblockColumns; ++mbx)
             {
@@ -1713,31 +1916,15 @@ namespace ps2_stubs
                         continue;
                     }
 
-                    for (uint32_t x = 0u; x < 16u; ++x)
-                    {
-                        const uint32_t srcX = mbx * 16u + x;
-                        const uint8_t *src = nullptr;
-                        if (srcX < width && y < height)
-                        {
-                            src = frame.rgba.data() +
-                                  (static_cast<size_t>(y) * static_cast<size_t>(width) + srcX) * 4u;
-                        }
-
-                        if (src)
-                        {
-                            dst[x * 4u + 0u] = src[0u];
-                            dst[x * 4u + 1u] = src[1u];
-                            dst[x * 4u + 2u] = src[2u];
-                            dst[x * 4u + 3u] = 0x80u;
-                        }
-                        else
-                        {
-                            dst[x * 4u + 0u] = 0u;
-                            dst[x * 4u + 1u] = 0u;
-                            dst[x * 4u + 2u] = 0u;
-                            dst[x * 4u + 3u] = 0x80u;
-                        }
-                    }
+                    const size_t lumaOffset = static_cast<size_t>(y) * lumaStride + mbx * 16u;
+                    const size_t chromaOffset = static_cast<size_t>(y / 2u) * chromaStride + mbx * 8u;
+                    ps2_mpeg::convertRow(picture.luma.data() + lumaOffset,
+                                         picture.cb.data() + chromaOffset,
+                                         picture.cr.data() + chromaOffset,
+                                         16u,
+                                         0x80u,
+                                         ps2_mpeg::PixelFormat::Rgba32,
+                                         dst);
                 }
             }
         }
@@ -1770,18 +1957,25 @@ namespace ps2_stubs
 
     void enqueueMpegDecodedFrameForTesting(uint32_t mpegAddr)
     {
-        constexpr int kTestFrameWidth = 16;
-        constexpr int kTestFrameHeight = 16;
-
-        MpegDecodedFrame frame;
-        frame.width = kTestFrameWidth;
-        frame.height = kTestFrameHeight;
-        frame.rgba.resize(static_cast<size_t>(kTestFrameWidth * kTestFrameHeight * 4), 0x80u);
+        constexpr uint32_t kTestFrameWidth = 16u;
+        constexpr uint32_t kTestFrameHeight = 16u;
 
         std::lock_guard<std::mutex> lock(g_mpeg_stub_mutex);
         MpegPlaybackState &playback = getPlaybackState(mpegAddr);
+        PS2MpegPicture *picture = playback.pictures->tryAcquire();
+        if (!picture)
+        {
+            return;
+        }
+
+        picture->allocate(kTestFrameWidth, kTestFrameHeight);
+        picture->repeatPict = 0;
+        picture->pts90k = -1;
+        std::fill(picture->luma.begin(), picture->luma.end(), 0x80u);
+        std::fill(picture->cb.begin(), picture->cb.end(), 0x80u);
+        std::fill(picture->cr.begin(), picture->cr.end(), 0x80u);
         playback.sawInput = true;
-        playback.decodedFrames.push_back(std::move(frame));
+        playback.pictures->publish(picture);
     }
 
     void notifyMpegCdStreamStart(PS2Runtime *runtime)
@@ -1857,14 +2051,12 @@ namespace ps2_stubs
         {
             std::lock_guard<std::mutex> lock(g_mpeg_stub_mutex);
             MpegPlaybackState &playback = getPlaybackState(mpegAddr);
-            const size_t framesBefore = playback.decodedFrames.size();
+            bindPictureWaiterWake(mpegAddr, playback, runtime);
             if (playback.decoder)
             {
-                playback.decoder->flush(playback.decodedFrames);
+                playback.decoder->flush();
             }
-            wakePictureWaiter = playback.decodedFrames.size() != framesBefore ||
-                                playback.streamEnded ||
-                                playback.decoderFailed;
+            wakePictureWaiter = playback.streamEnded || playback.decoderFailed;
         }
         if (wakePictureWaiter)
         {
@@ -1884,7 +2076,7 @@ namespace ps2_stubs
         {
             std::lock_guard<std::mutex> lock(g_mpeg_stub_mutex);
             MpegPlaybackState &playback = getPlaybackState(mpegAddr);
-            const size_t framesBefore = playback.decodedFrames.size();
+            bindPictureWaiterWake(mpegAddr, playback, runtime);
             while (copied < byteCount)
             {
                 const uint32_t curAddr = dataAddr + static_cast<uint32_t>(copied);
@@ -1898,7 +2090,7 @@ namespace ps2_stubs
                 feedElementaryStream(playback, src, chunk);
                 copied += chunk;
             }
-            wakePictureWaiter = playback.decodedFrames.size() != framesBefore || playback.streamEnded || playback.decoderFailed;
+            wakePictureWaiter = playback.streamEnded || playback.decoderFailed;
         }
 
         if (wakePictureWaiter)
@@ -2085,22 +2277,19 @@ namespace ps2_stubs
         std::vector<MpegStreamCallbackEvent> callbackEvents;
         std::vector<uint32_t> completedMpegIds;
         size_t consumed = 0u;
-        size_t decodedBefore = 0u;
-        size_t decodedCount = 0u;
         uint32_t traceIdx = 0u;
         bool eofChanged = false;
         bool backpressured = false;
         {
             std::lock_guard<std::mutex> lock(g_mpeg_stub_mutex);
             MpegPlaybackState &playback = getPlaybackState(mpegAddr);
-            decodedBefore = playback.decodedFrames.size();
+            bindPictureWaiterWake(mpegAddr, playback, runtime);
             backpressured = mpegDemuxBackpressured(playback);
             if (!backpressured)
             {
                 consumed = appendGuestBytes(mpegAddr, playback, rdram, dataAddr, byteCount, callbackEvents);
                 recordCdStreamBytesDemuxedUnlocked(consumed, completedMpegIds, eofChanged);
             }
-            decodedCount = playback.decodedFrames.size();
             traceIdx = g_mpeg_stub_state.demuxPssTraceCount++;
         }
 
@@ -2109,14 +2298,14 @@ namespace ps2_stubs
             if (traceIdx < 32u)
             {
                 PS2_IF_AGRESSIVE_LOGS({
-                    std::cerr << "[MPEG:DemuxPss:BACKPRESSURE] mpeg=0x" << std::hex << mpegAddr << std::dec << " decoded=" << decodedCount << std::endl;
+                    std::cerr << "[MPEG:DemuxPss:BACKPRESSURE] mpeg=0x" << std::hex << mpegAddr << std::dec << std::endl;
                 });
             }
             setReturnS32(ctx, 0);
             return;
         }
         const bool currentStreamCompleted = std::find(completedMpegIds.begin(), completedMpegIds.end(), mpegAddr) != completedMpegIds.end();
-        if (decodedCount != decodedBefore || eofChanged || currentStreamCompleted)
+        if (eofChanged || currentStreamCompleted)
         {
             runtime->eeScheduler().completeExternalWait(kMpegPictureWaitType, mpegAddr, KE_OK);
         }
@@ -2135,7 +2324,6 @@ namespace ps2_stubs
                           << " data=0x" << dataAddr << std::dec
                           << " bytes=" << byteCount
                           << " consumed=" << consumed
-                          << " decoded=" << decodedCount
                           << " callbacks=" << callbackEvents.size()
                           << std::endl;
             });
@@ -2168,15 +2356,13 @@ namespace ps2_stubs
         std::vector<MpegStreamCallbackEvent> callbackEvents;
         std::vector<uint32_t> completedMpegIds;
         size_t consumed = 0u;
-        size_t decodedBefore = 0u;
-        size_t decodedCount = 0u;
         uint32_t traceIdx = 0u;
         bool eofChanged = false;
         bool backpressured = false;
         {
             std::lock_guard<std::mutex> lock(g_mpeg_stub_mutex);
             MpegPlaybackState &playback = getPlaybackState(mpegAddr);
-            decodedBefore = playback.decodedFrames.size();
+            bindPictureWaiterWake(mpegAddr, playback, runtime);
             backpressured = mpegDemuxBackpressured(playback);
             if (!backpressured)
             {
@@ -2191,7 +2377,6 @@ namespace ps2_stubs
                     callbackEvents);
                 recordCdStreamBytesDemuxedUnlocked(consumed, completedMpegIds, eofChanged);
             }
-            decodedCount = playback.decodedFrames.size();
             traceIdx = g_mpeg_stub_state.demuxRingTraceCount++;
         }
 
@@ -2201,15 +2386,14 @@ namespace ps2_stubs
             {
                 PS2_IF_AGRESSIVE_LOGS({
                     std::cerr << "[MPEG:DemuxPssRing:BACKPRESSURE] mpeg=0x" << std::hex << mpegAddr
-                              << std::dec << " decoded=" << decodedCount
-                              << " avail=" << availableBytes << std::endl;
+                              << std::dec << " avail=" << availableBytes << std::endl;
                 });
             }
             setReturnS32(ctx, 0);
             return;
         }
         const bool currentStreamCompleted = std::find(completedMpegIds.begin(), completedMpegIds.end(), mpegAddr) != completedMpegIds.end();
-        if (decodedCount != decodedBefore || eofChanged || currentStreamCompleted)
+        if (eofChanged || currentStreamCompleted)
         {
             runtime->eeScheduler().completeExternalWait(kMpegPictureWaitType, mpegAddr, KE_OK);
         }
@@ -2229,7 +2413,6 @@ namespace ps2_stubs
                           << " ring=0x" << ringBaseAddr << std::dec
                           << " avail=" << availableBytes
                           << " consumed=" << consumed
-                          << " decoded=" << decodedCount
                           << " callbacks=" << callbackEvents.size()
                           << std::endl;
             });
@@ -2287,15 +2470,20 @@ namespace ps2_stubs
         uint32_t width = kStubMovieWidth;
         uint32_t height = kStubMovieHeight;
         uint32_t frameCount = 0u;
-        bool haveFrame = false;
-        MpegDecodedFrame frame;
+        std::shared_ptr<PS2MpegPictureQueue> pictures;
+        PS2MpegPicture *picture = nullptr;
         {
             std::unique_lock<std::mutex> lock(g_mpeg_stub_mutex);
             MpegPlaybackState &playback = getPlaybackState(mpegAddr);
-            if (playback.decodedFrames.empty() &&
-                !g_mpeg_stub_state.currentCdStreamEofSeen &&
-                !playback.streamEnded &&
-                !playback.decoderFailed)
+            pictures = playback.pictures;
+            const PS2MpegPicture *nextFrame = pictures->peek();
+            // Only park when the next picture is not decoded yet. While the
+            // worker still has input, EOF does not mean no more pictures.
+            if (!nextFrame &&
+                (decodePending(playback) ||
+                 (!g_mpeg_stub_state.currentCdStreamEofSeen &&
+                  !playback.streamEnded &&
+                  !playback.decoderFailed)))
             {
                 if (g_mpeg_stub_state.getPictureWaitTraceCount < 32u)
                 {
@@ -2322,19 +2510,18 @@ namespace ps2_stubs
                     });
             }
 
-            if (!playback.decodedFrames.empty())
+            if (nextFrame)
             {
                 const uint64_t currentTick = runtime->eeScheduler().currentVSyncTick();
                 const uint64_t currentTickQ32 = currentTick << 32u;
-                const MpegDecodedFrame &nextFrame = playback.decodedFrames.front();
-                const uint64_t frameIntervalQ32 = decodedFrameIntervalQ32(playback, nextFrame);
-                uint64_t presentationTargetQ32 = presentationTickForFrame(playback, nextFrame, currentTickQ32);
+                const uint64_t frameIntervalQ32 = decodedFrameIntervalQ32(playback, *nextFrame);
+                uint64_t presentationTargetQ32 = presentationTickForFrame(playback, *nextFrame, currentTickQ32);
 
                 if (currentTickQ32 > presentationTargetQ32 && currentTickQ32 - presentationTargetQ32 >= frameIntervalQ32)
                 {
                     const uint64_t correction = currentTickQ32 - presentationTargetQ32;
                     presentationTargetQ32 = currentTickQ32;
-                    if (nextFrame.pts90k >= 0 && playback.firstPresentedPts90k >= 0)
+                    if (nextFrame->pts90k >= 0 && playback.firstPresentedPts90k >= 0)
                     {
                         playback.ptsPresentationBaseTickQ32 += correction;
                     }
@@ -2358,24 +2545,22 @@ namespace ps2_stubs
                         });
                 }
 
-                frame = std::move(playback.decodedFrames.front());
-                playback.decodedFrames.pop_front();
-                playback.width = static_cast<uint32_t>(frame.width);
-                playback.height = static_cast<uint32_t>(frame.height);
+                picture = pictures->take();
+                playback.width = picture->width;
+                playback.height = picture->height;
                 width = playback.width;
                 height = playback.height;
                 frameCount = playback.picturesServed;
                 playback.picturesServed += 1u;
                 playback.nextPictureTickQ32 = presentationTargetQ32 + frameIntervalQ32;
                 playback.presentationEndTickQ32 = playback.nextPictureTickQ32;
-                haveFrame = true;
                 if (g_mpeg_stub_state.pictureTraceCount < 32u)
                 {
                     PS2_IF_AGRESSIVE_LOGS({
                         std::cerr << "[MPEG:GetPicture:FRAME] mpeg=0x" << std::hex << mpegAddr
                                   << std::dec << " generation=" << g_mpeg_stub_state.cdStreamGeneration
                                   << " frame=" << frameCount
-                                  << " queued=" << playback.decodedFrames.size()
+                                  << " queued=" << pictures->readyCount()
                                   << " size=" << width << "x" << height << std::endl;
                     });
                     ++g_mpeg_stub_state.pictureTraceCount;
@@ -2406,9 +2591,10 @@ namespace ps2_stubs
             }
         }
 
-        if (haveFrame)
+        if (picture)
         {
-            writeDecodedFrameToGuest(rdram, imageAddr, frame);
+            writeDecodedFrameToGuest(rdram, imageAddr, *picture);
+            pictures->release(picture);
         }
         else if (frameCount == 0u)
         {
@@ -2480,13 +2666,14 @@ namespace ps2_stubs
                           << " seqEnd=" << playback.sawSequenceEnd
                           << " streamEnded=" << playback.streamEnded
                           << " presentationComplete=" << presentationComplete
-                          << " frames=" << playback.decodedFrames.size()
+                          << " frames=" << playback.pictures->readyCount()
                           << " sawInput=" << playback.sawInput << std::endl;
             });
             ++g_mpeg_stub_state.isEndTraceCount;
         }
 
-        setReturnS32(ctx, (ended && playback.decodedFrames.empty() && presentationComplete) ? 1 : 0);
+        const bool drained = playback.pictures->readyCount() == 0u && !decodePending(playback);
+        setReturnS32(ctx, (ended && drained && presentationComplete) ? 1 : 0);
     }
 
     void sceMpegIsRefBuffEmpty(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
@@ -2496,7 +2683,7 @@ namespace ps2_stubs
         const uint32_t mpegAddr = getRegU32(ctx, 4);
         std::lock_guard<std::mutex> lock(g_mpeg_stub_mutex);
         const MpegPlaybackState &playback = getPlaybackState(mpegAddr);
-        setReturnS32(ctx, playback.decodedFrames.empty() ? 1 : 0);
+        setReturnS32(ctx, (playback.pictures->readyCount() == 0u && !decodePending(playback)) ? 1 : 0);
     }
 
     void sceMpegReset(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
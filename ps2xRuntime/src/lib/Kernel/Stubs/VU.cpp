@@ -1,5 +1,6 @@
 #include "Common.h"
 #include "VU.h"
+#include "runtime/ps2_vu_float.h"
 
 namespace ps2_stubs
 {
@@ -28,7 +29,7 @@ namespace ps2_stubs
             return true;
         }
 
-        bool readVuVec4i(uint8_t *rdram, uint32_t addr, int32_t (&out)[4])
+        bool readVuMatrix4f(uint8_t *rdram, uint32_t addr, float (&out)[16])
         {
             const uint8_t *ptr = getConstMemPtr(rdram, addr);
             if (!ptr)
@@ -39,7 +40,7 @@ namespace ps2_stubs
             return true;
         }
 
-        bool writeVuVec4i(uint8_t *rdram, uint32_t addr, const int32_t (&in)[4])
+        bool writeVuMatrix4f(uint8_t *rdram, uint32_t addr, const float (&in)[16])
         {
             uint8_t *ptr = getMemPtr(rdram, addr);
             if (!ptr)
@@ -50,41 +51,104 @@ namespace ps2_stubs
             return true;
         }
 
-        bool readVuMatrix4f(uint8_t *rdram, uint32_t addr, float (&out)[16])
+        // Vector loads fold Inf/NaN/denormal lanes the way VU0 reads them, so
+        // the math below only ever sees values the hardware could hold.
+        bool loadVuVec(uint8_t *rdram, uint32_t addr, __m128 &out)
         {
             const uint8_t *ptr = getConstMemPtr(rdram, addr);
             if (!ptr)
             {
                 return false;
             }
-            std::memcpy(out, ptr, sizeof(out));
+            out = Ps2VuNormalize4(_mm_loadu_ps(reinterpret_cast<const float *>(ptr)));
             return true;
         }
 
-        bool writeVuMatrix4f(uint8_t *rdram, uint32_t addr, const float (&in)[16])
+        bool storeVuVec(uint8_t *rdram, uint32_t addr, __m128 in)
         {
             uint8_t *ptr = getMemPtr(rdram, addr);
             if (!ptr)
             {
                 return false;
             }
-            std::memcpy(ptr, in, sizeof(in));
+            _mm_storeu_ps(reinterpret_cast<float *>(ptr), in);
+            return true;
+        }
+
+        bool loadVuVecInt(uint8_t *rdram, uint32_t addr, __m128i &out)
+        {
+            const uint8_t *ptr = getConstMemPtr(rdram, addr);
+            if (!ptr)
+            {
+                return false;
+            }
+            out = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+            return true;
+        }
+
+        bool storeVuVecInt(uint8_t *rdram, uint32_t addr, __m128i in)
+        {
+            uint8_t *ptr = getMemPtr(rdram, addr);
+            if (!ptr)
+            {
+                return false;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr), in);
+            return true;
+        }
+
+        struct VuMatrix
+        {
+            __m128 row[4];
+        };
+
+        VuMatrix toVuMatrix(const float (&in)[16])
+        {
+            VuMatrix m;
+            for (int i = 0; i < 4; ++i)
+            {
+                m.row[i] = Ps2VuNormalize4(_mm_loadu_ps(in + 4 * i));
+            }
+            return m;
+        }
+
+        bool loadVuMatrix(uint8_t *rdram, uint32_t addr, VuMatrix &out)
+        {
+            float in[16]{};
+            if (!readVuMatrix4f(rdram, addr, in))
+            {
+                return false;
+            }
+            out = toVuMatrix(in);
             return true;
         }
 
+        template <int Lane>
+        __m128 splatVuLane(__m128 v)
+        {
+            return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+        }
+
+        // v * M in the row-vector convention. Rows are scaled by v.x, v.y,
+        // v.z, v.w and accumulated in that order (MULAx/MADDAy/MADDAz/MADDw),
+        // which is also the summation order of the scalar formulas.
+        __m128 applyVuMatrix(const VuMatrix &m, __m128 v)
+        {
+            __m128 acc = Ps2VuMul4(m.row[0], splatVuLane<0>(v));
+            acc = Ps2VuAdd4(acc, Ps2VuMul4(m.row[1], splatVuLane<1>(v)));
+            acc = Ps2VuAdd4(acc, Ps2VuMul4(m.row[2], splatVuLane<2>(v)));
+            return Ps2VuAdd4(acc, Ps2VuMul4(m.row[3], splatVuLane<3>(v)));
+        }
+
         // Row-major matrix product: out = lhs * rhs (lhs is the left factor).
+        // Each output row is lhs's row applied to rhs.
         void mulVuMatrix(const float (&lhs)[16], const float (&rhs)[16], float (&out)[16])
         {
-            std::fill(std::begin(out), std::end(out), 0.0f);
+            const VuMatrix right = toVuMatrix(rhs);
             for (int i = 0; i < 4; ++i)
             {
-                for (int j = 0; j < 4; ++j)
-                {
-                    for (int k = 0; k < 4; ++k)
-                    {
-                        out[4 * i + j] += rhs[4 * k + j] * lhs[4 * i + k];
-                    }
-                }
+                const __m128 left = Ps2VuNormalize4(_mm_loadu_ps(lhs + 4 * i));
+                _mm_storeu_ps(out + 4 * i, applyVuMatrix(right, left));
             }
         }
 
@@ -151,21 +215,14 @@ namespace ps2_stubs
         // x/y to 12.4 fixed point (x16) unconditionally. z/w take the same
         // x16 conversion when fullFtoi4 is set; otherwise they are plain
         // integer-truncated (FTOI0) after the divide instead.
-        void rotTransPersOne(const float (&m)[16], const float (&v)[4], bool fullFtoi4, int32_t (&out)[4])
-        {
-            float t[4];
-            t[0] = (m[0] * v[0]) + (m[4] * v[1]) + (m[8] * v[2]) + (m[12] * v[3]);
-            t[1] = (m[1] * v[0]) + (m[5] * v[1]) + (m[9] * v[2]) + (m[13] * v[3]);
-            t[2] = (m[2] * v[0]) + (m[6] * v[1]) + (m[10] * v[2]) + (m[14] * v[3]);
-            t[3] = (m[3] * v[0]) + (m[7] * v[1]) + (m[11] * v[2]) + (m[15] * v[3]);
-            const float q = (t[3] != 0.0f) ? (1.0f / t[3]) : 0.0f;
-            t[0] *= q;
-            t[1] *= q;
-            t[2] *= q;
-            out[0] = static_cast<int32_t>(t[0] * 16.0f);
-            out[1] = static_cast<int32_t>(t[1] * 16.0f);
-            out[2] = fullFtoi4 ? static_cast<int32_t>(t[2] * 16.0f) : static_cast<int32_t>(t[2]);
-            out[3] = fullFtoi4 ? static_cast<int32_t>(t[3] * 16.0f) : static_cast<int32_t>(t[3]);
+        __m128i rotTransPersOne(const VuMatrix &m, __m128 v, bool fullFtoi4)
+        {
+            __m128 t = applyVuMatrix(m, v);
+            const float w = _mm_cvtss_f32(splatVuLane<3>(t));
+            const float q = (w != 0.0f) ? (1.0f / w) : 0.0f;
+            t = Ps2VuMul4(t, _mm_setr_ps(q, q, q, 1.0f));
+            const float zwScale = fullFtoi4 ? 16.0f : 1.0f;
+            return Ps2VuFtoi4(Ps2VuMul4(t, _mm_setr_ps(16.0f, 16.0f, zwScale, zwScale)));
         }
 
         // Guard-band proxy for the COP2 sticky clip flags: nonzero => the
@@ -196,14 +253,10 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t lhsAddr = getRegU32(ctx, 5);
         const uint32_t rhsAddr = getRegU32(ctx, 6);
-        float lhs[4]{}, rhs[4]{}, out[4]{};
-        if (readVuVec4f(rdram, lhsAddr, lhs) && readVuVec4f(rdram, rhsAddr, rhs))
+        __m128 lhs, rhs;
+        if (loadVuVec(rdram, lhsAddr, lhs) && loadVuVec(rdram, rhsAddr, rhs))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = lhs[i] + rhs[i];
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, Ps2VuAdd4(lhs, rhs));
         }
         setReturnS32(ctx, 0);
     }
@@ -213,18 +266,13 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t matrixAddr = getRegU32(ctx, 5);
         const uint32_t srcAddr = getRegU32(ctx, 6);
-        float matrix[16]{};
-        float src[4]{};
-        float out[4]{};
-        if (readVuMatrix4f(rdram, matrixAddr, matrix) && readVuVec4f(rdram, srcAddr, src))
+        VuMatrix matrix;
+        __m128 src;
+        if (loadVuMatrix(rdram, matrixAddr, matrix) && loadVuVec(rdram, srcAddr, src))
         {
             // Match libvux VuxApplyMatrix math while honoring the imported EE ABI:
             // a0=out, a1=matrix, a2=vector.
-            out[0] = (matrix[0] * src[0]) + (matrix[4] * src[1]) + (matrix[8] * src[2]) + (matrix[12] * src[3]);
-            out[1] = (matrix[1] * src[0]) + (matrix[5] * src[1]) + (matrix[9] * src[2]) + (matrix[13] * src[3]);
-            out[2] = (matrix[2] * src[0]) + (matrix[6] * src[1]) + (matrix[10] * src[2]) + (matrix[14] * src[3]);
-            out[3] = (matrix[3] * src[0]) + (matrix[7] * src[1]) + (matrix[11] * src[2]) + (matrix[15] * src[3]);
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, applyVuMatrix(matrix, src));
         }
         setReturnS32(ctx, 0);
     }
@@ -282,19 +330,14 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        const float lo = ctx ? ctx->f[12] : 0.0f;
-        const float hi = ctx ? ctx->f[13] : 0.0f;
-        float src[4]{}, out[4]{};
-        if (readVuVec4f(rdram, srcAddr, src))
+        const __m128 lo = _mm_set1_ps(Ps2VuNormalizeOperand(ctx ? ctx->f[12] : 0.0f));
+        const __m128 hi = _mm_set1_ps(Ps2VuNormalizeOperand(ctx ? ctx->f[13] : 0.0f));
+        __m128 src;
+        if (loadVuVec(rdram, srcAddr, src))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                float v = src[i];
-                v = (v < lo) ? lo : v;
-                v = (v > hi) ? hi : v;
-                out[i] = v;
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            // Operand order keeps the scalar (v < lo ? lo : v) tie behavior.
+            const __m128 out = _mm_min_ps(hi, _mm_max_ps(lo, src));
+            (void)storeVuVec(rdram, dstAddr, out);
         }
         setReturnS32(ctx, 0);
     }
@@ -306,22 +349,22 @@ namespace ps2_stubs
         const uint32_t matAddr = getRegU32(ctx, 6);
         uint32_t vAddr = getRegU32(ctx, 7);
         const int32_t count = static_cast<int32_t>(getRegU32(ctx, 8));
-        float lo[4]{}, hi[4]{}, m[16]{};
+        __m128 lo, hi;
+        VuMatrix m;
         int32_t result = 0;
-        if (readVuVec4f(rdram, loAddr, lo) && readVuVec4f(rdram, hiAddr, hi) && readVuMatrix4f(rdram, matAddr, m))
+        if (loadVuVec(rdram, loAddr, lo) && loadVuVec(rdram, hiAddr, hi) && loadVuMatrix(rdram, matAddr, m))
         {
             result = 1;
             for (int32_t i = 0; i < count; ++i)
             {
-                float v[4]{};
-                if (!readVuVec4f(rdram, vAddr, v))
+                __m128 v;
+                if (!loadVuVec(rdram, vAddr, v))
                     break;
-                const float tx = (m[0] * v[0]) + (m[4] * v[1]) + (m[8] * v[2]) + (m[12] * v[3]);
-                const float ty = (m[1] * v[0]) + (m[5] * v[1]) + (m[9] * v[2]) + (m[13] * v[3]);
-                const float tw = (m[3] * v[0]) + (m[7] * v[1]) + (m[11] * v[2]) + (m[15] * v[3]);
-                const bool outsideX = (tx < lo[0] * tw) || (tx > hi[0] * tw);
-                const bool outsideY = (ty < lo[1] * tw) || (ty > hi[1] * tw);
-                if (!outsideX && !outsideY)
+                const __m128 t = applyVuMatrix(m, v);
+                const __m128 tw = splatVuLane<3>(t);
+                const __m128 outside = _mm_or_ps(_mm_cmplt_ps(t, Ps2VuMul4(lo, tw)),
+                                                 _mm_cmpgt_ps(t, Ps2VuMul4(hi, tw)));
+                if ((_mm_movemask_ps(outside) & 0x3) == 0)
                 {
                     result = 0;
                     break;
@@ -410,15 +453,11 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
         const float divisor = ctx ? ctx->f[12] : 1.0f;
-        float src[4]{}, out[4]{};
-        if (readVuVec4f(rdram, srcAddr, src))
+        __m128 src;
+        if (loadVuVec(rdram, srcAddr, src))
         {
-            const float q = (divisor != 0.0f) ? (1.0f / divisor) : 0.0f;
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = src[i] * q;
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            const __m128 q = _mm_set1_ps(Ps2VuNormalizeOperand((divisor != 0.0f) ? (1.0f / divisor) : 0.0f));
+            (void)storeVuVec(rdram, dstAddr, Ps2VuMul4(src, q));
         }
         setReturnS32(ctx, 0);
     }
@@ -428,15 +467,11 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
         const float divisor = ctx ? ctx->f[12] : 1.0f;
-        float src[4]{}, out[4]{};
-        if (readVuVec4f(rdram, srcAddr, src))
-        {
-            const float q = (divisor != 0.0f) ? (1.0f / divisor) : 0.0f;
-            out[0] = src[0] * q;
-            out[1] = src[1] * q;
-            out[2] = src[2] * q;
-            out[3] = src[3];
-            (void)writeVuVec4f(rdram, dstAddr, out);
+        __m128 src;
+        if (loadVuVec(rdram, srcAddr, src))
+        {
+            const __m128 q = _mm_set1_ps(Ps2VuNormalizeOperand((divisor != 0.0f) ? (1.0f / divisor) : 0.0f));
+            (void)storeVuVec(rdram, dstAddr, _mm_blend_ps(Ps2VuMul4(src, q), src, 0x8));
         }
         setReturnS32(ctx, 0);
     }
@@ -515,15 +550,10 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        float src[4]{};
-        int32_t out[4]{};
-        if (readVuVec4f(rdram, srcAddr, src))
+        __m128 src;
+        if (loadVuVec(rdram, srcAddr, src))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = static_cast<int32_t>(src[i]);
-            }
-            (void)writeVuVec4i(rdram, dstAddr, out);
+            (void)storeVuVecInt(rdram, dstAddr, Ps2VuFtoi4(src));
         }
         setReturnS32(ctx, 0);
     }
@@ -532,15 +562,10 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        float src[4]{};
-        int32_t out[4]{};
-        if (readVuVec4f(rdram, srcAddr, src))
+        __m128 src;
+        if (loadVuVec(rdram, srcAddr, src))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = static_cast<int32_t>(src[i] * 16.0f);
-            }
-            (void)writeVuVec4i(rdram, dstAddr, out);
+            (void)storeVuVecInt(rdram, dstAddr, Ps2VuFtoi4(Ps2VuMul4(src, _mm_set1_ps(16.0f))));
         }
         setReturnS32(ctx, 0);
     }
@@ -570,16 +595,13 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t aAddr = getRegU32(ctx, 5);
         const uint32_t bAddr = getRegU32(ctx, 6);
-        const float t = ctx ? ctx->f[12] : 0.0f;
-        float a[4]{}, b[4]{}, out[4]{};
-        if (readVuVec4f(rdram, aAddr, a) && readVuVec4f(rdram, bAddr, b))
+        const float t = Ps2VuNormalizeOperand(ctx ? ctx->f[12] : 0.0f);
+        __m128 a, b;
+        if (loadVuVec(rdram, aAddr, a) && loadVuVec(rdram, bAddr, b))
         {
             const float invT = 1.0f - t;
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = (a[i] * t) + (b[i] * invT);
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            const __m128 lerp = Ps2VuAdd4(Ps2VuMul4(a, _mm_set1_ps(t)), Ps2VuMul4(b, _mm_set1_ps(invT)));
+            (void)storeVuVec(rdram, dstAddr, lerp);
         }
         setReturnS32(ctx, 0);
     }
@@ -589,16 +611,13 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t aAddr = getRegU32(ctx, 5);
         const uint32_t bAddr = getRegU32(ctx, 6);
-        const float t = ctx ? ctx->f[12] : 0.0f;
-        float a[4]{}, b[4]{}, out[4]{};
-        if (readVuVec4f(rdram, aAddr, a) && readVuVec4f(rdram, bAddr, b))
+        const float t = Ps2VuNormalizeOperand(ctx ? ctx->f[12] : 0.0f);
+        __m128 a, b;
+        if (loadVuVec(rdram, aAddr, a) && loadVuVec(rdram, bAddr, b))
         {
             const float invT = 1.0f - t;
-            out[0] = (a[0] * t) + (b[0] * invT);
-            out[1] = (a[1] * t) + (b[1] * invT);
-            out[2] = (a[2] * t) + (b[2] * invT);
-            out[3] = a[3];
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            const __m128 lerp = Ps2VuAdd4(Ps2VuMul4(a, _mm_set1_ps(t)), Ps2VuMul4(b, _mm_set1_ps(invT)));
+            (void)storeVuVec(rdram, dstAddr, _mm_blend_ps(lerp, a, 0x8));
         }
         setReturnS32(ctx, 0);
     }
@@ -620,15 +639,10 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        int32_t src[4]{};
-        float out[4]{};
-        if (readVuVec4i(rdram, srcAddr, src))
+        __m128i src;
+        if (loadVuVecInt(rdram, srcAddr, src))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = static_cast<float>(src[i]);
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, _mm_cvtepi32_ps(src));
         }
         setReturnS32(ctx, 0);
     }
@@ -637,15 +651,10 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        int32_t src[4]{};
-        float out[4]{};
-        if (readVuVec4i(rdram, srcAddr, src))
+        __m128i src;
+        if (loadVuVecInt(rdram, srcAddr, src))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = static_cast<float>(src[i]) / 4096.0f;
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, Ps2VuMul4(_mm_cvtepi32_ps(src), _mm_set1_ps(1.0f / 4096.0f)));
         }
         setReturnS32(ctx, 0);
     }
@@ -654,15 +663,10 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        int32_t src[4]{};
-        float out[4]{};
-        if (readVuVec4i(rdram, srcAddr, src))
+        __m128i src;
+        if (loadVuVecInt(rdram, srcAddr, src))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = static_cast<float>(src[i]) / 16.0f;
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, Ps2VuMul4(_mm_cvtepi32_ps(src), _mm_set1_ps(1.0f / 16.0f)));
         }
         setReturnS32(ctx, 0);
     }
@@ -713,14 +717,10 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t lhsAddr = getRegU32(ctx, 5);
         const uint32_t rhsAddr = getRegU32(ctx, 6);
-        float lhs[4]{}, rhs[4]{}, out[4]{};
-        if (readVuVec4f(rdram, lhsAddr, lhs) && readVuVec4f(rdram, rhsAddr, rhs))
+        __m128 lhs, rhs;
+        if (loadVuVec(rdram, lhsAddr, lhs) && loadVuVec(rdram, rhsAddr, rhs))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = lhs[i] * rhs[i];
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, Ps2VuMul4(lhs, rhs));
         }
         setReturnS32(ctx, 0);
     }
@@ -729,19 +729,20 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        float src[4]{}, out[4]{};
-        if (readVuVec4f(rdram, srcAddr, src))
+        __m128 src;
+        if (loadVuVec(rdram, srcAddr, src))
         {
-            const float len = std::sqrt((src[0] * src[0]) + (src[1] * src[1]) + (src[2] * src[2]) + (src[3] * src[3]));
+            // The length is summed x, y, z, w in order; a horizontal add would
+            // pair the lanes differently and round differently.
+            float s[4];
+            _mm_storeu_ps(s, Ps2VuMul4(src, src));
+            const float len = std::sqrt(s[0] + s[1] + s[2] + s[3]);
+            __m128 out = _mm_setzero_ps();
             if (len > 1.0e-6f)
             {
-                const float invLen = 1.0f / len;
-                for (int i = 0; i < 4; ++i)
-                {
-                    out[i] = src[i] * invLen;
-                }
+                out = Ps2VuMul4(src, _mm_set1_ps(1.0f / len));
             }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, out);
         }
         setReturnS32(ctx, 0);
     }
@@ -791,14 +792,15 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t lhsAddr = getRegU32(ctx, 5);
         const uint32_t rhsAddr = getRegU32(ctx, 6);
-        float lhs[4]{}, rhs[4]{}, out[4]{};
-        if (readVuVec4f(rdram, lhsAddr, lhs) && readVuVec4f(rdram, rhsAddr, rhs))
+        __m128 lhs, rhs;
+        if (loadVuVec(rdram, lhsAddr, lhs) && loadVuVec(rdram, rhsAddr, rhs))
         {
-            out[0] = (lhs[1] * rhs[2]) - (lhs[2] * rhs[1]);
-            out[1] = (lhs[2] * rhs[0]) - (lhs[0] * rhs[2]);
-            out[2] = (lhs[0] * rhs[1]) - (lhs[1] * rhs[0]);
-            out[3] = 0.0f;
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            const __m128 lhsYzx = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 lhsZxy = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 1, 0, 2));
+            const __m128 rhsYzx = _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 rhsZxy = _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 1, 0, 2));
+            const __m128 cross = Ps2VuSub4(Ps2VuMul4(lhsYzx, rhsZxy), Ps2VuMul4(lhsZxy, rhsYzx));
+            (void)storeVuVec(rdram, dstAddr, _mm_blend_ps(cross, _mm_setzero_ps(), 0x8));
         }
         setReturnS32(ctx, 0);
     }
@@ -889,12 +891,11 @@ namespace ps2_stubs
         const uint32_t matAddr = getRegU32(ctx, 5);
         const uint32_t vAddr = getRegU32(ctx, 6);
         const bool fullFtoi4 = (getRegU32(ctx, 7) != 0);
-        float m[16]{}, v[4]{};
-        if (readVuMatrix4f(rdram, matAddr, m) && readVuVec4f(rdram, vAddr, v))
+        VuMatrix m;
+        __m128 v;
+        if (loadVuMatrix(rdram, matAddr, m) && loadVuVec(rdram, vAddr, v))
         {
-            int32_t out[4]{};
-            rotTransPersOne(m, v, fullFtoi4, out);
-            (void)writeVuVec4i(rdram, dstAddr, out);
+            (void)storeVuVecInt(rdram, dstAddr, rotTransPersOne(m, v, fullFtoi4));
         }
         setReturnS32(ctx, 0);
     }
@@ -906,18 +907,16 @@ namespace ps2_stubs
         uint32_t vAddr = getRegU32(ctx, 6);
         const int32_t count = static_cast<int32_t>(getRegU32(ctx, 7));
         const bool fullFtoi4 = (getRegU32(ctx, 8) != 0);
-        float m[16]{};
-        if (readVuMatrix4f(rdram, matAddr, m))
+        VuMatrix m;
+        if (loadVuMatrix(rdram, matAddr, m))
         {
             uint32_t outAddr = dstAddr;
             for (int32_t i = 0; i < count; ++i)
             {
-                float v[4]{};
-                if (!readVuVec4f(rdram, vAddr, v))
+                __m128 v;
+                if (!loadVuVec(rdram, vAddr, v))
                     break;
-                int32_t out[4]{};
-                rotTransPersOne(m, v, fullFtoi4, out);
-                (void)writeVuVec4i(rdram, outAddr, out);
+                (void)storeVuVecInt(rdram, outAddr, rotTransPersOne(m, v, fullFtoi4));
                 vAddr += 16u;
                 outAddr += 16u;
             }
@@ -929,7 +928,7 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        float src[4]{}, out[4]{};
+        __m128 src;
         float scale = ctx ? ctx->f[12] : 0.0f;
         if (scale == 0.0f)
         {
@@ -941,13 +940,9 @@ namespace ps2_stubs
             }
         }
 
-        if (readVuVec4f(rdram, srcAddr, src))
+        if (loadVuVec(rdram, srcAddr, src))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = src[i] * scale;
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, Ps2VuMul4(src, _mm_set1_ps(Ps2VuNormalizeOperand(scale))));
         }
         setReturnS32(ctx, 0);
     }
@@ -956,15 +951,11 @@ namespace ps2_stubs
     {
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t srcAddr = getRegU32(ctx, 5);
-        const float scale = ctx ? ctx->f[12] : 0.0f;
-        float src[4]{}, out[4]{};
-        if (readVuVec4f(rdram, srcAddr, src))
-        {
-            out[0] = src[0] * scale;
-            out[1] = src[1] * scale;
-            out[2] = src[2] * scale;
-            out[3] = src[3];
-            (void)writeVuVec4f(rdram, dstAddr, out);
+        const __m128 scale = _mm_set1_ps(Ps2VuNormalizeOperand(ctx ? ctx->f[12] : 0.0f));
+        __m128 src;
+        if (loadVuVec(rdram, srcAddr, src))
+        {
+            (void)storeVuVec(rdram, dstAddr, _mm_blend_ps(Ps2VuMul4(src, scale), src, 0x8));
         }
         setReturnS32(ctx, 0);
     }
@@ -974,14 +965,10 @@ namespace ps2_stubs
         const uint32_t dstAddr = getRegU32(ctx, 4);
         const uint32_t lhsAddr = getRegU32(ctx, 5);
         const uint32_t rhsAddr = getRegU32(ctx, 6);
-        float lhs[4]{}, rhs[4]{}, out[4]{};
-        if (readVuVec4f(rdram, lhsAddr, lhs) && readVuVec4f(rdram, rhsAddr, rhs))
+        __m128 lhs, rhs;
+        if (loadVuVec(rdram, lhsAddr, lhs) && loadVuVec(rdram, rhsAddr, rhs))
         {
-            for (int i = 0; i < 4; ++i)
-            {
-                out[i] = lhs[i] - rhs[i];
-            }
-            (void)writeVuVec4f(rdram, dstAddr, out);
+            (void)storeVuVec(rdram, dstAddr, Ps2VuSub4(lhs, rhs));
         }
         setReturnS32(ctx, 0);
     }
@@ -1012,13 +999,16 @@ namespace ps2_stubs
         float out[16]{};
         if (readVuMatrix4f(rdram, srcAddr, src))
         {
-            for (int row = 0; row < 4; ++row)
-            {
-                for (int col = 0; col < 4; ++col)
-                {
-                    out[4 * row + col] = src[4 * col + row];
-                }
-            }
+            // A pure move: lanes are shuffled, not normalized.
+            __m128 row0 = _mm_loadu_ps(src);
+            __m128 row1 = _mm_loadu_ps(src + 4);
+            __m128 row2 = _mm_loadu_ps(src + 8);
+            __m128 row3 = _mm_loadu_ps(src + 12);
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+            _mm_storeu_ps(out, row0);
+            _mm_storeu_ps(out + 4, row1);
+            _mm_storeu_ps(out + 8, row2);
+            _mm_storeu_ps(out + 12, row3);
             (void)writeVuMatrix4f(rdram, dstAddr, out);
         }
         setReturnS32(ctx, 0);
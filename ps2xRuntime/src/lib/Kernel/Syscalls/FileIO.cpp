@@ -1,44 +1,150 @@
 #include "Common.h"
 #include "FileIO.h"
 
+#include <cstdlib>
+
 namespace ps2_syscalls
 {
-    static int allocatePs2Fd(FILE *file)
+    static std::atomic<bool> g_fioVagStreaming{false};
+    static constexpr uint64_t kVagStreamMaxBytes = 16 * 1024 * 1024;
+
+    void setFioVagStreaming(bool enabled)
+    {
+        g_fioVagStreaming.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool configureFioVagStreamingFromEnvironment()
+    {
+        if (const char *value = std::getenv("PS2X_FIO_VAG_STREAMING"))
+        {
+            const std::string setting(value);
+            setFioVagStreaming(setting == "1" || setting == "on" || setting == "true");
+        }
+        return g_fioVagStreaming.load(std::memory_order_relaxed);
+    }
+
+    static FioDescriptor *findPs2Fd(int ps2Fd)
+    {
+        if (ps2Fd < kFioFirstFd || ps2Fd >= kFioFirstFd + static_cast<int>(kFioMaxDescriptors))
+            return nullptr;
+        return &g_fioDescriptors[static_cast<size_t>(ps2Fd - kFioFirstFd)];
+    }
+
+    // Claims the lowest free descriptor. The slot stays invisible to other fio
+    // calls until the caller marks it Open.
+    static int reservePs2Fd()
+    {
+        for (size_t i = 0; i < kFioMaxDescriptors; ++i)
+        {
+            FioDescriptorState expected = FioDescriptorState::Free;
+            if (g_fioDescriptors[i].state.compare_exchange_strong(expected, FioDescriptorState::Opening,
+                                                                  std::memory_order_acq_rel))
+            {
+                return kFioFirstFd + static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Returns the descriptor with its mutex held, or null if ps2Fd is not open.
+    static FioDescriptor *lockPs2Fd(int ps2Fd, std::unique_lock<std::mutex> &lock)
+    {
+        FioDescriptor *desc = findPs2Fd(ps2Fd);
+        if (!desc || desc->state.load(std::memory_order_acquire) != FioDescriptorState::Open)
+            return nullptr;
+
+        lock = std::unique_lock<std::mutex>(desc->mutex);
+        if (desc->state.load(std::memory_order_acquire) != FioDescriptorState::Open)
+        {
+            lock.unlock();
+            return nullptr;
+        }
+        return desc;
+    }
+
+    static void syncStreamPosition(FioDescriptor &desc)
     {
-        if (!file)
-            return -1;
+        const long pos = ::ftell(desc.stream);
+        if (pos >= 0)
+            desc.position.store(static_cast<uint64_t>(pos), std::memory_order_relaxed);
+    }
 
-        std::lock_guard<std::mutex> lock(g_fd_mutex);
-        int fd = g_nextFd++;
-        g_fileDescriptors[fd] = file;
-        return fd;
+    static bool hasVagMagic(const uint8_t *data)
+    {
+        const uint32_t magic = (static_cast<uint32_t>(data[0]) << 24) |
+                               (static_cast<uint32_t>(data[1]) << 16) |
+                               (static_cast<uint32_t>(data[2]) << 8) |
+                               static_cast<uint32_t>(data[3]);
+        const uint32_t magicLE = (static_cast<uint32_t>(data[3]) << 24) |
+                                 (static_cast<uint32_t>(data[2]) << 16) |
+                                 (static_cast<uint32_t>(data[1]) << 8) |
+                                 static_cast<uint32_t>(data[0]);
+        return magic == 0x56414770u || magicLE == 0x56414770u;
     }
 
-    static FILE *getHostFile(int ps2Fd)
+    // Banks the samples the audio backend has received so far, or drops
+    // them when the header never parsed.
+    static void finishVagStream(FioDescriptor &desc)
     {
-        std::lock_guard<std::mutex> lock(g_fd_mutex);
-        auto it = g_fileDescriptors.find(ps2Fd);
-        if (it != g_fileDescriptors.end())
+        if (desc.vagStream && desc.vagBackend)
         {
-            return it->second;
+            desc.vagStream->flush();
+            if (desc.vagStream->headerValid())
+                desc.vagBackend->finishVagStream(desc.vagStreamId, desc.vagStream->sampleRate(),
+                                                 desc.vagStream->contentKey());
+            else
+                desc.vagBackend->abortVagStream(desc.vagStreamId);
         }
-        return nullptr;
+        desc.vagStream.reset();
+        desc.vagBackend = nullptr;
     }
 
-    static void releasePs2Fd(int ps2Fd)
+    static void dropVagStream(FioDescriptor &desc)
     {
-        std::lock_guard<std::mutex> lock(g_fd_mutex);
-        g_fileDescriptors.erase(ps2Fd);
+        if (desc.vagStream && desc.vagBackend)
+            desc.vagBackend->abortVagStream(desc.vagStreamId);
+        desc.vagStream.reset();
+        desc.vagBackend = nullptr;
     }
 
-    struct VagAccumEntry
+    // Feeds one fioRead result to the descriptor's VAG decoder, which passes
+    // each decoded chunk straight on to the audio backend. A stream starts at
+    // a read of offset 0 that carries the VAG magic and only continues while
+    // the guest keeps reading sequentially.
+    static void streamVagChunk(FioDescriptor &desc, uint64_t offset, const uint8_t *data, size_t size,
+                               uint32_t bufAddr, PS2Runtime *runtime)
     {
-        std::vector<uint8_t> data;
-        uint32_t firstBufAddr = 0;
-    };
-    static std::unordered_map<int, VagAccumEntry> g_vagAccum;
-    static std::mutex g_vagAccumMutex;
-    static constexpr size_t kVagAccumMaxBytes = 16 * 1024 * 1024;
+        if (!desc.vagStream)
+        {
+            if (!runtime || offset != 0 || size < 4 || !hasVagMagic(data))
+                return;
+            PS2AudioBackend *backend = &runtime->audioBackend();
+            const uint64_t streamId = backend->beginVagStream(bufAddr);
+            desc.vagStream = std::make_unique<PS2VagStreamDecoder>(
+                [backend, streamId](const int16_t *samples, size_t count)
+                { backend->appendVagStream(streamId, samples, count); });
+            desc.vagBackend = backend;
+            desc.vagStreamId = streamId;
+            desc.vagStreamedBytes = 0;
+        }
+        else if (offset != desc.vagStreamedBytes)
+        {
+            dropVagStream(desc);
+            return;
+        }
+
+        const size_t take = static_cast<size_t>(std::min<uint64_t>(size, kVagStreamMaxBytes - desc.vagStreamedBytes));
+        desc.vagStream->feed(data, take);
+        desc.vagStreamedBytes += take;
+        if (desc.vagStream->failed())
+        {
+            dropVagStream(desc);
+        }
+        else if (desc.vagStream->complete() || desc.vagStreamedBytes >= kVagStreamMaxBytes)
+        {
+            finishVagStream(desc);
+        }
+    }
 
     static const char *translateFioMode(int ps2Flags)
     {
@@ -97,23 +203,35 @@ namespace ps2_syscalls
         const char *mode = translateFioMode(flags);
         RUNTIME_LOG("fioOpen: '" << hostPath << "' flags=0x" << std::hex << flags << std::dec << " mode='" << mode << "'");
 
-        FILE *fp = ::fopen(hostPath.c_str(), mode);
-        if (!fp)
-        {
-            std::cerr << "fioOpen error: fopen failed for '" << hostPath << "': " << strerror(errno) << std::endl;
-            setReturnS32(ctx, -1); // e.g., -ENOENT, -EACCES
-            return;
-        }
-
-        int ps2Fd = allocatePs2Fd(fp);
+        int ps2Fd = reservePs2Fd();
         if (ps2Fd < 0)
         {
             std::cerr << "fioOpen error: Failed to allocate PS2 file descriptor" << std::endl;
-            ::fclose(fp);
             setReturnS32(ctx, -1); // e.g., -EMFILE
             return;
         }
 
+        FioDescriptor &desc = *findPs2Fd(ps2Fd);
+        {
+            std::lock_guard<std::mutex> lock(desc.mutex);
+            desc.position.store(0, std::memory_order_relaxed);
+            // Read-only regular files take the positional path; anything else
+            // (writers, directories, devices) goes through stdio.
+            const bool readOnly = (flags & PS2_FIO_O_WRONLY) == 0;
+            if (!readOnly || !desc.reader.open(hostPath))
+            {
+                desc.stream = ::fopen(hostPath.c_str(), mode);
+            }
+            if (!desc.reader.isOpen() && !desc.stream)
+            {
+                std::cerr << "fioOpen error: fopen failed for '" << hostPath << "': " << strerror(errno) << std::endl;
+                desc.state.store(FioDescriptorState::Free, std::memory_order_release);
+                setReturnS32(ctx, -1); // e.g., -ENOENT, -EACCES
+                return;
+            }
+        }
+        desc.state.store(FioDescriptorState::Open, std::memory_order_release);
+
         // returns the PS2 file descriptor
         setReturnS32(ctx, ps2Fd);
     }
@@ -122,44 +240,30 @@ namespace ps2_syscalls
     {
         int ps2Fd = (int)getRegU32(ctx, 4);
 
-        FILE *fp = getHostFile(ps2Fd);
-        if (!fp)
+        FioDescriptor *desc = findPs2Fd(ps2Fd);
+        FioDescriptorState expected = FioDescriptorState::Open;
+        if (!desc || !desc->state.compare_exchange_strong(expected, FioDescriptorState::Closing,
+                                                          std::memory_order_acq_rel))
         {
             std::cerr << "fioClose warning: Invalid PS2 file descriptor " << ps2Fd << std::endl;
             setReturnS32(ctx, -1);
             return;
         }
 
-        int ret = ::fclose(fp);
-        releasePs2Fd(ps2Fd);
-
+        int ret = 0;
         {
-            std::lock_guard<std::mutex> lock(g_vagAccumMutex);
-            auto it = g_vagAccum.find(ps2Fd);
-            if (it != g_vagAccum.end())
+            // Waits for any call still working on this descriptor.
+            std::lock_guard<std::mutex> lock(desc->mutex);
+            desc->reader.close();
+            if (desc->stream)
             {
-                VagAccumEntry &e = it->second;
-                if (e.data.size() >= 48)
-                {
-                    const uint32_t magic = (static_cast<uint32_t>(e.data[0]) << 24) |
-                                           (static_cast<uint32_t>(e.data[1]) << 16) |
-                                           (static_cast<uint32_t>(e.data[2]) << 8) |
-                                           static_cast<uint32_t>(e.data[3]);
-                    const uint32_t magicLE = (static_cast<uint32_t>(e.data[3]) << 24) |
-                                             (static_cast<uint32_t>(e.data[2]) << 16) |
-                                             (static_cast<uint32_t>(e.data[1]) << 8) |
-                                             static_cast<uint32_t>(e.data[0]);
-                    if (magic == 0x56414770u || magicLE == 0x56414770u)
-                    {
-                        if (runtime)
-                            runtime->audioBackend().onVagTransferFromBuffer(
-                                e.data.data(), static_cast<uint32_t>(e.data.size()),
-                                e.firstBufAddr ? e.firstBufAddr : 0u);
-                    }
-                }
-                g_vagAccum.erase(it);
+                ret = ::fclose(desc->stream);
+                desc->stream = nullptr;
             }
+            finishVagStream(*desc);
+            desc->position.store(0, std::memory_order_relaxed);
         }
+        desc->state.store(FioDescriptorState::Free, std::memory_order_release);
 
         setReturnS32(ctx, ret == 0 ? 0 : -1);
     }
@@ -171,7 +275,8 @@ namespace ps2_syscalls
         size_t size = getRegU32(ctx, 6);      // $a2
 
         uint8_t *hostBuf = getMemPtr(rdram, bufAddr);
-        FILE *fp = getHostFile(ps2Fd);
+        std::unique_lock<std::mutex> lock;
+        FioDescriptor *desc = lockPs2Fd(ps2Fd, lock);
 
         if (!hostBuf)
         {
@@ -179,7 +284,7 @@ namespace ps2_syscalls
             setReturnS32(ctx, -1); // -EFAULT
             return;
         }
-        if (!fp)
+        if (!desc)
         {
             std::cerr << "fioRead error: Invalid file descriptor " << ps2Fd << std::endl;
             setReturnS32(ctx, -1); // -EBADF
@@ -191,51 +296,39 @@ namespace ps2_syscalls
             return;
         }
 
+        const uint64_t offset = desc->position.load(std::memory_order_relaxed);
         size_t bytesRead = 0;
+        if (desc->reader.isOpen())
         {
-            std::lock_guard<std::mutex> lock(g_sys_fd_mutex);
-            bytesRead = fread(hostBuf, 1, size, fp);
+            if (!desc->reader.readAt(offset, hostBuf, size, bytesRead))
+            {
+                std::cerr << "fioRead error: read failed for fd " << ps2Fd << ": " << strerror(errno) << std::endl;
+                setReturnS32(ctx, -1);
+                return;
+            }
+            desc->position.store(offset + bytesRead, std::memory_order_relaxed);
         }
-        if (bytesRead > 0)
+        else
         {
-            ps2TraceGuestRangeWrite(rdram, bufAddr, static_cast<uint32_t>(bytesRead), "fioRead", ctx);
+            bytesRead = fread(hostBuf, 1, size, desc->stream);
+            if (bytesRead < size && ferror(desc->stream))
+            {
+                std::cerr << "fioRead error: fread failed for fd " << ps2Fd << ": " << strerror(errno) << std::endl;
+                clearerr(desc->stream);
+                setReturnS32(ctx, -1);
+                return;
+            }
+            syncStreamPosition(*desc);
         }
 
-        if (bytesRead < size && ferror(fp))
+        if (bytesRead > 0)
         {
-            std::cerr << "fioRead error: fread failed for fd " << ps2Fd << ": " << strerror(errno) << std::endl;
-            clearerr(fp);
-            setReturnS32(ctx, -1);
-            return;
+            ps2TraceGuestRangeWrite(rdram, bufAddr, static_cast<uint32_t>(bytesRead), "fioRead", ctx);
         }
 
+        if (g_fioVagStreaming.load(std::memory_order_relaxed) || desc->vagStream)
         {
-            std::lock_guard<std::mutex> lock(g_vagAccumMutex);
-            auto it = g_vagAccum.find(ps2Fd);
-            if (it != g_vagAccum.end())
-            {
-                VagAccumEntry &e = it->second;
-                if (e.data.size() + bytesRead <= kVagAccumMaxBytes)
-                    e.data.insert(e.data.end(), hostBuf, hostBuf + bytesRead);
-            }
-            else if (bytesRead >= 4)
-            {
-                const uint32_t magic = (static_cast<uint32_t>(hostBuf[0]) << 24) |
-                                       (static_cast<uint32_t>(hostBuf[1]) << 16) |
-                                       (static_cast<uint32_t>(hostBuf[2]) << 8) |
-                                       static_cast<uint32_t>(hostBuf[3]);
-                const uint32_t magicLE = (static_cast<uint32_t>(hostBuf[3]) << 24) |
-                                         (static_cast<uint32_t>(hostBuf[2]) << 16) |
-                                         (static_cast<uint32_t>(hostBuf[1]) << 8) |
-                                         static_cast<uint32_t>(hostBuf[0]);
-                if (magic == 0x56414770u || magicLE == 0x56414770u)
-                {
-                    VagAccumEntry &e = g_vagAccum[ps2Fd];
-                    e.firstBufAddr = bufAddr;
-                    if (bytesRead <= kVagAccumMaxBytes)
-                        e.data.assign(hostBuf, hostBuf + bytesRead);
-                }
-            }
+            streamVagChunk(*desc, offset, hostBuf, bytesRead, bufAddr, runtime);
         }
 
         setReturnS32(ctx, (int32_t)bytesRead);
@@ -254,8 +347,9 @@ namespace ps2_syscalls
             return;
         }
 
-        FILE *fp = getHostFile(ps2Fd);
-        if (!fp)
+        std::unique_lock<std::mutex> lock;
+        FioDescriptor *desc = lockPs2Fd(ps2Fd, lock);
+        if (!desc)
         {
             setReturnS32(ctx, -1); // -EFAULT
             return;
@@ -267,18 +361,21 @@ namespace ps2_syscalls
             return;
         }
 
-        size_t bytesWritten = 0;
+        if (!desc->stream)
         {
-            std::lock_guard<std::mutex> lock(g_sys_fd_mutex);
-            bytesWritten = ::fwrite(hostBuf, 1, size, fp);
-            if (bytesWritten < size && ferror(fp))
-            {
-                clearerr(fp);
-                setReturnS32(ctx, -1); // -EIO, -ENOSPC etc.
-                return;
-            }
+            setReturnS32(ctx, -1); // -EBADF, opened read-only
+            return;
         }
 
+        size_t bytesWritten = ::fwrite(hostBuf, 1, size, desc->stream);
+        if (bytesWritten < size && ferror(desc->stream))
+        {
+            clearerr(desc->stream);
+            setReturnS32(ctx, -1); // -EIO, -ENOSPC etc.
+            return;
+        }
+        syncStreamPosition(*desc);
+
         // returns number of bytes written
         setReturnS32(ctx, (int32_t)bytesWritten);
     }
@@ -289,8 +386,9 @@ namespace ps2_syscalls
         int32_t offset = getRegU32(ctx, 5);  // $a1 (PS2 seems to use 32-bit offset here commonly)
         int whence = (int)getRegU32(ctx, 6); // $a2 (PS2 FIO_SEEK constants)
 
-        FILE *fp = getHostFile(ps2Fd);
-        if (!fp)
+        std::unique_lock<std::mutex> lock;
+        FioDescriptor *desc = lockPs2Fd(ps2Fd, lock);
+        if (!desc)
         {
             std::cerr << "fioLseek error: Invalid file descriptor " << ps2Fd << std::endl;
             setReturnS32(ctx, -1); // -EBADF
@@ -315,31 +413,49 @@ namespace ps2_syscalls
             return;
         }
 
-        if (::fseek(fp, static_cast<long>(offset), hostWhence) != 0)
-        {
-            std::cerr << "fioLseek error: fseek failed for fd " << ps2Fd << ": " << strerror(errno) << std::endl;
-            setReturnS32(ctx, -1); // Return error code
-            return;
-        }
-
-        long newPos = ::ftell(fp);
-        if (newPos < 0)
+        int64_t newPos = 0;
+        if (desc->reader.isOpen())
         {
-            std::cerr << "fioLseek error: ftell failed after fseek for fd " << ps2Fd << ": " << strerror(errno) << std::endl;
-            setReturnS32(ctx, -1);
+            int64_t base = 0;
+            if (hostWhence == SEEK_CUR)
+                base = static_cast<int64_t>(desc->position.load(std::memory_order_relaxed));
+            else if (hostWhence == SEEK_END)
+                base = static_cast<int64_t>(desc->reader.size());
+            newPos = base + offset;
+            if (newPos < 0)
+            {
+                std::cerr << "fioLseek error: Seek before start of file for fd " << ps2Fd << std::endl;
+                setReturnS32(ctx, -1); // -EINVAL
+                return;
+            }
         }
         else
         {
-            if (newPos > 0xFFFFFFFFL)
+            if (::fseek(desc->stream, static_cast<long>(offset), hostWhence) != 0)
             {
-                std::cerr << "fioLseek warning: New position exceeds 32-bit for fd " << ps2Fd << std::endl;
-                setReturnS32(ctx, -1);
+                std::cerr << "fioLseek error: fseek failed for fd " << ps2Fd << ": " << strerror(errno) << std::endl;
+                setReturnS32(ctx, -1); // Return error code
+                return;
             }
-            else
+
+            newPos = ::ftell(desc->stream);
+            if (newPos < 0)
             {
-                setReturnS32(ctx, (int32_t)newPos);
+                std::cerr << "fioLseek error: ftell failed after fseek for fd " << ps2Fd << ": " << strerror(errno) << std::endl;
+                setReturnS32(ctx, -1);
+                return;
             }
         }
+
+        if (newPos > 0xFFFFFFFFLL)
+        {
+            std::cerr << "fioLseek warning: New position exceeds 32-bit for fd " << ps2Fd << std::endl;
+            setReturnS32(ctx, -1);
+            return;
+        }
+
+        desc->position.store(static_cast<uint64_t>(newPos), std::memory_order_relaxed);
+        setReturnS32(ctx, (int32_t)newPos);
     }
 
     void fioMkdir(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
 
-inline std::unordered_map<int, FILE *> g_fileDescriptors;
-inline int g_nextFd = 3; // Start after stdin, stdout, stderr
+#include "../../../ps2_host_file.h"
+#include "runtime/ps2_audio.h"
 
 // Thread status
 #define THS_RUN 0x01
@@ -156,7 +161,34 @@ static constexpr uint32_t kFioSoIROth = 0x0004;
 static constexpr uint32_t kFioSoIWOth = 0x0002;
 static constexpr uint32_t kFioSoIXOth = 0x0001;
 
-inline std::mutex g_fd_mutex;
+enum class FioDescriptorState : uint8_t
+{
+    Free,
+    Opening,
+    Open,
+    Closing
+};
+
+// Guest fio descriptor. Read-only files are served with positional reads from
+// a PS2HostFile; every other mode keeps a stdio stream. All per-file state is
+// guarded by the descriptor's own mutex, so threads working on different
+// descriptors never wait on each other.
+struct FioDescriptor
+{
+    std::atomic<FioDescriptorState> state{FioDescriptorState::Free};
+    std::mutex mutex;
+    PS2HostFile reader;
+    FILE *stream = nullptr;
+    std::atomic<uint64_t> position{0}; // Written under mutex, read by the debug panel.
+    std::unique_ptr<PS2VagStreamDecoder> vagStream;
+    PS2AudioBackend *vagBackend = nullptr;
+    uint64_t vagStreamId = 0;
+    uint64_t vagStreamedBytes = 0;
+};
+
+inline constexpr int kFioFirstFd = 3; // Start after stdin, stdout, stderr
+inline constexpr size_t kFioMaxDescriptors = 128;
+inline std::array<FioDescriptor, kFioMaxDescriptors> g_fioDescriptors;
 
 struct RpcServerState
 {
@@ -659,37 +659,35 @@ namespace ps2_syscalls
                 return;
             }
 
-            GuestInvocation callback{};
-            callback.kind = GuestInvocationKind::RpcCallback;
-            callback.context = parent;
-            callback.context.pc = callbackFunction;
-            SET_GPR_U32(&callback.context, 4, endParameter);
-            SET_GPR_U32(&callback.context, 29, runtime->eeScheduler().invocationStackTop());
-            SET_GPR_U32(&callback.context, 31, 0u);
-            callback.onComplete = [completeClient](const R5900Context &, R5900Context &base)
+            EeScheduler &scheduler = runtime->eeScheduler();
+            GuestInvocationFrame callback = scheduler.acquireInvocationFrame(GuestInvocationKind::RpcCallback, parent);
+            callback->context.pc = callbackFunction;
+            SET_GPR_U32(&callback->context, 4, endParameter);
+            SET_GPR_U32(&callback->context, 29, scheduler.invocationStackTop());
+            SET_GPR_U32(&callback->context, 31, 0u);
+            callback->onComplete = [completeClient](const R5900Context &, R5900Context &base)
             {
                 completeClient(base, true);
             };
-            runtime->eeScheduler().invokeCurrent(std::move(callback));
+            scheduler.invokeCurrent(std::move(callback));
         };
 
         if (serverDispatched)
         {
-            GuestInvocation invocation{};
-            invocation.kind = GuestInvocationKind::RpcCallback;
-            invocation.context = *ctx;
-            invocation.context.pc = guestFunction;
-            SET_GPR_U32(&invocation.context, 4, guestA0);
-            SET_GPR_U32(&invocation.context, 5, guestA1);
-            SET_GPR_U32(&invocation.context, 6, guestA2);
-            SET_GPR_U32(&invocation.context, 7, guestA3);
-            SET_GPR_U32(&invocation.context, 29, runtime->eeScheduler().invocationStackTop());
-            SET_GPR_U32(&invocation.context, 31, 0u);
-            invocation.onComplete = [finishCall](const R5900Context &completed, R5900Context &parent)
+            EeScheduler &scheduler = runtime->eeScheduler();
+            GuestInvocationFrame invocation = scheduler.acquireInvocationFrame(GuestInvocationKind::RpcCallback, *ctx);
+            invocation->context.pc = guestFunction;
+            SET_GPR_U32(&invocation->context, 4, guestA0);
+            SET_GPR_U32(&invocation->context, 5, guestA1);
+            SET_GPR_U32(&invocation->context, 6, guestA2);
+            SET_GPR_U32(&invocation->context, 7, guestA3);
+            SET_GPR_U32(&invocation->context, 29, scheduler.invocationStackTop());
+            SET_GPR_U32(&invocation->context, 31, 0u);
+            invocation->onComplete = [finishCall](const R5900Context &completed, R5900Context &parent)
             {
                 finishCall(&completed, parent);
             };
-            runtime->eeScheduler().invokeCurrent(std::move(invocation));
+            scheduler.invokeCurrent(std::move(invocation));
         }
         finishCall(nullptr, *ctx);
     }
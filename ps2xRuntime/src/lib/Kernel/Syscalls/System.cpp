@@ -428,14 +428,12 @@ namespace ps2_syscalls
             return true;
         }
 
-        GuestInvocation invocation{};
-        invocation.kind = GuestInvocationKind::SyscallOverride;
-        invocation.tag = syscallNumber;
-        invocation.context = *ctx;
-        invocation.context.pc = handler;
-        SET_GPR_U32(&invocation.context, 29, scheduler.invocationStackTop());
-        SET_GPR_U32(&invocation.context, 31, 0u);
-        invocation.onComplete = [](const R5900Context &completed, R5900Context &parent)
+        GuestInvocationFrame invocation = scheduler.acquireInvocationFrame(GuestInvocationKind::SyscallOverride, *ctx);
+        invocation->tag = syscallNumber;
+        invocation->context.pc = handler;
+        SET_GPR_U32(&invocation->context, 29, scheduler.invocationStackTop());
+        SET_GPR_U32(&invocation->context, 31, 0u);
+        invocation->onComplete = [](const R5900Context &completed, R5900Context &parent)
         {
             parent.r[2] = completed.r[2];
         };
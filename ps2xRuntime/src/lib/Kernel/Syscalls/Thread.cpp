@@ -74,7 +74,7 @@ namespace ps2_syscalls
         {
             EeScheduler &ee = runtime->eeScheduler();
             const auto handlers = runtime->takeEeExitHandlers(tid);
-            std::vector<GuestInvocation> invocations;
+            std::vector<GuestInvocationFrame> invocations;
             invocations.reserve(handlers.size());
             for (const PS2Runtime::EeExitHandlerRegistration &handler : handlers)
             {
@@ -82,20 +82,18 @@ namespace ps2_syscalls
                 {
                     continue;
                 }
-                GuestInvocation invocation{};
-                invocation.kind = GuestInvocationKind::ExitHandler;
-                invocation.context = *ctx;
-                invocation.context.pc = handler.function;
-                SET_GPR_U32(&invocation.context, 4, handler.argument);
-                SET_GPR_U32(&invocation.context, 29, ee.invocationStackTop());
-                SET_GPR_U32(&invocation.context, 31, 0u);
+                GuestInvocationFrame invocation = ee.acquireInvocationFrame(GuestInvocationKind::ExitHandler, *ctx);
+                invocation->context.pc = handler.function;
+                SET_GPR_U32(&invocation->context, 4, handler.argument);
+                SET_GPR_U32(&invocation->context, 29, ee.invocationStackTop());
+                SET_GPR_U32(&invocation->context, 31, 0u);
                 invocations.push_back(std::move(invocation));
             }
             if (invocations.empty())
             {
                 ee.exitCurrent(deleteThread);
             }
-            invocations.back().onComplete = [runtime, deleteThread](const R5900Context &, R5900Context &)
+            invocations.back()->onComplete = [runtime, deleteThread](const R5900Context &, R5900Context &)
             {
                 runtime->eeScheduler().exitCurrent(deleteThread);
             };
@@ -424,14 +424,17 @@ namespace
     {
         if (pixels.empty() || width == 0u || height < 2u)
             return;
-        const std::vector<uint8_t> source = pixels;
+        // Every row of a line pair copies the same field row, and that row
+        // maps onto itself, so the doubling can run in place.
         for (uint32_t y = 0; y < height; ++y)
         {
             uint32_t sourceY = ((y >> 1u) << 1u) + (oddField ? 1u : 0u);
             if (sourceY >= height)
                 sourceY = height - 1u;
+            if (sourceY == y)
+                continue;
             std::memcpy(pixels.data() + y * kHostFrameWidth * 4u,
-                        source.data() + sourceY * kHostFrameWidth * 4u,
+                        pixels.data() + sourceY * kHostFrameWidth * 4u,
                         width * 4u);
         }
     }
@@ -1401,100 +1404,121 @@ void GSCpuBackend::UploadImage(const uint8_t *data, uint32_t sizeBytes)
 
     const uint32_t dbp = m_transfer.bitbltbuf.dbp;
     const uint32_t dbw = std::max<uint32_t>(m_transfer.bitbltbuf.dbw, 1u);
-    const uint8_t dpsm = m_transfer.bitbltbuf.dpsm;
+    const auto dpsm = static_cast<GSMem::PixelStorageMode>(m_transfer.bitbltbuf.dpsm);
     const uint32_t rrw = m_transfer.trxreg.rrw;
+    const uint32_t rrh = m_transfer.trxreg.rrh;
     const uint32_t dsax = m_transfer.trxpos.dsax;
-    uint32_t offset = 0u;
+    const uint32_t dsay = m_transfer.trxpos.dsay;
+    if (!GSMem::IsValidPsm(dpsm))
+        return;
 
-    auto advancePixel = [&](uint32_t count)
+    // Only whole pixels are consumed; a trailing partial pixel is dropped.
+    const uint32_t packedBits = static_cast<uint32_t>(GSMem::BitsPerPixel(dpsm));
+    const uint64_t packetPixels = (static_cast<uint64_t>(sizeBytes) * 8u) / packedBits;
+    const uint32_t pixels = static_cast<uint32_t>(
+        std::min<uint64_t>(packetPixels, m_transferState.totalPixels - m_transferState.copiedPixels));
+
+    auto decodePixels = [&](uint32_t first, uint32_t count, uint32_t *out)
     {
-        const uint32_t totalPixels = m_transferState.totalPixels;
-        m_transferState.copiedPixels =
-            std::min<uint32_t>(totalPixels, m_transferState.copiedPixels + count);
+        switch (packedBits)
+        {
+        case 32u:
+            std::memcpy(out, data + static_cast<size_t>(first) * 4u, static_cast<size_t>(count) * 4u);
+            break;
+        case 24u:
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const uint8_t *src = data + static_cast<size_t>(first + i) * 3u;
+                out[i] = static_cast<uint32_t>(src[0]) |
+                         (static_cast<uint32_t>(src[1]) << 8u) |
+                         (static_cast<uint32_t>(src[2]) << 16u);
+            }
+            break;
+        case 16u:
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint16_t value = 0u;
+                std::memcpy(&value, data + static_cast<size_t>(first + i) * 2u, sizeof(value));
+                out[i] = value;
+            }
+            break;
+        case 8u:
+            for (uint32_t i = 0; i < count; ++i)
+                out[i] = data[first + i];
+            break;
+        case 4u:
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const uint32_t pixel = first + i;
+                out[i] = (data[pixel >> 1u] >> ((pixel & 1u) * 4u)) & 0x0Fu;
+            }
+            break;
+        default:
+            break;
+        }
+    };
 
-        if (m_transferState.copiedPixels >= totalPixels)
+    auto advancePixels = [&](uint32_t count)
+    {
+        m_transferState.copiedPixels += count;
+        if (m_transferState.copiedPixels >= m_transferState.totalPixels)
         {
             m_transferState.direction = 3u;
             m_transferState.totalPixels = 0u;
             return;
         }
 
-        m_transferState.x = dsax + (m_transferState.copiedPixels % rrw);
-        m_transferState.y = m_transfer.trxpos.dsay + (m_transferState.copiedPixels / rrw);
+        const uint32_t row = m_transferState.copiedPixels / rrw;
+        m_transferState.x = dsax + (m_transferState.copiedPixels - row * rrw);
+        m_transferState.y = dsay + row;
     };
 
-    while (offset < sizeBytes && m_transferState.direction == 0u)
+    // Whole rows of blocks are swizzled a block at a time. The block path is
+    // only offered when no two pixels of the rectangle alias, so writing the
+    // band out of stream order cannot change the result.
+    const GSMem::Extent2D block = GSMem::TransferBlockExtent(dpsm, dbp, dbw, dsax, dsay, rrw, rrh);
+    const uint32_t blockStart = block.x != 0u ? ((dsax + block.x - 1u) / block.x) * block.x : 0u;
+    const uint32_t blockEnd = block.x != 0u ? ((dsax + rrw) / block.x) * block.x : 0u;
+    const bool useBlocks = block.x != 0u && blockStart < blockEnd;
+
+    uint32_t consumed = 0u;
+    while (consumed < pixels)
     {
-        switch (dpsm)
-        {
-        case GS_PSM_CT32:
-        case GS_PSM_Z32:
-        {
-            if (sizeBytes - offset < 4u)
-                return;
-            uint32_t value = 0u;
-            std::memcpy(&value, data + offset, sizeof(value));
-            WriteVramUnlocked(dpsm, dbp, dbw, m_transferState.x, m_transferState.y, value);
-            offset += 4u;
-            advancePixel(1u);
-            break;
-        }
-        case GS_PSM_CT24:
-        case GS_PSM_Z24:
-        {
-            if (sizeBytes - offset < 3u)
-                return;
-            const uint32_t value = static_cast<uint32_t>(data[offset]) |
-                                   (static_cast<uint32_t>(data[offset + 1u]) << 8u) |
-                                   (static_cast<uint32_t>(data[offset + 2u]) << 16u);
-            WriteVramUnlocked(dpsm, dbp, dbw, m_transferState.x, m_transferState.y, value);
-            offset += 3u;
-            advancePixel(1u);
-            break;
-        }
-        case GS_PSM_CT16:
-        case GS_PSM_CT16S:
-        case GS_PSM_Z16:
-        case GS_PSM_Z16S:
-        {
-            if (sizeBytes - offset < 2u)
-                return;
-            uint16_t value = 0u;
-            std::memcpy(&value, data + offset, sizeof(value));
-            WriteVramUnlocked(dpsm, dbp, dbw, m_transferState.x, m_transferState.y, value);
-            offset += 2u;
-            advancePixel(1u);
-            break;
-        }
-        case GS_PSM_T8:
-        case GS_PSM_T8H:
-            WriteVramUnlocked(dpsm, dbp, dbw, m_transferState.x, m_transferState.y, data[offset++]);
-            advancePixel(1u);
-            break;
-        case GS_PSM_T4:
-        case GS_PSM_T4HL:
-        case GS_PSM_T4HH:
+        const uint32_t row = m_transferState.copiedPixels / rrw;
+        const uint32_t column = m_transferState.copiedPixels - row * rrw;
+        const uint32_t y = dsay + row;
+
+        if (useBlocks && column == 0u && (y % block.y) == 0u && pixels - consumed >= rrw * block.y)
         {
-            const uint8_t packed = data[offset++];
-            const uint32_t firstPixel = m_transferState.copiedPixels;
-            WriteVramUnlocked(dpsm, dbp, dbw,
-                              dsax + (firstPixel % rrw),
-                              m_transfer.trxpos.dsay + (firstPixel / rrw),
-                              packed & 0x0Fu);
-            if (firstPixel + 1u < m_transferState.totalPixels)
+            const uint32_t count = rrw * block.y;
+            m_transferPixels.resize(count);
+            decodePixels(consumed, count, m_transferPixels.data());
+
+            const uint32_t *band = m_transferPixels.data();
+            for (uint32_t line = 0; line < block.y; ++line)
             {
-                const uint32_t secondPixel = firstPixel + 1u;
-                WriteVramUnlocked(dpsm, dbp, dbw,
-                                  dsax + (secondPixel % rrw),
-                                  m_transfer.trxpos.dsay + (secondPixel / rrw),
-                                  (packed >> 4u) & 0x0Fu);
+                const uint32_t *values = band + line * rrw;
+                if (blockStart > dsax)
+                    GSMem::WriteSpan(dpsm, m_vram, dbp, dbw, dsax, y + line, blockStart - dsax, values);
+                if (dsax + rrw > blockEnd)
+                    GSMem::WriteSpan(dpsm, m_vram, dbp, dbw, blockEnd, y + line, dsax + rrw - blockEnd,
+                                     values + (blockEnd - dsax));
             }
-            advancePixel(std::min<uint32_t>(2u, m_transferState.totalPixels - firstPixel));
-            break;
-        }
-        default:
-            return;
+            for (uint32_t x = blockStart; x < blockEnd; x += block.x)
+                GSMem::WriteBlock(dpsm, m_vram, dbp, dbw, x, y, band + (x - dsax), rrw);
+
+            consumed += count;
+            advancePixels(count);
+            continue;
         }
+
+        const uint32_t count = std::min<uint32_t>(rrw - column, pixels - consumed);
+        m_transferPixels.resize(count);
+        decodePixels(consumed, count, m_transferPixels.data());
+        GSMem::WriteSpan(dpsm, m_vram, dbp, dbw, dsax + column, y, count, m_transferPixels.data());
+
+        consumed += count;
+        advancePixels(count);
     }
 }
 
@@ -1512,26 +1536,49 @@ void GSCpuBackend::PerformLocalToLocalTransfer()
         return;
     }
 
-    for (uint32_t pixel = 0; pixel < total; ++pixel)
-    {
-        uint32_t x = pixel % rrw;
-        uint32_t y = pixel / rrw;
-        if ((m_transfer.trxpos.dir & 0x2u) != 0u)
-            x = rrw - x - 1u;
-        if ((m_transfer.trxpos.dir & 0x1u) != 0u)
-            y = rrh - y - 1u;
-
-        const uint32_t value = ReadVramUnlocked(m_transfer.bitbltbuf.spsm,
-                                                m_transfer.bitbltbuf.sbp,
-                                                std::max<uint32_t>(m_transfer.bitbltbuf.sbw, 1u),
-                                                x + m_transfer.trxpos.ssax,
-                                                y + m_transfer.trxpos.ssay);
-        WriteVramUnlocked(m_transfer.bitbltbuf.dpsm,
-                          m_transfer.bitbltbuf.dbp,
-                          std::max<uint32_t>(m_transfer.bitbltbuf.dbw, 1u),
-                          x + m_transfer.trxpos.dsax,
-                          y + m_transfer.trxpos.dsay,
-                          value);
+    const uint32_t sbp = m_transfer.bitbltbuf.sbp;
+    const uint32_t sbw = std::max<uint32_t>(m_transfer.bitbltbuf.sbw, 1u);
+    const uint32_t dbp = m_transfer.bitbltbuf.dbp;
+    const uint32_t dbw = std::max<uint32_t>(m_transfer.bitbltbuf.dbw, 1u);
+    const uint32_t ssax = m_transfer.trxpos.ssax;
+    const uint32_t ssay = m_transfer.trxpos.ssay;
+    const uint32_t dsax = m_transfer.trxpos.dsax;
+    const uint32_t dsay = m_transfer.trxpos.dsay;
+    const bool reverseX = (m_transfer.trxpos.dir & 0x2u) != 0u;
+    const bool reverseY = (m_transfer.trxpos.dir & 0x1u) != 0u;
+
+    // Copying a whole row at a time only matches the pixel order of the GS
+    // when the destination cannot feed back into the source.
+    const auto spsm = static_cast<GSMem::PixelStorageMode>(m_transfer.bitbltbuf.spsm & 0x3Fu);
+    const auto dpsm = static_cast<GSMem::PixelStorageMode>(m_transfer.bitbltbuf.dpsm & 0x3Fu);
+    uint32_t srcBegin = 0u, srcEnd = 0u, dstBegin = 0u, dstEnd = 0u;
+    const bool copyRows = !reverseX &&
+                          GSMem::ByteRange(spsm, sbp, sbw, ssax, ssay, rrw, rrh, srcBegin, srcEnd) &&
+                          GSMem::ByteRange(dpsm, dbp, dbw, dsax, dsay, rrw, rrh, dstBegin, dstEnd) &&
+                          (srcEnd <= dstBegin || dstEnd <= srcBegin);
+
+    if (copyRows)
+    {
+        m_transferPixels.resize(rrw);
+        for (uint32_t row = 0; row < rrh; ++row)
+        {
+            const uint32_t y = reverseY ? rrh - row - 1u : row;
+            GSMem::ReadSpan(spsm, m_vram, sbp, sbw, ssax, ssay + y, rrw, m_transferPixels.data());
+            GSMem::WriteSpan(dpsm, m_vram, dbp, dbw, dsax, dsay + y, rrw, m_transferPixels.data());
+        }
+    }
+    else
+    {
+        for (uint32_t row = 0; row < rrh; ++row)
+        {
+            const uint32_t y = reverseY ? rrh - row - 1u : row;
+            for (uint32_t column = 0; column < rrw; ++column)
+            {
+                const uint32_t x = reverseX ? rrw - column - 1u : column;
+                const uint32_t value = ReadVramUnlocked(m_transfer.bitbltbuf.spsm, sbp, sbw, x + ssax, y + ssay);
+                WriteVramUnlocked(m_transfer.bitbltbuf.dpsm, dbp, dbw, x + dsax, y + dsay, value);
+            }
+        }
     }
 
     m_transferState.copiedPixels = total;
@@ -1540,65 +1587,70 @@ void GSCpuBackend::PerformLocalToLocalTransfer()
 
 void GSCpuBackend::PerformLocalToHostTransfer()
 {
+    // A transfer that reads nothing must not leave the previous one's
+    // progress or pending bytes behind.
     m_localToHostBuffer.clear();
     m_localToHostReadPos = 0u;
+    m_transferState.copiedPixels = 0u;
+    m_transferState.localToHostPendingBytes = 0u;
     if (!m_vram)
         return;
 
     const uint32_t rrw = m_transfer.trxreg.rrw;
     const uint32_t rrh = m_transfer.trxreg.rrh;
+    const uint32_t sbp = m_transfer.bitbltbuf.sbp;
     const uint32_t sbw = std::max<uint32_t>(m_transfer.bitbltbuf.sbw, 1u);
-    const uint8_t spsm = m_transfer.bitbltbuf.spsm;
-    const uint32_t bpp = static_cast<uint32_t>(GSMem::BitsPerPixel(static_cast<GSMem::PixelStorageMode>(spsm)));
+    const auto readPsm = static_cast<GSMem::PixelStorageMode>(m_transfer.bitbltbuf.spsm & 0x3Fu);
+    const uint32_t bpp = static_cast<uint32_t>(GSMem::BitsPerPixel(readPsm));
     const uint32_t total = rrw * rrh;
-    m_localToHostBuffer.reserve((static_cast<size_t>(total) * bpp + 7u) / 8u);
+    m_localToHostBuffer.resize((static_cast<size_t>(total) * bpp + 7u) / 8u);
+    if (total == 0u)
+        return;
 
-    for (uint32_t pixel = 0u; pixel < total; ++pixel)
+    uint8_t *out = m_localToHostBuffer.data();
+    uint32_t pixel = 0u;
+    m_transferPixels.resize(rrw);
+    for (uint32_t row = 0u; row < rrh; ++row)
     {
-        const uint32_t x = pixel % rrw;
-        const uint32_t y = pixel / rrw;
-        const uint32_t value = ReadVramUnlocked(spsm,
-                                                m_transfer.bitbltbuf.sbp,
-                                                sbw,
-                                                x + m_transfer.trxpos.ssax,
-                                                y + m_transfer.trxpos.ssay);
+        const uint32_t *values = m_transferPixels.data();
+        GSMem::ReadSpan(readPsm, m_vram, sbp, sbw, m_transfer.trxpos.ssax, m_transfer.trxpos.ssay + row, rrw,
+                        m_transferPixels.data());
+
         switch (bpp)
         {
         case 32:
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value));
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value >> 8u));
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value >> 16u));
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value >> 24u));
+            std::memcpy(out, values, static_cast<size_t>(rrw) * 4u);
+            out += static_cast<size_t>(rrw) * 4u;
             break;
         case 24:
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value));
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value >> 8u));
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value >> 16u));
+            for (uint32_t i = 0u; i < rrw; ++i)
+            {
+                *out++ = static_cast<uint8_t>(values[i]);
+                *out++ = static_cast<uint8_t>(values[i] >> 8u);
+                *out++ = static_cast<uint8_t>(values[i] >> 16u);
+            }
             break;
         case 16:
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value));
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value >> 8u));
+            for (uint32_t i = 0u; i < rrw; ++i)
+            {
+                *out++ = static_cast<uint8_t>(values[i]);
+                *out++ = static_cast<uint8_t>(values[i] >> 8u);
+            }
             break;
         case 8:
-            m_localToHostBuffer.push_back(static_cast<uint8_t>(value));
+            for (uint32_t i = 0u; i < rrw; ++i)
+                *out++ = static_cast<uint8_t>(values[i]);
             break;
         case 4:
-        {
-            if ((pixel & 1u) != 0u)
-                break;
-            uint32_t next = 0u;
-            if (pixel + 1u < total)
+            // Pixels pair up in stream order, so a byte can straddle two rows.
+            for (uint32_t i = 0u; i < rrw; ++i, ++pixel)
             {
-                const uint32_t nextPixel = pixel + 1u;
-                const uint32_t nextX = nextPixel % rrw;
-                const uint32_t nextY = nextPixel / rrw;
-                next = ReadVramUnlocked(spsm, m_transfer.bitbltbuf.sbp, sbw,
-                                        nextX + m_transfer.trxpos.ssax,
-                                        nextY + m_transfer.trxpos.ssay);
+                if ((pixel & 1u) == 0u)
+                    *out = static_cast<uint8_t>(values[i] & 0x0Fu);
+                else
+                    *out++ |= static_cast<uint8_t>((values[i] & 0x0Fu) << 4u);
             }
-            m_localToHostBuffer.push_back(static_cast<uint8_t>((value & 0x0Fu) | ((next & 0x0Fu) << 4u)));
             break;
-        }
         default:
             break;
         }
@@ -1757,23 +1809,37 @@ bool GSCpuBackend::CopyFrameToHostRgba(const GSFrameReg &frame,
     return true;
 }
 
-PresentationFrame GSCpuBackend::Present(const GSPresentationRequest &request)
+bool GSCpuBackend::Present(const GSPresentationRequest &request, PresentationFrame &frame)
 {
     // Snapshot local memory under the backend lock, then perform the expensive
     // display conversion without holding the producer-side raster lock.
     thread_local std::vector<uint8_t> snapshot;
     SnapshotVram(snapshot);
     if (snapshot.empty())
-        return {};
+    {
+        frame.pixels.clear();
+        frame.width = frame.height = 0u;
+        return false;
+    }
 
     thread_local GSCpuBackend snapshotBackend;
     snapshotBackend.Initialize(snapshot.data(), static_cast<uint32_t>(snapshot.size()));
-    return snapshotBackend.PresentFromLocalMemory(request);
+    return snapshotBackend.PresentFromLocalMemory(request, frame);
 }
 
-PresentationFrame GSCpuBackend::PresentFromLocalMemory(const GSPresentationRequest &request)
+bool GSCpuBackend::PresentFromLocalMemory(const GSPresentationRequest &request, PresentationFrame &result)
 {
-    PresentationFrame result{};
+    // The caller's pixel storage is reused frame to frame; only the metadata
+    // starts over.
+    result.width = result.height = 0u;
+    result.displayFbp = result.sourceFbp = 0u;
+    result.usedPreferred = false;
+    auto noFrame = [&result]()
+    {
+        result.pixels.clear();
+        result.width = result.height = 0u;
+        return false;
+    };
     const GSPmodeState pmode = decodePmode(request.pmode);
     const GSSmode2State smode2 = decodeSMode2(request.smode2);
     const bool fieldMode = smode2.interlaced && !smode2.frameMode;
@@ -1788,7 +1854,7 @@ PresentationFrame GSCpuBackend::PresentFromLocalMemory(const GSPresentationReque
     const bool valid1 = pmode.enableCrt1 && hasDisplaySetup(request.display1, displayFrame1);
     const bool valid2 = pmode.enableCrt2 && hasDisplaySetup(request.display2, displayFrame2);
     if (!valid1 && !valid2)
-        return result;
+        return noFrame();
 
     auto copySource = [&](const GSFrameReg &displayFrame,
                           const GSDisplayReadOrigin &origin,
@@ -1819,7 +1885,7 @@ PresentationFrame GSCpuBackend::PresentFromLocalMemory(const GSPresentationReque
             {
                 if (candidate.fbp == selected.fbp && candidate.fbw == selected.fbw && candidate.psm == selected.psm)
                     continue;
-                std::vector<uint8_t> candidatePixels;
+                std::vector<uint8_t> &candidatePixels = m_presentCandidatePixels;
                 if (!CopyFrameToHostRgba(candidate, width, height, candidatePixels, preserveAlpha, true, true, 0u, 0u))
                     continue;
                 if (countNonBlackPixels(candidatePixels, width, height) == 0u)
@@ -1835,7 +1901,8 @@ PresentationFrame GSCpuBackend::PresentFromLocalMemory(const GSPresentationReque
     if (valid1 && valid2)
     {
         GSFrameReg selected1{}, selected2{};
-        std::vector<uint8_t> crt1, crt2;
+        std::vector<uint8_t> &crt1 = m_presentCircuitPixels[0];
+        std::vector<uint8_t> &crt2 = m_presentCircuitPixels[1];
         bool preferred1 = false, preferred2 = false;
         if (copySource(displayFrame1, origin1, width1, height1, false, true, selected1, crt1, preferred1) &&
             copySource(displayFrame2, origin2, width2, height2, false, true, selected2, crt2, preferred2))
@@ -1874,7 +1941,7 @@ PresentationFrame GSCpuBackend::PresentFromLocalMemory(const GSPresentationReque
                 applyFieldPresentation(result.pixels, result.width, result.height, oddField);
             result.displayFbp = displayFrame1.fbp;
             result.sourceFbp = selected1.fbp;
-            return result;
+            return static_cast<bool>(result);
         }
     }
 
@@ -1884,11 +1951,14 @@ PresentationFrame GSCpuBackend::PresentFromLocalMemory(const GSPresentationReque
     result.height = valid1 ? height1 : height2;
     GSFrameReg selected = displayFrame;
     if (!copySource(displayFrame, origin, result.width, result.height, true, false, selected, result.pixels, result.usedPreferred))
-        return {};
+    {
+        result.usedPreferred = false;
+        return noFrame();
+    }
     if (fieldMode)
         applyFieldPresentation(result.pixels, result.width, result.height, oddField);
     normalizePresentationAlpha(result.pixels, result.width, result.height);
     result.displayFbp = displayFrame.fbp;
     result.sourceFbp = selected.fbp;
-    return result;
+    return static_cast<bool>(result);
 }
@@ -159,6 +159,15 @@ void GS::reset()
     m_preferredDisplaySourceFrame = {};
     m_preferredDisplayDestFbp = 0;
     m_hasPreferredDisplaySource = false;
+    m_displayBuffers = {};
+    m_displayBufferCount = 0;
+    m_displayBufferNext = 0;
+    m_frameSkipWarmup = kFrameSkipWarmupFrames;
+    m_consecutiveSkippedFrames = 0;
+    m_skippedFrames = 0;
+    m_skippingFrame = false;
+    m_frameSkipBlocked = false;
+    m_presentSkippedFrame.store(false, std::memory_order_release);
     if (m_backend)
     {
         m_backend->Flush();
@@ -166,8 +175,10 @@ void GS::reset()
         m_backend->Reset();
     }
     {
+        // Frames latched before the reset are never handed to the presenter.
+        m_hostPresentationClearedSequence.store(m_hostPresentationSequence.load(std::memory_order_acquire),
+                                                std::memory_order_release);
         std::lock_guard<std::mutex> presentationLock(m_presentationMutex);
-        m_hostPresentationFrame.clear();
         m_hostPresentationWidth = 0u;
         m_hostPresentationHeight = 0u;
         m_hostPresentationDisplayFbp = 0u;
@@ -526,40 +537,59 @@ GSPresentationRequest GS::buildPresentationRequestUnlocked() const
 
 void GS::latchHostPresentationFrame()
 {
+    // A skipped frame left its display buffer stale; keep showing the last
+    // frame that was drawn.
+    if (m_presentSkippedFrame.load(std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> latchLock(m_presentationLatchMutex);
+    HostPresentationSlot &slot = m_hostPresentationSlots[m_hostPresentationBack];
+    PresentationFrame &frame = slot.frame;
+
     GSPresentationRequest request{};
+    bool hasRequest = false;
     {
         std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-        if (!m_backend || !m_privRegs)
+        if (m_backend && m_privRegs)
         {
-            std::lock_guard<std::mutex> presentationLock(m_presentationMutex);
-            m_hostPresentationFrame.clear();
-            m_hasHostPresentationFrame = false;
-            m_hostPresentationWidth = m_hostPresentationHeight = 0u;
-            return;
+            request = buildPresentationRequestUnlocked();
+            hasRequest = true;
         }
-        request = buildPresentationRequestUnlocked();
     }
 
-    PresentationFrame frame{};
+    bool hasFrame = false;
+    if (hasRequest)
     {
         std::lock_guard<std::mutex> backendLock(m_backendLifetimeMutex);
         if (m_backend)
         {
             m_backend->Flush();
             m_backend->Sync(GSSyncReason::Presentation);
-            frame = m_backend->Present(request);
+            hasFrame = m_backend->Present(request, frame);
         }
     }
+    if (!hasFrame)
+    {
+        frame.pixels.clear();
+        frame.width = frame.height = 0u;
+        frame.displayFbp = frame.sourceFbp = 0u;
+        frame.usedPreferred = false;
+    }
 
-    const bool hasFrame = static_cast<bool>(frame);
     const uint32_t displayFbp = frame.displayFbp;
     const uint32_t sourceFbp = frame.sourceFbp;
     const uint32_t width = frame.width;
     const uint32_t height = frame.height;
     const bool usedPreferred = frame.usedPreferred;
+
+    // Publish the back slot and take whichever slot was waiting in its place.
+    slot.sequence = m_hostPresentationSequence.fetch_add(1u, std::memory_order_acq_rel) + 1u;
+    m_hostPresentationBack = m_hostPresentationReady.exchange(m_hostPresentationBack | kHostPresentationFresh,
+                                                              std::memory_order_acq_rel) &
+                             kHostPresentationSlotMask;
+
     {
         std::lock_guard<std::mutex> presentationLock(m_presentationMutex);
-        m_hostPresentationFrame = std::move(frame.pixels);
         m_hostPresentationWidth = width;
         m_hostPresentationHeight = height;
         m_hostPresentationDisplayFbp = displayFbp;
@@ -575,15 +605,31 @@ void GS::latchHostPresentationFrame()
     }
 }
 
+const PresentationFrame *GS::acquireHostPresentationFrame(uint64_t *outSequence)
+{
+    if ((m_hostPresentationReady.load(std::memory_order_acquire) & kHostPresentationFresh) != 0u)
+    {
+        m_hostPresentationFront = m_hostPresentationReady.exchange(m_hostPresentationFront, std::memory_order_acq_rel) &
+                                  kHostPresentationSlotMask;
+    }
+
+    const HostPresentationSlot &slot = m_hostPresentationSlots[m_hostPresentationFront];
+    if (outSequence)
+        *outSequence = slot.sequence;
+    if (slot.sequence <= m_hostPresentationClearedSequence.load(std::memory_order_acquire) || !slot.frame)
+        return nullptr;
+    return &slot.frame;
+}
+
 bool GS::copyLatchedHostPresentationFrame(std::vector<uint8_t> &outPixels,
                                           uint32_t &outWidth,
                                           uint32_t &outHeight,
                                           uint32_t *outDisplayFbp,
                                           uint32_t *outSourceFbp,
-                                          bool *outUsedPreferred) const
+                                          bool *outUsedPreferred)
 {
-    std::lock_guard<std::mutex> lock(m_presentationMutex);
-    if (!m_hasHostPresentationFrame || m_hostPresentationFrame.empty())
+    const PresentationFrame *frame = acquireHostPresentationFrame();
+    if (!frame)
     {
         outPixels.clear();
         outWidth = 0u;
@@ -597,14 +643,14 @@ bool GS::copyLatchedHostPresentationFrame(std::vector<uint8_t> &outPixels,
         return false;
     }
 
-    outWidth = m_hostPresentationWidth;
-    outHeight = m_hostPresentationHeight;
+    outWidth = frame->width;
+    outHeight = frame->height;
     if (outDisplayFbp)
-        *outDisplayFbp = m_hostPresentationDisplayFbp;
+        *outDisplayFbp = frame->displayFbp;
     if (outSourceFbp)
-        *outSourceFbp = m_hostPresentationSourceFbp;
+        *outSourceFbp = frame->sourceFbp;
     if (outUsedPreferred)
-        *outUsedPreferred = m_hostPresentationUsedPreferred;
+        *outUsedPreferred = frame->usedPreferred;
 
     const size_t packedRowBytes = static_cast<size_t>(outWidth) * 4u;
     outPixels.resize(packedRowBytes * static_cast<size_t>(outHeight));
@@ -615,7 +661,7 @@ bool GS::copyLatchedHostPresentationFrame(std::vector<uint8_t> &outPixels,
         {
             const size_t srcOffset = static_cast<size_t>(y) * sourceRowBytes;
             const size_t dstOffset = static_cast<size_t>(y) * packedRowBytes;
-            if (srcOffset + packedRowBytes > m_hostPresentationFrame.size() ||
+            if (srcOffset + packedRowBytes > frame->pixels.size() ||
                 dstOffset + packedRowBytes > outPixels.size())
             {
                 outPixels.clear();
@@ -631,7 +677,7 @@ bool GS::copyLatchedHostPresentationFrame(std::vector<uint8_t> &outPixels,
             }
 
             std::memcpy(outPixels.data() + dstOffset,
-                        m_hostPresentationFrame.data() + srcOffset,
+                        frame->pixels.data() + srcOffset,
                         packedRowBytes);
         }
     }
@@ -1381,6 +1427,9 @@ void GS::writeRegisterUnlocked(uint8_t regAddr, uint64_t value)
     case GS_REG_TRXDIR:
     {
         m_trxdir = static_cast<uint32_t>(value & 0x3);
+        // The EE reads this frame's VRAM back, so it has to be drawn.
+        if (m_trxdir == 1u)
+            blockFrameSkipUnlocked();
 
         if (m_backend)
         {
@@ -1574,7 +1623,8 @@ void GS::vertexKick(bool drawing)
     {
         GSPrimitiveBatch batch = buildDrawBatch(needed);
         updatePreferredDisplaySourceForDraw(batch);
-        m_backend->Submit(batch);
+        if (m_frameSkipLimit == 0u || !dropDrawUnlocked(batch.state))
+            m_backend->Submit(batch);
         recordDrawDebugEventUnlocked(needed);
     }
 
@@ -1630,6 +1680,114 @@ uint32_t GS::consumeLocalToHostBytes(uint8_t *dst, uint32_t maxBytes)
     return m_backend ? m_backend->ConsumeLocalToHostBytes(dst, maxBytes) : 0u;
 }
 
+void GS::setFrameSkipLimit(uint32_t limit)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+    m_frameSkipLimit = limit;
+    if (limit == 0u)
+        m_skippingFrame = false;
+}
+
+void GS::beginFrame(bool behindRealTime)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+    m_presentSkippedFrame.store(m_skippingFrame, std::memory_order_release);
+    if (m_skippingFrame)
+    {
+        ++m_skippedFrames;
+        ++m_consecutiveSkippedFrames;
+    }
+    else
+    {
+        m_consecutiveSkippedFrames = 0u;
+    }
+    m_skippingFrame = false;
+
+    if (m_frameSkipLimit == 0u || m_frameSkipBlocked || !m_privRegs)
+        return;
+
+    trackDisplayBufferUnlocked(m_privRegs->dispfb1);
+    trackDisplayBufferUnlocked(m_privRegs->dispfb2);
+    if (m_frameSkipWarmup != 0u)
+    {
+        --m_frameSkipWarmup;
+        return;
+    }
+    m_skippingFrame = behindRealTime && m_consecutiveSkippedFrames < m_frameSkipLimit;
+}
+
+bool GS::isSkippingFrame() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+    return m_skippingFrame;
+}
+
+uint64_t GS::skippedFrameCount() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+    return m_skippedFrames;
+}
+
+void GS::trackDisplayBufferUnlocked(uint64_t dispfb)
+{
+    GSFrameReg frame{};
+    frame.fbp = static_cast<uint32_t>(dispfb & 0x1FFu);
+    frame.fbw = static_cast<uint32_t>((dispfb >> 9) & 0x3Fu);
+    frame.psm = static_cast<uint8_t>((dispfb >> 15) & 0x1Fu);
+    for (size_t i = 0; i < m_displayBufferCount; ++i)
+    {
+        if (m_displayBuffers[i].fbp == frame.fbp)
+        {
+            m_displayBuffers[i] = frame;
+            return;
+        }
+    }
+    // Double and triple buffering rotate through a few FBPs; the oldest one
+    // is forgotten once more than that have been displayed.
+    m_displayBuffers[m_displayBufferNext] = frame;
+    m_displayBufferNext = (m_displayBufferNext + 1u) % kMaxTrackedDisplayBuffers;
+    m_displayBufferCount = std::min(m_displayBufferCount + 1u, kMaxTrackedDisplayBuffers);
+}
+
+bool GS::isDisplayBufferBlockUnlocked(uint32_t block) const
+{
+    for (size_t i = 0; i < m_displayBufferCount; ++i)
+    {
+        const GSFrameReg &frame = m_displayBuffers[i];
+        // Generous extent: 512 lines of 32-bit pixels at the buffer's width.
+        const uint32_t begin = frame.fbp << 5u;
+        const uint32_t blocks = std::max<uint32_t>(frame.fbw, 1u) * 512u;
+        if (block >= begin && block - begin < blocks)
+            return true;
+    }
+    return false;
+}
+
+bool GS::dropDrawUnlocked(const GSDrawState &state)
+{
+    const GSContext &ctx = state.context;
+    if (state.prim.tme && isDisplayBufferBlockUnlocked(ctx.tex0.tbp0))
+    {
+        // A draw sampling a display buffer needs every frame rendered.
+        blockFrameSkipUnlocked();
+        return false;
+    }
+    if (!m_skippingFrame)
+        return false;
+    for (size_t i = 0; i < m_displayBufferCount; ++i)
+    {
+        if (m_displayBuffers[i].fbp == ctx.frame.fbp)
+            return true;
+    }
+    return false;
+}
+
+void GS::blockFrameSkipUnlocked()
+{
+    m_frameSkipBlocked = true;
+    m_skippingFrame = false;
+}
+
 void GS::setRasterBackend(std::unique_ptr<GSRasterBackend> backend)
 {
     if (!backend)
@@ -1,7 +1,16 @@
+#include <algorithm>
 #include <array>
 
 #include "runtime/gs/ps2_gs_memory.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(USE_SSE2NEON)
+#include "sse2neon.h"
+#else
+#include <emmintrin.h>
+#endif
+
 namespace GSMem
 {
     using C32Traits  = PixelStorageTraits<C32>;
@@ -358,6 +367,269 @@ namespace GSMem
     {
         return 0;
     }
-}
 
+    template<PixelStorageMode psm>
+    static void WriteSpanT(const typename PixelStorageTraits<psm>::PageLookupTableT& table, u8* data, u32 bp, u32 bw, u32 x, u32 y, u32 count, const u32* values)
+    {
+        using Traits = PixelStorageTraits<psm>;
+        using PackedT = typename Traits::PackedT;
+        constexpr auto page_extent = Traits::PageExtent();
+
+        // the row of the page table only depends on y, so only the page
+        // changes while walking along x
+        const auto& row = table[bp % Traits::BlocksPerPage()][y % page_extent.y];
+
+        while (count != 0)
+        {
+            const u32 page_base = static_cast<u32>(Traits::PageId(bp, bw, x, y) * Traits::PixelsPerPage());
+            const u32 column = x % page_extent.x;
+            const u32 run = std::min<u32>(count, page_extent.x - column);
+
+            for (u32 i = 0; i < run; ++i)
+                Traits::WriteAt(data, page_base + row[column + i], static_cast<PackedT>(values[i]));
+
+            x += run;
+            values += run;
+            count -= run;
+        }
+    }
+
+    template<PixelStorageMode psm>
+    static void ReadSpanT(const typename PixelStorageTraits<psm>::PageLookupTableT& table, const u8* data, u32 bp, u32 bw, u32 x, u32 y, u32 count, u32* values)
+    {
+        using Traits = PixelStorageTraits<psm>;
+        constexpr auto page_extent = Traits::PageExtent();
+
+        const auto& row = table[bp % Traits::BlocksPerPage()][y % page_extent.y];
+
+        while (count != 0)
+        {
+            const u32 page_base = static_cast<u32>(Traits::PageId(bp, bw, x, y) * Traits::PixelsPerPage());
+            const u32 column = x % page_extent.x;
+            const u32 run = std::min<u32>(count, page_extent.x - column);
+
+            for (u32 i = 0; i < run; ++i)
+                values[i] = Traits::ReadAt(data, page_base + row[column + i]);
 
+            x += run;
+            values += run;
+            count -= run;
+        }
+    }
+
+    template<PixelStorageMode psm, typename ColumnLookupTableT>
+    static void WriteBlockT(const typename PixelStorageTraits<psm>::PageLookupTableT& table, const ColumnLookupTableT& columns, u8* data, u32 bp, u32 bw, u32 x, u32 y, const u32* values, usz stride)
+    {
+        using Traits = PixelStorageTraits<psm>;
+        using PackedT = typename Traits::PackedT;
+        constexpr auto extent = Traits::ColumnExtent();
+
+        // the first pixel of a block is always column offset 0, everything
+        // else in the block is a fixed offset from it
+        const u32 base = Traits::Address(table, bp, bw, x, y);
+
+        for (u32 j = 0; j < extent.y; ++j, values += stride)
+        {
+            for (u32 i = 0; i < extent.x; ++i)
+                Traits::WriteAt(data, base + columns[j][i], static_cast<PackedT>(values[i]));
+        }
+    }
+
+    // 32 bit blocks are 8x8 pixels stored as four 8x2 columns, and each
+    // column interleaves pairs of pixels from its two rows (see ColumnTable32)
+    template<PixelStorageMode psm>
+    static void WriteBlock32(const typename PixelStorageTraits<psm>::PageLookupTableT& table, u8* data, u32 bp, u32 bw, u32 x, u32 y, const u32* values, usz stride)
+    {
+        using Traits = PixelStorageTraits<psm>;
+        constexpr bool keep_alpha = psm == C24 || psm == Z24;
+
+        // blocks are 256 byte aligned, so masking the first pixel covers the whole block
+        const u32 base = Traits::Address(table, bp, bw, x, y);
+        u8* block = &data[((base * 32) / 8) & (MEMORY_SIZE - sizeof(u32))];
+
+        const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+
+        for (u32 column = 0; column < COLUMNS_PER_BLOCK; ++column)
+        {
+            const u32* row0 = values + (column * 2) * stride;
+            const u32* row1 = row0 + stride;
+
+            const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+            const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 4));
+            const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+            const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 4));
+
+            __m128i out[4] =
+            {
+                _mm_unpacklo_epi64(a0, b0),
+                _mm_unpackhi_epi64(a0, b0),
+                _mm_unpacklo_epi64(a1, b1),
+                _mm_unpackhi_epi64(a1, b1),
+            };
+
+            __m128i* dst = reinterpret_cast<__m128i*>(block + column * 64);
+
+            for (u32 i = 0; i < 4; ++i)
+            {
+                if constexpr (keep_alpha)
+                {
+                    // RMW
+                    const __m128i old = _mm_loadu_si128(dst + i);
+                    out[i] = _mm_or_si128(_mm_andnot_si128(rgb_mask, old), _mm_and_si128(out[i], rgb_mask));
+                }
+
+                _mm_storeu_si128(dst + i, out[i]);
+            }
+        }
+    }
+
+    template<PixelStorageMode psm>
+    static bool ByteRangeT(u32 bp, u32 bw, u32 x, u32 y, u32 w, u32 h, u32& begin, u32& end)
+    {
+        using Traits = PixelStorageTraits<psm>;
+
+        if (w == 0 || h == 0)
+        {
+            begin = end = 0;
+            return true;
+        }
+
+        // page ids only grow along x and y, and a base pointer that is not
+        // page aligned spills blocks into the following page
+        const usz first = Traits::PageId(bp, bw, x, y);
+        const usz last = Traits::PageId(bp, bw, x + w - 1, y + h - 1) + 1;
+
+        if ((last + 1) * GS_PAGE_SIZE > MEMORY_SIZE)
+            return false;
+
+        begin = static_cast<u32>(first * GS_PAGE_SIZE);
+        end = static_cast<u32>((last + 1) * GS_PAGE_SIZE);
+        return true;
+    }
+
+    void WriteSpan(PixelStorageMode psm, u8* data, u32 bp, u32 bw, u32 x, u32 y, u32 count, const u32* values)
+    {
+        switch (psm)
+        {
+        case C32:  WriteSpanT<C32>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case C24:  WriteSpanT<C24>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case Z32:  WriteSpanT<Z32>(PageTableZ32, data, bp, bw, x, y, count, values); break;
+        case Z24:  WriteSpanT<Z24>(PageTableZ32, data, bp, bw, x, y, count, values); break;
+        case C16:  WriteSpanT<C16>(PageTableC16, data, bp, bw, x, y, count, values); break;
+        case C16S: WriteSpanT<C16S>(PageTableC16S, data, bp, bw, x, y, count, values); break;
+        case Z16:  WriteSpanT<Z16>(PageTableZ16, data, bp, bw, x, y, count, values); break;
+        case Z16S: WriteSpanT<Z16S>(PageTableZ16S, data, bp, bw, x, y, count, values); break;
+        case P8:   WriteSpanT<P8>(PageTableP8, data, bp, bw, x, y, count, values); break;
+        case P8H:  WriteSpanT<P8H>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case P4:   WriteSpanT<P4>(PageTableP4, data, bp, bw, x, y, count, values); break;
+        case P4HL: WriteSpanT<P4HL>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case P4HH: WriteSpanT<P4HH>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        default:
+            break;
+        }
+    }
+
+    void ReadSpan(PixelStorageMode psm, u8* data, u32 bp, u32 bw, u32 x, u32 y, u32 count, u32* values)
+    {
+        switch (psm)
+        {
+        case C32:  ReadSpanT<C32>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case C24:  ReadSpanT<C24>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case Z32:  ReadSpanT<Z32>(PageTableZ32, data, bp, bw, x, y, count, values); break;
+        case Z24:  ReadSpanT<Z24>(PageTableZ32, data, bp, bw, x, y, count, values); break;
+        case C16:  ReadSpanT<C16>(PageTableC16, data, bp, bw, x, y, count, values); break;
+        case C16S: ReadSpanT<C16S>(PageTableC16S, data, bp, bw, x, y, count, values); break;
+        case Z16:  ReadSpanT<Z16>(PageTableZ16, data, bp, bw, x, y, count, values); break;
+        case Z16S: ReadSpanT<Z16S>(PageTableZ16S, data, bp, bw, x, y, count, values); break;
+        case P8:   ReadSpanT<P8>(PageTableP8, data, bp, bw, x, y, count, values); break;
+        case P8H:  ReadSpanT<P8H>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case P4:   ReadSpanT<P4>(PageTableP4, data, bp, bw, x, y, count, values); break;
+        case P4HL: ReadSpanT<P4HL>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        case P4HH: ReadSpanT<P4HH>(PageTableC32, data, bp, bw, x, y, count, values); break;
+        default:
+            std::fill_n(values, count, 0u);
+            break;
+        }
+    }
+
+    template<PixelStorageMode psm>
+    static Extent2D TransferBlockExtentT(u32 bp, u32 bw, u32 x, u32 y, u32 w, u32 h)
+    {
+        using Traits = PixelStorageTraits<psm>;
+        constexpr auto page_extent = Traits::PageExtent();
+
+        // pixels past the last whole page of a row land in the next row of
+        // pages, blocks of an unaligned base spill into the next page, and
+        // anything past the end of memory wraps around
+        const u32 row_width = ((bw * 64) / page_extent.x) * page_extent.x;
+        u32 begin = 0;
+        u32 end = 0;
+
+        if ((bp % Traits::BlocksPerPage()) != 0 || x + w > row_width || !ByteRangeT<psm>(bp, bw, x, y, w, h, begin, end))
+            return { 0, 0 };
+
+        return Traits::ColumnExtent();
+    }
+
+    Extent2D TransferBlockExtent(PixelStorageMode psm, u32 bp, u32 bw, u32 x, u32 y, u32 w, u32 h)
+    {
+        switch (psm)
+        {
+        case C32:
+        case C24:
+        case Z32:
+        case Z24:
+            return TransferBlockExtentT<C32>(bp, bw, x, y, w, h);
+        case C16:
+        case C16S:
+        case Z16:
+        case Z16S:
+            return TransferBlockExtentT<C16>(bp, bw, x, y, w, h);
+        case P8:
+            return TransferBlockExtentT<P8>(bp, bw, x, y, w, h);
+        default:
+            break;
+        }
+
+        // P4 packs two pixels per byte and the H formats are RMW into 32 bit
+        // words, those go through WriteSpan
+        return { 0, 0 };
+    }
+
+    void WriteBlock(PixelStorageMode psm, u8* data, u32 bp, u32 bw, u32 x, u32 y, const u32* values, usz stride)
+    {
+        switch (psm)
+        {
+        case C32:  WriteBlock32<C32>(PageTableC32, data, bp, bw, x, y, values, stride); break;
+        case C24:  WriteBlock32<C24>(PageTableC32, data, bp, bw, x, y, values, stride); break;
+        case Z32:  WriteBlock32<Z32>(PageTableZ32, data, bp, bw, x, y, values, stride); break;
+        case Z24:  WriteBlock32<Z24>(PageTableZ32, data, bp, bw, x, y, values, stride); break;
+        case C16:  WriteBlockT<C16>(PageTableC16, ColumnTable16, data, bp, bw, x, y, values, stride); break;
+        case C16S: WriteBlockT<C16S>(PageTableC16S, ColumnTable16, data, bp, bw, x, y, values, stride); break;
+        case Z16:  WriteBlockT<Z16>(PageTableZ16, ColumnTable16, data, bp, bw, x, y, values, stride); break;
+        case Z16S: WriteBlockT<Z16S>(PageTableZ16S, ColumnTable16, data, bp, bw, x, y, values, stride); break;
+        case P8:   WriteBlockT<P8>(PageTableP8, ColumnTable8, data, bp, bw, x, y, values, stride); break;
+        default:
+            break;
+        }
+    }
+
+    bool ByteRange(PixelStorageMode psm, u32 bp, u32 bw, u32 x, u32 y, u32 w, u32 h, u32& begin, u32& end)
+    {
+        switch (psm)
+        {
+        case C16:
+        case C16S:
+        case Z16:
+        case Z16S:
+            return ByteRangeT<C16>(bp, bw, x, y, w, h, begin, end);
+        case P8:
+            return ByteRangeT<P8>(bp, bw, x, y, w, h, begin, end);
+        case P4:
+            return ByteRangeT<P4>(bp, bw, x, y, w, h, begin, end);
+        default:
+            // every 32 bit layout, unknown psm never touch memory
+            return ByteRangeT<C32>(bp, bw, x, y, w, h, begin, end);
+        }
+    }
+}
@@ -1,66 +1,32 @@
 #include "runtime/ps2_audio.h"
 #include "runtime/ps2_memory.h"
 #include "ps2_host_backend.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <thread>
 #include <vector>
 
 namespace
 {
-    std::vector<uint8_t> buildWavFromPcm(const int16_t *pcm, size_t sampleCount, uint32_t sampleRate)
+    constexpr size_t kMixBlockFrames = 256;
+    // About 40 ms of output; enough to ride out scheduler hiccups without
+    // making key-ons noticeably late.
+    constexpr size_t kRingFrames = 2048;
+
+#if !defined(PLATFORM_VITA)
+    // raylib's stream callback carries no user pointer.
+    std::atomic<PS2AudioRing *> g_streamRing{nullptr};
+
+    void pullStreamFrames(void *buffer, unsigned int frames)
     {
-        const uint32_t dataSize = static_cast<uint32_t>(sampleCount * 2);
-        const uint32_t fileSize = 36 + dataSize;
-        std::vector<uint8_t> wav(8 + fileSize);
-
-        uint8_t *p = wav.data();
-        p[0] = 'R';
-        p[1] = 'I';
-        p[2] = 'F';
-        p[3] = 'F';
-        p[4] = static_cast<uint8_t>(fileSize);
-        p[5] = static_cast<uint8_t>(fileSize >> 8);
-        p[6] = static_cast<uint8_t>(fileSize >> 16);
-        p[7] = static_cast<uint8_t>(fileSize >> 24);
-        p[8] = 'W';
-        p[9] = 'A';
-        p[10] = 'V';
-        p[11] = 'E';
-        p[12] = 'f';
-        p[13] = 'm';
-        p[14] = 't';
-        p[15] = ' ';
-        p[16] = 16;
-        p[17] = 0;
-        p[18] = 0;
-        p[19] = 0;
-        p[20] = 1;
-        p[21] = 0;
-        p[22] = 1;
-        p[23] = 0;
-        p[24] = static_cast<uint8_t>(sampleRate);
-        p[25] = static_cast<uint8_t>(sampleRate >> 8);
-        p[26] = static_cast<uint8_t>(sampleRate >> 16);
-        p[27] = static_cast<uint8_t>(sampleRate >> 24);
-        const uint32_t byteRate = sampleRate * 2;
-        p[28] = static_cast<uint8_t>(byteRate);
-        p[29] = static_cast<uint8_t>(byteRate >> 8);
-        p[30] = static_cast<uint8_t>(byteRate >> 16);
-        p[31] = static_cast<uint8_t>(byteRate >> 24);
-        p[32] = 2;
-        p[33] = 0;
-        p[34] = 16;
-        p[35] = 0;
-        p[36] = 'd';
-        p[37] = 'a';
-        p[38] = 't';
-        p[39] = 'a';
-        p[40] = static_cast<uint8_t>(dataSize);
-        p[41] = static_cast<uint8_t>(dataSize >> 8);
-        p[42] = static_cast<uint8_t>(dataSize >> 16);
-        p[43] = static_cast<uint8_t>(dataSize >> 24);
-        std::memcpy(p + 44, pcm, dataSize);
-        return wav;
+        int16_t *out = static_cast<int16_t *>(buffer);
+        PS2AudioRing *ring = g_streamRing.load(std::memory_order_acquire);
+        const size_t got = ring ? ring->read(out, frames) : 0u;
+        std::fill(out + got * 2u, out + static_cast<size_t>(frames) * 2u, static_cast<int16_t>(0));
     }
+#endif
 }
 
 namespace ps2_vag
@@ -71,12 +37,12 @@ namespace ps2_vag
 
 struct PS2AudioBackend::Impl
 {
-    struct TrackedSound
-    {
-        Sound snd;
-        uint32_t sampleKey;
-    };
-    std::vector<TrackedSound> activeSounds;
+    PS2AudioRing ring{kRingFrames};
+    std::thread mixer;
+    std::atomic<bool> mixing{false};
+#if !defined(PLATFORM_VITA)
+    AudioStream stream{};
+#endif
 };
 
 PS2AudioBackend::PS2AudioBackend() : m_impl(std::make_unique<Impl>())
@@ -86,7 +52,74 @@ PS2AudioBackend::PS2AudioBackend() : m_impl(std::make_unique<Impl>())
 PS2AudioBackend::~PS2AudioBackend()
 {
     if (m_impl)
-        stopAll();
+        stopMixer();
+}
+
+void PS2AudioBackend::setAudioReady(bool ready)
+{
+    if (ready == m_audioReady)
+        return;
+    m_audioReady = ready;
+    if (ready)
+        startMixer();
+    else
+        stopMixer();
+}
+
+bool PS2AudioBackend::streaming() const
+{
+    return m_impl->mixing.load(std::memory_order_acquire);
+}
+
+void PS2AudioBackend::startMixer()
+{
+#if defined(PLATFORM_VITA)
+    return;
+#else
+    if (m_impl->mixing.load(std::memory_order_acquire))
+        return;
+
+    SetAudioStreamBufferSizeDefault(static_cast<int>(kMixBlockFrames * 2u));
+    m_impl->stream = LoadAudioStream(PS2Spu2::kOutputRate, 16, 2);
+    g_streamRing.store(&m_impl->ring, std::memory_order_release);
+    SetAudioStreamCallback(m_impl->stream, pullStreamFrames);
+    PlayAudioStream(m_impl->stream);
+
+    m_impl->mixing.store(true, std::memory_order_release);
+    m_impl->mixer = std::thread([this]()
+                                { mixerLoop(); });
+#endif
+}
+
+void PS2AudioBackend::stopMixer()
+{
+    m_impl->mixing.store(false, std::memory_order_release);
+    if (m_impl->mixer.joinable())
+        m_impl->mixer.join();
+#if !defined(PLATFORM_VITA)
+    if (g_streamRing.load(std::memory_order_acquire) == &m_impl->ring)
+    {
+        StopAudioStream(m_impl->stream);
+        UnloadAudioStream(m_impl->stream);
+        g_streamRing.store(nullptr, std::memory_order_release);
+        m_impl->stream = {};
+    }
+#endif
+}
+
+void PS2AudioBackend::mixerLoop()
+{
+    std::vector<int16_t> block(kMixBlockFrames * 2u);
+    while (m_impl->mixing.load(std::memory_order_acquire))
+    {
+        if (m_impl->ring.space() < kMixBlockFrames)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        m_spu2.mix(block.data(), kMixBlockFrames);
+        m_impl->ring.write(block.data(), kMixBlockFrames);
+    }
 }
 
 void PS2AudioBackend::onVagTransfer(const uint8_t *rdram, uint32_t srcAddr, uint32_t sizeBytes)
@@ -98,15 +131,11 @@ void PS2AudioBackend::onVagTransfer(const uint8_t *rdram, uint32_t srcAddr, uint
     if (physAddr + sizeBytes > PS2_RAM_SIZE)
         return;
 
-    std::vector<int16_t> pcm;
-    uint32_t sampleRate = 44100;
-    if (!ps2_vag::decode(rdram + physAddr, sizeBytes, pcm, sampleRate))
+    DecodedSample sample;
+    if (!decodeCached(rdram + physAddr, sizeBytes, sample))
         return;
 
     std::lock_guard<std::mutex> lock(m_mutex);
-    DecodedSample sample;
-    sample.pcm = std::move(pcm);
-    sample.sampleRate = sampleRate;
     m_sampleBank[physAddr] = std::move(sample);
     m_mostRecentSampleKey = physAddr;
 }
@@ -116,26 +145,87 @@ void PS2AudioBackend::onVagTransferFromBuffer(const uint8_t *data, uint32_t size
     if (!data || sizeBytes < 48)
         return;
 
+    DecodedSample sample;
+    if (!decodeCached(data, sizeBytes, sample))
+        return;
+
+    storeLoadedSample(keyAddr, std::move(sample));
+}
+
+uint64_t PS2AudioBackend::beginVagStream(uint32_t keyAddr)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint64_t streamId = m_nextVagStreamId++;
+    m_vagStreams[streamId].keyAddr = keyAddr;
+    return streamId;
+}
+
+void PS2AudioBackend::appendVagStream(uint64_t streamId, const int16_t *samples, size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_vagStreams.find(streamId);
+    if (it != m_vagStreams.end())
+        it->second.pcm.insert(it->second.pcm.end(), samples, samples + count);
+}
+
+void PS2AudioBackend::finishVagStream(uint64_t streamId, uint32_t sampleRate, uint64_t contentKey)
+{
+    PendingVagStream stream;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_vagStreams.find(streamId);
+        if (it == m_vagStreams.end())
+            return;
+        stream = std::move(it->second);
+        m_vagStreams.erase(it);
+    }
+
+    // The stream was decoded as it was read, so a hit here only saves
+    // keeping a second copy of the same bank.
+    DecodedSample sample;
+    sample.sampleRate = sampleRate;
+    sample.pcm = m_vagCache.find(contentKey);
+    if (!sample.pcm)
+        sample.pcm = m_vagCache.insert(contentKey, std::move(stream.pcm));
+
+    storeLoadedSample(stream.keyAddr, std::move(sample));
+}
+
+void PS2AudioBackend::abortVagStream(uint64_t streamId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_vagStreams.erase(streamId);
+}
+
+bool PS2AudioBackend::decodeCached(const uint8_t *data, uint32_t sizeBytes, DecodedSample &outSample)
+{
+    uint64_t key = 0;
+    if (!ps2_vag::contentKey(data, sizeBytes, key, outSample.sampleRate))
+        return false;
+
+    outSample.pcm = m_vagCache.find(key);
+    if (outSample.pcm)
+        return true;
+
     std::vector<int16_t> pcm;
     uint32_t sampleRate = 44100;
     if (!ps2_vag::decode(data, sizeBytes, pcm, sampleRate))
-        return;
+        return false;
+
+    outSample.pcm = m_vagCache.insert(key, std::move(pcm));
+    return true;
+}
 
+void PS2AudioBackend::storeLoadedSample(uint32_t keyAddr, DecodedSample &&sample)
+{
     const uint32_t physAddr = keyAddr & PS2_RAM_MASK;
     std::lock_guard<std::mutex> lock(m_mutex);
-    DecodedSample sample;
-    sample.pcm = std::move(pcm);
-    sample.sampleRate = sampleRate;
     m_sampleBank[physAddr] = sample;
     m_mostRecentSampleKey = physAddr;
-    m_loadOrderSamples.push_back(std::move(sample));
-    m_loadOrderSampleKeys.push_back(physAddr);
+    m_loadOrderSamples.push_back({physAddr, std::move(sample)});
     constexpr size_t kMaxLoadOrderSamples = 32;
     if (m_loadOrderSamples.size() > kMaxLoadOrderSamples)
-    {
-        m_loadOrderSamples.erase(m_loadOrderSamples.begin());
-        m_loadOrderSampleKeys.erase(m_loadOrderSampleKeys.begin());
-    }
+        m_loadOrderSamples.pop_front();
 }
 
 namespace
@@ -204,12 +294,10 @@ void PS2AudioBackend::play(uint32_t sampleAddr, float pitch, float volume, uint3
         sampleToPlay = &it->second;
         sampleKey = it->first;
     }
-    else if (voiceIndex != 0xFFFFFFFFu &&
-             voiceIndex < m_loadOrderSamples.size() &&
-             voiceIndex < m_loadOrderSampleKeys.size())
+    else if (voiceIndex != 0xFFFFFFFFu && voiceIndex < m_loadOrderSamples.size())
     {
-        sampleToPlay = &m_loadOrderSamples[voiceIndex];
-        sampleKey = m_loadOrderSampleKeys[voiceIndex];
+        sampleToPlay = &m_loadOrderSamples[voiceIndex].sample;
+        sampleKey = m_loadOrderSamples[voiceIndex].key;
     }
     else
     {
@@ -219,92 +307,28 @@ void PS2AudioBackend::play(uint32_t sampleAddr, float pitch, float volume, uint3
         sampleToPlay = &it->second;
         sampleKey = it->first;
     }
-    if (!sampleToPlay || sampleToPlay->pcm.empty())
+    if (!sampleToPlay || !sampleToPlay->pcm || sampleToPlay->pcm->empty())
         return;
 
-    const bool isBgm = (sampleToPlay->pcm.size() > static_cast<size_t>(sampleToPlay->sampleRate * 5));
+    const bool isBgm = (sampleToPlay->pcm->size() > static_cast<size_t>(sampleToPlay->sampleRate * 5));
     playDecodedSample(sampleKey, *sampleToPlay, pitch, volume, isBgm);
 }
 
-void PS2AudioBackend::pruneFinishedSounds()
-{
-#if defined(PLATFORM_VITA)
-    return;
-#else
-    auto &sounds = m_impl->activeSounds;
-    auto it = sounds.begin();
-    while (it != sounds.end())
-    {
-        if (!IsSoundPlaying(it->snd))
-        {
-            UnloadSound(it->snd);
-            it = sounds.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
-#endif
-}
-
-void PS2AudioBackend::playDecodedSample(uint32_t sampleKey, DecodedSample &sample, float pitch, float volume,
+void PS2AudioBackend::playDecodedSample(uint32_t sampleKey, const DecodedSample &sample, float pitch, float volume,
                                         bool isBgm)
 {
-#if defined(PLATFORM_VITA)
-    (void)sampleKey;
-    (void)sample;
-    (void)pitch;
-    (void)volume;
-    (void)isBgm;
-    return;
-#else
-    if (!m_audioReady || sample.pcm.empty())
+    if (!m_audioReady || !sample.pcm || sample.pcm->empty())
         return;
 
-    pruneFinishedSounds();
-
-    for (const auto &t : m_impl->activeSounds)
-    {
-        if (t.sampleKey == sampleKey && IsSoundPlaying(t.snd))
-            return;
-    }
+    if (m_spu2.samplePlaying(sampleKey))
+        return;
 
-    auto &sounds = m_impl->activeSounds;
+    // Long samples are treated as music and replace whatever else the host
+    // sample path is playing.
     if (isBgm)
-    {
-        for (auto it = sounds.begin(); it != sounds.end();)
-        {
-            if (IsSoundPlaying(it->snd))
-            {
-                StopSound(it->snd);
-                UnloadSound(it->snd);
-                it = sounds.erase(it);
-            }
-            else
-                ++it;
-        }
-    }
+        m_spu2.stopSamples();
 
-    constexpr int kMaxConcurrentSounds = 4;
-    while (static_cast<int>(sounds.size()) >= kMaxConcurrentSounds)
-    {
-        StopSound(sounds.front().snd);
-        UnloadSound(sounds.front().snd);
-        sounds.erase(sounds.begin());
-    }
-
-    std::vector<uint8_t> wav = buildWavFromPcm(sample.pcm.data(), sample.pcm.size(), sample.sampleRate);
-    Wave wave = LoadWaveFromMemory(".wav", wav.data(), static_cast<int>(wav.size()));
-    if (wave.frameCount <= 0)
-        return;
-    Sound snd = LoadSoundFromWave(wave);
-    UnloadWave(wave);
-    SetSoundPitch(snd, pitch);
-    SetSoundVolume(snd, volume);
-    m_impl->activeSounds.push_back({snd, sampleKey});
-    PlaySound(snd);
-#endif
+    m_spu2.keyOnSample(sample.pcm, sample.sampleRate, pitch, volume, sampleKey);
 }
 
 void PS2AudioBackend::stop(uint32_t voiceId)
@@ -314,15 +338,5 @@ void PS2AudioBackend::stop(uint32_t voiceId)
 
 void PS2AudioBackend::stopAll()
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-#if defined(PLATFORM_VITA)
-    return;
-#else
-    for (auto &t : m_impl->activeSounds)
-    {
-        StopSound(t.snd);
-        UnloadSound(t.snd);
-    }
-    m_impl->activeSounds.clear();
-#endif
+    m_spu2.stopSamples();
 }
@@ -1,3 +1,4 @@
+#include "runtime/ps2_audio.h"
 #include "runtime/ps2_memory.h"
 #include <algorithm>
 #include <cstdint>
@@ -14,101 +15,332 @@ namespace
         return static_cast<int16_t>(v);
     }
 
-    inline int8_t signExtend4(uint8_t nibble)
+    constexpr uint32_t kVagMagic = 0x56414770u;
+    constexpr size_t kVagHeaderBytes = 48;
+    constexpr size_t kVagBlockBytes = 16;
+    constexpr uint32_t kVagSamplesPerBlock = 28;
+
+    // Predictor coefficients in 1/64ths for the five SPU ADPCM filters.
+    constexpr int32_t kFilterOld[5] = {0, 60, 115, 98, 122};
+    constexpr int32_t kFilterOlder[5] = {0, 0, -52, -55, -60};
+
+    inline uint32_t readBe32(const uint8_t *p)
+    {
+        return (static_cast<uint32_t>(p[0]) << 24) |
+               (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) |
+               static_cast<uint32_t>(p[3]);
+    }
+
+    bool parseVagHeader(const uint8_t *header, uint32_t &sampleRate, uint32_t &blockCount)
+    {
+        const uint32_t magic = readBe32(header);
+        const uint32_t magicLE = (static_cast<uint32_t>(header[3]) << 24) |
+                                 (static_cast<uint32_t>(header[2]) << 16) |
+                                 (static_cast<uint32_t>(header[1]) << 8) |
+                                 static_cast<uint32_t>(header[0]);
+        if (magic != kVagMagic && magicLE != kVagMagic)
+            return false;
+
+        const uint32_t dataSize = readBe32(header + 0x0c);
+        sampleRate = readBe32(header + 0x10);
+        if (sampleRate == 0)
+            sampleRate = 44100;
+        blockCount = static_cast<uint32_t>((static_cast<uint64_t>(dataSize) + 15u) / 16u);
+        return true;
+    }
+
+    // Content hash over whole 16-byte blocks, two 64-bit lanes at a time.
+    // Not cryptographic; it only has to tell sound banks apart.
+    constexpr uint64_t kHashPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kHashPrime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t kHashPrime3 = 0x165667B19E3779F9ull;
+
+    inline uint64_t rotl64(uint64_t v, int r)
+    {
+        return (v << r) | (v >> (64 - r));
+    }
+
+    inline uint64_t hashSeed(uint32_t sampleRate)
+    {
+        return kHashPrime3 ^ (static_cast<uint64_t>(sampleRate) * kHashPrime1);
+    }
+
+    inline uint64_t hashBlock(uint64_t hash, const uint8_t *block)
+    {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        std::memcpy(&lo, block, sizeof(lo));
+        std::memcpy(&hi, block + 8, sizeof(hi));
+        hash = rotl64(hash ^ (lo * kHashPrime2), 31) * kHashPrime1;
+        hash = rotl64(hash ^ (hi * kHashPrime2), 27) * kHashPrime1 + kHashPrime3;
+        return hash;
+    }
+
+    inline uint64_t hashFinish(uint64_t hash, uint32_t blockCount)
     {
-        uint8_t s = nibble & 0x0F;
-        return static_cast<int8_t>((s & 8) ? static_cast<int8_t>(s | 0xF0) : static_cast<int8_t>(s));
+        hash ^= static_cast<uint64_t>(blockCount) * kHashPrime3;
+        hash ^= hash >> 33;
+        hash *= kHashPrime2;
+        hash ^= hash >> 29;
+        hash *= kHashPrime3;
+        hash ^= hash >> 32;
+        return hash;
     }
 }
 
-namespace ps2_vag
+PS2VagStreamDecoder::PS2VagStreamDecoder(PcmSink sink) : m_sink(std::move(sink))
 {
-    bool decode(const uint8_t *data, uint32_t sizeBytes,
-                std::vector<int16_t> &outPcm, uint32_t &outSampleRate)
+}
+
+bool PS2VagStreamDecoder::feed(const uint8_t *data, size_t size)
+{
+    if (m_state == State::Invalid)
+        return false;
+    if (!data)
+        return true;
+
+    size_t offset = 0;
+    if (m_state == State::Header)
     {
-        if (!data || sizeBytes < 48)
+        const size_t take = std::min(size, kVagHeaderBytes - m_headerFill);
+        std::memcpy(m_header + m_headerFill, data, take);
+        m_headerFill += take;
+        offset += take;
+        if (m_headerFill < kVagHeaderBytes)
+            return true;
+        parseHeader();
+        if (m_state == State::Invalid)
             return false;
+    }
 
-        const uint32_t magic = (static_cast<uint32_t>(data[0]) << 24) |
-                               (static_cast<uint32_t>(data[1]) << 16) |
-                               (static_cast<uint32_t>(data[2]) << 8) |
-                               static_cast<uint32_t>(data[3]);
-        if (magic != 0x56414770u)
+    while (m_state == State::Blocks && offset < size)
+    {
+        if (m_blockFill == 0 && size - offset >= kVagBlockBytes)
         {
-            const uint32_t magicLE = (static_cast<uint32_t>(data[3]) << 24) |
-                                     (static_cast<uint32_t>(data[2]) << 16) |
-                                     (static_cast<uint32_t>(data[1]) << 8) |
-                                     static_cast<uint32_t>(data[0]);
-            if (magicLE != 0x56414770u)
-                return false;
+            decodeBlock(data + offset);
+            offset += kVagBlockBytes;
+            continue;
         }
 
-        uint32_t dataSize = (static_cast<uint32_t>(data[0x0c]) << 24) |
-                            (static_cast<uint32_t>(data[0x0d]) << 16) |
-                            (static_cast<uint32_t>(data[0x0e]) << 8) |
-                            static_cast<uint32_t>(data[0x0f]);
-        outSampleRate = (static_cast<uint32_t>(data[0x10]) << 24) |
-                        (static_cast<uint32_t>(data[0x11]) << 16) |
-                        (static_cast<uint32_t>(data[0x12]) << 8) |
-                        static_cast<uint32_t>(data[0x13]);
-        if (outSampleRate == 0)
-            outSampleRate = 44100;
-
-        const uint32_t numBlocks = (dataSize + 15) / 16;
-        outPcm.clear();
-        outPcm.reserve(numBlocks * 28);
+        const size_t take = std::min(size - offset, kVagBlockBytes - m_blockFill);
+        std::memcpy(m_block + m_blockFill, data + offset, take);
+        m_blockFill += take;
+        offset += take;
+        if (m_blockFill == kVagBlockBytes)
+        {
+            m_blockFill = 0;
+            decodeBlock(m_block);
+        }
+    }
+    return true;
+}
+
+void PS2VagStreamDecoder::parseHeader()
+{
+    if (!parseVagHeader(m_header, m_sampleRate, m_blocksRemaining))
+    {
+        m_state = State::Invalid;
+        return;
+    }
+
+    m_chunkFill = 0;
+    m_s1 = 0;
+    m_s2 = 0;
+    m_blocksDecoded = 0;
+    m_hash = hashSeed(m_sampleRate);
+    m_state = m_blocksRemaining != 0 ? State::Blocks : State::Done;
+}
+
+uint64_t PS2VagStreamDecoder::contentKey() const
+{
+    return hashFinish(m_hash, m_blocksDecoded);
+}
+
+void PS2VagStreamDecoder::flush()
+{
+    if (m_chunkFill != 0 && m_sink)
+        m_sink(m_chunk.data(), m_chunkFill);
+    m_chunkFill = 0;
+}
+
+void PS2VagStreamDecoder::decodeBlock(const uint8_t *block)
+{
+    ps2_vag::decodeBlock(block, m_s1, m_s2, m_chunk.data() + m_chunkFill);
+    m_chunkFill += kVagSamplesPerBlock;
+    m_hash = hashBlock(m_hash, block);
+    ++m_blocksDecoded;
+
+    if (--m_blocksRemaining == 0)
+        m_state = State::Done;
+    if (m_chunkFill == m_chunk.size() || m_state == State::Done)
+        flush();
+}
+
+namespace ps2_vag
+{
+    void decodeBlock(const uint8_t *block, int16_t &s1, int16_t &s2, int16_t *out)
+    {
+        uint8_t shift = block[0] & 0x0F;
+        if (shift > 12)
+            shift = 9;
+        uint8_t filter = (block[0] >> 4) & 0x07;
+        if (filter > 4)
+            filter = 0;
 
-        int16_t s1 = 0, s2 = 0;
-        const uint8_t *block = data + 48;
+        // Nibble expansion has no cross-sample dependency, so it is kept in
+        // its own loop the compiler can vectorize.
+        const int32_t scale = 1 << (12 - shift);
+        int32_t shifted[kVagSamplesPerBlock];
+        for (uint32_t i = 0; i < kVagSamplesPerBlock / 2; ++i)
+        {
+            const uint32_t byte = block[2 + i];
+            shifted[2 * i] = (static_cast<int32_t>(byte << 28) >> 28) * scale;
+            shifted[2 * i + 1] = (static_cast<int32_t>(byte << 24) >> 28) * scale;
+        }
 
-        for (uint32_t b = 0; b < numBlocks && (block + 16) <= data + sizeBytes; ++b, block += 16)
+        if (filter == 0)
         {
-            uint8_t shift = block[0] & 0x0F;
-            if (shift > 12)
-                shift = 9;
-            uint8_t filter = (block[0] >> 4) & 0x07;
-            if (filter > 4)
-                filter = 0;
-
-            for (int sampleIdx = 0; sampleIdx < 28; ++sampleIdx)
-            {
-                const uint8_t byte = block[2 + sampleIdx / 2];
-                const uint8_t nibble = (sampleIdx & 1) ? (byte >> 4) : (byte & 0x0F);
-                const int8_t rawSample = signExtend4(nibble);
-                const int32_t shiftedSample = rawSample << (12 - shift);
-
-                int32_t filteredSample;
-                const int32_t old = s1;
-                const int32_t older = s2;
-                switch (filter)
-                {
-                case 0:
-                    filteredSample = shiftedSample;
-                    break;
-                case 1:
-                    filteredSample = shiftedSample + (60 * old + 32) / 64;
-                    break;
-                case 2:
-                    filteredSample = shiftedSample + (115 * old - 52 * older + 32) / 64;
-                    break;
-                case 3:
-                    filteredSample = shiftedSample + (98 * old - 55 * older + 32) / 64;
-                    break;
-                case 4:
-                    filteredSample = shiftedSample + (122 * old - 60 * older + 32) / 64;
-                    break;
-                default:
-                    filteredSample = shiftedSample;
-                    break;
-                }
-
-                const int16_t clamped = clamp16(filteredSample);
-                s2 = s1;
-                s1 = clamped;
-                outPcm.push_back(clamped);
-            }
+            for (uint32_t i = 0; i < kVagSamplesPerBlock; ++i)
+                out[i] = clamp16(shifted[i]);
+            s2 = out[kVagSamplesPerBlock - 2];
+            s1 = out[kVagSamplesPerBlock - 1];
+            return;
         }
 
+        // The predictor is a serial recurrence; hoisting the filter choice
+        // out leaves a branch-free multiply-add per sample.
+        const int32_t k0 = kFilterOld[filter];
+        const int32_t k1 = kFilterOlder[filter];
+        int32_t old = s1;
+        int32_t older = s2;
+        for (uint32_t i = 0; i < kVagSamplesPerBlock; ++i)
+        {
+            const int16_t sample = clamp16(shifted[i] + (k0 * old + k1 * older + 32) / 64);
+            out[i] = sample;
+            older = old;
+            old = sample;
+        }
+        s1 = static_cast<int16_t>(old);
+        s2 = static_cast<int16_t>(older);
+    }
+
+    bool contentKey(const uint8_t *data, uint32_t sizeBytes, uint64_t &outKey, uint32_t &outSampleRate)
+    {
+        uint32_t blockCount = 0;
+        if (!data || sizeBytes < kVagHeaderBytes || !parseVagHeader(data, outSampleRate, blockCount))
+            return false;
+
+        // Hash exactly the blocks a decode of the same bytes would consume.
+        blockCount = std::min<uint32_t>(blockCount, static_cast<uint32_t>((sizeBytes - kVagHeaderBytes) / kVagBlockBytes));
+        uint64_t hash = hashSeed(outSampleRate);
+        const uint8_t *block = data + kVagHeaderBytes;
+        for (uint32_t i = 0; i < blockCount; ++i, block += kVagBlockBytes)
+            hash = hashBlock(hash, block);
+        outKey = hashFinish(hash, blockCount);
+        return true;
+    }
+
+    bool decode(const uint8_t *data, uint32_t sizeBytes,
+                std::vector<int16_t> &outPcm, uint32_t &outSampleRate)
+    {
+        if (!data || sizeBytes < kVagHeaderBytes)
+            return false;
+
+        outPcm.clear();
+        outPcm.reserve(static_cast<size_t>((sizeBytes - kVagHeaderBytes) / kVagBlockBytes) * kVagSamplesPerBlock);
+        PS2VagStreamDecoder decoder([&outPcm](const int16_t *samples, size_t count)
+                                    { outPcm.insert(outPcm.end(), samples, samples + count); });
+        decoder.feed(data, sizeBytes);
+        if (!decoder.headerValid())
+            return false;
+
+        decoder.flush();
+        outSampleRate = decoder.sampleRate();
         return true;
     }
 }
+
+PS2VagCache::PS2VagCache(size_t budgetBytes) : m_budgetBytes(budgetBytes)
+{
+}
+
+PS2VagCache::Pcm PS2VagCache::find(uint64_t key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        ++m_misses;
+        return {};
+    }
+    ++m_hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return it->second.pcm;
+}
+
+PS2VagCache::Pcm PS2VagCache::insert(uint64_t key, std::vector<int16_t> &&pcm)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+        return it->second.pcm;
+    }
+
+    Entry entry;
+    entry.pcm = std::make_shared<const std::vector<int16_t>>(std::move(pcm));
+    m_lru.push_front(key);
+    entry.lru = m_lru.begin();
+    m_bytes += entry.pcm->size() * sizeof(int16_t);
+    Pcm result = entry.pcm;
+    m_entries.emplace(key, std::move(entry));
+    evictUnlocked();
+    return result;
+}
+
+void PS2VagCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+void PS2VagCache::evictUnlocked()
+{
+    // The newest entry always stays, even when it alone exceeds the budget.
+    // Evicted buffers live on in whatever sample bank or voice holds them.
+    while (m_bytes > m_budgetBytes && m_lru.size() > 1)
+    {
+        auto it = m_entries.find(m_lru.back());
+        m_bytes -= it->second.pcm->size() * sizeof(int16_t);
+        m_entries.erase(it);
+        m_lru.pop_back();
+    }
+}
+
+size_t PS2VagCache::sizeBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+size_t PS2VagCache::entryCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+uint64_t PS2VagCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+uint64_t PS2VagCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
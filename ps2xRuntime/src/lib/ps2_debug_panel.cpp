@@ -706,6 +706,20 @@ namespace
 
         ImGui::Text("Runtime: %s", runtime.isStopRequested() ? "stop requested" : "running");
         ImGui::Text("EE executor: %s", runtime.eeScheduler().isExecutingGuest() ? "guest" : "scheduler");
+
+        const PS2Runtime::GuestBranchStats branches = runtime.guestBranchStats();
+        const uint64_t indirect = branches.indirectCalls + branches.indirectJumps;
+        const uint64_t cacheLookups = branches.cacheHits + branches.cacheMisses;
+        ImGui::Text("Dispatch: %llu  indirect: %llu (%.1f%%)  IC hit: %.1f%%",
+                    static_cast<unsigned long long>(branches.dispatches),
+                    static_cast<unsigned long long>(indirect),
+                    branches.dispatches ? 100.0 * static_cast<double>(indirect) / static_cast<double>(branches.dispatches) : 0.0,
+                    cacheLookups ? 100.0 * static_cast<double>(branches.cacheHits) / static_cast<double>(cacheLookups) : 0.0);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Reset##branchstats"))
+        {
+            runtime.resetGuestBranchStats();
+        }
         ImGui::Separator();
         textHex32("PC", pc);
         ImGui::SameLine();
@@ -1761,27 +1775,34 @@ namespace
         struct FdRow
         {
             int fd = 0;
-            FILE *file = nullptr;
+            bool idle = false;
+            bool positional = false;
+            uint64_t position = 0;
         };
 
         std::vector<FdRow> fds;
+        for (size_t i = 0; i < g_fioDescriptors.size(); ++i)
         {
-            std::lock_guard<std::mutex> lock(g_fd_mutex);
-            fds.reserve(g_fileDescriptors.size());
-            for (const auto &[fd, file] : g_fileDescriptors)
+            FioDescriptor &desc = g_fioDescriptors[i];
+            if (desc.state.load(std::memory_order_acquire) != FioDescriptorState::Open)
             {
-                fds.push_back(FdRow{fd, file});
+                continue;
             }
+            // Never wait on a descriptor that is in the middle of a read.
+            std::unique_lock<std::mutex> lock(desc.mutex, std::try_to_lock);
+            fds.push_back(FdRow{kFioFirstFd + static_cast<int>(i),
+                                lock.owns_lock(),
+                                lock.owns_lock() && desc.reader.isOpen(),
+                                desc.position.load(std::memory_order_relaxed)});
         }
-        std::sort(fds.begin(), fds.end(), [](const FdRow &a, const FdRow &b)
-                  { return a.fd < b.fd; });
 
         ImGui::SeparatorText("FileIO descriptors");
-        ImGui::Text("Open host FILE* descriptors: %zu", fds.size());
-        if (ImGui::BeginTable("fileio_fds", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable, ImVec2(0, 90)))
+        ImGui::Text("Open host descriptors: %zu / %zu", fds.size(), g_fioDescriptors.size());
+        if (ImGui::BeginTable("fileio_fds", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable, ImVec2(0, 90)))
         {
             ImGui::TableSetupColumn("FD");
-            ImGui::TableSetupColumn("FILE*");
+            ImGui::TableSetupColumn("Access");
+            ImGui::TableSetupColumn("Position");
             ImGui::TableHeadersRow();
             for (const FdRow &row : fds)
             {
@@ -1789,7 +1810,9 @@ namespace
                 ImGui::TableNextColumn();
                 ImGui::Text("%d", row.fd);
                 ImGui::TableNextColumn();
-                ImGui::Text("%p", static_cast<void *>(row.file));
+                ImGui::TextUnformatted(!row.idle ? "busy" : (row.positional ? "positional" : "stdio"));
+                ImGui::TableNextColumn();
+                ImGui::Text("0x%llX", static_cast<unsigned long long>(row.position));
             }
             ImGui::EndTable();
         }
@@ -0,0 +1,154 @@
+#include "ps2_host_file.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <string>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+PS2HostFile::~PS2HostFile()
+{
+    close();
+}
+
+bool PS2HostFile::isOpen() const
+{
+#if defined(_WIN32)
+    return m_native != nullptr;
+#else
+    return m_native >= 0;
+#endif
+}
+
+bool PS2HostFile::open(std::string_view path)
+{
+    close();
+    if (path.empty())
+    {
+        return false;
+    }
+
+    const std::filesystem::path hostPath{std::string(path)};
+#if defined(_WIN32)
+    HANDLE native = ::CreateFileW(hostPath.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+    if (native == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size{};
+    if (!::GetFileSizeEx(native, &size) || size.QuadPart < 0)
+    {
+        ::CloseHandle(native);
+        return false;
+    }
+    m_native = native;
+    m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+    const int native = ::open(hostPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (native < 0)
+    {
+        return false;
+    }
+    struct stat info{};
+    if (::fstat(native, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        ::close(native);
+        return false;
+    }
+    m_native = native;
+    m_size = static_cast<uint64_t>(info.st_size);
+#endif
+    return true;
+}
+
+void PS2HostFile::close()
+{
+#if defined(_WIN32)
+    if (m_native)
+    {
+        ::CloseHandle(static_cast<HANDLE>(m_native));
+        m_native = nullptr;
+    }
+#else
+    if (m_native >= 0)
+    {
+        ::close(m_native);
+        m_native = -1;
+    }
+#endif
+    m_size = 0u;
+}
+
+bool PS2HostFile::readAt(uint64_t offset, void *destination, size_t size, size_t &bytesRead) const
+{
+    bytesRead = 0u;
+    if (!isOpen() || (!destination && size != 0u))
+    {
+        return false;
+    }
+
+    uint8_t *out = static_cast<uint8_t *>(destination);
+    while (bytesRead < size)
+    {
+        const uint64_t position = offset + bytesRead;
+#if defined(_WIN32)
+        if (position > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+        {
+            return false;
+        }
+        const DWORD wanted = static_cast<DWORD>(
+            std::min<size_t>(size - bytesRead, std::numeric_limits<DWORD>::max()));
+        OVERLAPPED request{};
+        request.Offset = static_cast<DWORD>(position & 0xFFFFFFFFull);
+        request.OffsetHigh = static_cast<DWORD>(position >> 32);
+        DWORD received = 0;
+        if (!::ReadFile(static_cast<HANDLE>(m_native), out + bytesRead, wanted, &received, &request))
+        {
+            if (::GetLastError() == ERROR_HANDLE_EOF)
+            {
+                break;
+            }
+            return false;
+        }
+#else
+        if (position > static_cast<uint64_t>(std::numeric_limits<off_t>::max()))
+        {
+            return false;
+        }
+        const size_t wanted = std::min<size_t>(size - bytesRead,
+                                               static_cast<size_t>(std::numeric_limits<ssize_t>::max()));
+        const ssize_t received = ::pread(m_native, out + bytesRead, wanted, static_cast<off_t>(position));
+        if (received < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+#endif
+        if (received == 0)
+        {
+            break;
+        }
+        bytesRead += static_cast<size_t>(received);
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Read-only host file used for positional reads. readAt never moves a shared
+// file position, so any number of threads may read the same file at once.
+class PS2HostFile
+{
+public:
+    PS2HostFile() = default;
+    ~PS2HostFile();
+
+    PS2HostFile(const PS2HostFile &) = delete;
+    PS2HostFile &operator=(const PS2HostFile &) = delete;
+
+    bool open(std::string_view path);
+    void close();
+
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] uint64_t size() const { return m_size; }
+
+    // Reads up to size bytes at offset. A short count without an error means
+    // the read reached end of file.
+    bool readAt(uint64_t offset, void *destination, size_t size, size_t &bytesRead) const;
+
+private:
+#if defined(_WIN32)
+    void *m_native = nullptr;
+#else
+    int m_native = -1;
+#endif
+    uint64_t m_size = 0u;
+};
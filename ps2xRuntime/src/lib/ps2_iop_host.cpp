@@ -12,27 +12,24 @@
 #include <filesystem>
 #include <iostream>
 #include <limits>
+#include <thread>
 #include <utility>
+#include <vector>
 
-#if !defined(_WIN32)
-#include <sys/types.h>
-#endif
+thread_local PS2IopHostAdapter::CallScope::ActiveCall PS2IopHostAdapter::s_activeCall;
 
 PS2IopHostAdapter::CallScope::CallScope(PS2IopHostAdapter &owner, R5900Context *context, uint8_t *rdram)
     : m_lock(owner.m_callMutex),
       m_owner(&owner),
-      m_previousContext(owner.m_activeContext),
-      m_previousRdram(owner.m_activeRdram),
-      m_previousToken(owner.m_activeToken)
+      m_previous(s_activeCall)
 {
     m_token = owner.m_nextToken++;
     if (m_token == 0)
     {
         m_token = owner.m_nextToken++;
     }
-    owner.m_activeContext = context;
-    owner.m_activeRdram = rdram;
-    owner.m_activeToken = m_token;
+    const uint32_t depth = m_previous.owner == &owner ? m_previous.depth + 1u : 1u;
+    s_activeCall = ActiveCall{&owner, context, rdram, m_token, depth};
 }
 
 PS2IopHostAdapter::CallScope::~CallScope()
@@ -43,9 +40,7 @@ PS2IopHostAdapter::CallScope::~CallScope()
 PS2IopHostAdapter::CallScope::CallScope(CallScope &&other) noexcept
     : m_lock(std::move(other.m_lock)),
       m_owner(std::exchange(other.m_owner, nullptr)),
-      m_previousContext(other.m_previousContext),
-      m_previousRdram(other.m_previousRdram),
-      m_previousToken(other.m_previousToken),
+      m_previous(other.m_previous),
       m_token(other.m_token)
 {
 }
@@ -57,9 +52,7 @@ PS2IopHostAdapter::CallScope &PS2IopHostAdapter::CallScope::operator=(CallScope
         release();
         m_lock = std::move(other.m_lock);
         m_owner = std::exchange(other.m_owner, nullptr);
-        m_previousContext = other.m_previousContext;
-        m_previousRdram = other.m_previousRdram;
-        m_previousToken = other.m_previousToken;
+        m_previous = other.m_previous;
         m_token = other.m_token;
     }
     return *this;
@@ -69,43 +62,69 @@ void PS2IopHostAdapter::CallScope::release()
 {
     if (m_owner)
     {
-        m_owner->m_activeContext = m_previousContext;
-        m_owner->m_activeRdram = m_previousRdram;
-        m_owner->m_activeToken = m_previousToken;
+        s_activeCall = m_previous;
         m_owner = nullptr;
     }
 }
 
-PS2IopHostAdapter::PS2IopHostAdapter(PS2Runtime &runtime)
-    : m_runtime(runtime)
+// Releases every level of m_callMutex this thread holds for the duration
+// of a host read and takes them back afterwards. The thread's active call
+// is thread local, so nothing another call does in between is visible to
+// it; the module making the read has to keep its own state consistent.
+class PS2IopHostAdapter::HostIoWindow
 {
-}
+public:
+    explicit HostIoWindow(PS2IopHostAdapter &owner)
+        : m_owner(owner),
+          m_depth(s_activeCall.owner == &owner ? s_activeCall.depth : 0u)
+    {
+        for (uint32_t i = 0; i < m_depth; ++i)
+        {
+            m_owner.m_callMutex.unlock();
+        }
+    }
 
-PS2IopHostAdapter::~PS2IopHostAdapter()
-{
-    std::lock_guard<std::mutex> lock(m_hostFileMutex);
-    for (auto &[handle, file] : m_hostFiles)
+    ~HostIoWindow()
     {
-        (void)handle;
-        if (file.stream)
+        for (uint32_t i = 0; i < m_depth; ++i)
         {
-            std::fclose(file.stream);
+            m_owner.m_callMutex.lock();
         }
     }
-    m_hostFiles.clear();
+
+    HostIoWindow(const HostIoWindow &) = delete;
+    HostIoWindow &operator=(const HostIoWindow &) = delete;
+
+private:
+    PS2IopHostAdapter &m_owner;
+    uint32_t m_depth;
+};
+
+PS2IopHostAdapter::PS2IopHostAdapter(PS2Runtime &runtime)
+    : m_runtime(runtime)
+{
 }
 
+PS2IopHostAdapter::~PS2IopHostAdapter() = default;
+
 PS2IopHostAdapter::CallScope PS2IopHostAdapter::enterCall(R5900Context *context, uint8_t *rdram)
 {
     return CallScope(*this, context, rdram);
 }
 
+uint8_t *PS2IopHostAdapter::activeRdram() const
+{
+    if (s_activeCall.owner == this && s_activeCall.rdram)
+    {
+        return s_activeCall.rdram;
+    }
+    return m_runtime.memory().getRDRAM();
+}
+
 bool PS2IopHostAdapter::guestRange(uint32_t address, size_t size, uint8_t *&begin) const
 {
     begin = nullptr;
-    uint8_t *const rdram = m_activeRdram
-                               ? m_activeRdram
-                               : m_runtime.memory().getRDRAM();
+    uint8_t *const rdram = activeRdram();
     if (!rdram)
     {
         return false;
@@ -170,7 +189,7 @@ bool PS2IopHostAdapter::writeGuest(uint32_t address, const void *source, size_t
     }
     if (size != 0)
     {
-        uint8_t *const rdram = m_activeRdram ? m_activeRdram : m_runtime.memory().getRDRAM();
+        uint8_t *const rdram = activeRdram();
         ps2TraceGuestRangeWrite(rdram, address, static_cast<uint32_t>(size), "IopHost::writeGuest", nullptr);
         std::memcpy(destination, source, size);
     }
@@ -191,7 +210,7 @@ bool PS2IopHostAdapter::zeroGuest(uint32_t address, size_t size)
     }
     if (size != 0)
     {
-        uint8_t *const rdram = m_activeRdram ? m_activeRdram : m_runtime.memory().getRDRAM();
+        uint8_t *const rdram = activeRdram();
         ps2TraceGuestRangeWrite(rdram, address, static_cast<uint32_t>(size), "IopHost::zeroGuest", nullptr);
         std::memset(destination, 0, size);
     }
@@ -217,9 +236,7 @@ bool PS2IopHostAdapter::normalizeGuestAddress(uint32_t address, uint32_t &normal
 
 uint32_t PS2IopHostAdapter::allocateIopHandle(ps2x::iop::IopHandleKind kind)
 {
-    uint8_t *const rdram = m_activeRdram
-                               ? m_activeRdram
-                               : m_runtime.memory().getRDRAM();
+    uint8_t *const rdram = activeRdram();
     if (!rdram)
     {
         return 0;
@@ -286,52 +303,69 @@ std::string PS2IopHostAdapter::translateGuestPath(std::string_view path) const
     return translatePs2Path(std::string(path).c_str());
 }
 
-uint64_t PS2IopHostAdapter::openHostFile(std::string_view path)
+const PS2IopHostAdapter::HostFileSlot *PS2IopHostAdapter::acquireHostFile(uint64_t handle) const
 {
-    if (path.empty())
+    const uint64_t slotNumber = handle & kHostFileSlotMask;
+    if (slotNumber == 0u || slotNumber > kMaxHostFiles)
     {
-        return 0u;
+        return nullptr;
     }
 
-    const std::filesystem::path hostPath{std::string(path)};
-#if defined(_WIN32)
-    std::FILE *stream = ::_wfopen(hostPath.c_str(), L"rb");
-#else
-    std::FILE *stream = std::fopen(hostPath.string().c_str(), "rb");
-#endif
-    if (!stream)
+    // Pin first, then confirm the handle; closeHostFile clears the handle
+    // before it waits for users, so a reader either fails here or is waited on.
+    const HostFileSlot &slot = m_hostFiles[slotNumber - 1u];
+    slot.users.fetch_add(1u);
+    if (slot.handle.load() != handle)
     {
-        return 0u;
+        releaseHostFile(slot);
+        return nullptr;
     }
+    return &slot;
+}
+
+void PS2IopHostAdapter::releaseHostFile(const HostFileSlot &slot)
+{
+    slot.users.fetch_sub(1u, std::memory_order_release);
+}
 
-    std::error_code error;
-    const uint64_t size = std::filesystem::file_size(hostPath, error);
-    if (error)
+uint64_t PS2IopHostAdapter::openHostFile(std::string_view path)
+{
+    if (path.empty())
     {
-        std::fclose(stream);
         return 0u;
     }
 
-    std::lock_guard<std::mutex> lock(m_hostFileMutex);
-    uint64_t handle = m_nextHostFileHandle++;
-    if (handle == 0u)
+    std::lock_guard<std::mutex> lock(m_hostFileSlotMutex);
+    for (size_t index = 0; index < m_hostFiles.size(); ++index)
     {
-        handle = m_nextHostFileHandle++;
+        HostFileSlot &slot = m_hostFiles[index];
+        if (slot.handle.load(std::memory_order_relaxed) != 0u || slot.file.isOpen())
+        {
+            continue;
+        }
+        if (!slot.file.open(path))
+        {
+            return 0u;
+        }
+
+        const uint64_t generation = m_nextHostFileGeneration++;
+        const uint64_t handle = (generation << 16) | static_cast<uint64_t>(index + 1u);
+        slot.handle.store(handle, std::memory_order_release);
+        return handle;
     }
-    m_hostFiles.emplace(handle, HostFile{stream, size});
-    return handle;
+    return 0u;
 }
 
 bool PS2IopHostAdapter::hostFileSize(uint64_t handle, uint64_t &size) const
 {
     size = 0u;
-    std::lock_guard<std::mutex> lock(m_hostFileMutex);
-    const auto it = m_hostFiles.find(handle);
-    if (it == m_hostFiles.end() || !it->second.stream)
+    const HostFileSlot *slot = acquireHostFile(handle);
+    if (!slot)
     {
         return false;
     }
-    size = it->second.size;
+    size = slot->file.size();
+    releaseHostFile(*slot);
     return true;
 }
 
@@ -347,52 +381,78 @@ bool PS2IopHostAdapter::readHostFile(uint64_t handle,
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(m_hostFileMutex);
-    const auto it = m_hostFiles.find(handle);
-    if (it == m_hostFiles.end() || !it->second.stream)
+    const HostFileSlot *slot = acquireHostFile(handle);
+    if (!slot)
     {
         return false;
     }
+    const bool ok = slot->file.readAt(offset, destination, size, bytesRead);
+    releaseHostFile(*slot);
+    return ok;
+}
 
-#if defined(_WIN32)
-    if (offset > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ||
-        _fseeki64(it->second.stream, static_cast<int64_t>(offset), SEEK_SET) != 0)
-#else
-    if (offset > static_cast<uint64_t>(std::numeric_limits<off_t>::max()) ||
-        fseeko(it->second.stream, static_cast<off_t>(offset), SEEK_SET) != 0)
-#endif
+bool PS2IopHostAdapter::readHostFileIntoGuest(uint64_t handle,
+                                              uint64_t offset,
+                                              uint32_t guestAddress,
+                                              size_t size,
+                                              size_t &bytesRead)
+{
+    bytesRead = 0u;
+    if (ps2_stubs::isSifIopHeapAddress(guestAddress))
+    {
+        // The private IOP heap has no RDRAM backing to read into directly.
+        std::vector<uint8_t> staging(size);
+        return readHostFile(handle, offset, staging.data(), size, bytesRead) &&
+               (bytesRead == 0u || ps2_stubs::writeSifIopHeap(guestAddress, staging.data(), bytesRead));
+    }
+
+    uint8_t *destination = nullptr;
+    if (!guestRange(guestAddress, size, destination))
     {
         return false;
     }
 
-    bytesRead = size == 0u
-                    ? 0u
-                    : std::fread(destination, 1u, size, it->second.stream);
-    if (bytesRead < size && std::ferror(it->second.stream))
+    const HostFileSlot *slot = acquireHostFile(handle);
+    if (!slot)
     {
-        std::clearerr(it->second.stream);
         return false;
     }
-    return true;
+    bool ok = false;
+    {
+        HostIoWindow unlocked(*this);
+        ok = slot->file.readAt(offset, destination, size, bytesRead);
+    }
+    releaseHostFile(*slot);
+
+    if (bytesRead != 0u)
+    {
+        uint8_t *const rdram = activeRdram();
+        ps2TraceGuestRangeWrite(rdram, guestAddress, static_cast<uint32_t>(bytesRead),
+                                "IopHost::readHostFileIntoGuest", nullptr);
+    }
+    return ok;
 }
 
 void PS2IopHostAdapter::closeHostFile(uint64_t handle)
 {
-    std::FILE *stream = nullptr;
+    const uint64_t slotNumber = handle & kHostFileSlotMask;
+    if (handle == 0u || slotNumber == 0u || slotNumber > kMaxHostFiles)
     {
-        std::lock_guard<std::mutex> lock(m_hostFileMutex);
-        const auto it = m_hostFiles.find(handle);
-        if (it == m_hostFiles.end())
-        {
-            return;
-        }
-        stream = it->second.stream;
-        m_hostFiles.erase(it);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_hostFileSlotMutex);
+    HostFileSlot &slot = m_hostFiles[slotNumber - 1u];
+    uint64_t expected = handle;
+    if (!slot.handle.compare_exchange_strong(expected, 0u))
+    {
+        return;
     }
-    if (stream)
+    while (slot.users.load(std::memory_order_acquire) != 0u)
     {
-        std::fclose(stream);
+        std::this_thread::yield();
     }
+    slot.file.close();
 }
 
 int32_t PS2IopHostAdapter::memoryCard(const ps2x::iop::MemoryCardRequest &request)
@@ -461,7 +521,7 @@ int32_t PS2IopHostAdapter::memoryCard(const ps2x::iop::MemoryCardRequest &reques
     // EE n32 ABI: the fifth argument travels in $t0, matching the sceMc* stubs.
     setRegU32(&context, 8, request.arguments[4]);
 
-    handler(m_activeRdram ? m_activeRdram : m_runtime.memory().getRDRAM(),
+    handler(activeRdram(),
             &context,
             &m_runtime);
     return ps2_stubs::getMemoryCardDebugSnapshot().lastResult;
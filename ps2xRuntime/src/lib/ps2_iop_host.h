@@ -1,11 +1,12 @@
 #pragma once
 
 #include "ps2x/iop/iop_host.h"
+#include "ps2_host_file.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <cstdio>
 #include <mutex>
-#include <unordered_map>
 
 class PS2Runtime;
 struct R5900Context;
@@ -32,10 +33,18 @@ public:
 
         std::unique_lock<std::recursive_mutex> m_lock;
         PS2IopHostAdapter *m_owner = nullptr;
-        R5900Context *m_previousContext = nullptr;
-        uint8_t *m_previousRdram = nullptr;
-        uint64_t m_previousToken = 0;
+        struct ActiveCall
+        {
+            const PS2IopHostAdapter *owner = nullptr;
+            R5900Context *context = nullptr;
+            uint8_t *rdram = nullptr;
+            uint64_t token = 0;
+            uint32_t depth = 0;
+        };
+        ActiveCall m_previous;
         uint64_t m_token = 0;
+
+        friend class PS2IopHostAdapter;
     };
 
     explicit PS2IopHostAdapter(PS2Runtime &runtime);
@@ -66,6 +75,11 @@ public:
                       void *destination,
                       size_t size,
                       size_t &bytesRead) override;
+    bool readHostFileIntoGuest(uint64_t handle,
+                               uint64_t offset,
+                               uint32_t guestAddress,
+                               size_t size,
+                               size_t &bytesRead) override;
     void closeHostFile(uint64_t handle) override;
 
     int32_t memoryCard(const ps2x::iop::MemoryCardRequest &request) override;
@@ -85,19 +99,35 @@ private:
     friend class CallScope;
 
     bool guestRange(uint32_t address, size_t size, uint8_t *&begin) const;
+    uint8_t *activeRdram() const;
+
+    // Every IOP call holds m_callMutex, so modules see one call at a time.
+    // The call being served on each thread is tracked per thread, which
+    // lets a host file read drop the mutex while it waits on the disk and
+    // other modules' RPCs run in the meantime.
+    static thread_local CallScope::ActiveCall s_activeCall;
+    class HostIoWindow;
 
     PS2Runtime &m_runtime;
     std::recursive_mutex m_callMutex;
-    R5900Context *m_activeContext = nullptr;
-    uint8_t *m_activeRdram = nullptr;
-    uint64_t m_activeToken = 0;
     uint64_t m_nextToken = 1;
-    struct HostFile
+
+    // Host file handles are (generation << 16) | (slot + 1). Lookups pin a
+    // slot through its user count and never lock; open and close serialize
+    // on m_hostFileSlotMutex, and close waits for pinned readers to drain.
+    static constexpr size_t kMaxHostFiles = 256u;
+    static constexpr uint64_t kHostFileSlotMask = 0xFFFFu;
+    struct HostFileSlot
     {
-        std::FILE *stream = nullptr;
-        uint64_t size = 0u;
+        std::atomic<uint64_t> handle{0u};
+        mutable std::atomic<uint32_t> users{0u};
+        PS2HostFile file;
     };
-    mutable std::mutex m_hostFileMutex;
-    std::unordered_map<uint64_t, HostFile> m_hostFiles;
-    uint64_t m_nextHostFileHandle = 1u;
+
+    const HostFileSlot *acquireHostFile(uint64_t handle) const;
+    static void releaseHostFile(const HostFileSlot &slot);
+
+    std::mutex m_hostFileSlotMutex;
+    std::array<HostFileSlot, kMaxHostFiles> m_hostFiles;
+    uint64_t m_nextHostFileGeneration = 1u;
 };
@@ -0,0 +1,692 @@
+#include "runtime/ps2_ipu.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    using ps2_mpeg::BitReader;
+
+    constexpr size_t kQwordBits = PS2Ipu::kQwordBytes * 8u;
+    // The FIFO plus the two-qword bitstream buffer in front of it.
+    constexpr size_t kBufferedQwords = PS2Ipu::kFifoQwords + 2u;
+
+    constexpr size_t kRaw8MacroblockBytes = 384u;
+    constexpr size_t kRaw16MacroblockBytes = 768u;
+    constexpr size_t kRgb32MacroblockBytes = 1024u;
+    constexpr size_t kRgb16MacroblockBytes = 512u;
+    constexpr size_t kIndx4MacroblockBytes = 128u;
+
+    // IPU_CTRL fields written by software; RST reads back as last written.
+    constexpr uint32_t kCtrlWritableMask = 0x47F30000u;
+    constexpr uint32_t kCtrlReset = 1u << 30u;
+    constexpr uint32_t kCtrlAlternateScan = 1u << 20u;
+    constexpr uint32_t kCtrlIntraVlcFormat = 1u << 21u;
+    constexpr uint32_t kCtrlQuantiserType = 1u << 22u;
+    constexpr uint32_t kCtrlMpeg1 = 1u << 23u;
+
+    // Command bits shared by several opcodes.
+    constexpr uint32_t kCmdForwardBitsMask = 0x3Fu;
+    constexpr uint32_t kCmdIdecDecodeDctType = 1u << 24u;
+    constexpr uint32_t kCmdIdecSigned = 1u << 25u;
+    constexpr uint32_t kCmdBdecDctType = 1u << 25u;
+    constexpr uint32_t kCmdBdecResetDc = 1u << 26u;
+    constexpr uint32_t kCmdBdecIntra = 1u << 27u;
+    constexpr uint32_t kCmdDither = 1u << 26u;
+    constexpr uint32_t kCmdRgb16 = 1u << 27u;
+    constexpr uint32_t kCmdSetiqNonIntra = 1u << 27u;
+
+    // RGB555 grey ramp from black to white.
+    constexpr std::array<uint16_t, 16> makeDefaultVqClut()
+    {
+        std::array<uint16_t, 16> clut{};
+        for (uint32_t i = 0; i < clut.size(); ++i)
+        {
+            const uint32_t level = (i * 31u + 7u) / 15u;
+            clut[i] = static_cast<uint16_t>(level | (level << 5u) | (level << 10u));
+        }
+        return clut;
+    }
+
+    constexpr std::array<uint16_t, 16> kDefaultVqClut = makeDefaultVqClut();
+
+    constexpr int kDitherMatrix[4][4] = {
+        {-4, 0, -3, 1},
+        {2, -2, 3, -1},
+        {-3, 1, -4, 0},
+        {3, -1, 2, -2}};
+
+    inline bool hasBits(const BitReader &reader, size_t count)
+    {
+        return reader.position() + count <= reader.bitSize();
+    }
+
+    inline uint32_t forwardBits(uint32_t command)
+    {
+        return command & kCmdForwardBitsMask;
+    }
+
+    inline uint16_t packRgb16(int r, int g, int b, uint8_t alpha)
+    {
+        return static_cast<uint16_t>((r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10) | (alpha != 0u ? 0x8000 : 0));
+    }
+
+    // RGB32 16x16 macroblock to RGB16, optionally with the 4x4 ordered dither.
+    void packMacroblockRgb16(const uint8_t *rgba, bool dither, uint8_t *dst)
+    {
+        for (size_t y = 0; y < 16u; ++y)
+        {
+            for (size_t x = 0; x < 16u; ++x)
+            {
+                const uint8_t *pixel = rgba + (y * 16u + x) * 4u;
+                int r = pixel[0];
+                int g = pixel[1];
+                int b = pixel[2];
+                if (dither)
+                {
+                    const int offset = kDitherMatrix[y & 3u][x & 3u];
+                    r = std::clamp(r + offset, 0, 255);
+                    g = std::clamp(g + offset, 0, 255);
+                    b = std::clamp(b + offset, 0, 255);
+                }
+                const uint16_t packed = packRgb16(r, g, b, pixel[3]);
+                dst[(y * 16u + x) * 2u] = static_cast<uint8_t>(packed);
+                dst[(y * 16u + x) * 2u + 1u] = static_cast<uint8_t>(packed >> 8u);
+            }
+        }
+    }
+
+    // Nearest CLUT entry by squared RGB distance; ties keep the lower index.
+    uint8_t quantizeToClut(const uint8_t *pixel, const std::array<uint16_t, 16> &clut)
+    {
+        const int r = pixel[0] >> 3;
+        const int g = pixel[1] >> 3;
+        const int b = pixel[2] >> 3;
+        uint8_t best = 0u;
+        int bestDistance = 1 << 30;
+        for (size_t index = 0; index < clut.size(); ++index)
+        {
+            const int dr = r - static_cast<int>(clut[index] & 0x1Fu);
+            const int dg = g - static_cast<int>((clut[index] >> 5u) & 0x1Fu);
+            const int db = b - static_cast<int>((clut[index] >> 10u) & 0x1Fu);
+            const int distance = dr * dr + dg * dg + db * db;
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                best = static_cast<uint8_t>(index);
+            }
+        }
+        return best;
+    }
+}
+
+PS2Ipu::PS2Ipu()
+{
+    loadDefaultTables();
+}
+
+void PS2Ipu::loadDefaultTables()
+{
+    std::copy(std::begin(ps2_mpeg::kDefaultIntraMatrix), std::end(ps2_mpeg::kDefaultIntraMatrix),
+              m_intraMatrix.begin());
+    std::copy(std::begin(ps2_mpeg::kDefaultNonIntraMatrix), std::end(ps2_mpeg::kDefaultNonIntraMatrix),
+              m_nonIntraMatrix.begin());
+    m_clut = kDefaultVqClut;
+}
+
+void PS2Ipu::reset()
+{
+    m_input.clear();
+    m_bitPos = 0u;
+    m_output.clear();
+    m_outputRead = 0u;
+    m_control = 0u;
+    m_command = 0u;
+    m_data = 0u;
+    m_codedBlockPattern = 0u;
+    m_pending = false;
+    m_errorCode = false;
+    m_startCode = false;
+    m_commandStarted = false;
+    m_unitsDone = 0u;
+    m_quantiserCode = 0;
+    m_dcPredictors[0] = m_dcPredictors[1] = m_dcPredictors[2] = 128;
+}
+
+void PS2Ipu::writeControl(uint32_t value)
+{
+    if ((value & kCtrlReset) != 0u)
+        reset();
+    m_control = value & kCtrlWritableMask;
+}
+
+void PS2Ipu::writeCommand(uint32_t value)
+{
+    m_command = value;
+    m_errorCode = false;
+    m_startCode = false;
+    m_commandStarted = false;
+    m_unitsDone = 0u;
+
+    const uint32_t opcode = value >> 28u;
+    if (opcode == kBclr)
+    {
+        // Clears the input FIFO; BP applies to the first qword written next.
+        m_input.clear();
+        m_bitPos = value & 0x7Fu;
+        m_pending = false;
+        topUp();
+        return;
+    }
+    if (opcode == kSetth)
+    {
+        m_threshold0 = value & 0x1FFu;
+        m_threshold1 = (value >> 16u) & 0x1FFu;
+        m_pending = false;
+        return;
+    }
+    if (opcode > kSetth)
+    {
+        m_pending = false;
+        return;
+    }
+
+    m_pending = true;
+    topUp();
+    run();
+}
+
+uint64_t PS2Ipu::readCommand() const
+{
+    return static_cast<uint64_t>(m_data) | (m_pending ? (1ull << 63u) : 0ull);
+}
+
+uint32_t PS2Ipu::readControl() const
+{
+    const uint32_t queued = static_cast<uint32_t>(queuedQwords());
+    const uint32_t inputCount = queued > 2u ? std::min<uint32_t>(queued - 2u, kFifoQwords) : 0u;
+    const uint32_t outputCount = static_cast<uint32_t>(std::min(outputQwords(), kFifoQwords));
+    return inputCount | (outputCount << 4u) | ((m_codedBlockPattern & 0x3Fu) << 8u) |
+           (m_errorCode ? (1u << 14u) : 0u) | (m_startCode ? (1u << 15u) : 0u) | m_control |
+           (m_pending ? (1u << 31u) : 0u);
+}
+
+uint32_t PS2Ipu::readBitPointer() const
+{
+    const uint32_t queued = static_cast<uint32_t>(queuedQwords());
+    const uint32_t bufferCount = std::min<uint32_t>(queued, 2u);
+    const uint32_t inputCount = std::min<uint32_t>(queued - bufferCount, kFifoQwords);
+    return static_cast<uint32_t>(m_bitPos & 0x7Fu) | (inputCount << 8u) | (bufferCount << 16u);
+}
+
+uint64_t PS2Ipu::readTop()
+{
+    if (m_input.size() * 8u < m_bitPos + 32u)
+        topUp();
+    const BitReader reader(m_input.data(), m_input.size(), m_bitPos);
+    const bool ready = hasBits(reader, 32u);
+    return static_cast<uint64_t>(reader.peek(32u)) | ((ready && !m_pending) ? 0ull : (1ull << 63u));
+}
+
+void PS2Ipu::writeInput(const uint8_t qword[kQwordBytes])
+{
+    m_input.insert(m_input.end(), qword, qword + kQwordBytes);
+    if (m_pending)
+        run();
+}
+
+bool PS2Ipu::readOutput(uint8_t qword[kQwordBytes])
+{
+    if (outputQwords() == 0u)
+        return false;
+    std::memcpy(qword, m_output.data() + m_outputRead, kQwordBytes);
+    m_outputRead += kQwordBytes;
+    if (m_outputRead == m_output.size())
+    {
+        m_output.clear();
+        m_outputRead = 0u;
+    }
+    return true;
+}
+
+bool PS2Ipu::resume()
+{
+    topUp();
+    if (m_pending)
+        run();
+    return m_pending;
+}
+
+void PS2Ipu::run()
+{
+    // Each retry after starvation pulls another FIFO's worth; commands
+    // checkpoint per macroblock so nothing is decoded twice for long.
+    while (m_pending)
+    {
+        if (execute() == Progress::Done)
+        {
+            m_pending = false;
+            discardConsumedInput();
+            topUp();
+            break;
+        }
+        if (!pull(kFifoQwords))
+            break;
+    }
+}
+
+bool PS2Ipu::pull(size_t qwords)
+{
+    if (!m_pull)
+        return false;
+    uint8_t qword[kQwordBytes];
+    size_t pulled = 0u;
+    while (pulled < qwords && m_pull(qword))
+    {
+        m_input.insert(m_input.end(), qword, qword + kQwordBytes);
+        ++pulled;
+    }
+    return pulled != 0u;
+}
+
+void PS2Ipu::topUp()
+{
+    discardConsumedInput();
+    if (queuedQwords() < kBufferedQwords)
+        pull(kBufferedQwords - queuedQwords());
+}
+
+void PS2Ipu::discardConsumedInput()
+{
+    const size_t consumedQwords = std::min(m_bitPos / kQwordBits, queuedQwords());
+    if (consumedQwords == 0u)
+        return;
+    m_input.erase(m_input.begin(), m_input.begin() + static_cast<std::ptrdiff_t>(consumedQwords * kQwordBytes));
+    m_bitPos -= consumedQwords * kQwordBits;
+}
+
+PS2Ipu::Progress PS2Ipu::execute()
+{
+    switch (m_command >> 28u)
+    {
+    case kIdec:
+        return executeIdec();
+    case kBdec:
+        return executeBdec();
+    case kVdec:
+        return executeVdec();
+    case kFdec:
+        return executeFdec();
+    case kSetiq:
+        return executeTable(kSetiq);
+    case kSetvq:
+        return executeTable(kSetvq);
+    case kCsc:
+        return executeCsc();
+    case kPack:
+        return executePack();
+    default:
+        return Progress::Done;
+    }
+}
+
+PS2Ipu::Progress PS2Ipu::failOrStarve(const BitReader &reader)
+{
+    if (reader.overrun() || !hasBits(reader, 32u))
+        return Progress::Starved;
+    m_errorCode = true;
+    return Progress::Done;
+}
+
+ps2_mpeg::BlockCoding PS2Ipu::blockCoding(int quantiserCode) const
+{
+    ps2_mpeg::BlockCoding coding;
+    coding.mpeg1 = (m_control & kCtrlMpeg1) != 0u;
+    coding.scan = (m_control & kCtrlAlternateScan) != 0u ? ps2_mpeg::kAlternateScan : ps2_mpeg::kZigzagScan;
+    coding.intraMatrix = m_intraMatrix.data();
+    coding.nonIntraMatrix = m_nonIntraMatrix.data();
+    coding.quantiserScale =
+        ps2_mpeg::quantiserScale(quantiserCode, !coding.mpeg1 && (m_control & kCtrlQuantiserType) != 0u);
+    coding.intraDcPrecision = coding.mpeg1 ? 0 : static_cast<int>((m_control >> 16u) & 3u);
+    coding.intraVlcFormat = !coding.mpeg1 && (m_control & kCtrlIntraVlcFormat) != 0u;
+    return coding;
+}
+
+bool PS2Ipu::decodeBlocks(BitReader &reader, const ps2_mpeg::BlockCoding &coding, bool intra,
+                          uint32_t codedBlockPattern, int dcPredictors[3], int16_t blocks[6][64]) const
+{
+    for (int index = 0; index < 6; ++index)
+    {
+        if (intra)
+        {
+            if (!ps2_mpeg::decodeIntraBlock(reader, coding, index >= 4, dcPredictors[index < 4 ? 0 : index - 3],
+                                            blocks[index]))
+                return false;
+        }
+        else if ((codedBlockPattern & (0x20u >> index)) != 0u)
+        {
+            if (!ps2_mpeg::decodeNonIntraBlock(reader, coding, blocks[index]))
+                return false;
+        }
+        else
+        {
+            std::memset(blocks[index], 0, sizeof(blocks[index]));
+            continue;
+        }
+        ps2_mpeg::inverseDct(blocks[index]);
+    }
+    return true;
+}
+
+PS2Ipu::Progress PS2Ipu::executeIdec()
+{
+    if (!m_commandStarted)
+    {
+        if (m_input.size() * 8u < m_bitPos + forwardBits(m_command))
+            return Progress::Starved;
+        m_bitPos += forwardBits(m_command);
+        m_quantiserCode = static_cast<int>((m_command >> 16u) & 0x1Fu);
+        const int dcReset = 128 << blockCoding(m_quantiserCode).intraDcPrecision;
+        m_dcPredictors[0] = m_dcPredictors[1] = m_dcPredictors[2] = dcReset;
+        m_commandStarted = true;
+    }
+
+    const bool rgb16 = (m_command & kCmdRgb16) != 0u;
+    const bool dither = (m_command & kCmdDither) != 0u;
+    const bool signedOutput = (m_command & kCmdIdecSigned) != 0u;
+    alignas(16) int16_t blocks[6][64];
+    alignas(16) uint8_t luma[256];
+    alignas(16) uint8_t cb[64];
+    alignas(16) uint8_t cr[64];
+
+    for (;;)
+    {
+        BitReader reader(m_input.data(), m_input.size(), m_bitPos);
+        int quantiserCode = m_quantiserCode;
+        int dcPredictors[3] = {m_dcPredictors[0], m_dcPredictors[1], m_dcPredictors[2]};
+
+        const int type = ps2_mpeg::decodeMacroblockType(reader, ps2_mpeg::PictureCoding::Intra);
+        if (type == ps2_mpeg::kVlcInvalid)
+            return failOrStarve(reader);
+        const bool fieldDct = (m_command & kCmdIdecDecodeDctType) != 0u && reader.readFlag();
+        if ((static_cast<uint32_t>(type) & ps2_mpeg::kMbQuant) != 0u)
+            quantiserCode = static_cast<int>(reader.read(5u));
+
+        if (!decodeBlocks(reader, blockCoding(quantiserCode), true, 0x3Fu, dcPredictors, blocks))
+            return failOrStarve(reader);
+
+        // A start code ends the slice; otherwise the next macroblock's
+        // address increment follows.
+        if (reader.overrun() || !hasBits(reader, 23u))
+            return Progress::Starved;
+        const bool endOfSlice = reader.atStartCode();
+        if (!endOfSlice)
+        {
+            const int increment = ps2_mpeg::decodeMacroblockAddressIncrement(reader);
+            if (reader.overrun())
+                return Progress::Starved;
+            if (increment != 1)
+                m_errorCode = true;
+        }
+
+        for (int index = 0; index < 4; ++index)
+        {
+            const size_t column = static_cast<size_t>(index & 1) * 8u;
+            const size_t blockRow = static_cast<size_t>(index >> 1);
+            uint8_t *dst = luma + column + (fieldDct ? blockRow * 16u : blockRow * 128u);
+            ps2_mpeg::putBlock(blocks[index], dst, fieldDct ? 32u : 16u);
+        }
+        ps2_mpeg::putBlock(blocks[4], cb, 8u);
+        ps2_mpeg::putBlock(blocks[5], cr, 8u);
+        emitRgbMacroblock(luma, cb, cr, rgb16, dither, signedOutput);
+
+        m_bitPos = reader.position();
+        m_quantiserCode = quantiserCode;
+        std::copy(dcPredictors, dcPredictors + 3, m_dcPredictors);
+        ++m_unitsDone;
+        discardConsumedInput();
+
+        if (endOfSlice || m_errorCode)
+        {
+            m_startCode = endOfSlice;
+            return Progress::Done;
+        }
+    }
+}
+
+PS2Ipu::Progress PS2Ipu::executeBdec()
+{
+    BitReader reader(m_input.data(), m_input.size(), m_bitPos);
+    reader.skip(forwardBits(m_command));
+
+    const bool intra = (m_command & kCmdBdecIntra) != 0u;
+    const ps2_mpeg::BlockCoding coding = blockCoding(static_cast<int>((m_command >> 16u) & 0x1Fu));
+    int dcPredictors[3] = {m_dcPredictors[0], m_dcPredictors[1], m_dcPredictors[2]};
+    if ((m_command & kCmdBdecResetDc) != 0u)
+        dcPredictors[0] = dcPredictors[1] = dcPredictors[2] = 128 << coding.intraDcPrecision;
+
+    uint32_t codedBlockPattern = 0x3Fu;
+    if (!intra)
+    {
+        const int pattern = ps2_mpeg::decodeCodedBlockPattern(reader);
+        if (pattern < 0)
+            return failOrStarve(reader);
+        codedBlockPattern = static_cast<uint32_t>(pattern);
+    }
+
+    alignas(16) int16_t blocks[6][64];
+    if (!decodeBlocks(reader, coding, intra, codedBlockPattern, dcPredictors, blocks))
+        return failOrStarve(reader);
+    if (reader.overrun())
+        return Progress::Starved;
+
+    // RAW16: the 16x16 luma in raster order, then Cb and Cr.
+    const bool fieldDct = (m_command & kCmdBdecDctType) != 0u;
+    alignas(16) int16_t raw[kRaw16MacroblockBytes / 2u];
+    for (size_t index = 0; index < 4u; ++index)
+    {
+        const size_t column = (index & 1u) * 8u;
+        const size_t blockRow = index >> 1u;
+        for (size_t row = 0; row < 8u; ++row)
+        {
+            const size_t y = fieldDct ? row * 2u + blockRow : blockRow * 8u + row;
+            std::memcpy(raw + y * 16u + column, blocks[index] + row * 8u, 8u * sizeof(int16_t));
+        }
+    }
+    std::memcpy(raw + 256, blocks[4], sizeof(blocks[4]));
+    std::memcpy(raw + 320, blocks[5], sizeof(blocks[5]));
+    appendOutput(reinterpret_cast<const uint8_t *>(raw), kRaw16MacroblockBytes);
+
+    m_bitPos = reader.position();
+    m_codedBlockPattern = codedBlockPattern;
+    std::copy(dcPredictors, dcPredictors + 3, m_dcPredictors);
+    return Progress::Done;
+}
+
+PS2Ipu::Progress PS2Ipu::executeVdec()
+{
+    BitReader reader(m_input.data(), m_input.size(), m_bitPos);
+    reader.skip(forwardBits(m_command));
+    const size_t start = reader.position();
+    if (!hasBits(reader, 23u))
+        return Progress::Starved;
+
+    int value = 0;
+    switch ((m_command >> 26u) & 3u)
+    {
+    case 0u:
+        if (reader.atStartCode())
+        {
+            m_startCode = true;
+            m_data = 0u;
+            m_bitPos = start;
+            return Progress::Done;
+        }
+        value = ps2_mpeg::decodeAddressIncrementCode(reader);
+        break;
+    case 1u:
+        value = ps2_mpeg::decodeMacroblockType(reader,
+                                               static_cast<ps2_mpeg::PictureCoding>((m_control >> 24u) & 7u));
+        break;
+    case 2u:
+        value = ps2_mpeg::decodeMotionCode(reader);
+        break;
+    default:
+        value = ps2_mpeg::decodeDualPrimeVector(reader);
+        break;
+    }
+    if (value == ps2_mpeg::kVlcInvalid)
+    {
+        m_data = 0u;
+        return failOrStarve(reader);
+    }
+
+    const uint32_t length = static_cast<uint32_t>(reader.position() - start);
+    m_data = (static_cast<uint32_t>(value) & 0xFFFFu) | (length << 16u);
+    m_bitPos = reader.position();
+    return Progress::Done;
+}
+
+PS2Ipu::Progress PS2Ipu::executeFdec()
+{
+    BitReader reader(m_input.data(), m_input.size(), m_bitPos);
+    reader.skip(forwardBits(m_command));
+    if (!hasBits(reader, 32u))
+        return Progress::Starved;
+    m_data = reader.peek(32u);
+    m_bitPos = reader.position();
+    return Progress::Done;
+}
+
+PS2Ipu::Progress PS2Ipu::executeTable(Opcode opcode)
+{
+    BitReader reader(m_input.data(), m_input.size(), m_bitPos);
+    reader.skip(forwardBits(m_command));
+    const size_t bytes = opcode == kSetiq ? 64u : m_clut.size() * 2u;
+    if (!hasBits(reader, bytes * 8u))
+        return Progress::Starved;
+
+    if (opcode == kSetiq)
+    {
+        // Matrices arrive in zigzag order, as in the sequence header.
+        std::array<uint8_t, 64> &matrix = (m_command & kCmdSetiqNonIntra) != 0u ? m_nonIntraMatrix : m_intraMatrix;
+        for (size_t i = 0; i < 64u; ++i)
+            matrix[ps2_mpeg::kZigzagScan[i]] = static_cast<uint8_t>(reader.read(8u));
+    }
+    else
+    {
+        for (uint16_t &entry : m_clut)
+        {
+            const uint32_t low = reader.read(8u);
+            entry = static_cast<uint16_t>(low | (reader.read(8u) << 8u));
+        }
+    }
+    m_bitPos = reader.position();
+    return Progress::Done;
+}
+
+PS2Ipu::Progress PS2Ipu::executeCsc()
+{
+    const uint32_t macroblocks = m_command & 0x7FFu;
+    const bool rgb16 = (m_command & kCmdRgb16) != 0u;
+    const bool dither = (m_command & kCmdDither) != 0u;
+    while (m_unitsDone < macroblocks)
+    {
+        // RAW8 input: 16x16 luma, then 8x8 Cb and Cr, qword aligned.
+        const size_t offset = (m_bitPos + 7u) / 8u;
+        if (offset + kRaw8MacroblockBytes > m_input.size())
+            return Progress::Starved;
+        const uint8_t *raw = m_input.data() + offset;
+        emitRgbMacroblock(raw, raw + 256, raw + 320, rgb16, dither, false);
+        m_bitPos = (offset + kRaw8MacroblockBytes) * 8u;
+        ++m_unitsDone;
+        discardConsumedInput();
+    }
+    return Progress::Done;
+}
+
+PS2Ipu::Progress PS2Ipu::executePack()
+{
+    const uint32_t macroblocks = m_command & 0x7FFu;
+    const bool rgb16 = (m_command & kCmdRgb16) != 0u;
+    const bool dither = (m_command & kCmdDither) != 0u;
+    while (m_unitsDone < macroblocks)
+    {
+        const size_t offset = (m_bitPos + 7u) / 8u;
+        if (offset + kRgb32MacroblockBytes > m_input.size())
+            return Progress::Starved;
+        const uint8_t *rgba = m_input.data() + offset;
+        if (rgb16)
+        {
+            alignas(16) uint8_t packed[kRgb16MacroblockBytes];
+            packMacroblockRgb16(rgba, dither, packed);
+            appendOutput(packed, sizeof(packed));
+        }
+        else
+        {
+            // INDX4: two pixels a byte, the first in the low nibble.
+            alignas(16) uint8_t packed[kIndx4MacroblockBytes];
+            for (size_t pixel = 0; pixel < 256u; pixel += 2u)
+            {
+                packed[pixel / 2u] = static_cast<uint8_t>(quantizeToClut(rgba + pixel * 4u, m_clut) |
+                                                         (quantizeToClut(rgba + pixel * 4u + 4u, m_clut) << 4u));
+            }
+            appendOutput(packed, sizeof(packed));
+        }
+        m_bitPos = (offset + kRgb32MacroblockBytes) * 8u;
+        ++m_unitsDone;
+        discardConsumedInput();
+    }
+    return Progress::Done;
+}
+
+void PS2Ipu::emitRgbMacroblock(const uint8_t *luma, const uint8_t *cb, const uint8_t *cr, bool rgb16, bool dither,
+                               bool signedOutput)
+{
+    alignas(16) uint8_t rgba[kRgb32MacroblockBytes];
+    for (size_t row = 0; row < 16u; ++row)
+    {
+        ps2_mpeg::convertRow(luma + row * 16u, cb + (row / 2u) * 8u, cr + (row / 2u) * 8u, 16u, 0x80u,
+                             ps2_mpeg::PixelFormat::Rgba32, rgba + row * 64u);
+    }
+    applyAlphaThresholds(rgba, 256u);
+    if (signedOutput)
+    {
+        for (size_t pixel = 0; pixel < 256u; ++pixel)
+        {
+            rgba[pixel * 4u] ^= 0x80u;
+            rgba[pixel * 4u + 1u] ^= 0x80u;
+            rgba[pixel * 4u + 2u] ^= 0x80u;
+        }
+    }
+
+    if (!rgb16)
+    {
+        appendOutput(rgba, sizeof(rgba));
+        return;
+    }
+    alignas(16) uint8_t packed[kRgb16MacroblockBytes];
+    packMacroblockRgb16(rgba, dither, packed);
+    appendOutput(packed, sizeof(packed));
+}
+
+void PS2Ipu::applyAlphaThresholds(uint8_t *rgba, size_t pixelCount) const
+{
+    // SETTH: pixels darker than TH0 in every component are transparent,
+    // darker than TH1 half transparent.
+    if (m_threshold0 == 0u && m_threshold1 == 0u)
+        return;
+    for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+    {
+        uint8_t *p = rgba + pixel * 4u;
+        const uint32_t brightest = std::max({p[0], p[1], p[2]});
+        if (brightest < m_threshold0)
+            p[3] = 0x00u;
+        else if (brightest < m_threshold1)
+            p[3] = 0x40u;
+    }
+}
+
+void PS2Ipu::appendOutput(const uint8_t *data, size_t size)
+{
+    m_output.insert(m_output.end(), data, data + size);
+}
@@ -99,6 +99,18 @@ namespace
 
     constexpr uint32_t kGsCsrRegOffset = 0x1000u;
 
+    constexpr uint32_t kIpuCmdRegister = 0x10002000u;
+    constexpr uint32_t kIpuCtrlRegister = 0x10002010u;
+    constexpr uint32_t kIpuBpRegister = 0x10002020u;
+    constexpr uint32_t kIpuTopRegister = 0x10002030u;
+    constexpr uint32_t kIpuRegisterEnd = 0x10002040u;
+    constexpr uint32_t kIpuOutFifo = 0x10007000u;
+    constexpr uint32_t kIpuInFifo = 0x10007010u;
+    constexpr uint32_t kIpuFromChannel = 0x1000B000u;
+    constexpr uint32_t kIpuToChannel = 0x1000B400u;
+    constexpr uint32_t kDmaStart = 0x100u;
+    constexpr uint32_t kDStatRegister = 0x1000E010u;
+
     // Atomically apply a 32-bit write to one half (off=0 low dword, off=4 high
     // dword) of the GS CSR register. Bits 0..1 of the low dword (SIGNAL/FINISH) are
     // write-one-to-clear; everything else is a plain merge. Uses compare_exchange
@@ -242,6 +254,8 @@ PS2Memory::PS2Memory()
     : m_rdram(nullptr), m_scratchpad(nullptr), iop_ram(nullptr), m_seenGifCopy(false), m_gsVRAM(nullptr)
 {
     ps2SetScratchpadHostPtr(nullptr);
+    m_ipu.setInputPull([this](uint8_t qword[PS2Ipu::kQwordBytes])
+                       { return pullIpuInput(qword); });
 }
 
 PS2Memory::~PS2Memory()
@@ -331,6 +345,8 @@ bool PS2Memory::initialize(size_t ramSize)
     m_path3MaskedFifo.clear();
     m_vif1PendingPath2ImageQwc = 0u;
     m_vif1PendingPath2DirectHl = false;
+    m_ipu.reset();
+    m_ipuToChainEnded = false;
     resetEeTimers();
 
     try
@@ -813,6 +829,12 @@ uint64_t PS2Memory::read64(uint32_t address)
         return loadScalar<uint64_t>(vuMem, vuOffset, vuLimit, "read64 vu", address);
     }
 
+    // IPU_CMD and IPU_TOP carry BUSY in bit 63 and are read with ld.
+    if (address == kIpuCmdRegister)
+        return m_ipu.readCommand();
+    if (address == kIpuTopRegister)
+        return m_ipu.readTop();
+
     // 64-bit IO read: compose from the two adjacent 32-bit IO register slots
     // to avoid any side-effects from read32 handlers.
     if (isIoRegister(address))
@@ -852,6 +874,13 @@ __m128i PS2Memory::read128(uint32_t address)
         return _mm_loadu_si128(reinterpret_cast<const __m128i *>(vuMem + vuOffset));
     }
 
+    if (physAddr == kIpuOutFifo)
+    {
+        alignas(16) uint8_t qword[PS2Ipu::kQwordBytes] = {};
+        m_ipu.readOutput(qword);
+        return _mm_load_si128(reinterpret_cast<const __m128i *>(qword));
+    }
+
     // 128-bit reads are primarily for quad-word loads in the EE, which are only valid for RAM areas
     // Return zeroes for unsupported areas
     return _mm_setzero_si128();
@@ -1090,6 +1119,14 @@ void PS2Memory::write128(uint32_t address, __m128i value)
             return;
         }
     }
+    if (physAddr == kIpuInFifo)
+    {
+        alignas(16) uint8_t qword[PS2Ipu::kQwordBytes];
+        _mm_store_si128(reinterpret_cast<__m128i *>(qword), value);
+        m_ipu.writeInput(qword);
+        drainIpuOutput();
+        return;
+    }
     if (isIoRegister(physAddr))
     {
         // Non-RAM 128-bit stores are modeled as two 64-bit stores.
@@ -1158,21 +1195,16 @@ bool PS2Memory::writeIORegister(uint32_t address, uint32_t value)
         return true;
     }
 
-    if (address >= 0x10002000 && address <= 0x10002030)
+    if (address >= kIpuCmdRegister && address < kIpuRegisterEnd)
     {
-        if (address == 0x10002010)
+        if (address == kIpuCmdRegister)
         {
-            m_ioRegisters[address] = value & ~(1u << 31);
-            if (value & (1u << 30))
-            {
-                m_ioRegisters[0x10002000] = 0;
-                m_ioRegisters[0x10002020] = 0;
-                m_ioRegisters[0x10002030] = 0;
-            }
+            m_ipu.writeCommand(value);
+            drainIpuOutput();
         }
-        else
+        else if (address == kIpuCtrlRegister)
         {
-            m_ioRegisters[address] = value;
+            m_ipu.writeControl(value);
         }
         return true;
     }
@@ -1281,6 +1313,24 @@ bool PS2Memory::writeIORegister(uint32_t address, uint32_t value)
             const uint32_t qwc = m_ioRegisters[channelBase + 0x20];
             m_dmaStartCount.fetch_add(1, std::memory_order_relaxed);
 
+            if (channelBase == kIpuToChannel)
+            {
+                m_ipuToChainEnded = false;
+                m_ipu.resume();
+                drainIpuOutput();
+                // A normal-mode channel with nothing to move completes even
+                // when the IPU is not asking for input.
+                if ((m_ioRegisters[kIpuToChannel] & kDmaStart) != 0u && ((value >> 2) & 0x3u) == 0u &&
+                    m_ioRegisters[kIpuToChannel + 0x20u] == 0u)
+                    completeIpuChannel(kIpuToChannel, 4u);
+                return true;
+            }
+            if (channelBase == kIpuFromChannel)
+            {
+                drainIpuOutput();
+                return true;
+            }
+
             if ((channelBase == 0x1000A000u || channelBase == 0x10009000u || channelBase == 0x10008000u) &&
                 (m_gsVRAM || channelBase == 0x10008000u))
             {
@@ -1748,22 +1798,6 @@ void PS2Memory::processPendingTransfers()
     static constexpr uint32_t GIF_CHANNEL = 0x1000A000;
     static constexpr uint32_t VIF0_CHANNEL = 0x10008000;
     static constexpr uint32_t VIF1_CHANNEL = 0x10009000;
-    static constexpr uint32_t D_STAT = 0x1000E010u;
-
-    auto raiseDStatChannel = [&](uint32_t channelBit)
-    {
-        uint32_t dstat = m_ioRegisters.count(D_STAT) ? m_ioRegisters[D_STAT] : 0u;
-        dstat |= (1u << channelBit);
-
-        const uint32_t status = dstat & 0x3FFu;
-        const uint32_t mask = (dstat >> 16) & 0x3FFu;
-        if ((status & mask) != 0u)
-            dstat |= (1u << 31);
-        else
-            dstat &= ~(1u << 31);
-
-        m_ioRegisters[D_STAT] = dstat;
-    };
 
     if (hadGif)
     {
@@ -1788,6 +1822,183 @@ void PS2Memory::processPendingTransfers()
     }
 }
 
+void PS2Memory::raiseDStatChannel(uint32_t channelBit)
+{
+    uint32_t dstat = m_ioRegisters.count(kDStatRegister) ? m_ioRegisters[kDStatRegister] : 0u;
+    dstat |= (1u << channelBit);
+
+    const uint32_t status = dstat & 0x3FFu;
+    const uint32_t mask = (dstat >> 16) & 0x3FFu;
+    if ((status & mask) != 0u)
+        dstat |= (1u << 31);
+    else
+        dstat &= ~(1u << 31);
+
+    m_ioRegisters[kDStatRegister] = dstat;
+}
+
+bool PS2Memory::readDmaQword(uint32_t address, uint8_t qword[16])
+{
+    uint32_t physAddr = 0u;
+    try
+    {
+        physAddr = translateAddress(address);
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+    const bool scratch = isScratchpad(address);
+    const uint8_t *base = scratch ? m_scratchpad : m_rdram;
+    const uint32_t limit = scratch ? PS2_SCRATCHPAD_SIZE : PS2_RAM_SIZE;
+    if (!base || static_cast<uint64_t>(physAddr) + 16u > limit)
+        return false;
+    std::memcpy(qword, base + physAddr, 16u);
+    return true;
+}
+
+bool PS2Memory::writeDmaQword(uint32_t address, const uint8_t qword[16])
+{
+    uint32_t physAddr = 0u;
+    try
+    {
+        physAddr = translateAddress(address);
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+    const bool scratch = isScratchpad(address);
+    uint8_t *base = scratch ? m_scratchpad : m_rdram;
+    const uint32_t limit = scratch ? PS2_SCRATCHPAD_SIZE : PS2_RAM_SIZE;
+    if (!base || static_cast<uint64_t>(physAddr) + 16u > limit)
+        return false;
+    if (!scratch)
+        markModified(address, 16u);
+    std::memcpy(base + physAddr, qword, 16u);
+    return true;
+}
+
+void PS2Memory::completeIpuChannel(uint32_t channelBase, uint32_t channelBit)
+{
+    m_ioRegisters[channelBase + 0x00u] &= ~kDmaStart;
+    raiseDStatChannel(channelBit);
+    queueCompletedDmacCause(channelBit);
+}
+
+bool PS2Memory::readIpuChainTag()
+{
+    // Source chain for toIPU: refe/cnt/next/ref/refs/end. The channel has
+    // no call/ret stack, so those tags end the chain.
+    const uint32_t tagAddr = m_ioRegisters[kIpuToChannel + 0x30u];
+    uint8_t tagBytes[16];
+    if (!readDmaQword(tagAddr, tagBytes))
+        return false;
+    uint64_t tag = 0u;
+    std::memcpy(&tag, tagBytes, sizeof(tag));
+
+    const uint32_t tagQwc = static_cast<uint32_t>(tag & 0xFFFFu);
+    const uint32_t id = static_cast<uint32_t>((tag >> 28) & 0x7u);
+    const bool irq = ((tag >> 31) & 0x1u) != 0u;
+    const uint32_t addr = static_cast<uint32_t>((tag >> 32) & 0x7FFFFFFFu);
+    uint32_t &chcr = m_ioRegisters[kIpuToChannel + 0x00u];
+    chcr = (chcr & 0x0000FFFFu) | (static_cast<uint32_t>(tag) & 0xFFFF0000u);
+
+    uint32_t madr = 0u;
+    uint32_t nextTag = tagAddr + 16u;
+    switch (id)
+    {
+    case 0: // refe
+        madr = addr;
+        m_ipuToChainEnded = true;
+        break;
+    case 1: // cnt
+        madr = tagAddr + 16u;
+        nextTag = madr + tagQwc * 16u;
+        break;
+    case 2: // next
+        madr = tagAddr + 16u;
+        nextTag = addr;
+        break;
+    case 3: // ref
+    case 4: // refs
+        madr = addr;
+        break;
+    case 7: // end
+        madr = tagAddr + 16u;
+        m_ipuToChainEnded = true;
+        break;
+    default:
+        m_ipuToChainEnded = true;
+        m_ioRegisters[kIpuToChannel + 0x20u] = 0u;
+        return true;
+    }
+    if (irq && (chcr & (1u << 7)) != 0u)
+        m_ipuToChainEnded = true;
+
+    m_ioRegisters[kIpuToChannel + 0x10u] = madr;
+    m_ioRegisters[kIpuToChannel + 0x20u] = tagQwc;
+    m_ioRegisters[kIpuToChannel + 0x30u] = nextTag;
+    return true;
+}
+
+bool PS2Memory::pullIpuInput(uint8_t qword[PS2Ipu::kQwordBytes])
+{
+    const auto dctrlIt = m_ioRegisters.find(0x1000E000u);
+    const bool dmacEnabled = (dctrlIt == m_ioRegisters.end()) || ((dctrlIt->second & 0x1u) != 0u);
+    if (!dmacEnabled || (m_ioRegisters[kIpuToChannel + 0x00u] & kDmaStart) == 0u)
+        return false;
+
+    const bool chain = ((m_ioRegisters[kIpuToChannel + 0x00u] >> 2) & 0x3u) == 1u;
+    while (m_ioRegisters[kIpuToChannel + 0x20u] == 0u)
+    {
+        if (!chain || m_ipuToChainEnded || !readIpuChainTag())
+        {
+            completeIpuChannel(kIpuToChannel, 4u);
+            return false;
+        }
+    }
+
+    uint32_t &madr = m_ioRegisters[kIpuToChannel + 0x10u];
+    uint32_t &qwc = m_ioRegisters[kIpuToChannel + 0x20u];
+    if (!readDmaQword(madr, qword))
+    {
+        qwc = 0u;
+        completeIpuChannel(kIpuToChannel, 4u);
+        return false;
+    }
+    madr += 16u;
+    --qwc;
+    if (qwc == 0u && (!chain || m_ipuToChainEnded))
+        completeIpuChannel(kIpuToChannel, 4u);
+    return true;
+}
+
+bool PS2Memory::pumpIpu()
+{
+    const bool busy = m_ipu.resume();
+    drainIpuOutput();
+    return busy;
+}
+
+void PS2Memory::drainIpuOutput()
+{
+    if ((m_ioRegisters[kIpuFromChannel + 0x00u] & kDmaStart) == 0u)
+        return;
+
+    uint32_t &madr = m_ioRegisters[kIpuFromChannel + 0x10u];
+    uint32_t &qwc = m_ioRegisters[kIpuFromChannel + 0x20u];
+    alignas(16) uint8_t qword[PS2Ipu::kQwordBytes];
+    while (qwc > 0u && m_ipu.readOutput(qword))
+    {
+        writeDmaQword(madr, qword);
+        madr += 16u;
+        --qwc;
+    }
+    if (qwc == 0u)
+        completeIpuChannel(kIpuFromChannel, 3u);
+}
+
 void PS2Memory::queueCompletedDmacCause(uint32_t cause)
 {
     std::lock_guard<std::mutex> lock(m_completedDmacMutex);
@@ -2200,32 +2411,33 @@ uint32_t PS2Memory::readIORegister(uint32_t address)
         return 0u;
     }
 
-    if (address >= 0x10002000 && address <= 0x10002030)
+    if (address >= kIpuCmdRegister && address < kIpuRegisterEnd)
     {
-        uint32_t val = 0;
         switch (address)
         {
-        case 0x10002000:
-            val = m_ioRegisters[address];
-            break;
-        case 0x10002010:
-            val = m_ioRegisters[address] & ~(1u << 31);
-            break;
-        case 0x10002020:
-        case 0x10002030:
-            val = m_ioRegisters[address];
-            break;
+        case kIpuCmdRegister:
+            return static_cast<uint32_t>(m_ipu.readCommand());
+        case kIpuCmdRegister + 4u:
+            return static_cast<uint32_t>(m_ipu.readCommand() >> 32u);
+        case kIpuCtrlRegister:
+            return m_ipu.readControl();
+        case kIpuBpRegister:
+            return m_ipu.readBitPointer();
+        case kIpuTopRegister:
+            return static_cast<uint32_t>(m_ipu.readTop());
+        case kIpuTopRegister + 4u:
+            return static_cast<uint32_t>(m_ipu.readTop() >> 32u);
         default:
-            val = 0;
-            break;
+            return 0u;
         }
-        return val;
     }
     if (address >= 0x10000000 && address < 0x10010000)
     {
         if (address >= 0x10008000 && address < 0x1000F000)
         {
-            if ((address & 0xFF) == 0x00)
+            // The IPU channels finish when the IPU has moved their data, so
+            // STR reads back as the real state.
+            if ((address & 0xFF) == 0x00 && address != kIpuFromChannel && address != kIpuToChannel)
             {
                 uint32_t channelStatus = m_ioRegisters[address] & ~0x100u;
                 m_ioRegisters[address] = channelStatus;
@@ -0,0 +1,1668 @@
+#include "runtime/ps2_mpeg_decoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(USE_SSE2NEON)
+#include "sse2neon.h"
+#else
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    using ps2_mpeg::BitReader;
+
+    inline uint64_t loadBigEndian64(const uint8_t *data)
+    {
+        uint64_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+#if defined(_MSC_VER)
+        return _byteswap_uint64(value);
+#else
+        return __builtin_bswap64(value);
+#endif
+    }
+
+    // Two-level VLC lookup built once from the code strings of the standard's
+    // tables. Codes up to kPrimaryBits long resolve in one probe; longer ones
+    // index a subtable keyed by the bits after the primary prefix.
+    class VlcTable
+    {
+    public:
+        struct Code
+        {
+            const char *bits;
+            int16_t symbol;
+        };
+
+        template <size_t N>
+        explicit VlcTable(const Code (&codes)[N])
+        {
+            build(codes, N);
+        }
+
+        // Returns kVlcInvalid for a code that is not in the table.
+        int decode(BitReader &reader) const
+        {
+            const Entry &entry = m_entries[reader.peek(kPrimaryBits)];
+            if (entry.subBits == 0u)
+            {
+                if (entry.length == 0u)
+                    return ps2_mpeg::kVlcInvalid;
+                reader.skip(entry.length);
+                return entry.symbol;
+            }
+
+            const uint32_t subIndex = reader.peek(kPrimaryBits + entry.subBits) & ((1u << entry.subBits) - 1u);
+            const Entry &sub = m_entries[entry.offset + subIndex];
+            if (sub.length == 0u)
+                return ps2_mpeg::kVlcInvalid;
+            reader.skip(sub.length);
+            return sub.symbol;
+        }
+
+    private:
+        static constexpr uint32_t kPrimaryBits = 9u;
+
+        struct Entry
+        {
+            int16_t symbol = 0;
+            uint8_t length = 0u;
+            uint8_t subBits = 0u;
+            uint32_t offset = 0u;
+        };
+
+        void build(const Code *codes, size_t count)
+        {
+            m_entries.assign(1u << kPrimaryBits, Entry{});
+
+            // Size every subtable by the longest code sharing its prefix.
+            std::vector<uint8_t> subBits(1u << kPrimaryBits, 0u);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t length = static_cast<uint32_t>(std::strlen(codes[i].bits));
+                if (length > kPrimaryBits)
+                {
+                    const uint32_t prefix = codeValue(codes[i].bits, kPrimaryBits);
+                    subBits[prefix] = std::max<uint8_t>(subBits[prefix], static_cast<uint8_t>(length - kPrimaryBits));
+                }
+            }
+            for (uint32_t prefix = 0; prefix < subBits.size(); ++prefix)
+            {
+                if (subBits[prefix] == 0u)
+                    continue;
+                m_entries[prefix].subBits = subBits[prefix];
+                m_entries[prefix].offset = static_cast<uint32_t>(m_entries.size());
+                m_entries.resize(m_entries.size() + (1u << subBits[prefix]));
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t length = static_cast<uint32_t>(std::strlen(codes[i].bits));
+                const uint32_t value = codeValue(codes[i].bits, length);
+                uint32_t first = 0u;
+                uint32_t span = 0u;
+                Entry *table = nullptr;
+                if (length <= kPrimaryBits)
+                {
+                    table = m_entries.data();
+                    first = value << (kPrimaryBits - length);
+                    span = 1u << (kPrimaryBits - length);
+                }
+                else
+                {
+                    const Entry &head = m_entries[value >> (length - kPrimaryBits)];
+                    const uint32_t tail = value & ((1u << (length - kPrimaryBits)) - 1u);
+                    table = m_entries.data() + head.offset;
+                    first = tail << (head.subBits - (length - kPrimaryBits));
+                    span = 1u << (head.subBits - (length - kPrimaryBits));
+                }
+                for (uint32_t j = 0; j < span; ++j)
+                {
+                    table[first + j].symbol = codes[i].symbol;
+                    table[first + j].length = static_cast<uint8_t>(length);
+                }
+            }
+        }
+
+        static uint32_t codeValue(const char *bits, uint32_t length)
+        {
+            uint32_t value = 0u;
+            for (uint32_t i = 0; i < length; ++i)
+                value = (value << 1u) | static_cast<uint32_t>(bits[i] == '1');
+            return value;
+        }
+
+        std::vector<Entry> m_entries;
+    };
+
+    // Table B.1, macroblock_address_increment.
+    constexpr VlcTable::Code kAddressIncrementCodes[] = {
+        {"1", 1}, {"011", 2}, {"010", 3}, {"0011", 4}, {"0010", 5}, {"00011", 6}, {"00010", 7},
+        {"0000111", 8}, {"0000110", 9}, {"00001011", 10}, {"00001010", 11}, {"00001001", 12},
+        {"00001000", 13}, {"00000111", 14}, {"00000110", 15}, {"0000010111", 16}, {"0000010110", 17},
+        {"0000010101", 18}, {"0000010100", 19}, {"0000010011", 20}, {"0000010010", 21},
+        {"00000100011", 22}, {"00000100010", 23}, {"00000100001", 24}, {"00000100000", 25},
+        {"00000011111", 26}, {"00000011110", 27}, {"00000011101", 28}, {"00000011100", 29},
+        {"00000011011", 30}, {"00000011010", 31}, {"00000011001", 32}, {"00000011000", 33},
+        {"00000001111", ps2_mpeg::kMbaStuffing}, {"00000001000", ps2_mpeg::kMbaEscape}};
+
+    using ps2_mpeg::kMbIntra;
+    using ps2_mpeg::kMbMotionBackward;
+    using ps2_mpeg::kMbMotionForward;
+    using ps2_mpeg::kMbPattern;
+    using ps2_mpeg::kMbQuant;
+
+    // Tables B.2 to B.4, macroblock_type for I, P and B pictures.
+    constexpr VlcTable::Code kIntraTypeCodes[] = {
+        {"1", kMbIntra}, {"01", kMbQuant | kMbIntra}};
+    constexpr VlcTable::Code kPredictedTypeCodes[] = {
+        {"1", kMbMotionForward | kMbPattern},
+        {"01", kMbPattern},
+        {"001", kMbMotionForward},
+        {"00011", kMbIntra},
+        {"00010", kMbQuant | kMbMotionForward | kMbPattern},
+        {"00001", kMbQuant | kMbPattern},
+        {"000001", kMbQuant | kMbIntra}};
+    constexpr VlcTable::Code kBidirectionalTypeCodes[] = {
+        {"10", kMbMotionForward | kMbMotionBackward},
+        {"11", kMbMotionForward | kMbMotionBackward | kMbPattern},
+        {"010", kMbMotionBackward},
+        {"011", kMbMotionBackward | kMbPattern},
+        {"0010", kMbMotionForward},
+        {"0011", kMbMotionForward | kMbPattern},
+        {"00011", kMbIntra},
+        {"00010", kMbQuant | kMbMotionForward | kMbMotionBackward | kMbPattern},
+        {"000011", kMbQuant | kMbMotionForward | kMbPattern},
+        {"000010", kMbQuant | kMbMotionBackward | kMbPattern},
+        {"000001", kMbQuant | kMbIntra}};
+
+    // Table B.9, coded_block_pattern for 4:2:0.
+    constexpr VlcTable::Code kCodedBlockPatternCodes[] = {
+        {"111", 60}, {"1101", 4}, {"1100", 8}, {"1011", 16}, {"1010", 32}, {"10011", 12},
+        {"10010", 48}, {"10001", 20}, {"10000", 40}, {"01111", 28}, {"01110", 44}, {"01101", 52},
+        {"01100", 56}, {"01011", 1}, {"01010", 61}, {"01001", 2}, {"01000", 62}, {"001111", 24},
+        {"001110", 36}, {"001101", 3}, {"001100", 63}, {"0010111", 5}, {"0010110", 9},
+        {"0010101", 17}, {"0010100", 33}, {"0010011", 6}, {"0010010", 10}, {"0010001", 18},
+        {"0010000", 34}, {"00011111", 7}, {"00011110", 11}, {"00011101", 19}, {"00011100", 35},
+        {"00011011", 13}, {"00011010", 49}, {"00011001", 21}, {"00011000", 41}, {"00010111", 14},
+        {"00010110", 50}, {"00010101", 22}, {"00010100", 42}, {"00010011", 15}, {"00010010", 51},
+        {"00010001", 23}, {"00010000", 43}, {"00001111", 25}, {"00001110", 37}, {"00001101", 26},
+        {"00001100", 38}, {"00001011", 29}, {"00001010", 45}, {"00001001", 53}, {"00001000", 57},
+        {"00000111", 30}, {"00000110", 46}, {"00000101", 54}, {"00000100", 58}, {"000000111", 31},
+        {"000000110", 47}, {"000000101", 55}, {"000000100", 59}, {"000000011", 27},
+        {"000000010", 39}, {"000000001", 0}};
+
+    // Table B.10, motion_code magnitude; the sign bit follows non-zero codes.
+    constexpr VlcTable::Code kMotionCodeCodes[] = {
+        {"1", 0}, {"01", 1}, {"001", 2}, {"0001", 3}, {"000011", 4}, {"0000101", 5},
+        {"0000100", 6}, {"0000011", 7}, {"000001011", 8}, {"000001010", 9}, {"000001001", 10},
+        {"0000010001", 11}, {"0000010000", 12}, {"0000001111", 13}, {"0000001110", 14},
+        {"0000001101", 15}, {"0000001100", 16}};
+
+    // Tables B.12 and B.13, dct_dc_size.
+    constexpr VlcTable::Code kDcSizeLumaCodes[] = {
+        {"100", 0}, {"00", 1}, {"01", 2}, {"101", 3}, {"110", 4}, {"1110", 5}, {"11110", 6},
+        {"111110", 7}, {"1111110", 8}, {"11111110", 9}, {"111111110", 10}, {"111111111", 11}};
+    constexpr VlcTable::Code kDcSizeChromaCodes[] = {
+        {"00", 0}, {"01", 1}, {"10", 2}, {"110", 3}, {"1110", 4}, {"11110", 5}, {"111110", 6},
+        {"1111110", 7}, {"11111110", 8}, {"111111110", 9}, {"1111111110", 10}, {"1111111111", 11}};
+
+    // DCT coefficient symbols pack run and level as (run << 8) | level.
+    constexpr int16_t kDctEndOfBlock = -1;
+    constexpr int16_t kDctEscape = -2;
+
+    constexpr int16_t rl(int run, int level)
+    {
+        return static_cast<int16_t>((run << 8) | level);
+    }
+
+    // Table B.14, DCT coefficients table zero (sign bit not included). The
+    // "1s" first-coefficient form of run 0 level 1 is handled by the caller.
+    constexpr VlcTable::Code kDctTableZeroCodes[] = {
+        {"10", kDctEndOfBlock}, {"11", rl(0, 1)}, {"011", rl(1, 1)}, {"0100", rl(0, 2)},
+        {"0101", rl(2, 1)}, {"00101", rl(0, 3)}, {"00111", rl(3, 1)}, {"00110", rl(4, 1)},
+        {"000110", rl(1, 2)}, {"000111", rl(5, 1)}, {"000101", rl(6, 1)}, {"000100", rl(7, 1)},
+        {"0000110", rl(0, 4)}, {"0000100", rl(2, 2)}, {"0000111", rl(8, 1)}, {"0000101", rl(9, 1)},
+        {"000001", kDctEscape}, {"00100110", rl(0, 5)}, {"00100001", rl(0, 6)},
+        {"00100101", rl(1, 3)}, {"00100100", rl(3, 2)}, {"00100111", rl(10, 1)},
+        {"00100011", rl(11, 1)}, {"00100010", rl(12, 1)}, {"00100000", rl(13, 1)},
+        {"0000001010", rl(0, 7)}, {"0000001100", rl(1, 4)}, {"0000001011", rl(2, 3)},
+        {"0000001111", rl(4, 2)}, {"0000001001", rl(5, 2)}, {"0000001110", rl(14, 1)},
+        {"0000001101", rl(15, 1)}, {"0000001000", rl(16, 1)}, {"000000011101", rl(0, 8)},
+        {"000000011000", rl(0, 9)}, {"000000010011", rl(0, 10)}, {"000000010000", rl(0, 11)},
+        {"000000011011", rl(1, 5)}, {"000000010100", rl(2, 4)}, {"000000011100", rl(3, 3)},
+        {"000000010010", rl(4, 3)}, {"000000011110", rl(6, 2)}, {"000000010101", rl(7, 2)},
+        {"000000010001", rl(8, 2)}, {"000000011111", rl(17, 1)}, {"000000011010", rl(18, 1)},
+        {"000000011001", rl(19, 1)}, {"000000010111", rl(20, 1)}, {"000000010110", rl(21, 1)},
+        {"0000000011010", rl(0, 12)}, {"0000000011001", rl(0, 13)}, {"0000000011000", rl(0, 14)},
+        {"0000000010111", rl(0, 15)}, {"0000000010110", rl(1, 6)}, {"0000000010101", rl(1, 7)},
+        {"0000000010100", rl(2, 5)}, {"0000000010011", rl(3, 4)}, {"0000000010010", rl(5, 3)},
+        {"0000000010001", rl(9, 2)}, {"0000000010000", rl(10, 2)}, {"0000000011111", rl(22, 1)},
+        {"0000000011110", rl(23, 1)}, {"0000000011101", rl(24, 1)}, {"0000000011100", rl(25, 1)},
+        {"0000000011011", rl(26, 1)}, {"00000000011111", rl(0, 16)}, {"00000000011110", rl(0, 17)},
+        {"00000000011101", rl(0, 18)}, {"00000000011100", rl(0, 19)}, {"00000000011011", rl(0, 20)},
+        {"00000000011010", rl(0, 21)}, {"00000000011001", rl(0, 22)}, {"00000000011000", rl(0, 23)},
+        {"00000000010111", rl(0, 24)}, {"00000000010110", rl(0, 25)}, {"00000000010101", rl(0, 26)},
+        {"00000000010100", rl(0, 27)}, {"00000000010011", rl(0, 28)}, {"00000000010010", rl(0, 29)},
+        {"00000000010001", rl(0, 30)}, {"00000000010000", rl(0, 31)}, {"000000000011000", rl(0, 32)},
+        {"000000000010111", rl(0, 33)}, {"000000000010110", rl(0, 34)}, {"000000000010101", rl(0, 35)},
+        {"000000000010100", rl(0, 36)}, {"000000000010011", rl(0, 37)}, {"000000000010010", rl(0, 38)},
+        {"000000000010001", rl(0, 39)}, {"000000000010000", rl(0, 40)}, {"000000000011111", rl(1, 8)},
+        {"000000000011110", rl(1, 9)}, {"000000000011101", rl(1, 10)}, {"000000000011100", rl(1, 11)},
+        {"000000000011011", rl(1, 12)}, {"000000000011010", rl(1, 13)}, {"000000000011001", rl(1, 14)},
+        {"0000000000010011", rl(1, 15)}, {"0000000000010010", rl(1, 16)},
+        {"0000000000010001", rl(1, 17)}, {"0000000000010000", rl(1, 18)},
+        {"0000000000010100", rl(6, 3)}, {"0000000000011010", rl(11, 2)},
+        {"0000000000011001", rl(12, 2)}, {"0000000000011000", rl(13, 2)},
+        {"0000000000010111", rl(14, 2)}, {"0000000000010110", rl(15, 2)},
+        {"0000000000010101", rl(16, 2)}, {"0000000000011111", rl(27, 1)},
+        {"0000000000011110", rl(28, 1)}, {"0000000000011101", rl(29, 1)},
+        {"0000000000011100", rl(30, 1)}, {"0000000000011011", rl(31, 1)}};
+
+    // Table B.15, DCT coefficients table one (intra_vlc_format = 1).
+    constexpr VlcTable::Code kDctTableOneCodes[] = {
+        {"0110", kDctEndOfBlock}, {"10", rl(0, 1)}, {"010", rl(1, 1)}, {"110", rl(0, 2)},
+        {"00101", rl(2, 1)}, {"0111", rl(0, 3)}, {"00111", rl(3, 1)}, {"000110", rl(4, 1)},
+        {"00110", rl(1, 2)}, {"000111", rl(5, 1)}, {"0000110", rl(6, 1)}, {"0000100", rl(7, 1)},
+        {"11100", rl(0, 4)}, {"0000111", rl(2, 2)}, {"0000101", rl(8, 1)}, {"1111000", rl(9, 1)},
+        {"000001", kDctEscape}, {"11101", rl(0, 5)}, {"000101", rl(0, 6)}, {"1111001", rl(1, 3)},
+        {"00100110", rl(3, 2)}, {"1111010", rl(10, 1)}, {"00100001", rl(11, 1)},
+        {"00100101", rl(12, 1)}, {"00100100", rl(13, 1)}, {"000100", rl(0, 7)},
+        {"00100111", rl(1, 4)}, {"11111100", rl(2, 3)}, {"11111101", rl(4, 2)},
+        {"000000100", rl(5, 2)}, {"000000101", rl(14, 1)}, {"000000111", rl(15, 1)},
+        {"0000001101", rl(16, 1)}, {"1111011", rl(0, 8)}, {"1111100", rl(0, 9)},
+        {"00100011", rl(0, 10)}, {"00100010", rl(0, 11)}, {"00100000", rl(1, 5)},
+        {"0000001100", rl(2, 4)}, {"000000011100", rl(3, 3)}, {"000000010010", rl(4, 3)},
+        {"000000011110", rl(6, 2)}, {"000000010101", rl(7, 2)}, {"000000010001", rl(8, 2)},
+        {"000000011111", rl(17, 1)}, {"000000011010", rl(18, 1)}, {"000000011001", rl(19, 1)},
+        {"000000010111", rl(20, 1)}, {"000000010110", rl(21, 1)}, {"11111010", rl(0, 12)},
+        {"11111011", rl(0, 13)}, {"11111110", rl(0, 14)}, {"11111111", rl(0, 15)},
+        {"0000000010110", rl(1, 6)}, {"0000000010101", rl(1, 7)}, {"0000000010100", rl(2, 5)},
+        {"0000000010011", rl(3, 4)}, {"0000000010010", rl(5, 3)}, {"0000000010001", rl(9, 2)},
+        {"0000000010000", rl(10, 2)}, {"0000000011111", rl(22, 1)}, {"0000000011110", rl(23, 1)},
+        {"0000000011101", rl(24, 1)}, {"0000000011100", rl(25, 1)}, {"0000000011011", rl(26, 1)},
+        {"00000000011111", rl(0, 16)}, {"00000000011110", rl(0, 17)}, {"00000000011101", rl(0, 18)},
+        {"00000000011100", rl(0, 19)}, {"00000000011011", rl(0, 20)}, {"00000000011010", rl(0, 21)},
+        {"00000000011001", rl(0, 22)}, {"00000000011000", rl(0, 23)}, {"00000000010111", rl(0, 24)},
+        {"00000000010110", rl(0, 25)}, {"00000000010101", rl(0, 26)}, {"00000000010100", rl(0, 27)},
+        {"00000000010011", rl(0, 28)}, {"00000000010010", rl(0, 29)}, {"00000000010001", rl(0, 30)},
+        {"00000000010000", rl(0, 31)}, {"000000000011000", rl(0, 32)}, {"000000000010111", rl(0, 33)},
+        {"000000000010110", rl(0, 34)}, {"000000000010101", rl(0, 35)}, {"000000000010100", rl(0, 36)},
+        {"000000000010011", rl(0, 37)}, {"000000000010010", rl(0, 38)}, {"000000000010001", rl(0, 39)},
+        {"000000000010000", rl(0, 40)}, {"000000000011111", rl(1, 8)}, {"000000000011110", rl(1, 9)},
+        {"000000000011101", rl(1, 10)}, {"000000000011100", rl(1, 11)}, {"000000000011011", rl(1, 12)},
+        {"000000000011010", rl(1, 13)}, {"000000000011001", rl(1, 14)},
+        {"0000000000010011", rl(1, 15)}, {"0000000000010010", rl(1, 16)},
+        {"0000000000010001", rl(1, 17)}, {"0000000000010000", rl(1, 18)},
+        {"0000000000010100", rl(6, 3)}, {"0000000000011010", rl(11, 2)},
+        {"0000000000011001", rl(12, 2)}, {"0000000000011000", rl(13, 2)},
+        {"0000000000010111", rl(14, 2)}, {"0000000000010110", rl(15, 2)},
+        {"0000000000010101", rl(16, 2)}, {"0000000000011111", rl(27, 1)},
+        {"0000000000011110", rl(28, 1)}, {"0000000000011101", rl(29, 1)},
+        {"0000000000011100", rl(30, 1)}, {"0000000000011011", rl(31, 1)}};
+
+    struct VlcTables
+    {
+        VlcTable addressIncrement{kAddressIncrementCodes};
+        VlcTable intraType{kIntraTypeCodes};
+        VlcTable predictedType{kPredictedTypeCodes};
+        VlcTable bidirectionalType{kBidirectionalTypeCodes};
+        VlcTable codedBlockPattern{kCodedBlockPatternCodes};
+        VlcTable motionCode{kMotionCodeCodes};
+        VlcTable dcSizeLuma{kDcSizeLumaCodes};
+        VlcTable dcSizeChroma{kDcSizeChromaCodes};
+        VlcTable dctTableZero{kDctTableZeroCodes};
+        VlcTable dctTableOne{kDctTableOneCodes};
+    };
+
+    const VlcTables &vlcTables()
+    {
+        static const VlcTables s_tables;
+        return s_tables;
+    }
+
+    constexpr int kNonLinearQuantiserScale[32] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 18, 20, 22,
+        24, 28, 32, 36, 40, 44, 48, 52, 56, 64, 72, 80, 88, 96, 104, 112};
+
+    inline int16_t saturateCoefficient(int value)
+    {
+        return static_cast<int16_t>(std::clamp(value, -2048, 2047));
+    }
+
+    // Reads the run and signed level of one AC coefficient. Returns false on
+    // end of block (run set to -1) or a corrupt code.
+    inline bool readCoefficient(BitReader &reader, const VlcTable &table, bool mpeg1, int &run, int &level)
+    {
+        const int symbol = table.decode(reader);
+        if (symbol >= 0)
+        {
+            run = symbol >> 8;
+            level = (symbol & 0xFF);
+            if (reader.readFlag())
+                level = -level;
+            return true;
+        }
+        if (symbol == kDctEscape)
+        {
+            run = static_cast<int>(reader.read(6u));
+            if (mpeg1)
+            {
+                // 8-bit level, or -128/0 prefixes for 16-bit levels.
+                level = static_cast<int>(reader.read(8u));
+                if (level == 0x80)
+                    level = static_cast<int>(reader.read(8u)) - 256;
+                else if (level == 0)
+                    level = static_cast<int>(reader.read(8u));
+                else if (level > 0x80)
+                    level -= 256;
+            }
+            else
+            {
+                level = static_cast<int>(reader.read(12u));
+                if (level >= 0x800)
+                    level -= 0x1000;
+            }
+            return level != 0;
+        }
+        run = symbol == kDctEndOfBlock ? -1 : -2;
+        return false;
+    }
+
+    // Q14 basis of the 8-point inverse DCT, laid out as coefficient pairs for
+    // _mm_madd_epi16: kIdctPairs[y][p] holds M[y][2p], M[y][2p+1] four times.
+    constexpr int kIdctCoefficientBits = 14;
+    // The column pass keeps four fraction bits in 16-bit lanes, which meets
+    // the IEEE 1180 accuracy limits with room to spare.
+    constexpr int kIdctColumnShift = 10;
+    constexpr int kIdctRowShift = kIdctCoefficientBits + (kIdctCoefficientBits - kIdctColumnShift);
+
+    struct IdctBasis
+    {
+        alignas(16) int16_t pairs[8][4][8];
+
+        IdctBasis()
+        {
+            const double pi = std::acos(-1.0);
+            for (int y = 0; y < 8; ++y)
+            {
+                for (int p = 0; p < 4; ++p)
+                {
+                    for (int j = 0; j < 2; ++j)
+                    {
+                        const int v = p * 2 + j;
+                        const double scale = (v == 0 ? std::sqrt(0.5) : 1.0) * 0.5;
+                        const double c = scale * std::cos((2 * y + 1) * v * pi / 16.0);
+                        const int16_t q = static_cast<int16_t>(std::lround(c * (1 << kIdctCoefficientBits)));
+                        for (int lane = 0; lane < 4; ++lane)
+                            pairs[y][p][lane * 2 + j] = q;
+                    }
+                }
+            }
+        }
+    };
+
+    const IdctBasis &idctBasis()
+    {
+        static const IdctBasis s_basis;
+        return s_basis;
+    }
+
+    inline void transpose8x8(__m128i rows[8])
+    {
+        const __m128i a0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+        const __m128i a1 = _mm_unpackhi_epi16(rows[0], rows[1]);
+        const __m128i a2 = _mm_unpacklo_epi16(rows[2], rows[3]);
+        const __m128i a3 = _mm_unpackhi_epi16(rows[2], rows[3]);
+        const __m128i a4 = _mm_unpacklo_epi16(rows[4], rows[5]);
+        const __m128i a5 = _mm_unpackhi_epi16(rows[4], rows[5]);
+        const __m128i a6 = _mm_unpacklo_epi16(rows[6], rows[7]);
+        const __m128i a7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+        const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+        const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+        const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+        const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+        const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+        const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+        const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+        const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+        rows[0] = _mm_unpacklo_epi64(b0, b4);
+        rows[1] = _mm_unpackhi_epi64(b0, b4);
+        rows[2] = _mm_unpacklo_epi64(b1, b5);
+        rows[3] = _mm_unpackhi_epi64(b1, b5);
+        rows[4] = _mm_unpacklo_epi64(b2, b6);
+        rows[5] = _mm_unpackhi_epi64(b2, b6);
+        rows[6] = _mm_unpacklo_epi64(b3, b7);
+        rows[7] = _mm_unpackhi_epi64(b3, b7);
+    }
+
+    // out[y] = sum over v of M[y][v] * in[v], eight lanes at a time. Row
+    // pairs are interleaved so one madd covers two taps.
+    inline void idctPass(__m128i rows[8], int shift)
+    {
+        const IdctBasis &basis = idctBasis();
+        __m128i lo[4];
+        __m128i hi[4];
+        for (int p = 0; p < 4; ++p)
+        {
+            lo[p] = _mm_unpacklo_epi16(rows[2 * p], rows[2 * p + 1]);
+            hi[p] = _mm_unpackhi_epi16(rows[2 * p], rows[2 * p + 1]);
+        }
+
+        const __m128i round = _mm_set1_epi32(1 << (shift - 1));
+        const __m128i count = _mm_cvtsi32_si128(shift);
+        for (int y = 0; y < 8; ++y)
+        {
+            __m128i sumLo = round;
+            __m128i sumHi = round;
+            for (int p = 0; p < 4; ++p)
+            {
+                const __m128i c = _mm_load_si128(reinterpret_cast<const __m128i *>(basis.pairs[y][p]));
+                sumLo = _mm_add_epi32(sumLo, _mm_madd_epi16(lo[p], c));
+                sumHi = _mm_add_epi32(sumHi, _mm_madd_epi16(hi[p], c));
+            }
+            rows[y] = _mm_packs_epi32(_mm_sra_epi32(sumLo, count), _mm_sra_epi32(sumHi, count));
+        }
+    }
+
+    inline __m128i average4(__m128i a, __m128i b, __m128i c, __m128i d)
+    {
+        // (a + b + c + d + 2) >> 2 in 16-bit lanes.
+        const __m128i sum = _mm_add_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, d));
+        return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+    }
+
+    inline __m128i loadPixels(const uint8_t *src, uint32_t width)
+    {
+        return width == 16u ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(src))
+                            : _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src));
+    }
+
+    inline void storePixels(uint8_t *dst, uint32_t width, __m128i value)
+    {
+        if (width == 16u)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), value);
+        else
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), value);
+    }
+}
+
+namespace ps2_mpeg
+{
+    uint64_t BitReader::window() const
+    {
+        const size_t byte = m_bitPos >> 3u;
+        const uint32_t shift = static_cast<uint32_t>(m_bitPos & 7u);
+        if (byte + 9u <= m_size)
+        {
+            // Nine bytes cover any 64-bit window; the ninth only supplies the
+            // low bits lost to the shift.
+            const uint64_t high = loadBigEndian64(m_data + byte);
+            return shift == 0u ? high : (high << shift) | (m_data[byte + 8u] >> (8u - shift));
+        }
+
+        // Near the end of the buffer: zero-pad a copy and take the same path.
+        uint8_t padded[9] = {};
+        for (size_t i = 0; i < 9u && byte + i < m_size; ++i)
+            padded[i] = m_data[byte + i];
+        const uint64_t high = loadBigEndian64(padded);
+        const uint64_t value = shift == 0u ? high : (high << shift) | (padded[8] >> (8u - shift));
+        return value;
+    }
+
+    const uint8_t kZigzagScan[64] = {
+        0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+        12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+        35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+        58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+    const uint8_t kAlternateScan[64] = {
+        0, 8, 16, 24, 1, 9, 2, 10, 17, 25, 32, 40, 48, 56, 57, 49,
+        41, 33, 26, 18, 3, 11, 4, 12, 19, 27, 34, 42, 50, 58, 35, 43,
+        51, 59, 20, 28, 5, 13, 6, 14, 21, 29, 36, 44, 52, 60, 37, 45,
+        53, 61, 22, 30, 7, 15, 23, 31, 38, 46, 54, 62, 39, 47, 55, 63};
+
+    const uint8_t kDefaultIntraMatrix[64] = {
+        8, 16, 19, 22, 26, 27, 29, 34,
+        16, 16, 22, 24, 27, 29, 34, 37,
+        19, 22, 26, 27, 29, 34, 34, 38,
+        22, 22, 26, 27, 29, 34, 37, 40,
+        22, 26, 27, 29, 32, 35, 40, 48,
+        26, 27, 29, 32, 35, 40, 48, 58,
+        26, 27, 29, 34, 38, 46, 56, 69,
+        27, 29, 35, 38, 46, 56, 69, 83};
+
+    const uint8_t kDefaultNonIntraMatrix[64] = {
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16,
+        16, 16, 16, 16, 16, 16, 16, 16};
+
+    int quantiserScale(int code, bool nonLinear)
+    {
+        code &= 31;
+        return nonLinear ? kNonLinearQuantiserScale[code] : code * 2;
+    }
+
+    int decodeAddressIncrementCode(BitReader &reader)
+    {
+        return vlcTables().addressIncrement.decode(reader);
+    }
+
+    int decodeMacroblockAddressIncrement(BitReader &reader)
+    {
+        int increment = 0;
+        while (!reader.atStartCode())
+        {
+            const int code = decodeAddressIncrementCode(reader);
+            if (code == kMbaStuffing)
+                continue;
+            if (code == kMbaEscape)
+            {
+                increment += 33;
+                continue;
+            }
+            if (code == kVlcInvalid)
+                return 0;
+            return increment + code;
+        }
+        return 0;
+    }
+
+    int decodeMacroblockType(BitReader &reader, PictureCoding coding)
+    {
+        const VlcTables &tables = vlcTables();
+        switch (coding)
+        {
+        case PictureCoding::Intra:
+            return tables.intraType.decode(reader);
+        case PictureCoding::Predicted:
+            return tables.predictedType.decode(reader);
+        case PictureCoding::Bidirectional:
+            return tables.bidirectionalType.decode(reader);
+        case PictureCoding::DcIntra:
+            return reader.readFlag() ? static_cast<int>(kMbIntra) : kVlcInvalid;
+        }
+        return kVlcInvalid;
+    }
+
+    int decodeCodedBlockPattern(BitReader &reader)
+    {
+        return vlcTables().codedBlockPattern.decode(reader);
+    }
+
+    int decodeMotionCode(BitReader &reader)
+    {
+        const int magnitude = vlcTables().motionCode.decode(reader);
+        if (magnitude <= 0)
+            return magnitude;
+        return reader.readFlag() ? -magnitude : magnitude;
+    }
+
+    int decodeDualPrimeVector(BitReader &reader)
+    {
+        if (!reader.readFlag())
+            return 0;
+        return reader.readFlag() ? -1 : 1;
+    }
+
+    bool decodeIntraBlock(BitReader &reader, const BlockCoding &coding, bool chroma,
+                          int &dcPredictor, int16_t block[64])
+    {
+        std::memset(block, 0, 64u * sizeof(int16_t));
+        const VlcTables &tables = vlcTables();
+
+        const int size = (chroma ? tables.dcSizeChroma : tables.dcSizeLuma).decode(reader);
+        if (size < 0)
+            return false;
+        int differential = 0;
+        if (size > 0)
+        {
+            differential = static_cast<int>(reader.read(static_cast<uint32_t>(size)));
+            if (differential < (1 << (size - 1)))
+                differential -= (1 << size) - 1;
+        }
+        dcPredictor += differential;
+
+        const int dcShift = coding.mpeg1 ? 3 : 3 - coding.intraDcPrecision;
+        int value = saturateCoefficient(dcPredictor << dcShift);
+        block[0] = static_cast<int16_t>(value);
+        int sum = value;
+
+        const VlcTable &table = (coding.intraVlcFormat && !coding.mpeg1) ? tables.dctTableOne : tables.dctTableZero;
+        const int scale = coding.quantiserScale;
+        int index = 0;
+        while (true)
+        {
+            int run = 0;
+            int level = 0;
+            if (!readCoefficient(reader, table, coding.mpeg1, run, level))
+            {
+                if (run == -1)
+                    break;
+                return false;
+            }
+            index += run + 1;
+            if (index > 63)
+                return false;
+
+            const int position = coding.scan[index];
+            value = (level * scale * coding.intraMatrix[position]) / 16;
+            if (coding.mpeg1 && value != 0 && (value & 1) == 0)
+                value -= value > 0 ? 1 : -1;
+            value = saturateCoefficient(value);
+            block[position] = static_cast<int16_t>(value);
+            sum += value;
+        }
+
+        if (!coding.mpeg1 && (sum & 1) == 0)
+            block[63] ^= 1;
+        return !reader.overrun();
+    }
+
+    bool decodeNonIntraBlock(BitReader &reader, const BlockCoding &coding, int16_t block[64])
+    {
+        std::memset(block, 0, 64u * sizeof(int16_t));
+        const VlcTable &table = vlcTables().dctTableZero;
+        const int scale = coding.quantiserScale;
+
+        int index = -1;
+        int sum = 0;
+        bool first = true;
+        while (true)
+        {
+            int run = 0;
+            int level = 0;
+            if (first && reader.peek(1u) == 1u)
+            {
+                // "1s" stands for run 0, level 1 in the first position.
+                reader.skip(1u);
+                level = reader.readFlag() ? -1 : 1;
+            }
+            else if (!readCoefficient(reader, table, coding.mpeg1, run, level))
+            {
+                if (run == -1 && !first)
+                    break;
+                return false;
+            }
+            first = false;
+
+            index += run + 1;
+            if (index > 63)
+                return false;
+
+            const int position = coding.scan[index];
+            const int sign = level > 0 ? 1 : -1;
+            int value = ((2 * level + sign) * scale * coding.nonIntraMatrix[position]) / 32;
+            if (coding.mpeg1 && value != 0 && (value & 1) == 0)
+                value -= value > 0 ? 1 : -1;
+            value = saturateCoefficient(value);
+            block[position] = static_cast<int16_t>(value);
+            sum += value;
+        }
+
+        if (!coding.mpeg1 && (sum & 1) == 0)
+            block[63] ^= 1;
+        return !reader.overrun();
+    }
+
+    void inverseDct(int16_t block[64])
+    {
+        __m128i rows[8];
+        for (int i = 0; i < 8; ++i)
+            rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 8));
+
+        // Columns first (M * F), then rows on the transposed result.
+        idctPass(rows, kIdctColumnShift);
+        transpose8x8(rows);
+        idctPass(rows, kIdctRowShift);
+        transpose8x8(rows);
+
+        const __m128i low = _mm_set1_epi16(-256);
+        const __m128i high = _mm_set1_epi16(255);
+        for (int i = 0; i < 8; ++i)
+        {
+            const __m128i clamped = _mm_min_epi16(_mm_max_epi16(rows[i], low), high);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(block + i * 8), clamped);
+        }
+    }
+
+    void putBlock(const int16_t block[64], uint8_t *dst, size_t stride)
+    {
+        for (int y = 0; y < 8; ++y)
+        {
+            const __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + y * 8));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + y * stride), _mm_packus_epi16(row, row));
+        }
+    }
+
+    void addBlock(const int16_t block[64], uint8_t *dst, size_t stride)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        for (int y = 0; y < 8; ++y)
+        {
+            uint8_t *out = dst + y * stride;
+            const __m128i residual = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + y * 8));
+            const __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(out)), zero);
+            const __m128i sum = _mm_add_epi16(pixels, residual);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(sum, sum));
+        }
+    }
+
+    void predictBlock(uint8_t *dst, size_t dstStride, const uint8_t *src, size_t srcStride,
+                      uint32_t width, uint32_t height, bool halfX, bool halfY, bool average)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const uint8_t *row = src + y * srcStride;
+            __m128i prediction;
+            if (!halfX && !halfY)
+            {
+                prediction = loadPixels(row, width);
+            }
+            else if (halfX && !halfY)
+            {
+                prediction = _mm_avg_epu8(loadPixels(row, width), loadPixels(row + 1, width));
+            }
+            else if (!halfX && halfY)
+            {
+                prediction = _mm_avg_epu8(loadPixels(row, width), loadPixels(row + srcStride, width));
+            }
+            else
+            {
+                const __m128i a = loadPixels(row, width);
+                const __m128i b = loadPixels(row + 1, width);
+                const __m128i c = loadPixels(row + srcStride, width);
+                const __m128i d = loadPixels(row + srcStride + 1, width);
+                const __m128i lo = average4(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero),
+                                            _mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero));
+                const __m128i hi = average4(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero),
+                                            _mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero));
+                prediction = _mm_packus_epi16(lo, hi);
+            }
+
+            uint8_t *out = dst + y * dstStride;
+            if (average)
+                prediction = _mm_avg_epu8(prediction, loadPixels(out, width));
+            storePixels(out, width, prediction);
+        }
+    }
+}
+
+namespace
+{
+    using ps2_mpeg::BitReader;
+    using ps2_mpeg::PictureCoding;
+    using ps2_mpeg::kMbIntra;
+    using ps2_mpeg::kMbMotionBackward;
+    using ps2_mpeg::kMbMotionForward;
+    using ps2_mpeg::kMbPattern;
+
+    constexpr uint8_t kPictureStartCode = 0x00u;
+    constexpr uint8_t kSliceStartMin = 0x01u;
+    constexpr uint8_t kSliceStartMax = 0xAFu;
+    constexpr uint8_t kUserDataStartCode = 0xB2u;
+    constexpr uint8_t kSequenceHeaderCode = 0xB3u;
+    constexpr uint8_t kExtensionStartCode = 0xB5u;
+    constexpr uint8_t kSequenceEndCode = 0xB7u;
+    constexpr uint8_t kGroupStartCode = 0xB8u;
+
+    constexpr uint32_t kSequenceExtensionId = 1u;
+    constexpr uint32_t kQuantMatrixExtensionId = 3u;
+    constexpr uint32_t kPictureCodingExtensionId = 8u;
+
+    constexpr int kFramePicture = 3;
+    constexpr int kMotionField = 1;
+    constexpr int kMotionFrame = 2;
+    constexpr int kMotionDualPrime = 3;
+    constexpr size_t kEdgeScratchStride = 32u;
+
+    // Keep buffered stream bytes bounded when a caller feeds garbage with no
+    // start codes in it.
+    constexpr size_t kMaxUnitBytes = 4u * 1024u * 1024u;
+
+    void readMatrix(BitReader &reader, std::array<uint8_t, 64> &matrix)
+    {
+        // Matrices are transmitted in zigzag order.
+        for (size_t i = 0; i < 64u; ++i)
+            matrix[ps2_mpeg::kZigzagScan[i]] = static_cast<uint8_t>(reader.read(8u));
+    }
+
+    // Applies one decoded motion_code/motion_residual pair to a predictor,
+    // wrapping into the f_code range (ISO/IEC 13818-2 7.6.3.1).
+    int applyMotionDelta(int predictor, int motionCode, int residual, int fCode)
+    {
+        const int rSize = fCode - 1;
+        const int f = 1 << rSize;
+        int delta = motionCode;
+        if (f != 1 && motionCode != 0)
+        {
+            delta = ((std::abs(motionCode) - 1) * f) + residual + 1;
+            if (motionCode < 0)
+                delta = -delta;
+        }
+
+        const int low = -16 * f;
+        const int high = 16 * f - 1;
+        const int range = 32 * f;
+        int vector = predictor + delta;
+        if (vector < low)
+            vector += range;
+        else if (vector > high)
+            vector -= range;
+        return vector;
+    }
+
+    // Keeps a prediction window inside the reference picture. Conforming
+    // streams never need it; broken ones must not read out of bounds.
+    // Returns the top-left of a width x height (+1 each way for half-pel)
+    // source block. Vectors may point past the picture edge; those blocks
+    // are rebuilt in scratch from the nearest edge samples.
+    const uint8_t *edgeSource(const uint8_t *plane, size_t stride, int planeWidth, int planeRows, int x, int y,
+                              int width, int height, uint8_t *scratch, size_t &sourceStride)
+    {
+        if (x >= 0 && y >= 0 && x + width + 1 <= planeWidth && y + height + 1 <= planeRows)
+        {
+            sourceStride = stride;
+            return plane + static_cast<size_t>(y) * stride + static_cast<size_t>(x);
+        }
+        sourceStride = kEdgeScratchStride;
+        for (int row = 0; row <= height; ++row)
+        {
+            const uint8_t *src = plane + static_cast<size_t>(std::clamp(y + row, 0, planeRows - 1)) * stride;
+            uint8_t *dst = scratch + static_cast<size_t>(row) * kEdgeScratchStride;
+            for (int column = 0; column <= width; ++column)
+                dst[column] = src[std::clamp(x + column, 0, planeWidth - 1)];
+        }
+        return scratch;
+    }
+
+    void warnOnce(bool &warned, const char *message)
+    {
+        if (!warned)
+        {
+            std::cerr << "[MPEG] " << message << std::endl;
+            warned = true;
+        }
+    }
+}
+
+PS2MpegDecoder::PS2MpegDecoder()
+{
+    reset();
+}
+
+void PS2MpegDecoder::reset()
+{
+    m_stream.clear();
+    m_haveUnit = false;
+    m_unitCode = 0u;
+    m_unitPts = -1;
+    m_scanPos = 0u;
+    m_pendingPts = -1;
+    m_sequence = SequenceState{};
+    std::copy(std::begin(ps2_mpeg::kDefaultIntraMatrix), std::end(ps2_mpeg::kDefaultIntraMatrix),
+              m_sequence.intraMatrix.begin());
+    std::copy(std::begin(ps2_mpeg::kDefaultNonIntraMatrix), std::end(ps2_mpeg::kDefaultNonIntraMatrix),
+              m_sequence.nonIntraMatrix.begin());
+    m_picture = PictureState{};
+    m_pictureHeaderSeen = false;
+    m_pictureActive = false;
+    m_pictureDropped = false;
+    m_forwardIndex = -1;
+    m_backwardIndex = -1;
+    m_currentIndex = -1;
+    m_backwardPending = false;
+    m_frameMbWidth = 0u;
+    m_frameMbHeight = 0u;
+}
+
+bool PS2MpegDecoder::feed(const uint8_t *data, size_t size, int64_t pts90k, int64_t /*dts90k*/,
+                          PS2MpegPictureQueue &pictures)
+{
+    if (!data || size == 0u)
+        return true;
+
+    // A PES timestamp belongs to the first picture that starts in its packet.
+    if (pts90k >= 0)
+        m_pendingPts = pts90k;
+
+    m_stream.insert(m_stream.end(), data, data + size);
+
+    size_t pos = m_scanPos;
+    size_t consumed = 0u;
+    while (pos + 4u <= m_stream.size())
+    {
+        const uint8_t *p = m_stream.data() + pos;
+        if (p[2] > 1u)
+        {
+            pos += 3u;
+            continue;
+        }
+        if (p[0] != 0u || p[1] != 0u || p[2] != 1u)
+        {
+            ++pos;
+            continue;
+        }
+
+        if (m_haveUnit)
+        {
+            const size_t payloadStart = consumed + 4u;
+            if (!processUnit(m_unitCode, m_stream.data() + payloadStart, pos - payloadStart, pictures))
+                return false;
+        }
+
+        m_haveUnit = true;
+        m_unitCode = p[3];
+        consumed = pos;
+        if (m_unitCode == kPictureStartCode)
+        {
+            m_unitPts = m_pendingPts;
+            m_pendingPts = -1;
+        }
+        pos += 4u;
+    }
+
+    if (!m_haveUnit)
+    {
+        // Nothing to anchor on yet; keep only a possibly split start code.
+        const size_t keep = std::min<size_t>(m_stream.size(), 3u);
+        m_stream.erase(m_stream.begin(), m_stream.end() - static_cast<std::ptrdiff_t>(keep));
+        m_scanPos = 0u;
+        return true;
+    }
+
+    // Drop everything before the unit being gathered and resume the scan
+    // where a start code could still begin.
+    m_stream.erase(m_stream.begin(), m_stream.begin() + static_cast<std::ptrdiff_t>(consumed));
+    m_scanPos = pos - consumed;
+
+    if (m_stream.size() > kMaxUnitBytes)
+    {
+        static bool s_warnedOversized = false;
+        warnOnce(s_warnedOversized, "dropping an oversized MPEG video unit.");
+        m_stream.clear();
+        m_haveUnit = false;
+        m_scanPos = 0u;
+    }
+    return true;
+}
+
+bool PS2MpegDecoder::flush(PS2MpegPictureQueue &pictures)
+{
+    if (m_haveUnit && m_stream.size() >= 4u)
+    {
+        if (!processUnit(m_unitCode, m_stream.data() + 4u, m_stream.size() - 4u, pictures))
+            return false;
+    }
+    m_stream.clear();
+    m_haveUnit = false;
+    m_scanPos = 0u;
+
+    if (!finishPicture(pictures))
+        return false;
+    if (m_backwardPending && m_backwardIndex >= 0)
+    {
+        m_backwardPending = false;
+        return outputFrame(m_frames[static_cast<size_t>(m_backwardIndex)], pictures);
+    }
+    return true;
+}
+
+bool PS2MpegDecoder::processUnit(uint8_t code, const uint8_t *payload, size_t size, PS2MpegPictureQueue &pictures)
+{
+    if (code >= kSliceStartMin && code <= kSliceStartMax)
+    {
+        if (!m_pictureHeaderSeen || m_pictureDropped)
+            return true;
+        if (!m_pictureActive)
+        {
+            if (!startPicture(pictures))
+                return false;
+            if (!m_pictureActive)
+                return true;
+        }
+        decodeSlice(static_cast<uint32_t>(code - 1u), payload, size);
+        return true;
+    }
+
+    switch (code)
+    {
+    case kPictureStartCode:
+        if (!finishPicture(pictures))
+            return false;
+        parsePictureHeader(payload, size);
+        return true;
+    case kExtensionStartCode:
+        parseExtension(payload, size);
+        return true;
+    case kSequenceHeaderCode:
+        if (!finishPicture(pictures))
+            return false;
+        parseSequenceHeader(payload, size);
+        return true;
+    case kGroupStartCode:
+        return finishPicture(pictures);
+    case kSequenceEndCode:
+        if (!finishPicture(pictures))
+            return false;
+        if (m_backwardPending && m_backwardIndex >= 0)
+        {
+            m_backwardPending = false;
+            return outputFrame(m_frames[static_cast<size_t>(m_backwardIndex)], pictures);
+        }
+        return true;
+    case kUserDataStartCode:
+    default:
+        return true;
+    }
+}
+
+bool PS2MpegDecoder::parseSequenceHeader(const uint8_t *payload, size_t size)
+{
+    BitReader reader(payload, size);
+    const uint32_t width = reader.read(12u);
+    const uint32_t height = reader.read(12u);
+    reader.skip(4u + 4u);       // aspect ratio, frame rate
+    reader.skip(18u + 1u);      // bit rate, marker
+    reader.skip(10u + 1u);      // vbv buffer size, constrained parameters
+
+    if (reader.readFlag())
+        readMatrix(reader, m_sequence.intraMatrix);
+    else
+        std::copy(std::begin(ps2_mpeg::kDefaultIntraMatrix), std::end(ps2_mpeg::kDefaultIntraMatrix),
+                  m_sequence.intraMatrix.begin());
+    if (reader.readFlag())
+        readMatrix(reader, m_sequence.nonIntraMatrix);
+    else
+        std::copy(std::begin(ps2_mpeg::kDefaultNonIntraMatrix), std::end(ps2_mpeg::kDefaultNonIntraMatrix),
+                  m_sequence.nonIntraMatrix.begin());
+
+    if (reader.overrun() || width == 0u || height == 0u)
+    {
+        m_sequence.valid = false;
+        return false;
+    }
+    if (width > kMaxWidth || height > kMaxHeight)
+    {
+        static bool s_warnedSize = false;
+        warnOnce(s_warnedSize, "built-in decoder only handles pictures up to 720x576.");
+        m_sequence.valid = false;
+        return false;
+    }
+
+    // An MPEG-2 sequence extension follows and flips mpeg2 back on. Frame
+    // buffers are sized when the first picture starts, once both are known.
+    m_sequence.width = width;
+    m_sequence.height = height;
+    m_sequence.mpeg2 = false;
+    m_sequence.progressiveSequence = true;
+    m_sequence.valid = true;
+    return true;
+}
+
+void PS2MpegDecoder::parseExtension(const uint8_t *payload, size_t size)
+{
+    BitReader reader(payload, size);
+    const uint32_t id = reader.read(4u);
+    if (id == kSequenceExtensionId)
+    {
+        reader.skip(8u); // profile and level
+        m_sequence.progressiveSequence = reader.readFlag();
+        const uint32_t chromaFormat = reader.read(2u);
+        const uint32_t widthExtension = reader.read(2u);
+        const uint32_t heightExtension = reader.read(2u);
+        m_sequence.mpeg2 = true;
+        if (chromaFormat != 1u || widthExtension != 0u || heightExtension != 0u)
+        {
+            static bool s_warnedFormat = false;
+            warnOnce(s_warnedFormat, "built-in decoder only handles 4:2:0 streams.");
+            m_sequence.valid = false;
+        }
+        return;
+    }
+
+    if (id == kQuantMatrixExtensionId)
+    {
+        if (reader.readFlag())
+            readMatrix(reader, m_sequence.intraMatrix);
+        if (reader.readFlag())
+            readMatrix(reader, m_sequence.nonIntraMatrix);
+        return;
+    }
+
+    if (id == kPictureCodingExtensionId && m_pictureHeaderSeen)
+    {
+        m_picture.fCode[0][0] = static_cast<int>(reader.read(4u));
+        m_picture.fCode[0][1] = static_cast<int>(reader.read(4u));
+        m_picture.fCode[1][0] = static_cast<int>(reader.read(4u));
+        m_picture.fCode[1][1] = static_cast<int>(reader.read(4u));
+        m_picture.intraDcPrecision = static_cast<int>(reader.read(2u));
+        m_picture.pictureStructure = static_cast<int>(reader.read(2u));
+        m_picture.topFieldFirst = reader.readFlag();
+        m_picture.framePredFrameDct = reader.readFlag();
+        m_picture.concealmentVectors = reader.readFlag();
+        m_picture.qScaleType = reader.readFlag();
+        m_picture.intraVlcFormat = reader.readFlag();
+        m_picture.alternateScan = reader.readFlag();
+        m_picture.repeatFirstField = reader.readFlag();
+        reader.skip(1u); // chroma_420_type
+        m_picture.progressiveFrame = reader.readFlag();
+    }
+}
+
+void PS2MpegDecoder::parsePictureHeader(const uint8_t *payload, size_t size)
+{
+    BitReader reader(payload, size);
+    PictureState picture{};
+    reader.skip(10u); // temporal_reference
+    const uint32_t coding = reader.read(3u);
+    reader.skip(16u); // vbv_delay
+    if (coding == 2u || coding == 3u)
+    {
+        picture.fullPel[0] = reader.readFlag();
+        const int fCode = static_cast<int>(reader.read(3u));
+        picture.fCode[0][0] = picture.fCode[0][1] = fCode;
+    }
+    if (coding == 3u)
+    {
+        picture.fullPel[1] = reader.readFlag();
+        const int fCode = static_cast<int>(reader.read(3u));
+        picture.fCode[1][0] = picture.fCode[1][1] = fCode;
+    }
+    picture.pts90k = m_unitPts;
+    m_unitPts = -1;
+
+    m_pictureHeaderSeen = coding >= 1u && coding <= 4u;
+    m_pictureDropped = false;
+    if (!m_pictureHeaderSeen)
+        return;
+    picture.coding = static_cast<PictureCoding>(coding);
+    m_picture = picture;
+}
+
+void PS2MpegDecoder::allocateFrames()
+{
+    m_sequence.mbWidth = (m_sequence.width + 15u) / 16u;
+    // Interlaced frame pictures are coded as pairs of 16-line field rows.
+    m_sequence.mbHeight = (m_sequence.mpeg2 && !m_sequence.progressiveSequence)
+                              ? 2u * ((m_sequence.height + 31u) / 32u)
+                              : (m_sequence.height + 15u) / 16u;
+
+    if (m_sequence.mbWidth == m_frameMbWidth && m_sequence.mbHeight == m_frameMbHeight)
+        return;
+    m_frameMbWidth = m_sequence.mbWidth;
+    m_frameMbHeight = m_sequence.mbHeight;
+
+    // New geometry: old anchors cannot be referenced any more.
+    const size_t lumaSize = static_cast<size_t>(m_frameMbWidth) * 16u * m_frameMbHeight * 16u;
+    for (Frame &frame : m_frames)
+    {
+        frame.luma.assign(lumaSize, 16u);
+        frame.cb.assign(lumaSize / 4u, 128u);
+        frame.cr.assign(lumaSize / 4u, 128u);
+    }
+    m_forwardIndex = -1;
+    m_backwardIndex = -1;
+    m_backwardPending = false;
+}
+
+ps2_mpeg::BlockCoding PS2MpegDecoder::blockCoding(int quantiserScale) const
+{
+    ps2_mpeg::BlockCoding coding;
+    coding.scan = m_picture.alternateScan ? ps2_mpeg::kAlternateScan : ps2_mpeg::kZigzagScan;
+    coding.intraMatrix = m_sequence.intraMatrix.data();
+    coding.nonIntraMatrix = m_sequence.nonIntraMatrix.data();
+    coding.quantiserScale = quantiserScale;
+    coding.intraDcPrecision = m_picture.intraDcPrecision;
+    coding.intraVlcFormat = m_picture.intraVlcFormat;
+    coding.mpeg1 = !m_sequence.mpeg2;
+    return coding;
+}
+
+bool PS2MpegDecoder::startPicture(PS2MpegPictureQueue &pictures)
+{
+    auto drop = [this]()
+    {
+        m_pictureDropped = true;
+        ++m_picturesSkipped;
+        return true;
+    };
+
+    if (!m_sequence.valid)
+        return drop();
+    allocateFrames();
+    if (m_picture.pictureStructure != kFramePicture)
+    {
+        static bool s_warnedFields = false;
+        warnOnce(s_warnedFields, "built-in decoder skips field pictures.");
+        return drop();
+    }
+
+    if (m_picture.coding == PictureCoding::Bidirectional)
+    {
+        if (m_forwardIndex < 0 || m_backwardIndex < 0)
+            return drop();
+        for (int i = 0; i < static_cast<int>(m_frames.size()); ++i)
+        {
+            if (i != m_forwardIndex && i != m_backwardIndex)
+                m_currentIndex = i;
+        }
+    }
+    else
+    {
+        if (m_picture.coding == PictureCoding::Predicted && m_backwardIndex < 0)
+            return drop();
+
+        // The previous anchor is due for display once the next one arrives.
+        if (m_backwardPending && m_backwardIndex >= 0)
+        {
+            m_backwardPending = false;
+            if (!outputFrame(m_frames[static_cast<size_t>(m_backwardIndex)], pictures))
+                return false;
+        }
+        m_forwardIndex = m_backwardIndex;
+        m_currentIndex = m_forwardIndex == 0 ? 1 : 0;
+        m_backwardIndex = m_currentIndex;
+    }
+
+    Frame &frame = m_frames[static_cast<size_t>(m_currentIndex)];
+    frame.pts90k = m_picture.pts90k;
+    frame.repeatPict = 0;
+    if (m_picture.repeatFirstField)
+    {
+        if (m_sequence.progressiveSequence)
+            frame.repeatPict = m_picture.topFieldFirst ? 4 : 2;
+        else if (m_picture.progressiveFrame)
+            frame.repeatPict = 1;
+    }
+    m_pictureActive = true;
+    return true;
+}
+
+bool PS2MpegDecoder::finishPicture(PS2MpegPictureQueue &pictures)
+{
+    const bool active = m_pictureActive;
+    m_pictureActive = false;
+    m_pictureHeaderSeen = false;
+    m_pictureDropped = false;
+    if (!active)
+        return true;
+
+    ++m_picturesDecoded;
+    if (m_picture.coding == PictureCoding::Bidirectional)
+        return outputFrame(m_frames[static_cast<size_t>(m_currentIndex)], pictures);
+
+    m_backwardPending = true;
+    return true;
+}
+
+bool PS2MpegDecoder::outputFrame(const Frame &frame, PS2MpegPictureQueue &pictures)
+{
+    PS2MpegPicture *picture = pictures.acquire();
+    if (!picture)
+        return false;
+
+    picture->allocate(m_sequence.width, m_sequence.height);
+    picture->pts90k = frame.pts90k;
+    picture->repeatPict = frame.repeatPict;
+
+    const size_t srcStride = static_cast<size_t>(m_frameMbWidth) * 16u;
+    const size_t rows = std::min<size_t>(picture->alignedHeight(), static_cast<size_t>(m_frameMbHeight) * 16u);
+    const size_t columns = std::min<size_t>(picture->lumaStride(), srcStride);
+    for (size_t y = 0; y < rows; ++y)
+    {
+        std::memcpy(picture->luma.data() + y * picture->lumaStride(), frame.luma.data() + y * srcStride, columns);
+    }
+    for (size_t y = 0; y < rows / 2u; ++y)
+    {
+        std::memcpy(picture->cb.data() + y * picture->chromaStride(), frame.cb.data() + y * (srcStride / 2u), columns / 2u);
+        std::memcpy(picture->cr.data() + y * picture->chromaStride(), frame.cr.data() + y * (srcStride / 2u), columns / 2u);
+    }
+
+    pictures.publish(picture);
+    return true;
+}
+
+void PS2MpegDecoder::decodeSlice(uint32_t row, const uint8_t *payload, size_t size)
+{
+    if (row >= m_frameMbHeight)
+        return;
+
+    BitReader reader(payload, size);
+    int quantiserScale = ps2_mpeg::quantiserScale(static_cast<int>(reader.read(5u)),
+                                                  m_sequence.mpeg2 && m_picture.qScaleType);
+    if (m_sequence.mpeg2 && reader.peek(1u) == 1u)
+        reader.skip(9u); // intra_slice_flag, intra_slice, reserved_bits
+    while (reader.readFlag())
+        reader.skip(8u); // extra_information_slice
+
+    const int dcReset = 128 << (m_sequence.mpeg2 ? m_picture.intraDcPrecision : 0);
+    int dcPredictors[3] = {dcReset, dcReset, dcReset};
+    MotionState motion;
+
+    const uint32_t mbCount = m_frameMbWidth * m_frameMbHeight;
+    int increment = ps2_mpeg::decodeMacroblockAddressIncrement(reader);
+    if (increment <= 0)
+        return;
+    uint32_t address = row * m_frameMbWidth + static_cast<uint32_t>(increment - 1);
+    while (address < mbCount)
+    {
+        if (!decodeMacroblock(reader, address % m_frameMbWidth, address / m_frameMbWidth,
+                              quantiserScale, dcPredictors, motion))
+            return;
+        if (reader.overrun() || reader.atStartCode())
+            return;
+
+        increment = ps2_mpeg::decodeMacroblockAddressIncrement(reader);
+        if (increment <= 0)
+            return;
+
+        // Skipped macroblocks reset the DC predictors and copy their
+        // prediction; I pictures have none.
+        if (increment > 1)
+        {
+            if (m_picture.coding == PictureCoding::Intra || m_picture.coding == PictureCoding::DcIntra)
+                return;
+            dcPredictors[0] = dcPredictors[1] = dcPredictors[2] = dcReset;
+            for (int skipped = 1; skipped < increment && address + static_cast<uint32_t>(skipped) < mbCount; ++skipped)
+            {
+                const uint32_t skippedAddress = address + static_cast<uint32_t>(skipped);
+                skipMacroblock(skippedAddress % m_frameMbWidth, skippedAddress / m_frameMbWidth, motion);
+            }
+        }
+        address += static_cast<uint32_t>(increment);
+    }
+}
+
+void PS2MpegDecoder::skipMacroblock(uint32_t mbX, uint32_t mbY, MotionState &motion)
+{
+    if (m_picture.coding == PictureCoding::Predicted)
+    {
+        // Zero-vector frame prediction from the forward anchor.
+        std::memset(motion.pmv, 0, sizeof(motion.pmv));
+        motion.flags = kMbMotionForward;
+        motion.motionType = kMotionFrame;
+        std::memset(motion.vectors, 0, sizeof(motion.vectors));
+    }
+    else
+    {
+        // B pictures keep the previous macroblock's directions but always
+        // predict a skipped macroblock as a frame from the predictors.
+        motion.motionType = kMotionFrame;
+        for (int direction = 0; direction < 2; ++direction)
+        {
+            const int scale = (!m_sequence.mpeg2 && m_picture.fullPel[direction]) ? 2 : 1;
+            motion.vectors[0][direction][0] = motion.pmv[0][direction][0] * scale;
+            motion.vectors[0][direction][1] = motion.pmv[0][direction][1] * scale;
+        }
+    }
+    predictMacroblock(mbX, mbY, motion);
+}
+
+bool PS2MpegDecoder::decodeMacroblock(BitReader &reader, uint32_t mbX, uint32_t mbY, int &quantiserScale,
+                                      int dcPredictors[3], MotionState &motion)
+{
+    const int type = ps2_mpeg::decodeMacroblockType(reader, m_picture.coding);
+    if (type == ps2_mpeg::kVlcInvalid)
+        return false;
+    const uint32_t flags = static_cast<uint32_t>(type);
+
+    int motionType = kMotionFrame;
+    if ((flags & (kMbMotionForward | kMbMotionBackward)) != 0u && !m_picture.framePredFrameDct)
+        motionType = static_cast<int>(reader.read(2u));
+
+    bool fieldDct = false;
+    if (!m_picture.framePredFrameDct && (flags & (kMbIntra | kMbPattern)) != 0u)
+        fieldDct = reader.readFlag();
+
+    if ((flags & kMbQuant) != 0u)
+        quantiserScale = ps2_mpeg::quantiserScale(static_cast<int>(reader.read(5u)),
+                                                  m_sequence.mpeg2 && m_picture.qScaleType);
+
+    const bool intra = (flags & kMbIntra) != 0u;
+    const int dcReset = 128 << (m_sequence.mpeg2 ? m_picture.intraDcPrecision : 0);
+
+    if (intra)
+    {
+        if (m_picture.concealmentVectors)
+        {
+            // Concealment vectors are parsed for the predictors and unused.
+            motion.motionType = motionType;
+            if (!decodeMotionVectors(reader, 0, motion))
+                return false;
+            reader.skip(1u); // marker_bit
+        }
+        else
+        {
+            std::memset(motion.pmv, 0, sizeof(motion.pmv));
+        }
+        motion.flags = kMbIntra;
+    }
+    else
+    {
+        dcPredictors[0] = dcPredictors[1] = dcPredictors[2] = dcReset;
+        motion.flags = flags;
+        motion.motionType = motionType;
+        if (motionType == kMotionDualPrime)
+        {
+            static bool s_warnedDualPrime = false;
+            warnOnce(s_warnedDualPrime, "built-in decoder skips dual-prime macroblocks.");
+            return false;
+        }
+        if ((flags & kMbMotionForward) != 0u && !decodeMotionVectors(reader, 0, motion))
+            return false;
+        if ((flags & kMbMotionBackward) != 0u && !decodeMotionVectors(reader, 1, motion))
+            return false;
+
+        if (m_picture.coding == PictureCoding::Predicted && (flags & kMbMotionForward) == 0u)
+        {
+            // "No MC" in a P picture: zero vector, predictors reset.
+            std::memset(motion.pmv, 0, sizeof(motion.pmv));
+            std::memset(motion.vectors, 0, sizeof(motion.vectors));
+            motion.flags |= kMbMotionForward;
+            motion.motionType = kMotionFrame;
+        }
+        predictMacroblock(mbX, mbY, motion);
+    }
+
+    int codedBlockPattern = intra ? 0x3F : 0;
+    if (!intra && (flags & kMbPattern) != 0u)
+    {
+        codedBlockPattern = ps2_mpeg::decodeCodedBlockPattern(reader);
+        if (codedBlockPattern < 0)
+            return false;
+    }
+
+    Frame &frame = m_frames[static_cast<size_t>(m_currentIndex)];
+    const size_t lumaStride = static_cast<size_t>(m_frameMbWidth) * 16u;
+    const size_t chromaStride = lumaStride / 2u;
+    uint8_t *luma = frame.luma.data() + static_cast<size_t>(mbY) * 16u * lumaStride + mbX * 16u;
+    const ps2_mpeg::BlockCoding coding = blockCoding(quantiserScale);
+
+    alignas(16) int16_t block[64];
+    for (int index = 0; index < 6; ++index)
+    {
+        if ((codedBlockPattern & (0x20 >> index)) == 0)
+            continue;
+
+        uint8_t *dst = nullptr;
+        size_t stride = 0u;
+        if (index < 4)
+        {
+            const size_t column = static_cast<size_t>(index & 1) * 8u;
+            const size_t blockRow = static_cast<size_t>(index >> 1);
+            dst = luma + column + (fieldDct ? blockRow * lumaStride : blockRow * 8u * lumaStride);
+            stride = fieldDct ? lumaStride * 2u : lumaStride;
+        }
+        else
+        {
+            std::vector<uint8_t> &plane = index == 4 ? frame.cb : frame.cr;
+            dst = plane.data() + static_cast<size_t>(mbY) * 8u * chromaStride + mbX * 8u;
+            stride = chromaStride;
+        }
+
+        if (intra)
+        {
+            int &predictor = dcPredictors[index < 4 ? 0 : index - 3];
+            if (!ps2_mpeg::decodeIntraBlock(reader, coding, index >= 4, predictor, block))
+                return false;
+            ps2_mpeg::inverseDct(block);
+            ps2_mpeg::putBlock(block, dst, stride);
+        }
+        else
+        {
+            if (!ps2_mpeg::decodeNonIntraBlock(reader, coding, block))
+                return false;
+            ps2_mpeg::inverseDct(block);
+            ps2_mpeg::addBlock(block, dst, stride);
+        }
+    }
+
+    // MPEG-1 D pictures end every macroblock with a marker bit.
+    if (m_picture.coding == PictureCoding::DcIntra)
+        reader.skip(1u);
+    return true;
+}
+
+bool PS2MpegDecoder::decodeMotionVectors(BitReader &reader, int direction, MotionState &motion)
+{
+    const bool mpeg1 = !m_sequence.mpeg2;
+    auto component = [&](int field, int axis, int predictor) -> int
+    {
+        const int code = ps2_mpeg::decodeMotionCode(reader);
+        if (code == ps2_mpeg::kVlcInvalid)
+            return INT32_MIN;
+        const int fCode = std::max(1, m_picture.fCode[direction][axis]);
+        int residual = 0;
+        if (fCode > 1 && code != 0)
+            residual = static_cast<int>(reader.read(static_cast<uint32_t>(fCode - 1)));
+        (void)field;
+        return applyMotionDelta(predictor, code, residual, fCode);
+    };
+
+    if (motion.motionType == kMotionField)
+    {
+        for (int field = 0; field < 2; ++field)
+        {
+            motion.fieldSelect[field][direction] = reader.readFlag();
+            const int x = component(field, 0, motion.pmv[field][direction][0]);
+            if (x == INT32_MIN)
+                return false;
+            // Field vectors in frame pictures predict from half the frame
+            // vector and store back doubled (7.6.3.1).
+            const int y = component(field, 1, motion.pmv[field][direction][1] >> 1);
+            if (y == INT32_MIN)
+                return false;
+            motion.pmv[field][direction][0] = x;
+            motion.pmv[field][direction][1] = y * 2;
+            motion.vectors[field][direction][0] = x;
+            motion.vectors[field][direction][1] = y;
+        }
+        return true;
+    }
+
+    const int x = component(0, 0, motion.pmv[0][direction][0]);
+    if (x == INT32_MIN)
+        return false;
+    const int y = component(0, 1, motion.pmv[0][direction][1]);
+    if (y == INT32_MIN)
+        return false;
+    motion.pmv[0][direction][0] = motion.pmv[1][direction][0] = x;
+    motion.pmv[0][direction][1] = motion.pmv[1][direction][1] = y;
+
+    // MPEG-1 full-pel vectors count whole pixels.
+    const int scale = (mpeg1 && m_picture.fullPel[direction]) ? 2 : 1;
+    motion.vectors[0][direction][0] = x * scale;
+    motion.vectors[0][direction][1] = y * scale;
+    return !reader.overrun();
+}
+
+void PS2MpegDecoder::predictMacroblock(uint32_t mbX, uint32_t mbY, const MotionState &motion)
+{
+    bool average = false;
+    if ((motion.flags & kMbMotionForward) != 0u && m_forwardIndex >= 0)
+    {
+        predictFromReference(m_frames[static_cast<size_t>(m_forwardIndex)], mbX, mbY, 0, motion, false);
+        average = true;
+    }
+    if ((motion.flags & kMbMotionBackward) != 0u && m_picture.coding == PictureCoding::Bidirectional)
+    {
+        predictFromReference(m_frames[static_cast<size_t>(m_backwardIndex)], mbX, mbY, 1, motion, average);
+    }
+}
+
+void PS2MpegDecoder::predictFromReference(const Frame &reference, uint32_t mbX, uint32_t mbY, int direction,
+                                          const MotionState &motion, bool average)
+{
+    const uint32_t x = mbX * 16u;
+    const uint32_t y = mbY * 16u;
+    if (motion.motionType == kMotionField)
+    {
+        for (uint32_t field = 0; field < 2u; ++field)
+        {
+            predictRegion(reference, x, y, 8u,
+                          motion.vectors[field][direction][0], motion.vectors[field][direction][1],
+                          motion.fieldSelect[field][direction] ? 1u : 0u, field, true, average);
+        }
+        return;
+    }
+    predictRegion(reference, x, y, 16u, motion.vectors[0][direction][0], motion.vectors[0][direction][1],
+                  0u, 0u, false, average);
+}
+
+void PS2MpegDecoder::predictRegion(const Frame &reference, uint32_t x, uint32_t y, uint32_t lumaRows, int mvX, int mvY,
+                                   uint32_t sourceField, uint32_t targetField, bool fieldPrediction, bool average)
+{
+    Frame &target = m_frames[static_cast<size_t>(m_currentIndex)];
+    const int lumaWidth = static_cast<int>(m_frameMbWidth) * 16;
+    const int chromaWidth = lumaWidth / 2;
+
+    // Field prediction works on one field: every other line, half the rows.
+    const size_t lineStep = fieldPrediction ? 2u : 1u;
+    const int planeRows = static_cast<int>(m_frameMbHeight * 16u / lineStep);
+    const int baseRow = static_cast<int>(y / lineStep);
+    const size_t lumaStride = static_cast<size_t>(lumaWidth) * lineStep;
+    const size_t chromaStride = static_cast<size_t>(chromaWidth) * lineStep;
+
+    alignas(16) uint8_t scratch[kEdgeScratchStride * 17u];
+    size_t sourceStride = 0u;
+    {
+        const uint8_t *src = edgeSource(reference.luma.data() + sourceField * static_cast<size_t>(lumaWidth), lumaStride,
+                                        lumaWidth, planeRows, static_cast<int>(x) + (mvX >> 1), baseRow + (mvY >> 1),
+                                        16, static_cast<int>(lumaRows), scratch, sourceStride);
+        uint8_t *dst = target.luma.data() + (y + targetField) * static_cast<size_t>(lumaWidth) + x;
+        ps2_mpeg::predictBlock(dst, lumaStride, src, sourceStride, 16u, lumaRows, (mvX & 1) != 0, (mvY & 1) != 0,
+                               average);
+    }
+
+    // 4:2:0 chroma vectors are the luma ones halved toward zero.
+    const int chromaX = mvX / 2;
+    const int chromaY = mvY / 2;
+    const uint32_t chromaRows = lumaRows / 2u;
+    const int sourceX = static_cast<int>(x / 2u) + (chromaX >> 1);
+    const int sourceY = baseRow / 2 + (chromaY >> 1);
+    const size_t fieldOffset = sourceField * static_cast<size_t>(chromaWidth);
+    const size_t dstOffset = (y / 2u + targetField) * static_cast<size_t>(chromaWidth) + x / 2u;
+    const std::vector<uint8_t> *sourcePlanes[2] = {&reference.cb, &reference.cr};
+    std::vector<uint8_t> *targetPlanes[2] = {&target.cb, &target.cr};
+    for (size_t plane = 0; plane < 2u; ++plane)
+    {
+        const uint8_t *src = edgeSource(sourcePlanes[plane]->data() + fieldOffset, chromaStride, chromaWidth,
+                                        planeRows / 2, sourceX, sourceY, 8, static_cast<int>(chromaRows), scratch,
+                                        sourceStride);
+        ps2_mpeg::predictBlock(targetPlanes[plane]->data() + dstOffset, chromaStride, src, sourceStride, 8u,
+                               chromaRows, (chromaX & 1) != 0, (chromaY & 1) != 0, average);
+    }
+}
@@ -0,0 +1,271 @@
+#include "runtime/ps2_mpeg_video.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(USE_SSE2NEON)
+#include "sse2neon.h"
+#else
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // BT.601 studio-range coefficients in Q14. Inputs are pre-shifted left by
+    // seven so one mulhi leaves every term in Q5 without overflowing 16 bits.
+    // Cb's blue gain (2.017) is split into an exact 2.0 plus a small remainder.
+    constexpr int16_t kLumaGain = 19077;
+    constexpr int16_t kCrToRed = 26149;
+    constexpr int16_t kCbToGreen = 6419;
+    constexpr int16_t kCrToGreen = 13320;
+    constexpr int16_t kCbToBlueFraction = 282;
+    constexpr int32_t kResultRound = 16;
+    constexpr int32_t kResultShift = 5;
+
+    inline int32_t mulhi16(int32_t a, int32_t b)
+    {
+        return (a * b) >> 16;
+    }
+
+    inline uint8_t clampComponent(int32_t value)
+    {
+        return static_cast<uint8_t>(std::clamp((value + kResultRound) >> kResultShift, 0, 255));
+    }
+
+    inline void storePixel(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha,
+                           ps2_mpeg::PixelFormat format, uint8_t *dst)
+    {
+        if (format == ps2_mpeg::PixelFormat::Rgba32)
+        {
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+            dst[3] = alpha;
+            return;
+        }
+
+        const uint16_t packed = static_cast<uint16_t>((r >> 3u) | ((g >> 3u) << 5u) | ((b >> 3u) << 10u) |
+                                                      (alpha != 0u ? 0x8000u : 0u));
+        dst[0] = static_cast<uint8_t>(packed);
+        dst[1] = static_cast<uint8_t>(packed >> 8u);
+    }
+
+    // Eight pixels per call: luma widened to 16-bit lanes, each chroma sample
+    // duplicated across its two pixels, then the same Q5 arithmetic as
+    // convertPixel so both paths agree bit for bit.
+    inline void convertSpan8(const uint8_t *luma, const uint8_t *cb, const uint8_t *cr,
+                             uint8_t alpha, ps2_mpeg::PixelFormat format, uint8_t *dst)
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        uint32_t cbWord = 0;
+        uint32_t crWord = 0;
+        std::memcpy(&cbWord, cb, sizeof(cbWord));
+        std::memcpy(&crWord, cr, sizeof(crWord));
+
+        const __m128i y16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(luma)), zero);
+        __m128i cb16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(cbWord)), zero);
+        __m128i cr16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(crWord)), zero);
+        cb16 = _mm_unpacklo_epi16(cb16, cb16);
+        cr16 = _mm_unpacklo_epi16(cr16, cr16);
+
+        const __m128i c = _mm_slli_epi16(_mm_sub_epi16(y16, _mm_set1_epi16(16)), 7);
+        const __m128i d = _mm_slli_epi16(_mm_sub_epi16(cb16, _mm_set1_epi16(128)), 7);
+        const __m128i e = _mm_slli_epi16(_mm_sub_epi16(cr16, _mm_set1_epi16(128)), 7);
+
+        const __m128i yTerm = _mm_mulhi_epi16(c, _mm_set1_epi16(kLumaGain));
+        __m128i r = _mm_add_epi16(yTerm, _mm_mulhi_epi16(e, _mm_set1_epi16(kCrToRed)));
+        __m128i g = _mm_sub_epi16(
+            _mm_sub_epi16(yTerm, _mm_mulhi_epi16(d, _mm_set1_epi16(kCbToGreen))),
+            _mm_mulhi_epi16(e, _mm_set1_epi16(kCrToGreen)));
+        __m128i b = _mm_add_epi16(
+            _mm_add_epi16(yTerm, _mm_srai_epi16(d, 1)),
+            _mm_mulhi_epi16(d, _mm_set1_epi16(kCbToBlueFraction)));
+
+        const __m128i round = _mm_set1_epi16(static_cast<int16_t>(kResultRound));
+        r = _mm_srai_epi16(_mm_add_epi16(r, round), kResultShift);
+        g = _mm_srai_epi16(_mm_add_epi16(g, round), kResultShift);
+        b = _mm_srai_epi16(_mm_add_epi16(b, round), kResultShift);
+
+        // packus clamps to 0..255.
+        const __m128i r8 = _mm_packus_epi16(r, r);
+        const __m128i g8 = _mm_packus_epi16(g, g);
+        const __m128i b8 = _mm_packus_epi16(b, b);
+
+        if (format == ps2_mpeg::PixelFormat::Rgba32)
+        {
+            const __m128i a8 = _mm_set1_epi8(static_cast<char>(alpha));
+            const __m128i rg = _mm_unpacklo_epi8(r8, g8);
+            const __m128i ba = _mm_unpacklo_epi8(b8, a8);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi16(rg, ba));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi16(rg, ba));
+            return;
+        }
+
+        const __m128i r5 = _mm_srli_epi16(_mm_unpacklo_epi8(r8, zero), 3);
+        const __m128i g5 = _mm_slli_epi16(_mm_srli_epi16(_mm_unpacklo_epi8(g8, zero), 3), 5);
+        const __m128i b5 = _mm_slli_epi16(_mm_srli_epi16(_mm_unpacklo_epi8(b8, zero), 3), 10);
+        __m128i packed = _mm_or_si128(_mm_or_si128(r5, g5), b5);
+        if (alpha != 0u)
+        {
+            packed = _mm_or_si128(packed, _mm_set1_epi16(static_cast<int16_t>(0x8000u)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), packed);
+    }
+}
+
+void PS2MpegPicture::allocate(uint32_t pictureWidth, uint32_t pictureHeight)
+{
+    const bool sameSize = width == pictureWidth && height == pictureHeight && !luma.empty();
+    width = pictureWidth;
+    height = pictureHeight;
+    if (sameSize)
+        return;
+
+    const size_t chromaRows = alignedHeight() / 2u;
+    luma.assign(static_cast<size_t>(lumaStride()) * alignedHeight(), 16u);
+    cb.assign(static_cast<size_t>(chromaStride()) * chromaRows, 128u);
+    cr.assign(static_cast<size_t>(chromaStride()) * chromaRows, 128u);
+}
+
+PS2MpegPictureQueue::PS2MpegPictureQueue(size_t slotCount)
+{
+    m_slots.reserve(slotCount);
+    m_free.reserve(slotCount);
+    for (size_t i = 0; i < slotCount; ++i)
+    {
+        m_slots.push_back(std::make_unique<PS2MpegPicture>());
+        m_free.push_back(m_slots.back().get());
+    }
+}
+
+PS2MpegPicture *PS2MpegPictureQueue::acquire()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_slotFreed.wait(lock, [this]
+                     { return m_closed || !m_free.empty(); });
+    if (m_closed)
+        return nullptr;
+
+    PS2MpegPicture *picture = m_free.back();
+    m_free.pop_back();
+    return picture;
+}
+
+PS2MpegPicture *PS2MpegPictureQueue::tryAcquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_closed || m_free.empty())
+        return nullptr;
+
+    PS2MpegPicture *picture = m_free.back();
+    m_free.pop_back();
+    return picture;
+}
+
+void PS2MpegPictureQueue::publish(PS2MpegPicture *picture)
+{
+    if (!picture)
+        return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ready.push_back(picture);
+    ++m_published;
+}
+
+const PS2MpegPicture *PS2MpegPictureQueue::peek() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ready.empty() ? nullptr : m_ready.front();
+}
+
+PS2MpegPicture *PS2MpegPictureQueue::take()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ready.empty())
+        return nullptr;
+
+    PS2MpegPicture *picture = m_ready.front();
+    m_ready.pop_front();
+    return picture;
+}
+
+size_t PS2MpegPictureQueue::readyCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ready.size();
+}
+
+uint64_t PS2MpegPictureQueue::publishedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_published;
+}
+
+void PS2MpegPictureQueue::release(PS2MpegPicture *picture)
+{
+    if (!picture)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(picture);
+    }
+    m_slotFreed.notify_one();
+}
+
+void PS2MpegPictureQueue::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.insert(m_free.end(), m_ready.begin(), m_ready.end());
+        m_ready.clear();
+    }
+    m_slotFreed.notify_all();
+}
+
+void PS2MpegPictureQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_slotFreed.notify_all();
+}
+
+void PS2MpegPictureQueue::reopen()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = false;
+}
+
+namespace ps2_mpeg
+{
+    void convertPixel(uint8_t y, uint8_t cb, uint8_t cr, uint8_t rgb[3])
+    {
+        const int32_t c = (static_cast<int32_t>(y) - 16) << 7;
+        const int32_t d = (static_cast<int32_t>(cb) - 128) << 7;
+        const int32_t e = (static_cast<int32_t>(cr) - 128) << 7;
+        const int32_t yTerm = mulhi16(c, kLumaGain);
+        rgb[0] = clampComponent(yTerm + mulhi16(e, kCrToRed));
+        rgb[1] = clampComponent(yTerm - mulhi16(d, kCbToGreen) - mulhi16(e, kCrToGreen));
+        rgb[2] = clampComponent(yTerm + (d >> 1) + mulhi16(d, kCbToBlueFraction));
+    }
+
+    void convertRow(const uint8_t *luma, const uint8_t *cb, const uint8_t *cr,
+                    uint32_t pixelCount, uint8_t alpha, PixelFormat format, uint8_t *dst)
+    {
+        const uint32_t bytesPerPixel = format == PixelFormat::Rgba32 ? 4u : 2u;
+        uint32_t x = 0;
+        for (; x + 8u <= pixelCount; x += 8u)
+        {
+            convertSpan8(luma + x, cb + x / 2u, cr + x / 2u, alpha, format, dst + x * bytesPerPixel);
+        }
+
+        for (; x < pixelCount; ++x)
+        {
+            uint8_t rgb[3];
+            convertPixel(luma[x], cb[x / 2u], cr[x / 2u], rgb);
+            storePixel(rgb[0], rgb[1], rgb[2], alpha, format, dst + x * bytesPerPixel);
+        }
+    }
+}
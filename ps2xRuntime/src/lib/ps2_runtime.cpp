@@ -100,6 +100,7 @@ namespace
     constexpr uint32_t EXCEPTION_VECTOR_TLB_REFILL = 0x80000000u;
     constexpr uint32_t EXCEPTION_VECTOR_BOOT = 0xBFC00200u;
 
+#if defined(PS2X_ENABLE_DISPATCH_TRACE) && PS2X_ENABLE_DISPATCH_TRACE
     struct DispatchHistory
     {
         std::array<uint32_t, 64> pcs{};
@@ -108,6 +109,7 @@ namespace
     };
 
     thread_local DispatchHistory g_dispatchHistory;
+#endif
 
     bool computeFileCrc32(const std::string &path, uint32_t &crcOut)
     {
@@ -151,6 +153,7 @@ namespace
         return true;
     }
 
+#if defined(PS2X_ENABLE_DISPATCH_TRACE) && PS2X_ENABLE_DISPATCH_TRACE
     void pushDispatchPc(uint32_t pc)
     {
         DispatchHistory &h = g_dispatchHistory;
@@ -185,6 +188,16 @@ namespace
         }
         return oss.str();
     }
+#else
+    inline void pushDispatchPc(uint32_t)
+    {
+    }
+
+    std::string formatDispatchHistory()
+    {
+        return "(disabled, build with PS2X_ENABLE_DISPATCH_TRACE)";
+    }
+#endif
 
     uint32_t selectExceptionVector(const R5900Context *ctx, bool tlbRefill)
     {
@@ -212,10 +225,11 @@ namespace
         ctx->vu0_vpu_stat2 = 0;
     }
 
+    // The interpreter state persists between micro calls, so only the
+    // architectural registers are loaded; VU1Interpreter::execute resets the
+    // per-run control fields itself.
     void copyVu0ContextToState(const R5900Context *ctx, VU1State &state)
     {
-        std::memset(&state, 0, sizeof(state));
-
         for (uint32_t i = 0; i < 32u; ++i)
         {
             _mm_storeu_ps(state.vf[i], ctx->vu0_vf[i]);
@@ -383,8 +397,8 @@ static void UploadFrame(Texture2D &tex, PS2Runtime *rt, uint32_t &outWidth, uint
     static uint32_t s_lastWidth = 0u;
     static uint32_t s_lastHeight = 0u;
     static bool s_hasUploadedFrame = false;
-    static std::vector<uint8_t> s_scratch;
-    static std::vector<uint8_t> s_uploadBuffer(DEFAULT_FB_SIZE, 0u);
+    static uint64_t s_lastUploadedSequence = std::numeric_limits<uint64_t>::max();
+    static std::vector<uint8_t> s_uploadBuffer;
 
     const uint64_t currentTick = rt->eeScheduler().currentVSyncTick();
     const bool needsLatch = !s_hasLatchedInitialFrame || currentTick != s_lastPresentationTick;
@@ -401,79 +415,84 @@ static void UploadFrame(Texture2D &tex, PS2Runtime *rt, uint32_t &outWidth, uint
         return;
     }
 
-    s_scratch.clear();
-    uint32_t width = 0u;
-    uint32_t height = 0u;
-    uint32_t displayFbp = 0u;
-    uint32_t sourceFbp = 0u;
-    bool usedPreferredDisplaySource = false;
-    if (!rt->gs().copyLatchedHostPresentationFrame(s_scratch,
-                                                   width,
-                                                   height,
-                                                   &displayFbp,
-                                                   &sourceFbp,
-                                                   &usedPreferredDisplaySource))
-    {
-        Image blank = GenImageColor(FB_WIDTH, FB_HEIGHT, MAGENTA);
-        UpdateTexture(tex, blank.data);
-        UnloadImage(blank);
+    uint64_t sequence = 0u;
+    const PresentationFrame *frame = rt->gs().acquireHostPresentationFrame(&sequence);
+    if (!frame)
+    {
+        if (!s_hasUploadedFrame || s_lastUploadedSequence != sequence)
+        {
+            Image blank = GenImageColor(FB_WIDTH, FB_HEIGHT, MAGENTA);
+            UpdateTexture(tex, blank.data);
+            UnloadImage(blank);
+        }
         outWidth = FB_WIDTH;
         outHeight = DEFAULT_DISPLAY_HEIGHT;
         s_lastWidth = outWidth;
         s_lastHeight = outHeight;
+        s_lastUploadedSequence = sequence;
         s_hasUploadedFrame = true;
         return;
     }
 
+    // The latched frame is still on the texture.
+    if (s_hasUploadedFrame && sequence == s_lastUploadedSequence)
+    {
+        outWidth = s_lastWidth;
+        outHeight = s_lastHeight;
+        return;
+    }
+
+    const uint32_t width = frame->width;
+    const uint32_t height = frame->height;
     PS2_IF_AGRESSIVE_LOGS({
         static uint32_t s_uploadDebugCount = 0u;
         if (s_uploadDebugCount < 128u ||
-            displayFbp != s_lastDisplayFbp ||
-            sourceFbp != s_lastSourceFbp ||
-            usedPreferredDisplaySource != s_lastPreferred ||
+            frame->displayFbp != s_lastDisplayFbp ||
+            frame->sourceFbp != s_lastSourceFbp ||
+            frame->usedPreferred != s_lastPreferred ||
             width != s_lastWidth ||
             height != s_lastHeight)
         {
             std::cout << "[frame:upload] idx=" << s_uploadDebugCount
                       << " tick=" << currentTick
-                      << " displayFbp=" << displayFbp
-                      << " sourceFbp=" << sourceFbp
+                      << " displayFbp=" << frame->displayFbp
+                      << " sourceFbp=" << frame->sourceFbp
                       << " size=" << width << "x" << height
-                      << " preferred=" << static_cast<uint32_t>(usedPreferredDisplaySource ? 1u : 0u)
+                      << " preferred=" << static_cast<uint32_t>(frame->usedPreferred ? 1u : 0u)
                       << std::endl;
         }
         ++s_uploadDebugCount;
     });
-    s_lastDisplayFbp = displayFbp;
-    s_lastSourceFbp = sourceFbp;
-    s_lastPreferred = usedPreferredDisplaySource;
+    s_lastDisplayFbp = frame->displayFbp;
+    s_lastSourceFbp = frame->sourceFbp;
+    s_lastPreferred = frame->usedPreferred;
     s_lastWidth = width;
     s_lastHeight = height;
 
-    std::fill(s_uploadBuffer.begin(), s_uploadBuffer.end(), 0u);
-    if (!s_scratch.empty() && width != 0u && height != 0u)
+    // Presentation frames share the texture layout (640 pixel rows, zeroed
+    // outside the display rectangle), so they upload as they are.
+    if (frame->pixels.size() >= DEFAULT_FB_SIZE)
     {
-        const uint32_t copyWidth = std::min<uint32_t>(width, FB_WIDTH);
-        const uint32_t copyHeight = std::min<uint32_t>(height, FB_HEIGHT);
-        const size_t srcRowBytes = static_cast<size_t>(width) * 4u;
-        const size_t dstRowBytes = static_cast<size_t>(FB_WIDTH) * 4u;
-        const size_t copyRowBytes = static_cast<size_t>(copyWidth) * 4u;
-        for (uint32_t y = 0; y < copyHeight; ++y)
+        UpdateTexture(tex, frame->pixels.data());
+    }
+    else
+    {
+        s_uploadBuffer.assign(DEFAULT_FB_SIZE, 0u);
+        const size_t rowBytes = static_cast<size_t>(FB_WIDTH) * 4u;
+        const size_t copyRowBytes = static_cast<size_t>(std::min<uint32_t>(width, FB_WIDTH)) * 4u;
+        for (uint32_t y = 0; y < std::min<uint32_t>(height, FB_HEIGHT); ++y)
         {
-            const size_t srcOffset = static_cast<size_t>(y) * srcRowBytes;
-            const size_t dstOffset = static_cast<size_t>(y) * dstRowBytes;
-            if (srcOffset + copyRowBytes > s_scratch.size() ||
-                dstOffset + copyRowBytes > s_uploadBuffer.size())
-            {
+            const size_t offset = static_cast<size_t>(y) * rowBytes;
+            if (offset + copyRowBytes > frame->pixels.size())
                 break;
-            }
-            std::memcpy(s_uploadBuffer.data() + dstOffset, s_scratch.data() + srcOffset, copyRowBytes);
+            std::memcpy(s_uploadBuffer.data() + offset, frame->pixels.data() + offset, copyRowBytes);
         }
+        UpdateTexture(tex, s_uploadBuffer.data());
     }
 
-    UpdateTexture(tex, s_uploadBuffer.data());
     outWidth = width;
     outHeight = height;
+    s_lastUploadedSequence = sequence;
     s_hasUploadedFrame = true;
 }
 
@@ -536,6 +555,8 @@ PS2Runtime::~PS2Runtime()
     try
     {
         requestStop();
+        // MPEG decode workers post wakes to this runtime; join them first.
+        ps2_stubs::resetMpegStubState();
         m_iopSubsystem.reset();
         m_iopHost.reset();
 #if defined(PLATFORM_VITA)
@@ -544,8 +565,9 @@ PS2Runtime::~PS2Runtime()
 #else
         if (IsAudioDeviceReady())
         {
-            CloseAudioDevice();
+            // The mixer stream must be torn down while the device is open.
             m_audioBackend.setAudioReady(false);
+            CloseAudioDevice();
         }
 #endif
         if (m_debugUiInitialized && m_debugUiShutdownCallback)
@@ -682,6 +704,7 @@ bool PS2Runtime::initialize(const char *title)
             std::cerr << "Failed to bind runtime core subsystems" << std::endl;
             return false;
         }
+        ps2_syscalls::configureFioVagStreamingFromEnvironment();
 #if defined(PS2X_IOP_ENABLE_PLUGINS) && PS2X_IOP_ENABLE_PLUGINS && \
     !defined(PLATFORM_VITA) && (defined(_WIN32) || defined(__linux__))
         std::string pluginError;
@@ -1062,6 +1085,7 @@ bool PS2Runtime::replaceFunction(uint32_t address, RecompiledFunction func)
     }
 
     g_ps2RecompiledFunctionTable[slot] = func;
+    invalidateGuestBranchCaches();
     return true;
 }
 
@@ -1145,6 +1169,13 @@ void PS2Runtime::resetMissingFunctionReportOnce()
     m_missingFunctionReported.store(false, std::memory_order_release);
 }
 
+void PS2Runtime::reportUncleanCall(const R5900Context *ctx, uint32_t targetPc, uint32_t sourcePc, uint32_t returnPc)
+{
+    std::cerr << "[call] callee 0x" << std::hex << targetPc << " called from 0x" << sourcePc
+              << " was emitted without a return check but came back with pc=0x" << ctx->pc
+              << " instead of 0x" << returnPc << std::dec << std::endl;
+}
+
 void PS2Runtime::reportMissingFunction(uint8_t *rdram,
                                        R5900Context *ctx,
                                        uint32_t targetPc,
@@ -1156,17 +1187,17 @@ void PS2Runtime::reportMissingFunction(uint8_t *rdram,
     const bool firstReport = !m_missingFunctionReported.exchange(true, std::memory_order_acq_rel);
 
     const uint32_t pc = ctx->pc;
-    const uint32_t ra = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[31], 0));
-    const uint32_t sp = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[29], 0));
-    const uint32_t gp = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[28], 0));
-    const uint32_t a0 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[4], 0));
-    const uint32_t a1 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[5], 0));
-    const uint32_t a2 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[6], 0));
-    const uint32_t a3 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[7], 0));
-    const uint32_t s0 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[16], 0));
-    const uint32_t s1 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[17], 0));
-    const uint32_t v0 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[2], 0));
-    const uint32_t v1 = static_cast<uint32_t>(_mm_extract_epi32(ctx->r[3], 0));
+    const uint32_t ra = static_cast<uint32_t>(ctx->r[31].lo);
+    const uint32_t sp = static_cast<uint32_t>(ctx->r[29].lo);
+    const uint32_t gp = static_cast<uint32_t>(ctx->r[28].lo);
+    const uint32_t a0 = static_cast<uint32_t>(ctx->r[4].lo);
+    const uint32_t a1 = static_cast<uint32_t>(ctx->r[5].lo);
+    const uint32_t a2 = static_cast<uint32_t>(ctx->r[6].lo);
+    const uint32_t a3 = static_cast<uint32_t>(ctx->r[7].lo);
+    const uint32_t s0 = static_cast<uint32_t>(ctx->r[16].lo);
+    const uint32_t s1 = static_cast<uint32_t>(ctx->r[17].lo);
+    const uint32_t v0 = static_cast<uint32_t>(ctx->r[2].lo);
+    const uint32_t v1 = static_cast<uint32_t>(ctx->r[3].lo);
 
     auto readGuestU32At = [rdram](uint32_t addr, uint32_t &out) -> bool
     {
@@ -1303,6 +1334,72 @@ void PS2Runtime::reportMissingFunction(uint8_t *rdram,
     }
 }
 
+void PS2Runtime::invalidateGuestBranchCaches() noexcept
+{
+    uint32_t next = s_guestBranchCacheGeneration.load(std::memory_order_relaxed) + 1u;
+    if (next == 0u)
+    {
+        // Zero is the generation of a never-filled cache.
+        next = 1u;
+    }
+    s_guestBranchCacheGeneration.store(next, std::memory_order_relaxed);
+}
+
+PS2Runtime::GuestBranchStats PS2Runtime::guestBranchStats() const
+{
+    GuestBranchStats stats;
+    stats.dispatches = m_guestBranchDispatches.load(std::memory_order_relaxed);
+    stats.indirectCalls = m_guestBranchIndirectCalls.load(std::memory_order_relaxed);
+    stats.indirectJumps = m_guestBranchIndirectJumps.load(std::memory_order_relaxed);
+    stats.cacheHits = m_guestBranchCacheHits.load(std::memory_order_relaxed);
+    stats.cacheMisses = m_guestBranchCacheMisses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PS2Runtime::resetGuestBranchStats()
+{
+    m_guestBranchDispatches.store(0u, std::memory_order_relaxed);
+    m_guestBranchIndirectCalls.store(0u, std::memory_order_relaxed);
+    m_guestBranchIndirectJumps.store(0u, std::memory_order_relaxed);
+    m_guestBranchCacheHits.store(0u, std::memory_order_relaxed);
+    m_guestBranchCacheMisses.store(0u, std::memory_order_relaxed);
+}
+
+bool PS2Runtime::dispatchGuestBranchMiss(uint8_t *rdram,
+                                         R5900Context *ctx,
+                                         uint32_t targetPc,
+                                         uint32_t sourcePc,
+                                         uint32_t fallthroughPc,
+                                         GuestBranchKind kind,
+                                         const char *debugName,
+                                         GuestBranchCache &cache)
+{
+    bumpGuestBranchCounter(m_guestBranchCacheMisses);
+
+    uint32_t slot = 0u;
+    if (generatedFunctionTableSlot(targetPc, slot) && g_ps2RecompiledFunctionTable[slot] != nullptr)
+    {
+        const uint32_t generation = s_guestBranchCacheGeneration.load(std::memory_order_relaxed);
+        if (cache.generation != generation)
+        {
+            cache = GuestBranchCache{};
+            cache.generation = generation;
+        }
+
+        // Most-recent first, like a hit: the new target goes to slot 0 and
+        // the least recently used one drops off the end.
+        for (uint32_t i = GuestBranchCache::kEntries - 1u; i > 0u; --i)
+        {
+            cache.targets[i] = cache.targets[i - 1u];
+            cache.functions[i] = cache.functions[i - 1u];
+        }
+        cache.targets[0] = targetPc;
+        cache.functions[0] = g_ps2RecompiledFunctionTable[slot];
+    }
+
+    return dispatchGuestBranch(rdram, ctx, targetPc, sourcePc, fallthroughPc, kind, debugName);
+}
+
 bool PS2Runtime::dispatchGuestBranch(uint8_t *rdram,
                                      R5900Context *ctx,
                                      uint32_t targetPc,
@@ -1313,11 +1410,20 @@ bool PS2Runtime::dispatchGuestBranch(uint8_t *rdram,
 {
     ctx->pc = targetPc;
     const bool isCall = (kind == GuestBranchKind::DirectCall || kind == GuestBranchKind::IndirectCall);
+    bumpGuestBranchCounter(m_guestBranchDispatches);
+    if (kind == GuestBranchKind::IndirectCall)
+    {
+        bumpGuestBranchCounter(m_guestBranchIndirectCalls);
+    }
+    else if (kind == GuestBranchKind::IndirectJump)
+    {
+        bumpGuestBranchCounter(m_guestBranchIndirectJumps);
+    }
 
     // Every inter-function transfer is also a deterministic EE safe point.
     // Backward edges inside generated functions use eeCheckpointDue(), while
     // this charge bounds straight-line call chains that have no local loop.
-    if (m_eeScheduler && m_eeScheduler->checkpointDue(EeScheduler::kGuestDispatchCycles))
+    if (m_eeScheduler && m_eeScheduler->checkpointDue(kGuestBranchDispatchCycles))
     {
         return false;
     }
@@ -1397,7 +1503,6 @@ void PS2Runtime::executeVU0Microprogram(uint8_t *rdram, R5900Context *ctx, uint3
         return;
     }
 
-    m_vu0.reset();
     copyVu0ContextToState(ctx, m_vu0.state());
     m_vu0.execute(vu0Code, PS2_VU0_CODE_SIZE,
                   vu0Data, PS2_VU0_DATA_SIZE,
@@ -2171,7 +2276,7 @@ void PS2Runtime::postEeEvent(EeEvent event)
 
 bool PS2Runtime::eeCheckpointDue(uint32_t cycles) noexcept
 {
-    return m_eeScheduler->checkpointDue(cycles);
+    return m_eeScheduler && m_eeScheduler->checkpointDue(cycles);
 }
 
 [[noreturn]] void PS2Runtime::eeWaitVSyncTicks(uint32_t ticks, uint32_t resumePc)
@@ -2311,9 +2416,9 @@ void PS2Runtime::run()
     m_cpuContext.r[5] = _mm_setzero_si128();
     m_cpuContext.r[29] = _mm_set_epi64x(0, static_cast<int64_t>(PS2_RAM_SIZE - 0x10u));
     m_debugPc.store(m_cpuContext.pc, std::memory_order_relaxed);
-    m_debugRa.store(static_cast<uint32_t>(_mm_extract_epi32(m_cpuContext.r[31], 0)), std::memory_order_relaxed);
-    m_debugSp.store(static_cast<uint32_t>(_mm_extract_epi32(m_cpuContext.r[29], 0)), std::memory_order_relaxed);
-    m_debugGp.store(static_cast<uint32_t>(_mm_extract_epi32(m_cpuContext.r[28], 0)), std::memory_order_relaxed);
+    m_debugRa.store(static_cast<uint32_t>(m_cpuContext.r[31].lo), std::memory_order_relaxed);
+    m_debugSp.store(static_cast<uint32_t>(m_cpuContext.r[29].lo), std::memory_order_relaxed);
+    m_debugGp.store(static_cast<uint32_t>(m_cpuContext.r[28].lo), std::memory_order_relaxed);
 
     RUNTIME_LOG("Starting execution at address 0x" << std::hex << m_cpuContext.pc << std::dec);
 
@@ -2333,7 +2438,7 @@ void PS2Runtime::run()
             m_eeScheduler->run();
             uint32_t pc = m_debugPc.load(std::memory_order_relaxed);
             RUNTIME_LOG("Game thread returned. PC=0x" << std::hex << pc
-                      << " RA=0x" << static_cast<uint32_t>(_mm_extract_epi32(m_cpuContext.r[31], 0)) << std::dec << std::endl);
+                      << " RA=0x" << static_cast<uint32_t>(m_cpuContext.r[31].lo) << std::dec << std::endl);
         }
         catch (const std::exception &e)
         {
@@ -0,0 +1,510 @@
+#include "runtime/ps2_spu2.h"
+#include "runtime/ps2_audio.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t kRamMask = PS2Spu2::kRamBytes - 1u;
+    constexpr uint32_t kAdpcmBlockBytes = 16u;
+    constexpr uint32_t kAdpcmSamplesPerBlock = 28u;
+    constexpr uint8_t kAdpcmFlagEnd = 0x01u;
+    constexpr uint8_t kAdpcmFlagRepeat = 0x02u;
+    constexpr uint8_t kAdpcmFlagLoopStart = 0x04u;
+    constexpr uint16_t kMaxPitch = 0x3FFFu;
+    constexpr int32_t kMaxEnvelope = 0x7FFF;
+    constexpr uint32_t kAdmaHalfBytes = 0x200u;
+
+    inline int16_t clamp16(int32_t v)
+    {
+        return static_cast<int16_t>(std::clamp(v, -32768, 32767));
+    }
+
+    // Fixed volumes are 15-bit signed values stored shifted right by one.
+    // Sweep mode is not modelled; a sweeping voice plays at full volume.
+    inline int32_t voiceVolume(uint16_t reg)
+    {
+        if ((reg & 0x8000u) != 0u)
+            return kMaxEnvelope;
+        return static_cast<int16_t>(static_cast<uint16_t>(reg << 1));
+    }
+
+    // One step of the SPU envelope generator. rate is the 7-bit ADSR rate;
+    // its top five bits pick a shift and the low two a step size.
+    inline void advanceEnvelope(int32_t &level, uint32_t &counter, uint32_t rate,
+                                bool decreasing, bool exponential)
+    {
+        const int32_t shift = static_cast<int32_t>(rate >> 2);
+        const int32_t stepRaw = static_cast<int32_t>(rate & 3u);
+        int32_t step = decreasing ? (-8 + stepRaw) : (7 - stepRaw);
+        uint32_t cycles = 1u << std::max(0, shift - 11);
+        step *= 1 << std::max(0, 11 - shift);
+        if (exponential && !decreasing && level > 0x6000)
+            cycles *= 4u;
+        if (exponential && decreasing)
+            step = (step * level) >> 15;
+
+        if (++counter < cycles)
+            return;
+        counter = 0;
+        level = std::clamp(level + step, 0, kMaxEnvelope);
+    }
+}
+
+PS2AudioRing::PS2AudioRing(size_t capacityFrames)
+{
+    size_t capacity = 1u;
+    while (capacity < capacityFrames)
+        capacity <<= 1u;
+    m_samples.assign(capacity * 2u, 0);
+    m_mask = capacity - 1u;
+}
+
+size_t PS2AudioRing::write(const int16_t *frames, size_t frameCount)
+{
+    const size_t writePos = m_writePos.load(std::memory_order_relaxed);
+    const size_t readPos = m_readPos.load(std::memory_order_acquire);
+    const size_t count = std::min(frameCount, capacity() - (writePos - readPos));
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t slot = ((writePos + i) & m_mask) * 2u;
+        m_samples[slot] = frames[i * 2u];
+        m_samples[slot + 1u] = frames[i * 2u + 1u];
+    }
+    m_writePos.store(writePos + count, std::memory_order_release);
+    return count;
+}
+
+size_t PS2AudioRing::read(int16_t *frames, size_t frameCount)
+{
+    const size_t readPos = m_readPos.load(std::memory_order_relaxed);
+    const size_t writePos = m_writePos.load(std::memory_order_acquire);
+    const size_t count = std::min(frameCount, writePos - readPos);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t slot = ((readPos + i) & m_mask) * 2u;
+        frames[i * 2u] = m_samples[slot];
+        frames[i * 2u + 1u] = m_samples[slot + 1u];
+    }
+    m_readPos.store(readPos + count, std::memory_order_release);
+    return count;
+}
+
+size_t PS2AudioRing::available() const
+{
+    return m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_acquire);
+}
+
+size_t PS2AudioRing::space() const
+{
+    return capacity() - available();
+}
+
+PS2Spu2::PS2Spu2() : m_ram(kRamBytes, 0u)
+{
+}
+
+void PS2Spu2::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::fill(m_ram.begin(), m_ram.end(), 0u);
+    m_voices = {};
+    m_inputs = {};
+}
+
+void PS2Spu2::writeRam(uint32_t spuAddr, const uint8_t *data, uint32_t size)
+{
+    if (!data || size == 0u)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size = std::min(size, kRamBytes);
+    uint32_t addr = spuAddr & kRamMask;
+    while (size != 0u)
+    {
+        const uint32_t chunk = std::min(size, kRamBytes - addr);
+        std::memcpy(m_ram.data() + addr, data, chunk);
+        data += chunk;
+        size -= chunk;
+        addr = 0u;
+    }
+}
+
+uint16_t PS2Spu2::readRam16(uint32_t spuAddr) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint32_t addr = spuAddr & kRamMask & ~1u;
+    return static_cast<uint16_t>(m_ram[addr] | (m_ram[addr + 1u] << 8));
+}
+
+void PS2Spu2::setVoiceParam(uint32_t voice, VoiceParam param, uint16_t value)
+{
+    if (voice >= kVoiceCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Voice &v = m_voices[voice];
+    switch (param)
+    {
+    case VoiceParam::VolumeLeft:
+        v.volLeft = value;
+        break;
+    case VoiceParam::VolumeRight:
+        v.volRight = value;
+        break;
+    case VoiceParam::Pitch:
+        v.pitch = std::min(value, kMaxPitch);
+        break;
+    case VoiceParam::Adsr1:
+        v.adsr1 = value;
+        break;
+    case VoiceParam::Adsr2:
+        v.adsr2 = value;
+        break;
+    case VoiceParam::Envelope:
+        v.envelope = std::min<int32_t>(value, kMaxEnvelope);
+        break;
+    }
+}
+
+uint16_t PS2Spu2::voiceParam(uint32_t voice, VoiceParam param) const
+{
+    if (voice >= kVoiceCount)
+        return 0u;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Voice &v = m_voices[voice];
+    switch (param)
+    {
+    case VoiceParam::VolumeLeft:
+        return v.volLeft;
+    case VoiceParam::VolumeRight:
+        return v.volRight;
+    case VoiceParam::Pitch:
+        return v.pitch;
+    case VoiceParam::Adsr1:
+        return v.adsr1;
+    case VoiceParam::Adsr2:
+        return v.adsr2;
+    case VoiceParam::Envelope:
+        return static_cast<uint16_t>(v.envelope);
+    }
+    return 0u;
+}
+
+void PS2Spu2::setVoiceStartAddress(uint32_t voice, uint32_t spuAddr)
+{
+    if (voice >= kVoiceCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_voices[voice].startAddr = spuAddr & kRamMask & ~(kAdpcmBlockBytes - 1u);
+}
+
+void PS2Spu2::setVoiceLoopAddress(uint32_t voice, uint32_t spuAddr)
+{
+    if (voice >= kVoiceCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Voice &v = m_voices[voice];
+    v.loopAddr = spuAddr & kRamMask & ~(kAdpcmBlockBytes - 1u);
+    v.loopAddrSet = true;
+}
+
+void PS2Spu2::keyOn(uint32_t core, uint32_t voiceMask)
+{
+    if (core >= kCoreCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t i = 0; i < kVoicesPerCore; ++i)
+    {
+        if ((voiceMask & (1u << i)) == 0u)
+            continue;
+
+        Voice &v = m_voices[core * kVoicesPerCore + i];
+        v.nextBlockAddr = v.startAddr;
+        v.endAfterBlock = false;
+        v.blockPos = kAdpcmSamplesPerBlock;
+        v.s1 = 0;
+        v.s2 = 0;
+        v.prevSample = 0;
+        v.curSample = 0;
+        v.counter = 0;
+        v.phase = EnvelopePhase::Attack;
+        v.envelope = 0;
+        v.envelopeCounter = 0;
+        v.pcm.reset();
+        v.pcmPos = 0;
+        v.sampleKey = 0;
+    }
+}
+
+void PS2Spu2::keyOff(uint32_t core, uint32_t voiceMask)
+{
+    if (core >= kCoreCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t i = 0; i < kVoicesPerCore; ++i)
+    {
+        Voice &v = m_voices[core * kVoicesPerCore + i];
+        if ((voiceMask & (1u << i)) != 0u && v.phase != EnvelopePhase::Off)
+        {
+            v.phase = EnvelopePhase::Release;
+            v.envelopeCounter = 0;
+        }
+    }
+}
+
+bool PS2Spu2::voiceActive(uint32_t voice) const
+{
+    if (voice >= kVoiceCount)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_voices[voice].phase != EnvelopePhase::Off;
+}
+
+bool PS2Spu2::keyOnSample(std::shared_ptr<const std::vector<int16_t>> pcm, uint32_t sampleRate,
+                          float pitch, float volume, uint32_t sampleKey)
+{
+    if (!pcm || pcm->empty())
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Take voices from the top of core 1 so libsd-driven voices, which games
+    // usually allocate from the bottom, are left alone.
+    for (uint32_t i = kVoiceCount; i-- > 0u;)
+    {
+        Voice &v = m_voices[i];
+        if (v.phase != EnvelopePhase::Off)
+            continue;
+
+        const double step = static_cast<double>(sampleRate) * pitch * 4096.0 / kOutputRate;
+        const uint16_t volumeReg = static_cast<uint16_t>(std::clamp(volume, 0.0f, 1.0f) * 0x3FFF);
+        v = {};
+        v.pcm = std::move(pcm);
+        v.sampleKey = sampleKey;
+        v.pitch = static_cast<uint16_t>(std::clamp(std::lround(step), 1l, static_cast<long>(kMaxPitch)));
+        v.volLeft = volumeReg;
+        v.volRight = volumeReg;
+        v.phase = EnvelopePhase::Sustain;
+        v.envelope = kMaxEnvelope;
+        return true;
+    }
+    return false;
+}
+
+bool PS2Spu2::samplePlaying(uint32_t sampleKey) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::any_of(m_voices.begin(), m_voices.end(), [sampleKey](const Voice &v)
+                       { return v.pcm && v.sampleKey == sampleKey && v.phase != EnvelopePhase::Off; });
+}
+
+void PS2Spu2::stopSamples()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Voice &v : m_voices)
+    {
+        if (v.pcm)
+            v = {};
+    }
+}
+
+void PS2Spu2::startCoreInput(uint32_t core, const uint8_t *data, uint32_t size, uint32_t offset, bool loop)
+{
+    if (core >= kCoreCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CoreInput &input = m_inputs[core];
+    input.data = data;
+    input.size = size;
+    input.offset = (offset < size) ? offset : 0u;
+    input.loop = loop;
+}
+
+void PS2Spu2::stopCoreInput(uint32_t core)
+{
+    if (core >= kCoreCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_inputs[core] = {};
+}
+
+bool PS2Spu2::coreInputOffset(uint32_t core, uint32_t &offset) const
+{
+    if (core >= kCoreCount)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const CoreInput &input = m_inputs[core];
+    if (!input.data)
+        return false;
+    offset = input.offset;
+    return true;
+}
+
+void PS2Spu2::mix(int16_t *out, size_t frameCount)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        int32_t left = 0;
+        int32_t right = 0;
+        for (Voice &v : m_voices)
+        {
+            if (v.phase == EnvelopePhase::Off)
+                continue;
+
+            const int32_t sample = (nextVoiceSample(v) * v.envelope) >> 15;
+            tickEnvelope(v);
+            left += (sample * voiceVolume(v.volLeft)) >> 15;
+            right += (sample * voiceVolume(v.volRight)) >> 15;
+        }
+        for (CoreInput &input : m_inputs)
+        {
+            if (input.data)
+                readCoreInput(input, left, right);
+        }
+        out[frame * 2u] = clamp16(left);
+        out[frame * 2u + 1u] = clamp16(right);
+    }
+}
+
+int16_t PS2Spu2::nextVoiceSample(Voice &voice)
+{
+    if (voice.pcm)
+    {
+        const std::vector<int16_t> &pcm = *voice.pcm;
+        if (voice.pcmPos >= pcm.size())
+        {
+            voice.phase = EnvelopePhase::Off;
+            return 0;
+        }
+        const int32_t cur = pcm[voice.pcmPos];
+        const int32_t next = (voice.pcmPos + 1u < pcm.size()) ? pcm[voice.pcmPos + 1u] : 0;
+        const int32_t out = cur + (((next - cur) * static_cast<int32_t>(voice.counter)) >> 12);
+        voice.counter += voice.pitch;
+        voice.pcmPos += voice.counter >> 12;
+        voice.counter &= 0xFFFu;
+        return static_cast<int16_t>(out);
+    }
+
+    const int32_t prev = voice.prevSample;
+    const int32_t out = prev + (((voice.curSample - prev) * static_cast<int32_t>(voice.counter)) >> 12);
+    voice.counter += voice.pitch;
+    while (voice.counter >= 0x1000u && voice.phase != EnvelopePhase::Off)
+    {
+        voice.counter -= 0x1000u;
+        voice.prevSample = voice.curSample;
+        if (voice.blockPos >= kAdpcmSamplesPerBlock)
+        {
+            // A block with END set and REPEAT clear silences the voice once
+            // its samples have played.
+            if (voice.endAfterBlock)
+            {
+                voice.phase = EnvelopePhase::Off;
+                voice.envelope = 0;
+                break;
+            }
+            decodeNextBlock(voice);
+        }
+        voice.curSample = voice.block[voice.blockPos++];
+    }
+    return static_cast<int16_t>(out);
+}
+
+void PS2Spu2::decodeNextBlock(Voice &voice)
+{
+    const uint32_t addr = voice.nextBlockAddr & kRamMask & ~(kAdpcmBlockBytes - 1u);
+    const uint8_t *block = m_ram.data() + addr;
+    const uint8_t flags = block[1];
+    if ((flags & kAdpcmFlagLoopStart) != 0u && !voice.loopAddrSet)
+        voice.loopAddr = addr;
+
+    ps2_vag::decodeBlock(block, voice.s1, voice.s2, voice.block.data());
+    voice.blockPos = 0;
+
+    if ((flags & kAdpcmFlagEnd) != 0u)
+    {
+        voice.nextBlockAddr = voice.loopAddr;
+        voice.endAfterBlock = (flags & kAdpcmFlagRepeat) == 0u;
+    }
+    else
+    {
+        voice.nextBlockAddr = (addr + kAdpcmBlockBytes) & kRamMask;
+    }
+}
+
+void PS2Spu2::tickEnvelope(Voice &voice)
+{
+    switch (voice.phase)
+    {
+    case EnvelopePhase::Attack:
+        advanceEnvelope(voice.envelope, voice.envelopeCounter, (voice.adsr1 >> 8) & 0x7Fu,
+                        false, (voice.adsr1 & 0x8000u) != 0u);
+        if (voice.envelope >= kMaxEnvelope)
+        {
+            voice.phase = EnvelopePhase::Decay;
+            voice.envelopeCounter = 0;
+        }
+        break;
+    case EnvelopePhase::Decay:
+    {
+        const int32_t sustainLevel = std::min<int32_t>(((voice.adsr1 & 0xFu) + 1) * 0x800, kMaxEnvelope);
+        if (voice.envelope <= sustainLevel)
+        {
+            voice.phase = EnvelopePhase::Sustain;
+            voice.envelopeCounter = 0;
+            break;
+        }
+        advanceEnvelope(voice.envelope, voice.envelopeCounter, ((voice.adsr1 >> 4) & 0xFu) << 2,
+                        true, true);
+        break;
+    }
+    case EnvelopePhase::Sustain:
+        advanceEnvelope(voice.envelope, voice.envelopeCounter, (voice.adsr2 >> 6) & 0x7Fu,
+                        (voice.adsr2 & 0x4000u) != 0u, (voice.adsr2 & 0x8000u) != 0u);
+        break;
+    case EnvelopePhase::Release:
+        advanceEnvelope(voice.envelope, voice.envelopeCounter, (voice.adsr2 & 0x1Fu) << 2,
+                        true, (voice.adsr2 & 0x20u) != 0u);
+        if (voice.envelope == 0)
+            voice.phase = EnvelopePhase::Off;
+        break;
+    case EnvelopePhase::Off:
+        break;
+    }
+}
+
+void PS2Spu2::readCoreInput(CoreInput &input, int32_t &left, int32_t &right)
+{
+    const uint32_t chunk = input.offset & ~(2u * kAdmaHalfBytes - 1u);
+    const uint32_t index = input.offset & (kAdmaHalfBytes - 1u);
+    if (chunk + kAdmaHalfBytes + index + sizeof(int16_t) <= input.size)
+    {
+        int16_t l = 0;
+        int16_t r = 0;
+        std::memcpy(&l, input.data + chunk + index, sizeof(l));
+        std::memcpy(&r, input.data + chunk + kAdmaHalfBytes + index, sizeof(r));
+        left += l;
+        right += r;
+    }
+
+    input.offset += sizeof(int16_t);
+    if ((input.offset & (2u * kAdmaHalfBytes - 1u)) >= kAdmaHalfBytes)
+        input.offset += kAdmaHalfBytes;
+    if (input.offset >= input.size)
+    {
+        if (input.loop)
+            input.offset = 0u;
+        else
+            input = {};
+    }
+}
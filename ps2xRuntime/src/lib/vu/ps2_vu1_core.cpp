@@ -2,6 +2,7 @@
 #include "runtime/gs/ps2_gif_arbiter.h"
 #include "runtime/gs/gs_frontend.h"
 #include "runtime/ps2_memory.h"
+#include "runtime/ps2_vu_float.h"
 #include "ps2_vu1_detail.h"
 
 #include <algorithm>
@@ -14,14 +15,6 @@
 #include <limits>
 #include <ps2_log.h>
 
-namespace
-{
-    constexpr uint8_t laneForComponent(uint32_t component)
-    {
-        return static_cast<uint8_t>(1u << (3u - component));
-    }
-}
-
 void VU1Interpreter::addVfRead(InstructionUsage &usage, uint8_t reg, uint8_t lanes)
 {
     if (lanes == 0u)
@@ -73,7 +66,7 @@ void VU1Interpreter::resetScheduler()
     m_vfWritePipeline = {};
     m_viWritePipeline = {};
     m_accWritePipeline = {};
-    m_xgkick = {};
+    resetXgkick();
     m_vfReady = {};
     m_viReady = {};
     m_accReady = {};
@@ -101,54 +94,14 @@ void VU1Interpreter::reset()
     resetScheduler();
 }
 
-float VU1Interpreter::broadcast(const float *vf, uint8_t bc)
-{
-    return normalizeOperand(vf[bc & 3u]);
-}
-
 float VU1Interpreter::normalizeOperand(float value) const
 {
-    uint32_t bits = 0;
-    std::memcpy(&bits, &value, sizeof(bits));
-    const uint32_t exponent = (bits >> 23) & 0xFFu;
-    if (exponent == 0u)
-    {
-        bits &= 0x80000000u;
-    }
-    else if (exponent == 0xFFu)
-    {
-        bits = (bits & 0x80000000u) | 0x7F7FFFFFu;
-    }
-    std::memcpy(&value, &bits, sizeof(value));
-    return value;
+    return Ps2VuNormalizeOperand(value);
 }
 
 float VU1Interpreter::normalizeResult(float value, uint32_t &laneFlags) const
 {
-    uint32_t bits = 0;
-    std::memcpy(&bits, &value, sizeof(bits));
-    const uint32_t sign = bits & 0x80000000u;
-    const uint32_t magnitude = bits & 0x7FFFFFFFu;
-    const uint32_t exponent = (bits >> 23) & 0xFFu;
-
-    laneFlags = sign != 0u ? 0x2u : 0u;
-    if (magnitude == 0u)
-    {
-        laneFlags |= 0x1u;
-    }
-    else if (exponent == 0u)
-    {
-        laneFlags |= 0x5u;
-        bits = sign;
-    }
-    else if (exponent == 0xFFu)
-    {
-        laneFlags |= 0x8u;
-        bits = sign | 0x7F7FFFFFu;
-    }
-
-    std::memcpy(&value, &bits, sizeof(value));
-    return value;
+    return Ps2VuNormalizeResult(value, laneFlags);
 }
 
 uint32_t VU1Interpreter::microAddressMask() const
@@ -189,216 +142,6 @@ void VU1Interpreter::applyDest(float *dst, const float *result, uint8_t dest)
         dst[3] = result[3];
 }
 
-void VU1Interpreter::applyDestAcc(const float *result, uint8_t dest)
-{
-    applyDest(m_state.acc, result, dest);
-}
-
-void VU1Interpreter::normalizeFmacResult(float *result, uint8_t dest,
-                                         uint8_t laneFlags[4])
-{
-    for (uint32_t component = 0; component < 4u; ++component)
-    {
-        laneFlags[component] = 0u;
-        if ((dest & laneForComponent(component)) == 0u)
-            continue;
-
-        long double exactResult = 0.0L;
-        if (calculateFmacExactResult(component, exactResult))
-        {
-            laneFlags[component] = normalizeFmacExactResult(result[component], exactResult);
-            continue;
-        }
-
-        uint32_t flags = 0u;
-        result[component] = normalizeResult(result[component], flags);
-        laneFlags[component] = static_cast<uint8_t>(flags);
-    }
-}
-
-bool VU1Interpreter::calculateFmacExactResult(uint32_t component,
-                                               long double &result) const
-{
-    const uint32_t upper = m_currentUpperInstruction;
-    const uint8_t op = static_cast<uint8_t>(upper & 0x3Fu);
-    const uint8_t special = op >= 0x3Cu
-                                ? static_cast<uint8_t>((upper & 3u) | ((upper >> 4) & 0x7Cu))
-                                : 0xFFu;
-    const uint8_t fs = FS(upper);
-    const uint8_t ft = FT(upper);
-
-    const auto operand = [this](float value)
-    {
-        return static_cast<long double>(normalizeOperand(value));
-    };
-    const auto vs = [&](uint32_t lane)
-    {
-        return operand(m_state.vf[fs][lane]);
-    };
-    const auto vt = [&](uint32_t lane)
-    {
-        return operand(m_state.vf[ft][lane]);
-    };
-    const auto acc = [&](uint32_t lane)
-    {
-        return operand(m_state.acc[lane]);
-    };
-
-    const long double q = operand(m_state.q);
-    const long double i = operand(m_state.i);
-
-    if (op < 0x3Cu)
-    {
-        if (op <= 0x03u)
-            result = vs(component) + vt(op & 3u);
-        else if (op <= 0x07u)
-            result = vs(component) - vt(op & 3u);
-        else if (op <= 0x0Bu)
-            result = acc(component) + vs(component) * vt(op & 3u);
-        else if (op <= 0x0Fu)
-            result = acc(component) - vs(component) * vt(op & 3u);
-        else if (op >= 0x18u && op <= 0x1Bu)
-            result = vs(component) * vt(op & 3u);
-        else
-        {
-            switch (op)
-            {
-            case 0x1Cu:
-                result = vs(component) * q;
-                break;
-            case 0x1Eu:
-                result = vs(component) * i;
-                break;
-            case 0x20u:
-                result = vs(component) + q;
-                break;
-            case 0x21u:
-                result = acc(component) + vs(component) * q;
-                break;
-            case 0x22u:
-                result = vs(component) + i;
-                break;
-            case 0x23u:
-                result = acc(component) + vs(component) * i;
-                break;
-            case 0x24u:
-                result = vs(component) - q;
-                break;
-            case 0x25u:
-                result = acc(component) - vs(component) * q;
-                break;
-            case 0x26u:
-                result = vs(component) - i;
-                break;
-            case 0x27u:
-                result = acc(component) - vs(component) * i;
-                break;
-            case 0x28u:
-                result = vs(component) + vt(component);
-                break;
-            case 0x29u:
-                result = acc(component) + vs(component) * vt(component);
-                break;
-            case 0x2Au:
-                result = vs(component) * vt(component);
-                break;
-            case 0x2Cu:
-                result = vs(component) - vt(component);
-                break;
-            case 0x2Du:
-                result = acc(component) - vs(component) * vt(component);
-                break;
-            case 0x2Eu:
-            {
-                static constexpr uint8_t left[4] = {1u, 2u, 0u, 3u};
-                static constexpr uint8_t right[4] = {2u, 0u, 1u, 3u};
-                result = component == 3u
-                             ? 0.0L
-                             : acc(component) - vs(left[component]) * vt(right[component]);
-                break;
-            }
-            default:
-                return false;
-            }
-        }
-        return true;
-    }
-
-    if (special <= 0x03u)
-        result = vs(component) + vt(special & 3u);
-    else if (special <= 0x07u)
-        result = vs(component) - vt(special & 3u);
-    else if (special <= 0x0Bu)
-        result = acc(component) + vs(component) * vt(special & 3u);
-    else if (special <= 0x0Fu)
-        result = acc(component) - vs(component) * vt(special & 3u);
-    else if (special >= 0x18u && special <= 0x1Bu)
-        result = vs(component) * vt(special & 3u);
-    else
-    {
-        switch (special)
-        {
-        case 0x1Cu:
-            result = vs(component) * q;
-            break;
-        case 0x1Eu:
-            result = vs(component) * i;
-            break;
-        case 0x20u:
-            result = vs(component) + q;
-            break;
-        case 0x21u:
-            result = acc(component) + vs(component) * q;
-            break;
-        case 0x22u:
-            result = vs(component) + i;
-            break;
-        case 0x23u:
-            result = acc(component) + vs(component) * i;
-            break;
-        case 0x24u:
-            result = vs(component) - q;
-            break;
-        case 0x25u:
-            result = acc(component) - vs(component) * q;
-            break;
-        case 0x26u:
-            result = vs(component) - i;
-            break;
-        case 0x27u:
-            result = acc(component) - vs(component) * i;
-            break;
-        case 0x28u:
-            result = vs(component) + vt(component);
-            break;
-        case 0x29u:
-            result = acc(component) + vs(component) * vt(component);
-            break;
-        case 0x2Au:
-            result = vs(component) * vt(component);
-            break;
-        case 0x2Cu:
-            result = vs(component) - vt(component);
-            break;
-        case 0x2Du:
-            result = acc(component) - vs(component) * vt(component);
-            break;
-        case 0x2Eu:
-        {
-            static constexpr uint8_t left[4] = {1u, 2u, 0u, 3u};
-            static constexpr uint8_t right[4] = {2u, 0u, 1u, 3u};
-            result = component == 3u
-                         ? 0.0L
-                         : vs(left[component]) * vt(right[component]);
-            break;
-        }
-        default:
-            return false;
-        }
-    }
-    return true;
-}
-
 uint8_t VU1Interpreter::normalizeFmacExactResult(float &value,
                                                   long double exactResult) const
 {
@@ -429,91 +172,8 @@ uint8_t VU1Interpreter::normalizeFmacExactResult(float &value,
     return flags;
 }
 
-uint32_t VU1Interpreter::calculateFmacProductSticky(uint8_t dest) const
-{
-    uint32_t extraSticky = 0u;
-    const uint32_t upper = m_currentUpperInstruction;
-    const uint8_t op = static_cast<uint8_t>(upper & 0x3Fu);
-    const uint8_t special = op >= 0x3Cu ? static_cast<uint8_t>((upper & 3u) | ((upper >> 4) & 0x7Cu)) : 0xFFu;
-    const bool productSum =
-        (op >= 0x08u && op <= 0x0Fu) ||
-        op == 0x21u || op == 0x23u || op == 0x25u || op == 0x27u ||
-        op == 0x29u || op == 0x2Du || op == 0x2Eu ||
-        (special >= 0x08u && special <= 0x0Fu) ||
-        special == 0x21u || special == 0x23u || special == 0x25u ||
-        special == 0x27u || special == 0x29u || special == 0x2Du;
-    if (!productSum)
-        return 0u;
-
-    const uint8_t fs = FS(upper);
-    const uint8_t ft = FT(upper);
-    for (uint32_t component = 0; component < 4u; ++component)
-    {
-        if ((dest & laneForComponent(component)) == 0u)
-            continue;
-        static constexpr uint8_t crossLeft[4] = {1u, 2u, 0u, 3u};
-        static constexpr uint8_t crossRight[4] = {2u, 0u, 1u, 3u};
-        const uint8_t leftComponent = op == 0x2Eu ? crossLeft[component] : static_cast<uint8_t>(component);
-        const float left = normalizeOperand(m_state.vf[fs][leftComponent]);
-        float right = 0.0f;
-        if ((op >= 0x08u && op <= 0x0Fu) || (special >= 0x08u && special <= 0x0Fu))
-        {
-            right = normalizeOperand(m_state.vf[ft][(op >= 0x08u && op <= 0x0Fu ? op : special) & 3u]);
-        }
-        else if (op == 0x21u || op == 0x25u || special == 0x21u || special == 0x25u)
-        {
-            right = normalizeOperand(m_state.q);
-        }
-        else if (op == 0x23u || op == 0x27u || special == 0x23u || special == 0x27u)
-        {
-            right = normalizeOperand(m_state.i);
-        }
-        else if (op == 0x2Eu)
-        {
-            right = normalizeOperand(m_state.vf[ft][crossRight[component]]);
-        }
-        else
-        {
-            right = normalizeOperand(m_state.vf[ft][component]);
-        }
-
-        float product = left * right;
-        const long double exactProduct = static_cast<long double>(left) * static_cast<long double>(right);
-        const uint8_t productFlags = normalizeFmacExactResult(product, exactProduct);
-        // Product-sum instructions report Z/S/U/O from the add/subtract result
-        // as current flags, while every product condition accumulates into the
-        // corresponding sticky flag.
-        extraSticky |= productFlags & 0xFu;
-    }
-    return extraSticky;
-}
-
-void VU1Interpreter::updateFmacFlags(const uint8_t laneFlags[4], uint8_t dest,
-                                     uint32_t extraSticky)
+void VU1Interpreter::queueFmacFlags(uint32_t mac, uint32_t status, uint32_t extraSticky)
 {
-    if (dest == 0u)
-        return;
-
-    uint32_t mac = 0u;
-    uint32_t status = 0u;
-    for (uint32_t component = 0; component < 4u; ++component)
-    {
-        const uint8_t lane = laneForComponent(component);
-        if ((dest & lane) == 0u)
-            continue;
-
-        const uint32_t flags = laneFlags[component];
-        if ((flags & 0x1u) != 0u)
-            mac |= lane;
-        if ((flags & 0x2u) != 0u)
-            mac |= static_cast<uint32_t>(lane) << 4;
-        if ((flags & 0x4u) != 0u)
-            mac |= static_cast<uint32_t>(lane) << 8;
-        if ((flags & 0x8u) != 0u)
-            mac |= static_cast<uint32_t>(lane) << 12;
-        status |= flags;
-    }
-
     FlagPipelineEntry *entry = nullptr;
     for (FlagPipelineEntry &candidate : m_flagPipeline)
     {
@@ -540,22 +200,6 @@ void VU1Interpreter::updateFmacFlags(const uint8_t laneFlags[4], uint8_t dest,
     entry->writesStatus = true;
 }
 
-void VU1Interpreter::applyFmacDest(float *dst, float *result, uint8_t dest)
-{
-    uint8_t laneFlags[4]{};
-    normalizeFmacResult(result, dest, laneFlags);
-    updateFmacFlags(laneFlags, dest, calculateFmacProductSticky(dest));
-    applyDest(dst, result, dest);
-}
-
-void VU1Interpreter::applyFmacDestAcc(float *result, uint8_t dest)
-{
-    uint8_t laneFlags[4]{};
-    normalizeFmacResult(result, dest, laneFlags);
-    updateFmacFlags(laneFlags, dest, calculateFmacProductSticky(dest));
-    applyDestAcc(result, dest);
-}
-
 void VU1Interpreter::queueFsset(uint16_t immediate)
 {
     for (FlagPipelineEntry &entry : m_flagPipeline)
@@ -742,7 +386,7 @@ void VU1Interpreter::queueAccWrite(uint8_t laneMask, const float value[4], uint3
     reportReservedInstruction(true, 0xFFFFFFF5u);
 }
 
-void VU1Interpreter::commitReadyPipelines()
+void VU1Interpreter::commitReadyFlags()
 {
     for (FlagPipelineEntry &entry : m_flagPipeline)
     {
@@ -764,24 +408,10 @@ void VU1Interpreter::commitReadyPipelines()
             m_state.clip = entry.clip;
         entry = {};
     }
+}
 
-    if (m_fdiv.valid && m_fdiv.readyCycle <= m_cycle)
-    {
-        m_state.q = m_fdiv.value;
-        const uint32_t currentDi = m_fdiv.statusDi & 0x30u;
-        m_state.status = (m_state.status & 0xFCFu) | currentDi | (currentDi << 6);
-        m_fdiv = {};
-    }
-
-    for (ScalarPipelineEntry &entry : m_efu)
-    {
-        if (entry.valid && entry.readyCycle <= m_cycle)
-        {
-            m_state.p = entry.value;
-            entry = {};
-        }
-    }
-
+void VU1Interpreter::commitReadyStores()
+{
     for (PendingStore &store : m_storePipeline)
     {
         if (!store.valid || store.readyCycle > m_cycle)
@@ -799,10 +429,13 @@ void VU1Interpreter::commitReadyPipelines()
         }
         store = {};
     }
+}
 
+void VU1Interpreter::commitRegisterWrites(uint64_t throughCycle)
+{
     for (PendingVfWrite &write : m_vfWritePipeline)
     {
-        if (!write.valid || write.readyCycle > m_cycle)
+        if (!write.valid || write.readyCycle > throughCycle)
             continue;
         for (uint32_t component = 0; component < 4u; ++component)
         {
@@ -817,7 +450,7 @@ void VU1Interpreter::commitReadyPipelines()
 
     for (PendingViWrite &write : m_viWritePipeline)
     {
-        if (!write.valid || write.readyCycle > m_cycle)
+        if (!write.valid || write.readyCycle > throughCycle)
             continue;
         if (m_viLatestWrite[write.reg] == write.sequence)
             m_state.vi[write.reg] = static_cast<int16_t>(write.value);
@@ -826,7 +459,7 @@ void VU1Interpreter::commitReadyPipelines()
 
     for (PendingAccWrite &write : m_accWritePipeline)
     {
-        if (!write.valid || write.readyCycle > m_cycle)
+        if (!write.valid || write.readyCycle > throughCycle)
             continue;
         for (uint32_t component = 0; component < 4u; ++component)
         {
@@ -840,6 +473,31 @@ void VU1Interpreter::commitReadyPipelines()
     }
 }
 
+void VU1Interpreter::commitReadyPipelines()
+{
+    commitReadyFlags();
+
+    if (m_fdiv.valid && m_fdiv.readyCycle <= m_cycle)
+    {
+        m_state.q = m_fdiv.value;
+        const uint32_t currentDi = m_fdiv.statusDi & 0x30u;
+        m_state.status = (m_state.status & 0xFCFu) | currentDi | (currentDi << 6);
+        m_fdiv = {};
+    }
+
+    for (ScalarPipelineEntry &entry : m_efu)
+    {
+        if (entry.valid && entry.readyCycle <= m_cycle)
+        {
+            m_state.p = entry.value;
+            entry = {};
+        }
+    }
+
+    commitReadyStores();
+    commitRegisterWrites(m_cycle);
+}
+
 void VU1Interpreter::progressXgkick()
 {
     if (!m_xgkick.active || !m_activeVuData || m_activeVuDataSize == 0u)
@@ -926,13 +584,27 @@ void VU1Interpreter::finishXgkick()
     m_xgkick.active = false;
 }
 
+// Only the bookkeeping is cleared: packet bytes are always copied in before
+// they are read, and zeroing the 64 KiB buffer dominated short VU calls.
+void VU1Interpreter::resetXgkick()
+{
+    m_xgkick.sourceAddress = 0;
+    m_xgkick.totalBytes = 0;
+    m_xgkick.copiedBytes = 0;
+    m_xgkick.currentTagEnd = 0;
+    m_xgkick.cycleCredit = 0;
+    m_xgkick.issueCycle = 0;
+    m_xgkick.active = false;
+    m_xgkick.currentTagEop = false;
+}
+
 void VU1Interpreter::startXgkick(uint32_t qwordAddress)
 {
     if (m_unit != Unit::VU1 || !m_activeVuData || m_activeVuDataSize < 16u)
         return;
 
     const uint32_t sourceAddress = (qwordAddress * 16u) % m_activeVuDataSize;
-    m_xgkick = {};
+    resetXgkick();
     m_xgkick.active = true;
     m_xgkick.sourceAddress = sourceAddress;
     m_xgkick.cycleCredit = 1u; // XGKICK's issue cycle counts toward PATH1.
@@ -1517,9 +1189,18 @@ VU1Interpreter::DecodedInstructionPair VU1Interpreter::decodeInstructionPair(con
     decoded.mBit = (decoded.upper & 0x20000000u) != 0u;
     decoded.dBit = (decoded.upper & 0x10000000u) != 0u;
     decoded.tBit = (decoded.upper & 0x08000000u) != 0u;
+    decoded.upperHandler = selectUpperHandler(decoded.upper);
+    decoded.dest = DEST(decoded.upper);
+    decoded.fs = FS(decoded.upper);
+    decoded.ft = FT(decoded.upper);
+    decoded.fd = FD(decoded.upper);
+    decoded.bc = BC(decoded.upper);
     decoded.upperUsage = decodeUpperUsage(decoded.upper);
     if (!decoded.iBit)
+    {
         decoded.lowerUsage = decodeLowerUsage(decoded.lower);
+        decoded.lowerNop = decoded.lower == 0x00000000u || decoded.lower == 0x8000033Cu;
+    }
 
     const uint8_t upperWriteReg = decoded.upperUsage.vfWrite.reg;
     if (upperWriteReg != 0u && (vfReadLanes(decoded.lowerUsage, upperWriteReg) != 0u || decoded.lowerUsage.vfWrite.reg == upperWriteReg))
@@ -1542,20 +1223,28 @@ void VU1Interpreter::rebuildDecodedCodeCache(const uint8_t *vuCode, uint32_t cod
     m_cachedMemory = memory;
     m_cachedCodeSize = codeSize;
     m_cachedCodeGeneration = generation;
+    m_cachedPairCount = pairCount;
     m_decodedCodeCacheValid = true;
+    resetFastBlocks();
 }
 
-VU1Interpreter::DecodedInstructionPair VU1Interpreter::getDecodedInstructionPairForPc(
+const VU1Interpreter::DecodedInstructionPair &VU1Interpreter::getDecodedInstructionPairForPc(
     const uint8_t *vuCode, uint32_t codeSize, PS2Memory *memory, uint32_t pc)
 {
+    const auto decodeUncached = [&]() -> const DecodedInstructionPair &
+    {
+        m_uncachedPair = decodeInstructionPair(vuCode, pc);
+        return m_uncachedPair;
+    };
+
     if ((pc & 7u) != 0u)
-        return decodeInstructionPair(vuCode, pc);
+        return decodeUncached();
 
     const bool trackedVu1Code = memory != nullptr &&
                                 ((m_unit == Unit::VU1 && vuCode == memory->getVU1Code()) ||
                                  (m_unit == Unit::VU0 && vuCode == memory->getVU0Code()));
     if (!trackedVu1Code)
-        return decodeInstructionPair(vuCode, pc);
+        return decodeUncached();
 
     const uint64_t generation = m_unit == Unit::VU1 ? memory->getVU1CodeGeneration() : memory->getVU0CodeGeneration();
     if (!m_decodedCodeCacheValid ||
@@ -1568,7 +1257,7 @@ VU1Interpreter::DecodedInstructionPair VU1Interpreter::getDecodedInstructionPair
     }
     const uint32_t pairIndex = pc / 8u;
     if (pairIndex >= kMaxDecodedPairs)
-        return decodeInstructionPair(vuCode, pc);
+        return decodeUncached();
     return m_decodedCodeCache[pairIndex];
 }
 
@@ -1620,6 +1309,135 @@ void VU1Interpreter::resume(uint8_t *vuCode, uint32_t codeSize,
     run(vuCode, codeSize, vuData, dataSize, gs, memory, maxCycles);
 }
 
+void VU1Interpreter::executePair(const DecodedInstructionPair &decoded,
+                                 uint8_t *vuData, uint32_t dataSize,
+                                 GS &gs, PS2Memory *memory)
+{
+    if (decoded.iBit)
+    {
+        (this->*decoded.upperHandler)(decoded);
+        float immediate = 0.0f;
+        std::memcpy(&immediate, &decoded.lower, sizeof(immediate));
+        m_state.i = normalizeOperand(immediate);
+    }
+    else if (decoded.upperVfShadowReg != 0u)
+    {
+        float oldVf[4]{};
+        float upperVf[4]{};
+        std::memcpy(oldVf,
+                    m_state.vf[decoded.upperVfShadowReg],
+                    sizeof(oldVf));
+        (this->*decoded.upperHandler)(decoded);
+        std::memcpy(upperVf,
+                    m_state.vf[decoded.upperVfShadowReg],
+                    sizeof(upperVf));
+        std::memcpy(m_state.vf[decoded.upperVfShadowReg],
+                    oldVf,
+                    sizeof(oldVf));
+        if (!decoded.lowerNop)
+            execLower(decoded.lower, vuData, dataSize, gs, memory);
+        std::memcpy(m_state.vf[decoded.upperVfShadowReg],
+                    upperVf,
+                    sizeof(upperVf));
+    }
+    else
+    {
+        (this->*decoded.upperHandler)(decoded);
+        if (!decoded.lowerNop)
+            execLower(decoded.lower, vuData, dataSize, gs, memory);
+    }
+}
+
+// Executes a pair and moves its register results into the write pipelines,
+// leaving the old values visible until each write's latency has elapsed.
+void VU1Interpreter::issuePair(const DecodedInstructionPair &decoded,
+                               uint8_t *vuData, uint32_t dataSize,
+                               GS &gs, PS2Memory *memory)
+{
+    uint8_t writtenVi = 0u;
+    int32_t oldVi = 0;
+    for (uint32_t reg = 1; reg < 16u; ++reg)
+    {
+        if ((decoded.lowerUsage.viWrite & (1u << reg)) != 0u)
+        {
+            writtenVi = static_cast<uint8_t>(reg);
+            oldVi = m_state.vi[reg];
+            break;
+        }
+    }
+
+    const VfAccess upperWrite = decoded.upperUsage.vfWrite;
+    const VfAccess lowerWrite = decoded.lowerUsage.vfWrite;
+    const bool hasUpperWrite = upperWrite.reg != 0u;
+    const bool hasLowerWrite = lowerWrite.reg != 0u && decoded.suppressedLowerVf != lowerWrite.reg;
+    const bool hasDistinctLowerWrite = hasLowerWrite && (!hasUpperWrite || lowerWrite.reg != upperWrite.reg);
+    float oldUpperVf[4]{};
+    float newUpperVf[4]{};
+    float oldLowerVf[4]{};
+    float newLowerVf[4]{};
+    float oldAcc[4]{};
+    float newAcc[4]{};
+    if (hasUpperWrite)
+        std::memcpy(oldUpperVf, m_state.vf[upperWrite.reg], sizeof(oldUpperVf));
+    if (hasDistinctLowerWrite)
+        std::memcpy(oldLowerVf, m_state.vf[lowerWrite.reg], sizeof(oldLowerVf));
+    if (decoded.upperUsage.accWrite != 0u)
+        std::memcpy(oldAcc, m_state.acc, sizeof(oldAcc));
+
+    executePair(decoded, vuData, dataSize, gs, memory);
+
+    m_viBranchBackupValid = false;
+
+    if (hasUpperWrite)
+    {
+        std::memcpy(newUpperVf, m_state.vf[upperWrite.reg], sizeof(newUpperVf));
+        std::memcpy(m_state.vf[upperWrite.reg], oldUpperVf, sizeof(oldUpperVf));
+        const uint32_t latency =
+            decoded.upperUsage.vfLatency != 0u
+                ? decoded.upperUsage.vfLatency
+                : decoded.upperUsage.latency;
+        queueVfWrite(upperWrite.reg, upperWrite.lanes, newUpperVf, latency);
+    }
+    if (hasDistinctLowerWrite)
+    {
+        std::memcpy(newLowerVf, m_state.vf[lowerWrite.reg], sizeof(newLowerVf));
+        std::memcpy(m_state.vf[lowerWrite.reg], oldLowerVf, sizeof(oldLowerVf));
+        const uint32_t latency = decoded.lowerUsage.vfLatency != 0u
+                                     ? decoded.lowerUsage.vfLatency
+                                     : decoded.lowerUsage.latency;
+        queueVfWrite(lowerWrite.reg, lowerWrite.lanes, newLowerVf, latency);
+    }
+    if (decoded.upperUsage.accWrite != 0u)
+    {
+        std::memcpy(newAcc, m_state.acc, sizeof(newAcc));
+        std::memcpy(m_state.acc, oldAcc, sizeof(oldAcc));
+        // ACC is forwarded to the next upper instruction. Its arithmetic
+        // flags still use the normal four-cycle FMAC timeline.
+        queueAccWrite(decoded.upperUsage.accWrite, newAcc,
+                      kAccForwardLatency);
+    }
+    if (writtenVi != 0u)
+    {
+        const int32_t newVi = m_state.vi[writtenVi];
+        m_state.vi[writtenVi] = oldVi;
+        const uint32_t latency =
+            decoded.lowerUsage.viLatency != 0u
+                ? decoded.lowerUsage.viLatency
+                : decoded.lowerUsage.latency;
+        queueViWrite(writtenVi, newVi, latency);
+    }
+
+    markPairWrites(decoded);
+    if (writtenVi != 0u && decoded.lowerUsage.delaysNextBranchRead)
+        recordViWriteForBranch(writtenVi, oldVi);
+
+    m_state.vf[0][0] = 0.0f;
+    m_state.vf[0][1] = 0.0f;
+    m_state.vf[0][2] = 0.0f;
+    m_state.vf[0][3] = 1.0f;
+    m_state.vi[0] = 0;
+}
+
 void VU1Interpreter::run(uint8_t *vuCode, uint32_t codeSize,
                          uint8_t *vuData, uint32_t dataSize,
                          GS &gs, PS2Memory *memory, uint32_t maxCycles)
@@ -1639,13 +1457,16 @@ void VU1Interpreter::run(uint8_t *vuCode, uint32_t codeSize,
         if (m_state.pc + 8u > codeSize)
             break;
 
-        const DecodedInstructionPair decoded = getDecodedInstructionPairForPc(vuCode, codeSize, memory, m_state.pc);
+        const DecodedInstructionPair &decoded = getDecodedInstructionPairForPc(vuCode, codeSize, memory, m_state.pc);
         if (decoded.upperUsage.reserved || decoded.lowerUsage.reserved)
         {
             reportReservedInstruction(decoded.upperUsage.reserved, decoded.upperUsage.reserved ? decoded.upper : decoded.lower);
             break;
         }
 
+        if (tryRunFastBlock(decoded, budgetEnd, vuData, dataSize, gs, memory))
+            continue;
+
         uint64_t readyCycle = calculatePairReadyCycle(decoded);
         while (readyCycle > m_cycle)
         {
@@ -1660,118 +1481,7 @@ void VU1Interpreter::run(uint8_t *vuCode, uint32_t codeSize,
         if (m_cycle >= budgetEnd)
             break;
 
-        uint8_t writtenVi = 0u;
-        int32_t oldVi = 0;
-        for (uint32_t reg = 1; reg < 16u; ++reg)
-        {
-            if ((decoded.lowerUsage.viWrite & (1u << reg)) != 0u)
-            {
-                writtenVi = static_cast<uint8_t>(reg);
-                oldVi = m_state.vi[reg];
-                break;
-            }
-        }
-
-        const VfAccess upperWrite = decoded.upperUsage.vfWrite;
-        const VfAccess lowerWrite = decoded.lowerUsage.vfWrite;
-        const bool hasUpperWrite = upperWrite.reg != 0u;
-        const bool hasLowerWrite = lowerWrite.reg != 0u && decoded.suppressedLowerVf != lowerWrite.reg;
-        const bool hasDistinctLowerWrite = hasLowerWrite && (!hasUpperWrite || lowerWrite.reg != upperWrite.reg);
-        float oldUpperVf[4]{};
-        float newUpperVf[4]{};
-        float oldLowerVf[4]{};
-        float newLowerVf[4]{};
-        float oldAcc[4]{};
-        float newAcc[4]{};
-        if (hasUpperWrite)
-            std::memcpy(oldUpperVf, m_state.vf[upperWrite.reg], sizeof(oldUpperVf));
-        if (hasDistinctLowerWrite)
-            std::memcpy(oldLowerVf, m_state.vf[lowerWrite.reg], sizeof(oldLowerVf));
-        if (decoded.upperUsage.accWrite != 0u)
-            std::memcpy(oldAcc, m_state.acc, sizeof(oldAcc));
-
-        if (decoded.iBit)
-        {
-            execUpper(decoded.upper);
-            float immediate = 0.0f;
-            std::memcpy(&immediate, &decoded.lower, sizeof(immediate));
-            m_state.i = normalizeOperand(immediate);
-        }
-        else if (decoded.upperVfShadowReg != 0u)
-        {
-            float oldVf[4]{};
-            float upperVf[4]{};
-            std::memcpy(oldVf,
-                        m_state.vf[decoded.upperVfShadowReg],
-                        sizeof(oldVf));
-            execUpper(decoded.upper);
-            std::memcpy(upperVf,
-                        m_state.vf[decoded.upperVfShadowReg],
-                        sizeof(upperVf));
-            std::memcpy(m_state.vf[decoded.upperVfShadowReg],
-                        oldVf,
-                        sizeof(oldVf));
-            execLower(decoded.lower, vuData, dataSize, gs, memory, decoded.upper);
-            std::memcpy(m_state.vf[decoded.upperVfShadowReg],
-                        upperVf,
-                        sizeof(upperVf));
-        }
-        else
-        {
-            execUpper(decoded.upper);
-            execLower(decoded.lower, vuData, dataSize, gs, memory, decoded.upper);
-        }
-
-        m_viBranchBackupValid = false;
-
-        if (hasUpperWrite)
-        {
-            std::memcpy(newUpperVf, m_state.vf[upperWrite.reg], sizeof(newUpperVf));
-            std::memcpy(m_state.vf[upperWrite.reg], oldUpperVf, sizeof(oldUpperVf));
-            const uint32_t latency =
-                decoded.upperUsage.vfLatency != 0u
-                    ? decoded.upperUsage.vfLatency
-                    : decoded.upperUsage.latency;
-            queueVfWrite(upperWrite.reg, upperWrite.lanes, newUpperVf, latency);
-        }
-        if (hasDistinctLowerWrite)
-        {
-            std::memcpy(newLowerVf, m_state.vf[lowerWrite.reg], sizeof(newLowerVf));
-            std::memcpy(m_state.vf[lowerWrite.reg], oldLowerVf, sizeof(oldLowerVf));
-            const uint32_t latency = decoded.lowerUsage.vfLatency != 0u
-                                         ? decoded.lowerUsage.vfLatency
-                                         : decoded.lowerUsage.latency;
-            queueVfWrite(lowerWrite.reg, lowerWrite.lanes, newLowerVf, latency);
-        }
-        if (decoded.upperUsage.accWrite != 0u)
-        {
-            std::memcpy(newAcc, m_state.acc, sizeof(newAcc));
-            std::memcpy(m_state.acc, oldAcc, sizeof(oldAcc));
-            // ACC is forwarded to the next upper instruction. Its arithmetic
-            // flags still use the normal four-cycle FMAC timeline.
-            queueAccWrite(decoded.upperUsage.accWrite, newAcc,
-                          kAccForwardLatency);
-        }
-        if (writtenVi != 0u)
-        {
-            const int32_t newVi = m_state.vi[writtenVi];
-            m_state.vi[writtenVi] = oldVi;
-            const uint32_t latency =
-                decoded.lowerUsage.viLatency != 0u
-                    ? decoded.lowerUsage.viLatency
-                    : decoded.lowerUsage.latency;
-            queueViWrite(writtenVi, newVi, latency);
-        }
-
-        markPairWrites(decoded);
-        if (writtenVi != 0u && decoded.lowerUsage.delaysNextBranchRead)
-            recordViWriteForBranch(writtenVi, oldVi);
-
-        m_state.vf[0][0] = 0.0f;
-        m_state.vf[0][1] = 0.0f;
-        m_state.vf[0][2] = 0.0f;
-        m_state.vf[0][3] = 1.0f;
-        m_state.vi[0] = 0;
+        issuePair(decoded, vuData, dataSize, gs, memory);
 
         uint32_t nextPc = m_state.pc + 8u;
         if (nextPc >= codeSize)
@@ -10,6 +10,9 @@ static inline uint8_t FS(uint32_t i) { return (uint8_t)((i >> 11) & 0x1F); }
 static inline uint8_t FD(uint32_t i) { return (uint8_t)((i >> 6) & 0x1F); }
 static inline uint8_t BC(uint32_t i) { return (uint8_t)(i & 0x3); }
 
+// DEST bit for a component (x = 8, y = 4, z = 2, w = 1)
+static inline constexpr uint8_t laneForComponent(uint32_t component) { return (uint8_t)(1u << (3u - component)); }
+
 // Lower instruction field helpers
 static inline uint8_t LIT(uint32_t i) { return (uint8_t)((i >> 16) & 0x1F); }
 static inline uint8_t LIS(uint32_t i) { return (uint8_t)((i >> 11) & 0x1F); }
@@ -69,9 +69,8 @@ namespace
 // ============================================================================
 // Lower instructions
 // ============================================================================
-void VU1Interpreter::execLower(uint32_t instr, uint8_t *vuData, uint32_t dataSize, GS &gs, PS2Memory *memory, uint32_t upperInstr)
+void VU1Interpreter::execLower(uint32_t instr, uint8_t *vuData, uint32_t dataSize, GS &gs, PS2Memory *memory)
 {
-    (void)upperInstr;
     if (instr == 0x00000000 || instr == 0x8000033C) // NOP
         return;
 
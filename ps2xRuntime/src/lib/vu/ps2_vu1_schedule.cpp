@@ -0,0 +1,459 @@
+#include "runtime/ps2_vu1.h"
+#include "ps2_vu1_detail.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+// Hand-scheduled microcode rarely stalls, yet the pipeline model pays for
+// hazard checks, write queues and commits on every pair. Straight-line runs
+// of the decoded cache are analyzed once per code generation: stalls inside
+// the run are resolved statically and reads of values produced before the run
+// become entry conditions. Pairs whose writes are visible by the end of the
+// run execute with immediate register writes. The trailing pairs, whose
+// results are still in flight when the run ends, go through the write
+// pipelines so the scheduler is left exactly as the pipeline model leaves it.
+
+namespace
+{
+    enum FastBlockReadKind : uint8_t
+    {
+        FastBlockReadVf = 0,
+        FastBlockReadVi,
+        FastBlockReadAcc
+    };
+
+    // OPMULA/OPMSUB read fs rotated by one lane (x = ys * zt and so on), while
+    // the usage tables record fs under the dest mask. The pipeline model does
+    // not wait for the rotated lanes, so a block may only cover such a pair
+    // once they have settled.
+    uint8_t outerProductFsLanes(uint32_t upper, uint8_t dest)
+    {
+        const uint8_t op = static_cast<uint8_t>(upper & 0x3Fu);
+        const uint8_t special = static_cast<uint8_t>((upper & 3u) | ((upper >> 4) & 0x7Cu));
+        if (op != 0x2Eu && (op < 0x3Cu || special != 0x2Eu))
+            return 0u;
+        uint8_t lanes = 0u;
+        if (dest & 0x8u)
+            lanes |= 0x4u;
+        if (dest & 0x4u)
+            lanes |= 0x2u;
+        if (dest & 0x2u)
+            lanes |= 0x8u;
+        return lanes;
+    }
+
+    // Register results of one analyzed pair with their ready offsets. VF
+    // slot 0 is the lower write and slot 1 the upper write.
+    struct FastBlockWrites
+    {
+        std::array<uint8_t, 2> vfReg{};
+        std::array<uint8_t, 2> vfLanes{};
+        std::array<uint32_t, 2> vfReady{};
+        uint16_t vi = 0;
+        uint32_t viReady = 0;
+        uint8_t acc = 0;
+        uint32_t accReady = 0;
+        uint32_t lastReady = 0;
+    };
+
+    // True if a later pair writes a lane before an earlier result to it has
+    // landed. The pipeline model then drops the earlier result.
+    bool overtakes(const FastBlockWrites &earlier, const FastBlockWrites &later, uint32_t laterIssue)
+    {
+        for (uint32_t i = 0; i < 2u; ++i)
+        {
+            for (uint32_t j = 0; j < 2u; ++j)
+            {
+                if (earlier.vfReg[i] != 0u && earlier.vfReg[i] == later.vfReg[j] &&
+                    (earlier.vfLanes[i] & later.vfLanes[j]) != 0u && earlier.vfReady[i] > laterIssue)
+                {
+                    return true;
+                }
+            }
+        }
+        if ((earlier.vi & later.vi) != 0u && earlier.viReady > laterIssue)
+            return true;
+        return (earlier.acc & later.acc) != 0u && earlier.accReady > laterIssue;
+    }
+}
+
+void VU1Interpreter::resetFastBlocks()
+{
+    m_fastBlocks.fill(FastBlock{});
+    m_fastBlockIssue.clear();
+    m_fastBlockReads.clear();
+}
+
+bool VU1Interpreter::fastBlockCandidate(const DecodedInstructionPair &decoded)
+{
+    if (decoded.upperUsage.reserved || decoded.lowerUsage.reserved)
+        return false;
+    if (decoded.eBit || decoded.dBit || decoded.tBit)
+        return false;
+
+    // Q, P, PATH1 and control flow keep their cycle-by-cycle timing.
+    const InstructionUsage &lower = decoded.lowerUsage;
+    switch (lower.pipeline)
+    {
+    case PipelineFdiv:
+    case PipelineEfu:
+    case PipelineBranch:
+    case PipelineXgkick:
+        return false;
+    default:
+        break;
+    }
+    if (lower.waitQ || lower.waitP || lower.readsClip || lower.writesClip)
+        return false;
+
+    // Flag instructions observe MAC/status/clip at an exact cycle.
+    const uint8_t opHi = static_cast<uint8_t>((decoded.lower >> 25) & 0x7Fu);
+    if (!decoded.iBit && opHi >= 0x10u && opHi <= 0x1Cu)
+        return false;
+    return true;
+}
+
+const VU1Interpreter::FastBlock &VU1Interpreter::fastBlockAt(uint32_t pairIndex)
+{
+    FastBlock &block = m_fastBlocks[pairIndex];
+    if (!block.analyzed)
+        analyzeFastBlock(pairIndex, block);
+    return block;
+}
+
+void VU1Interpreter::analyzeFastBlock(uint32_t pairIndex, FastBlock &block)
+{
+    block = {};
+    block.analyzed = true;
+    block.issueBegin = static_cast<uint32_t>(m_fastBlockIssue.size());
+    block.readBegin = static_cast<uint32_t>(m_fastBlockReads.size());
+
+    // Ready offsets relative to the block start, mirroring markPairWrites.
+    // Lanes not yet written inside the block are read from the entry state.
+    std::array<std::array<uint32_t, 4>, 32> vfReady{};
+    std::array<uint32_t, 16> viReady{};
+    std::array<uint32_t, 4> accReady{};
+    std::array<uint8_t, 32> vfWritten{};
+    std::array<uint8_t, 32> vfExternal{};
+    uint16_t viWritten = 0u;
+    uint16_t viExternal = 0u;
+    uint8_t accWritten = 0u;
+    uint8_t accExternal = 0u;
+
+    std::array<FastBlockWrites, kMaxFastBlockPairs> writes{};
+    uint32_t cycle = 0u;
+    uint32_t pairCount = 0u;
+    for (uint32_t index = pairIndex;
+         index + 1u < m_cachedPairCount && pairCount < kMaxFastBlockPairs;
+         ++index)
+    {
+        const DecodedInstructionPair &decoded = m_decodedCodeCache[index];
+        if (!fastBlockCandidate(decoded))
+            break;
+
+        const InstructionUsage *usages[2] = {&decoded.upperUsage, &decoded.lowerUsage};
+        uint32_t issue = cycle;
+        for (const InstructionUsage *usage : usages)
+        {
+            for (uint32_t read = 0; read < usage->vfReadCount; ++read)
+            {
+                const VfAccess &access = usage->vfRead[read];
+                for (uint32_t component = 0; component < 4u; ++component)
+                {
+                    if ((access.lanes & vfWritten[access.reg] & laneForComponent(component)) != 0u)
+                        issue = std::max(issue, vfReady[access.reg][component]);
+                }
+            }
+            for (uint32_t reg = 1; reg < 16u; ++reg)
+            {
+                if ((usage->viRead & viWritten & (1u << reg)) != 0u)
+                    issue = std::max(issue, viReady[reg]);
+            }
+            for (uint32_t component = 0; component < 4u; ++component)
+            {
+                if ((usage->accRead & accWritten & laneForComponent(component)) != 0u)
+                    issue = std::max(issue, accReady[component]);
+            }
+        }
+
+        const uint8_t outerLanes = static_cast<uint8_t>(outerProductFsLanes(decoded.upper, decoded.dest) &
+                                                        ~vfReadLanes(decoded.upperUsage, decoded.fs));
+        bool outerSettled = true;
+        for (uint32_t component = 0; component < 4u; ++component)
+        {
+            if ((outerLanes & vfWritten[decoded.fs] & laneForComponent(component)) != 0u &&
+                vfReady[decoded.fs][component] > issue)
+            {
+                outerSettled = false;
+            }
+        }
+        if (!outerSettled)
+            break;
+        if (decoded.fs != 0u && (outerLanes & ~vfWritten[decoded.fs] & ~vfExternal[decoded.fs]) != 0u)
+        {
+            const uint8_t lanes = static_cast<uint8_t>(outerLanes & ~vfWritten[decoded.fs] & ~vfExternal[decoded.fs]);
+            vfExternal[decoded.fs] |= lanes;
+            m_fastBlockReads.push_back({static_cast<uint16_t>(issue), FastBlockReadVf, decoded.fs, lanes});
+        }
+
+        // Only the earliest read of an entry value constrains the start.
+        for (const InstructionUsage *usage : usages)
+        {
+            for (uint32_t read = 0; read < usage->vfReadCount; ++read)
+            {
+                const VfAccess &access = usage->vfRead[read];
+                const uint8_t lanes = static_cast<uint8_t>(access.lanes & ~vfWritten[access.reg] & ~vfExternal[access.reg]);
+                if (access.reg == 0u || lanes == 0u)
+                    continue;
+                vfExternal[access.reg] |= lanes;
+                m_fastBlockReads.push_back({static_cast<uint16_t>(issue), FastBlockReadVf, access.reg, lanes});
+            }
+            const uint16_t viLanes = static_cast<uint16_t>(usage->viRead & ~viWritten & ~viExternal);
+            for (uint32_t reg = 1; reg < 16u; ++reg)
+            {
+                if ((viLanes & (1u << reg)) == 0u)
+                    continue;
+                m_fastBlockReads.push_back({static_cast<uint16_t>(issue), FastBlockReadVi, static_cast<uint8_t>(reg), 0u});
+            }
+            viExternal |= viLanes;
+            const uint8_t accLanes = static_cast<uint8_t>(usage->accRead & ~accWritten & ~accExternal);
+            if (accLanes != 0u)
+            {
+                accExternal |= accLanes;
+                m_fastBlockReads.push_back({static_cast<uint16_t>(issue), FastBlockReadAcc, 0u, accLanes});
+            }
+        }
+
+        FastBlockWrites &pairWrites = writes[pairCount];
+        pairWrites.lastReady = issue;
+        const VfAccess lowerWrite = decoded.lowerUsage.vfWrite;
+        if (lowerWrite.reg != 0u && decoded.suppressedLowerVf != lowerWrite.reg)
+        {
+            const uint32_t ready = issue + (decoded.lowerUsage.vfLatency != 0u
+                                                ? decoded.lowerUsage.vfLatency
+                                                : decoded.lowerUsage.latency);
+            for (uint32_t component = 0; component < 4u; ++component)
+            {
+                if ((lowerWrite.lanes & laneForComponent(component)) != 0u)
+                    vfReady[lowerWrite.reg][component] = ready;
+            }
+            vfWritten[lowerWrite.reg] |= lowerWrite.lanes;
+            pairWrites.vfReg[0] = lowerWrite.reg;
+            pairWrites.vfLanes[0] = lowerWrite.lanes;
+            pairWrites.vfReady[0] = ready;
+            pairWrites.lastReady = std::max(pairWrites.lastReady, ready);
+        }
+        const VfAccess upperWrite = decoded.upperUsage.vfWrite;
+        if (upperWrite.reg != 0u)
+        {
+            const uint32_t ready = issue + (decoded.upperUsage.vfLatency != 0u
+                                                ? decoded.upperUsage.vfLatency
+                                                : decoded.upperUsage.latency);
+            for (uint32_t component = 0; component < 4u; ++component)
+            {
+                if ((upperWrite.lanes & laneForComponent(component)) != 0u)
+                    vfReady[upperWrite.reg][component] = ready;
+            }
+            vfWritten[upperWrite.reg] |= upperWrite.lanes;
+            pairWrites.vfReg[1] = upperWrite.reg;
+            pairWrites.vfLanes[1] = upperWrite.lanes;
+            pairWrites.vfReady[1] = ready;
+            pairWrites.lastReady = std::max(pairWrites.lastReady, ready);
+        }
+        if (decoded.lowerUsage.viWrite != 0u)
+        {
+            const uint32_t ready = issue + (decoded.lowerUsage.viLatency != 0u
+                                                ? decoded.lowerUsage.viLatency
+                                                : decoded.lowerUsage.latency);
+            for (uint32_t reg = 1; reg < 16u; ++reg)
+            {
+                if ((decoded.lowerUsage.viWrite & (1u << reg)) != 0u)
+                    viReady[reg] = ready;
+            }
+            viWritten |= decoded.lowerUsage.viWrite;
+            pairWrites.vi = decoded.lowerUsage.viWrite;
+            pairWrites.viReady = ready;
+            pairWrites.lastReady = std::max(pairWrites.lastReady, ready);
+        }
+        if (decoded.upperUsage.accWrite != 0u)
+        {
+            const uint32_t ready = issue + kAccForwardLatency;
+            for (uint32_t component = 0; component < 4u; ++component)
+            {
+                if ((decoded.upperUsage.accWrite & laneForComponent(component)) != 0u)
+                    accReady[component] = ready;
+            }
+            accWritten |= decoded.upperUsage.accWrite;
+            pairWrites.acc = decoded.upperUsage.accWrite;
+            pairWrites.accReady = ready;
+            pairWrites.lastReady = std::max(pairWrites.lastReady, ready);
+        }
+
+        m_fastBlockIssue.push_back(static_cast<uint16_t>(issue));
+        cycle = issue + 1u;
+        ++pairCount;
+    }
+
+    if (pairCount < kMinFastBlockPairs)
+    {
+        m_fastBlockIssue.resize(block.issueBegin);
+        m_fastBlockReads.resize(block.readBegin);
+        return;
+    }
+
+    // Once one pair's results outlive the block, the rest queue theirs too so
+    // that write order is preserved in the pipelines. A queued write must not
+    // overtake an immediate one either, since the pipeline model would have
+    // dropped the immediate result.
+    const uint16_t *issue = m_fastBlockIssue.data() + block.issueBegin;
+    uint32_t immediatePairs = 0u;
+    while (immediatePairs < pairCount && writes[immediatePairs].lastReady <= cycle)
+        ++immediatePairs;
+    for (bool shrunk = true; shrunk;)
+    {
+        shrunk = false;
+        for (uint32_t later = immediatePairs; later < pairCount && !shrunk; ++later)
+        {
+            for (uint32_t earlier = 0; earlier < immediatePairs; ++earlier)
+            {
+                if (overtakes(writes[earlier], writes[later], issue[later]))
+                {
+                    immediatePairs = earlier;
+                    shrunk = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    block.pairCount = static_cast<uint16_t>(pairCount);
+    block.immediatePairs = static_cast<uint16_t>(immediatePairs);
+    block.cycles = static_cast<uint16_t>(cycle);
+    block.settleCycles = static_cast<uint16_t>(immediatePairs < pairCount ? issue[immediatePairs] : cycle);
+    block.readCount = static_cast<uint16_t>(m_fastBlockReads.size() - block.readBegin);
+}
+
+bool VU1Interpreter::canEnterFastBlock(const FastBlock &block, uint64_t budgetEnd) const
+{
+    if (block.pairCount == 0u)
+        return false;
+    if (m_state.branchPending || m_state.ebit || m_state.haltAfterDelaySlot)
+        return false;
+    if (m_fdiv.valid || m_xgkick.active)
+        return false;
+    for (const ScalarPipelineEntry &entry : m_efu)
+        if (entry.valid)
+            return false;
+
+    if (m_cycle + block.cycles > budgetEnd)
+        return false;
+
+    // Older writes must land before the first queued pair issues, so none can
+    // be overtaken by a write that is still in flight when the block ends.
+    const uint64_t settleCycle = m_cycle + block.settleCycles;
+    for (const PendingVfWrite &write : m_vfWritePipeline)
+        if (write.valid && write.readyCycle > settleCycle)
+            return false;
+    for (const PendingViWrite &write : m_viWritePipeline)
+        if (write.valid && write.readyCycle > settleCycle)
+            return false;
+    for (const PendingAccWrite &write : m_accWritePipeline)
+        if (write.valid && write.readyCycle > settleCycle)
+            return false;
+
+    const FastBlockRead *reads = m_fastBlockReads.data() + block.readBegin;
+    for (uint32_t index = 0; index < block.readCount; ++index)
+    {
+        const FastBlockRead &read = reads[index];
+        const uint64_t issueCycle = m_cycle + read.issueOffset;
+        if (read.kind == FastBlockReadVi)
+        {
+            if (m_viReady[read.reg] > issueCycle)
+                return false;
+            continue;
+        }
+        for (uint32_t component = 0; component < 4u; ++component)
+        {
+            if ((read.lanes & laneForComponent(component)) == 0u)
+                continue;
+            const uint64_t ready = read.kind == FastBlockReadVf
+                                       ? m_vfReady[read.reg][component]
+                                       : m_accReady[component];
+            if (ready > issueCycle)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool VU1Interpreter::tryRunFastBlock(const DecodedInstructionPair &decoded, uint64_t budgetEnd,
+                                     uint8_t *vuData, uint32_t dataSize,
+                                     GS &gs, PS2Memory *memory)
+{
+    if (&decoded == &m_uncachedPair)
+        return false;
+    const uint32_t pairIndex = static_cast<uint32_t>(&decoded - m_decodedCodeCache.data());
+    const FastBlock &block = fastBlockAt(pairIndex);
+    if (!canEnterFastBlock(block, budgetEnd))
+        return false;
+
+    // Every pending register write is ready before the block reads it and
+    // before any queued pair issues, so it can land now.
+    commitRegisterWrites(std::numeric_limits<uint64_t>::max());
+
+    // While pairs write immediately only flags and stores are queued. FDIV,
+    // EFU and XGKICK are idle, so nothing else advances with the cycle.
+    const auto advanceImmediateCycle = [this]()
+    {
+        ++m_cycle;
+        commitReadyFlags();
+        commitReadyStores();
+    };
+
+    const uint64_t startCycle = m_cycle;
+    const uint16_t *issue = m_fastBlockIssue.data() + block.issueBegin;
+    uint32_t offset = 0u;
+    for (; offset < block.immediatePairs && !m_stopRequested; ++offset)
+    {
+        while (m_cycle < startCycle + issue[offset])
+            advanceImmediateCycle();
+
+        const DecodedInstructionPair &pair = m_decodedCodeCache[pairIndex + offset];
+        m_state.pc = (pairIndex + offset) * 8u;
+        const uint16_t viWrite = pair.lowerUsage.viWrite;
+        const uint8_t writtenVi = viWrite != 0u ? static_cast<uint8_t>(std::countr_zero(viWrite)) : 0u;
+        const int32_t oldVi = m_state.vi[writtenVi];
+
+        executePair(pair, vuData, dataSize, gs, memory);
+
+        m_viBranchBackupValid = false;
+        if (writtenVi != 0u)
+        {
+            m_state.vi[writtenVi] = static_cast<int16_t>(m_state.vi[writtenVi]);
+            if (pair.lowerUsage.delaysNextBranchRead)
+                recordViWriteForBranch(writtenVi, oldVi);
+        }
+
+        m_state.vf[0][0] = 0.0f;
+        m_state.vf[0][1] = 0.0f;
+        m_state.vf[0][2] = 0.0f;
+        m_state.vf[0][3] = 1.0f;
+        m_state.vi[0] = 0;
+        m_state.pc = (pairIndex + offset + 1u) * 8u;
+        advanceImmediateCycle();
+    }
+
+    for (; offset < block.pairCount && !m_stopRequested; ++offset)
+    {
+        advanceTo(startCycle + issue[offset]);
+
+        const DecodedInstructionPair &pair = m_decodedCodeCache[pairIndex + offset];
+        m_state.pc = (pairIndex + offset) * 8u;
+        issuePair(pair, vuData, dataSize, gs, memory);
+        m_state.pc = (pairIndex + offset + 1u) * 8u;
+        advanceOneCycle();
+    }
+    m_state.cycles = m_cycle;
+    return true;
+}
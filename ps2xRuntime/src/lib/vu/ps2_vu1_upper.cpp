@@ -1,506 +1,508 @@
 #include "runtime/ps2_vu1.h"
+#include "runtime/ps2_vu_float.h"
 #include "ps2_vu1_detail.h"
 
-#include <cmath>
 #include <cstring>
 #include <limits>
+#include <utility>
 
 namespace
 {
-    int32_t vuFloatToInt(float value, float scale)
-    {
-        const double scaled = static_cast<double>(value) * static_cast<double>(scale);
-        if (scaled >= static_cast<double>(std::numeric_limits<int32_t>::max()))
-            return std::numeric_limits<int32_t>::max();
-        if (scaled <= static_cast<double>(std::numeric_limits<int32_t>::min()))
-            return std::numeric_limits<int32_t>::min();
-        return static_cast<int32_t>(scaled);
-    }
-}
+    // ITOF/FTOI 0, 4, 12 and 15 fixed-point scales, indexed by the low opcode bits.
+    constexpr float kFixedPointScale[4] = {1.0f, 16.0f, 4096.0f, 32768.0f};
 
-// ============================================================================
-// Upper instructions (FMAC pipeline)
-// ============================================================================
-void VU1Interpreter::execUpper(uint32_t instr)
-{
-    m_currentUpperInstruction = instr;
-    uint8_t dest = DEST(instr);
-    uint8_t ft = FT(instr);
-    uint8_t fs = FS(instr);
-    uint8_t fd = FD(instr);
-    uint8_t op = instr & 0x3F;
-
-    float *vd = m_state.vf[fd];
-    float normalizedVs[4];
-    float normalizedVt[4];
-    float normalizedAcc[4];
-    for (uint32_t component = 0; component < 4u; ++component)
-    {
-        normalizedVs[component] = normalizeOperand(m_state.vf[fs][component]);
-        normalizedVt[component] = normalizeOperand(m_state.vf[ft][component]);
-        normalizedAcc[component] = normalizeOperand(m_state.acc[component]);
-    }
-    const float *vs = normalizedVs;
-    const float *vt = normalizedVt;
-    const float *acc = normalizedAcc;
-    const float q = normalizeOperand(m_state.q);
-    const float i = normalizeOperand(m_state.i);
-    float result[4];
+    // SIMD lane masks are x-first (bit 0 = x); DEST and MAC masks are x-high.
+    constexpr uint8_t kReverseLanes[16] = {0u, 8u, 4u, 12u, 2u, 10u, 6u, 14u,
+                                           1u, 9u, 5u, 13u, 3u, 11u, 7u, 15u};
 
-    // Upper opcode decoding (bits 5:0 of upper word)
-    switch (op)
+    // Exact FMAC results are held as two pairs of doubles. A product of two
+    // floats is exact in double, and a sum rounded once to double falls on
+    // the same side of FLT_MAX, FLT_MIN and zero as the exact sum. The only
+    // exception is a sum that rounds to exactly FLT_MAX or FLT_MIN, which is
+    // reported in boundaryLanes for the scalar long double path.
+    struct FmacClassification
     {
-    case 0x00:
-    case 0x01:
-    case 0x02:
-    case 0x03: // ADDbc
-    {
-        float bc = broadcast(vt, op & 3);
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] + bc;
-        applyFmacDest(vd, result, dest);
-        return;
-    }
-    case 0x04:
-    case 0x05:
-    case 0x06:
-    case 0x07: // SUBbc
+        __m128 sign;
+        __m128 zero;
+        __m128 overflow;
+        uint32_t zeroLanes;
+        uint32_t signLanes;
+        uint32_t underflowLanes;
+        uint32_t overflowLanes;
+        uint32_t boundaryLanes;
+    };
+
+    inline __m128d highToDouble(__m128 value)
     {
-        float bc = broadcast(vt, op & 3);
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] - bc;
-        applyFmacDest(vd, result, dest);
-        return;
+        return _mm_cvtps_pd(_mm_movehl_ps(value, value));
     }
-    case 0x08:
-    case 0x09:
-    case 0x0A:
-    case 0x0B: // MADDbc
+
+    inline __m128 packLaneMask(__m128d low, __m128d high)
     {
-        float bc = broadcast(vt, op & 3);
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] + vs[c] * bc;
-        applyFmacDest(vd, result, dest);
-        return;
+        return _mm_shuffle_ps(_mm_castpd_ps(low), _mm_castpd_ps(high), _MM_SHUFFLE(2, 0, 2, 0));
     }
-    case 0x0C:
-    case 0x0D:
-    case 0x0E:
-    case 0x0F: // MSUBbc
+
+    inline FmacClassification classifyFmac(__m128d low, __m128d high)
     {
-        float bc = broadcast(vt, op & 3);
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] - vs[c] * bc;
-        applyFmacDest(vd, result, dest);
-        return;
+        const __m128d magnitudeMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFll));
+        const __m128d maximum = _mm_set1_pd(static_cast<double>(std::numeric_limits<float>::max()));
+        const __m128d minimum = _mm_set1_pd(static_cast<double>(std::numeric_limits<float>::min()));
+        const __m128d lowMagnitude = _mm_and_pd(low, magnitudeMask);
+        const __m128d highMagnitude = _mm_and_pd(high, magnitudeMask);
+
+        const __m128 isZero = packLaneMask(_mm_cmpeq_pd(lowMagnitude, _mm_setzero_pd()),
+                                           _mm_cmpeq_pd(highMagnitude, _mm_setzero_pd()));
+        const __m128 isSmall = packLaneMask(_mm_cmplt_pd(lowMagnitude, minimum),
+                                            _mm_cmplt_pd(highMagnitude, minimum));
+        const __m128 isOverflow = packLaneMask(_mm_cmpgt_pd(lowMagnitude, maximum),
+                                               _mm_cmpgt_pd(highMagnitude, maximum));
+        const __m128 isBoundary = packLaneMask(
+            _mm_or_pd(_mm_cmpeq_pd(lowMagnitude, maximum), _mm_cmpeq_pd(lowMagnitude, minimum)),
+            _mm_or_pd(_mm_cmpeq_pd(highMagnitude, maximum), _mm_cmpeq_pd(highMagnitude, minimum)));
+        const __m128 signBits = _mm_and_ps(
+            _mm_shuffle_ps(_mm_castpd_ps(low), _mm_castpd_ps(high), _MM_SHUFFLE(3, 1, 3, 1)),
+            _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(PS2_VU_FLOAT_SIGN))));
+
+        FmacClassification result;
+        result.sign = signBits;
+        result.zero = isSmall;
+        result.overflow = isOverflow;
+        result.zeroLanes = static_cast<uint32_t>(_mm_movemask_ps(isSmall));
+        result.signLanes = static_cast<uint32_t>(_mm_movemask_pd(low) | (_mm_movemask_pd(high) << 2));
+        result.underflowLanes = static_cast<uint32_t>(_mm_movemask_ps(_mm_andnot_ps(isZero, isSmall)));
+        result.overflowLanes = static_cast<uint32_t>(_mm_movemask_ps(isOverflow));
+        result.boundaryLanes = static_cast<uint32_t>(_mm_movemask_ps(isBoundary));
+        return result;
     }
-    case 0x10:
-    case 0x11:
-    case 0x12:
-    case 0x13: // MAXbc
+
+    // Folds a zero, underflowed or overflowed lane the way the FMAC does:
+    // signed zero or signed largest finite value, with the exact sign.
+    inline __m128 foldFmacResult(__m128 value, const FmacClassification &cls)
     {
-        float bc = broadcast(vt, op & 3);
-        for (int c = 0; c < 4; c++)
-            result[c] = (vs[c] > bc) ? vs[c] : bc;
-        applyDest(vd, result, dest);
-        return;
+        const __m128 saturated = _mm_or_ps(cls.sign, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(PS2_VU_FLOAT_MAX))));
+        value = _mm_blendv_ps(value, cls.sign, cls.zero);
+        return _mm_blendv_ps(value, saturated, cls.overflow);
     }
-    case 0x14:
-    case 0x15:
-    case 0x16:
-    case 0x17: // MINIbc
+
+    inline uint32_t statusOf(uint32_t zero, uint32_t sign, uint32_t underflow, uint32_t overflow)
     {
-        float bc = broadcast(vt, op & 3);
-        for (int c = 0; c < 4; c++)
-            result[c] = (vs[c] < bc) ? vs[c] : bc;
-        applyDest(vd, result, dest);
-        return;
+        return (zero != 0u ? PS2_VU_LANE_ZERO : 0u) |
+               (sign != 0u ? PS2_VU_LANE_SIGN : 0u) |
+               (underflow != 0u ? PS2_VU_LANE_UNDERFLOW : 0u) |
+               (overflow != 0u ? PS2_VU_LANE_OVERFLOW : 0u);
     }
-    case 0x18:
-    case 0x19:
-    case 0x1A:
-    case 0x1B: // MULbc
+}
+
+// ============================================================================
+// Upper instructions (FMAC pipeline)
+// ============================================================================
+template <VU1Interpreter::FmacOp Op, VU1Interpreter::FmacSource Source, bool ToAcc, uint8_t Dest>
+void VU1Interpreter::upperFmac(const DecodedInstructionPair &decoded)
+{
+    if constexpr (Dest == 0u)
     {
-        float bc = broadcast(vt, op & 3);
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] * bc;
-        applyFmacDest(vd, result, dest);
+        (void)decoded;
         return;
     }
-    case 0x1C: // MULq
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] * q;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x1D: // MAXi
-        for (int c = 0; c < 4; c++)
-            result[c] = (vs[c] > i) ? vs[c] : i;
-        applyDest(vd, result, dest);
-        return;
-    case 0x1E: // MULi
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] * i;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x1F: // MINIi
-        for (int c = 0; c < 4; c++)
-            result[c] = (vs[c] < i) ? vs[c] : i;
-        applyDest(vd, result, dest);
-        return;
-    case 0x20: // ADDq
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] + q;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x21: // MADDq
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] + vs[c] * q;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x22: // ADDi
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] + i;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x23: // MADDi
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] + vs[c] * i;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x24: // SUBq
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] - q;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x25: // MSUBq
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] - vs[c] * q;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x26: // SUBi
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] - i;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x27: // MSUBi
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] - vs[c] * i;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x28: // ADD
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] + vt[c];
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x29: // MADD
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] + vs[c] * vt[c];
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x2A: // MUL
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] * vt[c];
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x2B: // MAX
-        for (int c = 0; c < 4; c++)
-            result[c] = (vs[c] > vt[c]) ? vs[c] : vt[c];
-        applyDest(vd, result, dest);
-        return;
-    case 0x2C: // SUB
-        for (int c = 0; c < 4; c++)
-            result[c] = vs[c] - vt[c];
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x2D: // MSUB
-        for (int c = 0; c < 4; c++)
-            result[c] = acc[c] - vs[c] * vt[c];
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x2E: // OPMSUB
-        result[0] = acc[0] - vs[1] * vt[2];
-        result[1] = acc[1] - vs[2] * vt[0];
-        result[2] = acc[2] - vs[0] * vt[1];
-        result[3] = 0.0f;
-        applyFmacDest(vd, result, dest);
-        return;
-    case 0x2F: // MINI
-        for (int c = 0; c < 4; c++)
-            result[c] = (vs[c] < vt[c]) ? vs[c] : vt[c];
-        applyDest(vd, result, dest);
-        return;
-
-    // Upper special group (low op 0x3C..0x3F).
-    // Like lower1 special, the real selector is not just bits 5:0.  Dobie decodes:
-    //   op = (instr & 0x3) | ((instr >> 4) & 0x7C)
-    // Several instructions in this group also use FT as the destination, not FD.
-    case 0x3C:
-    case 0x3D:
-    case 0x3E:
-    case 0x3F:
+    else
     {
-        const uint8_t specialOp = static_cast<uint8_t>((instr & 0x3u) | ((instr >> 4) & 0x7Cu));
-        float *vtDest = m_state.vf[ft];
+        constexpr bool productSum = Op == FmacOp::Madd || Op == FmacOp::Msub;
+        constexpr int laneMask = kReverseLanes[Dest];
 
-        switch (specialOp)
+        __m128 left = Ps2VuNormalize4(_mm_loadu_ps(m_state.vf[decoded.fs]));
+        __m128 right;
+        if constexpr (Source == FmacSource::Broadcast)
+            right = _mm_set1_ps(normalizeOperand(m_state.vf[decoded.ft][decoded.bc]));
+        else if constexpr (Source == FmacSource::Q)
+            right = _mm_set1_ps(normalizeOperand(m_state.q));
+        else if constexpr (Source == FmacSource::I)
+            right = _mm_set1_ps(normalizeOperand(m_state.i));
+        else
+            right = Ps2VuNormalize4(_mm_loadu_ps(m_state.vf[decoded.ft]));
+        if constexpr (Source == FmacSource::Outer)
         {
-        case 0x00:
-        case 0x01:
-        case 0x02:
-        case 0x03: // ADDAbc
-        {
-            float bc = broadcast(vt, specialOp & 3);
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] + bc;
-            applyFmacDestAcc(result, dest);
-            return;
+            // OPMULA/OPMSUB: x = ys*zt, y = zs*xt, z = xs*yt.
+            left = _mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 0, 2, 1));
+            right = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 1, 0, 2));
         }
-        case 0x04:
-        case 0x05:
-        case 0x06:
-        case 0x07: // SUBAbc
+        __m128 acc = _mm_setzero_ps();
+        if constexpr (productSum)
+            acc = Ps2VuNormalize4(_mm_loadu_ps(m_state.acc));
+
+        const __m128d leftLow = _mm_cvtps_pd(left);
+        const __m128d leftHigh = highToDouble(left);
+        const __m128d rightLow = _mm_cvtps_pd(right);
+        const __m128d rightHigh = highToDouble(right);
+        __m128 value;
+        __m128d exactLow;
+        __m128d exactHigh;
+        __m128d productLow = _mm_setzero_pd();
+        __m128d productHigh = _mm_setzero_pd();
+        if constexpr (Op == FmacOp::Add)
         {
-            float bc = broadcast(vt, specialOp & 3);
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] - bc;
-            applyFmacDestAcc(result, dest);
-            return;
+            value = _mm_add_ps(left, right);
+            exactLow = _mm_add_pd(leftLow, rightLow);
+            exactHigh = _mm_add_pd(leftHigh, rightHigh);
         }
-        case 0x08:
-        case 0x09:
-        case 0x0A:
-        case 0x0B: // MADDAbc
+        else if constexpr (Op == FmacOp::Sub)
         {
-            float bc = broadcast(vt, specialOp & 3);
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] + vs[c] * bc;
-            applyFmacDestAcc(result, dest);
-            return;
+            value = _mm_sub_ps(left, right);
+            exactLow = _mm_sub_pd(leftLow, rightLow);
+            exactHigh = _mm_sub_pd(leftHigh, rightHigh);
         }
-        case 0x0C:
-        case 0x0D:
-        case 0x0E:
-        case 0x0F: // MSUBAbc
+        else if constexpr (Op == FmacOp::Mul)
         {
-            float bc = broadcast(vt, specialOp & 3);
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] - vs[c] * bc;
-            applyFmacDestAcc(result, dest);
-            return;
+            value = _mm_mul_ps(left, right);
+            exactLow = _mm_mul_pd(leftLow, rightLow);
+            exactHigh = _mm_mul_pd(leftHigh, rightHigh);
         }
-        case 0x10: // ITOF0
-            for (int c = 0; c < 4; c++)
-            {
-                int32_t iv;
-                std::memcpy(&iv, &m_state.vf[fs][c], 4);
-                result[c] = static_cast<float>(iv);
-            }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x11: // ITOF4
-            for (int c = 0; c < 4; c++)
-            {
-                int32_t iv;
-                std::memcpy(&iv, &m_state.vf[fs][c], 4);
-                result[c] = static_cast<float>(iv) / 16.0f;
-            }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x12: // ITOF12
-            for (int c = 0; c < 4; c++)
-            {
-                int32_t iv;
-                std::memcpy(&iv, &m_state.vf[fs][c], 4);
-                result[c] = static_cast<float>(iv) / 4096.0f;
-            }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x13: // ITOF15
-            for (int c = 0; c < 4; c++)
-            {
-                int32_t iv;
-                std::memcpy(&iv, &m_state.vf[fs][c], 4);
-                result[c] = static_cast<float>(iv) / 32768.0f;
-            }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x14: // FTOI0
-            for (int c = 0; c < 4; c++)
-            {
-                int32_t iv = vuFloatToInt(vs[c], 1.0f);
-                std::memcpy(&result[c], &iv, 4);
-            }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x15: // FTOI4
-            for (int c = 0; c < 4; c++)
+        else
+        {
+            productLow = _mm_mul_pd(leftLow, rightLow);
+            productHigh = _mm_mul_pd(leftHigh, rightHigh);
+            if constexpr (Op == FmacOp::Madd)
             {
-                int32_t iv = vuFloatToInt(vs[c], 16.0f);
-                std::memcpy(&result[c], &iv, 4);
+                value = _mm_add_ps(acc, _mm_mul_ps(left, right));
+                exactLow = _mm_add_pd(_mm_cvtps_pd(acc), productLow);
+                exactHigh = _mm_add_pd(highToDouble(acc), productHigh);
             }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x16: // FTOI12
-            for (int c = 0; c < 4; c++)
+            else
             {
-                int32_t iv = vuFloatToInt(vs[c], 4096.0f);
-                std::memcpy(&result[c], &iv, 4);
+                value = _mm_sub_ps(acc, _mm_mul_ps(left, right));
+                exactLow = _mm_sub_pd(_mm_cvtps_pd(acc), productLow);
+                exactHigh = _mm_sub_pd(highToDouble(acc), productHigh);
             }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x17: // FTOI15
-            for (int c = 0; c < 4; c++)
+        }
+        if constexpr (Source == FmacSource::Outer)
+        {
+            value = _mm_blend_ps(value, _mm_setzero_ps(), 0x8);
+            exactHigh = _mm_blend_pd(exactHigh, _mm_setzero_pd(), 0x2);
+        }
+
+        const FmacClassification cls = classifyFmac(exactLow, exactHigh);
+        value = foldFmacResult(value, cls);
+        uint32_t zeroLanes = cls.zeroLanes;
+        uint32_t signLanes = cls.signLanes;
+        uint32_t underflowLanes = cls.underflowLanes;
+        uint32_t overflowLanes = cls.overflowLanes;
+
+        // Products are exact in double, so only sums can land on a boundary.
+        uint32_t boundaryLanes = Op == FmacOp::Mul ? 0u : cls.boundaryLanes & static_cast<uint32_t>(laneMask);
+        if (boundaryLanes != 0u)
+        {
+            float leftLanes[4];
+            float rightLanes[4];
+            float accLanes[4];
+            float valueLanes[4];
+            _mm_storeu_ps(leftLanes, left);
+            _mm_storeu_ps(rightLanes, right);
+            _mm_storeu_ps(accLanes, acc);
+            _mm_storeu_ps(valueLanes, value);
+            for (uint32_t component = 0; component < 4u; ++component)
             {
-                int32_t iv = vuFloatToInt(vs[c], 32768.0f);
-                std::memcpy(&result[c], &iv, 4);
+                const uint32_t bit = 1u << component;
+                if ((boundaryLanes & bit) == 0u)
+                    continue;
+                const long double l = leftLanes[component];
+                const long double r = rightLanes[component];
+                const long double a = accLanes[component];
+                long double exact = 0.0L;
+                if constexpr (Op == FmacOp::Add)
+                    exact = l + r;
+                else if constexpr (Op == FmacOp::Sub)
+                    exact = l - r;
+                else if constexpr (Op == FmacOp::Madd)
+                    exact = a + l * r;
+                else
+                    exact = a - l * r;
+                const uint8_t flags = normalizeFmacExactResult(valueLanes[component], exact);
+                zeroLanes = (zeroLanes & ~bit) | ((flags & PS2_VU_LANE_ZERO) != 0u ? bit : 0u);
+                signLanes = (signLanes & ~bit) | ((flags & PS2_VU_LANE_SIGN) != 0u ? bit : 0u);
+                underflowLanes = (underflowLanes & ~bit) | ((flags & PS2_VU_LANE_UNDERFLOW) != 0u ? bit : 0u);
+                overflowLanes = (overflowLanes & ~bit) | ((flags & PS2_VU_LANE_OVERFLOW) != 0u ? bit : 0u);
             }
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x18:
-        case 0x19:
-        case 0x1A:
-        case 0x1B: // MULAbc
-        {
-            float bc = broadcast(vt, specialOp & 3);
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] * bc;
-            applyFmacDestAcc(result, dest);
-            return;
+            value = _mm_loadu_ps(valueLanes);
         }
-        case 0x1C: // MULAq
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] * q;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x1D: // ABS
-            for (int c = 0; c < 4; c++)
-                result[c] = std::fabs(vs[c]);
-            applyDest(vtDest, result, dest);
-            return;
-        case 0x1E: // MULAi
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] * i;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x1F: // CLIP
+
+        zeroLanes &= laneMask;
+        signLanes &= laneMask;
+        underflowLanes &= laneMask;
+        overflowLanes &= laneMask;
+        const uint32_t mac = kReverseLanes[zeroLanes] |
+                             (static_cast<uint32_t>(kReverseLanes[signLanes]) << 4) |
+                             (static_cast<uint32_t>(kReverseLanes[underflowLanes]) << 8) |
+                             (static_cast<uint32_t>(kReverseLanes[overflowLanes]) << 12);
+        const uint32_t status = statusOf(zeroLanes, signLanes, underflowLanes, overflowLanes);
+
+        uint32_t productSticky = 0u;
+        if constexpr (productSum)
         {
-            uint32_t wBits = 0u;
-            std::memcpy(&wBits, &m_state.vf[ft][3], sizeof(wBits));
-            const int32_t limit = (wBits & 0x7F800000u) != 0u ? static_cast<int32_t>(wBits & 0x7FFFFFFFu) : 0x007FFFFF;
+            // Product-sum instructions report Z/S/U/O from the add/subtract
+            // result as current flags, while every product condition
+            // accumulates into the corresponding sticky flag.
+            const FmacClassification product = classifyFmac(productLow, productHigh);
+            productSticky = statusOf(product.zeroLanes & laneMask,
+                                     product.signLanes & laneMask,
+                                     product.underflowLanes & laneMask,
+                                     product.overflowLanes & laneMask);
+        }
+        queueFmacFlags(mac, status, productSticky);
+
+        float *target = ToAcc ? m_state.acc : m_state.vf[decoded.fd];
+        _mm_storeu_ps(target, _mm_blend_ps(_mm_loadu_ps(target), value, laneMask));
+    }
+}
+
+template <bool Max, VU1Interpreter::FmacSource Source, uint8_t Dest>
+void VU1Interpreter::upperMinMax(const DecodedInstructionPair &decoded)
+{
+    constexpr int laneMask = kReverseLanes[Dest];
+    const __m128 left = Ps2VuNormalize4(_mm_loadu_ps(m_state.vf[decoded.fs]));
+    __m128 right;
+    if constexpr (Source == FmacSource::Broadcast)
+        right = _mm_set1_ps(normalizeOperand(m_state.vf[decoded.ft][decoded.bc]));
+    else if constexpr (Source == FmacSource::I)
+        right = _mm_set1_ps(normalizeOperand(m_state.i));
+    else
+        right = Ps2VuNormalize4(_mm_loadu_ps(m_state.vf[decoded.ft]));
+
+    // MAXPS/MINPS return the second operand unless the first compares
+    // greater/less, matching (vs > vt) ? vs : vt with signed zeros.
+    const __m128 result = Max ? _mm_max_ps(left, right) : _mm_min_ps(left, right);
+    float *target = m_state.vf[decoded.fd];
+    _mm_storeu_ps(target, _mm_blend_ps(_mm_loadu_ps(target), result, laneMask));
+}
+
+void VU1Interpreter::upperItof(const DecodedInstructionPair &decoded)
+{
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_state.vf[decoded.fs]));
+    float result[4];
+    _mm_storeu_ps(result, _mm_div_ps(_mm_cvtepi32_ps(raw), _mm_set1_ps(kFixedPointScale[decoded.bc])));
+    applyDest(m_state.vf[decoded.ft], result, decoded.dest);
+}
+
+void VU1Interpreter::upperFtoi(const DecodedInstructionPair &decoded)
+{
+    // Scaling by a power of two is exact unless it overflows, and an
+    // overflowed lane saturates either way.
+    const __m128 scaled = _mm_mul_ps(Ps2VuNormalize4(_mm_loadu_ps(m_state.vf[decoded.fs])),
+                                     _mm_set1_ps(kFixedPointScale[decoded.bc]));
+    float result[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(result), Ps2VuFtoi4(scaled));
+    applyDest(m_state.vf[decoded.ft], result, decoded.dest);
+}
 
-            const auto exceedsClipPlane = [limit](float value, uint32_t signMask)
+void VU1Interpreter::upperAbs(const DecodedInstructionPair &decoded)
+{
+    const __m128 magnitudeMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(~PS2_VU_FLOAT_SIGN)));
+    float result[4];
+    _mm_storeu_ps(result, _mm_and_ps(Ps2VuNormalize4(_mm_loadu_ps(m_state.vf[decoded.fs])), magnitudeMask));
+    applyDest(m_state.vf[decoded.ft], result, decoded.dest);
+}
+
+void VU1Interpreter::upperClip(const DecodedInstructionPair &decoded)
+{
+    const float *vs = m_state.vf[decoded.fs];
+    uint32_t wBits = 0u;
+    std::memcpy(&wBits, &m_state.vf[decoded.ft][3], sizeof(wBits));
+    const int32_t limit = (wBits & 0x7F800000u) != 0u ? static_cast<int32_t>(wBits & 0x7FFFFFFFu) : 0x007FFFFF;
+
+    const auto exceedsClipPlane = [limit](float value, uint32_t signMask)
+    {
+        uint32_t bits = 0u;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits ^= signMask;
+        int32_t orderedBits = 0;
+        std::memcpy(&orderedBits, &bits, sizeof(orderedBits));
+        return orderedBits > limit;
+    };
+
+    uint32_t flags = 0u;
+    if (exceedsClipPlane(vs[0], 0x00000000u))
+        flags |= 0x01u;
+    if (exceedsClipPlane(vs[0], 0x80000000u))
+        flags |= 0x02u;
+    if (exceedsClipPlane(vs[1], 0x00000000u))
+        flags |= 0x04u;
+    if (exceedsClipPlane(vs[1], 0x80000000u))
+        flags |= 0x08u;
+    if (exceedsClipPlane(vs[2], 0x00000000u))
+        flags |= 0x10u;
+    if (exceedsClipPlane(vs[2], 0x80000000u))
+        flags |= 0x20u;
+    queueClip(flags);
+}
+
+void VU1Interpreter::upperNop(const DecodedInstructionPair &)
+{
+}
+
+void VU1Interpreter::upperReserved(const DecodedInstructionPair &decoded)
+{
+    reportReservedInstruction(true, decoded.upper);
+}
+
+// ============================================================================
+// Upper handler selection
+// ============================================================================
+struct VU1Interpreter::UpperHandlerTable
+{
+    using DestHandlers = std::array<UpperHandler, 16>;
+
+    template <FmacOp Op, FmacSource Source, bool ToAcc, size_t... Dest>
+    static constexpr DestHandlers makeFmac(std::index_sequence<Dest...>)
+    {
+        return {&VU1Interpreter::upperFmac<Op, Source, ToAcc, static_cast<uint8_t>(Dest)>...};
+    }
+
+    template <bool Max, FmacSource Source, size_t... Dest>
+    static constexpr DestHandlers makeMinMax(std::index_sequence<Dest...>)
+    {
+        return {&VU1Interpreter::upperMinMax<Max, Source, static_cast<uint8_t>(Dest)>...};
+    }
+
+    template <FmacOp Op, FmacSource Source, bool ToAcc>
+    static UpperHandler fmac(uint8_t dest)
+    {
+        static constexpr DestHandlers handlers = makeFmac<Op, Source, ToAcc>(std::make_index_sequence<16>{});
+        return handlers[dest & 0xFu];
+    }
+
+    template <bool Max, FmacSource Source>
+    static UpperHandler minMax(uint8_t dest)
+    {
+        static constexpr DestHandlers handlers = makeMinMax<Max, Source>(std::make_index_sequence<16>{});
+        return handlers[dest & 0xFu];
+    }
+
+    // The main group and the ACC-writing special group share the FMAC
+    // numbering (ADDAbc is special 0x00 like ADDbc, MADDAq is 0x21 like
+    // MADDq and so on). Returns nullptr for selectors outside that set.
+    template <bool ToAcc>
+    static UpperHandler arithmetic(uint8_t op, uint8_t dest)
+    {
+        if (op <= 0x0Fu || (op >= 0x18u && op <= 0x1Bu))
+        {
+            switch (op >> 2)
             {
-                uint32_t bits = 0u;
-                std::memcpy(&bits, &value, sizeof(bits));
-                bits ^= signMask;
-                int32_t orderedBits = 0;
-                std::memcpy(&orderedBits, &bits, sizeof(orderedBits));
-                return orderedBits > limit;
-            };
-
-            uint32_t flags = 0u;
-            if (exceedsClipPlane(m_state.vf[fs][0], 0x00000000u))
-                flags |= 0x01u;
-            if (exceedsClipPlane(m_state.vf[fs][0], 0x80000000u))
-                flags |= 0x02u;
-            if (exceedsClipPlane(m_state.vf[fs][1], 0x00000000u))
-                flags |= 0x04u;
-            if (exceedsClipPlane(m_state.vf[fs][1], 0x80000000u))
-                flags |= 0x08u;
-            if (exceedsClipPlane(m_state.vf[fs][2], 0x00000000u))
-                flags |= 0x10u;
-            if (exceedsClipPlane(m_state.vf[fs][2], 0x80000000u))
-                flags |= 0x20u;
-            queueClip(flags);
-            return;
+            case 0x0u:
+                return fmac<FmacOp::Add, FmacSource::Broadcast, ToAcc>(dest);
+            case 0x1u:
+                return fmac<FmacOp::Sub, FmacSource::Broadcast, ToAcc>(dest);
+            case 0x2u:
+                return fmac<FmacOp::Madd, FmacSource::Broadcast, ToAcc>(dest);
+            case 0x3u:
+                return fmac<FmacOp::Msub, FmacSource::Broadcast, ToAcc>(dest);
+            default:
+                return fmac<FmacOp::Mul, FmacSource::Broadcast, ToAcc>(dest);
+            }
         }
-        case 0x20: // ADDAq
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] + q;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x21: // MADDAq
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] + vs[c] * q;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x22: // ADDAi
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] + i;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x23: // MADDAi
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] + vs[c] * i;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x24: // SUBAq
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] - q;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x25: // MSUBAq
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] - vs[c] * q;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x26: // SUBAi
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] - i;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x27: // MSUBAi
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] - vs[c] * i;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x28: // ADDA
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] + vt[c];
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x29: // MADDA
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] + vs[c] * vt[c];
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x2A: // MULA
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] * vt[c];
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x2C: // SUBA
-            for (int c = 0; c < 4; c++)
-                result[c] = vs[c] - vt[c];
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x2D: // MSUBA
-            for (int c = 0; c < 4; c++)
-                result[c] = acc[c] - vs[c] * vt[c];
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x2E: // OPMULA
-            result[0] = vs[1] * vt[2];
-            result[1] = vs[2] * vt[0];
-            result[2] = vs[0] * vt[1];
-            result[3] = 0.0f;
-            applyFmacDestAcc(result, dest);
-            return;
-        case 0x2F:
-        case 0x30: // NOP
-            return;
+
+        switch (op)
+        {
+        case 0x1Cu:
+            return fmac<FmacOp::Mul, FmacSource::Q, ToAcc>(dest);
+        case 0x1Eu:
+            return fmac<FmacOp::Mul, FmacSource::I, ToAcc>(dest);
+        case 0x20u:
+            return fmac<FmacOp::Add, FmacSource::Q, ToAcc>(dest);
+        case 0x21u:
+            return fmac<FmacOp::Madd, FmacSource::Q, ToAcc>(dest);
+        case 0x22u:
+            return fmac<FmacOp::Add, FmacSource::I, ToAcc>(dest);
+        case 0x23u:
+            return fmac<FmacOp::Madd, FmacSource::I, ToAcc>(dest);
+        case 0x24u:
+            return fmac<FmacOp::Sub, FmacSource::Q, ToAcc>(dest);
+        case 0x25u:
+            return fmac<FmacOp::Msub, FmacSource::Q, ToAcc>(dest);
+        case 0x26u:
+            return fmac<FmacOp::Sub, FmacSource::I, ToAcc>(dest);
+        case 0x27u:
+            return fmac<FmacOp::Msub, FmacSource::I, ToAcc>(dest);
+        case 0x28u:
+            return fmac<FmacOp::Add, FmacSource::Vector, ToAcc>(dest);
+        case 0x29u:
+            return fmac<FmacOp::Madd, FmacSource::Vector, ToAcc>(dest);
+        case 0x2Au:
+            return fmac<FmacOp::Mul, FmacSource::Vector, ToAcc>(dest);
+        case 0x2Cu:
+            return fmac<FmacOp::Sub, FmacSource::Vector, ToAcc>(dest);
+        case 0x2Du:
+            return fmac<FmacOp::Msub, FmacSource::Vector, ToAcc>(dest);
+        case 0x2Eu:
+            // OPMSUB in the main group, OPMULA in the special group.
+            if constexpr (ToAcc)
+                return fmac<FmacOp::Mul, FmacSource::Outer, true>(dest);
+            else
+                return fmac<FmacOp::Msub, FmacSource::Outer, false>(dest);
         default:
-            reportReservedInstruction(true, instr);
-            return;
+            return nullptr;
         }
     }
+};
 
-    case 0x30:
-    case 0x31:
-    case 0x32:
-    case 0x33:
-    default:
-        reportReservedInstruction(true, instr);
-        return;
+VU1Interpreter::UpperHandler VU1Interpreter::selectUpperHandler(uint32_t upper)
+{
+    using Table = UpperHandlerTable;
+    const uint8_t dest = DEST(upper);
+    const uint8_t op = static_cast<uint8_t>(upper & 0x3Fu);
+
+    if (op <= 0x2Fu)
+    {
+        switch (op)
+        {
+        case 0x10u:
+        case 0x11u:
+        case 0x12u:
+        case 0x13u: // MAXbc
+            return Table::minMax<true, FmacSource::Broadcast>(dest);
+        case 0x14u:
+        case 0x15u:
+        case 0x16u:
+        case 0x17u: // MINIbc
+            return Table::minMax<false, FmacSource::Broadcast>(dest);
+        case 0x1Du: // MAXi
+            return Table::minMax<true, FmacSource::I>(dest);
+        case 0x1Fu: // MINIi
+            return Table::minMax<false, FmacSource::I>(dest);
+        case 0x2Bu: // MAX
+            return Table::minMax<true, FmacSource::Vector>(dest);
+        case 0x2Fu: // MINI
+            return Table::minMax<false, FmacSource::Vector>(dest);
+        default:
+            if (const UpperHandler handler = Table::arithmetic<false>(op, dest))
+                return handler;
+            break;
+        }
+    }
+
+    // Upper special group (low op 0x3C..0x3F).
+    // Like lower1 special, the real selector is not just bits 5:0.  Dobie decodes:
+    //   op = (instr & 0x3) | ((instr >> 4) & 0x7C)
+    // Several instructions in this group also use FT as the destination, not FD.
+    if (op >= 0x3Cu)
+    {
+        const uint8_t specialOp = static_cast<uint8_t>((upper & 0x3u) | ((upper >> 4) & 0x7Cu));
+        if (specialOp >= 0x10u && specialOp <= 0x13u) // ITOF0/4/12/15
+            return &VU1Interpreter::upperItof;
+        if (specialOp >= 0x14u && specialOp <= 0x17u) // FTOI0/4/12/15
+            return &VU1Interpreter::upperFtoi;
+        switch (specialOp)
+        {
+        case 0x1Du: // ABS
+            return &VU1Interpreter::upperAbs;
+        case 0x1Fu: // CLIP
+            return &VU1Interpreter::upperClip;
+        case 0x2Fu:
+        case 0x30u: // NOP
+            return &VU1Interpreter::upperNop;
+        default:
+            break;
+        }
+        if (const UpperHandler handler = Table::arithmetic<true>(specialOp, dest))
+            return handler;
     }
+
+    return &VU1Interpreter::upperReserved;
 }
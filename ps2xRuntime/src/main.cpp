@@ -219,6 +219,9 @@ int main(int argc, char *argv[])
             std::cerr << "Failed to initialize PS2 runtime" << std::endl;
             return 1;
         }
+#if defined(PS2X_GS_FRAME_SKIP_LIMIT)
+        runtime.gs().setFrameSkipLimit(PS2X_GS_FRAME_SKIP_LIMIT);
+#endif
 
         if (!runtime.loadELF(filePathStr))
         {
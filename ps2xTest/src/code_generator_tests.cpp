@@ -11,6 +11,10 @@
 
 using namespace ps2recomp;
 
+#ifndef PS2X_RECOMP_PRECISE_PC
+#define PS2X_RECOMP_PRECISE_PC 0
+#endif
+
 static Instruction makeBranch(uint32_t address, uint32_t targetOffsetWords)
 {
     Instruction inst;
@@ -155,6 +159,19 @@ static Instruction makeSyscall(uint32_t address)
     return inst;
 }
 
+static Instruction makeAddu(uint32_t address, uint8_t rd, uint8_t rs, uint8_t rt)
+{
+    Instruction inst{};
+    inst.address = address;
+    inst.opcode = OPCODE_SPECIAL;
+    inst.function = SPECIAL_ADDU;
+    inst.rs = rs;
+    inst.rt = rt;
+    inst.rd = rd;
+    inst.raw = (OPCODE_SPECIAL << 26) | (rs << 21) | (rt << 16) | (rd << 11) | SPECIAL_ADDU;
+    return inst;
+}
+
 static void printGeneratedCode(const std::string& name, const std::string& code)
 {
 #ifdef PRINT_GENERATED_CODE
@@ -196,6 +213,92 @@ void register_code_generator_tests()
                  "the continuation PC must be visible before a syscall can transfer to the scheduler");
     });
 
+#if !PS2X_RECOMP_PRECISE_PC
+    tc.Run("PC is only materialized before instructions that can observe it", [](TestCase &t) {
+        Function func;
+        func.name = "lazy_pc";
+        func.start = 0x9100;
+        func.end = 0x9110;
+        func.isRecompiled = true;
+
+        const std::vector<Instruction> instructions = {
+            makeAddiu(0x9100, 4, 4, 0x10),
+            makeLw(0x9104, 2, 4, 0),
+            makeOri(0x9108, 2, 2, 1),
+            makeSw(0x910C, 2, 4, 4),
+        };
+
+        CodeGenerator gen({}, {});
+        const std::string lazy = gen.generateFunction(func, instructions, false);
+        t.IsTrue(lazy.find("ctx->pc = 0x9100u;") != std::string::npos, "function entry should still publish its start PC");
+        t.IsTrue(lazy.find("ctx->pc = 0x9104u;") != std::string::npos, "loads should publish their PC");
+        t.IsTrue(lazy.find("ctx->pc = 0x9108u;") == std::string::npos, "register-only ops should not publish their PC");
+        t.IsTrue(lazy.find("ctx->pc = 0x910cu;") != std::string::npos, "stores should publish their PC");
+        t.IsTrue(lazy.find("ctx->pc = 0x9110u;") != std::string::npos, "fallthrough should still publish the next PC");
+
+        gen.setEmitPrecisePc(true);
+        const std::string precise = gen.generateFunction(func, instructions, false);
+        t.IsTrue(precise.find("ctx->pc = 0x9108u;") != std::string::npos, "precise PC mode should publish every instruction");
+        t.IsTrue(precise.size() > lazy.size(), "precise PC mode should emit more code");
+    });
+
+    tc.Run("pure delay slots skip the delay slot bookkeeping", [](TestCase &t) {
+        Function func;
+        func.name = "lazy_delay_slot";
+        func.start = 0x9200;
+        func.end = 0x9210;
+        func.isRecompiled = true;
+
+        Symbol targetSym;
+        targetSym.name = "callee";
+        targetSym.address = 0x9800;
+        targetSym.isFunction = true;
+
+        CodeGenerator gen({targetSym}, {});
+        const std::string pure = gen.generateFunction(
+            func, {makeJal(0x9200, 0x9800), makeAddiu(0x9204, 4, 0, 1)}, false);
+        t.IsTrue(pure.find("ctx->pc = 0x9204u;") == std::string::npos, "an ALU delay slot should not publish its PC");
+        t.IsTrue(pure.find("ctx->in_delay_slot = true;") == std::string::npos, "an ALU delay slot cannot fault");
+
+        const std::string memory = gen.generateFunction(
+            func, {makeJal(0x9200, 0x9800), makeSw(0x9204, 4, 29, 0)}, false);
+        t.IsTrue(memory.find("ctx->pc = 0x9204u;") != std::string::npos, "a store in the delay slot should publish its PC");
+        t.IsTrue(memory.find("ctx->branch_pc = 0x9200u;") != std::string::npos, "a store in the delay slot should record the branch");
+    });
+
+    tc.Run("PC observation is decided per opcode and function", [](TestCase &t) {
+        Function func;
+        func.name = "pc_table";
+        func.start = 0x9300;
+        func.end = 0x9310;
+        func.isRecompiled = true;
+
+        Instruction add = makeAddu(0x9304, 2, 4, 5);
+        add.function = SPECIAL_ADD;
+        add.raw = (add.raw & ~0x3Fu) | SPECIAL_ADD;
+
+        Instruction pmthl{};
+        pmthl.address = 0x9308;
+        pmthl.opcode = OPCODE_MMI;
+        pmthl.isMMI = true;
+        pmthl.function = MMI_PMTHL;
+        pmthl.sa = 1;
+        pmthl.raw = (OPCODE_MMI << 26) | (1u << 6) | MMI_PMTHL;
+
+        CodeGenerator gen({}, {});
+        const std::string code = gen.generateFunction(
+            func, {makeAddu(0x9300, 2, 4, 5), add, pmthl, makeIType(0x930C, OPCODE_ADDI, 4, 2, 1)}, false);
+        t.IsTrue(code.find("ctx->pc = 0x9300u;") != std::string::npos, "function entry should still publish its start PC");
+        t.IsTrue(code.find("ctx->pc = 0x9304u;") != std::string::npos, "trapping ADD should publish its PC");
+        t.IsTrue(code.find("ctx->pc = 0x9308u;") != std::string::npos, "unhandled MMI subfunctions should publish their PC");
+        t.IsTrue(code.find("ctx->pc = 0x930cu;") != std::string::npos, "trapping ADDI should publish its PC");
+
+        const std::string pure = gen.generateFunction(
+            func, {makeAddu(0x9300, 2, 4, 5), makeAddu(0x9304, 3, 4, 5)}, false);
+        t.IsTrue(pure.find("ctx->pc = 0x9304u;") == std::string::npos, "ADDU should not publish its PC");
+    });
+#endif
+
     tc.Run("R5900 MULT writes rd when rd is non-zero", [](TestCase &t) {
         CodeGenerator gen({}, {});
 
@@ -285,6 +388,109 @@ void register_code_generator_tests()
                  "constant RDRAM SW should not go through WRITE32 address classification");
     });
 
+    tc.Run("constant base survives a loop head", [](TestCase &t) {
+        Function func;
+        func.name = "loop_constant_base";
+        func.start = 0x3000;
+        func.end = 0x3014;
+        func.isRecompiled = true;
+
+        std::vector<Instruction> instructions;
+        instructions.push_back(makeLui(0x3000, 4, 0x0012));
+        instructions.push_back(makeLw(0x3004, 3, 4, 0x0010));
+        instructions.push_back(makeAddiu(0x3008, 5, 5, 1));
+        instructions.push_back(makeBranch(0x300C, static_cast<uint32_t>(-3))); // target = 0x3004
+        instructions.push_back(makeNop(0x3010));
+
+        CodeGenerator gen({}, {});
+        std::string generated = gen.generateFunction(func, instructions, false);
+        printGeneratedCode("constant base survives a loop head", generated);
+
+        t.IsTrue(generated.find("label_3004:") != std::string::npos,
+                 "loop head should be labelled");
+        t.IsTrue(generated.find("FAST_READ32(0x120010u)") != std::string::npos,
+                 "LW at the loop head should keep the constant base from before the loop");
+    });
+
+    tc.Run("resume entry at a local branch target does not fold a constant base", [](TestCase &t) {
+        Function func;
+        func.name = "resume_constant_base";
+        func.start = 0x3100;
+        func.end = 0x3114;
+        func.isRecompiled = true;
+
+        std::vector<Instruction> instructions;
+        instructions.push_back(makeLui(0x3100, 4, 0x0012));
+        instructions.push_back(makeLw(0x3104, 3, 4, 0x0010));
+        instructions.push_back(makeAddiu(0x3108, 5, 5, 1));
+        instructions.push_back(makeBranch(0x310C, static_cast<uint32_t>(-3))); // target = 0x3104
+        instructions.push_back(makeNop(0x3110));
+
+        CodeGenerator gen({}, {});
+        gen.setResumeEntryTargets({{0x3100u, {0x3104u}}});
+        std::string generated = gen.generateFunction(func, instructions, false);
+        printGeneratedCode("resume entry at a local branch target does not fold a constant base", generated);
+
+        t.IsTrue(generated.find("label_3104:") != std::string::npos,
+                 "the resume target should be labelled");
+        t.IsTrue(generated.find("FAST_READ32(0x120010u)") == std::string::npos,
+                 "a resume entry can arrive with any $a0, so the LW must not use a literal address");
+        t.IsTrue(generated.find("GPR_U32(ctx, 4)") != std::string::npos,
+                 "the LW should read its base from the register");
+    });
+
+    tc.Run("stack relative access uses fast RDRAM access", [](TestCase &t) {
+        Function func;
+        func.name = "stack_access";
+        func.start = 0x4000;
+        func.end = 0x400C;
+        func.isRecompiled = true;
+
+        std::vector<Instruction> instructions;
+        instructions.push_back(makeAddiu(0x4000, 29, 29, static_cast<uint16_t>(-32)));
+        instructions.push_back(makeSw(0x4004, 4, 29, 0x0010));
+        instructions.push_back(makeLw(0x4008, 3, 29, 0x0014));
+
+        CodeGenerator gen({}, {});
+        std::string generated = gen.generateFunction(func, instructions, false);
+        printGeneratedCode("stack relative access uses fast RDRAM access", generated);
+
+        t.IsTrue(generated.find("FAST_READ32(ADD32(GPR_U32(ctx, 29), 20))") != std::string::npos,
+                 "$sp-relative LW should skip the special address check");
+        t.IsTrue(generated.find("FAST_WRITE32(_addr, _value);") != std::string::npos,
+                 "$sp-relative SW should skip the special address check");
+        t.IsTrue(generated.find("(int32_t)READ32(") == std::string::npos,
+                 "$sp-relative LW should not go through READ32");
+
+        CodeGenerator checked({}, {});
+        checked.setAssumeRdramStackAndGp(false);
+        generated = checked.generateFunction(func, instructions, false);
+        t.IsTrue(generated.find("SET_GPR_S32(ctx, 3, (int32_t)READ32(ADD32(GPR_U32(ctx, 29), 20)));") != std::string::npos,
+                 "without the RDRAM stack assumption the LW should keep the address check");
+        t.IsTrue(generated.find("WRITE32(ADD32(GPR_U32(ctx, 29), 16), GPR_U32(ctx, 4));") != std::string::npos,
+                 "without the RDRAM stack assumption the SW should keep the address check");
+    });
+
+    tc.Run("scratchpad base with unknown index emits direct runtime access", [](TestCase &t) {
+        Function func;
+        func.name = "scratchpad_access";
+        func.start = 0x5000;
+        func.end = 0x500C;
+        func.isRecompiled = true;
+
+        std::vector<Instruction> instructions;
+        instructions.push_back(makeLui(0x5000, 4, 0x7000));
+        instructions.push_back(makeAddu(0x5004, 4, 4, 5));
+        instructions.push_back(makeLw(0x5008, 3, 4, 0x0040));
+
+        CodeGenerator gen({}, {});
+        std::string generated = gen.generateFunction(func, instructions, false);
+        printGeneratedCode("scratchpad base with unknown index emits direct runtime access", generated);
+
+        t.IsTrue(generated.find("runtime->Load32(rdram, ctx, ADD32(GPR_U32(ctx, 4), 64))") != std::string::npos,
+                 "scratchpad-relative LW should call the runtime without classifying the address");
+    });
+
     tc.Run("known GIF DMA MMIO sequence emits native kick helper", [](TestCase &t) {
         Function func;
         func.name = "gif_dma_kick";
@@ -773,32 +979,6 @@ void register_code_generator_tests()
             t.IsTrue(generated.find("goto label_") == std::string::npos, "external jump should not use goto");
         });
 
-        tc.Run("renamed function used in jump table", [](TestCase &t) {
-            Function func;
-            func.name = "jt_func";
-            func.start = 0x7000;
-            func.end = 0x7010;
-            func.isRecompiled = true;
-            func.isStub = false;
-
-            JumpTableEntry entry;
-            entry.index = 0;
-            entry.target = 0x8000;
-            std::vector<JumpTableEntry> entries{entry};
-
-            Instruction inst{};
-            inst.opcode = OPCODE_REGIMM;
-
-            CodeGenerator gen({}, {});
-            gen.setRenamedFunctions({{0x8000, "renamed_target"}});
-
-            std::string sw = gen.generateJumpTableSwitch(inst, 0x0, entries);
-            printGeneratedCode("renamed function used in jump table", sw);
-
-        t.IsTrue(sw.find("renamed_target(rdram, ctx, runtime);") != std::string::npos,
-                 "jump table should use renamed function name");
-        });
-
         tc.Run("reserved identifiers are sanitized and used in calls", [](TestCase &t) {
             Function func;
             func.name = "__is_pointer";
@@ -1360,19 +1540,83 @@ void register_code_generator_tests()
 
             // Expect:
             // SET_GPR_U32(ctx, 31, 0xA008u);
-            // ctx->pc = 0xA004u;
             // ... delay slot ...
-            // runtime->dispatchGuestBranch(..., DirectCall, "JAL")
+            // if (ps2GuestFunctionAt(0xB000u) == &some_func) { some_func(...); pc check }
+            // else runtime->dispatchGuestBranch(..., DirectCall, "JAL")
 
             t.IsTrue(generated.find("SET_GPR_U32(ctx, 31, 0xA008u);") != std::string::npos, "JAL should set RA");
+            t.IsTrue(generated.find("if (ps2GuestFunctionAt(0xB000u) == &some_func) {") != std::string::npos,
+                     "JAL should call the named function while the table still holds it");
+            t.IsTrue(generated.find("    some_func(rdram, ctx, runtime);") != std::string::npos,
+                     "JAL should call the named function directly");
+            t.IsTrue(generated.find("if (ctx->pc != 0xA008u && ctx->pc != 0xB000u) {") != std::string::npos,
+                     "a direct call to an unproven callee should check where it returned");
             t.IsTrue(generated.find("runtime->dispatchGuestBranch(rdram, ctx, 0xB000u") != std::string::npos,
-                     "JAL should dispatch through the runtime branch helper");
+                     "an overridden callee should still dispatch through the runtime branch helper");
             t.IsTrue(generated.find("PS2Runtime::GuestBranchKind::DirectCall") != std::string::npos,
                      "JAL should identify itself as a direct call");
             t.IsTrue(generated.find("0xA000u, 0xA008u") != std::string::npos,
                      "JAL should pass call-site and fallthrough PCs to the runtime helper");
         });
 
+        tc.Run("JAL to a clean callee skips the return check", [](TestCase &t) {
+            Function callee;
+            callee.name = "clean_leaf";
+            callee.start = 0xB100;
+            callee.end = 0xB118;
+            callee.isRecompiled = true;
+
+            Instruction skip = makeBranch(0xB104, 2); // target = 0xB110
+            skip.rs = 4;
+            skip.rt = 0;
+            const std::vector<Instruction> calleeInstructions{
+                makeAddiu(0xB100, 2, 4, 1),
+                skip,
+                makeNop(0xB108),
+                makeAddiu(0xB10C, 2, 2, 1),
+                makeJr(0xB110, 31),
+                makeNop(0xB114)};
+            t.IsTrue(isCleanCallee(callee, calleeInstructions),
+                     "a forward-branching leaf ending in JR $ra should be clean");
+
+            std::vector<Instruction> looping = calleeInstructions;
+            looping[1].simmediate = static_cast<uint32_t>(-2); // target = 0xB100
+            t.IsFalse(isCleanCallee(callee, looping), "a backward branch can yield at the EE checkpoint");
+
+            std::vector<Instruction> calling = calleeInstructions;
+            calling[3] = makeJal(0xB10C, 0xC000);
+            t.IsFalse(isCleanCallee(callee, calling), "a nested call is not proven clean");
+
+            std::vector<Instruction> savingRa = calleeInstructions;
+            savingRa[3] = makeLw(0xB10C, 31, 29, 0);
+            t.IsFalse(isCleanCallee(callee, savingRa), "rewriting $ra breaks the return proof");
+
+            Function func;
+            func.name = "clean_caller";
+            func.start = 0xA100;
+            func.end = 0xA108;
+            func.isRecompiled = true;
+
+            Symbol target;
+            target.name = "clean_leaf";
+            target.address = callee.start;
+            target.isFunction = true;
+
+            CodeGenerator gen({target}, {});
+            gen.setCleanCallTargets({callee.start});
+            const std::string generated = gen.generateFunction(func, {makeJal(0xA100, 0xB100), makeNop(0xA104)}, false);
+            printGeneratedCode("JAL to a clean callee skips the return check", generated);
+
+            t.IsTrue(generated.find("    clean_leaf(rdram, ctx, runtime);") != std::string::npos,
+                     "clean callee should be called directly");
+            t.IsTrue(generated.find("if (ctx->pc != 0xA108u && ctx->pc != 0xB100u)") == std::string::npos,
+                     "clean callee should not need a return check");
+            t.IsTrue(generated.find("#if defined(PS2X_STRICT_CALL_DIAGNOSTICS) && PS2X_STRICT_CALL_DIAGNOSTICS") != std::string::npos,
+                     "clean calls should keep an opt-in assertion of the proof");
+            t.IsTrue(generated.find("runtime->reportUncleanCall(ctx, 0xB100u, 0xA100u, 0xA108u);") != std::string::npos,
+                     "the assertion should report the callee, call site and expected return");
+        });
+
         tc.Run("JAL to a resolved syscall publishes fallthrough before the handler", [](TestCase &t) {
             Function func;
             func.name = "jal_syscall_resume";
@@ -1498,7 +1742,7 @@ void register_code_generator_tests()
 
             t.IsTrue(generated.find("const uint32_t jumpTarget = GPR_U32(ctx, 4);") != std::string::npos, "JALR should read target from RS");
             t.IsTrue(generated.find("SET_GPR_U32(ctx, 31, 0xD008u);") != std::string::npos, "JALR should set link register");
-            t.IsTrue(generated.find("runtime->dispatchGuestBranch(rdram, ctx, jumpTarget") != std::string::npos, "JALR should dispatch through runtime branch helper");
+            t.IsTrue(generated.find("runtime->dispatchCachedGuestBranch(rdram, ctx, jumpTarget") != std::string::npos, "JALR should dispatch through the cached runtime branch helper");
             t.IsTrue(generated.find("PS2Runtime::GuestBranchKind::IndirectCall") != std::string::npos,
                      "JALR should identify itself as an indirect call");
             t.IsTrue(generated.find("0xD000u, 0xD008u") != std::string::npos,
@@ -1692,6 +1936,10 @@ void register_code_generator_tests()
                      "unresolved JR should hand the dynamic target back through ctx->pc");
             t.IsTrue(generated.find("PS2Runtime::GuestBranchKind::IndirectJump") != std::string::npos,
                      "unresolved non-RA JR should use indirect-jump diagnostics");
+            t.IsTrue(generated.find("static PS2Runtime::GuestBranchCache branchCache_0x1404;") != std::string::npos,
+                     "unresolved non-RA JR should keep a per-callsite inline cache");
+            t.IsTrue(generated.find("\"JR\", branchCache_0x1404)") != std::string::npos,
+                     "JR dispatch should pass its own inline cache");
         });
 
         tc.Run("configured jump table addresses drive JR dispatch targets", [](TestCase &t) {
@@ -1783,6 +2031,69 @@ void register_code_generator_tests()
                      "configured table should avoid broad JR fallback labels");
         });
 
+        tc.Run("rodata jump table dispatches on the table slot", [](TestCase &t) {
+            Function func;
+            func.name = "jr_rodata_jump_table";
+            func.start = 0x1700;
+            func.end = 0x1740;
+            func.isRecompiled = true;
+            func.isStub = false;
+
+            constexpr uint32_t tableAddress = 0x00200000u;
+            uint32_t tableData[] = {0x1720u, 0x1730u, 0x9000u};
+
+            Section rodata{};
+            rodata.name = ".rodata";
+            rodata.address = tableAddress;
+            rodata.size = sizeof(tableData);
+            rodata.isData = true;
+            rodata.isReadOnly = true;
+            rodata.data = reinterpret_cast<uint8_t *>(tableData);
+            const std::vector<Section> sections{rodata};
+
+            Instruction sll{};
+            sll.address = 0x1708;
+            sll.opcode = OPCODE_SPECIAL;
+            sll.function = SPECIAL_SLL;
+            sll.rd = 8;
+            sll.rt = 4;
+            sll.sa = 2;
+
+            std::vector<Instruction> instructions{
+                makeIType(0x1700, OPCODE_SLTIU, 4, 2, 3),
+                makeLui(0x1704, 9, static_cast<uint16_t>(tableAddress >> 16)),
+                sll,
+                makeAddu(0x170C, 9, 9, 8),
+                makeLw(0x1710, 10, 9, 0),
+                makeJr(0x1714, 10),
+                makeNop(0x1718),
+                makeNop(0x171C),
+                makeNop(0x1720),
+                makeNop(0x1730)};
+
+            CodeGenerator gen({}, sections);
+            std::string generated = gen.generateFunction(func, instructions, false);
+            printGeneratedCode("rodata jump table dispatches on the table slot", generated);
+
+            t.IsTrue(generated.find("const uint32_t jumpSlot = (GPR_U32(ctx, 9) - 0x200000u) >> 2;") != std::string::npos,
+                     "JR should recover the table slot from the LW base register");
+            t.IsTrue(generated.find("case 0u: if (jumpTarget == 0x1720u) goto label_1720; break;") != std::string::npos,
+                     "slot 0 should branch straight to its label");
+            t.IsTrue(generated.find("case 1u: if (jumpTarget == 0x1730u) goto label_1730; break;") != std::string::npos,
+                     "slot 1 should branch straight to its label");
+            t.IsTrue(generated.find("case 2u:") == std::string::npos,
+                     "external table targets should be left to the dispatcher");
+            t.IsTrue(generated.find("switch (ctx->pc)") == std::string::npos,
+                     "local table targets should not become dispatcher resume sites");
+
+            instructions[6] = makeAddiu(0x1718, 9, 9, 4);
+            generated = gen.generateFunction(func, instructions, false);
+            t.IsTrue(generated.find("jumpSlot") == std::string::npos,
+                     "a delay slot that rewrites the base register should fall back to the target switch");
+            t.IsTrue(generated.find("case 0x1720u: goto label_1720;") != std::string::npos,
+                     "target switch should still reach the local labels");
+        });
+
         tc.Run("unresolved JALR uses runtime dispatch without broad local switch", [](TestCase &t) {
             Function func;
             func.name = "jalr_runtime_fallback";
@@ -1805,8 +2116,8 @@ void register_code_generator_tests()
 
             t.IsFalse(generated.find("switch (jumpTarget)") != std::string::npos,
                       "unresolved JALR should not emit a broad local switch over every internal label");
-            t.IsTrue(generated.find("runtime->dispatchGuestBranch(rdram, ctx, jumpTarget") != std::string::npos,
-                     "unresolved JALR should dispatch through the runtime branch helper");
+            t.IsTrue(generated.find("runtime->dispatchCachedGuestBranch(rdram, ctx, jumpTarget") != std::string::npos,
+                     "unresolved JALR should dispatch through the cached runtime branch helper");
             t.IsTrue(generated.find("PS2Runtime::GuestBranchKind::IndirectCall") != std::string::npos,
                      "JALR should retain indirect-call dispatch kind");
             t.IsTrue(generated.find("0x1514u, 0x151Cu") != std::string::npos,
@@ -3,6 +3,7 @@
 #include "ps2_runtime.h"
 #include "ps2_stubs.h"
 #include "ps2_syscalls.h"
+#include "runtime/gs/gs_cpu_backend.h"
 #include "runtime/gs/gs_frontend.h"
 #include "runtime/ee_scheduler.h"
 #include "runtime/gs/ps2_gs_memory.h"
@@ -12,10 +13,12 @@
 #include "Stubs/Helpers/Support.h"
 #include "Stubs/GS.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -88,6 +91,39 @@ namespace
         appendU64(dst, reg);
     }
 
+    void fillVramPattern(std::vector<uint8_t> &bytes, uint32_t seed)
+    {
+        for (uint8_t &byte : bytes)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<uint8_t>(seed >> 24u);
+        }
+    }
+
+    uint32_t decodeTransferPixel(const std::vector<uint8_t> &payload, uint32_t bits, uint32_t pixel)
+    {
+        switch (bits)
+        {
+        case 32u:
+        {
+            uint32_t value = 0u;
+            std::memcpy(&value, payload.data() + pixel * 4u, sizeof(value));
+            return value;
+        }
+        case 24u:
+            return static_cast<uint32_t>(payload[pixel * 3u]) |
+                   (static_cast<uint32_t>(payload[pixel * 3u + 1u]) << 8u) |
+                   (static_cast<uint32_t>(payload[pixel * 3u + 2u]) << 16u);
+        case 16u:
+            return static_cast<uint32_t>(payload[pixel * 2u]) |
+                   (static_cast<uint32_t>(payload[pixel * 2u + 1u]) << 8u);
+        case 8u:
+            return payload[pixel];
+        default:
+            return (payload[pixel >> 1u] >> ((pixel & 1u) * 4u)) & 0x0Fu;
+        }
+    }
+
     template <typename Predicate>
     bool waitUntil(Predicate pred, std::chrono::milliseconds timeout)
     {
@@ -734,6 +770,63 @@ void register_ps2_gs_tests()
                      "context-targeted clear should leave the other context framebuffer untouched");
         });
 
+        tc.Run("GS frame skip drops display-buffer draws only while behind and within the limit", [](TestCase &t)
+        {
+            std::vector<uint8_t> vram(PS2_GS_VRAM_SIZE, 0u);
+            GSRegisters regs{};
+            regs.dispfb1 = 1ull << 9; // FBP=0, FBW=1
+            GS gs;
+            gs.init(vram.data(), static_cast<uint32_t>(vram.size()), &regs);
+            gs.setFrameSkipLimit(2u);
+
+            constexpr uint32_t kOffscreenFbp = 150u;
+            gs.writeRegister(GS_REG_FRAME_1, 1ull << 16);
+            gs.writeRegister(GS_REG_FRAME_2, kOffscreenFbp | (1ull << 16));
+            gs.writeRegister(GS_REG_ZBUF_1, 1ull << 32);
+            gs.writeRegister(GS_REG_ZBUF_2, 1ull << 32);
+            gs.writeRegister(GS_REG_SCISSOR_1, 0ull);
+            gs.writeRegister(GS_REG_SCISSOR_2, 0ull);
+            gs.writeRegister(GS_REG_TEST_1, 0x30000ull);
+            gs.writeRegister(GS_REG_TEST_2, 0x30000ull);
+
+            auto drawPoint = [&gs](uint32_t ctxt, uint8_t red)
+            {
+                gs.writeRegister(GS_REG_PRIM, static_cast<uint64_t>(GS_PRIM_POINT) | (static_cast<uint64_t>(ctxt) << 9));
+                gs.writeRegister(GS_REG_RGBAQ, static_cast<uint64_t>(red) | (0x80ull << 24));
+                gs.writeRegister(GS_REG_XYZ2, 0ull);
+            };
+
+            // Nothing is skipped before the warmup has seen the display settle.
+            for (uint32_t i = 0; i < 120u; ++i)
+                gs.beginFrame(true);
+            t.IsFalse(gs.isSkippingFrame(), "frame skip should wait for the warmup period");
+
+            gs.beginFrame(true);
+            t.IsTrue(gs.isSkippingFrame(), "a late frame past the warmup should be skipped");
+            drawPoint(0u, 0x11u);
+            t.Equals(gs.ReadVram(GS_PSM_CT32, 0u, 1u, 0u, 0u), 0u,
+                     "draws into the displayed buffer should be dropped while skipping");
+            drawPoint(1u, 0x22u);
+            t.Equals(gs.ReadVram(GS_PSM_CT32, kOffscreenFbp << 5, 1u, 0u, 0u) & 0xFFu, 0x22u,
+                     "off-screen render targets should still be drawn while skipping");
+
+            gs.beginFrame(true);
+            t.IsTrue(gs.isSkippingFrame(), "a second late frame is within the limit");
+            gs.beginFrame(true);
+            t.IsFalse(gs.isSkippingFrame(), "the limit should force a drawn frame");
+            drawPoint(0u, 0x33u);
+            t.Equals(gs.ReadVram(GS_PSM_CT32, 0u, 1u, 0u, 0u) & 0xFFu, 0x33u,
+                     "draws should land when the frame is not skipped");
+            t.Equals(gs.skippedFrameCount(), static_cast<uint64_t>(2u), "skipped frames should be counted");
+
+            gs.beginFrame(true);
+            t.IsTrue(gs.isSkippingFrame(), "skipping should resume after a drawn frame");
+            gs.writeRegister(GS_REG_TRXDIR, 1ull);
+            t.IsFalse(gs.isSkippingFrame(), "a local-to-host readback should cancel the skip");
+            gs.beginFrame(true);
+            t.IsFalse(gs.isSkippingFrame(), "frame skip should stay off once the guest reads VRAM back");
+        });
+
         tc.Run("XYZ3 culls a triangle strip primitive without desynchronizing the vertex queue", [](TestCase &t)
         {
             std::vector<uint8_t> vram(PS2_GS_VRAM_SIZE, 0u);
@@ -1302,6 +1395,59 @@ void register_ps2_gs_tests()
                      "relatching should pick up the updated source frame contents");
         });
 
+        tc.Run("host presentation latch hands off pooled frames by sequence", [](TestCase &t)
+        {
+            std::vector<uint8_t> vram(PS2_GS_VRAM_SIZE, 0u);
+            GSRegisters regs{};
+            regs.pmode = 1ull;
+            regs.dispfb1 =
+                150ull |
+                (10ull << 9) |
+                (static_cast<uint64_t>(GS_PSM_CT32) << 15);
+            regs.display1 =
+                (639ull << 32) |
+                (447ull << 44);
+
+            GS gs;
+            gs.init(vram.data(), static_cast<uint32_t>(vram.size()), &regs);
+            writeReferenceFramePSMCT32Pixel(vram, 150u, 10u, 0u, 0u, 0x00332211u);
+
+            uint64_t sequence = 0u;
+            t.IsTrue(gs.acquireHostPresentationFrame(&sequence) == nullptr,
+                     "no frame should be handed out before the first latch");
+
+            std::vector<const uint8_t *> storage;
+            uint64_t lastSequence = 0u;
+            bool sequencesAdvance = true;
+            for (uint32_t i = 0; i < 8u; ++i)
+            {
+                gs.latchHostPresentationFrame();
+                const PresentationFrame *frame = gs.acquireHostPresentationFrame(&sequence);
+                if (!frame)
+                {
+                    t.IsTrue(false, "every latch should publish a frame");
+                    return;
+                }
+                sequencesAdvance = sequencesAdvance && sequence > lastSequence;
+                lastSequence = sequence;
+                if (std::find(storage.begin(), storage.end(), frame->pixels.data()) == storage.end())
+                    storage.push_back(frame->pixels.data());
+
+                t.Equals(frame->width, 640u, "pooled frame should keep the display width");
+                t.Equals(static_cast<uint32_t>(frame->pixels[0]), 0x11u, "pooled frame should hold the display pixels");
+            }
+            t.IsTrue(sequencesAdvance, "each latch should advance the presentation sequence");
+            t.IsTrue(storage.size() <= 3u, "latches should cycle through the three pooled frame buffers");
+
+            const PresentationFrame *again = gs.acquireHostPresentationFrame(&sequence);
+            t.IsTrue(again != nullptr && sequence == lastSequence,
+                     "acquiring without a new latch should return the same frame and sequence");
+
+            gs.reset();
+            t.IsTrue(gs.acquireHostPresentationFrame() == nullptr,
+                     "frames latched before a reset should not be presented");
+        });
+
         tc.Run("latched host presentation frame is returned tightly packed for narrower display widths", [](TestCase &t)
         {
             std::vector<uint8_t> vram(PS2_GS_VRAM_SIZE, 0u);
@@ -2359,6 +2505,226 @@ void register_ps2_gs_tests()
             t.Equals(out[1], static_cast<uint8_t>(0x43u), "packed nibble byte 1 should roundtrip");
         });
 
+        tc.Run("GS host-to-local block uploads match per-pixel writes for every PSM", [](TestCase &t)
+        {
+            const uint8_t psms[] = {
+                GS_PSM_CT32, GS_PSM_CT24, GS_PSM_CT16, GS_PSM_CT16S, GS_PSM_T8, GS_PSM_T4, GS_PSM_T8H,
+                GS_PSM_T4HL, GS_PSM_T4HH, GS_PSM_Z32, GS_PSM_Z24, GS_PSM_Z16, GS_PSM_Z16S,
+            };
+            struct Rect
+            {
+                uint32_t bp;
+                uint8_t bw;
+                uint16_t x;
+                uint16_t y;
+                uint16_t w;
+                uint16_t h;
+            };
+            const Rect rects[] = {
+                {0u, 4u, 0u, 0u, 64u, 32u},   // whole blocks only
+                {64u, 4u, 5u, 3u, 45u, 37u},  // ragged edges on every side
+                {7u, 2u, 16u, 16u, 48u, 16u}, // base not page aligned
+                {32u, 1u, 40u, 0u, 48u, 24u}, // wider than the buffer
+            };
+
+            std::vector<uint8_t> fastVram(PS2_GS_VRAM_SIZE, 0u);
+            std::vector<uint8_t> refVram(PS2_GS_VRAM_SIZE, 0u);
+            GSCpuBackend fast;
+            GSCpuBackend reference;
+            fast.Initialize(fastVram.data(), static_cast<uint32_t>(fastVram.size()));
+            reference.Initialize(refVram.data(), static_cast<uint32_t>(refVram.size()));
+
+            uint32_t seed = 1u;
+            for (const uint8_t psm : psms)
+            {
+                const uint32_t bits = static_cast<uint32_t>(GSMem::BitsPerPixel(static_cast<GSMem::PixelStorageMode>(psm)));
+                for (const Rect &rect : rects)
+                {
+                    fillVramPattern(fastVram, seed++);
+                    std::memcpy(refVram.data(), fastVram.data(), refVram.size());
+
+                    GSTransferCommand command{};
+                    command.bitbltbuf.dbp = rect.bp;
+                    command.bitbltbuf.dbw = rect.bw;
+                    command.bitbltbuf.dpsm = psm;
+                    command.trxpos.dsax = rect.x;
+                    command.trxpos.dsay = rect.y;
+                    command.trxreg.rrw = rect.w;
+                    command.trxreg.rrh = rect.h;
+                    command.direction = 0u;
+                    fast.BeginTransfer(command);
+
+                    const uint32_t total = static_cast<uint32_t>(rect.w) * rect.h;
+                    std::vector<uint8_t> payload((total * bits + 7u) / 8u);
+                    fillVramPattern(payload, seed++);
+
+                    // Uneven packet sizes split rows and block bands, but stay
+                    // multiples of every pixel size.
+                    const uint32_t chunks[] = {48u, 480u, 96u, 1776u};
+                    uint32_t offset = 0u;
+                    for (uint32_t i = 0u; offset < payload.size(); ++i)
+                    {
+                        const uint32_t size = std::min<uint32_t>(chunks[i % 4u], static_cast<uint32_t>(payload.size()) - offset);
+                        fast.UploadImage(payload.data() + offset, size);
+                        offset += size;
+                    }
+
+                    for (uint32_t pixel = 0u; pixel < total; ++pixel)
+                    {
+                        reference.WriteVram(psm, rect.bp, rect.bw, rect.x + pixel % rect.w, rect.y + pixel / rect.w,
+                                            decodeTransferPixel(payload, bits, pixel));
+                    }
+
+                    const GSTransferSnapshot snapshot = fast.GetTransferSnapshot();
+                    const bool same = std::memcmp(fastVram.data(), refVram.data(), fastVram.size()) == 0;
+                    t.IsTrue(same, "upload should match per-pixel writes for psm " + std::to_string(psm) +
+                                       " at bp " + std::to_string(rect.bp));
+                    t.Equals(snapshot.direction, 3u, "upload should complete once every pixel arrived");
+                    t.Equals(snapshot.copiedPixels, total, "upload should account for every pixel");
+                }
+            }
+        });
+
+        tc.Run("GS local-to-local row copies match per-pixel copies", [](TestCase &t)
+        {
+            struct Copy
+            {
+                uint8_t spsm;
+                uint32_t sbp;
+                uint8_t sbw;
+                uint16_t ssax;
+                uint16_t ssay;
+                uint8_t dpsm;
+                uint32_t dbp;
+                uint8_t dbw;
+                uint16_t dsax;
+                uint16_t dsay;
+                uint16_t w;
+                uint16_t h;
+                uint8_t dir;
+            };
+            const Copy copies[] = {
+                {GS_PSM_CT32, 0u, 4u, 3u, 2u, GS_PSM_CT32, 512u, 4u, 9u, 1u, 40u, 20u, 0u},
+                {GS_PSM_CT16, 0u, 2u, 0u, 0u, GS_PSM_CT32, 256u, 2u, 0u, 0u, 64u, 16u, 1u},
+                {GS_PSM_T8, 96u, 2u, 7u, 5u, GS_PSM_T4HH, 0u, 1u, 0u, 0u, 33u, 9u, 0u},
+                // overlapping copies have to keep the GS pixel order
+                {GS_PSM_CT32, 0u, 1u, 0u, 0u, GS_PSM_CT32, 0u, 1u, 1u, 0u, 32u, 8u, 0u},
+                {GS_PSM_CT32, 0u, 1u, 1u, 1u, GS_PSM_CT32, 0u, 1u, 0u, 0u, 32u, 8u, 3u},
+                {GS_PSM_CT32, 0u, 2u, 0u, 0u, GS_PSM_CT24, 512u, 2u, 4u, 4u, 20u, 12u, 2u},
+            };
+
+            std::vector<uint8_t> fastVram(PS2_GS_VRAM_SIZE, 0u);
+            std::vector<uint8_t> refVram(PS2_GS_VRAM_SIZE, 0u);
+            GSCpuBackend fast;
+            GSCpuBackend reference;
+            fast.Initialize(fastVram.data(), static_cast<uint32_t>(fastVram.size()));
+            reference.Initialize(refVram.data(), static_cast<uint32_t>(refVram.size()));
+
+            uint32_t seed = 7u;
+            for (const Copy &copy : copies)
+            {
+                fillVramPattern(fastVram, seed++);
+                std::memcpy(refVram.data(), fastVram.data(), refVram.size());
+
+                GSTransferCommand command{};
+                command.bitbltbuf.sbp = copy.sbp;
+                command.bitbltbuf.sbw = copy.sbw;
+                command.bitbltbuf.spsm = copy.spsm;
+                command.bitbltbuf.dbp = copy.dbp;
+                command.bitbltbuf.dbw = copy.dbw;
+                command.bitbltbuf.dpsm = copy.dpsm;
+                command.trxpos.ssax = copy.ssax;
+                command.trxpos.ssay = copy.ssay;
+                command.trxpos.dsax = copy.dsax;
+                command.trxpos.dsay = copy.dsay;
+                command.trxpos.dir = copy.dir;
+                command.trxreg.rrw = copy.w;
+                command.trxreg.rrh = copy.h;
+                command.direction = 2u;
+                fast.BeginTransfer(command);
+
+                for (uint32_t pixel = 0u; pixel < static_cast<uint32_t>(copy.w) * copy.h; ++pixel)
+                {
+                    uint32_t x = pixel % copy.w;
+                    uint32_t y = pixel / copy.w;
+                    if ((copy.dir & 0x2u) != 0u)
+                        x = copy.w - x - 1u;
+                    if ((copy.dir & 0x1u) != 0u)
+                        y = copy.h - y - 1u;
+                    const uint32_t value = reference.ReadVram(copy.spsm, copy.sbp, copy.sbw, x + copy.ssax, y + copy.ssay);
+                    reference.WriteVram(copy.dpsm, copy.dbp, copy.dbw, x + copy.dsax, y + copy.dsay, value);
+                }
+
+                const bool same = std::memcmp(fastVram.data(), refVram.data(), fastVram.size()) == 0;
+                t.IsTrue(same, "local->local copy should match per-pixel copy from psm " + std::to_string(copy.spsm) +
+                                   " to psm " + std::to_string(copy.dpsm));
+            }
+        });
+
+        tc.Run("GS local-to-host row reads match per-pixel reads", [](TestCase &t)
+        {
+            const uint8_t psms[] = {GS_PSM_CT32, GS_PSM_CT24, GS_PSM_CT16S, GS_PSM_T8, GS_PSM_T4, GS_PSM_T4HL, GS_PSM_Z24};
+
+            std::vector<uint8_t> vram(PS2_GS_VRAM_SIZE, 0u);
+            fillVramPattern(vram, 99u);
+            GSCpuBackend backend;
+            backend.Initialize(vram.data(), static_cast<uint32_t>(vram.size()));
+
+            for (const uint8_t psm : psms)
+            {
+                // odd width and height so T4 bytes straddle rows
+                GSTransferCommand command{};
+                command.bitbltbuf.sbp = 35u;
+                command.bitbltbuf.sbw = 2u;
+                command.bitbltbuf.spsm = psm;
+                command.trxpos.ssax = 3u;
+                command.trxpos.ssay = 6u;
+                command.trxreg.rrw = 37u;
+                command.trxreg.rrh = 11u;
+                command.direction = 1u;
+
+                std::vector<uint8_t> expected;
+                const uint32_t bits = static_cast<uint32_t>(GSMem::BitsPerPixel(static_cast<GSMem::PixelStorageMode>(psm)));
+                const uint32_t total = 37u * 11u;
+                for (uint32_t pixel = 0u; pixel < total; ++pixel)
+                {
+                    const uint32_t value = backend.ReadVram(psm, 35u, 2u, 3u + pixel % 37u, 6u + pixel / 37u);
+                    if (bits == 4u)
+                    {
+                        if ((pixel & 1u) == 0u)
+                            expected.push_back(static_cast<uint8_t>(value & 0x0Fu));
+                        else
+                            expected.back() |= static_cast<uint8_t>((value & 0x0Fu) << 4u);
+                        continue;
+                    }
+                    for (uint32_t byte = 0u; byte < bits / 8u; ++byte)
+                        expected.push_back(static_cast<uint8_t>(value >> (byte * 8u)));
+                }
+
+                backend.BeginTransfer(command);
+                std::vector<uint8_t> actual(expected.size() + 16u, 0u);
+                const uint32_t count = backend.ConsumeLocalToHostBytes(actual.data(), static_cast<uint32_t>(actual.size()));
+                actual.resize(count);
+
+                t.IsTrue(actual == expected, "local->host bytes should match per-pixel reads for psm " + std::to_string(psm));
+
+                // Bits above the 6-bit PSM field must not change the pixel size.
+                command.bitbltbuf.spsm = static_cast<uint8_t>(psm | 0xC0u);
+                backend.BeginTransfer(command);
+                std::vector<uint8_t> masked(expected.size() + 16u, 0u);
+                masked.resize(backend.ConsumeLocalToHostBytes(masked.data(), static_cast<uint32_t>(masked.size())));
+                t.IsTrue(masked == expected, "spsm bits above the PSM field should be ignored for psm " + std::to_string(psm));
+            }
+
+            GSTransferCommand empty{};
+            empty.bitbltbuf.spsm = GS_PSM_CT32;
+            empty.direction = 1u;
+            backend.BeginTransfer(empty);
+            uint8_t scratch[16] = {};
+            t.Equals(backend.ConsumeLocalToHostBytes(scratch, sizeof(scratch)), 0u,
+                     "an empty local->host transfer should leave nothing to read");
+        });
+
         tc.Run("GS PSMT4 host-local upload keeps position across split IMAGE packets", [](TestCase &t)
         {
             std::vector<uint8_t> vram(PS2_GS_VRAM_SIZE, 0u);
@@ -210,6 +210,21 @@ namespace
             return true;
         }
 
+        bool readHostFileIntoGuest(uint64_t handle,
+                                   uint64_t offset,
+                                   uint32_t guestAddress,
+                                   size_t size,
+                                   size_t &bytesRead) override
+        {
+            bytesRead = 0u;
+            if (!contains(guestAddress, size))
+            {
+                return false;
+            }
+            ++guestHostFileReads;
+            return readHostFile(handle, offset, memory.data() + guestAddress, size, bytesRead);
+        }
+
         void closeHostFile(uint64_t handle) override
         {
             if (openHostFiles.erase(handle) != 0u)
@@ -293,6 +308,7 @@ namespace
         std::vector<std::pair<LogLevel, std::string>> logs;
         std::unordered_map<std::string, std::vector<uint8_t>> hostFileContents;
         std::unordered_map<uint64_t, std::string> openHostFiles;
+        uint32_t guestHostFileReads = 0u;
         std::vector<uint64_t> closedHostFileHandles;
         uint64_t nextHostFileHandle = 1u;
 
@@ -0,0 +1,776 @@
+#include "MiniTest.h"
+#include "runtime/ps2_ipu.h"
+#include "runtime/ps2_memory.h"
+#include "runtime/ps2_mpeg_decoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t kIpuCmd = 0x10002000u;
+    constexpr uint32_t kIpuCtrl = 0x10002010u;
+    constexpr uint32_t kIpuBp = 0x10002020u;
+    constexpr uint32_t kIpuOutFifo = 0x10007000u;
+    constexpr uint32_t kIpuInFifo = 0x10007010u;
+    constexpr uint32_t kFromIpuChcr = 0x1000B000u;
+    constexpr uint32_t kToIpuChcr = 0x1000B400u;
+    constexpr uint32_t kDStat = 0x1000E010u;
+
+    // IPU_CTRL for MPEG-1 I pictures: PCT=1, MP1.
+    constexpr uint32_t kCtrlMpeg1Intra = 0x01800000u;
+
+    // MSB-first writer for building elementary streams bit by bit.
+    class StreamWriter
+    {
+    public:
+        void put(uint32_t value, uint32_t count)
+        {
+            for (uint32_t bit = count; bit-- > 0u;)
+                putBit(((value >> bit) & 1u) != 0u);
+        }
+
+        // VLC given as its '0'/'1' spelling, as the standard tabulates them.
+        void code(const char *bits)
+        {
+            for (; *bits; ++bits)
+                putBit(*bits == '1');
+        }
+
+        void align()
+        {
+            while (m_bits != 0u)
+                putBit(false);
+        }
+
+        void startCode(uint8_t value)
+        {
+            align();
+            m_bytes.insert(m_bytes.end(), {0x00u, 0x00u, 0x01u, value});
+        }
+
+        [[nodiscard]] const std::vector<uint8_t> &bytes() const { return m_bytes; }
+
+    private:
+        void putBit(bool bit)
+        {
+            if (m_bits == 0u)
+                m_bytes.push_back(0u);
+            if (bit)
+                m_bytes.back() |= static_cast<uint8_t>(0x80u >> m_bits);
+            m_bits = (m_bits + 1u) & 7u;
+        }
+
+        std::vector<uint8_t> m_bytes;
+        uint32_t m_bits = 0u;
+    };
+
+    void writeSequenceHeader(StreamWriter &w, uint32_t width, uint32_t height)
+    {
+        w.startCode(0xB3u);
+        w.put(width, 12u);
+        w.put(height, 12u);
+        w.put(1u, 4u);        // square pixels
+        w.put(3u, 4u);        // 25 fps
+        w.put(0x3FFFFu, 18u); // variable bit rate
+        w.put(1u, 1u);
+        w.put(20u, 10u);
+        w.put(0u, 3u); // not constrained, default matrices
+
+        w.startCode(0xB8u);
+        w.put(0u, 12u);
+        w.put(1u, 1u);
+        w.put(0u, 12u);
+        w.put(1u, 1u); // closed GOP
+        w.put(0u, 1u);
+    }
+
+    // MPEG-1 picture header; f_code 1 in each direction the type uses.
+    void writePictureHeader(StreamWriter &w, uint32_t temporalReference, uint32_t codingType)
+    {
+        w.startCode(0x00u);
+        w.put(temporalReference, 10u);
+        w.put(codingType, 3u);
+        w.put(0xFFFFu, 16u);
+        if (codingType >= 2u)
+            w.put(1u, 4u);
+        if (codingType == 3u)
+            w.put(1u, 4u);
+        w.put(0u, 1u);
+    }
+
+    void writeSliceHeader(StreamWriter &w, uint32_t row, uint32_t quantiserCode)
+    {
+        w.startCode(static_cast<uint8_t>(row + 1u));
+        w.put(quantiserCode, 5u);
+        w.put(0u, 1u);
+    }
+
+    // dct_dc_differential with its size prefix (MPEG-1, 8-bit DC).
+    void writeDcDifferential(StreamWriter &w, int diff, bool chroma)
+    {
+        static const char *const kLumaSize[] = {"100", "00", "01", "101", "110", "1110", "11110", "111110",
+                                                "1111110"};
+        static const char *const kChromaSize[] = {"00", "01", "10", "110", "1110", "11110", "111110",
+                                                  "1111110", "11111110"};
+        uint32_t size = 0u;
+        for (int magnitude = std::abs(diff); magnitude != 0; magnitude >>= 1)
+            ++size;
+        w.code(chroma ? kChromaSize[size] : kLumaSize[size]);
+        if (size != 0u)
+            w.put(static_cast<uint32_t>(diff > 0 ? diff : diff + (1 << size) - 1), size);
+    }
+
+    // Escape-coded run/level pair with an 8-bit MPEG-1 level.
+    void writeEscapeCoefficient(StreamWriter &w, uint32_t run, int level)
+    {
+        w.code("000001");
+        w.put(run, 6u);
+        w.put(static_cast<uint32_t>(level) & 0xFFu, 8u);
+    }
+
+    void writeMotionCode(StreamWriter &w, int motionCode)
+    {
+        static const char *const kMotionCodes[] = {"1", "01", "001", "0001", "000011"};
+        w.code(kMotionCodes[std::abs(motionCode)]);
+        if (motionCode != 0)
+            w.put(motionCode < 0 ? 1u : 0u, 1u);
+    }
+
+    // Intra macroblock of DC-only blocks; predictors carry the running DC of
+    // luma, Cb and Cr across the slice.
+    void writeDcMacroblock(StreamWriter &w, const int luma[4], int cb, int cr, int predictors[3])
+    {
+        for (int block = 0; block < 6; ++block)
+        {
+            const int component = block < 4 ? 0 : block - 3;
+            const int value = block < 4 ? luma[block] : (block == 4 ? cb : cr);
+            writeDcDifferential(w, value - predictors[component], component != 0);
+            predictors[component] = value;
+            w.code("10");
+        }
+    }
+
+    // I picture where every 8x8 luma block is flat at lumaAt(blockX, blockY)
+    // and chroma is flat at cb/cr.
+    void writeFlatIntraPicture(StreamWriter &w, uint32_t width, uint32_t height,
+                               const std::function<int(uint32_t, uint32_t)> &lumaAt, int cb, int cr)
+    {
+        writePictureHeader(w, 0u, 1u);
+        for (uint32_t mbY = 0; mbY < height / 16u; ++mbY)
+        {
+            writeSliceHeader(w, mbY, 8u);
+            int predictors[3] = {128, 128, 128};
+            for (uint32_t mbX = 0; mbX < width / 16u; ++mbX)
+            {
+                const int luma[4] = {lumaAt(mbX * 2u, mbY * 2u), lumaAt(mbX * 2u + 1u, mbY * 2u),
+                                     lumaAt(mbX * 2u, mbY * 2u + 1u), lumaAt(mbX * 2u + 1u, mbY * 2u + 1u)};
+                w.code("1"); // address increment 1
+                w.code("1"); // intra
+                writeDcMacroblock(w, luma, cb, cr, predictors);
+            }
+        }
+    }
+
+    std::vector<const PS2MpegPicture *> takeAll(PS2MpegPictureQueue &queue)
+    {
+        std::vector<const PS2MpegPicture *> pictures;
+        while (PS2MpegPicture *picture = queue.take())
+            pictures.push_back(picture);
+        return pictures;
+    }
+
+    uint32_t nextRandom(uint32_t &state)
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8u;
+    }
+
+    // 720x576 stream of one I picture with textured blocks followed by
+    // predictedCount P pictures of coded, motion compensated macroblocks.
+    std::vector<uint8_t> buildBenchmarkStream(uint32_t predictedCount)
+    {
+        constexpr uint32_t kWidth = 720u;
+        constexpr uint32_t kHeight = 576u;
+        uint32_t seed = 0x1234567u;
+        StreamWriter w;
+        writeSequenceHeader(w, kWidth, kHeight);
+
+        writePictureHeader(w, 0u, 1u);
+        for (uint32_t mbY = 0; mbY < kHeight / 16u; ++mbY)
+        {
+            writeSliceHeader(w, mbY, 4u);
+            int predictors[3] = {128, 128, 128};
+            for (uint32_t mbX = 0; mbX < kWidth / 16u; ++mbX)
+            {
+                w.code("1"); // address increment 1
+                w.code("1"); // intra
+                for (int block = 0; block < 6; ++block)
+                {
+                    const int component = block < 4 ? 0 : block - 3;
+                    const int value = 40 + static_cast<int>(nextRandom(seed) % 176u);
+                    writeDcDifferential(w, value - predictors[component], component != 0);
+                    predictors[component] = value;
+                    for (int coefficient = 0; coefficient < 4; ++coefficient)
+                        writeEscapeCoefficient(w, 1u + nextRandom(seed) % 3u,
+                                               (static_cast<int>(nextRandom(seed) % 21u) - 10) | 1);
+                    w.code("10");
+                }
+            }
+        }
+
+        for (uint32_t picture = 1; picture <= predictedCount; ++picture)
+        {
+            writePictureHeader(w, picture, 2u);
+            for (uint32_t mbY = 0; mbY < kHeight / 16u; ++mbY)
+            {
+                writeSliceHeader(w, mbY, 8u);
+                for (uint32_t mbX = 0; mbX < kWidth / 16u; ++mbX)
+                {
+                    w.code("1");   // address increment 1
+                    w.code("1");   // motion compensated, coded
+                    writeMotionCode(w, static_cast<int>(nextRandom(seed) % 5u) - 2);
+                    writeMotionCode(w, static_cast<int>(nextRandom(seed) % 5u) - 2);
+                    w.code("111"); // luma blocks coded
+                    for (int block = 0; block < 4; ++block)
+                    {
+                        writeEscapeCoefficient(w, nextRandom(seed) % 3u, (static_cast<int>(nextRandom(seed) % 9u) - 4) | 1);
+                        w.code("10");
+                    }
+                }
+            }
+        }
+        w.startCode(0xB7u);
+        return w.bytes();
+    }
+
+    std::vector<uint8_t> padToQwords(std::vector<uint8_t> bytes)
+    {
+        bytes.resize((bytes.size() + 15u) & ~static_cast<size_t>(15u), 0u);
+        return bytes;
+    }
+
+    void writeIpuInput(PS2Memory &mem, const std::vector<uint8_t> &bytes)
+    {
+        const std::vector<uint8_t> padded = padToQwords(bytes);
+        for (size_t offset = 0; offset < padded.size(); offset += 16u)
+        {
+            __m128i qword;
+            std::memcpy(&qword, padded.data() + offset, sizeof(qword));
+            mem.write128(kIpuInFifo, qword);
+        }
+    }
+
+    std::vector<uint8_t> readIpuOutput(PS2Memory &mem, size_t qwords)
+    {
+        std::vector<uint8_t> bytes(qwords * 16u);
+        for (size_t index = 0; index < qwords; ++index)
+        {
+            const __m128i qword = mem.read128(kIpuOutFifo);
+            std::memcpy(bytes.data() + index * 16u, &qword, sizeof(qword));
+        }
+        return bytes;
+    }
+
+    uint64_t ipuCommand(PS2Memory &mem, uint32_t command)
+    {
+        mem.write32(kIpuCmd, command);
+        return mem.read64(kIpuCmd);
+    }
+
+    // One 16x16 RAW8 macroblock: flat luma, then flat Cb and Cr.
+    std::vector<uint8_t> flatRaw8Macroblock(uint8_t y, uint8_t cb, uint8_t cr)
+    {
+        std::vector<uint8_t> raw(384u, y);
+        std::fill(raw.begin() + 256, raw.begin() + 320, cb);
+        std::fill(raw.begin() + 320, raw.end(), cr);
+        return raw;
+    }
+
+    // Decodes every slice of a byte aligned MPEG-1 I picture stream through
+    // FDEC/VDEC/IDEC the way a game's IPU loop does; returns the RGB32
+    // output or an empty vector when a command fails.
+    std::vector<uint8_t> ipuDecodeIntraSlices(PS2Ipu &ipu)
+    {
+        std::vector<uint8_t> output;
+        uint8_t qword[PS2Ipu::kQwordBytes];
+        const auto fdec = [&ipu](uint32_t forwardBits)
+        {
+            ipu.writeCommand(0x40000000u | forwardBits);
+            return static_cast<uint32_t>(ipu.readCommand());
+        };
+        for (;;)
+        {
+            const uint32_t bitPointer = ipu.readBitPointer() & 0x7Fu;
+            if ((bitPointer & 7u) != 0u)
+                fdec(8u - (bitPointer & 7u));
+            uint32_t top = fdec(0u);
+            while ((top >> 8u) != 1u && !ipu.busy())
+                top = fdec(8u);
+            if (ipu.busy() || (top & 0xFFu) == 0xB7u)
+                break;
+            if ((top & 0xFFu) < 0x01u || (top & 0xFFu) > 0xAFu)
+            {
+                fdec(32u);
+                continue;
+            }
+            const uint32_t quantiserCode = fdec(32u) >> 27u;
+            ipu.writeCommand(0x30000006u);
+            ipu.writeCommand(0x10000000u | (quantiserCode << 16u));
+            if (ipu.busy() || (ipu.readControl() & (1u << 14u)) != 0u)
+                return {};
+            while (ipu.readOutput(qword))
+                output.insert(output.end(), qword, qword + PS2Ipu::kQwordBytes);
+        }
+        return output;
+    }
+}
+
+void register_ps2_mpeg_tests()
+{
+    MiniTest::Case("PS2MpegDecoder", [](TestCase &tc)
+    {
+        tc.Run("flat intra picture decodes exactly", [](TestCase &t)
+        {
+            const auto lumaAt = [](uint32_t blockX, uint32_t blockY)
+            { return 40 + static_cast<int>(blockX * 40u + blockY * 10u); };
+            StreamWriter w;
+            writeSequenceHeader(w, 32u, 32u);
+            writeFlatIntraPicture(w, 32u, 32u, lumaAt, 100, 150);
+            w.startCode(0xB7u);
+
+            PS2MpegDecoder decoder;
+            PS2MpegPictureQueue queue(4u);
+            t.IsTrue(decoder.feed(w.bytes().data(), w.bytes().size(), 9000, -1, queue), "feed should succeed");
+            t.IsTrue(decoder.flush(queue), "flush should succeed");
+
+            const std::vector<const PS2MpegPicture *> pictures = takeAll(queue);
+            t.Equals(pictures.size(), static_cast<size_t>(1u), "one picture should be published");
+            if (pictures.size() != 1u)
+                return;
+            const PS2MpegPicture &picture = *pictures[0];
+            t.Equals(picture.width, 32u, "picture width");
+            t.Equals(picture.height, 32u, "picture height");
+            t.Equals(picture.pts90k, static_cast<int64_t>(9000), "picture should carry the packet pts");
+
+            bool lumaMatches = true;
+            for (uint32_t y = 0; y < 32u; ++y)
+                for (uint32_t x = 0; x < 32u; ++x)
+                    lumaMatches = lumaMatches &&
+                                  picture.luma[y * picture.lumaStride() + x] == lumaAt(x / 8u, y / 8u);
+            t.IsTrue(lumaMatches, "every luma block should hold its DC value");
+            t.IsTrue(std::all_of(picture.cb.begin(), picture.cb.end(), [](uint8_t v) { return v == 100u; }),
+                     "Cb should be flat");
+            t.IsTrue(std::all_of(picture.cr.begin(), picture.cr.end(), [](uint8_t v) { return v == 150u; }),
+                     "Cr should be flat");
+        });
+
+        tc.Run("P and B pictures predict from reordered anchors", [](TestCase &t)
+        {
+            // 48x16: six luma block columns stepping by 30.
+            const auto lumaAt = [](uint32_t blockX, uint32_t) { return 30 + static_cast<int>(blockX) * 30; };
+            StreamWriter head;
+            writeSequenceHeader(head, 48u, 16u);
+            writeFlatIntraPicture(head, 48u, 16u, lumaAt, 128, 128);
+
+            // P: half-pel right on macroblocks 0 and 2, macroblock 1 skipped
+            // (which resets the predictor, so macroblock 2 codes +1 again).
+            StreamWriter predicted;
+            writePictureHeader(predicted, 2u, 2u);
+            writeSliceHeader(predicted, 0u, 8u);
+            predicted.code("1");
+            predicted.code("001");
+            writeMotionCode(predicted, 1);
+            writeMotionCode(predicted, 0);
+            predicted.code("011"); // address increment 2
+            predicted.code("001");
+            writeMotionCode(predicted, 1);
+            writeMotionCode(predicted, 0);
+
+            // B: backward-only zero vectors, so it must equal the P picture.
+            StreamWriter bidirectional;
+            writePictureHeader(bidirectional, 1u, 3u);
+            writeSliceHeader(bidirectional, 0u, 8u);
+            for (int mb = 0; mb < 3; ++mb)
+            {
+                bidirectional.code("1");
+                bidirectional.code("010");
+                writeMotionCode(bidirectional, 0);
+                writeMotionCode(bidirectional, 0);
+            }
+            bidirectional.startCode(0xB7u);
+
+            PS2MpegDecoder decoder;
+            PS2MpegPictureQueue queue(4u);
+            t.IsTrue(decoder.feed(head.bytes().data(), head.bytes().size(), 0, -1, queue), "I feed");
+            t.IsTrue(decoder.feed(predicted.bytes().data(), predicted.bytes().size(), 6000, -1, queue), "P feed");
+            t.IsTrue(decoder.feed(bidirectional.bytes().data(), bidirectional.bytes().size(), 3000, -1, queue),
+                     "B feed");
+            t.IsTrue(decoder.flush(queue), "flush should succeed");
+
+            const std::vector<const PS2MpegPicture *> pictures = takeAll(queue);
+            t.Equals(pictures.size(), static_cast<size_t>(3u), "three pictures should be published");
+            if (pictures.size() != 3u)
+                return;
+            t.Equals(pictures[0]->pts90k, static_cast<int64_t>(0), "I picture first");
+            t.Equals(pictures[1]->pts90k, static_cast<int64_t>(3000), "B picture second");
+            t.Equals(pictures[2]->pts90k, static_cast<int64_t>(6000), "P picture last");
+            t.Equals(decoder.picturesDecoded(), static_cast<uint64_t>(3u), "decoded count");
+
+            const PS2MpegPicture &reference = *pictures[0];
+            const PS2MpegPicture &p = *pictures[2];
+            bool predictionMatches = true;
+            for (uint32_t y = 0; y < 16u; ++y)
+            {
+                for (uint32_t x = 0; x < 48u; ++x)
+                {
+                    const uint8_t *row = reference.luma.data() + y * reference.lumaStride();
+                    // Macroblock 1 was skipped; the edge repeats at x = 47.
+                    const int expected = (x >= 16u && x < 32u)
+                                             ? row[x]
+                                             : (row[x] + row[std::min(x + 1u, 47u)] + 1) / 2;
+                    predictionMatches = predictionMatches && p.luma[y * p.lumaStride() + x] == expected;
+                }
+            }
+            t.IsTrue(predictionMatches, "P luma should be the half-pel average of the reference");
+            t.IsTrue(pictures[1]->luma == p.luma, "B luma should match its backward anchor");
+        });
+
+        tc.Run("escape coded intra coefficients are dequantised", [](TestCase &t)
+        {
+            StreamWriter w;
+            writeDcDifferential(w, 0, false);
+            writeEscapeCoefficient(w, 0u, 10);
+            writeEscapeCoefficient(w, 1u, -3);
+            w.code("10");
+            w.put(0u, 32u);
+
+            ps2_mpeg::BlockCoding coding;
+            coding.scan = ps2_mpeg::kZigzagScan;
+            coding.intraMatrix = ps2_mpeg::kDefaultIntraMatrix;
+            coding.nonIntraMatrix = ps2_mpeg::kDefaultNonIntraMatrix;
+            coding.quantiserScale = ps2_mpeg::quantiserScale(2, false);
+            coding.mpeg1 = true;
+
+            ps2_mpeg::BitReader reader(w.bytes().data(), w.bytes().size());
+            int predictor = 128;
+            alignas(16) int16_t block[64];
+            t.IsTrue(ps2_mpeg::decodeIntraBlock(reader, coding, false, predictor, block), "block should parse");
+            t.Equals(block[0], static_cast<int16_t>(1024), "DC should be predictor times eight");
+            // 2 * level * scale * W / 16, forced odd toward zero.
+            t.Equals(block[1], static_cast<int16_t>(39), "first AC (W=16)");
+            t.Equals(block[16], static_cast<int16_t>(-13), "scan position 3 lands at raster 16 (W=19)");
+            t.Equals(reader.position(), static_cast<size_t>(3u + 20u + 20u + 2u), "reader should stop after EOB");
+        });
+
+        tc.Run("inverse DCT stays within IEEE 1180 peak error", [](TestCase &t)
+        {
+            const double pi = std::acos(-1.0);
+            uint32_t seed = 0xC0FFEEu;
+            int peakError = 0;
+            double squaredError = 0.0;
+            constexpr int kBlocks = 2000;
+            for (int run = 0; run < kBlocks; ++run)
+            {
+                alignas(16) int16_t block[64];
+                for (int16_t &coefficient : block)
+                    coefficient = static_cast<int16_t>(static_cast<int>(nextRandom(seed) % 512u) - 256);
+                double reference[64];
+                for (int y = 0; y < 8; ++y)
+                {
+                    for (int x = 0; x < 8; ++x)
+                    {
+                        double sum = 0.0;
+                        for (int v = 0; v < 8; ++v)
+                            for (int u = 0; u < 8; ++u)
+                                sum += (u == 0 ? std::sqrt(0.5) : 1.0) * (v == 0 ? std::sqrt(0.5) : 1.0) *
+                                       block[v * 8 + u] * std::cos((2 * x + 1) * u * pi / 16.0) *
+                                       std::cos((2 * y + 1) * v * pi / 16.0);
+                        reference[y * 8 + x] = std::clamp(std::floor(sum / 4.0 + 0.5), -256.0, 255.0);
+                    }
+                }
+                ps2_mpeg::inverseDct(block);
+                for (int i = 0; i < 64; ++i)
+                {
+                    const double error = block[i] - reference[i];
+                    peakError = std::max(peakError, static_cast<int>(std::abs(error)));
+                    squaredError += error * error;
+                }
+            }
+            t.IsTrue(peakError <= 1, "peak IDCT error should be at most 1");
+            t.IsTrue(squaredError / (kBlocks * 64.0) <= 0.02, "overall mean square error should be <= 0.02");
+        });
+
+        tc.Run("decoder microbenchmark", [](TestCase &t)
+        {
+            constexpr uint32_t kPredicted = 11u;
+            const std::vector<uint8_t> stream = buildBenchmarkStream(kPredicted);
+
+            PS2MpegDecoder decoder;
+            PS2MpegPictureQueue queue(4u);
+            uint32_t published = 0u;
+            const auto start = std::chrono::steady_clock::now();
+            // Feed in PES-sized chunks and recycle slots as a consumer would.
+            constexpr size_t kChunk = 2048u;
+            bool ok = true;
+            for (size_t offset = 0; offset < stream.size() && ok; offset += kChunk)
+            {
+                ok = decoder.feed(stream.data() + offset, std::min(kChunk, stream.size() - offset), -1, -1, queue);
+                while (PS2MpegPicture *picture = queue.take())
+                {
+                    queue.release(picture);
+                    ++published;
+                }
+            }
+            ok = ok && decoder.flush(queue);
+            while (PS2MpegPicture *picture = queue.take())
+            {
+                queue.release(picture);
+                ++published;
+            }
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+
+            t.IsTrue(ok, "benchmark stream should decode");
+            t.Equals(published, kPredicted + 1u, "every picture should be published");
+            std::cout << "  MPEG decode 720x576: "
+                      << static_cast<double>(elapsed.count()) / 1000.0 / static_cast<double>(kPredicted + 1u)
+                      << " ms/picture" << std::endl;
+        });
+    });
+
+    MiniTest::Case("PS2Ipu", [](TestCase &tc)
+    {
+        tc.Run("FDEC and VDEC read the bitstream", [](TestCase &t)
+        {
+            PS2Memory mem;
+            t.IsTrue(mem.initialize(), "PS2Memory initialize should succeed");
+            ipuCommand(mem, 0x00000000u);
+            writeIpuInput(mem, {0x61u, 0x23u, 0x45u, 0x67u, 0x89u, 0xABu, 0xCDu, 0xEFu});
+
+            t.Equals(static_cast<uint32_t>(ipuCommand(mem, 0x40000000u)), 0x61234567u, "FDEC peeks 32 bits");
+            t.Equals(mem.read32(kIpuBp) & 0x7Fu, 0u, "FDEC with FB=0 leaves BP");
+            // 011 is address increment 2.
+            const uint64_t vdec = ipuCommand(mem, 0x30000000u);
+            t.Equals(static_cast<uint32_t>(vdec), 2u | (3u << 16u), "VDEC returns the value and code length");
+            t.Equals(mem.read32(kIpuBp) & 0x7Fu, 3u, "BP should advance past the code");
+            t.Equals(vdec >> 63u, 0ull, "command should not be busy");
+
+            ipuCommand(mem, 0x00000000u);
+            const uint64_t starved = ipuCommand(mem, 0x40000000u);
+            t.Equals(starved >> 63u, 1ull, "FDEC on an empty FIFO stays busy");
+            writeIpuInput(mem, {0x12u, 0x34u, 0x56u, 0x78u});
+            t.Equals(mem.read64(kIpuCmd), static_cast<uint64_t>(0x12345678u), "FDEC completes once input arrives");
+        });
+
+        tc.Run("BDEC writes RAW16 intra blocks", [](TestCase &t)
+        {
+            PS2Memory mem;
+            t.IsTrue(mem.initialize(), "PS2Memory initialize should succeed");
+            mem.write32(kIpuCtrl, kCtrlMpeg1Intra);
+            ipuCommand(mem, 0x00000000u);
+
+            StreamWriter w;
+            int predictors[3] = {128, 128, 128};
+            const int luma[4] = {136, 128, 128, 120};
+            writeDcMacroblock(w, luma, 64, 192, predictors);
+            w.put(0u, 32u);
+            writeIpuInput(mem, w.bytes());
+
+            // MBI | DCR | QSC=8.
+            const uint64_t result = ipuCommand(mem, 0x2C080000u);
+            t.Equals(result >> 63u, 0ull, "BDEC should complete");
+            t.Equals((mem.read32(kIpuCtrl) >> 8u) & 0x3Fu, 0x3Fu, "intra BDEC reports every block coded");
+            const std::vector<uint8_t> bytes = readIpuOutput(mem, 48u);
+            std::vector<int16_t> raw(384u);
+            std::memcpy(raw.data(), bytes.data(), bytes.size());
+
+            bool lumaMatches = true;
+            for (uint32_t y = 0; y < 16u; ++y)
+                for (uint32_t x = 0; x < 16u; ++x)
+                    lumaMatches = lumaMatches && raw[y * 16u + x] == luma[(y / 8u) * 2u + x / 8u];
+            t.IsTrue(lumaMatches, "luma should come out in raster order");
+            t.IsTrue(std::all_of(raw.begin() + 256, raw.begin() + 320, [](int16_t v) { return v == 64; }), "Cb");
+            t.IsTrue(std::all_of(raw.begin() + 320, raw.end(), [](int16_t v) { return v == 192; }), "Cr");
+        });
+
+        tc.Run("CSC converts RAW8 with alpha thresholds", [](TestCase &t)
+        {
+            PS2Memory mem;
+            t.IsTrue(mem.initialize(), "PS2Memory initialize should succeed");
+            ipuCommand(mem, 0x00000000u);
+            ipuCommand(mem, 0x90000000u | (0x40u << 16u) | 0x20u); // SETTH TH0=0x20 TH1=0x40
+
+            std::vector<uint8_t> input = flatRaw8Macroblock(180u, 90u, 160u);
+            const std::vector<uint8_t> dark = flatRaw8Macroblock(16u, 128u, 128u);
+            input.insert(input.end(), dark.begin(), dark.end());
+            writeIpuInput(mem, input);
+
+            t.Equals(ipuCommand(mem, 0x70000002u) >> 63u, 0ull, "CSC should complete");
+            const std::vector<uint8_t> rgba = readIpuOutput(mem, 128u);
+            uint8_t expected[3];
+            ps2_mpeg::convertPixel(180u, 90u, 160u, expected);
+            t.IsTrue(rgba[0] == expected[0] && rgba[1] == expected[1] && rgba[2] == expected[2],
+                     "RGB should match the shared converter");
+            t.Equals(rgba[3], static_cast<uint8_t>(0x80u), "bright pixels keep full alpha");
+            t.Equals(rgba[1024 + 3], static_cast<uint8_t>(0x00u), "black pixels fall under TH0");
+
+            writeIpuInput(mem, flatRaw8Macroblock(180u, 90u, 160u));
+            t.Equals(ipuCommand(mem, 0x78000001u) >> 63u, 0ull, "RGB16 CSC should complete");
+            const std::vector<uint8_t> packed = readIpuOutput(mem, 32u);
+            const uint16_t pixel = static_cast<uint16_t>(packed[0] | (packed[1] << 8u));
+            t.Equals(pixel, static_cast<uint16_t>((expected[0] >> 3) | ((expected[1] >> 3) << 5) |
+                                                  ((expected[2] >> 3) << 10) | 0x8000),
+                     "RGB16 should pack 5:5:5 with the alpha bit");
+        });
+
+        tc.Run("SETVQ and PACK quantise to the CLUT", [](TestCase &t)
+        {
+            PS2Memory mem;
+            t.IsTrue(mem.initialize(), "PS2Memory initialize should succeed");
+            ipuCommand(mem, 0x00000000u);
+
+            std::vector<uint8_t> clut;
+            for (uint32_t index = 0; index < 16u; ++index)
+            {
+                const uint16_t entry = static_cast<uint16_t>((index * 2u) | ((31u - index) << 5u) | ((index & 3u) << 10u));
+                clut.push_back(static_cast<uint8_t>(entry));
+                clut.push_back(static_cast<uint8_t>(entry >> 8u));
+            }
+            writeIpuInput(mem, clut);
+            t.Equals(ipuCommand(mem, 0x60000000u) >> 63u, 0ull, "SETVQ should complete");
+
+            std::vector<uint8_t> rgba(1024u);
+            for (uint32_t pixel = 0; pixel < 256u; ++pixel)
+            {
+                const uint32_t index = (pixel * 7u) & 15u;
+                rgba[pixel * 4u] = static_cast<uint8_t>((index * 2u) << 3u);
+                rgba[pixel * 4u + 1u] = static_cast<uint8_t>((31u - index) << 3u);
+                rgba[pixel * 4u + 2u] = static_cast<uint8_t>((index & 3u) << 3u);
+                rgba[pixel * 4u + 3u] = 0x80u;
+            }
+            writeIpuInput(mem, rgba);
+            t.Equals(ipuCommand(mem, 0x80000001u) >> 63u, 0ull, "PACK should complete");
+
+            const std::vector<uint8_t> packed = readIpuOutput(mem, 8u);
+            bool indicesMatch = true;
+            for (uint32_t pixel = 0; pixel < 256u; pixel += 2u)
+                indicesMatch = indicesMatch &&
+                               packed[pixel / 2u] == (((pixel * 7u) & 15u) | ((((pixel + 1u) * 7u) & 15u) << 4u));
+            t.IsTrue(indicesMatch, "INDX4 should hold the exact CLUT index, low nibble first");
+        });
+
+        tc.Run("IDEC decodes a slice over the toIPU and fromIPU channels", [](TestCase &t)
+        {
+            PS2Memory mem;
+            t.IsTrue(mem.initialize(), "PS2Memory initialize should succeed");
+            mem.write32(kIpuCtrl, kCtrlMpeg1Intra);
+            ipuCommand(mem, 0x00000000u);
+
+            // One slice of two macroblocks, ended by a sequence end code.
+            const auto lumaAt = [](uint32_t blockX, uint32_t blockY)
+            { return 60 + static_cast<int>(blockX * 30u + blockY * 5u); };
+            StreamWriter w;
+            writeSliceHeader(w, 0u, 8u);
+            int predictors[3] = {128, 128, 128};
+            for (uint32_t mbX = 0; mbX < 2u; ++mbX)
+            {
+                const int luma[4] = {lumaAt(mbX * 2u, 0u), lumaAt(mbX * 2u + 1u, 0u), lumaAt(mbX * 2u, 1u),
+                                     lumaAt(mbX * 2u + 1u, 1u)};
+                w.code("1");
+                w.code("1");
+                writeDcMacroblock(w, luma, 110, 140, predictors);
+            }
+            w.startCode(0xB7u);
+            const std::vector<uint8_t> stream = padToQwords(w.bytes());
+
+            constexpr uint32_t kInputAddress = 0x00100000u;
+            constexpr uint32_t kOutputAddress = 0x00200000u;
+            std::memcpy(mem.getRDRAM() + kInputAddress, stream.data(), stream.size());
+            mem.write32(kToIpuChcr + 0x10u, kInputAddress);
+            mem.write32(kToIpuChcr + 0x20u, static_cast<uint32_t>(stream.size() / 16u));
+            mem.write32(kToIpuChcr, 0x101u);
+            mem.write32(kFromIpuChcr + 0x10u, kOutputAddress);
+            mem.write32(kFromIpuChcr + 0x20u, 128u);
+            mem.write32(kFromIpuChcr, 0x100u);
+
+            t.Equals(static_cast<uint32_t>(ipuCommand(mem, 0x40000000u)), 0x00000101u, "FDEC finds the slice");
+            const uint32_t quantiserCode = static_cast<uint32_t>(ipuCommand(mem, 0x40000020u)) >> 27u;
+            t.Equals(quantiserCode, 8u, "slice quantiser code");
+            t.Equals(static_cast<uint32_t>(ipuCommand(mem, 0x30000006u)), 1u | (1u << 16u),
+                     "VDEC consumes the first address increment");
+            t.Equals(ipuCommand(mem, 0x10000000u | (quantiserCode << 16u)) >> 63u, 0ull, "IDEC should complete");
+
+            const uint32_t ctrl = mem.read32(kIpuCtrl);
+            t.IsTrue((ctrl & (1u << 15u)) != 0u, "IDEC should stop at the start code");
+            t.IsTrue((ctrl & (1u << 14u)) == 0u, "IDEC should not report an error");
+            t.Equals(mem.read32(kToIpuChcr) & 0x100u, 0u, "toIPU should complete");
+            t.Equals(mem.read32(kFromIpuChcr) & 0x100u, 0u, "fromIPU should complete");
+            t.Equals(mem.read32(kDStat) & 0x18u, 0x18u, "D_STAT should flag both IPU channels");
+
+            bool rgbMatches = true;
+            const uint8_t *out = mem.getRDRAM() + kOutputAddress;
+            for (uint32_t mbX = 0; mbX < 2u; ++mbX)
+            {
+                for (uint32_t y = 0; y < 16u; ++y)
+                {
+                    for (uint32_t x = 0; x < 16u; ++x)
+                    {
+                        uint8_t expected[3];
+                        ps2_mpeg::convertPixel(static_cast<uint8_t>(lumaAt(mbX * 2u + x / 8u, y / 8u)), 110u, 140u,
+                                               expected);
+                        const uint8_t *pixel = out + mbX * 1024u + (y * 16u + x) * 4u;
+                        rgbMatches = rgbMatches && pixel[0] == expected[0] && pixel[1] == expected[1] &&
+                                     pixel[2] == expected[2] && pixel[3] == 0x80u;
+                    }
+                }
+            }
+            t.IsTrue(rgbMatches, "RGB32 output should match the converted picture");
+        });
+
+        tc.Run("IDEC microbenchmark", [](TestCase &t)
+        {
+            const std::vector<uint8_t> stream = padToQwords(buildBenchmarkStream(0u));
+            // Skip to the first slice; IDEC only sees slice data.
+            size_t sliceStart = 0u;
+            while (sliceStart + 4u <= stream.size() &&
+                   !(stream[sliceStart] == 0u && stream[sliceStart + 1u] == 0u && stream[sliceStart + 2u] == 1u &&
+                     stream[sliceStart + 3u] == 1u))
+                ++sliceStart;
+            sliceStart &= ~static_cast<size_t>(15u);
+
+            constexpr int kRuns = 4;
+            PS2Ipu ipu;
+            size_t output = 0u;
+            const auto start = std::chrono::steady_clock::now();
+            for (int run = 0; run < kRuns; ++run)
+            {
+                size_t dma = sliceStart;
+                ipu.reset();
+                ipu.setInputPull([&stream, &dma](uint8_t qword[PS2Ipu::kQwordBytes])
+                {
+                    if (dma >= stream.size())
+                        return false;
+                    std::memcpy(qword, stream.data() + dma, PS2Ipu::kQwordBytes);
+                    dma += PS2Ipu::kQwordBytes;
+                    return true;
+                });
+                ipu.writeControl(kCtrlMpeg1Intra);
+                ipu.writeCommand(0x00000000u);
+                output = ipuDecodeIntraSlices(ipu).size();
+            }
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+
+            t.Equals(output, static_cast<size_t>(45u * 36u * 1024u), "every macroblock should be converted");
+            std::cout << "  IPU IDEC 720x576: " << static_cast<double>(elapsed.count()) / 1000.0 / kRuns
+                      << " ms/picture" << std::endl;
+        });
+    });
+}
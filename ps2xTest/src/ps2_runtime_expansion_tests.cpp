@@ -10,6 +10,7 @@
 #include "runtime/gs/gs_frontend.h"
 #include "runtime/ee_scheduler.h"
 #include "runtime/gs/ps2_gs_psmct32.h"
+#include "runtime/ps2_mpeg_video.h"
 #include "ps2_runtime_macros.h"
 #include "Stubs/MPEG.h"
 #include "Stubs/CD.h"
@@ -18,9 +19,11 @@
 #include "Stubs/VU.h"
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <exception>
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -166,6 +169,20 @@ namespace
         }
     }
 
+    // A one-instruction guest leaf (JR $ra with a result in v0). Kept out of
+    // line so the benchmark calls it the way generated code in another
+    // translation unit would.
+#if defined(_MSC_VER)
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    void testCallBenchLeaf(uint8_t *, R5900Context *ctx, PS2Runtime *)
+    {
+        setRegU32(*ctx, 2, getRegU32(ctx, 2) + 1u);
+        ctx->pc = getRegU32(ctx, 31);
+    }
+
     std::atomic<uint32_t> gGuestJumpTargetCount{0u};
 
     void testGuestJumpTargetHandler(uint8_t *, R5900Context *, PS2Runtime *)
@@ -195,33 +212,6 @@ namespace
     constexpr uint32_t kMpegNoDuplicateProducerPc = 0x00125050u;
     constexpr uint32_t kMpegNoDuplicateHandle = 0x00124000u;
     constexpr uint32_t kMpegNoDuplicateImage = 0x00131000u;
-    constexpr uint32_t kIpuInitMainPc = 0x00125100u;
-    constexpr uint32_t kIpuInitResumePc = 0x00125104u;
-    constexpr uint32_t kIpuSetD4Pc = 0x00126428u;
-    std::atomic<uint32_t> gIpuSetD4Hits{0u};
-    std::atomic<uint32_t> gIpuSetD4Argument{0u};
-    std::atomic<int32_t> gIpuInitResult{-999};
-
-    void testIpuSetD4(uint8_t *, R5900Context *ctx, PS2Runtime *)
-    {
-        gIpuSetD4Hits.fetch_add(1u, std::memory_order_acq_rel);
-        gIpuSetD4Argument.store(::getRegU32(ctx, 4), std::memory_order_release);
-        ctx->pc = 0u;
-    }
-
-    void testIpuInitMain(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
-    {
-        ctx->pc = kIpuInitResumePc;
-        ps2_stubs::sceIpuInit(rdram, ctx, runtime);
-    }
-
-    void testIpuInitResume(uint8_t *, R5900Context *ctx, PS2Runtime *runtime)
-    {
-        gIpuInitResult.store(getRegS32(*ctx, 2), std::memory_order_release);
-        ctx->pc = 0u;
-        runtime->requestStop();
-    }
-
     void testMpegWaitMain(uint8_t *rdram, R5900Context *ctx, PS2Runtime *runtime)
     {
         gMpegWaitStage.store(1u, std::memory_order_release);
@@ -455,6 +445,181 @@ void register_ps2_runtime_expansion_tests()
                      "callee transfer PC should be preserved");
         });
 
+        tc.Run("cached guest branch fills on miss and calls directly on hit", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            runtime.registerFunction(0x3000u, &testGuestBranchImplicitReturnHandler);
+            PS2Runtime::GuestBranchCache cache{};
+
+            for (int i = 0; i < 3; ++i)
+            {
+                R5900Context ctx{};
+                ctx.pc = 0x2000u;
+                const bool returnedToFallthrough = runtime.dispatchCachedGuestBranch(
+                    nullptr,
+                    &ctx,
+                    0x3000u,
+                    0x2000u,
+                    0x2008u,
+                    PS2Runtime::GuestBranchKind::IndirectCall,
+                    "test-jalr-cached",
+                    cache);
+
+                t.IsTrue(returnedToFallthrough, "cached call should resume at fallthrough");
+                t.Equals(ctx.pc, 0x2008u, "cached call should normalize unchanged callee PC");
+                t.Equals(::getRegU32(&ctx, 2), 0x00FACE42u, "cached call should run the callee");
+            }
+
+            const PS2Runtime::GuestBranchStats stats = runtime.guestBranchStats();
+            t.Equals(stats.cacheMisses, 1u, "only the first dispatch should miss");
+            t.Equals(stats.cacheHits, 2u, "repeat targets should hit the inline cache");
+            t.Equals(stats.indirectCalls, 3u, "every cached call should count as an indirect call");
+            t.Equals(stats.dispatches, 3u, "hits and misses should both count as dispatches");
+            t.Equals(cache.targets[0], 0x3000u, "miss should record the target in the cache");
+        });
+
+        tc.Run("cached guest branch keeps recently hit targets and evicts the least recent", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            const uint32_t targets[] = {0x3000u, 0x3100u, 0x3200u, 0x3300u, 0x3400u};
+            for (const uint32_t target : targets)
+            {
+                runtime.registerFunction(target, &testGuestBranchImplicitReturnHandler);
+            }
+            PS2Runtime::GuestBranchCache cache{};
+            const auto call = [&](uint32_t target)
+            {
+                R5900Context ctx{};
+                ctx.pc = 0x2000u;
+                (void)runtime.dispatchCachedGuestBranch(nullptr, &ctx, target, 0x2000u, 0x2008u,
+                                                        PS2Runtime::GuestBranchKind::IndirectCall,
+                                                        "test-jalr-lru", cache);
+            };
+
+            for (uint32_t i = 0; i < 4u; ++i)
+            {
+                call(targets[i]);
+            }
+            call(targets[0]);
+            t.Equals(cache.targets[0], targets[0], "a hit should move its target to the front");
+            t.Equals(runtime.guestBranchStats().cacheHits, 1u, "the repeat should hit");
+
+            call(targets[4]);
+            call(targets[0]);
+            const PS2Runtime::GuestBranchStats stats = runtime.guestBranchStats();
+            t.Equals(stats.cacheHits, 2u, "the recently hit target should survive the next fill");
+            t.Equals(stats.cacheMisses, 5u, "the fill should evict the least recently used target");
+            call(targets[1]);
+            t.Equals(runtime.guestBranchStats().cacheMisses, 6u, "the evicted target should miss");
+        });
+
+        tc.Run("direct JAL call microbenchmark", [](TestCase &t)
+        {
+            // The three shapes the recompiler emits for JAL: the dispatcher,
+            // a direct call guarded by the table slot, and an unchecked call
+            // to a proven clean leaf.
+            constexpr uint32_t kCallee = 0x3800u;
+            constexpr uint32_t kCallSite = 0x2000u;
+            constexpr uint32_t kReturn = 0x2008u;
+            constexpr uint32_t kCalls = 2000000u;
+            PS2Runtime runtime;
+            runtime.registerFunction(kCallee, &testCallBenchLeaf);
+
+            const auto measure = [&](auto &&callOnce)
+            {
+                R5900Context ctx{};
+                uint32_t completed = 0u;
+                const auto start = std::chrono::steady_clock::now();
+                for (uint32_t i = 0; i < kCalls; ++i)
+                {
+                    SET_GPR_U32(&ctx, 31, kReturn);
+                    ctx.pc = kCallee;
+                    completed += callOnce(ctx) ? 1u : 0u;
+                }
+                const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+                t.Equals(completed, kCalls, "every call should return to the call site");
+                t.Equals(getRegU32(&ctx, 2), kCalls, "the leaf should run once per call");
+                return elapsed.count();
+            };
+
+            const auto dispatched = measure([&](R5900Context &ctx)
+                                            { return runtime.dispatchGuestBranch(nullptr, &ctx, kCallee, kCallSite, kReturn,
+                                                                                 PS2Runtime::GuestBranchKind::DirectCall,
+                                                                                 "bench-jal"); });
+            const auto guarded = measure([&](R5900Context &ctx)
+                                         {
+                                             if (ps2GuestFunctionAt(kCallee) != &testCallBenchLeaf)
+                                             {
+                                                 return false;
+                                             }
+                                             testCallBenchLeaf(nullptr, &ctx, &runtime);
+                                             return ctx.pc == kReturn || ctx.pc == kCallee; });
+            const auto clean = measure([&](R5900Context &ctx)
+                                       {
+                                           testCallBenchLeaf(nullptr, &ctx, &runtime);
+                                           return true; });
+
+            std::cout << "  JAL to a leaf, " << kCalls << " calls: dispatchGuestBranch " << dispatched
+                      << " us, guarded direct " << guarded << " us, clean " << clean << " us" << std::endl;
+        });
+
+        tc.Run("cached guest jump runs a known target without the dispatcher", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            runtime.registerFunction(0x3400u, &testGuestJumpTargetHandler);
+            gGuestJumpTargetCount.store(0u, std::memory_order_relaxed);
+            PS2Runtime::GuestBranchCache cache{};
+
+            R5900Context ctx{};
+            ctx.pc = 0x2000u;
+            const bool missContinued = runtime.dispatchCachedGuestBranch(
+                nullptr, &ctx, 0x3400u, 0x2000u, 0u,
+                PS2Runtime::GuestBranchKind::IndirectJump, "test-jr-cached", cache);
+
+            t.IsFalse(missContinued, "missed jump should stop the current wrapper");
+            t.Equals(gGuestJumpTargetCount.load(std::memory_order_relaxed), 0u,
+                     "missed jump should still go back through the central dispatcher");
+            t.Equals(ctx.pc, 0x3400u, "missed jump should hand the target to the dispatcher");
+
+            const bool hitContinued = runtime.dispatchCachedGuestBranch(
+                nullptr, &ctx, 0x3400u, 0x2000u, 0u,
+                PS2Runtime::GuestBranchKind::IndirectJump, "test-jr-cached", cache);
+
+            t.IsFalse(hitContinued, "cached jump should still stop the current wrapper");
+            t.Equals(gGuestJumpTargetCount.load(std::memory_order_relaxed), 1u,
+                     "cached jump should run the known target directly");
+            t.Equals(runtime.guestBranchStats().indirectJumps, 2u,
+                     "both jumps should count as indirect jumps");
+        });
+
+        tc.Run("replacing a function invalidates cached guest branches", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            runtime.registerFunction(0x3000u, &testGuestJumpTargetHandler);
+            PS2Runtime::GuestBranchCache cache{};
+            gGuestJumpTargetCount.store(0u, std::memory_order_relaxed);
+
+            R5900Context ctx{};
+            ctx.pc = 0x2000u;
+            (void)runtime.dispatchCachedGuestBranch(nullptr, &ctx, 0x3000u, 0x2000u, 0x2008u,
+                                                    PS2Runtime::GuestBranchKind::IndirectCall, "test-jalr-replace", cache);
+            t.Equals(gGuestJumpTargetCount.load(std::memory_order_relaxed), 1u, "original callee should run on the miss");
+
+            runtime.replaceFunction(0x3000u, &testGuestBranchImplicitReturnHandler);
+
+            ctx = R5900Context{};
+            ctx.pc = 0x2000u;
+            (void)runtime.dispatchCachedGuestBranch(nullptr, &ctx, 0x3000u, 0x2000u, 0x2008u,
+                                                    PS2Runtime::GuestBranchKind::IndirectCall, "test-jalr-replace", cache);
+
+            t.Equals(gGuestJumpTargetCount.load(std::memory_order_relaxed), 1u,
+                     "stale cached callee must not run after replaceFunction");
+            t.Equals(::getRegU32(&ctx, 2), 0x00FACE42u, "replacement callee should run");
+            t.Equals(runtime.guestBranchStats().cacheMisses, 2u,
+                     "replaceFunction should force the next lookup to miss");
+        });
+
         tc.Run("dispatchGuestBranch rejects missing exact targets", [](TestCase &t)
         {
             PS2Runtime runtime;
@@ -783,6 +948,75 @@ void register_ps2_runtime_expansion_tests()
                      "EOF should resume the blocked GetPicture continuation");
             t.Equals(Ps2FastRead32(rdram.data(), kMpegNoDuplicateHandle + 0x08u), 1u,
                      "only the injected decoder frame should be counted as served");
+            t.Equals(Ps2FastRead32(rdram.data(), kMpegNoDuplicateImage), 0x80828282u,
+                     "the served picture should be converted from mid-grey YCbCr into RGBA32");
+        });
+
+        tc.Run("MPEG picture slots convert 4:2:0 planes straight to RGBA32 and RGB16", [](TestCase &t)
+        {
+            PS2MpegPictureQueue queue(2u);
+            PS2MpegPicture *first = queue.tryAcquire();
+            PS2MpegPicture *second = queue.tryAcquire();
+            t.IsTrue(first != nullptr && second != nullptr, "both preallocated slots should be handed out");
+            t.IsTrue(queue.tryAcquire() == nullptr, "a full pool should not grow");
+
+            first->allocate(20u, 8u);
+            t.Equals(first->lumaStride(), 32u, "planes should be padded to whole macroblocks");
+            t.Equals(first->luma.size(), static_cast<size_t>(32u * 16u), "luma should cover the padded height");
+            t.Equals(first->cb.size(), static_cast<size_t>(16u * 8u), "chroma should be half size both ways");
+            queue.publish(first);
+            queue.release(second);
+            t.Equals(queue.readyCount(), static_cast<size_t>(1u), "published slots should be ready in order");
+            PS2MpegPicture *taken = queue.take();
+            t.IsTrue(taken == first, "take should return the oldest published slot");
+            queue.release(taken);
+
+            uint8_t luma[24];
+            uint8_t cb[12];
+            uint8_t cr[12];
+            uint32_t seed = 0x1234567u;
+            auto next = [&seed]()
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return static_cast<uint8_t>(seed >> 24u);
+            };
+            for (uint8_t &v : luma)
+                v = next();
+            for (size_t i = 0; i < 12u; ++i)
+            {
+                cb[i] = next();
+                cr[i] = next();
+            }
+
+            uint8_t rgba[24u * 4u];
+            uint8_t rgb16[24u * 2u];
+            // 22 pixels exercise both the 8-wide path and the scalar tail.
+            ps2_mpeg::convertRow(luma, cb, cr, 22u, 0x80u, ps2_mpeg::PixelFormat::Rgba32, rgba);
+            ps2_mpeg::convertRow(luma, cb, cr, 22u, 0x80u, ps2_mpeg::PixelFormat::Rgb16, rgb16);
+            bool matches = true;
+            for (uint32_t x = 0; x < 22u; ++x)
+            {
+                uint8_t expected[3];
+                ps2_mpeg::convertPixel(luma[x], cb[x / 2u], cr[x / 2u], expected);
+                const uint16_t packed = static_cast<uint16_t>(rgb16[x * 2u] | (rgb16[x * 2u + 1u] << 8u));
+                const uint16_t expectedPacked = static_cast<uint16_t>(
+                    (expected[0] >> 3u) | ((expected[1] >> 3u) << 5u) | ((expected[2] >> 3u) << 10u) | 0x8000u);
+                matches = matches &&
+                          rgba[x * 4u + 0u] == expected[0] &&
+                          rgba[x * 4u + 1u] == expected[1] &&
+                          rgba[x * 4u + 2u] == expected[2] &&
+                          rgba[x * 4u + 3u] == 0x80u &&
+                          packed == expectedPacked;
+            }
+            t.IsTrue(matches, "vector and scalar conversion should agree bit for bit");
+
+            uint8_t rgb[3];
+            ps2_mpeg::convertPixel(16u, 128u, 128u, rgb);
+            t.IsTrue(rgb[0] == 0u && rgb[1] == 0u && rgb[2] == 0u, "studio black should map to 0");
+            ps2_mpeg::convertPixel(235u, 128u, 128u, rgb);
+            t.IsTrue(rgb[0] == 255u && rgb[1] == 255u && rgb[2] == 255u, "studio white should map to 255");
+            ps2_mpeg::convertPixel(81u, 90u, 240u, rgb);
+            t.IsTrue(rgb[0] >= 254u && rgb[1] <= 1u && rgb[2] <= 1u, "BT.601 red should stay saturated red");
         });
 
         tc.Run("sceSdRemote isolates voice transfers from block streaming state", [](TestCase &t)
@@ -899,7 +1133,70 @@ void register_ps2_runtime_expansion_tests()
                      "sceSdRemoteInit should restore idle voice status to complete");
         });
 
-        tc.Run("IPU init skips missing optional helper instead of dispatching the default trap", [](TestCase &t)
+        tc.Run("sceSdRemote voice transfers and register writes drive the SPU2 mixer", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            std::vector<uint8_t> rdram(PS2_RAM_SIZE, 0u);
+            constexpr uint32_t kStackAddr = 0x00100000u;
+            constexpr uint32_t kSourceAddr = 0x00030000u;
+            constexpr uint32_t kSpuAddr = 0x00005000u;
+            constexpr uint32_t kVoice = 3u;
+            constexpr uint32_t kCore = 1u;
+            const uint32_t entry = (kVoice << 1) | kCore;
+
+            // One shift-0 block of nibble 1 that loops back onto itself.
+            std::memset(rdram.data() + kSourceAddr, 0x11, 16u);
+            rdram[kSourceAddr] = 0x00u;
+            rdram[kSourceAddr + 1u] = 0x07u;
+
+            auto remote = [&](uint32_t command, uint32_t arg0, uint32_t arg1,
+                              uint32_t arg4 = 0u, uint32_t arg5 = 0u, uint32_t arg6 = 0u)
+            {
+                R5900Context ctx{};
+                setRegU32(ctx, 29, kStackAddr);
+                setRegU32(ctx, 4, 1u);
+                setRegU32(ctx, 5, command);
+                setRegU32(ctx, 6, arg0);
+                setRegU32(ctx, 7, arg1);
+                setRegU32(ctx, 8, arg4);
+                setRegU32(ctx, 9, arg5);
+                setRegU32(ctx, 10, arg6);
+                ps2_stubs::sceSdRemote(rdram.data(), &ctx, &runtime);
+                return getRegU32(&ctx, 2);
+            };
+
+            R5900Context initCtx{};
+            ps2_stubs::sceSdRemoteInit(rdram.data(), &initCtx, &runtime);
+
+            PS2Spu2 &spu2 = runtime.audioBackend().spu2();
+            remote(0x80D0u, kCore, 0u, kSourceAddr, kSpuAddr, 16u);
+            t.Equals(spu2.readRam16(kSpuAddr + 2u), static_cast<uint16_t>(0x1111u),
+                     "voice transfer should copy guest data into SPU2 RAM");
+
+            remote(0x8050u, (0x20u << 8) | (1u << 6) | entry, kSpuAddr);
+            remote(0x8010u, (0x02u << 8) | entry, 0x1000u);
+            remote(0x8010u, (0x03u << 8) | entry, 0x000Fu);
+            remote(0x8010u, (0x00u << 8) | entry, 0x3FFFu);
+            remote(0x8010u, (0x01u << 8) | entry, 0x3FFFu);
+            t.Equals(remote(0x8020u, (0x02u << 8) | entry, 0u), 0x1000u,
+                     "voice parameters should read back through sceSdGetParam");
+
+            remote(0x8030u, (0x15u << 8) | (1u << 7) | kCore, 1u << kVoice);
+            const uint32_t voice = kCore * PS2Spu2::kVoicesPerCore + kVoice;
+            t.IsTrue(spu2.voiceActive(voice), "SD_S_KON should key on the addressed core's voice");
+
+            std::vector<int16_t> out(256u * 2u, 0);
+            spu2.mix(out.data(), 256u);
+            t.IsTrue(spu2.voiceActive(voice), "a repeating block should keep the voice playing");
+            t.IsTrue(out[200u * 2u] > 4000 && out[200u * 2u + 1u] > 4000,
+                     "the looped block should keep producing the decoded sample on both channels");
+
+            remote(0x8030u, (0x16u << 8) | (1u << 7) | kCore, 1u << kVoice);
+            spu2.mix(out.data(), 16u);
+            t.IsFalse(spu2.voiceActive(voice), "SD_S_KOFF should release the voice");
+        });
+
+        tc.Run("IPU init resets IPU_CTRL and IPU_CMD without a guest helper", [](TestCase &t)
         {
             PS2Runtime runtime;
             std::vector<uint8_t> rdram(PS2_RAM_SIZE, 0u);
@@ -909,37 +1206,110 @@ void register_ps2_runtime_expansion_tests()
             ps2_stubs::sceIpuInit(rdram.data(), &ctx, &runtime);
 
             t.IsFalse(runtime.isStopRequested(),
-                      "sceIpuInit should tolerate the missing optional SetD4 helper");
+                      "sceIpuInit should not dispatch into guest code");
             t.Equals(runtime.memory().read32(0x10002010u), 0x40000000u,
-                     "sceIpuInit should still program IPU_CTRL");
+                     "sceIpuInit should reset the IPU through IPU_CTRL");
             t.Equals(runtime.memory().read32(0x10002000u), 0u,
                      "sceIpuInit should leave IPU_CMD reset after initialization");
         });
 
-        tc.Run("IPU init executes its guest helper as a scheduler invocation", [](TestCase &t)
+        tc.Run("IPU init resets a command left waiting for input", [](TestCase &t)
         {
             PS2Runtime runtime;
             std::vector<uint8_t> rdram(PS2_RAM_SIZE, 0u);
-            runtime.registerFunction(kIpuInitMainPc, testIpuInitMain);
-            runtime.registerFunction(kIpuInitResumePc, testIpuInitResume);
-            runtime.registerFunction(kIpuSetD4Pc, testIpuSetD4);
-            gIpuSetD4Hits.store(0u, std::memory_order_release);
-            gIpuSetD4Argument.store(0u, std::memory_order_release);
-            gIpuInitResult.store(-999, std::memory_order_release);
-
-            R5900Context context{};
-            context.pc = kIpuInitMainPc;
-            runtime.eeScheduler().reset(rdram.data(), context);
-            runtime.eeScheduler().run();
+            R5900Context ctx{};
+            t.IsTrue(runtime.memory().initialize(), "memory should initialize");
 
-            t.Equals(gIpuSetD4Hits.load(std::memory_order_acquire), 1u,
-                     "the optional guest helper should execute exactly once through the dispatcher");
-            t.Equals(gIpuSetD4Argument.load(std::memory_order_acquire), 1u,
-                     "the invocation should receive the SetD4 enable argument");
-            t.Equals(gIpuInitResult.load(std::memory_order_acquire), 0,
-                     "the HLE completion should resume the preserved base context with success");
-            t.Equals(runtime.memory().read32(0x10002010u), 0x40000000u,
-                     "IPU initialization should finish only after the guest invocation completes");
+            runtime.memory().write32(0x10002000u, 0x40000000u); // FDEC with no input
+            t.IsTrue(runtime.memory().ipu().busy(), "FDEC should wait for input");
+
+            ps2_stubs::sceIpuInit(rdram.data(), &ctx, &runtime);
+
+            t.Equals(getRegS32(ctx, 2), 0, "sceIpuInit should report success");
+            t.IsFalse(runtime.memory().ipu().busy(), "IPU_CTRL.RST should drop the waiting command");
+            t.Equals(runtime.memory().read32(0x10002010u) & 0x80000000u, 0u, "IPU_CTRL.BUSY should be clear");
+        });
+
+        tc.Run("IPU init restores the default matrices and VQ CLUT", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            std::vector<uint8_t> rdram(PS2_RAM_SIZE, 0u);
+            R5900Context ctx{};
+            t.IsTrue(runtime.memory().initialize(), "memory should initialize");
+            PS2Ipu &ipu = runtime.memory().ipu();
+            const std::array<uint8_t, 64> defaultIntra = ipu.intraMatrix();
+            const std::array<uint8_t, 64> defaultNonIntra = ipu.nonIntraMatrix();
+            const std::array<uint16_t, 16> defaultClut = ipu.vqClut();
+            t.IsTrue(defaultClut[0] == 0x0000u && defaultClut[15] == 0x7FFFu,
+                     "the default CLUT should run from black to white");
+
+            // SETIQ intra, SETIQ non-intra and SETVQ with every byte 0x11.
+            uint8_t qword[PS2Ipu::kQwordBytes];
+            std::memset(qword, 0x11, sizeof(qword));
+            const auto upload = [&](uint32_t command, uint32_t qwords)
+            {
+                for (uint32_t i = 0; i < qwords; ++i)
+                    ipu.writeInput(qword);
+                ipu.writeCommand(command);
+                t.IsFalse(ipu.busy(), "table upload should complete");
+            };
+            upload(PS2Ipu::kSetiq << 28u, 4u);
+            upload((PS2Ipu::kSetiq << 28u) | (1u << 27u), 4u);
+            upload(PS2Ipu::kSetvq << 28u, 2u);
+            t.Equals(static_cast<uint32_t>(ipu.intraMatrix()[0]), 0x11u, "SETIQ should load the intra matrix");
+            t.Equals(static_cast<uint32_t>(ipu.nonIntraMatrix()[0]), 0x11u, "SETIQ should load the non-intra matrix");
+            t.Equals(static_cast<uint32_t>(ipu.vqClut()[0]), 0x1111u, "SETVQ should load the CLUT");
+
+            ps2_stubs::sceIpuInit(rdram.data(), &ctx, &runtime);
+
+            t.Equals(getRegS32(ctx, 2), 0, "sceIpuInit should report success");
+            t.IsTrue(ipu.intraMatrix() == defaultIntra, "sceIpuInit should restore the default intra matrix");
+            t.IsTrue(ipu.nonIntraMatrix() == defaultNonIntra, "sceIpuInit should restore the default non-intra matrix");
+            t.IsTrue(ipu.vqClut() == defaultClut, "sceIpuInit should restore the default VQ CLUT");
+        });
+
+        tc.Run("IPU stop/restart DMA saves the toIPU channel and sync waits for it", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            t.IsTrue(runtime.memory().initialize(), "memory should initialize");
+            PS2Memory &mem = runtime.memory();
+            uint8_t *rdram = mem.getRDRAM();
+            R5900Context ctx{};
+
+            constexpr uint32_t kInputAddr = 0x00010000u;
+            constexpr uint32_t kEnvAddr = 0x00011000u;
+            std::memset(rdram + kInputAddr, 0xA5, 16u);
+
+            mem.write32(0x10002000u, 0x40000000u); // FDEC
+            mem.write32(0x1000E000u, 0u);          // hold the DMAC so STR stays set
+            mem.write32(0x1000B410u, kInputAddr);
+            mem.write32(0x1000B420u, 1u);
+            mem.write32(0x1000B400u, 0x100u);
+
+            setRegU32(ctx, 4, kEnvAddr);
+            ps2_stubs::sceIpuStopDMA(rdram, &ctx, &runtime);
+            t.Equals(mem.read32(0x1000B400u) & 0x100u, 0u, "sceIpuStopDMA should clear toIPU STR");
+            uint32_t saved[9] = {};
+            std::memcpy(saved, rdram + kEnvAddr, sizeof(saved));
+            t.Equals(saved[0], kInputAddr, "the env should keep toIPU MADR");
+            t.Equals(saved[2], 1u, "the env should keep toIPU QWC");
+            t.Equals(saved[3] & 0x100u, 0x100u, "the env should record that toIPU was running");
+
+            mem.write32(0x1000E000u, 1u);
+            setRegU32(ctx, 4, 1u);
+            ps2_stubs::sceIpuSync(rdram, &ctx, &runtime);
+            t.Equals(getRegS32(ctx, 2), 1, "a stopped toIPU channel should leave FDEC busy");
+            setRegU32(ctx, 4, 0u);
+            ps2_stubs::sceIpuSync(rdram, &ctx, &runtime);
+            t.Equals(getRegS32(ctx, 2), -1, "a blocking sync with no input coming should time out");
+
+            setRegU32(ctx, 4, kEnvAddr);
+            ps2_stubs::sceIpuRestartDMA(rdram, &ctx, &runtime);
+            setRegU32(ctx, 4, 0u);
+            ps2_stubs::sceIpuSync(rdram, &ctx, &runtime);
+            t.Equals(getRegS32(ctx, 2), 0, "restarting toIPU should let FDEC finish");
+            t.Equals(mem.read32(0x1000B420u), 0u, "the restarted channel should consume its qword");
+            t.Equals(mem.read32(0x1000B400u) & 0x100u, 0u, "the restarted channel should complete");
         });
 
         tc.Run("sprintf consumes EE varargs from a2 a3 t0 and preserves width formatting", [](TestCase &t)
@@ -1207,6 +1577,46 @@ void register_ps2_runtime_expansion_tests()
                      "VU0 cache should rebuild after a direct MicroMem write");
         });
 
+        tc.Run("VU0 microprogram calls see macro-mode register changes between calls", [](TestCase &t)
+        {
+            PS2Runtime runtime;
+            t.IsTrue(runtime.memory().initialize(), "PS2Memory initialize should succeed");
+            t.IsTrue(runtime.syncCoreSubsystems(), "runtime core subsystems should bind");
+
+            uint8_t *const code = runtime.memory().getVU0Code();
+            std::memset(code, 0, PS2_VU0_CODE_SIZE);
+            constexpr uint32_t kVuUpperNop = 0x000002FFu;
+            constexpr uint32_t kVuUpperEndNop = 0x400002FFu;
+            writeVuInstructionPair(code, 0u, makeVuIaddiu(2u, 1u, 1), makeVuAdd(0xFu, 2u, 1u, 1u));
+            writeVuInstructionPair(code, 8u, 0u, kVuUpperEndNop);
+            writeVuInstructionPair(code, 16u, 0u, kVuUpperNop);
+
+            R5900Context ctx{};
+            ctx.vu0_vf[1] = _mm_set_ps(4.0f, 3.0f, 2.0f, 1.0f);
+            ctx.vu0_vf[3] = _mm_set1_ps(9.0f);
+            ctx.vi[1] = 10u;
+            runtime.executeVU0Microprogram(runtime.memory().getRDRAM(), &ctx, 0u);
+
+            alignas(16) float vf2[4]{};
+            _mm_storeu_ps(vf2, ctx.vu0_vf[2]);
+            t.Equals(vf2[3], 8.0f, "first call should double VF1");
+            t.Equals(static_cast<uint32_t>(ctx.vi[2]), 11u, "first call should increment VI1");
+
+            // Macro-mode code writes the COP2 registers straight into the
+            // context between calls.
+            ctx.vu0_vf[1] = _mm_set1_ps(-0.5f);
+            ctx.vu0_vf[3] = _mm_setzero_ps();
+            ctx.vi[1] = 20u;
+            runtime.executeVU0Microprogram(runtime.memory().getRDRAM(), &ctx, 0u);
+
+            _mm_storeu_ps(vf2, ctx.vu0_vf[2]);
+            alignas(16) float vf3[4]{};
+            _mm_storeu_ps(vf3, ctx.vu0_vf[3]);
+            t.Equals(vf2[0], -1.0f, "second call should read the updated VF1");
+            t.Equals(vf3[0], 0.0f, "registers the program leaves alone should keep the context value");
+            t.Equals(static_cast<uint32_t>(ctx.vi[2]), 21u, "second call should read the updated VI1");
+        });
+
         tc.Run("VU0 FBRST TE gates a T-bit microprogram stop", [](TestCase &t)
         {
             PS2Runtime runtime;
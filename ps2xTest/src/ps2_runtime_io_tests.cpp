@@ -3,11 +3,15 @@
 #include "ps2_syscalls.h"
 #include "ps2_stubs.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <memory>
 #include <fstream>
 #include <vector>
 #include <cstring>
+#include <cstdlib>
 #include <chrono>
+#include <thread>
 
 using namespace ps2_syscalls;
 
@@ -89,6 +93,44 @@ namespace
         std::memset(&ctx, 0, sizeof(ctx));
     }
 
+    int32_t callFio(void (*fn)(uint8_t *, R5900Context *, PS2Runtime *), uint8_t *rdram,
+                    uint32_t a0, uint32_t a1 = 0u, uint32_t a2 = 0u, PS2Runtime *runtime = nullptr)
+    {
+        R5900Context ctx{};
+        setRegU32(ctx, 4, a0);
+        setRegU32(ctx, 5, a1);
+        setRegU32(ctx, 6, a2);
+        fn(rdram, &ctx, runtime);
+        return getRegS32(&ctx, 2);
+    }
+
+    // nullptr value removes the variable.
+    void setEnvironmentVariable(const char *name, const char *value)
+    {
+#if defined(_WIN32)
+        _putenv_s(name, value ? value : "");
+#else
+        if (value)
+            setenv(name, value, 1);
+        else
+            unsetenv(name);
+#endif
+    }
+
+    std::vector<uint8_t> makePatternFile(const std::filesystem::path &path, size_t size)
+    {
+        std::vector<uint8_t> bytes(size);
+        uint32_t state = 0x1234567u;
+        for (uint8_t &byte : bytes)
+        {
+            state = state * 1664525u + 1013904223u;
+            byte = static_cast<uint8_t>(state >> 24);
+        }
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    }
+
     int32_t syncMc(std::vector<uint8_t> &rdram, int32_t *cmdOut = nullptr)
     {
         R5900Context syncCtx{};
@@ -344,6 +386,316 @@ void register_ps2_runtime_io_tests()
                 "mc0: directory should NOT exist under cdRoot");
         });
 
+        tc.Run("fioRead serves concurrent readers on separate descriptors", [](TestCase &t)
+        {
+            TestContext test;
+
+            constexpr size_t kFileSize = 48u * 1024u;
+            constexpr int kThreads = 8;
+            constexpr uint32_t kThreadBufferBase = 0x100000u;
+            constexpr uint32_t kThreadBufferStride = 0x10000u;
+            const std::vector<uint8_t> expected = makePatternFile(test.paths.cdRoot / "stream.bin", kFileSize);
+            writeGuestString(test.rdram.data(), GUEST_STRING_AREA_START, "host0:stream.bin");
+
+            std::vector<int32_t> fds(kThreads, -1);
+            std::vector<int32_t> totals(kThreads, 0);
+            std::vector<std::thread> workers;
+            for (int i = 0; i < kThreads; ++i)
+            {
+                workers.emplace_back([&, i]()
+                {
+                    uint8_t *rdram = test.rdram.data();
+                    const uint32_t bufAddr = kThreadBufferBase + static_cast<uint32_t>(i) * kThreadBufferStride;
+                    // Uneven chunk sizes so no two readers stay in step.
+                    const uint32_t chunk = 1000u + static_cast<uint32_t>(i) * 331u;
+                    for (int pass = 0; pass < 4; ++pass)
+                    {
+                        const int32_t fd = callFio(fioOpen, rdram, GUEST_STRING_AREA_START, PS2_FIO_O_RDONLY);
+                        fds[i] = fd;
+                        int32_t total = 0;
+                        while (fd >= 0)
+                        {
+                            const int32_t got = callFio(fioRead, rdram, static_cast<uint32_t>(fd),
+                                                        bufAddr + static_cast<uint32_t>(total), chunk);
+                            if (got <= 0)
+                                break;
+                            total += got;
+                        }
+                        totals[i] = total;
+                        callFio(fioClose, rdram, static_cast<uint32_t>(fd));
+                    }
+                });
+            }
+            for (std::thread &worker : workers)
+            {
+                worker.join();
+            }
+
+            for (int i = 0; i < kThreads; ++i)
+            {
+                t.IsTrue(fds[i] >= 0, "every reader should get a descriptor");
+                t.Equals(totals[i], static_cast<int32_t>(kFileSize), "every reader should see the whole file");
+                const uint8_t *buf = test.rdram.data() + kThreadBufferBase + static_cast<uint32_t>(i) * kThreadBufferStride;
+                t.IsTrue(std::memcmp(buf, expected.data(), kFileSize) == 0,
+                         "every reader should receive the file bytes in order");
+            }
+        });
+
+        tc.Run("fioLseek positions are per descriptor", [](TestCase &t)
+        {
+            TestContext test;
+
+            constexpr size_t kFileSize = 4096u;
+            const std::vector<uint8_t> expected = makePatternFile(test.paths.cdRoot / "seek.bin", kFileSize);
+            writeGuestString(test.rdram.data(), GUEST_STRING_AREA_START, "host0:seek.bin");
+            uint8_t *rdram = test.rdram.data();
+            const uint32_t bufA = GUEST_BUFFER_AREA_START;
+            const uint32_t bufB = GUEST_BUFFER_AREA_START + 0x100;
+
+            const int32_t fdA = callFio(fioOpen, rdram, GUEST_STRING_AREA_START, PS2_FIO_O_RDONLY);
+            const int32_t fdB = callFio(fioOpen, rdram, GUEST_STRING_AREA_START, PS2_FIO_O_RDONLY);
+            t.IsTrue(fdA >= 0 && fdB >= 0 && fdA != fdB, "two opens of one file should get distinct descriptors");
+
+            t.Equals(callFio(fioLseek, rdram, static_cast<uint32_t>(fdA), 100u, PS2_FIO_SEEK_SET), 100,
+                     "SEEK_SET should return the new offset");
+            t.Equals(callFio(fioRead, rdram, static_cast<uint32_t>(fdA), bufA, 16u), 16, "read after seek");
+            t.IsTrue(std::memcmp(rdram + bufA, expected.data() + 100, 16) == 0, "read should start at the seek offset");
+
+            t.Equals(callFio(fioRead, rdram, static_cast<uint32_t>(fdB), bufB, 16u), 16, "read on second descriptor");
+            t.IsTrue(std::memcmp(rdram + bufB, expected.data(), 16) == 0,
+                     "seeking one descriptor should not move another");
+
+            t.Equals(callFio(fioLseek, rdram, static_cast<uint32_t>(fdA), static_cast<uint32_t>(-16), PS2_FIO_SEEK_CUR), 100,
+                     "SEEK_CUR should be relative to the descriptor position");
+            t.Equals(callFio(fioLseek, rdram, static_cast<uint32_t>(fdB), static_cast<uint32_t>(-8), PS2_FIO_SEEK_END),
+                     static_cast<int32_t>(kFileSize - 8u), "SEEK_END should be relative to the file size");
+            t.Equals(callFio(fioRead, rdram, static_cast<uint32_t>(fdB), bufB, 16u), 8, "read at end of file should be short");
+            t.Equals(callFio(fioRead, rdram, static_cast<uint32_t>(fdB), bufB, 16u), 0, "read past end of file should return 0");
+            t.Equals(callFio(fioLseek, rdram, static_cast<uint32_t>(fdA), static_cast<uint32_t>(-1), PS2_FIO_SEEK_SET), -1,
+                     "seeking before the start should fail");
+
+            t.Equals(callFio(fioClose, rdram, static_cast<uint32_t>(fdA)), 0, "close first descriptor");
+            t.Equals(callFio(fioRead, rdram, static_cast<uint32_t>(fdA), bufA, 16u), -1, "read on a closed descriptor should fail");
+            t.Equals(callFio(fioRead, rdram, static_cast<uint32_t>(fdB), bufB, 16u), 0,
+                     "closing one descriptor should leave the other open");
+            t.Equals(callFio(fioClose, rdram, static_cast<uint32_t>(fdB)), 0, "close second descriptor");
+            t.Equals(callFio(fioClose, rdram, static_cast<uint32_t>(fdB)), -1, "double close should fail");
+        });
+
+        tc.Run("VAG stream decoder matches whole-buffer decode for any chunking", [](TestCase &t)
+        {
+            constexpr uint32_t kBlocks = 150u;
+            std::vector<uint8_t> vag(48u + kBlocks * 16u, 0);
+            const uint8_t header[] = {'V', 'A', 'G', 'p'};
+            std::memcpy(vag.data(), header, sizeof(header));
+            const uint32_t dataSize = kBlocks * 16u;
+            vag[0x0c] = static_cast<uint8_t>(dataSize >> 24);
+            vag[0x0d] = static_cast<uint8_t>(dataSize >> 16);
+            vag[0x0e] = static_cast<uint8_t>(dataSize >> 8);
+            vag[0x0f] = static_cast<uint8_t>(dataSize);
+            vag[0x12] = 0x56; // 22050 Hz
+            vag[0x13] = 0x22;
+            uint32_t state = 99u;
+            for (size_t i = 48; i < vag.size(); ++i)
+            {
+                state = state * 1664525u + 1013904223u;
+                vag[i] = static_cast<uint8_t>(state >> 24);
+            }
+
+            std::vector<int16_t> wholePcm;
+            size_t largestChunk = 0;
+            PS2VagStreamDecoder whole([&](const int16_t *samples, size_t count)
+                                      {
+                                          wholePcm.insert(wholePcm.end(), samples, samples + count);
+                                          largestChunk = std::max(largestChunk, count);
+                                      });
+            t.IsTrue(whole.feed(vag.data(), 48u + PS2VagStreamDecoder::kChunkBlocks * 16u),
+                     "whole-buffer feed should accept a VAG file");
+            t.Equals(wholePcm.size(), PS2VagStreamDecoder::kChunkSamples,
+                     "a full chunk should reach the sink before the file ends");
+            whole.feed(vag.data() + 48u + PS2VagStreamDecoder::kChunkBlocks * 16u,
+                       vag.size() - 48u - PS2VagStreamDecoder::kChunkBlocks * 16u);
+            t.IsTrue(whole.complete(), "whole-buffer feed should decode every block");
+            t.Equals(whole.sampleRate(), 22050u, "sample rate should come from the header");
+            t.Equals(wholePcm.size(), static_cast<size_t>(kBlocks * 28u), "each block should give 28 samples");
+            t.IsTrue(largestChunk <= PS2VagStreamDecoder::kChunkSamples, "chunks should stay bounded");
+
+            for (size_t chunk : {size_t{1}, size_t{5}, size_t{16}, size_t{47}, size_t{100}})
+            {
+                std::vector<int16_t> streamedPcm;
+                PS2VagStreamDecoder streamed([&](const int16_t *samples, size_t count)
+                                             { streamedPcm.insert(streamedPcm.end(), samples, samples + count); });
+                for (size_t offset = 0; offset < vag.size(); offset += chunk)
+                {
+                    streamed.feed(vag.data() + offset, std::min(chunk, vag.size() - offset));
+                }
+                t.IsTrue(streamed.complete(), "chunked feed should decode every block");
+                t.IsTrue(streamedPcm == wholePcm, "chunked feed should produce identical samples");
+            }
+
+            PS2VagStreamDecoder notVag;
+            std::vector<uint8_t> other(vag);
+            other[0] = 'X';
+            t.IsFalse(notVag.feed(other.data(), other.size()), "a file without the VAG magic should be rejected");
+            t.IsTrue(notVag.failed(), "rejected stream should stay failed");
+        });
+
+        tc.Run("PS2X_FIO_VAG_STREAMING switches fioRead VAG decoding", [](TestCase &t)
+        {
+            TestContext test;
+            PS2Runtime runtime;
+
+            constexpr uint32_t kBlocks = 8u;
+            std::vector<uint8_t> vag(48u + kBlocks * 16u, 0);
+            const uint8_t header[] = {'V', 'A', 'G', 'p'};
+            std::memcpy(vag.data(), header, sizeof(header));
+            vag[0x0f] = static_cast<uint8_t>(kBlocks * 16u);
+            vag[0x12] = 0xAC; // 44100 Hz
+            vag[0x13] = 0x44;
+            {
+                std::ofstream file(test.paths.cdRoot / "voice.vag", std::ios::binary);
+                file.write(reinterpret_cast<const char *>(vag.data()), static_cast<std::streamsize>(vag.size()));
+            }
+            writeGuestString(test.rdram.data(), GUEST_STRING_AREA_START, "host0:voice.vag");
+
+            const auto readWholeFile = [&]()
+            {
+                uint8_t *rdram = test.rdram.data();
+                const int32_t fd = callFio(fioOpen, rdram, GUEST_STRING_AREA_START, PS2_FIO_O_RDONLY);
+                const int32_t got = callFio(fioRead, rdram, static_cast<uint32_t>(fd), GUEST_BUFFER_AREA_START,
+                                            static_cast<uint32_t>(vag.size()), &runtime);
+                callFio(fioClose, rdram, static_cast<uint32_t>(fd), 0u, 0u, &runtime);
+                return got;
+            };
+
+            t.IsFalse(configureFioVagStreamingFromEnvironment(), "streaming should be off by default");
+            t.Equals(readWholeFile(), static_cast<int32_t>(vag.size()), "read with the default setting");
+            t.Equals(runtime.audioBackend().vagCache().entryCount(), static_cast<size_t>(0u),
+                     "nothing should reach the audio backend by default");
+
+            setEnvironmentVariable("PS2X_FIO_VAG_STREAMING", "0");
+            t.IsFalse(configureFioVagStreamingFromEnvironment(), "\"0\" should turn streaming off");
+            t.Equals(readWholeFile(), static_cast<int32_t>(vag.size()), "read with streaming off");
+            t.Equals(runtime.audioBackend().vagCache().entryCount(), static_cast<size_t>(0u),
+                     "nothing should reach the audio backend while streaming is off");
+
+            setEnvironmentVariable("PS2X_FIO_VAG_STREAMING", "1");
+            t.IsTrue(configureFioVagStreamingFromEnvironment(), "\"1\" should turn streaming on");
+            t.Equals(readWholeFile(), static_cast<int32_t>(vag.size()), "read with streaming on");
+            t.Equals(runtime.audioBackend().vagCache().entryCount(), static_cast<size_t>(1u),
+                     "the decoded VAG should reach the audio backend");
+
+            setEnvironmentVariable("PS2X_FIO_VAG_STREAMING", nullptr);
+            t.IsTrue(configureFioVagStreamingFromEnvironment(), "an unset variable should keep the setting");
+            setFioVagStreaming(false);
+        });
+
+        tc.Run("VAG cache turns identical re-uploads into a lookup and evicts least recently used", [](TestCase &t)
+        {
+            constexpr uint32_t kBlocks = 24u;
+            std::vector<uint8_t> vag(48u + kBlocks * 16u, 0);
+            const uint8_t header[] = {'V', 'A', 'G', 'p'};
+            std::memcpy(vag.data(), header, sizeof(header));
+            vag[0x0f] = static_cast<uint8_t>(kBlocks * 16u);
+            vag[0x12] = 0xAC; // 44100 Hz
+            vag[0x13] = 0x44;
+            uint32_t state = 7u;
+            for (size_t i = 48; i < vag.size(); ++i)
+            {
+                state = state * 1664525u + 1013904223u;
+                vag[i] = static_cast<uint8_t>(state >> 24);
+            }
+
+            PS2AudioBackend backend;
+            backend.onVagTransferFromBuffer(vag.data(), static_cast<uint32_t>(vag.size()), 0x00100000u);
+            backend.onVagTransferFromBuffer(vag.data(), static_cast<uint32_t>(vag.size()), 0x00200000u);
+            t.Equals(backend.vagCache().entryCount(), static_cast<size_t>(1u), "an identical bank should be cached once");
+            t.Equals(backend.vagCache().hits(), static_cast<uint64_t>(1u), "the re-upload should be a cache hit");
+
+            uint64_t key = 0;
+            uint32_t sampleRate = 0;
+            t.IsTrue(ps2_vag::contentKey(vag.data(), static_cast<uint32_t>(vag.size()), key, sampleRate),
+                     "content key should accept a VAG file");
+            PS2VagStreamDecoder streamed;
+            streamed.feed(vag.data(), 100u);
+            streamed.feed(vag.data() + 100u, vag.size() - 100u);
+            t.Equals(streamed.contentKey(), key, "streamed and whole-buffer decodes should share a cache key");
+
+            std::vector<uint8_t> changed(vag);
+            changed[60] ^= 0x01u;
+            uint64_t changedKey = 0;
+            ps2_vag::contentKey(changed.data(), static_cast<uint32_t>(changed.size()), changedKey, sampleRate);
+            t.IsTrue(changedKey != key, "a one-bit change in the ADPCM data should change the key");
+
+            PS2VagCache cache(5000u);
+            cache.insert(1u, std::vector<int16_t>(1000u));
+            cache.insert(2u, std::vector<int16_t>(1000u));
+            t.IsTrue(static_cast<bool>(cache.find(1u)), "entry 1 should still fit the budget");
+            cache.insert(3u, std::vector<int16_t>(1000u));
+            t.IsFalse(static_cast<bool>(cache.find(2u)), "the least recently used entry should be evicted first");
+            t.IsTrue(static_cast<bool>(cache.find(1u)), "a recently found entry should survive eviction");
+            t.Equals(cache.sizeBytes(), static_cast<size_t>(4000u), "evicted bytes should leave the budget");
+        });
+
+        tc.Run("SPU2 mixer decodes ADPCM voices with pitch envelope and volume", [](TestCase &t)
+        {
+            constexpr uint32_t kVoiceAddr = 0x5000u;
+            // Two shift-0 filter-0 blocks of constant nibble 1 (4096); the
+            // second ends the sample without repeating.
+            std::vector<uint8_t> blocks(32u, 0x11u);
+            blocks[0] = 0x00u;
+            blocks[1] = 0x00u;
+            blocks[16] = 0x00u;
+            blocks[17] = 0x01u;
+
+            auto spu2 = std::make_unique<PS2Spu2>();
+            spu2->writeRam(kVoiceAddr, blocks.data(), static_cast<uint32_t>(blocks.size()));
+            t.Equals(spu2->readRam16(kVoiceAddr + 2u), static_cast<uint16_t>(0x1111u),
+                     "voice data should land at its SPU2 address");
+
+            spu2->setVoiceStartAddress(1u, kVoiceAddr);
+            spu2->setVoiceParam(1u, PS2Spu2::VoiceParam::Pitch, 0x1000u);
+            spu2->setVoiceParam(1u, PS2Spu2::VoiceParam::Adsr1, 0x000Fu);
+            spu2->setVoiceParam(1u, PS2Spu2::VoiceParam::VolumeLeft, 0x3FFFu);
+            spu2->setVoiceParam(1u, PS2Spu2::VoiceParam::VolumeRight, 0u);
+            spu2->keyOn(0u, 1u << 1);
+            t.IsTrue(spu2->voiceActive(1u), "key-on should start the voice");
+
+            std::vector<int16_t> out(128u * 2u, 0);
+            spu2->mix(out.data(), 128u);
+            t.IsTrue(out[10u * 2u] > 4000 && out[10u * 2u] <= 4096,
+                     "a full-volume voice should play the decoded sample after the attack");
+            bool rightSilent = true;
+            for (size_t i = 0; i < 128u; ++i)
+                rightSilent = rightSilent && out[i * 2u + 1u] == 0;
+            t.IsTrue(rightSilent, "a zero right volume should keep the right channel silent");
+            t.IsFalse(spu2->voiceActive(1u), "an END block without REPEAT should stop the voice");
+            t.Equals(out[100u * 2u], static_cast<int16_t>(0), "a stopped voice should mix silence");
+
+            // Half pitch plays each decoded sample for two output frames, so
+            // the same two blocks last twice as long.
+            spu2->setVoiceParam(1u, PS2Spu2::VoiceParam::Pitch, 0x0800u);
+            spu2->keyOn(0u, 1u << 1);
+            spu2->mix(out.data(), 100u);
+            t.IsTrue(spu2->voiceActive(1u), "a half-pitch voice should still be playing");
+            spu2->keyOff(0u, 1u << 1);
+            spu2->mix(out.data(), 16u);
+            t.IsFalse(spu2->voiceActive(1u), "key-off should release the envelope to silence");
+
+            PS2AudioRing ring(6u);
+            t.Equals(ring.capacity(), static_cast<size_t>(8u), "ring capacity should round up to a power of two");
+            const int16_t frames[] = {1, -1, 2, -2, 3, -3, 4, -4, 5, -5, 6, -6};
+            int16_t readBack[12] = {};
+            t.Equals(ring.write(frames, 6u), static_cast<size_t>(6u), "the ring should accept frames up to its space");
+            t.Equals(ring.read(readBack, 4u), static_cast<size_t>(4u), "the reader should drain what it asks for");
+            t.Equals(ring.write(frames, 6u), static_cast<size_t>(6u), "writes should wrap around the ring");
+            t.Equals(ring.write(frames, 1u), static_cast<size_t>(0u), "a full ring should refuse more frames");
+            t.Equals(ring.read(readBack, 6u), static_cast<size_t>(6u), "reads should wrap around the ring");
+            t.Equals(readBack[0], static_cast<int16_t>(5), "leftover frames should be read first");
+            t.Equals(readBack[4], static_cast<int16_t>(1), "frames should come back in order across the wrap");
+            t.Equals(readBack[5], static_cast<int16_t>(-1), "channels should stay interleaved");
+        });
+
         tc.Run("sceMc open write read and close roundtrip through sync", [](TestCase &t)
         {
             TestContext test;
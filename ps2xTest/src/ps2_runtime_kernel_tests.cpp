@@ -5,10 +5,14 @@
 #include "ps2_stubs.h"
 #include "runtime/ee_scheduler.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <memory>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -543,12 +547,55 @@ namespace
             std::memset(&ctx, 0, sizeof(ctx));
         }
     };
+
+    EeSemaphore makeSemaphore(int id, int count = 0)
+    {
+        EeSemaphore sema;
+        sema.id = id;
+        sema.count = count;
+        return sema;
+    }
+
+    EeEventFlag makeEventFlag(int id)
+    {
+        EeEventFlag flag;
+        flag.id = id;
+        return flag;
+    }
 }
 
 void register_ps2_runtime_kernel_tests()
 {
     MiniTest::Case("PS2RuntimeKernel", [](TestCase &tc)
     {
+        tc.Run("GPR scalar accessors share storage with the MMI vector view", [](TestCase &t)
+        {
+            R5900Context ctx;
+            R5900Context *cpu = &ctx;
+
+            SET_GPR_VEC(cpu, 8, _mm_set_epi64x(static_cast<int64_t>(K_EXPECTED_UPPER64), 0x0123456789ABCDEFll));
+            t.Equals(GPR_U64(cpu, 8), 0x0123456789ABCDEFull, "GPR_U64 should read the low lane of a vector write");
+            t.Equals(GPR_U32(cpu, 8), 0x89ABCDEFu, "GPR_U32 should read the low word");
+            t.Equals(GPR_S32(cpu, 8), static_cast<int32_t>(0x89ABCDEFu), "GPR_S32 should read the low word as signed");
+
+            SET_GPR_U32(cpu, 8, 0x80000000u);
+            t.Equals(ctx.r[8].lo, 0xFFFFFFFF80000000ull, "32-bit writes should sign-extend into the low doubleword");
+            t.Equals(ctx.r[8].hi, K_EXPECTED_UPPER64, "32-bit writes should keep the upper doubleword");
+            t.Equals(static_cast<uint64_t>(_mm_extract_epi64(GPR_VEC(cpu, 8), 0)), 0xFFFFFFFF80000000ull,
+                     "the vector view should see scalar writes");
+
+            SET_GPR_S64(cpu, 8, -2);
+            t.Equals(GPR_S64(cpu, 8), static_cast<int64_t>(-2), "64-bit writes should round-trip");
+            t.Equals(static_cast<uint64_t>(_mm_extract_epi64(GPR_VEC(cpu, 8), 1)), K_EXPECTED_UPPER64,
+                     "64-bit writes should keep the upper doubleword");
+
+            SET_GPR_U64(cpu, 0, 0x1234u);
+            SET_GPR_VEC(cpu, 0, _mm_set1_epi32(-1));
+            t.Equals(GPR_U64(cpu, 0), 0ull, "$zero should ignore scalar and vector writes");
+            t.IsTrue(_mm_movemask_epi8(_mm_cmpeq_epi8(GPR_VEC(cpu, 0), _mm_setzero_si128())) == 0xFFFF,
+                     "$zero should read as a zero vector");
+        });
+
         tc.Run("CreateThread and CreateSema decode the exact PS2SDK EE layouts", [](TestCase &t)
         {
             TestEnv env;
@@ -645,6 +692,256 @@ void register_ps2_runtime_kernel_tests()
                       "the scheduler must publish guest execution only around the active guest call");
         });
 
+        tc.Run("EE ready queue follows priority changes across bitmap words", [](TestCase &t)
+        {
+            TestEnv env;
+            std::vector<int> trace;
+            gSchedulerTrace = &trace;
+            env.runtime.registerFunction(K_SCHED_MAIN, schedulerMainExit);
+            env.runtime.registerFunction(K_SCHED_A, schedulerTraceA);
+            env.runtime.registerFunction(K_SCHED_B, schedulerTraceB);
+
+            env.ctx.pc = K_SCHED_MAIN;
+            EeScheduler &ee = env.runtime.eeScheduler();
+            ee.reset(env.rdram.data(), env.ctx);
+            const int lowest = ee.createThread(EeThreadCreateParams{0, K_SCHED_B, 0x20000u, 0x800u, 0, 127, 0});
+            const int boosted = ee.createThread(EeThreadCreateParams{0, K_SCHED_A, 0x21000u, 0x800u, 0, 100, 0});
+            const int middle = ee.createThread(EeThreadCreateParams{0, K_SCHED_B, 0x22000u, 0x800u, 0, 60, 0});
+            ee.startThread(lowest, 0, env.ctx, false);
+            ee.startThread(boosted, 0, env.ctx, false);
+            ee.startThread(middle, 0, env.ctx, false);
+
+            int oldPriority = 0;
+            t.Equals(ee.changePriority(boosted, 2, false, oldPriority), KE_OK, "ready thread priority change should succeed");
+            t.Equals(oldPriority, 100, "changePriority should report the previous priority");
+            ee.run();
+
+            const std::vector<int> expected{1, 10, 20, 20};
+            t.IsTrue(trace == expected, "boosted thread should run before priority 60, and priority 127 last");
+        });
+
+        tc.Run("guest invocation completions store small and large captures", [](TestCase &t)
+        {
+            GuestInvocationCompletion empty;
+            t.IsFalse(static_cast<bool>(empty), "default completion should be empty");
+            std::function<void(const R5900Context &, R5900Context &)> nullFunction;
+            GuestInvocationCompletion fromNull = nullFunction;
+            t.IsFalse(static_cast<bool>(fromNull), "empty std::function should stay empty");
+
+            R5900Context completed{};
+            R5900Context parent{};
+            uint32_t calls = 0u;
+            GuestInvocationCompletion small = [&calls](const R5900Context &done, R5900Context &base)
+            {
+                base.pc = done.pc + 4u;
+                ++calls;
+            };
+            completed.pc = 0x100u;
+            GuestInvocationCompletion moved = std::move(small);
+            t.IsFalse(static_cast<bool>(small), "moved-from completion should be empty");
+            moved(completed, parent);
+            t.Equals(parent.pc, 0x104u, "inline completion should run with both contexts");
+
+            auto shared = std::make_shared<int>(0);
+            std::array<uint64_t, 16> payload{};
+            payload[15] = 7u;
+            GuestInvocationCompletion large = [shared, payload](const R5900Context &, R5900Context &)
+            {
+                *shared += static_cast<int>(payload[15]);
+            };
+            GuestInvocationCompletion largeMoved = std::move(large);
+            largeMoved(completed, parent);
+            t.Equals(*shared, 7, "heap-stored completion should keep its captures");
+            largeMoved = nullptr;
+            t.Equals(shared.use_count(), 1l, "clearing a completion should release its captures");
+            t.Equals(calls, 1u, "inline completion should run exactly once");
+        });
+
+        tc.Run("EE event ring is FIFO and reports a full ring", [](TestCase &t)
+        {
+            auto ring = std::make_unique<EeEventRing>();
+            t.IsTrue(ring->empty(), "new ring should be empty");
+
+            for (uint32_t i = 0; i < EeEventRing::kCapacity; ++i)
+            {
+                t.IsTrue(ring->tryPush(EeEvent{EeEventType::Dmac, i, 0u}), "push below capacity should succeed");
+            }
+            t.IsFalse(ring->tryPush(EeEvent{EeEventType::Dmac, 0xFFFFu, 0u}), "push into a full ring should fail");
+
+            EeEvent event{};
+            for (uint32_t i = 0; i < EeEventRing::kCapacity; ++i)
+            {
+                t.IsTrue(ring->tryPop(event), "pop should return every pushed event");
+                t.Equals(event.id, i, "events should come out in push order");
+            }
+            t.IsFalse(ring->tryPop(event), "drained ring should be empty");
+            t.IsTrue(ring->tryPush(EeEvent{EeEventType::Alarm, 7u, 0u}), "drained ring should accept new events");
+        });
+
+        tc.Run("EE event ring keeps per-producer order across threads", [](TestCase &t)
+        {
+            constexpr uint32_t kProducers = 4u;
+            constexpr uint32_t kEventsPerProducer = 20000u;
+            auto ring = std::make_unique<EeEventRing>();
+
+            std::vector<std::thread> producers;
+            for (uint32_t producer = 0; producer < kProducers; ++producer)
+            {
+                producers.emplace_back([&ring, producer]()
+                                       {
+                                           for (uint32_t i = 0; i < kEventsPerProducer; ++i)
+                                           {
+                                               while (!ring->tryPush(EeEvent{EeEventType::ExternalWake, producer, i}))
+                                               {
+                                                   std::this_thread::yield();
+                                               }
+                                           } });
+            }
+
+            std::array<uint64_t, kProducers> nextExpected{};
+            bool ordered = true;
+            uint32_t received = 0u;
+            EeEvent event{};
+            while (received < kProducers * kEventsPerProducer)
+            {
+                if (!ring->tryPop(event))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // Keep draining after a mismatch so the producers never
+                // block on a full ring and the joins below return.
+                ++received;
+                if (event.id >= kProducers || event.value != nextExpected[event.id])
+                {
+                    ordered = false;
+                    continue;
+                }
+                ++nextExpected[event.id];
+            }
+            for (std::thread &producer : producers)
+            {
+                producer.join();
+            }
+
+            t.IsTrue(ordered, "each producer's events should be popped in order");
+            t.Equals(received, kProducers * kEventsPerProducer, "every posted event should be popped exactly once");
+            t.IsTrue(ring->empty(), "ring should be empty after draining all producers");
+        });
+
+        tc.Run("EE deadline queue pops in deterministic order and cancels by handle", [](TestCase &t)
+        {
+            EeDeadlineQueue queue;
+            const auto host = std::chrono::steady_clock::time_point{} + std::chrono::seconds(1);
+            uint64_t sequence = 0u;
+            auto push = [&](uint64_t cycle, EeEventType type, uint32_t id)
+            {
+                return queue.push(EeScheduledEvent{cycle, host, EeEvent{type, id, 0u}, ++sequence});
+            };
+
+            std::vector<EeDeadlineQueue::Handle> alarms;
+            for (uint32_t id = 1u; id <= 64u; ++id)
+            {
+                alarms.push_back(push(1000u + (id * 37u) % 17u, EeEventType::Alarm, id));
+            }
+            push(1005u, EeEventType::VBlankStart, 0u);
+            push(1005u, EeEventType::VBlankStart, 0u);
+            t.IsTrue(queue.erase(alarms[0]), "a pending alarm should cancel by handle");
+            t.IsFalse(queue.erase(alarms[0]), "a cancelled handle should not erase twice");
+            t.Equals(queue.top().deadlineCycle, 1000u, "top should be the earliest deadline");
+
+            std::vector<EeScheduledEvent> due;
+            queue.takeDue(1008u, host, due);
+            bool ordered = true;
+            bool cancelledSeen = false;
+            for (size_t i = 0; i < due.size(); ++i)
+            {
+                cancelledSeen = cancelledSeen || (due[i].event.type == EeEventType::Alarm && due[i].event.id == 1u);
+                ordered = ordered && due[i].deadlineCycle <= 1008u;
+                if (i == 0u)
+                {
+                    continue;
+                }
+                const EeScheduledEvent &left = due[i - 1u];
+                const EeScheduledEvent &right = due[i];
+                ordered = ordered &&
+                          (left.deadlineCycle != right.deadlineCycle
+                               ? left.deadlineCycle < right.deadlineCycle
+                           : left.event.type != right.event.type
+                               ? left.event.type < right.event.type
+                           : left.event.id != right.event.id
+                               ? left.event.id < right.event.id
+                               : left.sequence < right.sequence);
+            }
+            t.IsTrue(ordered, "due events should come out by (cycle, type, id, sequence)");
+            t.IsFalse(cancelledSeen, "a cancelled alarm should never fire");
+            t.Equals(due.size() + queue.size(), static_cast<size_t>(65u), "every live event should be due or still queued");
+            t.IsTrue(queue.top().deadlineCycle > 1008u, "events past the cycle should stay queued");
+
+            const auto late = host + std::chrono::seconds(5);
+            const EeDeadlineQueue::Handle waiting = queue.push(EeScheduledEvent{1009u, late, EeEvent{EeEventType::Alarm, 99u, 0u}, ++sequence});
+            due.clear();
+            queue.takeDue(1009u, host, due);
+            t.IsTrue(std::none_of(due.begin(), due.end(), [](const EeScheduledEvent &item)
+                                  { return item.event.id == 99u; }),
+                     "events waiting on the host clock should stay queued");
+            t.IsTrue(queue.erase(waiting), "a deferred event should keep its handle");
+
+            while (!queue.empty())
+            {
+                queue.pop();
+            }
+            t.IsFalse(queue.erase(alarms[1]), "popped handles should be stale");
+        });
+
+        tc.Run("EE object table hands out rotating IDs with stable references", [](TestCase &t)
+        {
+            EeObjectTable<EeSemaphore> table{1, 200};
+            const int first = table.nextFreeId();
+            t.Equals(first, 1, "first allocation should use the lowest ID");
+            EeSemaphore &kept = table.emplace(first, makeSemaphore(first, 3));
+            for (int expected = 2; expected <= 100; ++expected)
+            {
+                const int id = table.nextFreeId();
+                t.Equals(id, expected, "fresh IDs should be handed out in ascending order");
+                table.emplace(id, makeSemaphore(id));
+            }
+            t.Equals(kept.count, 3, "growing the table must not move existing objects");
+            t.IsTrue(table.find(first) == &kept, "lookup should return the original object");
+
+            t.IsTrue(table.erase(50), "erasing a live ID should succeed");
+            t.IsFalse(table.erase(50), "erasing a freed ID should fail");
+            t.IsTrue(table.find(50) == nullptr, "freed ID should not resolve");
+            t.Equals(table.nextFreeId(), 101, "freed IDs should rotate behind never-used ones");
+            t.Equals(table.size(), static_cast<size_t>(99), "size should track live objects");
+
+            int visited = 0;
+            int lastId = 0;
+            bool ascending = true;
+            table.forEach([&](const EeSemaphore &item)
+                          {
+                              ascending = ascending && item.id > lastId;
+                              lastId = item.id;
+                              ++visited; });
+            t.Equals(visited, 99, "forEach should visit every live object");
+            t.IsTrue(ascending, "forEach should visit objects in ID order");
+        });
+
+        tc.Run("EE object table reports exhaustion of a bounded ID range", [](TestCase &t)
+        {
+            EeObjectTable<EeEventFlag> table{EeScheduler::kMainThreadId, 4};
+            table.emplace(EeScheduler::kMainThreadId, makeEventFlag(EeScheduler::kMainThreadId));
+            for (int expected = 2; expected <= 4; ++expected)
+            {
+                const int id = table.nextFreeId();
+                t.Equals(id, expected, "explicitly placed IDs should be skipped");
+                table.emplace(id, makeEventFlag(id));
+            }
+            t.Equals(table.nextFreeId(), 0, "full table should report no free ID");
+            table.erase(3);
+            t.Equals(table.nextFreeId(), 3, "freed ID should be reusable once the range is exhausted");
+        });
+
         tc.Run("thread lifecycle, nested suspend, WAIT-SUSPEND, and wakeup count are centralized", [](TestCase &t)
         {
             TestEnv env;
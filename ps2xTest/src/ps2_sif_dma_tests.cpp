@@ -8,11 +8,15 @@
 #include "runtime/ee_scheduler.h"
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace ps2_stubs
@@ -1134,5 +1138,80 @@ void register_ps2_sif_dma_tests()
             t.Equals(readGuestU32(env.rdram.data(), kRdAddr + 0x10u), 0x11111111u,
                      "failed sceSifGetOtherData should not overwrite rd metadata");
         });
+
+        tc.Run("IOP host reads host files straight into guest memory", [](TestCase &t)
+        {
+            TestEnv env;
+            const std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                               "ps2recomp_iop_host_positional_read.bin";
+            std::vector<uint8_t> contents(64u * 1024u);
+            for (size_t i = 0; i < contents.size(); ++i)
+            {
+                contents[i] = static_cast<uint8_t>((i * 7u) ^ (i >> 8));
+            }
+            {
+                std::ofstream out(path, std::ios::binary);
+                out.write(reinterpret_cast<const char *>(contents.data()),
+                          static_cast<std::streamsize>(contents.size()));
+            }
+
+            PS2IopHostAdapter host(env.runtime);
+            const uint64_t handle = host.openHostFile(path.string());
+            t.IsTrue(handle != 0u, "host file should open");
+
+            // Four readers share one handle, each inside its own IOP call;
+            // positional reads keep their offsets independent and the call
+            // lock is dropped while a read waits on the file.
+            constexpr uint32_t kDstAddr = 0x00100000u;
+            constexpr size_t kReaders = 4u;
+            const size_t slice = contents.size() / kReaders;
+            std::atomic<uint32_t> failures{0u};
+            std::vector<std::thread> readers;
+            for (size_t reader = 0; reader < kReaders; ++reader)
+            {
+                readers.emplace_back([&, reader]()
+                                     {
+                    for (int pass = 0; pass < 16; ++pass)
+                    {
+                        auto readerScope = host.enterCall(&env.ctx, env.rdram.data());
+                        size_t bytesRead = 0u;
+                        if (!host.readHostFileIntoGuest(handle,
+                                                        reader * slice,
+                                                        kDstAddr + static_cast<uint32_t>(reader * slice),
+                                                        slice,
+                                                        bytesRead) ||
+                            bytesRead != slice)
+                        {
+                            failures.fetch_add(1u);
+                        }
+                    } });
+            }
+            for (std::thread &reader : readers)
+            {
+                reader.join();
+            }
+            t.Equals(failures.load(), 0u, "concurrent positional reads should all succeed");
+            t.IsTrue(std::memcmp(env.rdram.data() + kDstAddr, contents.data(), contents.size()) == 0,
+                     "each reader should land its slice at its own guest address");
+
+            auto scope = host.enterCall(&env.ctx, env.rdram.data());
+            size_t bytesRead = 0u;
+            t.IsTrue(host.readHostFileIntoGuest(handle, contents.size() - 3u, kDstAddr, 16u, bytesRead) &&
+                         bytesRead == 3u,
+                     "a read past end of file should return the short count");
+
+            host.closeHostFile(handle);
+            t.IsFalse(host.readHostFileIntoGuest(handle, 0u, kDstAddr, 16u, bytesRead),
+                      "a closed handle should be rejected");
+            const uint64_t reopened = host.openHostFile(path.string());
+            t.IsTrue(reopened != 0u && reopened != handle,
+                     "reusing a slot should hand out a new handle");
+            t.IsFalse(host.readHostFile(handle, 0u, contents.data(), 16u, bytesRead),
+                      "the stale handle should not reach the reopened file");
+            host.closeHostFile(reopened);
+
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        });
     });
 }
@@ -5,9 +5,12 @@
 #include "runtime/ps2_memory.h"
 #include "runtime/ps2_vu1.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <iostream>
 #include <limits>
 #include <vector>
 
@@ -133,6 +136,14 @@ namespace
                (static_cast<uint32_t>(imm) & 0x7FFu);
     }
 
+    uint32_t makeVuIsubiu(uint8_t it, uint8_t is, int16_t imm)
+    {
+        return (0x09u << 25) |
+               (static_cast<uint32_t>(it & 0xFu) << 16) |
+               (static_cast<uint32_t>(is & 0xFu) << 11) |
+               (static_cast<uint32_t>(imm) & 0x7FFu);
+    }
+
     uint32_t makeVuBranch(int16_t imm)
     {
         return (0x20u << 25) | (static_cast<uint32_t>(imm) & 0x7FFu);
@@ -1690,6 +1701,45 @@ void register_ps2_vu1_tests()
                      "the underflowing product should set sticky Z and U");
         });
 
+        tc.Run("FMAC flags and folding follow the exact product-sum", [](TestCase &t)
+        {
+            Vu1Fixture fx;
+            t.IsTrue(fx.initialize(), "VU1 fixture should initialize");
+
+            writeVuInstructionPair(
+                fx.code, 0u, 0u,
+                makeVuUpper(0x2Du, 0x8u, 2u, 1u, 3u)); // MSUB.x
+
+            // (1 + 2^-23) * 2^-63 squared rounds to ACC, so the float result
+            // is +0 while the exact result is -2^-172.
+            const uint32_t operandBits = 0x20000001u;
+            const uint32_t roundedProductBits = 0x00800002u;
+            float operand = 0.0f;
+            float roundedProduct = 0.0f;
+            std::memcpy(&operand, &operandBits, sizeof(operand));
+            std::memcpy(&roundedProduct, &roundedProductBits, sizeof(roundedProduct));
+
+            VU1Interpreter vu1;
+            vu1.state().acc[0] = roundedProduct;
+            vu1.state().vf[1][0] = operand;
+            vu1.state().vf[2][0] = operand;
+            vu1.state().vf[3][1] = 7.0f;
+            vu1.execute(fx.code, PS2_VU1_CODE_SIZE,
+                        fx.data, PS2_VU1_DATA_SIZE, fx.gs, &fx.mem,
+                        0u, 0u, 0u, 5u);
+
+            uint32_t resultBits = 0u;
+            std::memcpy(&resultBits, &vu1.state().vf[3][0], sizeof(resultBits));
+            t.Equals(resultBits, 0x80000000u,
+                     "an underflowing exact result should fold to a zero with its sign");
+            t.Equals(vu1.state().mac, 0x888u,
+                     "x should report zero, sign and underflow from the exact result");
+            t.Equals(vu1.state().status, 0x1C7u,
+                     "current and sticky status should carry Z/S/U");
+            t.Equals(vu1.state().vf[3][1], 7.0f,
+                     "lanes outside DEST should keep their value");
+        });
+
         tc.Run("reserved opcodes stop before executing or corrupting state", [](TestCase &t)
         {
             Vu1Fixture fx;
@@ -1712,5 +1762,198 @@ void register_ps2_vu1_tests()
             t.Equals(vu1.state().vi[1], 0,
                      "instruction following a reserved opcode must not execute");
         });
+
+        tc.Run("upper handlers honor every destination mask", [](TestCase &t)
+        {
+            Vu1Fixture fx;
+            t.IsTrue(fx.initialize(), "VU1 fixture should initialize");
+
+            for (uint8_t dest = 0u; dest < 16u; ++dest)
+            {
+                // MADDy vf3, vf1, vf2y then MAX vf4, vf1, vf2 and OPMULA.
+                writeTrackedVuInstructionPair(fx, 0u, 0x8000033Cu, makeVuUpper(0x09u, dest, 2u, 1u, 3u));
+                writeTrackedVuInstructionPair(fx, 8u, 0x8000033Cu, makeVuUpper(0x2Bu, dest, 2u, 1u, 4u));
+                writeTrackedVuInstructionPair(fx, 16u, 0x8000033Cu, makeVuUpperSpecial(0x2Eu, dest, 2u, 1u));
+                writeTrackedVuInstructionPair(fx, 24u, 0x8000033Cu, kVuUpperNop | 0x40000000u);
+                writeTrackedVuInstructionPair(fx, 32u, 0x8000033Cu, kVuUpperNop);
+
+                VU1Interpreter vu1;
+                const float vs[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+                const float vt[4] = {-5.0f, 6.0f, -7.0f, 8.0f};
+                for (uint32_t component = 0; component < 4u; ++component)
+                {
+                    vu1.state().vf[1][component] = vs[component];
+                    vu1.state().vf[2][component] = vt[component];
+                    vu1.state().vf[3][component] = -1.0f;
+                    vu1.state().vf[4][component] = -1.0f;
+                    vu1.state().acc[component] = 10.0f;
+                }
+                vu1.execute(fx.code, PS2_VU1_CODE_SIZE,
+                            fx.data, PS2_VU1_DATA_SIZE, fx.gs, &fx.mem,
+                            0u, 0u, 0u, 64u);
+
+                const float outer[4] = {vs[1] * vt[2], vs[2] * vt[0], vs[0] * vt[1], 10.0f};
+                for (uint32_t component = 0; component < 4u; ++component)
+                {
+                    const bool written = (dest & (1u << (3u - component))) != 0u;
+                    const float madd = 10.0f + vs[component] * vt[1];
+                    const float max = std::max(vs[component], vt[component]);
+                    const float opmula = component == 3u ? 0.0f : outer[component];
+                    t.Equals(vu1.state().vf[3][component], written ? madd : -1.0f,
+                             "MADDbc should only write its destination lanes");
+                    t.Equals(vu1.state().vf[4][component], written ? max : -1.0f,
+                             "MAX should only write its destination lanes");
+                    t.Equals(vu1.state().acc[component], written ? opmula : 10.0f,
+                             "OPMULA should only write its destination lanes");
+                }
+            }
+        });
+
+        tc.Run("scheduled blocks match single-cycle stepping", [](TestCase &t)
+        {
+            Vu1Fixture fx;
+            t.IsTrue(fx.initialize(), "VU1 fixture should initialize");
+
+            // A vertex loop whose body is long enough to run as a scheduled
+            // block when the budget allows it, with FMAC results still in
+            // flight across the back-edge.
+            constexpr uint32_t kVertices = 8u;
+            constexpr uint32_t kOutputQword = 64u;
+            writeTrackedVuInstructionPair(fx, 0u, makeVuIaddiu(3u, 0u, kVertices), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 8u, makeVuIaddiu(2u, 0u, kOutputQword), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 16u, makeVuLq(0xFu, 5u, 1u, 0), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 24u, makeVuIaddiu(1u, 1u, 1), makeVuUpperSpecial(0x18u, 0xFu, 5u, 1u));
+            writeTrackedVuInstructionPair(fx, 32u, 0x8000033Cu, makeVuUpperSpecial(0x09u, 0xFu, 5u, 2u));
+            writeTrackedVuInstructionPair(fx, 40u, 0x8000033Cu, makeVuUpperSpecial(0x0Au, 0xEu, 5u, 3u));
+            writeTrackedVuInstructionPair(fx, 48u, 0x8000033Cu, makeVuUpper(0x0Bu, 0xFu, 5u, 4u, 6u));
+            writeTrackedVuInstructionPair(fx, 56u, makeVuIsubiu(3u, 3u, 1), makeVuUpperSpecial(0x2Eu, 0xEu, 6u, 5u));
+            writeTrackedVuInstructionPair(fx, 64u, makeVuSq(0xFu, 6u, 2u, 0), makeVuUpper(0x28u, 0x7u, 5u, 6u, 7u));
+            writeTrackedVuInstructionPair(fx, 72u, makeVuIbne(3u, 0u, -8), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 80u, makeVuIaddiu(2u, 2u, 1), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 88u, makeVuSq(0xFu, 7u, 2u, 0), kVuUpperNop | 0x40000000u);
+            writeTrackedVuInstructionPair(fx, 96u, 0x8000033Cu, kVuUpperNop);
+
+            for (uint32_t vertex = 0; vertex < kVertices; ++vertex)
+            {
+                const float point[4] = {static_cast<float>(vertex) * 0.5f, static_cast<float>(vertex + 3u),
+                                        -static_cast<float>(vertex), 1.0f};
+                std::memcpy(fx.data + vertex * 16u, point, sizeof(point));
+            }
+            std::vector<uint8_t> initialData(fx.data, fx.data + PS2_VU1_DATA_SIZE);
+
+            const float columns[4][4] = {
+                {2.0f, 0.5f, 0.0f, 0.0f},
+                {0.0f, 3.0f, -1.0f, 0.0f},
+                {1.0f, 0.0f, 4.0f, 0.0f},
+                {10.0f, 20.0f, 30.0f, 1.0f}};
+
+            VU1Interpreter scheduled;
+            std::memcpy(scheduled.state().vf[1], columns, sizeof(columns));
+            scheduled.execute(fx.code, PS2_VU1_CODE_SIZE,
+                              fx.data, PS2_VU1_DATA_SIZE, fx.gs, &fx.mem,
+                              0u, 0u, 0u, 65536u);
+            const VU1State expected = scheduled.state();
+            std::vector<uint8_t> scheduledData(fx.data, fx.data + PS2_VU1_DATA_SIZE);
+
+            // One-cycle slices never leave room for a block, so every pair goes
+            // through the per-cycle pipeline model.
+            std::memcpy(fx.data, initialData.data(), initialData.size());
+            VU1Interpreter stepped;
+            std::memcpy(stepped.state().vf[1], columns, sizeof(columns));
+            stepped.execute(fx.code, PS2_VU1_CODE_SIZE,
+                            fx.data, PS2_VU1_DATA_SIZE, fx.gs, &fx.mem,
+                            0u, 0u, 0u, 1u);
+            for (uint32_t slice = 0; slice < 4096u && stepped.state().cycles < expected.cycles; ++slice)
+                stepped.resume(fx.code, PS2_VU1_CODE_SIZE,
+                               fx.data, PS2_VU1_DATA_SIZE, fx.gs, &fx.mem, 0u, 0u, 1u);
+
+            const VU1State &actual = stepped.state();
+            t.Equals(actual.cycles, expected.cycles, "both runs should take the same number of cycles");
+            t.Equals(actual.pc, expected.pc, "both runs should stop at the same PC");
+            t.IsTrue(std::memcmp(actual.vf, expected.vf, sizeof(expected.vf)) == 0,
+                     "VF registers should match single-cycle stepping");
+            t.IsTrue(std::memcmp(actual.vi, expected.vi, sizeof(expected.vi)) == 0,
+                     "VI registers should match single-cycle stepping");
+            t.IsTrue(std::memcmp(actual.acc, expected.acc, sizeof(expected.acc)) == 0,
+                     "ACC should match single-cycle stepping");
+            t.Equals(actual.mac, expected.mac, "MAC flags should match single-cycle stepping");
+            t.Equals(actual.status, expected.status, "status flags should match single-cycle stepping");
+            t.IsTrue(std::memcmp(fx.data, scheduledData.data(), scheduledData.size()) == 0,
+                     "stored vertices should match single-cycle stepping");
+        });
+
+        tc.Run("VU1 transform loop microbenchmark", [](TestCase &t)
+        {
+            Vu1Fixture fx;
+            t.IsTrue(fx.initialize(), "VU1 fixture should initialize");
+
+            // Transform kVertices points by the matrix in VF1..VF4, the usual
+            // MULAx/MADDAy/MADDAz/MADDw sequence found in VU1 renderers.
+            constexpr uint32_t kVertices = 64u;
+            constexpr uint32_t kOutputQword = 256u;
+            constexpr uint32_t kRuns = 200u;
+            writeTrackedVuInstructionPair(fx, 0u, makeVuIaddiu(3u, 0u, kVertices), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 8u, makeVuIaddiu(2u, 0u, kOutputQword), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 16u, makeVuLq(0xFu, 5u, 1u, 0), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 24u, makeVuIaddiu(1u, 1u, 1), makeVuUpperSpecial(0x18u, 0xFu, 5u, 1u));
+            writeTrackedVuInstructionPair(fx, 32u, 0x8000033Cu, makeVuUpperSpecial(0x09u, 0xFu, 5u, 2u));
+            writeTrackedVuInstructionPair(fx, 40u, 0x8000033Cu, makeVuUpperSpecial(0x0Au, 0xFu, 5u, 3u));
+            writeTrackedVuInstructionPair(fx, 48u, 0x8000033Cu, makeVuUpper(0x0Bu, 0xFu, 5u, 4u, 6u));
+            writeTrackedVuInstructionPair(fx, 56u, makeVuIsubiu(3u, 3u, 1), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 64u, makeVuSq(0xFu, 6u, 2u, 0), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 72u, makeVuIbne(3u, 0u, -8), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 80u, makeVuIaddiu(2u, 2u, 1), kVuUpperNop);
+            writeTrackedVuInstructionPair(fx, 88u, 0x8000033Cu, kVuUpperNop | 0x40000000u);
+            writeTrackedVuInstructionPair(fx, 96u, 0x8000033Cu, kVuUpperNop);
+
+            for (uint32_t vertex = 0; vertex < kVertices; ++vertex)
+            {
+                const float point[4] = {static_cast<float>(vertex), static_cast<float>(vertex + 1u),
+                                        static_cast<float>(vertex + 2u), 1.0f};
+                std::memcpy(fx.data + vertex * 16u, point, sizeof(point));
+            }
+
+            VU1Interpreter vu1;
+            const float columns[4][4] = {
+                {2.0f, 0.0f, 0.0f, 0.0f},
+                {0.0f, 3.0f, 0.0f, 0.0f},
+                {0.0f, 0.0f, 4.0f, 0.0f},
+                {10.0f, 20.0f, 30.0f, 1.0f}};
+            std::memcpy(vu1.state().vf[1], columns, sizeof(columns));
+
+            uint64_t cycles = 0u;
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t run = 0; run < kRuns; ++run)
+            {
+                vu1.state().vi[1] = 0;
+                vu1.execute(fx.code, PS2_VU1_CODE_SIZE,
+                            fx.data, PS2_VU1_DATA_SIZE, fx.gs, &fx.mem,
+                            0u, 0u, 0u, 65536u);
+                cycles += vu1.state().cycles;
+                vu1.reset();
+                std::memcpy(vu1.state().vf[1], columns, sizeof(columns));
+            }
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start);
+
+            bool transformed = true;
+            for (uint32_t vertex = 0; vertex < kVertices; ++vertex)
+            {
+                float out[4]{};
+                std::memcpy(out, fx.data + (kOutputQword + vertex) * 16u, sizeof(out));
+                const float v = static_cast<float>(vertex);
+                transformed = transformed &&
+                              out[0] == 2.0f * v + 10.0f &&
+                              out[1] == 3.0f * (v + 1.0f) + 20.0f &&
+                              out[2] == 4.0f * (v + 2.0f) + 30.0f &&
+                              out[3] == 1.0f;
+            }
+            t.IsTrue(transformed, "every vertex should be transformed by the matrix");
+
+            std::cout << "  VU1 transform: " << kRuns * kVertices << " vertices, "
+                      << cycles << " VU cycles, "
+                      << static_cast<double>(elapsed.count()) / static_cast<double>(cycles)
+                      << " ns/cycle" << std::endl;
+        });
     });
 }
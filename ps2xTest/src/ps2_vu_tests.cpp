@@ -7,6 +7,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <vector>
 
 namespace
@@ -75,6 +76,96 @@ namespace
         m[10] = 1.0f;
         m[15] = 1.0f;
     }
+
+    // Scalar references: the libvu0 stub formulas as they were before the
+    // SIMD rewrite. For normal-range inputs the vector stubs must reproduce
+    // them bit for bit.
+    struct Lcg
+    {
+        uint32_t state;
+
+        float next(float range)
+        {
+            state = state * 1664525u + 1013904223u;
+            const float unit = static_cast<float>(state >> 8) / 16777216.0f;
+            const float value = (unit * 2.0f - 1.0f) * range;
+            return value == 0.0f ? 0.5f : value;
+        }
+    };
+
+    uint32_t floatBits(float value)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float floatFromBits(uint32_t bits)
+    {
+        float value = 0.0f;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void refMulMatrix(const float (&lhs)[16], const float (&rhs)[16], float (&out)[16])
+    {
+        std::fill(std::begin(out), std::end(out), 0.0f);
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                for (int k = 0; k < 4; ++k)
+                    out[4 * i + j] += rhs[4 * k + j] * lhs[4 * i + k];
+    }
+
+    void refApplyMatrix(const float (&m)[16], const float (&v)[4], float (&out)[4])
+    {
+        for (int c = 0; c < 4; ++c)
+            out[c] = (m[c] * v[0]) + (m[4 + c] * v[1]) + (m[8 + c] * v[2]) + (m[12 + c] * v[3]);
+    }
+
+    void refRotTransPers(const float (&m)[16], const float (&v)[4], bool fullFtoi4, int32_t (&out)[4])
+    {
+        float t[4];
+        refApplyMatrix(m, v, t);
+        const float q = (t[3] != 0.0f) ? (1.0f / t[3]) : 0.0f;
+        t[0] *= q;
+        t[1] *= q;
+        t[2] *= q;
+        out[0] = static_cast<int32_t>(t[0] * 16.0f);
+        out[1] = static_cast<int32_t>(t[1] * 16.0f);
+        out[2] = fullFtoi4 ? static_cast<int32_t>(t[2] * 16.0f) : static_cast<int32_t>(t[2]);
+        out[3] = fullFtoi4 ? static_cast<int32_t>(t[3] * 16.0f) : static_cast<int32_t>(t[3]);
+    }
+
+    bool refVertexInside(const float (&m)[16], const float (&v)[4], const float (&lo)[4], const float (&hi)[4])
+    {
+        float t[4];
+        refApplyMatrix(m, v, t);
+        const bool outsideX = (t[0] < lo[0] * t[3]) || (t[0] > hi[0] * t[3]);
+        const bool outsideY = (t[1] < lo[1] * t[3]) || (t[1] > hi[1] * t[3]);
+        return !outsideX && !outsideY;
+    }
+
+    void refNormalize(const float (&src)[4], float (&out)[4])
+    {
+        const float len = std::sqrt((src[0] * src[0]) + (src[1] * src[1]) + (src[2] * src[2]) + (src[3] * src[3]));
+        for (int i = 0; i < 4; ++i)
+            out[i] = (len > 1.0e-6f) ? src[i] * (1.0f / len) : 0.0f;
+    }
+
+    void refOuterProduct(const float (&lhs)[4], const float (&rhs)[4], float (&out)[4])
+    {
+        out[0] = (lhs[1] * rhs[2]) - (lhs[2] * rhs[1]);
+        out[1] = (lhs[2] * rhs[0]) - (lhs[0] * rhs[2]);
+        out[2] = (lhs[0] * rhs[1]) - (lhs[1] * rhs[0]);
+        out[3] = 0.0f;
+    }
+
+    template <size_t N>
+    void randomFill(Lcg &rng, float (&out)[N], float range)
+    {
+        for (float &value : out)
+            value = rng.next(range);
+    }
 }
 
 void register_ps2_vu_tests()
@@ -1042,4 +1133,241 @@ void register_ps2_vu_tests()
             t.IsTrue(nearlyEqual(out[0], 0.0f), "DropShadowMatrix point mode should subtract d before scaling by k");
         });
     });
+
+    MiniTest::Case("PS2VU0Simd", [](TestCase &tc)
+    {
+        tc.Run("MulMatrix_matches_scalar_reference_bit_exact", [](TestCase &t)
+        {
+            VuEnv env;
+            Lcg rng{0x1234u};
+            bool same = true;
+            for (int iter = 0; iter < 256 && same; ++iter)
+            {
+                float lhs[16], rhs[16], expected[16], out[16]{};
+                randomFill(rng, lhs, 64.0f);
+                randomFill(rng, rhs, 64.0f);
+                refMulMatrix(lhs, rhs, expected);
+                writeMat4(env, kA, lhs);
+                writeMat4(env, kB, rhs);
+                SET_GPR_U32(&env.ctx, 4, kDst);
+                SET_GPR_U32(&env.ctx, 5, kA);
+                SET_GPR_U32(&env.ctx, 6, kB);
+                ps2_stubs::sceVu0MulMatrix(env.rdram.data(), &env.ctx, &env.runtime);
+                readMat4(env, kDst, out);
+                same = std::memcmp(out, expected, sizeof(out)) == 0;
+            }
+            t.IsTrue(same, "MulMatrix should match the scalar row-by-column product bit for bit");
+        });
+
+        tc.Run("ApplyMatrix_matches_scalar_reference_bit_exact", [](TestCase &t)
+        {
+            VuEnv env;
+            Lcg rng{0xBEEFu};
+            bool same = true;
+            for (int iter = 0; iter < 256 && same; ++iter)
+            {
+                float m[16], v[4], expected[4], out[4]{};
+                randomFill(rng, m, 64.0f);
+                randomFill(rng, v, 64.0f);
+                refApplyMatrix(m, v, expected);
+                writeMat4(env, kA, m);
+                writeVec4(env, kB, v[0], v[1], v[2], v[3]);
+                SET_GPR_U32(&env.ctx, 4, kDst);
+                SET_GPR_U32(&env.ctx, 5, kA);
+                SET_GPR_U32(&env.ctx, 6, kB);
+                ps2_stubs::sceVu0ApplyMatrix(env.rdram.data(), &env.ctx, &env.runtime);
+                readVec4f(env, kDst, out);
+                same = std::memcmp(out, expected, sizeof(out)) == 0;
+            }
+            t.IsTrue(same, "ApplyMatrix should sum the x, y, z, w terms in the scalar order");
+        });
+
+        tc.Run("RotTransPersN_matches_scalar_reference_bit_exact", [](TestCase &t)
+        {
+            constexpr int32_t kCount = 64;
+            constexpr uint32_t kBatchOut = 0x4000u; // past the 1 KiB vertex batch at kArr
+            for (uint32_t fullFtoi4 = 0; fullFtoi4 < 2u; ++fullFtoi4)
+            {
+                VuEnv env;
+                Lcg rng{0x600Du + fullFtoi4};
+                float m[16];
+                randomFill(rng, m, 32.0f);
+                // Keep w in [1, 2] so every vertex divides by a sane value.
+                m[3] = m[7] = m[11] = 0.0f;
+                m[15] = 1.5f + rng.next(0.5f);
+                writeMat4(env, kA, m);
+                std::vector<int32_t> expected(kCount * 4);
+                for (int32_t i = 0; i < kCount; ++i)
+                {
+                    float v[4];
+                    randomFill(rng, v, 32.0f);
+                    v[3] = 1.0f;
+                    writeVec4(env, kArr + 16u * static_cast<uint32_t>(i), v[0], v[1], v[2], v[3]);
+                    int32_t ref[4];
+                    refRotTransPers(m, v, fullFtoi4 != 0u, ref);
+                    std::memcpy(&expected[4 * i], ref, sizeof(ref));
+                }
+                SET_GPR_U32(&env.ctx, 4, kBatchOut);
+                SET_GPR_U32(&env.ctx, 5, kA);
+                SET_GPR_U32(&env.ctx, 6, kArr);
+                SET_GPR_U32(&env.ctx, 7, static_cast<uint32_t>(kCount));
+                SET_GPR_U32(&env.ctx, 8, fullFtoi4);
+                ps2_stubs::sceVu0RotTransPersN(env.rdram.data(), &env.ctx, &env.runtime);
+                const bool same = std::memcmp(getConstMemPtr(env.rdram.data(), kBatchOut), expected.data(),
+                                              expected.size() * sizeof(int32_t)) == 0;
+                t.IsTrue(same, "RotTransPersN should match the scalar divide and FTOI path bit for bit");
+            }
+        });
+
+        tc.Run("ClipAll_matches_scalar_reference", [](TestCase &t)
+        {
+            Lcg rng{0xC11Fu};
+            int32_t culled = 0;
+            bool same = true;
+            for (int iter = 0; iter < 128 && same; ++iter)
+            {
+                VuEnv env;
+                float m[16], lo[4], hi[4];
+                randomFill(rng, m, 4.0f);
+                m[15] = 8.0f;
+                lo[0] = lo[1] = lo[2] = lo[3] = -0.5f;
+                hi[0] = hi[1] = hi[2] = hi[3] = 0.5f;
+                int32_t expected = 1;
+                for (uint32_t i = 0; i < 3u; ++i)
+                {
+                    float v[4];
+                    randomFill(rng, v, 4.0f);
+                    v[3] = 1.0f;
+                    writeVec4(env, kArr + 16u * i, v[0], v[1], v[2], v[3]);
+                    if (expected == 1 && refVertexInside(m, v, lo, hi))
+                        expected = 0;
+                }
+                writeVec4(env, kA, lo[0], lo[1], lo[2], lo[3]);
+                writeVec4(env, kB, hi[0], hi[1], hi[2], hi[3]);
+                writeMat4(env, kC, m);
+                SET_GPR_U32(&env.ctx, 4, kA);
+                SET_GPR_U32(&env.ctx, 5, kB);
+                SET_GPR_U32(&env.ctx, 6, kC);
+                SET_GPR_U32(&env.ctx, 7, kArr);
+                SET_GPR_U32(&env.ctx, 8, 3u);
+                ps2_stubs::sceVu0ClipAll(env.rdram.data(), &env.ctx, &env.runtime);
+                const int32_t result = static_cast<int32_t>(getRegU32(&env.ctx, 2));
+                culled += result;
+                same = result == expected;
+            }
+            t.IsTrue(same, "ClipAll should make the same cull decision as the scalar plane tests");
+            t.IsTrue(culled > 0 && culled < 128, "ClipAll sample set should exercise both cull outcomes");
+        });
+
+        tc.Run("vector_ops_match_scalar_reference_bit_exact", [](TestCase &t)
+        {
+            VuEnv env;
+            Lcg rng{0xF00Du};
+            bool normalizeSame = true;
+            bool interSame = true;
+            bool outerSame = true;
+            for (int iter = 0; iter < 256; ++iter)
+            {
+                float a[4], b[4], expected[4], out[4]{};
+                randomFill(rng, a, 64.0f);
+                randomFill(rng, b, 64.0f);
+                writeVec4(env, kA, a[0], a[1], a[2], a[3]);
+                writeVec4(env, kB, b[0], b[1], b[2], b[3]);
+
+                refNormalize(a, expected);
+                SET_GPR_U32(&env.ctx, 4, kDst);
+                SET_GPR_U32(&env.ctx, 5, kA);
+                ps2_stubs::sceVu0Normalize(env.rdram.data(), &env.ctx, &env.runtime);
+                readVec4f(env, kDst, out);
+                normalizeSame = normalizeSame && std::memcmp(out, expected, sizeof(out)) == 0;
+
+                const float blend = rng.next(1.0f);
+                for (int i = 0; i < 4; ++i)
+                    expected[i] = (a[i] * blend) + (b[i] * (1.0f - blend));
+                env.ctx.f[12] = blend;
+                SET_GPR_U32(&env.ctx, 6, kB);
+                ps2_stubs::sceVu0InterVector(env.rdram.data(), &env.ctx, &env.runtime);
+                readVec4f(env, kDst, out);
+                interSame = interSame && std::memcmp(out, expected, sizeof(out)) == 0;
+
+                refOuterProduct(a, b, expected);
+                ps2_stubs::sceVu0OuterProduct(env.rdram.data(), &env.ctx, &env.runtime);
+                readVec4f(env, kDst, out);
+                outerSame = outerSame && std::memcmp(out, expected, sizeof(out)) == 0;
+            }
+            t.IsTrue(normalizeSame, "Normalize should sum the squared lanes in scalar order");
+            t.IsTrue(interSame, "InterVector should match the scalar lerp bit for bit");
+            t.IsTrue(outerSame, "OuterProduct should match the scalar cross product bit for bit");
+        });
+
+        tc.Run("AddVector_folds_inf_nan_and_denormal_operands", [](TestCase &t)
+        {
+            VuEnv env;
+            writeVec4(env, kA, floatFromBits(0x7F800000u), floatFromBits(0x7FC00000u),
+                      floatFromBits(0xFF800000u), floatFromBits(0x00000001u));
+            writeVec4(env, kB, 1.0f, 0.0f, 0.0f, 0.0f);
+            SET_GPR_U32(&env.ctx, 4, kDst);
+            SET_GPR_U32(&env.ctx, 5, kA);
+            SET_GPR_U32(&env.ctx, 6, kB);
+            ps2_stubs::sceVu0AddVector(env.rdram.data(), &env.ctx, &env.runtime);
+            float out[4]{};
+            readVec4f(env, kDst, out);
+            t.Equals(floatBits(out[0]), 0x7F7FFFFFu, "+Inf should read as +FLT_MAX");
+            t.Equals(floatBits(out[1]), 0x7F7FFFFFu, "a positive NaN should read as +FLT_MAX");
+            t.Equals(floatBits(out[2]), 0xFF7FFFFFu, "-Inf should read as -FLT_MAX");
+            t.Equals(floatBits(out[3]), 0x00000000u, "a denormal should read as zero");
+        });
+
+        tc.Run("MulVector_saturates_overflow_and_flushes_underflow", [](TestCase &t)
+        {
+            VuEnv env;
+            const float maxValue = floatFromBits(0x7F7FFFFFu);
+            writeVec4(env, kA, maxValue, -maxValue, 1.0e-30f, -1.0e-30f);
+            writeVec4(env, kB, 2.0f, 2.0f, 1.0e-30f, 1.0e-30f);
+            SET_GPR_U32(&env.ctx, 4, kDst);
+            SET_GPR_U32(&env.ctx, 5, kA);
+            SET_GPR_U32(&env.ctx, 6, kB);
+            ps2_stubs::sceVu0MulVector(env.rdram.data(), &env.ctx, &env.runtime);
+            float out[4]{};
+            readVec4f(env, kDst, out);
+            t.Equals(floatBits(out[0]), 0x7F7FFFFFu, "positive overflow should saturate to +FLT_MAX");
+            t.Equals(floatBits(out[1]), 0xFF7FFFFFu, "negative overflow should saturate to -FLT_MAX");
+            t.Equals(floatBits(out[2]), 0x00000000u, "underflow should flush to +0");
+            t.Equals(floatBits(out[3]), 0x80000000u, "negative underflow should flush to -0");
+        });
+
+        tc.Run("ApplyMatrix_clamps_each_step_so_no_nan_appears", [](TestCase &t)
+        {
+            VuEnv env;
+            const float maxValue = floatFromBits(0x7F7FFFFFu);
+            float m[16]{};
+            for (int i = 0; i < 8; ++i)
+                m[i] = maxValue;
+            writeMat4(env, kA, m);
+            writeVec4(env, kB, 2.0f, -2.0f, 0.0f, 0.0f);
+            SET_GPR_U32(&env.ctx, 4, kDst);
+            SET_GPR_U32(&env.ctx, 5, kA);
+            SET_GPR_U32(&env.ctx, 6, kB);
+            ps2_stubs::sceVu0ApplyMatrix(env.rdram.data(), &env.ctx, &env.runtime);
+            float out[4]{};
+            readVec4f(env, kDst, out);
+            t.Equals(floatBits(out[0]), 0x00000000u,
+                     "MAX*2 + MAX*-2 should clamp each product and cancel to zero instead of Inf-Inf");
+        });
+
+        tc.Run("FTOI4Vector_saturates_out_of_range_lanes", [](TestCase &t)
+        {
+            VuEnv env;
+            writeVec4(env, kA, 1.0e30f, -1.0e30f, floatFromBits(0x7F800000u), 1.5f);
+            SET_GPR_U32(&env.ctx, 4, kDst);
+            SET_GPR_U32(&env.ctx, 5, kA);
+            ps2_stubs::sceVu0FTOI4Vector(env.rdram.data(), &env.ctx, &env.runtime);
+            int32_t out[4]{};
+            readVec4i(env, kDst, out);
+            t.Equals(out[0], std::numeric_limits<int32_t>::max(), "large positive lanes should saturate");
+            t.Equals(out[1], std::numeric_limits<int32_t>::min(), "large negative lanes should saturate");
+            t.Equals(out[2], std::numeric_limits<int32_t>::max(), "+Inf should convert like +FLT_MAX");
+            t.Equals(out[3], 24, "in-range lanes should convert to 12.4 fixed point");
+        });
+    });
 }
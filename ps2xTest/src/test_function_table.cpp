@@ -15,4 +15,5 @@ void reset_ps2_test_function_table()
     std::fill(g_ps2RecompiledFunctionTable,
               g_ps2RecompiledFunctionTable + g_ps2RecompiledFunctionTableSlotCount,
               nullptr);
+    PS2Runtime::invalidateGuestBranchCaches();
 }